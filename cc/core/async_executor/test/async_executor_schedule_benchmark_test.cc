@@ -0,0 +1,114 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+
+namespace google::scp::core::test {
+
+static constexpr size_t kQueueCapacity = 1 << 20;
+static constexpr int kTasksPerIteration = 1000;
+
+/// Shared by all the threads of a benchmark run, created in the setup with
+/// the number of executor threads given by the second argument.
+static std::shared_ptr<AsyncExecutor> async_executor;
+
+static void CreateExecutor(const benchmark::State& state) {
+  async_executor = std::make_shared<AsyncExecutor>(
+      state.range(1), kQueueCapacity, /*drop_tasks_on_stop=*/false);
+  async_executor->Init();
+  async_executor->Run();
+}
+
+static void DestroyExecutor(const benchmark::State& state) {
+  async_executor->Stop();
+  async_executor.reset();
+}
+
+/**
+ * @brief Measures the time from scheduling a task until it starts running,
+ * one task at a time. The first argument is the AsyncPriority.
+ */
+static void BM_ScheduleToRunLatency(benchmark::State& state) {
+  auto priority = static_cast<AsyncPriority>(state.range(0));
+  for (auto _ : state) {
+    std::atomic<bool> has_run = false;
+    std::chrono::steady_clock::time_point run_time;
+    auto schedule_time = std::chrono::steady_clock::now();
+    auto execution_result = async_executor->Schedule(
+        [&]() {
+          run_time = std::chrono::steady_clock::now();
+          has_run = true;
+        },
+        priority);
+    if (!execution_result.Successful()) {
+      state.SkipWithError("Cannot schedule the task.");
+      break;
+    }
+    while (!has_run.load()) {}
+    state.SetIterationTime(
+        std::chrono::duration<double>(run_time - schedule_time).count());
+  }
+}
+
+BENCHMARK(BM_ScheduleToRunLatency)
+    ->Setup(CreateExecutor)
+    ->Teardown(DestroyExecutor)
+    ->ArgNames({"priority", "executor_threads"})
+    ->ArgsProduct({{static_cast<int64_t>(AsyncPriority::Normal),
+                    static_cast<int64_t>(AsyncPriority::High),
+                    static_cast<int64_t>(AsyncPriority::Urgent)},
+                   {1, 4}})
+    ->UseManualTime();
+
+/**
+ * @brief Every benchmark thread schedules a burst of tasks and waits for all
+ * of them to run, so schedulers contend on the executor queues.
+ */
+static void BM_ScheduleThroughput(benchmark::State& state) {
+  auto priority = static_cast<AsyncPriority>(state.range(0));
+  for (auto _ : state) {
+    std::atomic<int> pending_count = kTasksPerIteration;
+    for (int i = 0; i < kTasksPerIteration; i++) {
+      while (!async_executor
+                  ->Schedule([&]() { pending_count.fetch_sub(1); }, priority)
+                  .Successful()) {
+        std::this_thread::yield();
+      }
+    }
+    while (pending_count.load() > 0) {}
+  }
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+BENCHMARK(BM_ScheduleThroughput)
+    ->Setup(CreateExecutor)
+    ->Teardown(DestroyExecutor)
+    ->ArgNames({"priority", "executor_threads"})
+    ->ArgsProduct({{static_cast<int64_t>(AsyncPriority::Normal),
+                    static_cast<int64_t>(AsyncPriority::High)},
+                   {1, 4, 16}})
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+}  // namespace google::scp::core::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -167,9 +167,18 @@ class MockBlobStorageClient : public BlobStorageClientInterface {
     std::filesystem::create_directories(storage_path.parent_path());
 
     std::ofstream output_stream(full_path, std::ofstream::trunc);
-    output_stream.write(reinterpret_cast<char*>(
-                            put_blob_context.request->buffer->bytes->data()),
-                        put_blob_context.request->buffer->length);
+    if (put_blob_context.request->buffer) {
+      output_stream.write(reinterpret_cast<char*>(
+                              put_blob_context.request->buffer->bytes->data()),
+                          put_blob_context.request->buffer->length);
+    } else {
+      for (const auto& buffer_segment :
+           put_blob_context.request->buffer_segments) {
+        output_stream.write(
+            reinterpret_cast<char*>(buffer_segment->bytes->data()),
+            buffer_segment->length);
+      }
+    }
     output_stream.close();
 
     put_blob_context.result = SuccessExecutionResult();
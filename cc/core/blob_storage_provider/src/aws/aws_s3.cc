@@ -268,7 +268,8 @@ ExecutionResult AwsS3Client::PutBlob(
       !put_blob_context.request->blob_name ||
       put_blob_context.request->bucket_name->empty() ||
       put_blob_context.request->blob_name->empty() ||
-      put_blob_context.request->buffer == nullptr) {
+      (put_blob_context.request->buffer == nullptr &&
+       put_blob_context.request->buffer_segments.empty())) {
     return FailureExecutionResult(
         errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
   }
@@ -282,7 +283,9 @@ ExecutionResult AwsS3Client::PutBlob(
 
   ASSIGN_OR_LOG_AND_RETURN_CONTEXT(
       string md5_checksum,
-      utils::CalculateMd5Hash(*put_blob_context.request->buffer),
+      put_blob_context.request->buffer
+          ? utils::CalculateMd5Hash(*put_blob_context.request->buffer)
+          : utils::CalculateMd5Hash(put_blob_context.request->buffer_segments),
       kAwsS3Provider, put_blob_context, "MD5 Hash generation failed");
 
   string base64_md5_checksum;
@@ -296,8 +299,15 @@ ExecutionResult AwsS3Client::PutBlob(
   auto input_data = Aws::MakeShared<Aws::StringStream>(
       "PutObjectInputStream", std::stringstream::in | std::stringstream::out |
                                   std::stringstream::binary);
-  input_data->write(put_blob_context.request->buffer->bytes->data(),
-                    put_blob_context.request->buffer->length);
+  if (put_blob_context.request->buffer) {
+    input_data->write(put_blob_context.request->buffer->bytes->data(),
+                      put_blob_context.request->buffer->length);
+  } else {
+    for (const auto& buffer_segment :
+         put_blob_context.request->buffer_segments) {
+      input_data->write(buffer_segment->bytes->data(), buffer_segment->length);
+    }
+  }
 
   put_object_request.SetBody(input_data);
   put_object_request.SetContentMD5(base64_md5_checksum.c_str());
@@ -315,7 +315,7 @@ ExecutionResult GcpCloudStorageClient::PutBlob(
   const auto& request = *put_blob_context.request;
   if (!request.bucket_name || !request.blob_name ||
       request.bucket_name->empty() || request.blob_name->empty() ||
-      request.buffer == nullptr) {
+      (request.buffer == nullptr && request.buffer_segments.empty())) {
     return FailureExecutionResult(
         errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
   }
@@ -333,7 +333,23 @@ void GcpCloudStorageClient::PutBlobAsync(
     AsyncContext<PutBlobRequest, PutBlobResponse> put_blob_context) noexcept {
   Client cloud_storage_client(*cloud_storage_client_shared_);
 
-  auto upload_obj = put_blob_context.request->buffer->ToString();
+  string upload_obj;
+  if (put_blob_context.request->buffer) {
+    upload_obj = put_blob_context.request->buffer->ToString();
+  } else {
+    // The client takes the object as a single string, so the segments are
+    // gathered into it.
+    size_t length = 0;
+    for (const auto& buffer_segment :
+         put_blob_context.request->buffer_segments) {
+      length += buffer_segment->length;
+    }
+    upload_obj.reserve(length);
+    for (const auto& buffer_segment :
+         put_blob_context.request->buffer_segments) {
+      upload_obj.append(buffer_segment->bytes->data(), buffer_segment->length);
+    }
+  }
   string md5_hash = ComputeMD5Hash(upload_obj);
   auto object_metadata = cloud_storage_client.InsertObject(
       *put_blob_context.request->bucket_name,
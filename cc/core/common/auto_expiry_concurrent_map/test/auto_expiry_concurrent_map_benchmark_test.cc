@@ -0,0 +1,102 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/auto_expiry_concurrent_map/src/auto_expiry_concurrent_map.h"
+
+namespace google::scp::core::common::test {
+
+static constexpr uint64_t kKeyCount = 1 << 16;
+static constexpr int kMaxThreads = 16;
+static constexpr size_t kEntryLifetimeInSeconds = 3600;
+
+using BenchmarkMap = AutoExpiryConcurrentMap<uint64_t, std::shared_ptr<int>>;
+
+/// Shared by all the threads of a benchmark run, created in the setup. The
+/// map is not run, so garbage collection does not interfere.
+static std::unique_ptr<BenchmarkMap> map;
+
+static void CreatePopulatedMap(const benchmark::State& state) {
+  map = std::make_unique<BenchmarkMap>(
+      kEntryLifetimeInSeconds, /*extend_entry_lifetime_on_access=*/
+      state.range(0) == 1, /*block_entry_while_eviction=*/true,
+      [](uint64_t&, std::shared_ptr<int>&,
+         std::function<void(bool)> should_delete_entry) {
+        should_delete_entry(true);
+      },
+      /*async_executor=*/nullptr);
+  auto value = std::make_shared<int>(0);
+  for (uint64_t key = 0; key < kKeyCount; key++) {
+    std::shared_ptr<int> out_value;
+    map->Insert(std::make_pair(key, value), out_value);
+  }
+}
+
+static void DestroyMap(const benchmark::State& state) {
+  map.reset();
+}
+
+/// Threads look up existing keys. The argument is 1 if the lifetime of the
+/// entries is extended on access.
+static void BM_Find(benchmark::State& state) {
+  uint64_t key = state.thread_index() * (kKeyCount / kMaxThreads);
+  std::shared_ptr<int> value;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->Find(key, value));
+    key = (key + 1) % kKeyCount;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Find)
+    ->Setup(CreatePopulatedMap)
+    ->Teardown(DestroyMap)
+    ->ArgName("extend_lifetime")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/// Threads insert keys that mostly exist already, which is the common case
+/// of loading budget keys.
+static void BM_InsertExisting(benchmark::State& state) {
+  uint64_t key = state.thread_index() * (kKeyCount / kMaxThreads);
+  auto value = std::make_shared<int>(0);
+  std::shared_ptr<int> out_value;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        map->Insert(std::make_pair(key, value), out_value));
+    key = (key + 1) % kKeyCount;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_InsertExisting)
+    ->Setup(CreatePopulatedMap)
+    ->Teardown(DestroyMap)
+    ->ArgName("extend_lifetime")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bytes_buffer_pool.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using std::array;
+using std::atomic;
+using std::lock_guard;
+using std::make_shared;
+using std::make_unique;
+using std::move;
+using std::mutex;
+using std::shared_ptr;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+/// The size classes go from 256 B to 1 MiB.
+constexpr size_t kMinSizeClassShift = 8;
+constexpr size_t kMaxSizeClassShift = 20;
+constexpr size_t kSizeClassCount = kMaxSizeClassShift - kMinSizeClassShift + 1;
+constexpr size_t kMaxThreadCachedBuffersPerSizeClass = 8;
+constexpr size_t kMaxArenaPooledBytes = 64 * 1024 * 1024;
+}  // namespace
+
+namespace google::scp::core::common {
+namespace {
+using FreeBuffers = array<vector<unique_ptr<vector<Byte>>>, kSizeClassCount>;
+
+struct PoolCounters {
+  atomic<size_t> pooled_bytes{0};
+  atomic<size_t> outstanding_bytes{0};
+  atomic<uint64_t> hit_count{0};
+  atomic<uint64_t> miss_count{0};
+};
+
+/// The buffers shared by all the threads, up to kMaxArenaPooledBytes.
+struct Arena {
+  mutex free_buffers_mutex;
+  FreeBuffers free_buffers;
+  size_t pooled_bytes = 0;
+};
+
+// The counters and the arena are never destroyed, since buffers may still be
+// released during the static destruction.
+PoolCounters& GetCounters() noexcept {
+  static auto* counters = new PoolCounters();
+  return *counters;
+}
+
+Arena& GetArena() noexcept {
+  static auto* arena = new Arena();
+  return *arena;
+}
+
+size_t GetSizeClassBytes(size_t size_class) noexcept {
+  return static_cast<size_t>(1) << (kMinSizeClassShift + size_class);
+}
+
+/// Returns the smallest size class holding the size.
+size_t GetAllocationSizeClass(size_t size) noexcept {
+  size_t size_class = 0;
+  while (GetSizeClassBytes(size_class) < size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+void AddPooledBuffer(const vector<Byte>& bytes) noexcept {
+  GetCounters().pooled_bytes += bytes.capacity();
+}
+
+void RemovePooledBuffer(const vector<Byte>& bytes) noexcept {
+  GetCounters().pooled_bytes -= bytes.capacity();
+}
+
+/// Caches the buffer in the arena, or frees it if the arena is full.
+void ReleaseToArena(size_t size_class,
+                    unique_ptr<vector<Byte>> bytes) noexcept {
+  auto& arena = GetArena();
+  lock_guard<mutex> lock(arena.free_buffers_mutex);
+  if (arena.pooled_bytes + bytes->capacity() > kMaxArenaPooledBytes) {
+    return;
+  }
+  arena.pooled_bytes += bytes->capacity();
+  AddPooledBuffer(*bytes);
+  arena.free_buffers[size_class].push_back(move(bytes));
+}
+
+unique_ptr<vector<Byte>> TakeFromArena(size_t size_class) noexcept {
+  auto& arena = GetArena();
+  lock_guard<mutex> lock(arena.free_buffers_mutex);
+  auto& free_buffers = arena.free_buffers[size_class];
+  if (free_buffers.empty()) {
+    return nullptr;
+  }
+  auto bytes = move(free_buffers.back());
+  free_buffers.pop_back();
+  arena.pooled_bytes -= bytes->capacity();
+  RemovePooledBuffer(*bytes);
+  return bytes;
+}
+
+/// The buffers cached by a thread, which go to the arena once it exits.
+struct ThreadCache {
+  ~ThreadCache();
+
+  FreeBuffers free_buffers;
+};
+
+// Trivially destructible, so it can still be read once the cache is destroyed.
+thread_local bool is_thread_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+  is_thread_cache_destroyed = true;
+  for (size_t size_class = 0; size_class < kSizeClassCount; ++size_class) {
+    for (auto& bytes : free_buffers[size_class]) {
+      RemovePooledBuffer(*bytes);
+      ReleaseToArena(size_class, move(bytes));
+    }
+  }
+}
+
+/// Returns the cache of the calling thread, or nullptr if it exits.
+ThreadCache* GetThreadCache() noexcept {
+  if (is_thread_cache_destroyed) {
+    return nullptr;
+  }
+  thread_local ThreadCache thread_cache;
+  return &thread_cache;
+}
+
+void ReleaseBytes(vector<Byte>* raw_bytes, size_t allocated_capacity) noexcept {
+  unique_ptr<vector<Byte>> bytes(raw_bytes);
+  GetCounters().outstanding_bytes -= allocated_capacity;
+
+  // The callers may have shrunk or grown the bytes, so the size class is
+  // the largest one the current capacity can serve.
+  auto capacity = bytes->capacity();
+  if (capacity < GetSizeClassBytes(0) ||
+      capacity > GetSizeClassBytes(kSizeClassCount - 1)) {
+    return;
+  }
+  size_t size_class = kSizeClassCount - 1;
+  while (GetSizeClassBytes(size_class) > capacity) {
+    size_class--;
+  }
+
+  auto* thread_cache = GetThreadCache();
+  if (thread_cache && thread_cache->free_buffers[size_class].size() <
+                          kMaxThreadCachedBuffersPerSizeClass) {
+    AddPooledBuffer(*bytes);
+    thread_cache->free_buffers[size_class].push_back(move(bytes));
+    return;
+  }
+  ReleaseToArena(size_class, move(bytes));
+}
+}  // namespace
+
+BytesBuffer BytesBufferPool::Allocate(size_t size) noexcept {
+  BytesBuffer bytes_buffer;
+  bytes_buffer.bytes = AllocateBytes(size);
+  bytes_buffer.capacity = size;
+  return bytes_buffer;
+}
+
+shared_ptr<vector<Byte>> BytesBufferPool::AllocateBytes(size_t size) noexcept {
+  if (size > GetSizeClassBytes(kSizeClassCount - 1)) {
+    return make_shared<vector<Byte>>(size);
+  }
+
+  auto size_class = GetAllocationSizeClass(size);
+  unique_ptr<vector<Byte>> bytes;
+  auto* thread_cache = GetThreadCache();
+  if (thread_cache && !thread_cache->free_buffers[size_class].empty()) {
+    bytes = move(thread_cache->free_buffers[size_class].back());
+    thread_cache->free_buffers[size_class].pop_back();
+    RemovePooledBuffer(*bytes);
+  } else {
+    bytes = TakeFromArena(size_class);
+  }
+
+  if (bytes) {
+    GetCounters().hit_count++;
+  } else {
+    GetCounters().miss_count++;
+    bytes = make_unique<vector<Byte>>();
+    bytes->reserve(GetSizeClassBytes(size_class));
+  }
+  // Only the bytes past the size of the former use of the buffer are zeroed.
+  bytes->resize(size);
+
+  auto allocated_capacity = bytes->capacity();
+  GetCounters().outstanding_bytes += allocated_capacity;
+  return shared_ptr<vector<Byte>>(
+      bytes.release(), [allocated_capacity](vector<Byte>* bytes) {
+        ReleaseBytes(bytes, allocated_capacity);
+      });
+}
+
+BytesBufferPoolMetrics BytesBufferPool::GetMetrics() noexcept {
+  auto& counters = GetCounters();
+  BytesBufferPoolMetrics metrics;
+  metrics.pooled_bytes = counters.pooled_bytes;
+  metrics.outstanding_bytes = counters.outstanding_bytes;
+  metrics.hit_count = counters.hit_count;
+  metrics.miss_count = counters.miss_count;
+  return metrics;
+}
+
+void BytesBufferPool::Trim() noexcept {
+  FreeBuffers free_buffers;
+  auto& arena = GetArena();
+  {
+    lock_guard<mutex> lock(arena.free_buffers_mutex);
+    free_buffers.swap(arena.free_buffers);
+    arena.pooled_bytes = 0;
+  }
+  auto* thread_cache = GetThreadCache();
+  for (size_t size_class = 0; size_class < kSizeClassCount; ++size_class) {
+    for (const auto& bytes : free_buffers[size_class]) {
+      RemovePooledBuffer(*bytes);
+    }
+    if (thread_cache) {
+      for (const auto& bytes : thread_cache->free_buffers[size_class]) {
+        RemovePooledBuffer(*bytes);
+      }
+      thread_cache->free_buffers[size_class].clear();
+    }
+  }
+}
+}  // namespace google::scp::core::common
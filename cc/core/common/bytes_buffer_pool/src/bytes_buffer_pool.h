@@ -0,0 +1,79 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/interface/type_def.h"
+
+namespace google::scp::core::common {
+/// The occupancy of the bytes buffer pool, published by the health service.
+struct BytesBufferPoolMetrics {
+  /// The bytes cached by the pool, in the thread caches and the arena.
+  size_t pooled_bytes = 0;
+  /// The bytes of the pooled buffers handed out and not released yet.
+  size_t outstanding_bytes = 0;
+  /// The allocations served from a cached buffer and the ones which were not.
+  uint64_t hit_count = 0;
+  uint64_t miss_count = 0;
+};
+
+/**
+ * @brief Pools the bytes of the buffers used for serialization, e.g. journal
+ * logs and transaction commands, in power of two size classes. The buffers
+ * released by a thread are cached for that thread, and the ones exceeding its
+ * cache go to a global arena shared by all the threads. A buffer returns to
+ * the pool once the last reference to its bytes is released.
+ *
+ * Contrary to BytesBuffer(size), the bytes of a recycled buffer are not zeroed,
+ * so the callers must only read the bytes they wrote. Sizes above the largest
+ * size class are allocated without pooling.
+ */
+class BytesBufferPool {
+ public:
+  /**
+   * @brief Allocates a buffer with a capacity of the size and no length, as
+   * BytesBuffer(size) does.
+   *
+   * @param size The size of the buffer.
+   * @return BytesBuffer The buffer, with unspecified contents.
+   */
+  static BytesBuffer Allocate(size_t size) noexcept;
+
+  /**
+   * @brief Allocates the bytes of a buffer, e.g. to set on an existing
+   * BytesBuffer.
+   *
+   * @param size The size of the bytes.
+   * @return std::shared_ptr<std::vector<Byte>> The bytes, with unspecified
+   * contents.
+   */
+  static std::shared_ptr<std::vector<Byte>> AllocateBytes(size_t size) noexcept;
+
+  /// Returns the current occupancy of the pool.
+  static BytesBufferPoolMetrics GetMetrics() noexcept;
+
+  /**
+   * @brief Frees the buffers cached in the global arena and in the cache of
+   * the calling thread, e.g. under memory pressure.
+   */
+  static void Trim() noexcept;
+};
+}  // namespace google::scp::core::common
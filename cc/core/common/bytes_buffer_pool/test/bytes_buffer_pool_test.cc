@@ -0,0 +1,112 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "core/interface/type_def.h"
+
+using google::scp::core::Byte;
+using std::thread;
+
+namespace google::scp::core::common::test {
+class BytesBufferPoolTest : public testing::Test {
+ protected:
+  void SetUp() override { BytesBufferPool::Trim(); }
+};
+
+TEST_F(BytesBufferPoolTest, AllocateHasTheSize) {
+  auto bytes_buffer = BytesBufferPool::Allocate(1000);
+  EXPECT_EQ(bytes_buffer.length, 0);
+  EXPECT_EQ(bytes_buffer.capacity, 1000);
+  EXPECT_EQ(bytes_buffer.bytes->size(), 1000);
+  EXPECT_GE(bytes_buffer.bytes->capacity(), 1024);
+}
+
+TEST_F(BytesBufferPoolTest, ReleasedBufferIsReusedWithinItsSizeClass) {
+  auto bytes = BytesBufferPool::AllocateBytes(1000);
+  auto* data = bytes->data();
+  auto metrics = BytesBufferPool::GetMetrics();
+  EXPECT_EQ(metrics.outstanding_bytes, 1024);
+  EXPECT_EQ(metrics.pooled_bytes, 0);
+
+  // The buffer returns to the pool on the last release only.
+  auto bytes_copy = bytes;
+  bytes = nullptr;
+  EXPECT_EQ(BytesBufferPool::GetMetrics().pooled_bytes, 0);
+  bytes_copy = nullptr;
+  metrics = BytesBufferPool::GetMetrics();
+  EXPECT_EQ(metrics.outstanding_bytes, 0);
+  EXPECT_EQ(metrics.pooled_bytes, 1024);
+
+  // A smaller size class does not reuse the buffer.
+  auto hit_count = metrics.hit_count;
+  auto small_bytes = BytesBufferPool::AllocateBytes(100);
+  EXPECT_NE(small_bytes->data(), data);
+  EXPECT_EQ(BytesBufferPool::GetMetrics().hit_count, hit_count);
+
+  bytes = BytesBufferPool::AllocateBytes(600);
+  EXPECT_EQ(bytes->data(), data);
+  EXPECT_EQ(bytes->size(), 600);
+  metrics = BytesBufferPool::GetMetrics();
+  EXPECT_EQ(metrics.hit_count, hit_count + 1);
+  EXPECT_EQ(metrics.pooled_bytes, 0);
+}
+
+TEST_F(BytesBufferPoolTest, LargeBuffersAreNotPooled) {
+  auto bytes = BytesBufferPool::AllocateBytes(2 * 1024 * 1024);
+  EXPECT_EQ(bytes->size(), 2 * 1024 * 1024);
+  EXPECT_EQ(BytesBufferPool::GetMetrics().outstanding_bytes, 0);
+  bytes = nullptr;
+  EXPECT_EQ(BytesBufferPool::GetMetrics().pooled_bytes, 0);
+}
+
+TEST_F(BytesBufferPoolTest, ThreadCacheGoesToTheArenaOnExit) {
+  Byte* data = nullptr;
+  thread([&data]() {
+    auto bytes = BytesBufferPool::AllocateBytes(4096);
+    data = bytes->data();
+  }).join();
+  EXPECT_EQ(BytesBufferPool::GetMetrics().pooled_bytes, 4096);
+
+  auto bytes = BytesBufferPool::AllocateBytes(4000);
+  EXPECT_EQ(bytes->data(), data);
+}
+
+TEST_F(BytesBufferPoolTest, BuffersReleasedByOtherThreadsAreReused) {
+  auto bytes = BytesBufferPool::AllocateBytes(300);
+  auto* data = bytes->data();
+  thread([bytes = std::move(bytes)]() mutable { bytes = nullptr; }).join();
+
+  bytes = BytesBufferPool::AllocateBytes(300);
+  EXPECT_EQ(bytes->data(), data);
+}
+
+TEST_F(BytesBufferPoolTest, TrimFreesThePooledBuffers) {
+  auto bytes = BytesBufferPool::AllocateBytes(300);
+  auto other_bytes = BytesBufferPool::AllocateBytes(70000);
+  bytes = nullptr;
+  other_bytes = nullptr;
+  EXPECT_EQ(BytesBufferPool::GetMetrics().pooled_bytes, 512 + 128 * 1024);
+
+  BytesBufferPool::Trim();
+  auto metrics = BytesBufferPool::GetMetrics();
+  EXPECT_EQ(metrics.pooled_bytes, 0);
+}
+}  // namespace google::scp::core::common::test
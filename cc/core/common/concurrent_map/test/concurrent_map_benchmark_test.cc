@@ -0,0 +1,104 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/concurrent_map/src/concurrent_map.h"
+
+namespace google::scp::core::common::test {
+
+static constexpr uint64_t kKeyCount = 1 << 16;
+static constexpr int kMaxThreads = 16;
+
+/// Shared by all the threads of a benchmark run, created in the setup.
+static std::unique_ptr<ConcurrentMap<uint64_t, uint64_t>> map;
+
+static void CreatePopulatedMap(const benchmark::State& state) {
+  map = std::make_unique<ConcurrentMap<uint64_t, uint64_t>>();
+  for (uint64_t key = 0; key < kKeyCount; key++) {
+    uint64_t value;
+    map->Insert(std::make_pair(key, key), value);
+  }
+}
+
+static void CreateEmptyMap(const benchmark::State& state) {
+  map = std::make_unique<ConcurrentMap<uint64_t, uint64_t>>();
+}
+
+static void DestroyMap(const benchmark::State& state) {
+  map.reset();
+}
+
+/// Threads look up existing keys, each thread walking the key space from a
+/// different offset.
+static void BM_Find(benchmark::State& state) {
+  uint64_t key = state.thread_index() * (kKeyCount / kMaxThreads);
+  uint64_t value;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->Find(key, value));
+    key = (key + 1) % kKeyCount;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Find)
+    ->Setup(CreatePopulatedMap)
+    ->Teardown(DestroyMap)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/// Threads insert distinct keys.
+static void BM_Insert(benchmark::State& state) {
+  uint64_t key = static_cast<uint64_t>(state.thread_index()) << 40;
+  uint64_t value;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->Insert(std::make_pair(key, key), value));
+    key++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Insert)
+    ->Setup(CreateEmptyMap)
+    ->Teardown(DestroyMap)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/// Threads insert and then erase the same keys, contending on the same
+/// buckets.
+static void BM_InsertFindErase(benchmark::State& state) {
+  uint64_t key = state.thread_index() * (kKeyCount / kMaxThreads);
+  uint64_t value;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->Insert(std::make_pair(key, key), value));
+    benchmark::DoNotOptimize(map->Find(key, value));
+    benchmark::DoNotOptimize(map->Erase(key));
+    key = (key + 1) % kKeyCount;
+  }
+  state.SetItemsProcessed(state.iterations() * 3);
+}
+
+BENCHMARK(BM_InsertFindErase)
+    ->Setup(CreateEmptyMap)
+    ->Teardown(DestroyMap)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,77 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/concurrent_queue/src/concurrent_queue.h"
+
+namespace google::scp::core::common::test {
+
+static constexpr size_t kQueueCapacity = 1 << 20;
+static constexpr int kMaxThreads = 16;
+
+/// Shared by all the threads of a benchmark run, created in the setup.
+static std::unique_ptr<ConcurrentQueue<uint64_t>> queue;
+
+static void CreateQueue(const benchmark::State& state) {
+  queue = std::make_unique<ConcurrentQueue<uint64_t>>(kQueueCapacity);
+}
+
+static void DestroyQueue(const benchmark::State& state) {
+  queue.reset();
+}
+
+/// Every thread enqueues and then dequeues an element, so producers and
+/// consumers contend on both ends of the queue.
+static void BM_EnqueueDequeue(benchmark::State& state) {
+  uint64_t element = state.thread_index();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(queue->TryEnqueue(element));
+    benchmark::DoNotOptimize(queue->TryDequeue(element));
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_EnqueueDequeue)
+    ->Setup(CreateQueue)
+    ->Teardown(DestroyQueue)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/// Half of the threads only enqueue and the other half only dequeue.
+static void BM_ProducerConsumer(benchmark::State& state) {
+  bool is_producer = state.thread_index() % 2 == 0;
+  uint64_t element = state.thread_index();
+  for (auto _ : state) {
+    if (is_producer) {
+      benchmark::DoNotOptimize(queue->TryEnqueue(element));
+    } else {
+      benchmark::DoNotOptimize(queue->TryDequeue(element));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ProducerConsumer)
+    ->Setup(CreateQueue)
+    ->Teardown(DestroyQueue)
+    ->ThreadRange(2, kMaxThreads)
+    ->UseRealTime();
+
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,75 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/lru_cache/src/lru_cache.h"
+
+namespace google::scp::core::common::test {
+
+static constexpr uint64_t kCapacity = 1 << 14;
+static constexpr int kMaxThreads = 16;
+
+/// Shared by all the threads of a benchmark run, created in the setup.
+static std::unique_ptr<LruCache<uint64_t, uint64_t>> cache;
+
+static void CreateFullCache(const benchmark::State& state) {
+  cache = std::make_unique<LruCache<uint64_t, uint64_t>>(kCapacity);
+  for (uint64_t key = 0; key < kCapacity; key++) {
+    cache->Set(key, key);
+  }
+}
+
+static void DestroyCache(const benchmark::State& state) {
+  cache.reset();
+}
+
+/// Threads read cached keys, which also refreshes them.
+static void BM_Get(benchmark::State& state) {
+  uint64_t key = state.thread_index() * (kCapacity / kMaxThreads);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache->Get(key));
+    key = (key + 1) % kCapacity;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Get)
+    ->Setup(CreateFullCache)
+    ->Teardown(DestroyCache)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/// Threads set new keys on a full cache, so every set evicts an entry.
+static void BM_SetWithEviction(benchmark::State& state) {
+  uint64_t key = (static_cast<uint64_t>(state.thread_index()) + 1) << 40;
+  for (auto _ : state) {
+    cache->Set(key, key);
+    key++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SetWithEviction)
+    ->Setup(CreateFullCache)
+    ->Teardown(DestroyCache)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "core/interface/config_provider_interface.h"
+
+namespace google::scp::core {
+class ConfigProviderUtils {
+ public:
+  /**
+   * @brief Reads a bool configuration, falling back to the default value if
+   * there is no config provider or the key is missing or malformed.
+   *
+   * @param config_provider The config provider to read from, may be null.
+   * @param key The configuration key.
+   * @param default_value The value to return if the key cannot be read.
+   * @return bool The configured value or the default one.
+   */
+  static bool GetBoolOrDefault(
+      const std::shared_ptr<ConfigProviderInterface>& config_provider,
+      const ConfigKey& key, bool default_value) noexcept {
+    bool value = default_value;
+    if (!config_provider || !config_provider->Get(key, value).Successful()) {
+      return default_value;
+    }
+    return value;
+  }
+};
+}  // namespace google::scp::core
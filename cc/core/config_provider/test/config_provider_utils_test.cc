@@ -0,0 +1,50 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/config_provider/src/config_provider_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "core/config_provider/mock/mock_config_provider.h"
+
+using google::scp::core::ConfigProviderUtils;
+using google::scp::core::config_provider::mock::MockConfigProvider;
+using std::make_shared;
+
+namespace google::scp::core::test {
+constexpr char kBoolKey[] = "bool_key";
+
+TEST(ConfigProviderUtilsTest, GetBoolOrDefaultReturnsTheConfiguredValue) {
+  auto config_provider = make_shared<MockConfigProvider>();
+  config_provider->SetBool(kBoolKey, true);
+  EXPECT_TRUE(
+      ConfigProviderUtils::GetBoolOrDefault(config_provider, kBoolKey, false));
+  config_provider->SetBool(kBoolKey, false);
+  EXPECT_FALSE(
+      ConfigProviderUtils::GetBoolOrDefault(config_provider, kBoolKey, true));
+}
+
+TEST(ConfigProviderUtilsTest, GetBoolOrDefaultFallsBackToTheDefault) {
+  auto config_provider = make_shared<MockConfigProvider>();
+  EXPECT_TRUE(
+      ConfigProviderUtils::GetBoolOrDefault(config_provider, kBoolKey, true));
+  EXPECT_FALSE(
+      ConfigProviderUtils::GetBoolOrDefault(config_provider, kBoolKey, false));
+  EXPECT_TRUE(ConfigProviderUtils::GetBoolOrDefault(nullptr, kBoolKey, true));
+}
+}  // namespace google::scp::core::test
@@ -83,4 +83,16 @@ DEFINE_ERROR_CODE(SC_CURL_CLIENT_REQUEST_BAD_REGEX_PARSING, SC_CURL_CLIENT,
                   0x0010, "Response code could not be parsed",
                   HttpStatusCode::BAD_REQUEST);
 
+DEFINE_ERROR_CODE(SC_CURL_CLIENT_MULTI_ENGINE_NOT_RUNNING, SC_CURL_CLIENT,
+                  0x0011, "Curl multi engine is not running",
+                  HttpStatusCode::SERVICE_UNAVAILABLE);
+
+DEFINE_ERROR_CODE(SC_CURL_CLIENT_MULTI_INIT_ERROR, SC_CURL_CLIENT, 0x0012,
+                  "Curl multi handle could not be created",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR);
+
+DEFINE_ERROR_CODE(SC_CURL_CLIENT_MULTI_ADD_HANDLE_ERROR, SC_CURL_CLIENT, 0x0013,
+                  "Curl handle could not be added to the multi handle",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR);
+
 }  // namespace google::scp::core::errors
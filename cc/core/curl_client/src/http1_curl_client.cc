@@ -42,20 +42,43 @@ Http1CurlClient::Http1CurlClient(
       operation_dispatcher_(io_async_executor,
                             RetryStrategy(retry_strategy_options)) {}
 
+Http1CurlClient::Http1CurlClient(
+    const shared_ptr<AsyncExecutorInterface>& cpu_async_executor,
+    const shared_ptr<AsyncExecutorInterface>& io_async_executor,
+    shared_ptr<Http1CurlMultiEngine> curl_multi_engine,
+    common::RetryStrategyOptions retry_strategy_options)
+    : curl_multi_engine_(curl_multi_engine),
+      cpu_async_executor_(cpu_async_executor),
+      io_async_executor_(io_async_executor),
+      operation_dispatcher_(io_async_executor,
+                            RetryStrategy(retry_strategy_options)) {}
+
 ExecutionResult Http1CurlClient::Init() noexcept {
+  if (curl_multi_engine_) {
+    return curl_multi_engine_->Init();
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult Http1CurlClient::Run() noexcept {
+  if (curl_multi_engine_) {
+    return curl_multi_engine_->Run();
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult Http1CurlClient::Stop() noexcept {
+  if (curl_multi_engine_) {
+    return curl_multi_engine_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult Http1CurlClient::PerformRequest(
     AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  if (curl_multi_engine_) {
+    return PerformRequestOnMultiEngine(http_context);
+  }
   auto wrapper_or = curl_wrapper_provider_->MakeWrapper();
   RETURN_IF_FAILURE(wrapper_or.result());
   operation_dispatcher_.Dispatch<AsyncContext<HttpRequest, HttpResponse>>(
@@ -78,4 +101,32 @@ ExecutionResult Http1CurlClient::PerformRequest(
   return SuccessExecutionResult();
 }
 
+ExecutionResult Http1CurlClient::PerformRequestOnMultiEngine(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  operation_dispatcher_.Dispatch<AsyncContext<HttpRequest, HttpResponse>>(
+      http_context, [this](auto& http_context) {
+        // The engine calls back on its event loop thread, so the context is
+        // finished on the CPU executor, and retried by the dispatcher on the
+        // IO executor.
+        return curl_multi_engine_->PerformRequest(
+            http_context.request,
+            [this, http_context](
+                ExecutionResultOr<HttpResponse> response_or) mutable {
+              if (!response_or.Successful()) {
+                SCP_ERROR_CONTEXT(kHttp1CurlClient, http_context,
+                                  response_or.result(),
+                                  "curl multi engine request failed.");
+                FinishContext(response_or.result(), http_context,
+                              cpu_async_executor_);
+                return;
+              }
+              http_context.response =
+                  make_shared<HttpResponse>(move(*response_or));
+              FinishContext(SuccessExecutionResult(), http_context,
+                            cpu_async_executor_);
+            });
+      });
+  return SuccessExecutionResult();
+}
+
 }  // namespace google::scp::core
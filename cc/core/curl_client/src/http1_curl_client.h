@@ -25,6 +25,7 @@
 #include "public/core/interface/execution_result.h"
 
 #include "error_codes.h"
+#include "http1_curl_multi_engine.h"
 #include "http1_curl_wrapper.h"
 
 namespace google::scp::core {
@@ -53,6 +54,26 @@ class Http1CurlClient : public HttpClientInterface {
                                        kDefaultRetryStrategyDelayInMs,
                                        kDefaultRetryStrategyMaxRetries));
 
+  /**
+   * @brief Construct a new CURL Client object performing its requests on the
+   * curl multi engine, which reuses the CURL handles and connections across
+   * requests instead of blocking an IO thread per request. The engine is
+   * initialized, run and stopped by the client.
+   *
+   * @param cpu_async_executor the executor the requests are finished on.
+   * @param io_async_executor the executor the requests are retried on.
+   * @param curl_multi_engine the engine performing the requests.
+   * @param retry_strategy_options retry strategy options.
+   */
+  Http1CurlClient(
+      const std::shared_ptr<AsyncExecutorInterface>& cpu_async_executor,
+      const std::shared_ptr<AsyncExecutorInterface>& io_async_executor,
+      std::shared_ptr<Http1CurlMultiEngine> curl_multi_engine,
+      common::RetryStrategyOptions retry_strategy_options =
+          common::RetryStrategyOptions(common::RetryStrategyType::Exponential,
+                                       kDefaultRetryStrategyDelayInMs,
+                                       kDefaultRetryStrategyMaxRetries));
+
   ExecutionResult Init() noexcept override;
   ExecutionResult Run() noexcept override;
   ExecutionResult Stop() noexcept override;
@@ -61,7 +82,13 @@ class Http1CurlClient : public HttpClientInterface {
       AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept override;
 
  private:
+  /// Performs the request on the curl multi engine.
+  ExecutionResult PerformRequestOnMultiEngine(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept;
+
   std::shared_ptr<Http1CurlWrapperProvider> curl_wrapper_provider_;
+  /// Performs the requests if set, instead of a wrapper per request.
+  std::shared_ptr<Http1CurlMultiEngine> curl_multi_engine_;
 
   const std::shared_ptr<AsyncExecutorInterface> cpu_async_executor_,
       io_async_executor_;
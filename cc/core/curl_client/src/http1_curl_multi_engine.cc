@@ -0,0 +1,235 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "http1_curl_multi_engine.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/common/global_logger/src/global_logger.h"
+#include "core/common/uuid/src/uuid.h"
+
+#include "error_codes.h"
+
+using google::scp::core::common::kZeroUuid;
+using std::make_unique;
+using std::move;
+using std::mutex;
+using std::shared_ptr;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+constexpr char kHttp1CurlMultiEngine[] = "Http1CurlMultiEngine";
+// The event loop is woken up by new requests and by the transfers, so this
+// only bounds the wait when curl has nothing to report.
+constexpr int kMultiPollTimeoutInMs = 1000;
+}  // namespace
+
+namespace google::scp::core {
+
+Http1CurlMultiEngine::Http1CurlMultiEngine(size_t max_idle_curl_handles)
+    : max_idle_curl_handles_(max_idle_curl_handles),
+      multi_handle_(nullptr),
+      is_running_(false) {}
+
+Http1CurlMultiEngine::~Http1CurlMultiEngine() {
+  if (is_running_) {
+    Stop();
+  }
+  // The CURL handles must be cleaned up before the multi handle they share
+  // the connections of.
+  idle_wrappers_.clear();
+  if (multi_handle_) {
+    curl_multi_cleanup(multi_handle_);
+  }
+}
+
+ExecutionResult Http1CurlMultiEngine::Init() noexcept {
+  multi_handle_ = curl_multi_init();
+  if (!multi_handle_) {
+    auto result =
+        FailureExecutionResult(errors::SC_CURL_CLIENT_MULTI_INIT_ERROR);
+    SCP_ERROR(kHttp1CurlMultiEngine, kZeroUuid, result,
+              "Failed to create the curl multi handle.");
+    return result;
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult Http1CurlMultiEngine::Run() noexcept {
+  if (!multi_handle_) {
+    return FailureExecutionResult(errors::SC_CURL_CLIENT_MULTI_INIT_ERROR);
+  }
+  is_running_ = true;
+  event_loop_thread_ = thread([this]() { EventLoop(); });
+  return SuccessExecutionResult();
+}
+
+ExecutionResult Http1CurlMultiEngine::Stop() noexcept {
+  if (!is_running_.exchange(false)) {
+    return SuccessExecutionResult();
+  }
+  curl_multi_wakeup(multi_handle_);
+  if (event_loop_thread_.joinable()) {
+    event_loop_thread_.join();
+  }
+
+  // The transfers which did not complete are failed, so that their callers
+  // do not wait forever.
+  auto result =
+      FailureExecutionResult(errors::SC_CURL_CLIENT_MULTI_ENGINE_NOT_RUNNING);
+  for (auto& [curl, transfer] : active_transfers_) {
+    curl_multi_remove_handle(multi_handle_, curl);
+    transfer->wrapper->CompleteRequest(CURLE_ABORTED_BY_CALLBACK,
+                                       transfer->prepared_request);
+    transfer->callback(result);
+  }
+  active_transfers_.clear();
+
+  vector<unique_ptr<Transfer>> pending_transfers;
+  {
+    unique_lock<mutex> lock(pending_transfers_mutex_);
+    pending_transfers.swap(pending_transfers_);
+  }
+  for (auto& transfer : pending_transfers) {
+    transfer->callback(result);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult Http1CurlMultiEngine::PerformRequest(
+    const shared_ptr<HttpRequest>& request, Callback callback) noexcept {
+  auto transfer = make_unique<Transfer>();
+  transfer->request = request;
+  transfer->callback = move(callback);
+  {
+    unique_lock<mutex> lock(pending_transfers_mutex_);
+    // Checked under the lock, so that Stop does not miss the transfer.
+    if (!is_running_) {
+      return FailureExecutionResult(
+          errors::SC_CURL_CLIENT_MULTI_ENGINE_NOT_RUNNING);
+    }
+    pending_transfers_.push_back(move(transfer));
+  }
+  curl_multi_wakeup(multi_handle_);
+  return SuccessExecutionResult();
+}
+
+void Http1CurlMultiEngine::EventLoop() noexcept {
+  while (is_running_) {
+    StartPendingTransfers();
+
+    int running_transfers = 0;
+    auto multi_result = curl_multi_perform(multi_handle_, &running_transfers);
+    if (multi_result != CURLM_OK) {
+      SCP_ERROR(kHttp1CurlMultiEngine, kZeroUuid,
+                FailureExecutionResult(SC_UNKNOWN),
+                "curl_multi_perform failed: %s",
+                curl_multi_strerror(multi_result));
+    }
+    CompleteDoneTransfers();
+
+    curl_multi_poll(multi_handle_, nullptr, 0, kMultiPollTimeoutInMs, nullptr);
+  }
+}
+
+void Http1CurlMultiEngine::StartPendingTransfers() noexcept {
+  vector<unique_ptr<Transfer>> pending_transfers;
+  {
+    unique_lock<mutex> lock(pending_transfers_mutex_);
+    pending_transfers.swap(pending_transfers_);
+  }
+
+  for (auto& transfer : pending_transfers) {
+    auto wrapper_or = AcquireWrapper();
+    if (!wrapper_or.Successful()) {
+      transfer->callback(wrapper_or.result());
+      continue;
+    }
+    transfer->wrapper = move(*wrapper_or);
+
+    auto execution_result = transfer->wrapper->PrepareRequest(
+        *transfer->request, transfer->prepared_request);
+    if (!execution_result.Successful()) {
+      ReleaseWrapper(move(transfer->wrapper));
+      transfer->callback(execution_result);
+      continue;
+    }
+
+    auto* curl = transfer->wrapper->GetCurlHandle();
+    auto multi_result = curl_multi_add_handle(multi_handle_, curl);
+    if (multi_result != CURLM_OK) {
+      auto result =
+          RetryExecutionResult(errors::SC_CURL_CLIENT_MULTI_ADD_HANDLE_ERROR);
+      SCP_ERROR(kHttp1CurlMultiEngine, kZeroUuid, result,
+                "curl_multi_add_handle failed: %s",
+                curl_multi_strerror(multi_result));
+      transfer->wrapper->CompleteRequest(CURLE_ABORTED_BY_CALLBACK,
+                                         transfer->prepared_request);
+      transfer->callback(result);
+      continue;
+    }
+    active_transfers_[curl] = move(transfer);
+  }
+}
+
+void Http1CurlMultiEngine::CompleteDoneTransfers() noexcept {
+  int remaining_messages = 0;
+  while (auto* message = curl_multi_info_read(multi_handle_,
+                                              &remaining_messages)) {
+    if (message->msg != CURLMSG_DONE) {
+      continue;
+    }
+    auto* curl = message->easy_handle;
+    // The message is freed by the removal of its handle.
+    auto perform_result = message->data.result;
+    curl_multi_remove_handle(multi_handle_, curl);
+
+    auto transfer_it = active_transfers_.find(curl);
+    if (transfer_it == active_transfers_.end()) {
+      continue;
+    }
+    auto transfer = move(transfer_it->second);
+    active_transfers_.erase(transfer_it);
+
+    auto response_or = transfer->wrapper->CompleteRequest(
+        perform_result, transfer->prepared_request);
+    ReleaseWrapper(move(transfer->wrapper));
+    transfer->callback(move(response_or));
+  }
+}
+
+ExecutionResultOr<shared_ptr<Http1CurlWrapper>>
+Http1CurlMultiEngine::AcquireWrapper() noexcept {
+  if (idle_wrappers_.empty()) {
+    return Http1CurlWrapper::MakeWrapper();
+  }
+  auto wrapper = move(idle_wrappers_.back());
+  idle_wrappers_.pop_back();
+  return wrapper;
+}
+
+void Http1CurlMultiEngine::ReleaseWrapper(
+    shared_ptr<Http1CurlWrapper> wrapper) noexcept {
+  if (idle_wrappers_.size() < max_idle_curl_handles_) {
+    idle_wrappers_.push_back(move(wrapper));
+  }
+}
+
+}  // namespace google::scp::core
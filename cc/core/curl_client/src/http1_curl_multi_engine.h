@@ -0,0 +1,118 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "core/interface/http_types.h"
+#include "core/interface/service_interface.h"
+#include "public/core/interface/execution_result.h"
+
+#include "http1_curl_wrapper.h"
+
+namespace google::scp::core {
+/// Maximum number of idle CURL handles kept for reuse by default.
+static constexpr size_t kDefaultMaxIdleCurlHandles = 64;
+
+/**
+ * @brief Performs HTTP1 requests concurrently on a curl multi handle, driven by
+ * a dedicated event loop thread, instead of blocking a thread per request.
+ *
+ * The CURL handles of the completed requests are kept for the next requests,
+ * and the multi handle keeps the connections alive across requests, so that
+ * requests to the same host do not pay for a new TCP/TLS handshake.
+ */
+class Http1CurlMultiEngine : public ServiceInterface {
+ public:
+  /// Called on the event loop thread once the request completes. Must not
+  /// block.
+  using Callback = std::function<void(ExecutionResultOr<HttpResponse>)>;
+
+  /**
+   * @brief Construct a new CURL multi engine object
+   *
+   * @param max_idle_curl_handles maximum number of CURL handles kept for
+   * reuse once their requests complete.
+   */
+  explicit Http1CurlMultiEngine(
+      size_t max_idle_curl_handles = kDefaultMaxIdleCurlHandles);
+
+  ~Http1CurlMultiEngine();
+
+  ExecutionResult Init() noexcept override;
+  ExecutionResult Run() noexcept override;
+  ExecutionResult Stop() noexcept override;
+
+  /**
+   * @brief Queues the request for the event loop thread.
+   *
+   * @param request the request, which must be kept alive until the callback.
+   * @param callback called with the response or the failure of the request.
+   * @return ExecutionResult whether the request was queued.
+   */
+  ExecutionResult PerformRequest(const std::shared_ptr<HttpRequest>& request,
+                                 Callback callback) noexcept;
+
+ protected:
+  /// A request being set up or transferred.
+  struct Transfer {
+    std::shared_ptr<HttpRequest> request;
+    Callback callback;
+    std::shared_ptr<Http1CurlWrapper> wrapper;
+    Http1CurlWrapper::PreparedRequest prepared_request;
+  };
+
+  /// Drives the transfers until the engine is stopped.
+  void EventLoop() noexcept;
+
+  /// Adds the queued requests to the multi handle.
+  void StartPendingTransfers() noexcept;
+
+  /// Completes the transfers which curl reports as done.
+  void CompleteDoneTransfers() noexcept;
+
+  /// Returns an idle CURL handle or a new one.
+  ExecutionResultOr<std::shared_ptr<Http1CurlWrapper>>
+  AcquireWrapper() noexcept;
+
+  /// Keeps the CURL handle for the next requests, if there is room.
+  void ReleaseWrapper(std::shared_ptr<Http1CurlWrapper> wrapper) noexcept;
+
+  const size_t max_idle_curl_handles_;
+  CURLM* multi_handle_;
+
+  /// Requests queued by PerformRequest and not yet picked up by the event
+  /// loop.
+  std::mutex pending_transfers_mutex_;
+  std::vector<std::unique_ptr<Transfer>> pending_transfers_;
+
+  /// Only accessed by the event loop thread while running.
+  std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_transfers_;
+  std::vector<std::shared_ptr<Http1CurlWrapper>> idle_wrappers_;
+
+  std::atomic<bool> is_running_;
+  std::thread event_loop_thread_;
+};
+}  // namespace google::scp::core
@@ -281,9 +281,21 @@ void Http1CurlWrapper::SetUpPutData(const BytesBuffer& body) {
 // body of the response.
 ExecutionResultOr<HttpResponse> Http1CurlWrapper::PerformRequest(
     const HttpRequest& request) {
+  PreparedRequest prepared_request;
+  RETURN_IF_FAILURE(PrepareRequest(request, prepared_request));
+
+  // Execute the request.
+  CURLcode perform_res = curl_easy_perform(curl_.get());
+  return CompleteRequest(perform_res, prepared_request);
+}
+
+ExecutionResult Http1CurlWrapper::PrepareRequest(
+    const HttpRequest& request, PreparedRequest& prepared_request) {
   if (!request.path || request.path->empty()) {
     return FailureExecutionResult(errors::SC_CURL_CLIENT_NO_PATH_SUPPLIED);
   }
+  // Options of a previous request on this handle must not leak into this one.
+  curl_easy_reset(curl_.get());
   CURLoption option;
   switch (request.method) {
     case HttpMethod::GET:
@@ -305,37 +317,52 @@ ExecutionResultOr<HttpResponse> Http1CurlWrapper::PerformRequest(
 
   auto header_list = AddHeadersToRequest(request.headers);
   RETURN_IF_FAILURE(header_list.result());
+  // There is no header list if the request has no headers.
+  if (header_list.has_value()) {
+    prepared_request.header_list = move(*header_list);
+  }
   // Build the URL with the escaped path.
   auto uri = GetEscapedUriWithQuery(request);
   RETURN_IF_FAILURE(uri.result());
 
+  // CURLOPT_URL copies the string.
   curl_easy_setopt(curl_.get(), CURLOPT_URL, uri->c_str());
 
-  HttpResponse response;
-  response.headers = make_shared<HttpHeaders>();
-  SetUpResponseHeaderHandler(response.headers.get());
+  prepared_request.response.headers = make_shared<HttpHeaders>();
+  SetUpResponseHeaderHandler(prepared_request.response.headers.get());
 
   // Add the handler indicating what to do with the returned HTTP response.
   curl_easy_setopt(curl_.get(), CURLOPT_WRITEFUNCTION, ResponsePayloadHandler);
-  curl_easy_setopt(curl_.get(), CURLOPT_WRITEDATA, &response.body);
+  curl_easy_setopt(curl_.get(), CURLOPT_WRITEDATA,
+                   &prepared_request.response.body);
   curl_easy_setopt(curl_.get(), CURLOPT_TIMEOUT, kCurlOptTimeout);
   curl_easy_setopt(curl_.get(), CURLOPT_FAILONERROR, kTrueAsLong);
   // Create a buffer to place any error messages in.
-  string err_str(CURL_ERROR_SIZE, '\0');
-  curl_easy_setopt(curl_.get(), CURLOPT_ERRORBUFFER, err_str.data());
+  prepared_request.error_buffer = string(CURL_ERROR_SIZE, '\0');
+  curl_easy_setopt(curl_.get(), CURLOPT_ERRORBUFFER,
+                   prepared_request.error_buffer.data());
+  return SuccessExecutionResult();
+}
 
-  // Execute the request.
-  CURLcode perform_res = curl_easy_perform(curl_.get());
-  if (perform_res != CURLE_OK) {
+ExecutionResultOr<HttpResponse> Http1CurlWrapper::CompleteRequest(
+    CURLcode perform_result, PreparedRequest& prepared_request) {
+  // The request data is not needed anymore, and the handle must not point to
+  // the freed error buffer when it is reused.
+  curl_easy_setopt(curl_.get(), CURLOPT_ERRORBUFFER, nullptr);
+  curl_easy_setopt(curl_.get(), CURLOPT_HTTPHEADER, nullptr);
+  prepared_request.header_list.reset();
+
+  auto& err_str = prepared_request.error_buffer;
+  if (perform_result != CURLE_OK) {
     auto result = GetExecutionResultFromCurlError(err_str);
     if (err_str.empty()) err_str = "<empty>";
     SCP_ERROR(kHttp1CurlWrapper, kZeroUuid, result,
               "CURL HTTP request failed with error code: %s, message: %s",
-              curl_easy_strerror(perform_res), err_str.c_str());
+              curl_easy_strerror(perform_result), err_str.c_str());
     return result;
   }
-  response.code = errors::HttpStatusCode::OK;
-  return response;
+  prepared_request.response.code = errors::HttpStatusCode::OK;
+  return move(prepared_request.response);
 }
 
 Http1CurlWrapper::Http1CurlWrapper(CURL* curl) {
@@ -47,6 +47,28 @@ class Http1CurlWrapper {
   virtual ExecutionResultOr<HttpResponse> PerformRequest(
       const HttpRequest& request);
 
+  // State of a request set up on the CURL handle, which must outlive the
+  // transfer.
+  struct PreparedRequest {
+    std::unique_ptr<curl_slist, CurlListDeleter> header_list;
+    HttpResponse response;
+    std::string error_buffer;
+  };
+
+  // Resets the CURL handle and sets up the request on it, so that it can be
+  // performed with curl_easy_perform or a curl multi handle. The CURL handle
+  // keeps its connections and caches across requests.
+  ExecutionResult PrepareRequest(const HttpRequest& request,
+                                 PreparedRequest& prepared_request);
+
+  // Returns the status of the performed request if it failed or its
+  // HttpResponse. Logs any error that occurs.
+  ExecutionResultOr<HttpResponse> CompleteRequest(
+      CURLcode perform_result, PreparedRequest& prepared_request);
+
+  // Returns the CURL handle of the wrapper.
+  CURL* GetCurlHandle() { return curl_.get(); }
+
   virtual ~Http1CurlWrapper() = default;
 
  private:
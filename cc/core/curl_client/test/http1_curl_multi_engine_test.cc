@@ -0,0 +1,224 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/curl_client/src/http1_curl_multi_engine.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/async_executor/src/async_executor.h"
+#include "core/curl_client/src/error_codes.h"
+#include "core/curl_client/src/http1_curl_client.h"
+#include "core/test/utils/conditional_wait.h"
+#include "core/test/utils/http1_helper/test_http1_server.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using boost::beast::http::status;
+using std::atomic;
+using std::atomic_bool;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google::scp::core::test {
+namespace {
+
+class Http1CurlMultiEngineForTest : public Http1CurlMultiEngine {
+ public:
+  using Http1CurlMultiEngine::Http1CurlMultiEngine;
+
+  // Only safe to call while no request is in flight.
+  size_t IdleCurlHandleCount() const { return idle_wrappers_.size(); }
+};
+
+class Http1CurlMultiEngineTest : public ::testing::Test {
+ protected:
+  Http1CurlMultiEngineTest() {
+    EXPECT_SUCCESS(engine_.Init());
+    EXPECT_SUCCESS(engine_.Run());
+  }
+
+  ~Http1CurlMultiEngineTest() { EXPECT_SUCCESS(engine_.Stop()); }
+
+  shared_ptr<HttpRequest> MakeRequest(HttpMethod method) {
+    auto request = make_shared<HttpRequest>();
+    request->method = method;
+    request->path = make_shared<Uri>(server_.GetPath());
+    return request;
+  }
+
+  // Performs the request and waits for its response.
+  ExecutionResultOr<HttpResponse> PerformAndWait(
+      const shared_ptr<HttpRequest>& request) {
+    atomic_bool finished(false);
+    ExecutionResultOr<HttpResponse> response_or =
+        FailureExecutionResult(SC_UNKNOWN);
+    EXPECT_SUCCESS(engine_.PerformRequest(
+        request, [&](ExecutionResultOr<HttpResponse> result_or) {
+          response_or = std::move(result_or);
+          finished = true;
+        }));
+    WaitUntil([&finished]() { return finished.load(); });
+    return response_or;
+  }
+
+  TestHttp1Server server_;
+  Http1CurlMultiEngineForTest engine_;
+};
+
+TEST_F(Http1CurlMultiEngineTest, GetWorks) {
+  server_.SetResponseBody(BytesBuffer("response"));
+
+  auto response_or = PerformAndWait(MakeRequest(HttpMethod::GET));
+  ASSERT_SUCCESS(response_or.result());
+  EXPECT_EQ(response_or->code, errors::HttpStatusCode::OK);
+  EXPECT_EQ(response_or->body.ToString(), "response");
+  EXPECT_EQ(server_.Request().method(), boost::beast::http::verb::get);
+}
+
+TEST_F(Http1CurlMultiEngineTest, PostWorksWithHeaders) {
+  auto request = MakeRequest(HttpMethod::POST);
+  request->body = BytesBuffer("request");
+  request->headers = make_shared<HttpHeaders>();
+  request->headers->insert({"key1", "val1"});
+  server_.SetResponseBody(BytesBuffer("response"));
+  server_.SetResponseHeaders(HttpHeaders({{"resp1", "resp_val1"}}));
+
+  auto response_or = PerformAndWait(request);
+  ASSERT_SUCCESS(response_or.result());
+  EXPECT_EQ(response_or->body.ToString(), "response");
+  EXPECT_EQ(response_or->headers->count("resp1"), 1);
+  EXPECT_EQ(server_.Request().method(), boost::beast::http::verb::post);
+  EXPECT_EQ(server_.RequestBody(), "request");
+  EXPECT_EQ(GetRequestHeadersMap(server_.Request()).count("key1"), 1);
+}
+
+TEST_F(Http1CurlMultiEngineTest, HttpErrorIsReturned) {
+  server_.SetResponseStatus(status::service_unavailable);
+
+  auto response_or = PerformAndWait(MakeRequest(HttpMethod::GET));
+  EXPECT_THAT(response_or.result(),
+              ResultIs(RetryExecutionResult(
+                  errors::SC_CURL_CLIENT_REQUEST_SERVICE_UNAVAILABLE)));
+}
+
+TEST_F(Http1CurlMultiEngineTest, InvalidRequestIsReturned) {
+  auto request = MakeRequest(HttpMethod::GET);
+  request->path = nullptr;
+
+  auto response_or = PerformAndWait(request);
+  EXPECT_THAT(response_or.result(),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CURL_CLIENT_NO_PATH_SUPPLIED)));
+}
+
+TEST_F(Http1CurlMultiEngineTest, CurlHandlesAreReused) {
+  server_.SetResponseBody(BytesBuffer("response"));
+  // Neither a successful nor a failed request leaks options to the next
+  // request on the same handle.
+  auto post_request = MakeRequest(HttpMethod::POST);
+  post_request->body = BytesBuffer("request");
+  post_request->headers = make_shared<HttpHeaders>();
+  post_request->headers->insert({"key1", "val1"});
+  EXPECT_SUCCESS(PerformAndWait(post_request).result());
+  EXPECT_EQ(engine_.IdleCurlHandleCount(), 1);
+
+  server_.SetResponseStatus(status::not_found);
+  EXPECT_FALSE(PerformAndWait(MakeRequest(HttpMethod::GET)).Successful());
+  EXPECT_EQ(engine_.IdleCurlHandleCount(), 1);
+
+  server_.SetResponseStatus(status::ok);
+  auto response_or = PerformAndWait(MakeRequest(HttpMethod::GET));
+  ASSERT_SUCCESS(response_or.result());
+  EXPECT_EQ(response_or->body.ToString(), "response");
+  EXPECT_EQ(server_.Request().method(), boost::beast::http::verb::get);
+  EXPECT_EQ(GetRequestHeadersMap(server_.Request()).count("key1"), 0);
+  EXPECT_EQ(engine_.IdleCurlHandleCount(), 1);
+}
+
+TEST_F(Http1CurlMultiEngineTest, ConcurrentRequestsComplete) {
+  server_.SetResponseBody(BytesBuffer("response"));
+  constexpr size_t kRequestCount = 10;
+  vector<shared_ptr<HttpRequest>> requests;
+  atomic<size_t> succeeded_count(0);
+  atomic<size_t> finished_count(0);
+  for (size_t i = 0; i < kRequestCount; ++i) {
+    requests.push_back(MakeRequest(HttpMethod::GET));
+    EXPECT_SUCCESS(engine_.PerformRequest(
+        requests.back(), [&](ExecutionResultOr<HttpResponse> response_or) {
+          if (response_or.Successful() &&
+              response_or->body.ToString() == "response") {
+            succeeded_count++;
+          }
+          finished_count++;
+        }));
+  }
+  WaitUntil([&]() { return finished_count.load() == kRequestCount; });
+  EXPECT_EQ(succeeded_count.load(), kRequestCount);
+}
+
+TEST_F(Http1CurlMultiEngineTest, StoppedEngineRejectsRequests) {
+  EXPECT_SUCCESS(engine_.Stop());
+  EXPECT_THAT(engine_.PerformRequest(MakeRequest(HttpMethod::GET),
+                                     [](ExecutionResultOr<HttpResponse>) {
+                                       ADD_FAILURE();
+                                     }),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CURL_CLIENT_MULTI_ENGINE_NOT_RUNNING)));
+}
+
+TEST(Http1CurlClientOnMultiEngineTest, PerformsRequestsOnEngine) {
+  TestHttp1Server server;
+  server.SetResponseBody(BytesBuffer("response"));
+  auto cpu_async_executor =
+      make_shared<AsyncExecutor>(/*thread_count=*/2, /*queue_cap=*/10);
+  auto io_async_executor =
+      make_shared<AsyncExecutor>(/*thread_count=*/2, /*queue_cap=*/10);
+  EXPECT_SUCCESS(cpu_async_executor->Init());
+  EXPECT_SUCCESS(io_async_executor->Init());
+  EXPECT_SUCCESS(cpu_async_executor->Run());
+  EXPECT_SUCCESS(io_async_executor->Run());
+
+  Http1CurlClient client(cpu_async_executor, io_async_executor,
+                         make_shared<Http1CurlMultiEngine>());
+  EXPECT_SUCCESS(client.Init());
+  EXPECT_SUCCESS(client.Run());
+
+  atomic_bool finished(false);
+  AsyncContext<HttpRequest, HttpResponse> http_context;
+  http_context.request = make_shared<HttpRequest>();
+  http_context.request->method = HttpMethod::GET;
+  http_context.request->path = make_shared<Uri>(server.GetPath());
+  http_context.callback = [&finished](auto& http_context) {
+    EXPECT_SUCCESS(http_context.result);
+    ASSERT_TRUE(http_context.response);
+    EXPECT_EQ(http_context.response->body.ToString(), "response");
+    finished = true;
+  };
+  EXPECT_SUCCESS(client.PerformRequest(http_context));
+  WaitUntil([&finished]() { return finished.load(); });
+
+  EXPECT_SUCCESS(client.Stop());
+  EXPECT_SUCCESS(io_async_executor->Stop());
+  EXPECT_SUCCESS(cpu_async_executor->Stop());
+}
+
+}  // namespace
+}  // namespace google::scp::core::test
@@ -22,10 +22,12 @@
 #include <utility>
 #include <vector>
 
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "public/core/interface/execution_result.h"
 
 #include "http2_utils.h"
 
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::http2_server::Http2Utils;
 using std::bind;
 using std::copy;
@@ -120,7 +122,7 @@ ExecutionResult NgHttp2Request::UnwrapNgHttp2Request() noexcept {
           core::errors::SC_HTTP2_SERVER_INVALID_HEADER);
     }
   }
-  body.bytes = make_shared<vector<Byte>>(content_length);
+  body.bytes = BytesBufferPool::AllocateBytes(content_length);
   body.length = 0;
   body.capacity = content_length;
   return SuccessExecutionResult();
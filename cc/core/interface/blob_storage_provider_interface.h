@@ -79,6 +79,12 @@ struct ListBlobsResponse {
 struct PutBlobRequest : BlobRequest {
   /// Buffer to be written to the blob.
   std::shared_ptr<BytesBuffer> buffer;
+  /**
+   * @brief If buffer is not set, the buffers written to the blob one after
+   * another, e.g. to write bytes owned by several callers without gathering
+   * them first. The first length bytes of each segment are written.
+   */
+  std::vector<std::shared_ptr<BytesBuffer>> buffer_segments;
 };
 
 /// Represents the put blob response object.
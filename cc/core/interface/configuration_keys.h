@@ -24,6 +24,13 @@ static constexpr char kGcpProjectId[] = "google_scp_gcp_project_id";
 // GCP Cloud Spanner
 static constexpr char kSpannerInstance[] = "google_scp_spanner_instance_name";
 static constexpr char kSpannerDatabase[] = "google_scp_spanner_database_name";
+// Number of threads of the dedicated executor of the blocking Spanner calls.
+// If set, Spanner calls run on that executor rather than on the IO executor.
+static constexpr char kSpannerCallExecutorThreadCount[] =
+    "google_scp_spanner_call_executor_thread_count";
+// Queue capacity of the dedicated executor of the Spanner calls.
+static constexpr char kSpannerCallExecutorQueueCap[] =
+    "google_scp_spanner_call_executor_queue_cap";
 // Skip a log if unable to apply during log recovery
 static constexpr char kTransactionManagerSkipFailedLogsInRecovery[] =
     "google_scp_transaction_manager_skip_failed_logs_in_recovery";
@@ -43,8 +50,19 @@ static constexpr char kPBSJournalInputStreamNumberOfJournalsPerBatch[] =
     "google_scp_pbs_journal_input_stream_number_of_journals_per_batch";
 static constexpr char kPBSJournalInputStreamNumberOfJournalLogsToReturn[] =
     "google_scp_pbs_journal_input_stream_number_of_journal_logs_to_return";
+// The segments of the journal local tier, if enabled by its path.
+static constexpr char kPBSJournalServiceLocalTierSegmentByteSize[] =
+    "google_scp_pbs_journal_service_local_tier_segment_byte_size";
+static constexpr char kPBSJournalServiceLocalTierSegmentCount[] =
+    "google_scp_pbs_journal_service_local_tier_segment_count";
+// Writes the journal logs with a checksum. Only enable once all the readers of
+// the journals can read checksummed logs.
+static constexpr char kPBSJournalServiceChecksumLogs[] =
+    "google_scp_pbs_journal_service_checksum_logs";
 static constexpr char kTransactionManagerSkipDuplicateTransactionInRecovery[] =
     "google_scp_transaction_manager_skip_duplicate_transaction_in_recovery";
+static constexpr char kTransactionManagerCoalescePhaseLogs[] =
+    "google_scp_transaction_manager_coalesce_phase_logs";
 static constexpr char kSpannerEndpointOverride[] =
     "google_scp_core_spanner_endpoint_override";
 static constexpr char kPBSAdtechSiteAsAuthorizedDomain[] =
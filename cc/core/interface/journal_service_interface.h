@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "core/common/uuid/src/uuid.h"
 
@@ -38,6 +39,14 @@ enum class JournalLogStatus {
   EndLogGroup = 2,
 };
 
+/// Represents a log of a component journaled as part of a log group.
+struct JournalLogRecord {
+  /// The component id of the record, which replays it on recovery.
+  common::Uuid component_id;
+  /// The serialized data of the record.
+  std::shared_ptr<BytesBuffer> data;
+};
+
 /**
  * @brief Represents the journal log request object. This object is used cross
  * code base to store the current memory and state and recover in the case of
@@ -53,8 +62,13 @@ struct JournalLogRequest {
   common::Uuid log_id;
   /// The status of the current journal log.
   JournalLogStatus log_status;
-  /// The serialized data the need to be stored.
+  /// The serialized data the need to be stored. The data is written in place,
+  /// so it must not be modified until the request is finished.
   std::shared_ptr<BytesBuffer> data;
+  /// If not empty, the records are journaled as a single entry instead of the
+  /// data, and are replayed in order by their components on recovery. The
+  /// entry is owned by the component id of the request for deduplication.
+  std::vector<JournalLogRecord> records;
 };
 
 /// Contains journal logs response info.
@@ -78,6 +92,11 @@ struct JournalRecoverRequest {
   /// Should perform Recovery if there is only a checkpoint to be
   /// recovered in the stream but no journals to be recovered.
   bool should_perform_recovery_with_only_checkpoint_in_stream = true;
+  /// If set, the checkpoint is not read and only the journals written after
+  /// this journal id are replayed. This allows a caller that has already
+  /// recovered up to this journal id, e.g. a standby partition, to catch up
+  /// incrementally instead of performing a full recovery.
+  JournalId start_after_journal_id = kInvalidJournalId;
 };
 
 /// Represents journal recovery response object.
@@ -175,5 +194,17 @@ class JournalServiceInterface : public ServiceInterface {
    * @brief Stop recovery metrics.
    */
   virtual ExecutionResult StopRecoveryMetrics() noexcept = 0;
+
+  /**
+   * @brief Attaches the local tier of the journals to a journal service that
+   * was initialized without one, e.g. the journal service of a standby
+   * partition that gets promoted. Must be called before Run().
+   *
+   * @param local_tier_path The directory of the local tier. Nothing is
+   * attached if empty.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult AttachLocalTier(
+      const std::shared_ptr<std::string>& local_tier_path) noexcept = 0;
 };
 }  // namespace google::scp::core
@@ -273,6 +273,30 @@ class LeasableLockInterface {
   virtual bool IsCurrentLeaseOwner() const noexcept = 0;
 };
 
+/**
+ * @brief Interface to refresh the leases of several leasable locks together,
+ * e.g. with a single round trip to the underlying database instead of one per
+ * lock.
+ */
+class LeasableLockBatchRefresherInterface {
+ public:
+  virtual ~LeasableLockBatchRefresherInterface() = default;
+
+  /**
+   * @brief Refreshes lease on each of the locks, with the same semantics as
+   * LeasableLockInterface::RefreshLease() on every lock.
+   *
+   * @param leasable_locks the locks to refresh lease on.
+   * @param is_read_only_lease_refresh whether the refresh of the lock at the
+   * same index is read only.
+   * @return std::vector<ExecutionResult> the result of the refresh of the lock
+   * at the same index.
+   */
+  virtual std::vector<ExecutionResult> RefreshLeases(
+      const std::vector<std::shared_ptr<LeasableLockInterface>>& leasable_locks,
+      const std::vector<bool>& is_read_only_lease_refresh) noexcept = 0;
+};
+
 /**
  * @brief LeaseManagerInterface provides interface for lease acquisition and
  * maintenance.
@@ -81,11 +81,54 @@ struct GetDatabaseItemResponse : SingleDatabaseItemResponse {};
 struct UpsertDatabaseItemRequest : SingleDatabaseItemRequest {
   /// Attributes associated with the upsert record.
   std::shared_ptr<std::vector<NoSqlDatabaseKeyValuePair>> new_attributes;
+  /// Whether new_attributes are all the attributes of the record. If so, the
+  /// existing attributes which are not in new_attributes may be dropped, which
+  /// lets providers write the record without reading it first.
+  bool replace_existing_attributes = false;
 };
 
 /// Upsert database item response object.
 struct UpsertDatabaseItemResponse : SingleDatabaseItemRequest {};
 
+/// Batch get database items request object.
+struct BatchGetDatabaseItemsRequest {
+  virtual ~BatchGetDatabaseItemsRequest() = default;
+
+  /// The items to get, possibly from different tables.
+  std::vector<std::shared_ptr<GetDatabaseItemRequest>> items;
+};
+
+/// Batch get database items response object.
+struct BatchGetDatabaseItemsResponse {
+  virtual ~BatchGetDatabaseItemsResponse() = default;
+
+  /// The result of every item, in the order of the request items.
+  std::vector<ExecutionResult> item_results;
+  /// The response of every item, in the order of the request items. Only set
+  /// for the successful items.
+  std::vector<std::shared_ptr<GetDatabaseItemResponse>> items;
+};
+
+/// Batch upsert database items request object.
+struct BatchUpsertDatabaseItemsRequest {
+  virtual ~BatchUpsertDatabaseItemsRequest() = default;
+
+  /// The items to upsert, possibly in different tables. An item must not be
+  /// upserted more than once in a batch.
+  std::vector<std::shared_ptr<UpsertDatabaseItemRequest>> items;
+};
+
+/// Batch upsert database items response object.
+struct BatchUpsertDatabaseItemsResponse {
+  virtual ~BatchUpsertDatabaseItemsResponse() = default;
+
+  /// The result of every item, in the order of the request items.
+  std::vector<ExecutionResult> item_results;
+  /// The response of every item, in the order of the request items. Only set
+  /// for the successful items.
+  std::vector<std::shared_ptr<UpsertDatabaseItemResponse>> items;
+};
+
 /**
  * @brief NoSQLDatabase provides database access APIs for single records.
  */
@@ -114,5 +157,34 @@ class NoSQLDatabaseProviderInterface : public ServiceInterface {
   virtual ExecutionResult UpsertDatabaseItem(
       AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>&
           upsert_database_item_context) noexcept = 0;
+
+  /**
+   * @brief Gets multiple database records with as few round trips as the
+   * database allows. Every item succeeds or fails on its own, the batch
+   * context only fails if the batch could not be executed at all.
+   *
+   * @param batch_get_database_items_context The context object for the
+   * database operation.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult BatchGetDatabaseItems(
+      AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+          batch_get_database_items_context) noexcept = 0;
+
+  /**
+   * @brief Upserts multiple database records with as few round trips as the
+   * database allows. Every item succeeds or fails on its own, the batch
+   * context only fails if the batch could not be executed at all. Items with
+   * attribute conditions, or which do not replace the existing attributes,
+   * may be upserted one by one.
+   *
+   * @param batch_upsert_database_items_context The context object for the
+   * database operation.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult BatchUpsertDatabaseItems(
+      AsyncContext<BatchUpsertDatabaseItemsRequest,
+                   BatchUpsertDatabaseItemsResponse>&
+          batch_upsert_database_items_context) noexcept = 0;
 };
 }  // namespace google::scp::core
@@ -19,6 +19,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "core/common/concurrent_queue/src/concurrent_queue.h"
@@ -50,7 +51,7 @@ struct StreamingContext : public AsyncContext<TRequest, TResponse> {
    * be.
    *
    */
-  void MarkDone() noexcept { is_marked_done->store(true); }
+  virtual void MarkDone() noexcept { is_marked_done->store(true); }
 
   /**
    * @brief Returns true if this context is marked done.
@@ -65,7 +66,7 @@ struct StreamingContext : public AsyncContext<TRequest, TResponse> {
    * communicate to the SDK/callee to cancel.
    *
    */
-  void TryCancel() noexcept { is_cancelled->store(true); }
+  virtual void TryCancel() noexcept { is_cancelled->store(true); }
 
   /**
    * @brief Returns true if this context has been tried to be cancelled.
@@ -242,11 +243,41 @@ struct ProducerStreamingContext : public StreamingContext<TRequest, TResponse> {
    */
   explicit ProducerStreamingContext(size_t max_num_outstanding_requests = 50000)
       : request_queue(std::make_shared<common::ConcurrentQueue<TRequest>>(
-            max_num_outstanding_requests)) {}
+            max_num_outstanding_requests)),
+        request_notifier(std::make_shared<RequestNotifier>()) {}
 
   ProducerStreamingContext(const ProducerStreamingContext& right)
       : BaseClass(right) {
     request_queue = right.request_queue;
+    request_notifier = right.request_notifier;
+  }
+
+  /**
+   * @brief Sets the function called after a request is pushed, and after the
+   * context is marked done or cancelled, so that the callee does not have to
+   * poll for them. The function is shared by all the copies of the context
+   * and is cleared when the context is finished.
+   *
+   * Generally, the SDK/callee uses this function.
+   *
+   * @param notifier The function to call. It may be called on any thread,
+   * including the one pushing the request.
+   */
+  void SetRequestNotifier(std::function<void()> notifier) noexcept {
+    std::lock_guard<std::mutex> lock(request_notifier->mutex);
+    request_notifier->notify = std::move(notifier);
+  }
+
+  /// Marks the context as done and notifies the callee.
+  void MarkDone() noexcept override {
+    BaseClass::MarkDone();
+    NotifyRequest();
+  }
+
+  /// Tries to cancel the operation and notifies the callee.
+  void TryCancel() noexcept override {
+    BaseClass::TryCancel();
+    NotifyRequest();
   }
 
   /**
@@ -264,7 +295,11 @@ struct ProducerStreamingContext : public StreamingContext<TRequest, TResponse> {
     if (this->IsCancelled()) {
       return FailureExecutionResult(errors::SC_STREAMING_CONTEXT_CANCELLED);
     }
-    return request_queue->TryEnqueue(std::move(req));
+    auto execution_result = request_queue->TryEnqueue(std::move(req));
+    if (execution_result.Successful()) {
+      NotifyRequest();
+    }
+    return execution_result;
   }
 
   /**
@@ -281,10 +316,38 @@ struct ProducerStreamingContext : public StreamingContext<TRequest, TResponse> {
     return std::make_unique<TRequest>(std::move(req));
   }
 
+  /// Finishes the async operation by calling the callback.
+  void Finish() noexcept override {
+    // The notifier usually holds a copy of this context, clearing it breaks
+    // the reference cycle.
+    SetRequestNotifier(nullptr);
+    BaseClass::Finish();
+  }
+
  private:
+  struct RequestNotifier {
+    std::mutex mutex;
+    std::function<void()> notify;
+  };
+
+  /// Calls the notifier, if any, outside of its lock so that it may finish
+  /// the context.
+  void NotifyRequest() noexcept {
+    std::function<void()> notify;
+    {
+      std::lock_guard<std::mutex> lock(request_notifier->mutex);
+      notify = request_notifier->notify;
+    }
+    if (notify) {
+      notify();
+    }
+  }
+
   /// ConcurrentQueue used by the caller to communicate messages to the
   /// callee.
   std::shared_ptr<common::ConcurrentQueue<TRequest>> request_queue;
+  /// Notifies the callee of new requests, shared by the copies of the context.
+  std::shared_ptr<RequestNotifier> request_notifier;
 };
 
 /**
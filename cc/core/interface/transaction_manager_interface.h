@@ -91,6 +91,11 @@ struct TransactionRequest {
   /// Whether this transaction request is executed as part of the journal
   /// recovery process.
   bool is_journal_recovery = false;
+  /// Indicates whether all the phases of a locally coordinated transaction are
+  /// executed in one go. Only the transaction, its commit decision and its end
+  /// are journaled, and the transaction is aborted if it is recovered before
+  /// its commit decision.
+  bool is_phase_collapsed = false;
 };
 
 /**
@@ -79,6 +79,12 @@ struct JournalStreamAppendLogRequest {
   JournalLogStatus log_status;
   /// Log to be appended to the log stream.
   std::shared_ptr<journal_service::JournalLog> journal_log;
+  /**
+   * @brief If set, the body of the log, which is written in place of the
+   * log_body of journal_log, and must not be modified until the log is
+   * flushed. journal_log must not have a log_body then.
+   */
+  std::shared_ptr<BytesBuffer> log_body;
 };
 
 /// Represents the journal stream append response.
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "core/interface/blob_storage_provider_interface.h"
+#include "core/journal_service/src/journal_local_tier.h"
+
+namespace google::scp::core::journal_service::mock {
+class MockJournalLocalTier : public core::JournalLocalTier {
+ public:
+  MockJournalLocalTier(const std::shared_ptr<std::string>& bucket_name,
+                       const std::string& blob_name_prefix,
+                       const std::string& directory_path,
+                       size_t segment_byte_size, size_t segment_count,
+                       const std::shared_ptr<BlobStorageClientInterface>&
+                           remote_blob_storage_client)
+      : core::JournalLocalTier(bucket_name, blob_name_prefix, directory_path,
+                               segment_byte_size, segment_count,
+                               remote_blob_storage_client) {}
+
+  using core::JournalLocalTier::ShipPendingBlobs;
+};
+}  // namespace google::scp::core::journal_service::mock
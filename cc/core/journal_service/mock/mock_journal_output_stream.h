@@ -21,6 +21,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "core/interface/blob_storage_provider_interface.h"
 #include "core/journal_service/src/journal_output_stream.h"
@@ -34,11 +35,13 @@ class MockJournalOutputStream : public core::JournalOutputStream {
       const std::shared_ptr<std::string>& partition_name,
       const std::shared_ptr<AsyncExecutorInterface>& async_executor,
       const std::shared_ptr<BlobStorageClientInterface>&
-          blob_storage_provider_client)
+          blob_storage_provider_client,
+      bool should_checksum_logs = false)
       : core::JournalOutputStream(
             bucket_name, partition_name, async_executor,
             blob_storage_provider_client,
-            std::make_shared<cpio::MockAggregateMetric>()) {}
+            std::make_shared<cpio::MockAggregateMetric>(),
+            should_checksum_logs) {}
 
   std::function<ExecutionResult(
       AsyncContext<journal_service::JournalStreamAppendLogRequest,
@@ -57,10 +60,21 @@ class MockJournalOutputStream : public core::JournalOutputStream {
       BytesBuffer&, size_t&)>
       serialize_log_mock;
 
+  std::function<ExecutionResult(
+      AsyncContext<journal_service::JournalStreamAppendLogRequest,
+                   journal_service::JournalStreamAppendLogResponse>&,
+      std::vector<std::shared_ptr<BytesBuffer>>&, size_t&)>
+      serialize_log_segments_mock;
+
   std::function<ExecutionResult(BytesBuffer&, uint64_t,
                                 std::function<void(ExecutionResult&)>)>
       write_journal_blob_mock;
 
+  std::function<ExecutionResult(std::vector<std::shared_ptr<BytesBuffer>>&,
+                                uint64_t,
+                                std::function<void(ExecutionResult&)>)>
+      write_journal_blob_segments_mock;
+
   std::function<void(
       JournalId journal_id, std::function<void(ExecutionResult&)> callback,
       AsyncContext<PutBlobRequest, PutBlobResponse>& pub_blob_context)>
@@ -114,6 +128,20 @@ class MockJournalOutputStream : public core::JournalOutputStream {
                                              buffer, bytes_serialized);
   }
 
+  ExecutionResult SerializeLogSegments(
+      AsyncContext<journal_service::JournalStreamAppendLogRequest,
+                   journal_service::JournalStreamAppendLogResponse>&
+          journal_stream_append_log_context,
+      std::vector<std::shared_ptr<BytesBuffer>>& buffer_segments,
+      size_t& bytes_serialized) noexcept override {
+    if (serialize_log_segments_mock) {
+      return serialize_log_segments_mock(journal_stream_append_log_context,
+                                         buffer_segments, bytes_serialized);
+    }
+    return JournalOutputStream::SerializeLogSegments(
+        journal_stream_append_log_context, buffer_segments, bytes_serialized);
+  }
+
   ExecutionResult WriteJournalBlob(
       BytesBuffer& bytes_buffer, uint64_t current_journal_id,
       std::function<void(ExecutionResult&)> callback) noexcept override {
@@ -125,6 +153,18 @@ class MockJournalOutputStream : public core::JournalOutputStream {
                                                  current_journal_id, callback);
   }
 
+  ExecutionResult WriteJournalBlobSegments(
+      std::vector<std::shared_ptr<BytesBuffer>>& buffer_segments,
+      uint64_t current_journal_id,
+      std::function<void(ExecutionResult&)> callback) noexcept override {
+    if (write_journal_blob_segments_mock) {
+      return write_journal_blob_segments_mock(buffer_segments,
+                                              current_journal_id, callback);
+    }
+    return JournalOutputStream::WriteJournalBlobSegments(
+        buffer_segments, current_journal_id, callback);
+  }
+
   void OnWriteJournalBlobCallback(
       JournalId journal_id, std::function<void(ExecutionResult&)> callback,
       AsyncContext<PutBlobRequest, PutBlobResponse>& pub_blob_context) noexcept
@@ -18,6 +18,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 #include "core/interface/journal_service_interface.h"
 
@@ -69,6 +70,14 @@ class MockJournalService : public JournalServiceInterface {
     return SuccessExecutionResult();
   }
 
+  ExecutionResult AttachLocalTier(
+      const std::shared_ptr<std::string>& local_tier_path) noexcept override {
+    if (attach_local_tier_mock) {
+      return attach_local_tier_mock(local_tier_path);
+    }
+    return SuccessExecutionResult();
+  }
+
   ExecutionResult RunRecoveryMetrics() noexcept override {
     return SuccessExecutionResult();
   }
@@ -84,5 +93,8 @@ class MockJournalService : public JournalServiceInterface {
   std::function<ExecutionResult(
       AsyncContext<JournalRecoverRequest, JournalRecoverResponse>&)>
       recover_mock;
+
+  std::function<ExecutionResult(const std::shared_ptr<std::string>&)>
+      attach_local_tier_mock;
 };
 }  // namespace google::scp::core::journal_service::mock
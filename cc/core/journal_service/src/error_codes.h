@@ -112,4 +112,56 @@ DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_FAILED_TO_FLUSH_BATCH_OF_LOGS,
                   "The batch of logs to flush failed.",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_INVALID_LOG_GROUP, SC_JOURNAL_SERVICE,
+                  0x0015, "The journal log group is invalid.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_INVALID_LOG_BODY, SC_JOURNAL_SERVICE,
+                  0x0016,
+                  "The journal log body is both in place and in the log.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_LOCAL_TIER_CANNOT_OPEN_SEGMENT,
+                  SC_JOURNAL_SERVICE, 0x0017,
+                  "A segment file of the journal local tier cannot be opened.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(
+    SC_JOURNAL_SERVICE_LOCAL_TIER_INVALID_SEGMENT, SC_JOURNAL_SERVICE, 0x0018,
+    "The segment files of the journal local tier do not match its "
+    "configuration.",
+    HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_LOCAL_TIER_FULL, SC_JOURNAL_SERVICE,
+                  0x0019,
+                  "All the segments of the journal local tier are pending "
+                  "shipment.",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_LOCAL_TIER_BLOB_TOO_LARGE,
+                  SC_JOURNAL_SERVICE, 0x001A,
+                  "The blob does not fit in a segment of the journal local "
+                  "tier.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_LOCAL_TIER_SYNC_FAILED,
+                  SC_JOURNAL_SERVICE, 0x001B,
+                  "A segment of the journal local tier cannot be synced.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_LOCAL_TIER_BLOB_NOT_SHIPPED,
+                  SC_JOURNAL_SERVICE, 0x001C,
+                  "The blob of the journal local tier is not shipped yet.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_LOG_CHECKSUM_MISMATCH, SC_JOURNAL_SERVICE,
+                  0x001D,
+                  "The checksum of the journal log does not match its bytes.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_JOURNAL_SERVICE_LOCAL_TIER_ALREADY_ATTACHED,
+                  SC_JOURNAL_SERVICE, 0x001E,
+                  "The journal service already has a local tier.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 }  // namespace google::scp::core::errors
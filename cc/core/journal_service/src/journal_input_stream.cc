@@ -136,6 +136,15 @@ ExecutionResult JournalInputStream::ReadLog(
   bool loaded =
       enable_batch_read_journals_ ? journal_ids_loaded_ : journals_loaded_;
   if (!loaded) {
+    // When resuming after a known journal, the checkpoint has already been
+    // consumed by the caller, so go directly to listing the journals.
+    if (start_after_journal_id_ != kInvalidJournalId) {
+      auto start_from = make_shared<Blob>();
+      start_from->bucket_name = bucket_name_;
+      RETURN_IF_FAILURE(JournalUtils::CreateJournalBlobName(
+          partition_name_, start_after_journal_id_, start_from->blob_name));
+      return ListJournals(journal_stream_read_log_context, start_from);
+    }
     // Kick start Step 1
     return ReadLastCheckpointBlob(journal_stream_read_log_context);
   }
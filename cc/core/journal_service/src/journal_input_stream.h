@@ -42,10 +42,12 @@ class JournalInputStream : public journal_service::JournalInputStreamInterface {
       std::shared_ptr<std::string> bucket_name,
       std::shared_ptr<std::string> partition_name,
       std::shared_ptr<BlobStorageClientInterface> blob_storage_provider_client,
-      std::shared_ptr<ConfigProviderInterface> config_provider)
+      std::shared_ptr<ConfigProviderInterface> config_provider,
+      JournalId start_after_journal_id = kInvalidJournalId)
       : journals_loaded_(false),
         last_checkpoint_id_(kInvalidCheckpointId),
-        last_processed_journal_id_(kInvalidJournalId),
+        last_processed_journal_id_(start_after_journal_id),
+        start_after_journal_id_(start_after_journal_id),
         total_journals_to_read_(0),
         execution_result_of_failed_journal_read_(SuccessExecutionResult()),
         is_any_journal_read_failed_(false),
@@ -306,6 +308,10 @@ class JournalInputStream : public journal_service::JournalInputStreamInterface {
   /// Last processed journal id by the previous checkpoint.
   JournalId last_processed_journal_id_;
 
+  /// If set, the stream skips the checkpoint and only reads the journals
+  /// written after this journal id.
+  JournalId start_after_journal_id_;
+
   /// Total number of journal blobs to read. This is used as a counting
   /// semaphore to allow the last callback to execute the async sequence's
   /// continuation.
@@ -0,0 +1,934 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "journal_local_tier.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <set>
+
+#include "absl/crc/crc32c.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "core/blob_storage_provider/src/common/error_codes.h"
+#include "core/common/uuid/src/uuid.h"
+#include "core/journal_service/src/error_codes.h"
+
+using google::scp::core::common::kZeroUuid;
+using std::lock_guard;
+using std::make_shared;
+using std::make_unique;
+using std::mutex;
+using std::promise;
+using std::set;
+using std::shared_ptr;
+using std::sort;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+using std::chrono::milliseconds;
+
+namespace {
+constexpr char kJournalLocalTier[] = "JournalLocalTier";
+
+constexpr uint64_t kSegmentMagic = 0x5345474C4E524A53;  // "SJRNLGES"
+constexpr uint32_t kRecordMagic = 0x44524352;           // "RCRD"
+
+/// [Magic-8B][Sequence-8B]
+constexpr size_t kSegmentHeaderByteLength = 16;
+/// [Magic-4B][CRC32C-4B][Sequence-8B][NameLength-4B][DataLength-8B]
+constexpr size_t kRecordHeaderByteLength = 28;
+constexpr size_t kRecordChecksumOffset = 4;
+constexpr size_t kRecordChecksummedOffset = 8;
+constexpr size_t kRecordSequenceOffset = 8;
+constexpr size_t kRecordNameLengthOffset = 16;
+constexpr size_t kRecordDataLengthOffset = 20;
+
+template <typename T>
+T ReadValue(const google::scp::core::Byte* data) {
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void WriteValue(google::scp::core::Byte* data, T value) {
+  memcpy(data, &value, sizeof(T));
+}
+
+uint32_t CalculateRecordChecksum(const google::scp::core::Byte* record,
+                                 size_t record_byte_size) {
+  return static_cast<uint32_t>(absl::ComputeCrc32c(
+      absl::string_view(record + kRecordChecksummedOffset,
+                        record_byte_size - kRecordChecksummedOffset)));
+}
+}  // namespace
+
+namespace google::scp::core {
+JournalLocalTier::JournalLocalTier(
+    const shared_ptr<string>& bucket_name, const string& blob_name_prefix,
+    const string& directory_path, size_t segment_byte_size,
+    size_t segment_count,
+    const shared_ptr<BlobStorageClientInterface>& remote_blob_storage_client,
+    milliseconds ship_interval)
+    : bucket_name_(bucket_name),
+      blob_name_prefix_(blob_name_prefix),
+      directory_path_(directory_path),
+      segment_byte_size_(segment_byte_size),
+      segment_count_(segment_count),
+      remote_blob_storage_client_(remote_blob_storage_client),
+      ship_interval_(ship_interval),
+      last_sequence_(0),
+      is_running_(false),
+      has_pending_blobs_(false) {}
+
+JournalLocalTier::~JournalLocalTier() {
+  if (ship_thread_) {
+    Stop();
+  }
+  CloseSegments();
+}
+
+ExecutionResult JournalLocalTier::Init() noexcept {
+  if (segment_count_ == 0 ||
+      segment_byte_size_ <=
+          kSegmentHeaderByteLength + kRecordHeaderByteLength) {
+    return FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_INVALID_SEGMENT);
+  }
+
+  RETURN_IF_FAILURE(OpenSegments());
+  if (blob_index_.empty()) {
+    return SuccessExecutionResult();
+  }
+
+  // The recovered blobs are only shipped if this is still the latest writer
+  // of the journals, otherwise they would be interleaved with the journals of
+  // the other owner.
+  bool is_superseded = false;
+  RETURN_IF_FAILURE(CheckRecoveredBlobsSuperseded(is_superseded));
+  if (is_superseded) {
+    return QuarantineSegments();
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::OpenSegments() noexcept {
+  std::error_code error_code;
+  std::filesystem::create_directories(directory_path_, error_code);
+  if (error_code) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_CANNOT_OPEN_SEGMENT);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "Cannot create the directory '%s': %s", directory_path_.c_str(),
+              error_code.message().c_str());
+    return execution_result;
+  }
+
+  // Fewer segments than the ones on the disk would lose the blobs of the
+  // others.
+  auto extra_segment_path =
+      std::filesystem::path(directory_path_) /
+      absl::StrCat("segment_", segment_count_);
+  if (std::filesystem::exists(extra_segment_path, error_code)) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_INVALID_SEGMENT);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "The directory '%s' has more than %llu segments.",
+              directory_path_.c_str(), segment_count_);
+    return execution_result;
+  }
+
+  segments_.resize(segment_count_);
+  for (size_t segment_index = 0; segment_index < segment_count_;
+       ++segment_index) {
+    auto execution_result = OpenSegment(segment_index);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  }
+
+  // The blobs are indexed in the order of the segments, so that the latest
+  // write of a blob is the one served.
+  vector<size_t> segment_indices;
+  for (size_t segment_index = 0; segment_index < segment_count_;
+       ++segment_index) {
+    if (segments_[segment_index].sequence != 0) {
+      segment_indices.push_back(segment_index);
+    }
+  }
+  sort(segment_indices.begin(), segment_indices.end(),
+       [&](size_t left, size_t right) {
+         return segments_[left].sequence < segments_[right].sequence;
+       });
+
+  size_t recovered_blob_count = 0;
+  for (auto segment_index : segment_indices) {
+    const auto& segment = segments_[segment_index];
+    last_sequence_ = std::max(last_sequence_, segment.sequence);
+    for (size_t record_index = 0; record_index < segment.records.size();
+         ++record_index) {
+      blob_index_[segment.records[record_index].blob_name] = {segment_index,
+                                                              record_index};
+      recovered_blob_count++;
+    }
+  }
+
+  SCP_INFO(kJournalLocalTier, kZeroUuid,
+           "Recovered %llu blobs not shipped yet from '%s'.",
+           recovered_blob_count, directory_path_.c_str());
+  return SuccessExecutionResult();
+}
+
+void JournalLocalTier::CloseSegments() noexcept {
+  for (auto& segment : segments_) {
+    if (segment.data) {
+      munmap(segment.data, segment_byte_size_);
+    }
+    if (segment.file_descriptor >= 0) {
+      close(segment.file_descriptor);
+    }
+  }
+  segments_.clear();
+  active_segment_index_.reset();
+  blob_index_.clear();
+  last_sequence_ = 0;
+}
+
+ExecutionResult JournalLocalTier::CheckRecoveredBlobsSuperseded(
+    bool& is_superseded) noexcept {
+  is_superseded = false;
+  // The remote journals are a prefix of the local ones, so only the journals
+  // after the oldest recovered one need to be listed.
+  auto oldest_blob = blob_index_.lower_bound(blob_name_prefix_);
+  if (oldest_blob == blob_index_.end() ||
+      oldest_blob->first.compare(0, blob_name_prefix_.size(),
+                                 blob_name_prefix_) != 0) {
+    return SuccessExecutionResult();
+  }
+
+  auto marker = make_shared<string>(oldest_blob->first);
+  while (marker) {
+    AsyncContext<ListBlobsRequest, ListBlobsResponse> list_blobs_context;
+    list_blobs_context.parent_activity_id = kZeroUuid;
+    list_blobs_context.correlation_id = kZeroUuid;
+    list_blobs_context.request = make_shared<ListBlobsRequest>();
+    list_blobs_context.request->bucket_name = bucket_name_;
+    list_blobs_context.request->blob_name =
+        make_shared<string>(blob_name_prefix_);
+    list_blobs_context.request->marker = marker;
+
+    promise<ExecutionResult> list_blobs_execution_result;
+    list_blobs_context.callback =
+        [&](AsyncContext<ListBlobsRequest, ListBlobsResponse>&
+                list_blobs_context) {
+          list_blobs_execution_result.set_value(list_blobs_context.result);
+        };
+    RETURN_IF_FAILURE(
+        remote_blob_storage_client_->ListBlobs(list_blobs_context));
+    RETURN_IF_FAILURE(list_blobs_execution_result.get_future().get());
+
+    marker = nullptr;
+    const auto& response = list_blobs_context.response;
+    if (!response || !response->blobs) {
+      break;
+    }
+    for (const auto& blob : *response->blobs) {
+      if (blob.blob_name &&
+          blob_index_.find(*blob.blob_name) == blob_index_.end()) {
+        SCP_WARNING(kJournalLocalTier, kZeroUuid,
+                    "The blob '%s' was written after the blobs recovered "
+                    "from '%s'.",
+                    blob.blob_name->c_str(), directory_path_.c_str());
+        is_superseded = true;
+        return SuccessExecutionResult();
+      }
+    }
+    if (!response->blobs->empty() && response->next_marker &&
+        response->next_marker->blob_name &&
+        !response->next_marker->blob_name->empty()) {
+      marker = response->next_marker->blob_name;
+    }
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::QuarantineSegments() noexcept {
+  CloseSegments();
+
+  auto quarantine_path = absl::StrCat(
+      directory_path_, ".quarantined_",
+      std::chrono::duration_cast<milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  std::error_code error_code;
+  std::filesystem::rename(directory_path_, quarantine_path, error_code);
+  if (error_code) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_CANNOT_OPEN_SEGMENT);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "Cannot move the directory '%s' aside: %s",
+              directory_path_.c_str(), error_code.message().c_str());
+    return execution_result;
+  }
+  auto parent_path = std::filesystem::path(directory_path_).parent_path();
+  RETURN_IF_FAILURE(
+      SyncDirectory(parent_path.empty() ? "." : parent_path.string()));
+
+  SCP_WARNING(kJournalLocalTier, kZeroUuid,
+              "Moved the superseded segments of '%s' to '%s'.",
+              directory_path_.c_str(), quarantine_path.c_str());
+  return OpenSegments();
+}
+
+ExecutionResult JournalLocalTier::Run() noexcept {
+  {
+    lock_guard<mutex> lock(ship_thread_mutex_);
+    is_running_ = true;
+    // The recovered blobs are shipped right away, as Init has checked that
+    // no other owner has written journals since.
+    has_pending_blobs_ = true;
+  }
+  ship_thread_ = make_unique<thread>([this]() { ShipBlobsContinuously(); });
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::Stop() noexcept {
+  {
+    lock_guard<mutex> lock(ship_thread_mutex_);
+    is_running_ = false;
+  }
+  ship_thread_condition_.notify_all();
+  if (ship_thread_) {
+    if (ship_thread_->joinable()) {
+      ship_thread_->join();
+    }
+    ship_thread_ = nullptr;
+  }
+
+  // The blobs failing to ship stay on the disk and are recovered on the next
+  // initialization.
+  auto execution_result = ShipPendingBlobs();
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "Cannot ship the pending blobs on stop.");
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::OpenSegment(size_t segment_index) noexcept {
+  auto segment_path = (std::filesystem::path(directory_path_) /
+                       absl::StrCat("segment_", segment_index))
+                          .string();
+  auto& segment = segments_[segment_index];
+  segment.file_descriptor =
+      open(segment_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+
+  struct stat segment_stat;
+  if (segment.file_descriptor < 0 ||
+      fstat(segment.file_descriptor, &segment_stat) != 0) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_CANNOT_OPEN_SEGMENT);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "Cannot open the segment '%s': %s", segment_path.c_str(),
+              strerror(errno));
+    return execution_result;
+  }
+
+  if (segment_stat.st_size == 0) {
+    // The blocks are allocated up front, so that a full disk fails here
+    // rather than faulting on a write to the mapping.
+    auto error_number =
+        posix_fallocate(segment.file_descriptor, 0, segment_byte_size_);
+    if (error_number != 0 || fsync(segment.file_descriptor) != 0) {
+      auto execution_result = FailureExecutionResult(
+          errors::SC_JOURNAL_SERVICE_LOCAL_TIER_CANNOT_OPEN_SEGMENT);
+      SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+                "Cannot allocate the segment '%s': %s", segment_path.c_str(),
+                strerror(error_number != 0 ? error_number : errno));
+      return execution_result;
+    }
+    auto execution_result = SyncDirectory(directory_path_);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  } else if (static_cast<size_t>(segment_stat.st_size) != segment_byte_size_) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_INVALID_SEGMENT);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "The segment '%s' has %llu bytes instead of %llu.",
+              segment_path.c_str(), segment_stat.st_size, segment_byte_size_);
+    return execution_result;
+  }
+
+  auto* data = mmap(nullptr, segment_byte_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, segment.file_descriptor, 0);
+  if (data == MAP_FAILED) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_CANNOT_OPEN_SEGMENT);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "Cannot map the segment '%s': %s", segment_path.c_str(),
+              strerror(errno));
+    return execution_result;
+  }
+  segment.data = static_cast<Byte*>(data);
+
+  RecoverSegmentRecords(segment);
+  return SuccessExecutionResult();
+}
+
+void JournalLocalTier::RecoverSegmentRecords(Segment& segment) noexcept {
+  segment.sequence = 0;
+  segment.write_offset = kSegmentHeaderByteLength;
+  segment.records.clear();
+
+  auto sequence = ReadValue<uint64_t>(segment.data + sizeof(uint64_t));
+  if (ReadValue<uint64_t>(segment.data) != kSegmentMagic || sequence == 0) {
+    return;
+  }
+
+  auto offset = kSegmentHeaderByteLength;
+  while (offset + kRecordHeaderByteLength <= segment_byte_size_) {
+    const auto* record = segment.data + offset;
+    if (ReadValue<uint32_t>(record) != kRecordMagic ||
+        ReadValue<uint64_t>(record + kRecordSequenceOffset) != sequence) {
+      break;
+    }
+
+    size_t name_length = ReadValue<uint32_t>(record + kRecordNameLengthOffset);
+    size_t data_length = ReadValue<uint64_t>(record + kRecordDataLengthOffset);
+    auto available_byte_size =
+        segment_byte_size_ - offset - kRecordHeaderByteLength;
+    if (name_length > available_byte_size ||
+        data_length > available_byte_size - name_length) {
+      break;
+    }
+
+    auto record_byte_size = kRecordHeaderByteLength + name_length + data_length;
+    if (ReadValue<uint32_t>(record + kRecordChecksumOffset) !=
+        CalculateRecordChecksum(record, record_byte_size)) {
+      // A torn write of the last record before a crash.
+      SCP_WARNING(kJournalLocalTier, kZeroUuid,
+                  "Discarding a corrupted record at offset %llu of the "
+                  "segment with sequence %llu.",
+                  offset, sequence);
+      break;
+    }
+
+    Record recovered_record;
+    recovered_record.blob_name = string(
+        reinterpret_cast<const char*>(record + kRecordHeaderByteLength),
+        name_length);
+    recovered_record.data_offset =
+        offset + kRecordHeaderByteLength + name_length;
+    recovered_record.data_length = data_length;
+    segment.records.push_back(std::move(recovered_record));
+    offset += record_byte_size;
+  }
+
+  // The segment is sealed, so the blobs written after the recovery go to a
+  // segment of a later sequence.
+  if (!segment.records.empty()) {
+    segment.sequence = sequence;
+    segment.write_offset = offset;
+    segment.is_sealed = true;
+  }
+}
+
+ExecutionResult JournalLocalTier::ActivateFreeSegment() noexcept {
+  for (size_t segment_index = 0; segment_index < segments_.size();
+       ++segment_index) {
+    auto& segment = segments_[segment_index];
+    if (segment.sequence != 0) {
+      continue;
+    }
+
+    auto execution_result = WriteSegmentSequence(segment, last_sequence_ + 1);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    segment.sequence = ++last_sequence_;
+    segment.write_offset = kSegmentHeaderByteLength;
+    segment.is_sealed = false;
+    segment.records.clear();
+    segment.shipped_record_count = 0;
+    active_segment_index_ = segment_index;
+    return SuccessExecutionResult();
+  }
+
+  return RetryExecutionResult(errors::SC_JOURNAL_SERVICE_LOCAL_TIER_FULL);
+}
+
+ExecutionResult JournalLocalTier::FreeSegment(Segment& segment) noexcept {
+  auto execution_result = WriteSegmentSequence(segment, 0);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  segment.sequence = 0;
+  segment.write_offset = kSegmentHeaderByteLength;
+  segment.is_sealed = false;
+  segment.records.clear();
+  segment.shipped_record_count = 0;
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::WriteSegmentSequence(
+    Segment& segment, uint64_t sequence) noexcept {
+  WriteValue<uint64_t>(segment.data, kSegmentMagic);
+  WriteValue<uint64_t>(segment.data + sizeof(uint64_t), sequence);
+  return SyncSegment(segment, 0, kSegmentHeaderByteLength);
+}
+
+ExecutionResult JournalLocalTier::SyncSegment(const Segment& segment,
+                                              size_t offset,
+                                              size_t length) noexcept {
+  // msync requires an address aligned to the page.
+  static const size_t page_byte_size = sysconf(_SC_PAGESIZE);
+  auto aligned_offset = offset - offset % page_byte_size;
+  if (msync(segment.data + aligned_offset, offset + length - aligned_offset,
+            MS_SYNC) != 0) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_SYNC_FAILED);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "Cannot sync %llu bytes at offset %llu of a segment: %s",
+              length, offset, strerror(errno));
+    return execution_result;
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::SyncDirectory(
+    const string& directory_path) noexcept {
+  auto directory_file_descriptor =
+      open(directory_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (directory_file_descriptor < 0 || fsync(directory_file_descriptor) != 0) {
+    auto execution_result = FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_SYNC_FAILED);
+    SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+              "Cannot sync the directory '%s': %s", directory_path.c_str(),
+              strerror(errno));
+    if (directory_file_descriptor >= 0) {
+      close(directory_file_descriptor);
+    }
+    return execution_result;
+  }
+  close(directory_file_descriptor);
+  return SuccessExecutionResult();
+}
+
+void JournalLocalTier::IndexRecord(size_t segment_index,
+                                   size_t record_index) noexcept {
+  const auto& blob_name =
+      segments_[segment_index].records[record_index].blob_name;
+  auto blob = blob_index_.find(blob_name);
+  if (blob != blob_index_.end()) {
+    auto indexed_sequence = segments_[blob->second.first].sequence;
+    auto sequence = segments_[segment_index].sequence;
+    if (indexed_sequence > sequence ||
+        (indexed_sequence == sequence && blob->second.second > record_index)) {
+      return;
+    }
+  }
+  blob_index_[blob_name] = {segment_index, record_index};
+}
+
+bool JournalLocalTier::IsLocalBucket(const BlobRequest& blob_request) noexcept {
+  return blob_request.bucket_name && bucket_name_ &&
+         *blob_request.bucket_name == *bucket_name_;
+}
+
+ExecutionResult JournalLocalTier::PutBlob(
+    AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) noexcept {
+  const auto& request = *put_blob_context.request;
+  if (!IsLocalBucket(request)) {
+    return remote_blob_storage_client_->PutBlob(put_blob_context);
+  }
+
+  vector<shared_ptr<BytesBuffer>> buffers;
+  if (request.buffer) {
+    buffers.push_back(request.buffer);
+  } else {
+    buffers = request.buffer_segments;
+  }
+  if (!request.blob_name || request.blob_name->empty() || buffers.empty()) {
+    return FailureExecutionResult(
+        errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+  }
+
+  size_t data_length = 0;
+  for (const auto& buffer : buffers) {
+    if (!buffer) {
+      return FailureExecutionResult(
+          errors::SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+    }
+    data_length += buffer->length;
+  }
+  const auto& blob_name = *request.blob_name;
+  auto record_byte_size =
+      kRecordHeaderByteLength + blob_name.size() + data_length;
+  if (record_byte_size > segment_byte_size_ - kSegmentHeaderByteLength) {
+    return FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_BLOB_TOO_LARGE);
+  }
+
+  // The record is copied under the lock, and synced without it so that the
+  // appends to the segments are not serialized on the disk.
+  size_t segment_index = 0;
+  size_t record_index = 0;
+  size_t record_offset = 0;
+  ExecutionResult execution_result = SuccessExecutionResult();
+  {
+    lock_guard<mutex> lock(mutex_);
+    if (active_segment_index_ &&
+        segments_[*active_segment_index_].write_offset + record_byte_size >
+            segment_byte_size_) {
+      segments_[*active_segment_index_].is_sealed = true;
+      active_segment_index_.reset();
+    }
+    if (!active_segment_index_) {
+      execution_result = ActivateFreeSegment();
+      if (!execution_result.Successful()) {
+        return execution_result;
+      }
+    }
+
+    segment_index = *active_segment_index_;
+    auto& segment = segments_[segment_index];
+    record_offset = segment.write_offset;
+    auto* record = segment.data + record_offset;
+    WriteValue<uint32_t>(record, kRecordMagic);
+    WriteValue<uint64_t>(record + kRecordSequenceOffset, segment.sequence);
+    WriteValue<uint32_t>(record + kRecordNameLengthOffset,
+                         static_cast<uint32_t>(blob_name.size()));
+    WriteValue<uint64_t>(record + kRecordDataLengthOffset, data_length);
+    memcpy(record + kRecordHeaderByteLength, blob_name.data(),
+           blob_name.size());
+    auto data_offset =
+        record_offset + kRecordHeaderByteLength + blob_name.size();
+    auto* data = segment.data + data_offset;
+    for (const auto& buffer : buffers) {
+      if (buffer->length > 0) {
+        memcpy(data, buffer->bytes->data(), buffer->length);
+        data += buffer->length;
+      }
+    }
+    WriteValue<uint32_t>(record + kRecordChecksumOffset,
+                         CalculateRecordChecksum(record, record_byte_size));
+
+    Record appended_record;
+    appended_record.blob_name = blob_name;
+    appended_record.data_offset = data_offset;
+    appended_record.data_length = data_length;
+    appended_record.state = RecordState::Syncing;
+    segment.records.push_back(std::move(appended_record));
+    record_index = segment.records.size() - 1;
+    segment.write_offset += record_byte_size;
+  }
+
+  // The segment is not freed while it has a record being synced, as the
+  // record is not shipped until synced.
+  execution_result =
+      SyncSegment(segments_[segment_index], record_offset, record_byte_size);
+  {
+    lock_guard<mutex> lock(mutex_);
+    auto& record = segments_[segment_index].records[record_index];
+    if (execution_result.Successful()) {
+      record.state = RecordState::Synced;
+      IndexRecord(segment_index, record_index);
+    } else {
+      record.state = RecordState::SyncFailed;
+    }
+  }
+
+  // The shipments wait for the record either way.
+  {
+    lock_guard<mutex> lock(ship_thread_mutex_);
+    has_pending_blobs_ = true;
+  }
+  ship_thread_condition_.notify_one();
+
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  put_blob_context.response = make_shared<PutBlobResponse>();
+  put_blob_context.result = SuccessExecutionResult();
+  put_blob_context.Finish();
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::GetBlob(
+    AsyncContext<GetBlobRequest, GetBlobResponse>& get_blob_context) noexcept {
+  const auto& request = *get_blob_context.request;
+  if (!IsLocalBucket(request) || !request.blob_name) {
+    return remote_blob_storage_client_->GetBlob(get_blob_context);
+  }
+
+  shared_ptr<BytesBuffer> buffer;
+  {
+    lock_guard<mutex> lock(mutex_);
+    auto blob = blob_index_.find(*request.blob_name);
+    if (blob != blob_index_.end()) {
+      const auto& segment = segments_[blob->second.first];
+      const auto& record = segment.records[blob->second.second];
+      buffer = make_shared<BytesBuffer>(record.data_length);
+      memcpy(buffer->bytes->data(), segment.data + record.data_offset,
+             record.data_length);
+      buffer->length = record.data_length;
+    }
+  }
+
+  if (!buffer) {
+    return remote_blob_storage_client_->GetBlob(get_blob_context);
+  }
+
+  get_blob_context.response = make_shared<GetBlobResponse>();
+  get_blob_context.response->buffer = buffer;
+  get_blob_context.result = SuccessExecutionResult();
+  get_blob_context.Finish();
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalLocalTier::ListBlobs(
+    AsyncContext<ListBlobsRequest, ListBlobsResponse>&
+        list_blobs_context) noexcept {
+  const auto& request = *list_blobs_context.request;
+  if (!IsLocalBucket(request)) {
+    return remote_blob_storage_client_->ListBlobs(list_blobs_context);
+  }
+
+  // The local blobs are taken before listing the remote ones, so that a blob
+  // shipped in between is listed by either.
+  auto local_blob_names = make_shared<vector<string>>();
+  {
+    lock_guard<mutex> lock(mutex_);
+    for (const auto& [blob_name, location] : blob_index_) {
+      if (request.blob_name &&
+          blob_name.compare(0, request.blob_name->size(),
+                            *request.blob_name) != 0) {
+        continue;
+      }
+      if (request.marker && blob_name <= *request.marker) {
+        continue;
+      }
+      local_blob_names->push_back(blob_name);
+    }
+  }
+
+  if (local_blob_names->empty()) {
+    return remote_blob_storage_client_->ListBlobs(list_blobs_context);
+  }
+
+  // The local blobs are appended to the last page of the listing, which has
+  // no next marker.
+  AsyncContext<ListBlobsRequest, ListBlobsResponse> remote_list_blobs_context(
+      list_blobs_context.request,
+      [list_blobs_context, local_blob_names](
+          AsyncContext<ListBlobsRequest, ListBlobsResponse>&
+              remote_list_blobs_context) mutable {
+        list_blobs_context.result = remote_list_blobs_context.result;
+        list_blobs_context.response = remote_list_blobs_context.response;
+        if (!list_blobs_context.result.Successful()) {
+          list_blobs_context.Finish();
+          return;
+        }
+
+        auto& response = list_blobs_context.response;
+        if (!response) {
+          response = make_shared<ListBlobsResponse>();
+        }
+        if (!response->blobs) {
+          response->blobs = make_shared<vector<Blob>>();
+        }
+        if (response->next_marker && response->next_marker->blob_name &&
+            !response->next_marker->blob_name->empty()) {
+          list_blobs_context.Finish();
+          return;
+        }
+
+        set<string> remote_blob_names;
+        for (const auto& blob : *response->blobs) {
+          if (blob.blob_name) {
+            remote_blob_names.insert(*blob.blob_name);
+          }
+        }
+        for (const auto& blob_name : *local_blob_names) {
+          if (remote_blob_names.count(blob_name) > 0) {
+            continue;
+          }
+          Blob blob;
+          blob.bucket_name = list_blobs_context.request->bucket_name;
+          blob.blob_name = make_shared<string>(blob_name);
+          response->blobs->push_back(blob);
+        }
+        sort(response->blobs->begin(), response->blobs->end(),
+             [](const Blob& left, const Blob& right) {
+               return *left.blob_name < *right.blob_name;
+             });
+        list_blobs_context.Finish();
+      },
+      list_blobs_context);
+  return remote_blob_storage_client_->ListBlobs(remote_list_blobs_context);
+}
+
+ExecutionResult JournalLocalTier::DeleteBlob(
+    AsyncContext<DeleteBlobRequest, DeleteBlobResponse>&
+        delete_blob_context) noexcept {
+  const auto& request = *delete_blob_context.request;
+  if (IsLocalBucket(request) && request.blob_name) {
+    lock_guard<mutex> lock(mutex_);
+    if (blob_index_.find(*request.blob_name) != blob_index_.end()) {
+      return FailureExecutionResult(
+          errors::SC_JOURNAL_SERVICE_LOCAL_TIER_BLOB_NOT_SHIPPED);
+    }
+  }
+  return remote_blob_storage_client_->DeleteBlob(delete_blob_context);
+}
+
+ExecutionResult JournalLocalTier::ShipBlob(
+    const string& blob_name, shared_ptr<BytesBuffer> buffer) noexcept {
+  AsyncContext<PutBlobRequest, PutBlobResponse> put_blob_context;
+  put_blob_context.parent_activity_id = kZeroUuid;
+  put_blob_context.correlation_id = kZeroUuid;
+  put_blob_context.request = make_shared<PutBlobRequest>();
+  put_blob_context.request->bucket_name = bucket_name_;
+  put_blob_context.request->blob_name = make_shared<string>(blob_name);
+  put_blob_context.request->buffer = buffer;
+
+  promise<ExecutionResult> put_blob_execution_result;
+  put_blob_context.callback =
+      [&](AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) {
+        put_blob_execution_result.set_value(put_blob_context.result);
+      };
+
+  auto execution_result =
+      remote_blob_storage_client_->PutBlob(put_blob_context);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  return put_blob_execution_result.get_future().get();
+}
+
+ExecutionResult JournalLocalTier::ShipPendingBlobs() noexcept {
+  lock_guard<mutex> ship_lock(ship_mutex_);
+  while (true) {
+    size_t segment_index = 0;
+    size_t record_index = 0;
+    Record record;
+    {
+      lock_guard<mutex> lock(mutex_);
+      // The oldest segment has the first blob to ship.
+      std::optional<size_t> oldest_segment_index;
+      for (size_t index = 0; index < segments_.size(); ++index) {
+        auto& segment = segments_[index];
+        if (segment.sequence == 0 ||
+            segment.shipped_record_count == segment.records.size()) {
+          // A segment shipped before being sealed is freed once sealed.
+          if (segment.is_sealed) {
+            auto execution_result = FreeSegment(segment);
+            if (!execution_result.Successful()) {
+              return execution_result;
+            }
+          }
+          continue;
+        }
+        if (!oldest_segment_index ||
+            segment.sequence < segments_[*oldest_segment_index].sequence) {
+          oldest_segment_index = index;
+        }
+      }
+      if (!oldest_segment_index) {
+        return SuccessExecutionResult();
+      }
+      segment_index = *oldest_segment_index;
+      auto& segment = segments_[segment_index];
+      record_index = segment.shipped_record_count;
+      record = segment.records[record_index];
+      // The blobs are shipped in order, so the ones after a record being
+      // synced wait for it.
+      if (record.state == RecordState::Syncing) {
+        return SuccessExecutionResult();
+      }
+      if (record.state == RecordState::SyncFailed) {
+        segment.shipped_record_count++;
+        if (segment.is_sealed &&
+            segment.shipped_record_count == segment.records.size()) {
+          auto execution_result = FreeSegment(segment);
+          if (!execution_result.Successful()) {
+            return execution_result;
+          }
+        }
+        continue;
+      }
+    }
+
+    // The shipped records are only freed here, so the data is read without
+    // the lock.
+    auto buffer = make_shared<BytesBuffer>(record.data_length);
+    memcpy(buffer->bytes->data(),
+           segments_[segment_index].data + record.data_offset,
+           record.data_length);
+    buffer->length = record.data_length;
+    auto execution_result = ShipBlob(record.blob_name, buffer);
+    if (!execution_result.Successful()) {
+      SCP_ERROR(kJournalLocalTier, kZeroUuid, execution_result,
+                "Cannot ship the blob '%s'.", record.blob_name.c_str());
+      return execution_result;
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    auto& segment = segments_[segment_index];
+    segment.shipped_record_count++;
+    auto blob = blob_index_.find(record.blob_name);
+    if (blob != blob_index_.end() && blob->second.first == segment_index &&
+        blob->second.second == record_index) {
+      blob_index_.erase(blob);
+    }
+    if (segment.is_sealed &&
+        segment.shipped_record_count == segment.records.size()) {
+      execution_result = FreeSegment(segment);
+      if (!execution_result.Successful()) {
+        return execution_result;
+      }
+    }
+  }
+}
+
+void JournalLocalTier::ShipBlobsContinuously() noexcept {
+  while (true) {
+    {
+      unique_lock<mutex> lock(ship_thread_mutex_);
+      ship_thread_condition_.wait_for(lock, ship_interval_, [&]() {
+        return !is_running_ || has_pending_blobs_;
+      });
+      if (!is_running_) {
+        return;
+      }
+      has_pending_blobs_ = false;
+    }
+    // The failed shipments are retried on the next interval.
+    ShipPendingBlobs();
+  }
+}
+}  // namespace google::scp::core
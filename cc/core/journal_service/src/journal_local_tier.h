@@ -0,0 +1,252 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/interface/blob_storage_provider_interface.h"
+#include "core/interface/service_interface.h"
+#include "core/interface/type_def.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::core {
+/// The defaults of the segments of the journal local tier.
+static constexpr size_t kDefaultJournalLocalTierSegmentByteSize =
+    64 * 1024 * 1024;
+static constexpr size_t kDefaultJournalLocalTierSegmentCount = 16;
+static constexpr std::chrono::milliseconds
+    kDefaultJournalLocalTierShipInterval(1000);
+
+/**
+ * @brief A local write-ahead tier in front of the blob storage of the
+ * journals. The journal blobs are appended to a ring of memory-mapped segment
+ * files and acknowledged once synced to the local disk. The blobs are shipped
+ * to the remote blob storage in the background in the order they were
+ * appended, so that the remote journals are always a prefix of the local
+ * ones. A segment is sealed once full, and reused once all of its blobs are
+ * shipped.
+ *
+ * The blobs not shipped yet are served from the segments, listed along with
+ * the remote blobs, and recovered from the segment files on initialization.
+ * The recovered blobs are only kept if the remote journals are still a prefix
+ * of them, i.e. no other owner of the partition has written journals since.
+ * Otherwise the segment files are moved aside to a quarantine directory.
+ * Every segment file starts with [Magic-8B][Sequence-8B] followed by records
+ * [Magic-4B][CRC32C-4B][Sequence-8B][NameLength-4B][DataLength-8B][Name][Data]
+ * where the checksum covers everything after itself. A record of a former use
+ * of the segment does not have its sequence, so recovery stops at it.
+ *
+ * The blobs of other buckets go to the remote blob storage directly.
+ */
+class JournalLocalTier : public ServiceInterface,
+                         public BlobStorageClientInterface {
+ public:
+  /**
+   * @brief Constructs a new Journal Local Tier object.
+   *
+   * @param bucket_name The bucket of the journal blobs.
+   * @param blob_name_prefix The prefix of the names of the journal blobs.
+   * @param directory_path The directory of the segment files.
+   * @param segment_byte_size The byte size of every segment file.
+   * @param segment_count The number of segment files in the ring.
+   * @param remote_blob_storage_client The client to ship the blobs with.
+   * @param ship_interval The interval to retry failed shipments at.
+   */
+  JournalLocalTier(const std::shared_ptr<std::string>& bucket_name,
+                   const std::string& blob_name_prefix,
+                   const std::string& directory_path, size_t segment_byte_size,
+                   size_t segment_count,
+                   const std::shared_ptr<BlobStorageClientInterface>&
+                       remote_blob_storage_client,
+                   std::chrono::milliseconds ship_interval =
+                       kDefaultJournalLocalTierShipInterval);
+
+  ~JournalLocalTier();
+
+  ExecutionResult Init() noexcept override;
+
+  ExecutionResult Run() noexcept override;
+
+  ExecutionResult Stop() noexcept override;
+
+  ExecutionResult GetBlob(AsyncContext<GetBlobRequest, GetBlobResponse>&
+                              get_blob_context) noexcept override;
+
+  ExecutionResult ListBlobs(AsyncContext<ListBlobsRequest, ListBlobsResponse>&
+                                list_blobs_context) noexcept override;
+
+  ExecutionResult PutBlob(AsyncContext<PutBlobRequest, PutBlobResponse>&
+                              put_blob_context) noexcept override;
+
+  ExecutionResult DeleteBlob(
+      AsyncContext<DeleteBlobRequest, DeleteBlobResponse>&
+          delete_blob_context) noexcept override;
+
+ protected:
+  /**
+   * @brief Ships the blobs not shipped yet to the remote blob storage in
+   * order, and frees the sealed segments once shipped.
+   *
+   * @return ExecutionResult The result of the first failing shipment if any.
+   */
+  ExecutionResult ShipPendingBlobs() noexcept;
+
+ private:
+  /// The state of a record appended to a segment.
+  enum class RecordState {
+    /// The record is written to the mapping and being synced to the disk.
+    Syncing = 0,
+    Synced = 1,
+    /// The record could not be synced, so it is neither served nor shipped.
+    SyncFailed = 2,
+  };
+
+  /// A blob appended to a segment.
+  struct Record {
+    std::string blob_name;
+    /// The offset and the length of the data of the blob in the segment.
+    size_t data_offset = 0;
+    size_t data_length = 0;
+    RecordState state = RecordState::Synced;
+  };
+
+  /// A memory-mapped segment file.
+  struct Segment {
+    int file_descriptor = -1;
+    Byte* data = nullptr;
+    /// The sequence of the segment in the ring, or 0 if it is free.
+    uint64_t sequence = 0;
+    /// The offset to append the next record at.
+    size_t write_offset = 0;
+    bool is_sealed = false;
+    std::vector<Record> records;
+    /// The records are shipped in order, so the first ones are shipped.
+    size_t shipped_record_count = 0;
+  };
+
+  /// Opens and maps the segment files, and indexes the recovered blobs.
+  ExecutionResult OpenSegments() noexcept;
+
+  /// Unmaps and closes the segment files.
+  void CloseSegments() noexcept;
+
+  /// Opens and maps the segment file, and recovers its records.
+  ExecutionResult OpenSegment(size_t segment_index) noexcept;
+
+  /**
+   * @brief Checks whether the remote blob storage has journals after the
+   * recovered blobs that are not in the segments, which means that another
+   * owner of the partition has written journals since.
+   *
+   * @param is_superseded Whether the recovered blobs are superseded.
+   * @return ExecutionResult The result of listing the remote blobs.
+   */
+  ExecutionResult CheckRecoveredBlobsSuperseded(bool& is_superseded) noexcept;
+
+  /// Moves the segment files aside to a quarantine directory, and opens new
+  /// ones.
+  ExecutionResult QuarantineSegments() noexcept;
+
+  /// Reads the records of the segment written before the initialization.
+  void RecoverSegmentRecords(Segment& segment) noexcept;
+
+  /// Takes a free segment to append to. Must be called with mutex_ held.
+  ExecutionResult ActivateFreeSegment() noexcept;
+
+  /// Frees the shipped segment for reuse. Must be called with mutex_ held.
+  ExecutionResult FreeSegment(Segment& segment) noexcept;
+
+  /// Writes the sequence of the segment to its file and syncs it.
+  ExecutionResult WriteSegmentSequence(Segment& segment,
+                                       uint64_t sequence) noexcept;
+
+  /// Syncs the range of the segment to the disk.
+  ExecutionResult SyncSegment(const Segment& segment, size_t offset,
+                              size_t length) noexcept;
+
+  /// Syncs the directory, so that the files created or renamed in it survive a
+  /// crash.
+  ExecutionResult SyncDirectory(const std::string& directory_path) noexcept;
+
+  /// Indexes the synced record unless a later write of its blob is indexed.
+  /// Must be called with mutex_ held.
+  void IndexRecord(size_t segment_index, size_t record_index) noexcept;
+
+  /// Ships a blob to the remote blob storage, and waits for the result.
+  ExecutionResult ShipBlob(const std::string& blob_name,
+                           std::shared_ptr<BytesBuffer> buffer) noexcept;
+
+  /// Ships the pending blobs once appended or on every ship interval, until
+  /// stopped.
+  void ShipBlobsContinuously() noexcept;
+
+  /// Returns whether the request is on the bucket of the journals.
+  bool IsLocalBucket(const BlobRequest& blob_request) noexcept;
+
+  /// The bucket of the journal blobs.
+  std::shared_ptr<std::string> bucket_name_;
+
+  /// The prefix of the names of the journal blobs.
+  std::string blob_name_prefix_;
+
+  /// The directory of the segment files.
+  std::string directory_path_;
+
+  const size_t segment_byte_size_;
+  const size_t segment_count_;
+
+  /// The client of the remote blob storage.
+  std::shared_ptr<BlobStorageClientInterface> remote_blob_storage_client_;
+
+  const std::chrono::milliseconds ship_interval_;
+
+  /// Protects the segments and the index of the blobs.
+  std::mutex mutex_;
+
+  std::vector<Segment> segments_;
+
+  /// The index of the segment being appended to, if any.
+  std::optional<size_t> active_segment_index_;
+
+  /// The sequence of the latest segment activated.
+  uint64_t last_sequence_;
+
+  /// The segment and the record index of the blobs not shipped yet.
+  std::map<std::string, std::pair<size_t, size_t>> blob_index_;
+
+  /// Serializes the shipments, which must happen in order.
+  std::mutex ship_mutex_;
+
+  /// Wakes the shipping thread up once a blob is appended or on stop.
+  std::mutex ship_thread_mutex_;
+  std::condition_variable ship_thread_condition_;
+  bool is_running_;
+  bool has_pending_blobs_;
+
+  std::unique_ptr<std::thread> ship_thread_;
+};
+}  // namespace google::scp::core
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstring>
 #include <functional>
 #include <list>
 #include <memory>
@@ -29,6 +30,7 @@
 #include <vector>
 
 #include "core/blob_storage_provider/src/common/error_codes.h"
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/common/sized_or_timed_bytes_buffer/src/sized_or_timed_bytes_buffer.h"
 #include "core/common/time_provider/src/time_provider.h"
 #include "core/interface/metrics_def.h"
@@ -36,6 +38,7 @@
 #include "core/journal_service/src/journal_utils.h"
 #include "google/protobuf/any.pb.h"
 
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::common::SizedOrTimedBytesBuffer;
 using google::scp::core::common::TimeProvider;
 using google::scp::core::common::Uuid;
@@ -68,13 +71,15 @@ JournalOutputStream::JournalOutputStream(
     const shared_ptr<string>& partition_name,
     const shared_ptr<AsyncExecutorInterface>& async_executor,
     const shared_ptr<BlobStorageClientInterface>& blob_storage_provider_client,
-    const shared_ptr<AggregateMetricInterface>& journal_output_count_metric)
+    const shared_ptr<AggregateMetricInterface>& journal_output_count_metric,
+    bool should_checksum_logs)
     : current_journal_id_(kInvalidJournalId),
       bucket_name_(bucket_name),
       partition_name_(partition_name),
       async_executor_(async_executor),
       blob_storage_provider_client_(blob_storage_provider_client),
       journal_output_count_metric_(journal_output_count_metric),
+      should_checksum_logs_(should_checksum_logs),
       last_persisted_journal_id_(kInvalidJournalId),
       pending_logs_(0),
       logs_queue_(INT32_MAX),
@@ -155,15 +160,85 @@ size_t JournalOutputStream::GetSerializedLogByteSize(
     AsyncContext<journal_service::JournalStreamAppendLogRequest,
                  journal_service::JournalStreamAppendLogResponse>&
         journal_stream_append_log_context) noexcept {
+  const auto& log_body = journal_stream_append_log_context.request->log_body;
+  size_t log_body_length = log_body ? log_body->length : 0;
   return (
       journal_stream_append_log_context.request->journal_log->ByteSizeLong() +
-      sizeof(uint64_t) + kLogHeaderByteLength);
+      JournalSerialization::CalculateLogBodyFieldByteSize(log_body_length) +
+      sizeof(uint64_t) +
+      (should_checksum_logs_ ? kChecksummedLogHeaderByteLength
+                             : kLogHeaderByteLength));
 }
 
 ExecutionResult JournalOutputStream::SerializeLog(
     AsyncContext<JournalStreamAppendLogRequest, JournalStreamAppendLogResponse>&
         journal_stream_append_log_context,
     BytesBuffer& bytes_buffer, size_t& bytes_serialized) noexcept {
+  auto execution_result = SerializeLogWithoutBody(
+      journal_stream_append_log_context, bytes_buffer, bytes_serialized);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  const auto& log_body = journal_stream_append_log_context.request->log_body;
+  if (log_body && log_body->length > 0) {
+    size_t buffer_offset = bytes_buffer.length + bytes_serialized;
+    if (buffer_offset + log_body->length > bytes_buffer.capacity) {
+      return FailureExecutionResult(
+          core::errors::SC_SERIALIZATION_BUFFER_NOT_WRITABLE);
+    }
+    memcpy(bytes_buffer.bytes->data() + buffer_offset,
+           log_body->bytes->data(), log_body->length);
+    bytes_serialized += log_body->length;
+  }
+
+  if (should_checksum_logs_) {
+    return JournalSerialization::SealChecksummedLog(
+        bytes_buffer, bytes_buffer.length,
+        bytes_buffer.length + bytes_serialized);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalOutputStream::SerializeLogSegments(
+    AsyncContext<JournalStreamAppendLogRequest, JournalStreamAppendLogResponse>&
+        journal_stream_append_log_context,
+    vector<shared_ptr<BytesBuffer>>& buffer_segments,
+    size_t& bytes_serialized) noexcept {
+  bytes_serialized = 0;
+  const auto& log_body = journal_stream_append_log_context.request->log_body;
+  size_t log_body_length = log_body ? log_body->length : 0;
+
+  auto buffer = make_shared<BytesBuffer>(BytesBufferPool::Allocate(
+      GetSerializedLogByteSize(journal_stream_append_log_context) -
+      log_body_length));
+  size_t buffer_bytes_serialized = 0;
+  auto execution_result = SerializeLogWithoutBody(
+      journal_stream_append_log_context, *buffer, buffer_bytes_serialized);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  buffer->length = buffer_bytes_serialized;
+  if (should_checksum_logs_) {
+    execution_result = JournalSerialization::SealChecksummedLog(
+        *buffer, 0, buffer->length, log_body.get());
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  }
+  buffer_segments.push_back(buffer);
+  if (log_body_length > 0) {
+    buffer_segments.push_back(log_body);
+  }
+  bytes_serialized = buffer->length + log_body_length;
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalOutputStream::SerializeLogWithoutBody(
+    AsyncContext<JournalStreamAppendLogRequest, JournalStreamAppendLogResponse>&
+        journal_stream_append_log_context,
+    BytesBuffer& bytes_buffer, size_t& bytes_serialized) noexcept {
   size_t current_buffer_offset = bytes_buffer.length;
   size_t current_bytes_serialized = 0;
   bytes_serialized = 0;
@@ -174,12 +249,22 @@ ExecutionResult JournalOutputStream::SerializeLog(
   Timestamp current_time =
       TimeProvider::GetUniqueWallTimestampInNanoseconds().count();
 
-  auto execution_result = JournalSerialization::SerializeLogHeader(
-      bytes_buffer, current_buffer_offset, current_time,
-      journal_stream_append_log_context.request->log_status,
-      journal_stream_append_log_context.request->component_id,
-      journal_stream_append_log_context.request->log_id,
-      current_bytes_serialized);
+  ExecutionResult execution_result;
+  if (should_checksum_logs_) {
+    execution_result = JournalSerialization::SerializeChecksummedLogHeader(
+        bytes_buffer, current_buffer_offset, current_time,
+        journal_stream_append_log_context.request->log_status,
+        journal_stream_append_log_context.request->component_id,
+        journal_stream_append_log_context.request->log_id,
+        current_bytes_serialized);
+  } else {
+    execution_result = JournalSerialization::SerializeLogHeader(
+        bytes_buffer, current_buffer_offset, current_time,
+        journal_stream_append_log_context.request->log_status,
+        journal_stream_append_log_context.request->component_id,
+        journal_stream_append_log_context.request->log_id,
+        current_bytes_serialized);
+  }
 
   if (!execution_result.Successful()) {
     return execution_result;
@@ -189,10 +274,18 @@ ExecutionResult JournalOutputStream::SerializeLog(
   bytes_serialized += current_bytes_serialized;
   current_bytes_serialized = 0;
 
-  execution_result = JournalSerialization::SerializeJournalLog(
-      bytes_buffer, current_buffer_offset,
-      *journal_stream_append_log_context.request->journal_log,
-      current_bytes_serialized);
+  if (journal_stream_append_log_context.request->log_body) {
+    execution_result = JournalSerialization::SerializeJournalLogWithoutBody(
+        bytes_buffer, current_buffer_offset,
+        *journal_stream_append_log_context.request->journal_log,
+        journal_stream_append_log_context.request->log_body->length,
+        current_bytes_serialized);
+  } else {
+    execution_result = JournalSerialization::SerializeJournalLog(
+        bytes_buffer, current_buffer_offset,
+        *journal_stream_append_log_context.request->journal_log,
+        current_bytes_serialized);
+  }
 
   if (!execution_result.Successful()) {
     return execution_result;
@@ -216,11 +309,40 @@ ExecutionResult JournalOutputStream::WriteJournalBlob(
     return execution_result;
   }
 
-  PutBlobRequest put_blob_request;
-  put_blob_request.bucket_name = bucket_name_;
-  put_blob_request.buffer = make_shared<BytesBuffer>(move(bytes_buffer));
+  auto put_blob_request = make_shared<PutBlobRequest>();
+  put_blob_request->buffer = make_shared<BytesBuffer>(move(bytes_buffer));
+  return PutJournalBlob(put_blob_request, journal_id, callback);
+}
+
+ExecutionResult JournalOutputStream::WriteJournalBlobSegments(
+    vector<shared_ptr<BytesBuffer>>& buffer_segments, JournalId journal_id,
+    std::function<void(ExecutionResult&)> callback) noexcept {
+  size_t byte_count = 0;
+  for (const auto& buffer_segment : buffer_segments) {
+    byte_count += buffer_segment->length;
+  }
+  SCP_DEBUG(kJournalOutputStream, activity_id_,
+            "Writing journal blob of byte count: '%llu' in '%llu' segments for "
+            "batch with ID '%llu'",
+            byte_count, buffer_segments.size(), journal_id);
+
+  if (byte_count == 0) {
+    auto execution_result = SuccessExecutionResult();
+    callback(execution_result);
+    return execution_result;
+  }
+
+  auto put_blob_request = make_shared<PutBlobRequest>();
+  put_blob_request->buffer_segments = move(buffer_segments);
+  return PutJournalBlob(put_blob_request, journal_id, callback);
+}
+
+ExecutionResult JournalOutputStream::PutJournalBlob(
+    shared_ptr<PutBlobRequest> put_blob_request, JournalId journal_id,
+    std::function<void(ExecutionResult&)> callback) noexcept {
+  put_blob_request->bucket_name = bucket_name_;
   auto execution_result = JournalUtils::CreateJournalBlobName(
-      partition_name_, journal_id, put_blob_request.blob_name);
+      partition_name_, journal_id, put_blob_request->blob_name);
   if (!execution_result.Successful()) {
     return execution_result;
   }
@@ -232,7 +354,7 @@ ExecutionResult JournalOutputStream::WriteJournalBlob(
       kMetricEventJournalOutputCountWriteJournalScheduledCount);
 
   AsyncContext<PutBlobRequest, PutBlobResponse> put_blob_context(
-      make_shared<PutBlobRequest>(put_blob_request),
+      move(put_blob_request),
       bind(&JournalOutputStream::OnWriteJournalBlobCallback, this, journal_id,
            callback, _1),
       activity_id_, activity_id_);
@@ -297,11 +419,21 @@ void JournalOutputStream::WriteBatch(
             flush_batch->size());
 
   size_t total_size_needed = 0;
+  bool has_log_body_in_place = false;
   for (auto it = flush_batch->begin(); it != flush_batch->end(); ++it) {
     total_size_needed += GetSerializedLogByteSize(*it);
+    has_log_body_in_place |= it->request->log_body != nullptr;
   }
 
-  auto buffer = make_shared<BytesBuffer>(total_size_needed);
+  // The log bodies in place are written from the buffers of the callers
+  // rather than copied into the buffer of the batch.
+  if (has_log_body_in_place) {
+    WriteBatchSegments(flush_batch, journal_id, total_size_needed);
+    return;
+  }
+
+  auto buffer =
+      make_shared<BytesBuffer>(BytesBufferPool::Allocate(total_size_needed));
   size_t total_bytes_serialized = 0;
   for (auto it = flush_batch->begin(); it != flush_batch->end(); ++it) {
     size_t local_total_bytes_serialized = 0;
@@ -331,6 +463,40 @@ void JournalOutputStream::WriteBatch(
   }
 }
 
+void JournalOutputStream::WriteBatchSegments(
+    const shared_ptr<list<AsyncContext<JournalStreamAppendLogRequest,
+                                       JournalStreamAppendLogResponse>>>&
+        flush_batch,
+    JournalId journal_id, size_t total_size_needed) noexcept {
+  vector<shared_ptr<BytesBuffer>> buffer_segments;
+  buffer_segments.reserve(2 * flush_batch->size());
+  size_t total_bytes_serialized = 0;
+  for (auto it = flush_batch->begin(); it != flush_batch->end(); ++it) {
+    size_t local_total_bytes_serialized = 0;
+    auto execution_result = SerializeLogSegments(*it, buffer_segments,
+                                                 local_total_bytes_serialized);
+    if (!execution_result.Successful()) {
+      NotifyBatch(flush_batch, execution_result);
+      return;
+    }
+    total_bytes_serialized += local_total_bytes_serialized;
+  }
+
+  if (total_size_needed != total_bytes_serialized) {
+    auto execution_result = FailureExecutionResult(
+        core::errors::SC_JOURNAL_SERVICE_CORRUPTED_BATCH_OF_LOGS);
+    NotifyBatch(flush_batch, execution_result);
+    return;
+  }
+
+  auto execution_result = WriteJournalBlobSegments(
+      buffer_segments, journal_id,
+      bind(&JournalOutputStream::NotifyBatch, this, flush_batch, _1));
+  if (!execution_result.Successful()) {
+    NotifyBatch(flush_batch, execution_result);
+  }
+}
+
 void JournalOutputStream::NotifyBatch(
     const shared_ptr<list<AsyncContext<JournalStreamAppendLogRequest,
                                        JournalStreamAppendLogResponse>>>&
@@ -49,7 +49,8 @@ class JournalOutputStream
       const std::shared_ptr<BlobStorageClientInterface>&
           blob_storage_provider_client,
       const std::shared_ptr<cpio::AggregateMetricInterface>&
-          journal_output_metric);
+          journal_output_metric,
+      bool should_checksum_logs = false);
 
   ExecutionResult AppendLog(
       AsyncContext<journal_service::JournalStreamAppendLogRequest,
@@ -96,6 +97,24 @@ class JournalOutputStream
           journal_stream_append_log_context,
       BytesBuffer& buffer, size_t& bytes_serialized) noexcept;
 
+  /**
+   * @brief Serializes the log object provided by the journal stream append log
+   * context object as buffer segments: a buffer with the header and the
+   * journal log, followed by the log body in place if the request has one.
+   *
+   * @param journal_stream_append_log_context The journal stream append log
+   * context.
+   * @param buffer_segments The buffer segments to append the log to.
+   * @param bytes_serialized The total bytes serialized, with the log body.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult SerializeLogSegments(
+      AsyncContext<journal_service::JournalStreamAppendLogRequest,
+                   journal_service::JournalStreamAppendLogResponse>&
+          journal_stream_append_log_context,
+      std::vector<std::shared_ptr<BytesBuffer>>& buffer_segments,
+      size_t& bytes_serialized) noexcept;
+
   /**
    * @brief Writes the provided buffer to the journal blob with the provided id.
    *
@@ -108,6 +127,20 @@ class JournalOutputStream
       BytesBuffer& bytes_buffer, uint64_t current_journal_id,
       std::function<void(ExecutionResult&)> callback) noexcept;
 
+  /**
+   * @brief Writes the provided buffer segments one after another to the
+   * journal blob with the provided id.
+   *
+   * @param buffer_segments The buffer segments to write to the blob.
+   * @param current_journal_id The journal id to create the blob.
+   * @param callback The callback to call when the operation is completed.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult WriteJournalBlobSegments(
+      std::vector<std::shared_ptr<BytesBuffer>>& buffer_segments,
+      uint64_t current_journal_id,
+      std::function<void(ExecutionResult&)> callback) noexcept;
+
   /**
    * @brief Called when write operation on the journal blob is compeleted.
    *
@@ -144,6 +177,49 @@ class JournalOutputStream
           journal_service::JournalStreamAppendLogResponse>>>& flush_batch,
       JournalId journal_id) noexcept;
 
+  /**
+   * @brief Writes a single batch to the cloud storage provider as buffer
+   * segments, with the log bodies in place.
+   *
+   * @param flush_batch The batch of the async contexts.
+   * @param journal_id The current journal id for the batch.
+   * @param total_size_needed The total serialized size of the batch.
+   */
+  void WriteBatchSegments(
+      const std::shared_ptr<std::list<core::AsyncContext<
+          journal_service::JournalStreamAppendLogRequest,
+          journal_service::JournalStreamAppendLogResponse>>>& flush_batch,
+      JournalId journal_id, size_t total_size_needed) noexcept;
+
+  /**
+   * @brief Serializes the header and the journal log of the log, without the
+   * log body if the request has one in place. A checksummed log must be
+   * sealed once its log body is written.
+   *
+   * @param journal_stream_append_log_context The journal stream append log
+   * context.
+   * @param buffer The buffer to serialize the log to.
+   * @param bytes_serialized The total bytes serialized.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult SerializeLogWithoutBody(
+      AsyncContext<journal_service::JournalStreamAppendLogRequest,
+                   journal_service::JournalStreamAppendLogResponse>&
+          journal_stream_append_log_context,
+      BytesBuffer& buffer, size_t& bytes_serialized) noexcept;
+
+  /**
+   * @brief Puts the blob of the journal with the provided id.
+   *
+   * @param put_blob_request The put blob request, without the blob name.
+   * @param journal_id The journal id to create the blob.
+   * @param callback The callback to call when the operation is completed.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult PutJournalBlob(
+      std::shared_ptr<PutBlobRequest> put_blob_request, JournalId journal_id,
+      std::function<void(ExecutionResult&)> callback) noexcept;
+
   /// Mutex to synchronize concurrent batch creations of the pending logs.
   std::mutex create_batch_of_logs_mutex_;
 
@@ -165,6 +241,10 @@ class JournalOutputStream
   /// The aggregate metric instance for journal output count
   std::shared_ptr<cpio::AggregateMetricInterface> journal_output_count_metric_;
 
+  /// Whether the logs are written checksummed, which the readers of the
+  /// previous versions cannot read.
+  const bool should_checksum_logs_;
+
   /// The last persisted journal id by the writer.
   JournalId last_persisted_journal_id_;
 
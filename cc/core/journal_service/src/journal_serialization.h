@@ -21,12 +21,16 @@
 #include <set>
 #include <string>
 
+#include "absl/crc/crc32c.h"
+#include "absl/strings/string_view.h"
 #include "core/common/serialization/src/serialization.h"
 #include "core/common/uuid/src/uuid.h"
 #include "core/interface/journal_service_interface.h"
 #include "core/journal_service/src/error_codes.h"
 #include "core/journal_service/src/proto/journal_service.pb.h"
 #include "google/protobuf/any.pb.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
 #include "public/core/interface/execution_result.h"
 
 static constexpr uint64_t kCheckpointMetadataMagicNumber = 0x123456789;
@@ -34,6 +38,15 @@ static constexpr size_t kLogHeaderByteLength =
     3 * sizeof(uint64_t) + sizeof(uint16_t) + 4 * sizeof(uint64_t);
 static constexpr google::scp::core::Version kCurrentVersion = {.major = 1,
                                                                .minor = 0};
+/// The logs of version 2 frame the rest of the log with its length and its
+/// CRC32C right after the version.
+static constexpr google::scp::core::Version kChecksummedLogVersion = {
+    .major = 2, .minor = 0};
+static constexpr size_t kChecksummedLogFrameByteLength =
+    2 * sizeof(uint64_t) + sizeof(uint64_t) + sizeof(uint32_t);
+static constexpr size_t kChecksummedLogHeaderByteLength =
+    kChecksummedLogFrameByteLength + kLogHeaderByteLength -
+    2 * sizeof(uint64_t);
 
 namespace google::scp::core::journal_service {
 
@@ -69,49 +82,108 @@ class JournalSerialization {
     }
     bytes_serialized += current_bytes_serialized;
 
-    // Serializing timestamp.
     current_bytes_serialized = 0;
-    execution_result = core::common::Serialization::Serialize(
-        bytes_buffer, buffer_offset + bytes_serialized, timestamp,
-        current_bytes_serialized);
+    execution_result = SerializeLogHeaderFields(
+        bytes_buffer, buffer_offset + bytes_serialized, timestamp, log_status,
+        component_id, log_id, current_bytes_serialized);
+    // The fields serialized before a failure are still counted.
+    bytes_serialized += current_bytes_serialized;
     if (!execution_result.Successful()) {
       return execution_result;
     }
-    bytes_serialized += current_bytes_serialized;
+    return SuccessExecutionResult();
+  }
 
-    // Serializing log status.
-    uint16_t log_status_value = static_cast<uint16_t>(log_status);
-    current_bytes_serialized = 0;
-    execution_result = core::common::Serialization::Serialize(
-        bytes_buffer, buffer_offset + bytes_serialized, log_status_value,
-        current_bytes_serialized);
+  /**
+   * @brief Used to serialize the header section of a checksummed log, which
+   * frames the rest of the log with its length and CRC32C:
+   * [V-16B][Len-8B][CRC-4B][TS-8B][JLS-2B][C-Hid-8B][C.Lid-8B][Log.Hid-8B]
+   * [Log.Lid-8B]
+   * The length and the checksum are written by SealChecksummedLog once the
+   * rest of the log is serialized.
+   *
+   * @param bytes_buffer The bytes buffer to serialize the header to.
+   * @param buffer_offset The offset to write the log header to.
+   * @param timestamp The timestamp of the operation.
+   * @param log_status The status of the log.
+   * @param component_id The id of the component.
+   * @param log_id The id of the log.
+   * @param bytes_serialized Total bytes serialized after this operation.
+   * @return ExecutionResult The Execution results of the operation.
+   */
+  static ExecutionResult SerializeChecksummedLogHeader(
+      BytesBuffer& bytes_buffer, const size_t buffer_offset,
+      const Timestamp& timestamp, const JournalLogStatus& log_status,
+      const core::common::Uuid& component_id, const core::common::Uuid& log_id,
+      size_t& bytes_serialized) {
+    bytes_serialized = 0;
+    if (buffer_offset + kChecksummedLogFrameByteLength >
+        bytes_buffer.capacity) {
+      return FailureExecutionResult(
+          core::errors::SC_SERIALIZATION_BUFFER_NOT_WRITABLE);
+    }
 
+    size_t current_bytes_serialized = 0;
+    auto execution_result = core::common::Serialization::Serialize(
+        bytes_buffer, buffer_offset, kChecksummedLogVersion,
+        current_bytes_serialized);
     if (!execution_result.Successful()) {
       return execution_result;
     }
-    bytes_serialized += current_bytes_serialized;
+    // The length and the checksum are sealed after.
+    memset(bytes_buffer.bytes->data() + buffer_offset +
+               current_bytes_serialized,
+           0, kChecksummedLogFrameByteLength - current_bytes_serialized);
+    bytes_serialized += kChecksummedLogFrameByteLength;
 
-    // Serializing component id.
     current_bytes_serialized = 0;
-    execution_result = core::common::Serialization::Serialize(
-        bytes_buffer, buffer_offset + bytes_serialized, component_id,
-        current_bytes_serialized);
-
+    execution_result = SerializeLogHeaderFields(
+        bytes_buffer, buffer_offset + bytes_serialized, timestamp, log_status,
+        component_id, log_id, current_bytes_serialized);
+    bytes_serialized += current_bytes_serialized;
     if (!execution_result.Successful()) {
       return execution_result;
     }
-    bytes_serialized += current_bytes_serialized;
+    return SuccessExecutionResult();
+  }
 
-    // Serializing log id.
-    current_bytes_serialized = 0;
-    execution_result = core::common::Serialization::Serialize(
-        bytes_buffer, buffer_offset + bytes_serialized, log_id,
-        current_bytes_serialized);
+  /**
+   * @brief Writes the length and the checksum of a checksummed log once all of
+   * it is serialized.
+   *
+   * @param bytes_buffer The bytes buffer the log is serialized to.
+   * @param buffer_offset The offset of the header of the log.
+   * @param log_end_offset The offset right after the log in the buffer.
+   * @param log_body The log body written after the log end in another buffer,
+   * if any, e.g. in place.
+   * @return ExecutionResult The Execution results of the operation.
+   */
+  static ExecutionResult SealChecksummedLog(
+      BytesBuffer& bytes_buffer, const size_t buffer_offset,
+      const size_t log_end_offset,
+      const BytesBuffer* log_body = nullptr) {
+    auto checksummed_offset = buffer_offset + kChecksummedLogFrameByteLength;
+    if (log_end_offset < checksummed_offset ||
+        log_end_offset > bytes_buffer.capacity) {
+      return FailureExecutionResult(
+          core::errors::SC_SERIALIZATION_BUFFER_NOT_WRITABLE);
+    }
 
-    if (!execution_result.Successful()) {
-      return execution_result;
+    auto* data = bytes_buffer.bytes->data();
+    auto checksum = absl::ComputeCrc32c(absl::string_view(
+        data + checksummed_offset, log_end_offset - checksummed_offset));
+    uint64_t log_length = log_end_offset - checksummed_offset;
+    if (log_body && log_body->length > 0) {
+      checksum = absl::ExtendCrc32c(
+          checksum,
+          absl::string_view(log_body->bytes->data(), log_body->length));
+      log_length += log_body->length;
     }
-    bytes_serialized += current_bytes_serialized;
+
+    auto checksum_value = static_cast<uint32_t>(checksum);
+    auto* frame = data + buffer_offset + 2 * sizeof(uint64_t);
+    memcpy(frame, &log_length, sizeof(uint64_t));
+    memcpy(frame + sizeof(uint64_t), &checksum_value, sizeof(uint32_t));
     return SuccessExecutionResult();
   }
 
@@ -206,6 +278,90 @@ class JournalSerialization {
                      bytes_serialized);
   }
 
+  /**
+   * @brief Calculates the byte size of the log body field of a serialized
+   * journal log.
+   *
+   * @param log_body_length The length of the log body.
+   * @return size_t The byte size of the field, including its tag and length.
+   */
+  static size_t CalculateLogBodyFieldByteSize(size_t log_body_length) {
+    // As for any proto3 field, an empty log body is not serialized.
+    if (log_body_length == 0) {
+      return 0;
+    }
+    return google::protobuf::io::CodedOutputStream::VarintSize32(
+               GetLogBodyFieldTag()) +
+           google::protobuf::io::CodedOutputStream::VarintSize64(
+               log_body_length) +
+           log_body_length;
+  }
+
+  /**
+   * @brief Used to serialize a journal log object into a buffer except for
+   * the bytes of its log body, which the caller writes right after, e.g. from
+   * the buffer of the log body in place. Followed by the log body, the output
+   * is the same as the one of SerializeJournalLog with the log body set.
+   *
+   * @param bytes_buffer The bytes buffer to serialize the journal log to.
+   * @param buffer_offset The offset to write the journal log to.
+   * @param journal_log The journal log object to serialize, without log body.
+   * @param log_body_length The length of the log body written after.
+   * @param bytes_serialized Total bytes serialized after this operation.
+   * @return ExecutionResult The Execution results of the operation.
+   */
+  static ExecutionResult SerializeJournalLogWithoutBody(
+      BytesBuffer& bytes_buffer, const size_t buffer_offset,
+      const journal_service::JournalLog& journal_log,
+      const size_t log_body_length, size_t& bytes_serialized) {
+    bytes_serialized = 0;
+    if (!journal_log.log_body().empty()) {
+      return FailureExecutionResult(
+          core::errors::SC_JOURNAL_SERVICE_INVALID_LOG_BODY);
+    }
+
+    size_t journal_log_byte_size = journal_log.ByteSizeLong();
+    size_t log_body_field_byte_size =
+        CalculateLogBodyFieldByteSize(log_body_length);
+    size_t byte_size = sizeof(uint64_t) + journal_log_byte_size +
+                       log_body_field_byte_size - log_body_length;
+    if (buffer_offset + byte_size > bytes_buffer.capacity) {
+      return FailureExecutionResult(
+          core::errors::SC_SERIALIZATION_BUFFER_NOT_WRITABLE);
+    }
+
+    // The size block covers the log body too.
+    uint64_t serialized_journal_log_byte_size =
+        journal_log_byte_size + log_body_field_byte_size;
+    size_t current_bytes_serialized = 0;
+    auto execution_result = core::common::Serialization::Serialize(
+        bytes_buffer, buffer_offset, serialized_journal_log_byte_size,
+        current_bytes_serialized);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+
+    // The log body has the highest field number, so proto serializes it last.
+    auto* data =
+        bytes_buffer.bytes->data() + buffer_offset + current_bytes_serialized;
+    if (!journal_log.SerializeToArray(data, journal_log_byte_size)) {
+      return FailureExecutionResult(
+          core::errors::SC_SERIALIZATION_PROTO_SERIALIZATION_FAILED);
+    }
+    if (log_body_length > 0) {
+      auto* log_body_field_data =
+          reinterpret_cast<uint8_t*>(data + journal_log_byte_size);
+      log_body_field_data =
+          google::protobuf::io::CodedOutputStream::WriteTagToArray(
+              GetLogBodyFieldTag(), log_body_field_data);
+      google::protobuf::io::CodedOutputStream::WriteVarint64ToArray(
+          log_body_length, log_body_field_data);
+    }
+
+    bytes_serialized = byte_size;
+    return SuccessExecutionResult();
+  }
+
   /**
    * @brief Used to serialize a protobuf object into a buffer.
    *
@@ -271,6 +427,8 @@ class JournalSerialization {
    * @brief Used to deserialize a log header section. Log headers are stored in
    * the following format:
    * [V-16B][TS-8B][JLS-2B][C-Hid-8B][C.Lid-8B][Log.Hid-8B][Log.Lid-8B]
+   * or, for checksummed logs, in the format of SerializeChecksummedLogHeader,
+   * in which case the checksum of the whole log is verified.
    * @param bytes_buffer The bytes buffer to deserialize the header from.
    * @param buffer_offset The offset to write the log header from.
    * @param timestamp The timestamp of the operation.
@@ -300,55 +458,29 @@ class JournalSerialization {
     }
     bytes_deserialized += current_bytes_deserialized;
 
-    if (version.major != kCurrentVersion.major ||
-        version.minor != kCurrentVersion.minor) {
+    if (version.major == kChecksummedLogVersion.major &&
+        version.minor == kChecksummedLogVersion.minor) {
+      current_bytes_deserialized = 0;
+      execution_result = VerifyChecksummedLog(
+          bytes_buffer, buffer_offset, current_bytes_deserialized);
+      if (!execution_result.Successful()) {
+        return execution_result;
+      }
+      bytes_deserialized += current_bytes_deserialized;
+    } else if (version.major != kCurrentVersion.major ||
+               version.minor != kCurrentVersion.minor) {
       return FailureExecutionResult(
           errors::SC_SERIALIZATION_VERSION_IS_INVALID);
     }
 
-    // Deserialize timestamp.
     current_bytes_deserialized = 0;
-    execution_result = core::common::Serialization::Deserialize(
+    execution_result = DeserializeLogHeaderFields(
         bytes_buffer, buffer_offset + bytes_deserialized, timestamp,
-        current_bytes_deserialized);
-    if (!execution_result.Successful()) {
-      return execution_result;
-    }
+        log_status, component_id, log_id, current_bytes_deserialized);
     bytes_deserialized += current_bytes_deserialized;
-
-    // Deserialize log status.
-    uint16_t log_status_value = 0;
-    current_bytes_deserialized = 0;
-    execution_result = core::common::Serialization::Deserialize(
-        bytes_buffer, buffer_offset + bytes_deserialized, log_status_value,
-        current_bytes_deserialized);
     if (!execution_result.Successful()) {
       return execution_result;
     }
-    bytes_deserialized += current_bytes_deserialized;
-    log_status = static_cast<JournalLogStatus>(log_status_value);
-
-    // Deserialize component id.
-    current_bytes_deserialized = 0;
-    execution_result = core::common::Serialization::Deserialize(
-        bytes_buffer, buffer_offset + bytes_deserialized, component_id,
-        current_bytes_deserialized);
-
-    if (!execution_result.Successful()) {
-      return execution_result;
-    }
-    bytes_deserialized += current_bytes_deserialized;
-
-    // Deserialize log id.
-    current_bytes_deserialized = 0;
-    execution_result = core::common::Serialization::Deserialize(
-        bytes_buffer, buffer_offset + bytes_deserialized, log_id,
-        current_bytes_deserialized);
-
-    if (!execution_result.Successful()) {
-      return execution_result;
-    }
-    bytes_deserialized += current_bytes_deserialized;
     return SuccessExecutionResult();
   }
 
@@ -506,6 +638,171 @@ class JournalSerialization {
     return core::common::Serialization::Deserialize<google::protobuf::Message>(
         bytes_buffer, buffer_offset, object_to_deserialize, bytes_deserialized);
   }
+
+ private:
+  /**
+   * @brief Serializes the fields of a log header following its version:
+   * [TS-8B][JLS-2B][C-Hid-8B][C.Lid-8B][Log.Hid-8B][Log.Lid-8B]
+   */
+  static ExecutionResult SerializeLogHeaderFields(
+      BytesBuffer& bytes_buffer, const size_t buffer_offset,
+      const Timestamp& timestamp, const JournalLogStatus& log_status,
+      const core::common::Uuid& component_id, const core::common::Uuid& log_id,
+      size_t& bytes_serialized) {
+    bytes_serialized = 0;
+
+    // Serializing timestamp.
+    size_t current_bytes_serialized = 0;
+    auto execution_result = core::common::Serialization::Serialize(
+        bytes_buffer, buffer_offset + bytes_serialized, timestamp,
+        current_bytes_serialized);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_serialized += current_bytes_serialized;
+
+    // Serializing log status.
+    uint16_t log_status_value = static_cast<uint16_t>(log_status);
+    current_bytes_serialized = 0;
+    execution_result = core::common::Serialization::Serialize(
+        bytes_buffer, buffer_offset + bytes_serialized, log_status_value,
+        current_bytes_serialized);
+
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_serialized += current_bytes_serialized;
+
+    // Serializing component id.
+    current_bytes_serialized = 0;
+    execution_result = core::common::Serialization::Serialize(
+        bytes_buffer, buffer_offset + bytes_serialized, component_id,
+        current_bytes_serialized);
+
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_serialized += current_bytes_serialized;
+
+    // Serializing log id.
+    current_bytes_serialized = 0;
+    execution_result = core::common::Serialization::Serialize(
+        bytes_buffer, buffer_offset + bytes_serialized, log_id,
+        current_bytes_serialized);
+
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_serialized += current_bytes_serialized;
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Deserializes the fields of a log header following its version, in
+   * the format of SerializeLogHeaderFields.
+   */
+  static ExecutionResult DeserializeLogHeaderFields(
+      const BytesBuffer& bytes_buffer, const size_t buffer_offset,
+      Timestamp& timestamp, JournalLogStatus& log_status,
+      core::common::Uuid& component_id, core::common::Uuid& log_id,
+      size_t& bytes_deserialized) {
+    bytes_deserialized = 0;
+
+    // Deserialize timestamp.
+    size_t current_bytes_deserialized = 0;
+    auto execution_result = core::common::Serialization::Deserialize(
+        bytes_buffer, buffer_offset + bytes_deserialized, timestamp,
+        current_bytes_deserialized);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_deserialized += current_bytes_deserialized;
+
+    // Deserialize log status.
+    uint16_t log_status_value = 0;
+    current_bytes_deserialized = 0;
+    execution_result = core::common::Serialization::Deserialize(
+        bytes_buffer, buffer_offset + bytes_deserialized, log_status_value,
+        current_bytes_deserialized);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_deserialized += current_bytes_deserialized;
+    log_status = static_cast<JournalLogStatus>(log_status_value);
+
+    // Deserialize component id.
+    current_bytes_deserialized = 0;
+    execution_result = core::common::Serialization::Deserialize(
+        bytes_buffer, buffer_offset + bytes_deserialized, component_id,
+        current_bytes_deserialized);
+
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_deserialized += current_bytes_deserialized;
+
+    // Deserialize log id.
+    current_bytes_deserialized = 0;
+    execution_result = core::common::Serialization::Deserialize(
+        bytes_buffer, buffer_offset + bytes_deserialized, log_id,
+        current_bytes_deserialized);
+
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_deserialized += current_bytes_deserialized;
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Verifies the checksum of the checksummed log at the offset, and
+   * returns the byte count of its length and checksum following the version.
+   */
+  static ExecutionResult VerifyChecksummedLog(const BytesBuffer& bytes_buffer,
+                                              const size_t buffer_offset,
+                                              size_t& bytes_deserialized) {
+    bytes_deserialized = 0;
+    size_t current_bytes_deserialized = 0;
+    uint64_t log_length = 0;
+    auto execution_result = core::common::Serialization::Deserialize(
+        bytes_buffer, buffer_offset + 2 * sizeof(uint64_t), log_length,
+        current_bytes_deserialized);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_deserialized += current_bytes_deserialized;
+
+    uint32_t checksum = 0;
+    current_bytes_deserialized = 0;
+    execution_result = core::common::Serialization::Deserialize(
+        bytes_buffer, buffer_offset + 2 * sizeof(uint64_t) + bytes_deserialized,
+        checksum, current_bytes_deserialized);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    bytes_deserialized += current_bytes_deserialized;
+
+    auto checksummed_offset = buffer_offset + kChecksummedLogFrameByteLength;
+    if (log_length > bytes_buffer.length - checksummed_offset) {
+      return FailureExecutionResult(
+          errors::SC_SERIALIZATION_BUFFER_NOT_READABLE);
+    }
+    auto expected_checksum = static_cast<uint32_t>(
+        absl::ComputeCrc32c(absl::string_view(
+            bytes_buffer.bytes->data() + checksummed_offset, log_length)));
+    if (checksum != expected_checksum) {
+      return FailureExecutionResult(
+          errors::SC_JOURNAL_SERVICE_LOG_CHECKSUM_MISMATCH);
+    }
+    return SuccessExecutionResult();
+  }
+
+  /// Returns the tag of the log body field of the journal log.
+  static uint32_t GetLogBodyFieldTag() {
+    return google::protobuf::internal::WireFormatLite::MakeTag(
+        journal_service::JournalLog::kLogBodyFieldNumber,
+        google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  }
 };
 
 /**
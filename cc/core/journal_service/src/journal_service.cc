@@ -29,6 +29,7 @@
 #include "core/journal_service/src/journal_input_stream.h"
 #include "core/journal_service/src/journal_output_stream.h"
 #include "core/journal_service/src/journal_serialization.h"
+#include "core/journal_service/src/journal_utils.h"
 #include "core/journal_service/src/proto/journal_service.pb.h"
 #include "public/cpio/utils/metric_aggregation/interface/simple_metric_interface.h"
 #include "public/cpio/utils/metric_aggregation/src/metric_utils.h"
@@ -37,6 +38,8 @@
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::common::Uuid;
 using google::scp::core::journal_service::JournalLog;
+using google::scp::core::journal_service::JournalLogGroup;
+using google::scp::core::journal_service::JournalLogType;
 using google::scp::core::journal_service::JournalSerialization;
 using google::scp::core::journal_service::JournalStreamAppendLogRequest;
 using google::scp::core::journal_service::JournalStreamAppendLogResponse;
@@ -100,6 +103,12 @@ ExecutionResult JournalService::Init() noexcept {
     return execution_result;
   }
 
+  // The journals are written to and recovered from the local tier, which
+  // ships them to the blob storage.
+  if (local_tier_path_ && !local_tier_path_->empty()) {
+    RETURN_IF_FAILURE(InitLocalTier());
+  }
+
   journal_input_stream_ = make_shared<JournalInputStream>(
       bucket_name_, partition_name_, blob_storage_provider_client_,
       config_provider_);
@@ -154,6 +163,12 @@ ExecutionResult JournalService::Init() noexcept {
     journal_flush_interval_in_milliseconds_ = kMaxWaitTimeForFlushMs;
   }
 
+  if (!config_provider_->Get(kPBSJournalServiceChecksumLogs,
+                             should_checksum_logs_)
+           .Successful()) {
+    should_checksum_logs_ = false;
+  }
+
   SCP_INFO(
       kJournalService, partition_id_,
       "Starting Journal Service for Partition with ID: '%s'. Flush interval "
@@ -163,6 +178,61 @@ ExecutionResult JournalService::Init() noexcept {
   return SuccessExecutionResult();
 }
 
+ExecutionResult JournalService::InitLocalTier() noexcept {
+  size_t segment_byte_size;
+  if (!config_provider_
+           ->Get(kPBSJournalServiceLocalTierSegmentByteSize, segment_byte_size)
+           .Successful()) {
+    segment_byte_size = kDefaultJournalLocalTierSegmentByteSize;
+  }
+  size_t segment_count;
+  if (!config_provider_
+           ->Get(kPBSJournalServiceLocalTierSegmentCount, segment_count)
+           .Successful()) {
+    segment_count = kDefaultJournalLocalTierSegmentCount;
+  }
+
+  local_tier_ = make_shared<JournalLocalTier>(
+      bucket_name_,
+      absl::StrCat(*partition_name_, "/", kJournalBlobNamePrefix),
+      absl::StrCat(*local_tier_path_, "/", *partition_name_),
+      segment_byte_size, segment_count, blob_storage_provider_client_);
+  auto execution_result = local_tier_->Init();
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kJournalService, kZeroUuid, execution_result,
+              "Cannot initialize the journal local tier at '%s'",
+              local_tier_path_->c_str());
+    local_tier_ = nullptr;
+    return execution_result;
+  }
+  blob_storage_provider_client_ = local_tier_;
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalService::AttachLocalTier(
+    const shared_ptr<string>& local_tier_path) noexcept {
+  if (!is_initialized_) {
+    return FailureExecutionResult(errors::SC_JOURNAL_SERVICE_NOT_INITIALIZED);
+  }
+  if (is_running()) {
+    return FailureExecutionResult(errors::SC_JOURNAL_SERVICE_ALREADY_RUNNING);
+  }
+  if (local_tier_) {
+    return FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_LOCAL_TIER_ALREADY_ATTACHED);
+  }
+  if (!local_tier_path || local_tier_path->empty()) {
+    return SuccessExecutionResult();
+  }
+
+  local_tier_path_ = local_tier_path;
+  RETURN_IF_FAILURE(InitLocalTier());
+  // The recoveries after this point must go through the local tier too, as
+  // it also returns the journals it has not shipped yet.
+  journal_input_stream_ = nullptr;
+  return SuccessExecutionResult();
+}
+
 ExecutionResult JournalService::Run() noexcept {
   if (!is_initialized_) {
     return FailureExecutionResult(errors::SC_JOURNAL_SERVICE_NOT_INITIALIZED);
@@ -178,6 +248,10 @@ ExecutionResult JournalService::Run() noexcept {
 
   RETURN_IF_FAILURE(journal_output_count_metric_->Run());
 
+  if (local_tier_) {
+    RETURN_IF_FAILURE(local_tier_->Run());
+  }
+
   atomic<bool> flushing_thread_started(false);
   flushing_thread_ = make_unique<thread>([this, &flushing_thread_started]() {
     flushing_thread_started = true;
@@ -212,6 +286,11 @@ ExecutionResult JournalService::Stop() noexcept {
     flushing_thread_->join();
   }
 
+  // The local tier ships the journals flushed above before stopping.
+  if (local_tier_) {
+    RETURN_IF_FAILURE(local_tier_->Stop());
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -224,6 +303,18 @@ ExecutionResult JournalService::StopRecoveryMetrics() noexcept {
 ExecutionResult JournalService::Recover(
     AsyncContext<JournalRecoverRequest, JournalRecoverResponse>&
         journal_recover_context) noexcept {
+  // An incremental recovery reads the journals after the given journal id
+  // with a fresh input stream. A fresh stream is also needed if a previous
+  // recovery has already consumed the stream.
+  if (journal_recover_context.request->start_after_journal_id !=
+          kInvalidJournalId ||
+      !journal_input_stream_) {
+    journal_input_stream_ = make_shared<JournalInputStream>(
+        bucket_name_, partition_name_, blob_storage_provider_client_,
+        config_provider_,
+        journal_recover_context.request->start_after_journal_id);
+  }
+
   shared_ptr<TimeEvent> time_event = make_shared<TimeEvent>();
   auto replayed_log_ids = make_shared<unordered_set<string>>();
   AsyncContext<JournalStreamReadLogRequest, JournalStreamReadLogResponse>
@@ -245,12 +336,14 @@ ExecutionResult JournalService::Recover(
            "Starting JournalStreamReadLogRequest. Max journal id to process: "
            "'%llu', max number of journals to process: '%llu', Should perform "
            "recovery when "
-           "there is only a checkpoint to process: '%d'",
+           "there is only a checkpoint to process: '%d', Start after journal "
+           "id: '%llu'",
            journal_stream_read_log_context.request->max_journal_id_to_process,
            journal_stream_read_log_context.request
                ->max_number_of_journals_to_process,
            journal_stream_read_log_context.request
-               ->should_read_stream_when_only_checkpoint_exists);
+               ->should_read_stream_when_only_checkpoint_exists,
+           journal_recover_context.request->start_after_journal_id);
 
   return journal_input_stream_->ReadLog(journal_stream_read_log_context);
 }
@@ -277,7 +370,8 @@ void JournalService::OnJournalStreamReadLogCallback(
           journal_input_stream_->GetLastProcessedJournalId();
       journal_output_stream_ = make_shared<JournalOutputStream>(
           bucket_name_, partition_name_, async_executor_,
-          blob_storage_provider_client_, journal_output_count_metric_);
+          blob_storage_provider_client_, journal_output_count_metric_,
+          should_checksum_logs_);
       // Set to nullptr to deallocate the stream and its data.
       journal_input_stream_ = nullptr;
     }
@@ -339,9 +433,15 @@ void JournalService::OnJournalStreamReadLogCallback(
 
     replayed_log_ids->emplace(log_index);
 
-    auto bytes_buffer = make_shared<BytesBuffer>(log.journal_log->log_body());
-    execution_result =
-        callback(bytes_buffer, journal_recover_context.activity_id);
+    if (log.journal_log->type() == JournalLogType::JOURNAL_LOG_TYPE_GROUP) {
+      execution_result =
+          ReplayJournalLogGroup(*log.journal_log, journal_recover_context);
+    } else {
+      auto bytes_buffer =
+          make_shared<BytesBuffer>(log.journal_log->log_body());
+      execution_result =
+          callback(bytes_buffer, journal_recover_context.activity_id);
+    }
     if (!execution_result.Successful()) {
       SCP_ERROR_CONTEXT(
           kJournalService, journal_recover_context, execution_result,
@@ -401,9 +501,19 @@ ExecutionResult JournalService::Log(
           journal_log_context);
   journal_stream_append_log_context.request->journal_log =
       make_shared<JournalLog>();
-  journal_stream_append_log_context.request->journal_log->set_log_body(
-      journal_log_context.request->data->bytes->data(),
-      journal_log_context.request->data->length);
+  if (!journal_log_context.request->records.empty()) {
+    auto execution_result = SerializeJournalLogGroup(
+        journal_log_context.request->records,
+        *journal_stream_append_log_context.request->journal_log);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  } else {
+    // The data is written in place when the log is flushed instead of being
+    // copied into the journal log.
+    journal_stream_append_log_context.request->log_body =
+        journal_log_context.request->data;
+  }
   journal_stream_append_log_context.request->component_id =
       journal_log_context.request->component_id;
   journal_stream_append_log_context.request->log_id =
@@ -414,6 +524,66 @@ ExecutionResult JournalService::Log(
   return journal_output_stream_->AppendLog(journal_stream_append_log_context);
 }
 
+ExecutionResult JournalService::SerializeJournalLogGroup(
+    const vector<JournalLogRecord>& records,
+    JournalLog& journal_log) noexcept {
+  JournalLogGroup journal_log_group;
+  for (const auto& record : records) {
+    if (!record.data || !record.data->bytes) {
+      return FailureExecutionResult(
+          errors::SC_JOURNAL_SERVICE_INVALID_LOG_GROUP);
+    }
+    auto* group_record = journal_log_group.add_records();
+    group_record->mutable_component_id()->set_high(record.component_id.high);
+    group_record->mutable_component_id()->set_low(record.component_id.low);
+    group_record->set_log_body(record.data->bytes->data(),
+                               record.data->length);
+  }
+
+  journal_log.set_type(JournalLogType::JOURNAL_LOG_TYPE_GROUP);
+  if (!journal_log_group.SerializeToString(journal_log.mutable_log_body())) {
+    return FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_INVALID_LOG_GROUP);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult JournalService::ReplayJournalLogGroup(
+    const JournalLog& journal_log,
+    AsyncContext<JournalRecoverRequest, JournalRecoverResponse>&
+        journal_recover_context) noexcept {
+  JournalLogGroup journal_log_group;
+  if (!journal_log_group.ParseFromString(journal_log.log_body())) {
+    return FailureExecutionResult(
+        errors::SC_JOURNAL_SERVICE_INVALID_LOG_GROUP);
+  }
+
+  for (const auto& record : journal_log_group.records()) {
+    Uuid component_id;
+    component_id.high = record.component_id().high();
+    component_id.low = record.component_id().low();
+
+    OnLogRecoveredCallback callback;
+    auto execution_result = subscribers_map_.Find(component_id, callback);
+    if (!execution_result.Successful()) {
+      SCP_ERROR_CONTEXT(kJournalService, journal_recover_context,
+                        execution_result,
+                        "Cannot find the component with id %s of the log "
+                        "group record",
+                        core::common::ToString(component_id).c_str());
+      return execution_result;
+    }
+
+    execution_result =
+        callback(make_shared<BytesBuffer>(record.log_body()),
+                 journal_recover_context.activity_id);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  }
+  return SuccessExecutionResult();
+}
+
 void JournalService::OnJournalStreamAppendLogCallback(
     AsyncContext<JournalLogRequest, JournalLogResponse>& journal_log_context,
     AsyncContext<JournalStreamAppendLogRequest, JournalStreamAppendLogResponse>&
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "core/common/operation_dispatcher/src/operation_dispatcher.h"
 #include "core/common/uuid/src/uuid.h"
@@ -28,6 +29,7 @@
 #include "core/interface/journal_service_interface.h"
 #include "core/interface/partition_types.h"
 #include "core/journal_service/interface/journal_service_stream_interface.h"
+#include "core/journal_service/src/journal_local_tier.h"
 #include "cpio/client_providers/interface/metric_client_provider_interface.h"
 #include "public/cpio/interface/metric_client/metric_client_interface.h"
 #include "public/cpio/utils/metric_aggregation/interface/aggregate_metric_interface.h"
@@ -50,7 +52,8 @@ class JournalService : public JournalServiceInterface {
       const std::shared_ptr<BlobStorageProviderInterface>&
           blob_storage_provider,
       const std::shared_ptr<cpio::MetricClientInterface>& metric_client,
-      const std::shared_ptr<ConfigProviderInterface>& config_provider)
+      const std::shared_ptr<ConfigProviderInterface>& config_provider,
+      const std::shared_ptr<std::string>& local_tier_path = nullptr)
       : is_initialized_(false),
         is_running_(false),
         bucket_name_(bucket_name),
@@ -64,7 +67,9 @@ class JournalService : public JournalServiceInterface {
                                   kJournalServiceRetryStrategyTotalRetries)),
         metric_client_(metric_client),
         config_provider_(config_provider),
-        journal_flush_interval_in_milliseconds_(0) {}
+        local_tier_path_(local_tier_path),
+        journal_flush_interval_in_milliseconds_(0),
+        should_checksum_logs_(false) {}
 
   ExecutionResult Init() noexcept override;
 
@@ -93,7 +98,14 @@ class JournalService : public JournalServiceInterface {
   ExecutionResult GetLastPersistedJournalId(
       JournalId& journal_id) noexcept override;
 
+  ExecutionResult AttachLocalTier(
+      const std::shared_ptr<std::string>& local_tier_path) noexcept override;
+
  protected:
+  /// Creates the local tier at local_tier_path_ in front of the blob storage
+  /// client.
+  ExecutionResult InitLocalTier() noexcept;
+
   /**
    * @brief Is called after the read log operation is completed.
    *
@@ -115,6 +127,30 @@ class JournalService : public JournalServiceInterface {
                    journal_service::JournalStreamReadLogResponse>&
           journal_stream_read_log_context) noexcept;
 
+  /**
+   * @brief Serializes the records of a log group into the journal log.
+   *
+   * @param records The records of the log group.
+   * @param journal_log The journal log to write the group into.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult SerializeJournalLogGroup(
+      const std::vector<JournalLogRecord>& records,
+      journal_service::JournalLog& journal_log) noexcept;
+
+  /**
+   * @brief Replays the records of a log group in order, each by the
+   * subscriber of its component.
+   *
+   * @param journal_log The journal log containing the log group.
+   * @param journal_recover_context The context of the recovery operation.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult ReplayJournalLogGroup(
+      const journal_service::JournalLog& journal_log,
+      AsyncContext<JournalRecoverRequest, JournalRecoverResponse>&
+          journal_recover_context) noexcept;
+
   /**
    * @brief Is called after append log operation is completed.
    *
@@ -194,10 +230,20 @@ class JournalService : public JournalServiceInterface {
   /// Config provider
   std::shared_ptr<ConfigProviderInterface> config_provider_;
 
+  /// The directory of the local tier of the journals, which is disabled if
+  /// not set.
+  std::shared_ptr<std::string> local_tier_path_;
+
+  /// The local tier in front of the blob storage, if enabled.
+  std::shared_ptr<JournalLocalTier> local_tier_;
+
   /// Encapsulating Partition ID
   PartitionId partition_id_;
 
   /// Journal flush interval
   size_t journal_flush_interval_in_milliseconds_;
+
+  /// Whether the journal logs are written checksummed.
+  bool should_checksum_logs_;
 };
 }  // namespace google::scp::core
@@ -555,6 +555,67 @@ TEST_P(JournalInputStreamTestWithParam,
   ExpectNoMoreLogsToReturn();
 }
 
+TEST_P(JournalInputStreamTestWithParam,
+       ReadLogsAfterStartJournalIdSkipsCheckpointAndOlderJournals) {
+  JournalLog journal_log_1;
+  journal_log_1.set_type(11);
+  EXPECT_SUCCESS(WriteCheckpoint(journal_log_1, /*last_processed_journal_id=*/1,
+                                 IdToString(2)));
+  EXPECT_SUCCESS(WriteLastCheckpoint(2));
+
+  JournalLog journal_log_2;
+  journal_log_2.set_type(22);
+  EXPECT_SUCCESS(WriteJournalLog(journal_log_2, IdToString(3)));
+
+  JournalLog journal_log_3;
+  journal_log_3.set_type(33);
+  EXPECT_SUCCESS(WriteJournalLog(journal_log_3, IdToString(5)));
+
+  journal_input_stream_ = std::make_unique<JournalInputStream>(
+      std::make_shared<std::string>(kBucketName),
+      std::make_shared<std::string>(kPartitionName),
+      std::shared_ptr<BlobStorageClientInterface>(mock_storage_client_),
+      std::make_shared<EnvConfigProvider>(), /*start_after_journal_id=*/3);
+
+  AsyncContext<JournalStreamReadLogRequest, JournalStreamReadLogResponse>
+      context = ReadLogs();
+
+  EXPECT_SUCCESS(context.result);
+  ASSERT_TRUE(context.response != nullptr);
+  ASSERT_TRUE(context.response->read_logs != nullptr);
+  ASSERT_EQ(context.response->read_logs->size(), 1);
+
+  EXPECT_THAT(*context.response->read_logs->at(0).journal_log,
+              EqualsProto(journal_log_3));
+  EXPECT_EQ(context.response->read_logs->at(0).journal_id, 5);
+  EXPECT_EQ(journal_input_stream_->GetLastProcessedJournalId(), 5);
+
+  ExpectNoMoreLogsToReturn();
+}
+
+TEST_P(JournalInputStreamTestWithParam,
+       ReadLogsAfterStartJournalIdWithoutNewJournals) {
+  JournalLog journal_log_1;
+  journal_log_1.set_type(11);
+  EXPECT_SUCCESS(WriteJournalLog(journal_log_1, IdToString(3)));
+
+  journal_input_stream_ = std::make_unique<JournalInputStream>(
+      std::make_shared<std::string>(kBucketName),
+      std::make_shared<std::string>(kPartitionName),
+      std::shared_ptr<BlobStorageClientInterface>(mock_storage_client_),
+      std::make_shared<EnvConfigProvider>(), /*start_after_journal_id=*/3);
+
+  AsyncContext<JournalStreamReadLogRequest, JournalStreamReadLogResponse>
+      context = ReadLogs();
+  EXPECT_THAT(context.result,
+              FailureExecutionResult(
+                  core::errors::
+                      SC_JOURNAL_SERVICE_INPUT_STREAM_NO_MORE_LOGS_TO_RETURN));
+  EXPECT_EQ(journal_input_stream_->GetLastProcessedJournalId(), 3);
+
+  ExpectNoMoreLogsToReturn();
+}
+
 TEST_P(JournalInputStreamTestWithParam,
        ReadLogsWithOneCheckpointAndOneJournalBeforeCheckpoint) {
   JournalLog journal_log_1;
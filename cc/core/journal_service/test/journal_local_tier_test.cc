@@ -0,0 +1,386 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/journal_service/src/journal_local_tier.h"
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/blob_storage_provider/mock/mock_blob_storage_provider.h"
+#include "core/blob_storage_provider/src/common/error_codes.h"
+#include "core/journal_service/mock/mock_journal_local_tier.h"
+#include "core/journal_service/src/error_codes.h"
+#include "core/test/utils/conditional_wait.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::blob_storage_provider::mock::MockBlobStorageClient;
+using google::scp::core::journal_service::mock::MockJournalLocalTier;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::WaitUntil;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google::scp::core::test {
+
+constexpr char kBucketName[] = "journal_local_tier_bucket";
+constexpr char kBlobNamePrefix[] = "journal_";
+constexpr char kTierPath[] = "journal_local_tier_segments";
+constexpr size_t kSegmentByteSize = 4096;
+
+class JournalLocalTierTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    RemoveDirectories();
+    std::filesystem::create_directory(kBucketName);
+    remote_blob_storage_client_ = make_shared<MockBlobStorageClient>();
+  }
+
+  void TearDown() override { RemoveDirectories(); }
+
+  void RemoveDirectories() {
+    std::filesystem::remove_all(kBucketName);
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+      if (entry.path().filename().string().rfind(kTierPath, 0) == 0) {
+        std::filesystem::remove_all(entry.path());
+      }
+    }
+  }
+
+  bool IsQuarantined() {
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+      if (entry.path().filename().string().rfind(
+              absl::StrCat(kTierPath, ".quarantined_"), 0) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::unique_ptr<MockJournalLocalTier> CreateLocalTier(
+      size_t segment_count = 3) {
+    auto local_tier = std::make_unique<MockJournalLocalTier>(
+        bucket_name_, kBlobNamePrefix, kTierPath, kSegmentByteSize,
+        segment_count, remote_blob_storage_client_);
+    EXPECT_SUCCESS(local_tier->Init());
+    return local_tier;
+  }
+
+  ExecutionResult PutBlob(BlobStorageClientInterface& client,
+                          const string& blob_name, const string& data) {
+    AsyncContext<PutBlobRequest, PutBlobResponse> put_blob_context;
+    put_blob_context.request = make_shared<PutBlobRequest>();
+    put_blob_context.request->bucket_name = bucket_name_;
+    put_blob_context.request->blob_name = make_shared<string>(blob_name);
+    put_blob_context.request->buffer = make_shared<BytesBuffer>(data.size());
+    put_blob_context.request->buffer->bytes->assign(data.begin(), data.end());
+    put_blob_context.request->buffer->length = data.size();
+    ExecutionResult put_blob_result = FailureExecutionResult(SC_UNKNOWN);
+    put_blob_context.callback = [&](auto& put_blob_context) {
+      put_blob_result = put_blob_context.result;
+    };
+    RETURN_IF_FAILURE(client.PutBlob(put_blob_context));
+    return put_blob_result;
+  }
+
+  ExecutionResult GetBlob(BlobStorageClientInterface& client,
+                          const string& blob_name, string& data) {
+    AsyncContext<GetBlobRequest, GetBlobResponse> get_blob_context;
+    get_blob_context.request = make_shared<GetBlobRequest>();
+    get_blob_context.request->bucket_name = bucket_name_;
+    get_blob_context.request->blob_name = make_shared<string>(blob_name);
+    ExecutionResult get_blob_result = FailureExecutionResult(SC_UNKNOWN);
+    get_blob_context.callback = [&](auto& get_blob_context) {
+      get_blob_result = get_blob_context.result;
+      if (get_blob_result.Successful()) {
+        const auto& buffer = *get_blob_context.response->buffer;
+        data = string(buffer.bytes->begin(),
+                      buffer.bytes->begin() + buffer.length);
+      }
+    };
+    RETURN_IF_FAILURE(client.GetBlob(get_blob_context));
+    return get_blob_result;
+  }
+
+  vector<string> ListBlobs(BlobStorageClientInterface& client,
+                           const string& prefix) {
+    vector<string> blob_names;
+    shared_ptr<string> marker;
+    while (true) {
+      AsyncContext<ListBlobsRequest, ListBlobsResponse> list_blobs_context;
+      list_blobs_context.request = make_shared<ListBlobsRequest>();
+      list_blobs_context.request->bucket_name = bucket_name_;
+      list_blobs_context.request->blob_name = make_shared<string>(prefix);
+      list_blobs_context.request->marker = marker;
+      marker = nullptr;
+      list_blobs_context.callback = [&](auto& list_blobs_context) {
+        EXPECT_SUCCESS(list_blobs_context.result);
+        for (const auto& blob : *list_blobs_context.response->blobs) {
+          blob_names.push_back(*blob.blob_name);
+        }
+        if (list_blobs_context.response->next_marker) {
+          marker = list_blobs_context.response->next_marker->blob_name;
+        }
+      };
+      EXPECT_SUCCESS(client.ListBlobs(list_blobs_context));
+      if (!marker) {
+        return blob_names;
+      }
+    }
+  }
+
+  bool IsShipped(const string& blob_name) {
+    return std::filesystem::exists(absl::StrCat(kBucketName, "/", blob_name));
+  }
+
+  shared_ptr<string> bucket_name_ = make_shared<string>(kBucketName);
+  shared_ptr<MockBlobStorageClient> remote_blob_storage_client_;
+};
+
+TEST_F(JournalLocalTierTest, BlobsAreServedLocallyUntilShipped) {
+  auto local_tier = CreateLocalTier();
+  EXPECT_SUCCESS(PutBlob(*local_tier, "journal_1", "first"));
+  EXPECT_FALSE(IsShipped("journal_1"));
+
+  string data;
+  EXPECT_SUCCESS(GetBlob(*local_tier, "journal_1", data));
+  EXPECT_EQ(data, "first");
+  EXPECT_EQ(ListBlobs(*local_tier, "journal_"), vector<string>{"journal_1"});
+
+  AsyncContext<DeleteBlobRequest, DeleteBlobResponse> delete_blob_context;
+  delete_blob_context.request = make_shared<DeleteBlobRequest>();
+  delete_blob_context.request->bucket_name = bucket_name_;
+  delete_blob_context.request->blob_name = make_shared<string>("journal_1");
+  EXPECT_THAT(local_tier->DeleteBlob(delete_blob_context),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_LOCAL_TIER_BLOB_NOT_SHIPPED)));
+
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  EXPECT_TRUE(IsShipped("journal_1"));
+  EXPECT_SUCCESS(GetBlob(*remote_blob_storage_client_, "journal_1", data));
+  EXPECT_EQ(data, "first");
+  EXPECT_SUCCESS(GetBlob(*local_tier, "journal_1", data));
+  EXPECT_EQ(data, "first");
+  EXPECT_EQ(ListBlobs(*local_tier, "journal_"), vector<string>{"journal_1"});
+  EXPECT_SUCCESS(local_tier->DeleteBlob(delete_blob_context));
+}
+
+TEST_F(JournalLocalTierTest, BlobsAreShippedInTheBackground) {
+  auto local_tier = CreateLocalTier();
+  EXPECT_SUCCESS(local_tier->Run());
+  EXPECT_SUCCESS(PutBlob(*local_tier, "journal_1", "first"));
+  WaitUntil([&]() { return IsShipped("journal_1"); });
+  EXPECT_SUCCESS(local_tier->Stop());
+}
+
+TEST_F(JournalLocalTierTest, FailedShipmentsAreRetriedInOrder) {
+  auto local_tier = CreateLocalTier();
+  EXPECT_SUCCESS(PutBlob(*local_tier, "journal_1", "first"));
+  EXPECT_SUCCESS(PutBlob(*local_tier, "journal_2", "second"));
+
+  vector<string> shipped_blob_names;
+  remote_blob_storage_client_->put_blob_mock =
+      [&](AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) {
+        shipped_blob_names.push_back(*put_blob_context.request->blob_name);
+        put_blob_context.result = FailureExecutionResult(SC_UNKNOWN);
+        put_blob_context.Finish();
+        return SuccessExecutionResult();
+      };
+  EXPECT_THAT(local_tier->ShipPendingBlobs(),
+              ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+  EXPECT_EQ(shipped_blob_names, vector<string>{"journal_1"});
+
+  remote_blob_storage_client_->put_blob_mock = nullptr;
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  EXPECT_TRUE(IsShipped("journal_1"));
+  EXPECT_TRUE(IsShipped("journal_2"));
+}
+
+TEST_F(JournalLocalTierTest, UnshippedBlobsAreRecoveredOnInit) {
+  {
+    auto local_tier = CreateLocalTier();
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_1", "first"));
+    EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_2", "second"));
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_3", "third"));
+  }
+  EXPECT_FALSE(IsShipped("journal_2"));
+
+  auto local_tier = CreateLocalTier();
+  string data;
+  EXPECT_SUCCESS(GetBlob(*local_tier, "journal_2", data));
+  EXPECT_EQ(data, "second");
+  EXPECT_EQ(ListBlobs(*local_tier, "journal_"),
+            (vector<string>{"journal_1", "journal_2", "journal_3"}));
+
+  // The blobs written after the recovery are appended to another segment.
+  EXPECT_SUCCESS(PutBlob(*local_tier, "journal_4", "fourth"));
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  EXPECT_TRUE(IsShipped("journal_3"));
+  EXPECT_TRUE(IsShipped("journal_4"));
+}
+
+TEST_F(JournalLocalTierTest, RecoveredBlobsAreKeptIfNotSuperseded) {
+  {
+    auto local_tier = CreateLocalTier();
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_2", "second"));
+  }
+  // Older journals and blobs other than journals do not supersede the
+  // recovered blobs.
+  EXPECT_SUCCESS(PutBlob(*remote_blob_storage_client_, "journal_1", "first"));
+  EXPECT_SUCCESS(
+      PutBlob(*remote_blob_storage_client_, "last_checkpoint", "checkpoint"));
+
+  auto local_tier = CreateLocalTier();
+  EXPECT_FALSE(IsQuarantined());
+  string data;
+  EXPECT_SUCCESS(GetBlob(*local_tier, "journal_2", data));
+  EXPECT_EQ(data, "second");
+}
+
+TEST_F(JournalLocalTierTest, SupersededBlobsAreQuarantinedOnInit) {
+  {
+    auto local_tier = CreateLocalTier();
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_1", "first"));
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_2", "second"));
+  }
+  // Another owner of the partition has written a journal since.
+  EXPECT_SUCCESS(PutBlob(*remote_blob_storage_client_, "journal_3", "third"));
+
+  auto local_tier = CreateLocalTier();
+  EXPECT_TRUE(IsQuarantined());
+  string data;
+  EXPECT_THAT(GetBlob(*local_tier, "journal_1", data),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+  EXPECT_EQ(ListBlobs(*local_tier, "journal_"), vector<string>{"journal_3"});
+
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  EXPECT_FALSE(IsShipped("journal_1"));
+  EXPECT_FALSE(IsShipped("journal_2"));
+
+  // The tier keeps working on new segments.
+  EXPECT_SUCCESS(PutBlob(*local_tier, "journal_4", "fourth"));
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  EXPECT_TRUE(IsShipped("journal_4"));
+}
+
+TEST_F(JournalLocalTierTest, CorruptedRecordsAreDiscardedOnInit) {
+  {
+    auto local_tier = CreateLocalTier();
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_1", "first"));
+    EXPECT_SUCCESS(PutBlob(*local_tier, "journal_2", "second"));
+  }
+
+  // Simulates a torn write of the last record.
+  auto segment_path = absl::StrCat(kTierPath, "/segment_0");
+  std::fstream segment_file(segment_path, std::ios::in | std::ios::out |
+                                              std::ios::binary);
+  std::stringstream segment_stream;
+  segment_stream << segment_file.rdbuf();
+  auto offset = segment_stream.str().find("second");
+  ASSERT_NE(offset, string::npos);
+  segment_file.seekp(offset);
+  segment_file.write("SECOND", 6);
+  segment_file.close();
+
+  auto local_tier = CreateLocalTier();
+  string data;
+  EXPECT_SUCCESS(GetBlob(*local_tier, "journal_1", data));
+  EXPECT_EQ(data, "first");
+  EXPECT_THAT(GetBlob(*local_tier, "journal_2", data),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_BLOB_STORAGE_PROVIDER_BLOB_PATH_NOT_FOUND)));
+  EXPECT_EQ(ListBlobs(*local_tier, "journal_"), vector<string>{"journal_1"});
+}
+
+TEST_F(JournalLocalTierTest, FullRingIsRetriedUntilShipped) {
+  auto local_tier = CreateLocalTier(2 /* segment_count */);
+  // Two blobs fit in every segment.
+  string data(kSegmentByteSize / 3, 'a');
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_SUCCESS(PutBlob(*local_tier, absl::StrCat("journal_", i), data));
+  }
+  EXPECT_THAT(PutBlob(*local_tier, "journal_4", data),
+              ResultIs(RetryExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_LOCAL_TIER_FULL)));
+
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  EXPECT_SUCCESS(PutBlob(*local_tier, "journal_4", data));
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  EXPECT_TRUE(IsShipped("journal_4"));
+}
+
+TEST_F(JournalLocalTierTest, SegmentsAreAllocatedOnInit) {
+  CreateLocalTier();
+  for (int i = 0; i < 3; ++i) {
+    struct stat segment_stat;
+    ASSERT_EQ(stat(absl::StrCat(kTierPath, "/segment_", i).c_str(),
+                   &segment_stat),
+              0);
+    EXPECT_EQ(segment_stat.st_size, kSegmentByteSize);
+    // The blocks are allocated rather than the file being sparse.
+    EXPECT_GE(segment_stat.st_blocks * 512, kSegmentByteSize);
+  }
+}
+
+TEST_F(JournalLocalTierTest, ConcurrentBlobsAreAllShipped) {
+  auto local_tier = CreateLocalTier();
+  vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&, i]() {
+      EXPECT_SUCCESS(
+          PutBlob(*local_tier, absl::StrCat("journal_", i), "data"));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(ListBlobs(*local_tier, "journal_").size(), 8);
+  EXPECT_SUCCESS(local_tier->ShipPendingBlobs());
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(IsShipped(absl::StrCat("journal_", i)));
+  }
+}
+
+TEST_F(JournalLocalTierTest, BlobsLargerThanASegmentAreRejected) {
+  auto local_tier = CreateLocalTier();
+  EXPECT_THAT(PutBlob(*local_tier, "journal_1", string(kSegmentByteSize, 'a')),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_LOCAL_TIER_BLOB_TOO_LARGE)));
+}
+
+TEST_F(JournalLocalTierTest, SegmentsOfAnotherSizeAreRejected) {
+  CreateLocalTier();
+  MockJournalLocalTier local_tier(bucket_name_, kBlobNamePrefix, kTierPath,
+                                  2 * kSegmentByteSize, 3,
+                                  remote_blob_storage_client_);
+  EXPECT_THAT(local_tier.Init(),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_LOCAL_TIER_INVALID_SEGMENT)));
+}
+}  // namespace google::scp::core::test
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <string>
@@ -497,6 +499,235 @@ TEST(JournalOutputStreamTests, WriteEmptyJournalBlob) {
       mock_journal_output_stream.WriteJournalBlob(bytes_buffer, 1, callback));
 }
 
+TEST(JournalOutputStreamTests, SerializeLogWithLogBodyInPlace) {
+  auto bucket_name = make_shared<string>("bucket_name");
+  auto partition_name = make_shared<string>("partition_name");
+  MockAsyncExecutor async_executor_mock;
+  shared_ptr<AsyncExecutorInterface> async_executor =
+      make_shared<MockAsyncExecutor>(move(async_executor_mock));
+
+  MockBlobStorageClient mock_storage_client;
+  shared_ptr<BlobStorageClientInterface> storage_client =
+      make_shared<MockBlobStorageClient>(move(mock_storage_client));
+
+  MockJournalOutputStream mock_journal_output_stream(
+      bucket_name, partition_name, async_executor, storage_client);
+
+  AsyncContext<JournalStreamAppendLogRequest, JournalStreamAppendLogResponse>
+      journal_stream_append_log_context;
+  journal_stream_append_log_context.request =
+      make_shared<JournalStreamAppendLogRequest>();
+  journal_stream_append_log_context.request->journal_log =
+      make_shared<JournalLog>();
+  journal_stream_append_log_context.request->journal_log->set_type(1234);
+  journal_stream_append_log_context.request->log_body =
+      make_shared<BytesBuffer>(string(200, 'a'));
+
+  JournalLog journal_log;
+  journal_log.set_type(1234);
+  journal_log.set_log_body(string(200, 'a'));
+  auto byte_size = mock_journal_output_stream.GetSerializedLogByteSize(
+      journal_stream_append_log_context);
+  EXPECT_EQ(byte_size, journal_log.ByteSizeLong() + sizeof(uint64_t) +
+                           kLogHeaderByteLength);
+
+  // The log is the same whether the log body is copied or in place.
+  BytesBuffer bytes_buffer(byte_size);
+  size_t bytes_serialized = 0;
+  EXPECT_SUCCESS(mock_journal_output_stream.SerializeLog(
+      journal_stream_append_log_context, bytes_buffer, bytes_serialized));
+  EXPECT_EQ(bytes_serialized, byte_size);
+  bytes_buffer.length = bytes_serialized;
+
+  vector<shared_ptr<BytesBuffer>> buffer_segments;
+  EXPECT_SUCCESS(mock_journal_output_stream.SerializeLogSegments(
+      journal_stream_append_log_context, buffer_segments, bytes_serialized));
+  EXPECT_EQ(bytes_serialized, byte_size);
+  ASSERT_EQ(buffer_segments.size(), 2);
+  EXPECT_EQ(buffer_segments[0]->length, byte_size - 200);
+  EXPECT_EQ(buffer_segments[1],
+            journal_stream_append_log_context.request->log_body);
+
+  // Only the timestamps of the headers differ.
+  size_t timestamp_offset = 2 * sizeof(uint64_t);
+  size_t log_offset = timestamp_offset + sizeof(Timestamp);
+  EXPECT_TRUE(
+      std::equal(bytes_buffer.bytes->begin(), bytes_buffer.bytes->begin() +
+                                                  timestamp_offset,
+                 buffer_segments[0]->bytes->begin()));
+  EXPECT_TRUE(std::equal(
+      bytes_buffer.bytes->begin() + log_offset,
+      bytes_buffer.bytes->begin() + buffer_segments[0]->length,
+      buffer_segments[0]->bytes->begin() + log_offset));
+
+  JournalLog deserialized_journal_log;
+  size_t bytes_deserialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::DeserializeJournalLog(
+      bytes_buffer, kLogHeaderByteLength, deserialized_journal_log,
+      bytes_deserialized));
+  EXPECT_EQ(deserialized_journal_log.type(), 1234);
+  EXPECT_EQ(deserialized_journal_log.log_body(), string(200, 'a'));
+
+  // The buffer does not have room for the log body.
+  BytesBuffer small_bytes_buffer(byte_size - 1);
+  EXPECT_THAT(
+      mock_journal_output_stream.SerializeLog(
+          journal_stream_append_log_context, small_bytes_buffer,
+          bytes_serialized),
+      ResultIs(FailureExecutionResult(
+          errors::SC_SERIALIZATION_BUFFER_NOT_WRITABLE)));
+}
+
+TEST(JournalOutputStreamTests, SerializeChecksummedLog) {
+  auto bucket_name = make_shared<string>("bucket_name");
+  auto partition_name = make_shared<string>("partition_name");
+  MockAsyncExecutor async_executor_mock;
+  shared_ptr<AsyncExecutorInterface> async_executor =
+      make_shared<MockAsyncExecutor>(move(async_executor_mock));
+
+  MockBlobStorageClient mock_storage_client;
+  shared_ptr<BlobStorageClientInterface> storage_client =
+      make_shared<MockBlobStorageClient>(move(mock_storage_client));
+
+  MockJournalOutputStream mock_journal_output_stream(
+      bucket_name, partition_name, async_executor, storage_client,
+      /*should_checksum_logs=*/true);
+
+  AsyncContext<JournalStreamAppendLogRequest, JournalStreamAppendLogResponse>
+      journal_stream_append_log_context;
+  journal_stream_append_log_context.request =
+      make_shared<JournalStreamAppendLogRequest>();
+  journal_stream_append_log_context.request->journal_log =
+      make_shared<JournalLog>();
+  journal_stream_append_log_context.request->journal_log->set_type(1234);
+  journal_stream_append_log_context.request->log_body =
+      make_shared<BytesBuffer>(string(200, 'a'));
+
+  JournalLog journal_log;
+  journal_log.set_type(1234);
+  journal_log.set_log_body(string(200, 'a'));
+  auto byte_size = mock_journal_output_stream.GetSerializedLogByteSize(
+      journal_stream_append_log_context);
+  EXPECT_EQ(byte_size, journal_log.ByteSizeLong() + sizeof(uint64_t) +
+                           kChecksummedLogHeaderByteLength);
+
+  BytesBuffer bytes_buffer(byte_size);
+  size_t bytes_serialized = 0;
+  EXPECT_SUCCESS(mock_journal_output_stream.SerializeLog(
+      journal_stream_append_log_context, bytes_buffer, bytes_serialized));
+  EXPECT_EQ(bytes_serialized, byte_size);
+  bytes_buffer.length = bytes_serialized;
+
+  // The segments read the same once written one after the other.
+  vector<shared_ptr<BytesBuffer>> buffer_segments;
+  EXPECT_SUCCESS(mock_journal_output_stream.SerializeLogSegments(
+      journal_stream_append_log_context, buffer_segments, bytes_serialized));
+  EXPECT_EQ(bytes_serialized, byte_size);
+  BytesBuffer segments_bytes_buffer(byte_size);
+  for (const auto& buffer_segment : buffer_segments) {
+    memcpy(segments_bytes_buffer.bytes->data() + segments_bytes_buffer.length,
+           buffer_segment->bytes->data(), buffer_segment->length);
+    segments_bytes_buffer.length += buffer_segment->length;
+  }
+
+  for (const auto* buffer : {&bytes_buffer, &segments_bytes_buffer}) {
+    Timestamp timestamp;
+    JournalLogStatus log_status;
+    Uuid component_id;
+    Uuid log_id;
+    size_t bytes_deserialized = 0;
+    EXPECT_SUCCESS(JournalSerialization::DeserializeLogHeader(
+        *buffer, 0, timestamp, log_status, component_id, log_id,
+        bytes_deserialized));
+    EXPECT_EQ(bytes_deserialized, kChecksummedLogHeaderByteLength);
+
+    JournalLog deserialized_journal_log;
+    EXPECT_SUCCESS(JournalSerialization::DeserializeJournalLog(
+        *buffer, kChecksummedLogHeaderByteLength, deserialized_journal_log,
+        bytes_deserialized));
+    EXPECT_EQ(deserialized_journal_log.type(), 1234);
+    EXPECT_EQ(deserialized_journal_log.log_body(), string(200, 'a'));
+  }
+}
+
+TEST(JournalOutputStreamTests, WriteBatchWithLogBodiesInPlace) {
+  auto bucket_name = make_shared<string>("bucket_name");
+  auto partition_name = make_shared<string>("partition_name");
+  MockAsyncExecutor async_executor_mock;
+  async_executor_mock.schedule_mock = [](auto work) {
+    work();
+    return SuccessExecutionResult();
+  };
+  shared_ptr<AsyncExecutorInterface> async_executor =
+      make_shared<MockAsyncExecutor>(move(async_executor_mock));
+
+  shared_ptr<PutBlobRequest> put_blob_request;
+  MockBlobStorageClient mock_storage_client;
+  mock_storage_client.put_blob_mock =
+      [&](AsyncContext<PutBlobRequest, PutBlobResponse>& put_blob_context) {
+        put_blob_request = put_blob_context.request;
+        return SuccessExecutionResult();
+      };
+  shared_ptr<BlobStorageClientInterface> storage_client =
+      make_shared<MockBlobStorageClient>(move(mock_storage_client));
+
+  MockJournalOutputStream mock_journal_output_stream(
+      bucket_name, partition_name, async_executor, storage_client);
+  mock_journal_output_stream.write_journal_blob_mock = [](auto&, auto, auto) {
+    ADD_FAILURE();
+    return SuccessExecutionResult();
+  };
+  EXPECT_SUCCESS(mock_journal_output_stream.FlushLogs());
+
+  // The second log has its body in the journal log.
+  vector<string> log_bodies = {"first", "second", "third"};
+  vector<shared_ptr<BytesBuffer>> log_bodies_in_place;
+  for (size_t i = 0; i < log_bodies.size(); ++i) {
+    AsyncContext<JournalStreamAppendLogRequest, JournalStreamAppendLogResponse>
+        journal_stream_append_log_context;
+    journal_stream_append_log_context.request =
+        make_shared<JournalStreamAppendLogRequest>();
+    journal_stream_append_log_context.request->journal_log =
+        make_shared<JournalLog>();
+    if (i == 1) {
+      journal_stream_append_log_context.request->journal_log->set_log_body(
+          log_bodies[i]);
+    } else {
+      journal_stream_append_log_context.request->log_body =
+          make_shared<BytesBuffer>(log_bodies[i]);
+      log_bodies_in_place.push_back(
+          journal_stream_append_log_context.request->log_body);
+    }
+    EXPECT_SUCCESS(mock_journal_output_stream.AppendLog(
+        journal_stream_append_log_context));
+  }
+  EXPECT_SUCCESS(mock_journal_output_stream.FlushLogs());
+
+  ASSERT_NE(put_blob_request, nullptr);
+  EXPECT_EQ(put_blob_request->buffer, nullptr);
+  auto& buffer_segments = put_blob_request->buffer_segments;
+  ASSERT_EQ(buffer_segments.size(), 5);
+  EXPECT_EQ(buffer_segments[1], log_bodies_in_place[0]);
+  EXPECT_EQ(buffer_segments[4], log_bodies_in_place[1]);
+
+  string blob;
+  for (const auto& buffer_segment : buffer_segments) {
+    blob.append(buffer_segment->bytes->data(), buffer_segment->length);
+  }
+  BytesBuffer blob_buffer(blob);
+  size_t offset = 0;
+  for (const auto& log_body : log_bodies) {
+    JournalLog journal_log;
+    size_t bytes_deserialized = 0;
+    EXPECT_SUCCESS(JournalSerialization::DeserializeJournalLog(
+        blob_buffer, offset + kLogHeaderByteLength, journal_log,
+        bytes_deserialized));
+    EXPECT_EQ(journal_log.log_body(), log_body);
+    offset += kLogHeaderByteLength + bytes_deserialized;
+  }
+  EXPECT_EQ(offset, blob.size());
+}
+
 TEST(JournalOutputStreamTests, OnWriteJournalBlobCallback) {
   auto bucket_name = make_shared<string>("bucket_name");
   auto partition_name = make_shared<string>("partition_name");
@@ -0,0 +1,125 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/uuid/src/uuid.h"
+#include "core/journal_service/src/journal_serialization.h"
+#include "core/journal_service/src/proto/journal_service.pb.h"
+
+namespace google::scp::core::test {
+
+using ::google::scp::core::common::Uuid;
+using ::google::scp::core::journal_service::JournalLog;
+using ::google::scp::core::journal_service::JournalSerialization;
+
+static constexpr int kMinLogBodySize = 64;
+static constexpr int kMaxLogBodySize = 64 << 10;
+
+static JournalLog CreateJournalLog(size_t log_body_size) {
+  JournalLog journal_log;
+  journal_log.set_type(1);
+  journal_log.set_log_body(std::string(log_body_size, 'a'));
+  return journal_log;
+}
+
+/**
+ * @brief Serializes the header and the body of a journal entry the way the
+ * journal output stream does. The argument is the size of the log body.
+ */
+static void BM_SerializeJournalEntry(benchmark::State& state) {
+  auto journal_log = CreateJournalLog(state.range(0));
+  size_t log_size = 0;
+  JournalSerialization::CalculateSerializationByteSize(journal_log, log_size);
+  auto component_id = Uuid::GenerateUuid();
+  auto log_id = Uuid::GenerateUuid();
+
+  for (auto _ : state) {
+    BytesBuffer bytes_buffer(kLogHeaderByteLength + log_size);
+    size_t header_bytes_serialized = 0;
+    size_t log_bytes_serialized = 0;
+    if (!JournalSerialization::SerializeLogHeader(
+             bytes_buffer, 0, /*timestamp=*/1234, JournalLogStatus::Log,
+             component_id, log_id, header_bytes_serialized)
+             .Successful() ||
+        !JournalSerialization::SerializeJournalLog(
+             bytes_buffer, header_bytes_serialized, journal_log,
+             log_bytes_serialized)
+             .Successful()) {
+      state.SkipWithError("Cannot serialize the journal entry.");
+      break;
+    }
+    benchmark::DoNotOptimize(bytes_buffer.bytes->data());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          (kLogHeaderByteLength + log_size));
+}
+
+BENCHMARK(BM_SerializeJournalEntry)
+    ->RangeMultiplier(8)
+    ->Range(kMinLogBodySize, kMaxLogBodySize);
+
+/// Deserializes the header and the body of a journal entry. The argument is
+/// the size of the log body.
+static void BM_DeserializeJournalEntry(benchmark::State& state) {
+  auto journal_log = CreateJournalLog(state.range(0));
+  size_t log_size = 0;
+  JournalSerialization::CalculateSerializationByteSize(journal_log, log_size);
+  BytesBuffer bytes_buffer(kLogHeaderByteLength + log_size);
+  size_t header_bytes_serialized = 0;
+  size_t log_bytes_serialized = 0;
+  JournalSerialization::SerializeLogHeader(
+      bytes_buffer, 0, /*timestamp=*/1234, JournalLogStatus::Log,
+      Uuid::GenerateUuid(), Uuid::GenerateUuid(), header_bytes_serialized);
+  JournalSerialization::SerializeJournalLog(bytes_buffer,
+                                            header_bytes_serialized,
+                                            journal_log, log_bytes_serialized);
+  bytes_buffer.length = header_bytes_serialized + log_bytes_serialized;
+
+  for (auto _ : state) {
+    Timestamp timestamp;
+    JournalLogStatus log_status;
+    Uuid component_id;
+    Uuid log_id;
+    JournalLog deserialized_journal_log;
+    size_t header_bytes_deserialized = 0;
+    size_t log_bytes_deserialized = 0;
+    if (!JournalSerialization::DeserializeLogHeader(
+             bytes_buffer, 0, timestamp, log_status, component_id, log_id,
+             header_bytes_deserialized)
+             .Successful() ||
+        !JournalSerialization::DeserializeJournalLog(
+             bytes_buffer, header_bytes_deserialized, deserialized_journal_log,
+             log_bytes_deserialized)
+             .Successful()) {
+      state.SkipWithError("Cannot deserialize the journal entry.");
+      break;
+    }
+    benchmark::DoNotOptimize(deserialized_journal_log);
+  }
+  state.SetBytesProcessed(state.iterations() * bytes_buffer.length);
+}
+
+BENCHMARK(BM_DeserializeJournalEntry)
+    ->RangeMultiplier(8)
+    ->Range(kMinLogBodySize, kMaxLogBodySize);
+
+}  // namespace google::scp::core::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -15,7 +15,9 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "core/common/uuid/src/uuid.h"
@@ -23,13 +25,16 @@
 #include "core/journal_service/src/journal_serialization.h"
 #include "core/journal_service/src/proto/journal_service.pb.h"
 #include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
 
 using google::scp::core::common::Uuid;
 using google::scp::core::journal_service::CheckpointMetadata;
 using google::scp::core::journal_service::JournalLog;
 using google::scp::core::journal_service::JournalSerialization;
 using google::scp::core::journal_service::LastCheckpointMetadata;
+using google::scp::core::test::ResultIs;
 using std::make_shared;
+using std::string;
 using std::vector;
 
 namespace google::scp::core::test {
@@ -305,4 +310,167 @@ TEST(JournalServiceSerializationTests, JournalLogSerialization) {
   EXPECT_EQ(bytes_deserialized, bytes_serialized);
 }
 
+TEST(JournalServiceSerializationTests, JournalLogWithoutBodySerialization) {
+  // Sizes around the one byte varint boundary of the log body length.
+  for (size_t log_body_length : {0, 1, 127, 128, 300}) {
+    string log_body(log_body_length, 'a');
+    JournalLog journal_log;
+    journal_log.set_type(1234);
+    journal_log.set_log_body(log_body);
+    BytesBuffer expected_bytes_buffer(sizeof(uint64_t) +
+                                      journal_log.ByteSizeLong());
+    size_t expected_bytes_serialized = 0;
+    EXPECT_SUCCESS(JournalSerialization::SerializeJournalLog(
+        expected_bytes_buffer, 0, journal_log, expected_bytes_serialized));
+
+    // Followed by the log body, the serialization is the same.
+    journal_log.clear_log_body();
+    EXPECT_EQ(JournalSerialization::CalculateLogBodyFieldByteSize(
+                  log_body_length) +
+                  journal_log.ByteSizeLong() + sizeof(uint64_t),
+              expected_bytes_serialized);
+    BytesBuffer bytes_buffer(expected_bytes_serialized);
+    size_t bytes_serialized = 0;
+    EXPECT_SUCCESS(JournalSerialization::SerializeJournalLogWithoutBody(
+        bytes_buffer, 0, journal_log, log_body_length, bytes_serialized));
+    EXPECT_EQ(bytes_serialized + log_body_length, expected_bytes_serialized);
+    memcpy(bytes_buffer.bytes->data() + bytes_serialized, log_body.data(),
+           log_body_length);
+    EXPECT_EQ(*bytes_buffer.bytes, *expected_bytes_buffer.bytes);
+
+    // The buffer does not have room for the journal log.
+    BytesBuffer small_bytes_buffer(bytes_serialized - 1);
+    EXPECT_THAT(JournalSerialization::SerializeJournalLogWithoutBody(
+                    small_bytes_buffer, 0, journal_log, log_body_length,
+                    bytes_serialized),
+                ResultIs(FailureExecutionResult(
+                    errors::SC_SERIALIZATION_BUFFER_NOT_WRITABLE)));
+  }
+
+  // The log body cannot be both in place and in the journal log.
+  JournalLog journal_log;
+  journal_log.set_log_body("body");
+  BytesBuffer bytes_buffer(100);
+  size_t bytes_serialized = 0;
+  EXPECT_THAT(JournalSerialization::SerializeJournalLogWithoutBody(
+                  bytes_buffer, 0, journal_log, 4, bytes_serialized),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_INVALID_LOG_BODY)));
+}
+
+TEST(JournalServiceSerializationTests, ChecksummedLogSerialization) {
+  Uuid component_uuid;
+  component_uuid.high = 0x09999999;
+  component_uuid.low = 0x08888888;
+  Uuid log_uuid;
+  log_uuid.high = 0x01111111;
+  log_uuid.low = 0x02222222;
+  Timestamp current_timestamp = 1234567890;
+  JournalLog journal_log;
+  journal_log.set_type(1234);
+  journal_log.set_log_body("log body");
+
+  BytesBuffer bytes_buffer(kChecksummedLogHeaderByteLength + sizeof(uint64_t) +
+                           journal_log.ByteSizeLong());
+  size_t header_bytes_serialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::SerializeChecksummedLogHeader(
+      bytes_buffer, 0, current_timestamp, JournalLogStatus::Log,
+      component_uuid, log_uuid, header_bytes_serialized));
+  EXPECT_EQ(header_bytes_serialized, kChecksummedLogHeaderByteLength);
+  size_t log_bytes_serialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::SerializeJournalLog(
+      bytes_buffer, header_bytes_serialized, journal_log,
+      log_bytes_serialized));
+  auto log_end_offset = header_bytes_serialized + log_bytes_serialized;
+  EXPECT_SUCCESS(JournalSerialization::SealChecksummedLog(bytes_buffer, 0,
+                                                          log_end_offset));
+  bytes_buffer.length = log_end_offset;
+
+  Timestamp deserialized_timestamp;
+  JournalLogStatus deserialized_log_status;
+  Uuid deserialized_component_uuid;
+  Uuid deserialized_log_uuid;
+  size_t bytes_deserialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::DeserializeLogHeader(
+      bytes_buffer, 0, deserialized_timestamp, deserialized_log_status,
+      deserialized_component_uuid, deserialized_log_uuid, bytes_deserialized));
+  EXPECT_EQ(bytes_deserialized, header_bytes_serialized);
+  EXPECT_EQ(deserialized_timestamp, current_timestamp);
+  EXPECT_EQ(deserialized_log_status, JournalLogStatus::Log);
+  EXPECT_EQ(deserialized_component_uuid, component_uuid);
+  EXPECT_EQ(deserialized_log_uuid, log_uuid);
+
+  JournalLog deserialized_journal_log;
+  size_t log_bytes_deserialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::DeserializeJournalLog(
+      bytes_buffer, bytes_deserialized, deserialized_journal_log,
+      log_bytes_deserialized));
+  EXPECT_EQ(deserialized_journal_log.log_body(), "log body");
+
+  // Any byte flipped past the frame fails the checksum.
+  for (auto i = kChecksummedLogFrameByteLength; i < log_end_offset; ++i) {
+    auto corrupted_bytes_buffer = bytes_buffer;
+    corrupted_bytes_buffer.bytes =
+        make_shared<vector<Byte>>(*bytes_buffer.bytes);
+    (*corrupted_bytes_buffer.bytes)[i] ^= 0x01;
+    EXPECT_THAT(JournalSerialization::DeserializeLogHeader(
+                    corrupted_bytes_buffer, 0, deserialized_timestamp,
+                    deserialized_log_status, deserialized_component_uuid,
+                    deserialized_log_uuid, bytes_deserialized),
+                ResultIs(FailureExecutionResult(
+                    errors::SC_JOURNAL_SERVICE_LOG_CHECKSUM_MISMATCH)));
+  }
+
+  // A truncated log is not readable.
+  auto truncated_bytes_buffer = bytes_buffer;
+  truncated_bytes_buffer.length = log_end_offset - 1;
+  EXPECT_THAT(JournalSerialization::DeserializeLogHeader(
+                  truncated_bytes_buffer, 0, deserialized_timestamp,
+                  deserialized_log_status, deserialized_component_uuid,
+                  deserialized_log_uuid, bytes_deserialized),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_SERIALIZATION_BUFFER_NOT_READABLE)));
+}
+
+TEST(JournalServiceSerializationTests, ChecksummedLogWithBodyInPlace) {
+  JournalLog journal_log;
+  journal_log.set_type(1234);
+  string log_body(300, 'a');
+  BytesBuffer log_body_buffer(log_body.length());
+  memcpy(log_body_buffer.bytes->data(), log_body.data(), log_body.length());
+  log_body_buffer.length = log_body.length();
+
+  BytesBuffer bytes_buffer(1000);
+  size_t bytes_serialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::SerializeChecksummedLogHeader(
+      bytes_buffer, 0, 1234567890, JournalLogStatus::Log, Uuid::GenerateUuid(),
+      Uuid::GenerateUuid(), bytes_serialized));
+  size_t log_bytes_serialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::SerializeJournalLogWithoutBody(
+      bytes_buffer, bytes_serialized, journal_log, log_body.length(),
+      log_bytes_serialized));
+  bytes_serialized += log_bytes_serialized;
+  EXPECT_SUCCESS(JournalSerialization::SealChecksummedLog(
+      bytes_buffer, 0, bytes_serialized, &log_body_buffer));
+
+  // Once the log body follows, the log reads the same as a contiguous one.
+  memcpy(bytes_buffer.bytes->data() + bytes_serialized, log_body.data(),
+         log_body.length());
+  bytes_buffer.length = bytes_serialized + log_body.length();
+  Timestamp timestamp;
+  JournalLogStatus log_status;
+  Uuid component_id;
+  Uuid log_id;
+  size_t bytes_deserialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::DeserializeLogHeader(
+      bytes_buffer, 0, timestamp, log_status, component_id, log_id,
+      bytes_deserialized));
+  JournalLog deserialized_journal_log;
+  size_t log_bytes_deserialized = 0;
+  EXPECT_SUCCESS(JournalSerialization::DeserializeJournalLog(
+      bytes_buffer, bytes_deserialized, deserialized_journal_log,
+      log_bytes_deserialized));
+  EXPECT_EQ(deserialized_journal_log.log_body(), log_body);
+}
+
 }  // namespace google::scp::core::test
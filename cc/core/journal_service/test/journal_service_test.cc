@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -30,6 +31,7 @@
 #include "core/common/concurrent_map/src/error_codes.h"
 #include "core/common/uuid/src/uuid.h"
 #include "core/config_provider/mock/mock_config_provider.h"
+#include "core/interface/configuration_keys.h"
 #include "core/journal_service/mock/mock_journal_input_stream.h"
 #include "core/journal_service/mock/mock_journal_output_stream.h"
 #include "core/journal_service/mock/mock_journal_service_with_overrides.h"
@@ -52,6 +54,8 @@ using google::scp::core::common::Uuid;
 using google::scp::core::config_provider::mock::MockConfigProvider;
 using google::scp::core::journal_service::JournalInputStreamInterface;
 using google::scp::core::journal_service::JournalLog;
+using google::scp::core::journal_service::JournalLogGroup;
+using google::scp::core::journal_service::JournalLogType;
 using google::scp::core::journal_service::JournalOutputStreamInterface;
 using google::scp::core::journal_service::JournalStreamAppendLogRequest;
 using google::scp::core::journal_service::JournalStreamAppendLogResponse;
@@ -146,6 +150,50 @@ TEST_F(JournalServiceTests, Stop) {
                   errors::SC_JOURNAL_SERVICE_ALREADY_STOPPED)));
 }
 
+TEST_F(JournalServiceTests, AttachLocalTier) {
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  mock_config_provider->SetInt(kPBSJournalServiceLocalTierSegmentByteSize,
+                               4096);
+  mock_config_provider->SetInt(kPBSJournalServiceLocalTierSegmentCount, 2);
+  auto local_tier_path = make_shared<string>("attach_local_tier_segments");
+  std::filesystem::remove_all(*local_tier_path);
+  JournalService journal_service(bucket_name_, partition_name_, async_executor_,
+                                 mock_blob_storage_provider_,
+                                 mock_metric_client_, mock_config_provider);
+  EXPECT_THAT(journal_service.AttachLocalTier(local_tier_path),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_NOT_INITIALIZED)));
+  EXPECT_SUCCESS(journal_service.Init());
+
+  // Nothing is attached without a path.
+  EXPECT_SUCCESS(journal_service.AttachLocalTier(make_shared<string>()));
+  EXPECT_FALSE(std::filesystem::exists(*local_tier_path));
+
+  EXPECT_SUCCESS(journal_service.AttachLocalTier(local_tier_path));
+  EXPECT_TRUE(std::filesystem::exists(*local_tier_path + "/" +
+                                      *partition_name_));
+  EXPECT_THAT(journal_service.AttachLocalTier(local_tier_path),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_LOCAL_TIER_ALREADY_ATTACHED)));
+
+  EXPECT_SUCCESS(journal_service.Run());
+  EXPECT_SUCCESS(journal_service.Stop());
+  std::filesystem::remove_all(*local_tier_path);
+}
+
+TEST_F(JournalServiceTests, CannotAttachLocalTierWhenRunning) {
+  JournalService journal_service(bucket_name_, partition_name_, async_executor_,
+                                 mock_blob_storage_provider_,
+                                 mock_metric_client_, mock_config_provider_);
+  EXPECT_SUCCESS(journal_service.Init());
+  EXPECT_SUCCESS(journal_service.Run());
+  EXPECT_THAT(journal_service.AttachLocalTier(
+                  make_shared<string>("attach_local_tier_segments")),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_ALREADY_RUNNING)));
+  EXPECT_SUCCESS(journal_service.Stop());
+}
+
 TEST_F(JournalServiceTests, Recover) {
   MockJournalServiceWithOverrides journal_service(
       bucket_name_, partition_name_, async_executor_,
@@ -458,6 +506,182 @@ TEST_F(JournalServiceTests,
   EXPECT_EQ(replayed_logs->size(), 1);
 }
 
+TEST_F(JournalServiceTests, LogGroupOfRecords) {
+  MockJournalServiceWithOverrides journal_service(
+      bucket_name_, partition_name_, async_executor_,
+      mock_blob_storage_provider_, mock_metric_client_, mock_config_provider_);
+  shared_ptr<BlobStorageClientInterface> blob_storage_client;
+  mock_blob_storage_provider_->CreateBlobStorageClient(blob_storage_client);
+  auto mock_output_stream = make_shared<MockJournalOutputStream>(
+      bucket_name_, partition_name_, async_executor_, blob_storage_client);
+
+  AsyncContext<JournalLogRequest, JournalLogResponse> journal_log_context;
+  journal_log_context.request = make_shared<JournalLogRequest>();
+  journal_log_context.request->component_id = Uuid::GenerateUuid();
+  JournalLogRecord first_record;
+  first_record.component_id = Uuid::GenerateUuid();
+  first_record.data = make_shared<BytesBuffer>(string("first"));
+  JournalLogRecord second_record;
+  second_record.component_id = Uuid::GenerateUuid();
+  second_record.data = make_shared<BytesBuffer>(string("second"));
+  journal_log_context.request->records = {first_record, second_record};
+
+  size_t append_count = 0;
+  mock_output_stream->append_log_mock =
+      [&](AsyncContext<JournalStreamAppendLogRequest,
+                       JournalStreamAppendLogResponse>& append_log_context) {
+        append_count++;
+        EXPECT_EQ(append_log_context.request->component_id,
+                  journal_log_context.request->component_id);
+        EXPECT_EQ(append_log_context.request->journal_log->type(),
+                  JournalLogType::JOURNAL_LOG_TYPE_GROUP);
+        JournalLogGroup journal_log_group;
+        EXPECT_TRUE(journal_log_group.ParseFromString(
+            append_log_context.request->journal_log->log_body()));
+        EXPECT_EQ(journal_log_group.records_size(), 2);
+        EXPECT_EQ(journal_log_group.records(0).component_id().low(),
+                  first_record.component_id.low);
+        EXPECT_EQ(journal_log_group.records(0).log_body(), "first");
+        EXPECT_EQ(journal_log_group.records(1).component_id().high(),
+                  second_record.component_id.high);
+        EXPECT_EQ(journal_log_group.records(1).log_body(), "second");
+        return SuccessExecutionResult();
+      };
+  shared_ptr<JournalOutputStreamInterface> output_stream =
+      static_pointer_cast<JournalOutputStreamInterface>(mock_output_stream);
+  journal_service.SetOutputStream(output_stream);
+
+  EXPECT_SUCCESS(journal_service.Log(journal_log_context));
+  EXPECT_EQ(append_count, 1);
+
+  // A record without data fails the log.
+  journal_log_context.request->records.push_back(JournalLogRecord());
+  EXPECT_THAT(journal_service.Log(journal_log_context),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_JOURNAL_SERVICE_INVALID_LOG_GROUP)));
+  EXPECT_EQ(append_count, 1);
+}
+
+TEST_F(JournalServiceTests, LogReferencesDataInPlace) {
+  MockJournalServiceWithOverrides journal_service(
+      bucket_name_, partition_name_, async_executor_,
+      mock_blob_storage_provider_, mock_metric_client_, mock_config_provider_);
+  shared_ptr<BlobStorageClientInterface> blob_storage_client;
+  mock_blob_storage_provider_->CreateBlobStorageClient(blob_storage_client);
+  auto mock_output_stream = make_shared<MockJournalOutputStream>(
+      bucket_name_, partition_name_, async_executor_, blob_storage_client);
+
+  AsyncContext<JournalLogRequest, JournalLogResponse> journal_log_context;
+  journal_log_context.request = make_shared<JournalLogRequest>();
+  journal_log_context.request->component_id = Uuid::GenerateUuid();
+  journal_log_context.request->data = make_shared<BytesBuffer>(string("data"));
+
+  size_t append_count = 0;
+  mock_output_stream->append_log_mock =
+      [&](AsyncContext<JournalStreamAppendLogRequest,
+                       JournalStreamAppendLogResponse>& append_log_context) {
+        append_count++;
+        EXPECT_EQ(append_log_context.request->log_body,
+                  journal_log_context.request->data);
+        EXPECT_TRUE(
+            append_log_context.request->journal_log->log_body().empty());
+        return SuccessExecutionResult();
+      };
+  shared_ptr<JournalOutputStreamInterface> output_stream =
+      static_pointer_cast<JournalOutputStreamInterface>(mock_output_stream);
+  journal_service.SetOutputStream(output_stream);
+
+  EXPECT_SUCCESS(journal_service.Log(journal_log_context));
+  EXPECT_EQ(append_count, 1);
+}
+
+TEST_F(JournalServiceTests, OnJournalStreamReadLogCallbackReplaysLogGroup) {
+  MockJournalServiceWithOverrides journal_service(
+      bucket_name_, partition_name_, async_executor_,
+      mock_blob_storage_provider_, mock_metric_client_, mock_config_provider_);
+  shared_ptr<BlobStorageClientInterface> blob_storage_client;
+  mock_blob_storage_provider_->CreateBlobStorageClient(blob_storage_client);
+
+  atomic<bool> called = false;
+  AsyncContext<JournalRecoverRequest, JournalRecoverResponse>
+      journal_recover_context;
+  journal_recover_context.callback =
+      [&](AsyncContext<JournalRecoverRequest, JournalRecoverResponse>&
+              journal_recover_context) {
+        EXPECT_SUCCESS(journal_recover_context.result);
+      };
+
+  auto first_component_id = Uuid::GenerateUuid();
+  auto second_component_id = Uuid::GenerateUuid();
+  JournalLogGroup journal_log_group;
+  for (const auto& [component_id, log_body] :
+       {make_pair(first_component_id, "first"),
+        make_pair(second_component_id, "second"),
+        make_pair(first_component_id, "third")}) {
+    auto* record = journal_log_group.add_records();
+    record->mutable_component_id()->set_high(component_id.high);
+    record->mutable_component_id()->set_low(component_id.low);
+    record->set_log_body(log_body);
+  }
+
+  AsyncContext<JournalStreamReadLogRequest, JournalStreamReadLogResponse>
+      read_log_context;
+  read_log_context.response = make_shared<JournalStreamReadLogResponse>();
+  read_log_context.response->read_logs =
+      make_shared<vector<JournalStreamReadLogObject>>();
+  JournalStreamReadLogObject log_object;
+  log_object.log_id = Uuid::GenerateUuid();
+  log_object.component_id = Uuid::GenerateUuid();
+  log_object.journal_log = make_shared<JournalLog>();
+  log_object.journal_log->set_type(JournalLogType::JOURNAL_LOG_TYPE_GROUP);
+  journal_log_group.SerializeToString(
+      log_object.journal_log->mutable_log_body());
+  read_log_context.response->read_logs->push_back(log_object);
+  read_log_context.result = SuccessExecutionResult();
+
+  // The records are replayed in order by their components, and the owner of
+  // the group only deduplicates it.
+  vector<string> replayed_log_bodies;
+  OnLogRecoveredCallback owner_callback = [&](auto, auto) {
+    EXPECT_EQ(true, false);
+    return FailureExecutionResult(123);
+  };
+  OnLogRecoveredCallback record_callback =
+      [&](const shared_ptr<BytesBuffer>& bytes_buffer, auto) {
+        replayed_log_bodies.emplace_back(bytes_buffer->bytes->begin(),
+                                         bytes_buffer->bytes->end());
+        return SuccessExecutionResult();
+      };
+  auto owner_pair = make_pair(log_object.component_id, owner_callback);
+  journal_service.GetSubscribersMap().Insert(owner_pair, owner_callback);
+  auto first_pair = make_pair(first_component_id, record_callback);
+  journal_service.GetSubscribersMap().Insert(first_pair, record_callback);
+  auto second_pair = make_pair(second_component_id, record_callback);
+  journal_service.GetSubscribersMap().Insert(second_pair, record_callback);
+
+  auto mock_input_stream = make_shared<MockJournalInputStream>(
+      bucket_name_, partition_name_, blob_storage_client,
+      std::make_shared<EnvConfigProvider>());
+  mock_input_stream->read_log_mock =
+      [&](AsyncContext<JournalStreamReadLogRequest,
+                       JournalStreamReadLogResponse>& read_log_context) {
+        called = true;
+        return SuccessExecutionResult();
+      };
+  shared_ptr<JournalInputStreamInterface> input_stream =
+      static_pointer_cast<JournalInputStreamInterface>(mock_input_stream);
+  journal_service.SetInputStream(input_stream);
+
+  auto time_event = make_shared<TimeEvent>();
+  auto replayed_logs = make_shared<unordered_set<string>>();
+  journal_service.OnJournalStreamReadLogCallback(
+      time_event, replayed_logs, journal_recover_context, read_log_context);
+
+  WaitUntil([&]() { return called.load(); });
+  EXPECT_EQ(replayed_log_bodies,
+            vector<string>({"first", "second", "third"}));
+}
+
 TEST_F(JournalServiceTests, OnJournalStreamAppendLogCallback) {
   MockJournalServiceWithOverrides journal_service(
       bucket_name_, partition_name_, async_executor_,
@@ -80,4 +80,8 @@ DEFINE_ERROR_CODE(SC_LEASE_LIVENESS_ENFORCER_CANNOT_SET_THREAD_PRIORITY,
                   "Cannot set priority of the lease enforcer thread",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_LEASE_REFRESHER_REFRESH_TIMED_OUT, SC_LEASE_MANAGER_V2,
+                  0x000F, "Lease refresh timed out",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 }  // namespace google::scp::core::errors
@@ -96,30 +96,21 @@ LeaseRefreshMode LeaseRefresher::GetLeaseRefreshMode() const noexcept {
 }
 
 /**
- * @brief Helper function to perform a Lease Transition and Notify the lease
- * event sink about the Lease Transition
+ * @brief Helper function to determine the Lease Transition to notify the lease
+ * event sink about
  *
- * @param leasable_lock_id lock ID
- * @param lease_event_sink the sink object where the notification will be sent
  * @param is_lease_owner am I the lease owner in the current round
  * @param lease_refresh_mode the mode of lease refresh
  * @param was_lease_owner was I the lease owner in previous round
- * @param current_lease_owner_info lease owner of the current round
  * @param prev_lease_refresh_mode the prev mode of lease refresh
  *
- * @return LeaseTransitionType returns the performed Lease Transition type.
+ * @return LeaseTransitionType returns the Lease Transition type.
  */
-static LeaseTransitionType PerformLeaseTransitionAndNotifyLeaseEventSink(
-    const LeasableLockId& leasable_lock_id,
-    std::shared_ptr<LeaseEventSinkInterface> lease_event_sink,
+static LeaseTransitionType GetLeaseTransition(
     bool is_lease_owner, LeaseRefreshMode lease_refresh_mode,
-    bool was_lease_owner, optional<LeaseInfo> current_lease_owner_info,
-    LeaseRefreshMode prev_lease_refresh_mode) {
+    bool was_lease_owner, LeaseRefreshMode prev_lease_refresh_mode) {
   if (!was_lease_owner && is_lease_owner) {
     // 1. Previously NOT owned, and currently owned.
-    lease_event_sink->OnLeaseTransition(leasable_lock_id,
-                                        LeaseTransitionType::kAcquired,
-                                        current_lease_owner_info);
     return LeaseTransitionType::kAcquired;
   } else if (was_lease_owner && !is_lease_owner) {
     // 2. Previously owned, and currently NOT owned.
@@ -130,14 +121,8 @@ static LeaseTransitionType PerformLeaseTransitionAndNotifyLeaseEventSink(
         (prev_lease_refresh_mode ==
          LeaseRefreshMode::RefreshWithIntentionToReleaseTheHeldLease);
     if (should_send_release_notification) {
-      lease_event_sink->OnLeaseTransition(leasable_lock_id,
-                                          LeaseTransitionType::kReleased,
-                                          current_lease_owner_info);
       return LeaseTransitionType::kReleased;
     } else {
-      lease_event_sink->OnLeaseTransition(leasable_lock_id,
-                                          LeaseTransitionType::kLost,
-                                          current_lease_owner_info);
       return LeaseTransitionType::kLost;
     }
   } else if (was_lease_owner && is_lease_owner) {
@@ -146,21 +131,12 @@ static LeaseTransitionType PerformLeaseTransitionAndNotifyLeaseEventSink(
         (lease_refresh_mode ==
          LeaseRefreshMode::RefreshWithIntentionToReleaseTheHeldLease);
     if (should_send_release_notification) {
-      lease_event_sink->OnLeaseTransition(
-          leasable_lock_id, LeaseTransitionType::kRenewedWithIntentionToRelease,
-          current_lease_owner_info);
       return LeaseTransitionType::kRenewedWithIntentionToRelease;
     } else {
-      lease_event_sink->OnLeaseTransition(leasable_lock_id,
-                                          LeaseTransitionType::kRenewed,
-                                          current_lease_owner_info);
       return LeaseTransitionType::kRenewed;
     }
   } else if (!was_lease_owner && !is_lease_owner) {
     // 4. Previously NOT owned and currently NOT owned.
-    lease_event_sink->OnLeaseTransition(leasable_lock_id,
-                                        LeaseTransitionType::kNotAcquired,
-                                        current_lease_owner_info);
     return LeaseTransitionType::kNotAcquired;
   } else {
     // This should never happen! Keeping the compiler happy :)
@@ -182,18 +158,35 @@ ExecutionResult LeaseRefresher::PerformLeaseRefresh() noexcept {
   //
   bool perform_lease_refresh = leasable_lock_->ShouldRefreshLease();
   if (perform_lease_refresh) {
-    bool is_lease_refresh_read_only =
-        (lease_refresh_mode_ ==
-         LeaseRefreshMode::RefreshWithNoIntentionToHoldLease);
-    execution_result = leasable_lock_->RefreshLease(is_lease_refresh_read_only);
-    if (!execution_result.Successful()) {
-      SCP_ERROR(kLeaseRefresher, object_activity_id_, execution_result,
-                "Cannot refresh lease");
-      // Continue with notifying the sink.
-    }
+    execution_result = leasable_lock_->RefreshLease(IsLeaseRefreshReadOnly());
   }
   //
-  // 2) Run State Machine and Notify Lease Event Sink (if needed)
+  // 2) and 3)
+  //
+  auto lease_transition_notification = CompleteLeaseRefresh(
+      perform_lease_refresh, refresh_start_timestamp, execution_result);
+  if (lease_transition_notification) {
+    NotifyLeaseEventSink(*lease_transition_notification);
+  }
+  return execution_result;
+}
+
+bool LeaseRefresher::IsLeaseRefreshReadOnly() const noexcept {
+  return lease_refresh_mode_ ==
+         LeaseRefreshMode::RefreshWithNoIntentionToHoldLease;
+}
+
+optional<LeaseRefresher::LeaseTransitionNotification>
+LeaseRefresher::CompleteLeaseRefresh(
+    bool perform_lease_refresh, milliseconds refresh_start_timestamp,
+    const ExecutionResult& lease_refresh_result) noexcept {
+  if (perform_lease_refresh && !lease_refresh_result.Successful()) {
+    SCP_ERROR(kLeaseRefresher, object_activity_id_, lease_refresh_result,
+              "Cannot refresh lease");
+    // Continue with notifying the sink.
+  }
+  //
+  // 2) Run State Machine (the Lease Event Sink is notified by the caller)
   //
   bool was_lease_owner = was_lease_owner_;
   auto prev_lease_refresh_mode = prev_lease_refresh_mode_.load();
@@ -201,10 +194,13 @@ ExecutionResult LeaseRefresher::PerformLeaseRefresh() noexcept {
   auto lease_owner_info = leasable_lock_->GetCurrentLeaseOwnerInfo();
   auto lease_refresh_mode = lease_refresh_mode_.load();
   auto lease_event_sink = lease_event_sink_.lock();
+  optional<LeaseTransitionNotification> lease_transition_notification;
   if (lease_event_sink && perform_lease_refresh) {
-    last_lease_transition_ = PerformLeaseTransitionAndNotifyLeaseEventSink(
-        leasable_lock_id_, lease_event_sink, is_lease_owner, lease_refresh_mode,
-        was_lease_owner, lease_owner_info, prev_lease_refresh_mode);
+    last_lease_transition_ =
+        GetLeaseTransition(is_lease_owner, lease_refresh_mode, was_lease_owner,
+                           prev_lease_refresh_mode);
+    lease_transition_notification = LeaseTransitionNotification{
+        lease_event_sink, *last_lease_transition_, lease_owner_info};
   }
   was_lease_owner_ = is_lease_owner;
   //
@@ -225,8 +221,14 @@ ExecutionResult LeaseRefresher::PerformLeaseRefresh() noexcept {
       ((duration_cast<milliseconds>(last_lease_refresh_timestamp_.load()) -
         refresh_start_timestamp))
           .count());
+  return lease_transition_notification;
+}
 
-  return execution_result;
+void LeaseRefresher::NotifyLeaseEventSink(
+    const LeaseTransitionNotification& lease_transition_notification) noexcept {
+  lease_transition_notification.lease_event_sink->OnLeaseTransition(
+      leasable_lock_id_, lease_transition_notification.lease_transition_type,
+      lease_transition_notification.lease_owner_info);
 }
 
 void LeaseRefresher::LeaseRefreshThreadFunction() {
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 
 #include "core/interface/lease_manager_interface.h"
@@ -94,6 +95,40 @@ class LeaseRefresher : public LeaseRefresherInterface,
    */
   void LeaseRefreshThreadFunction();
 
+  /**
+   * @brief Returns true if the lease should be refreshed without acquiring it
+   * in the current lease refresh mode.
+   */
+  bool IsLeaseRefreshReadOnly() const noexcept;
+
+  /// @brief A lease transition to notify the lease event sink about.
+  struct LeaseTransitionNotification {
+    std::shared_ptr<LeaseEventSinkInterface> lease_event_sink;
+    LeaseTransitionType lease_transition_type;
+    std::optional<LeaseInfo> lease_owner_info;
+  };
+
+  /**
+   * @brief Runs the state machine on the refreshed lease and updates the lease
+   * refresh timestamp. Must be called with lease_refresh_mutex_ held.
+   *
+   * @param perform_lease_refresh whether the lease was refreshed in this round.
+   * @param refresh_start_timestamp steady timestamp of the start of the round.
+   * @param lease_refresh_result result of the lease refresh, if performed.
+   * @return the transition to notify the lease event sink about, if any.
+   */
+  std::optional<LeaseTransitionNotification> CompleteLeaseRefresh(
+      bool perform_lease_refresh,
+      std::chrono::milliseconds refresh_start_timestamp,
+      const ExecutionResult& lease_refresh_result) noexcept;
+
+  /**
+   * @brief Notifies the lease event sink about a transition returned by
+   * CompleteLeaseRefresh(). May be called without lease_refresh_mutex_ held.
+   */
+  void NotifyLeaseEventSink(const LeaseTransitionNotification&
+                                lease_transition_notification) noexcept;
+
   /// @brief Leasable lock that is managed by this refresher.
   std::shared_ptr<LeasableLockInterface> leasable_lock_;
   /// @brief Sink of the lease transition events generated by this refresher.
@@ -0,0 +1,270 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "multi_lease_refresher.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core/common/global_logger/src/global_logger.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/uuid/src/uuid.h"
+
+#include "error_codes.h"
+
+using google::scp::core::common::TimeProvider;
+using google::scp::core::common::Uuid;
+using std::find;
+using std::future_status;
+using std::make_unique;
+using std::move;
+using std::mutex;
+using std::optional;
+using std::promise;
+using std::shared_ptr;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+static constexpr char kMultiLeaseRefresher[] = "MultiLeaseRefresher";
+static constexpr milliseconds kLeaseRefreshInvocationIntervalInMilliseconds =
+    milliseconds(1000);
+
+namespace google::scp::core {
+BatchedLeaseRefresher::BatchedLeaseRefresher(
+    const LeasableLockId& leasable_lock_id,
+    const shared_ptr<LeasableLockInterface>& leasable_lock,
+    const shared_ptr<LeaseEventSinkInterface>& lease_event_sink,
+    const shared_ptr<MultiLeaseRefresher>& multi_lease_refresher)
+    : LeaseRefresher(leasable_lock_id, leasable_lock, lease_event_sink),
+      multi_lease_refresher_(multi_lease_refresher) {}
+
+ExecutionResult BatchedLeaseRefresher::Run() noexcept {
+  if (is_running_) {
+    return FailureExecutionResult(errors::SC_LEASE_REFRESHER_ALREADY_RUNNING);
+  }
+  auto execution_result = multi_lease_refresher_->AddLeaseRefresher(this);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  is_running_ = true;
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BatchedLeaseRefresher::Stop() noexcept {
+  if (!is_running_) {
+    return FailureExecutionResult(errors::SC_LEASE_REFRESHER_NOT_RUNNING);
+  }
+  auto execution_result = multi_lease_refresher_->RemoveLeaseRefresher(this);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  is_running_ = false;
+  return SuccessExecutionResult();
+}
+
+MultiLeaseRefresher::MultiLeaseRefresher(
+    const shared_ptr<LeasableLockBatchRefresherInterface>&
+        leasable_lock_batch_refresher,
+    milliseconds lease_refresh_round_timeout)
+    : leasable_lock_batch_refresher_(leasable_lock_batch_refresher),
+      lease_refresh_round_timeout_(lease_refresh_round_timeout),
+      is_running_(false),
+      object_activity_id_(Uuid::GenerateUuid()) {}
+
+MultiLeaseRefresher::~MultiLeaseRefresher() {
+  is_running_ = false;
+  if (lease_refresher_thread_ && lease_refresher_thread_->joinable()) {
+    lease_refresher_thread_->join();
+  }
+}
+
+ExecutionResult MultiLeaseRefresher::AddLeaseRefresher(
+    BatchedLeaseRefresher* lease_refresher) noexcept {
+  unique_lock<mutex> lifecycle_lock(lifecycle_mutex_);
+  {
+    unique_lock<mutex> lock(lease_refreshers_mutex_);
+    if (find(lease_refreshers_.begin(), lease_refreshers_.end(),
+             lease_refresher) != lease_refreshers_.end()) {
+      return FailureExecutionResult(
+          errors::SC_LEASE_REFRESHER_ALREADY_RUNNING);
+    }
+    lease_refreshers_.push_back(lease_refresher);
+  }
+
+  if (!is_running_) {
+    is_running_ = true;
+    lease_refresher_thread_ =
+        make_unique<thread>([this]() { LeaseRefreshThreadFunction(); });
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult MultiLeaseRefresher::RemoveLeaseRefresher(
+    BatchedLeaseRefresher* lease_refresher) noexcept {
+  unique_lock<mutex> lifecycle_lock(lifecycle_mutex_);
+  bool no_lease_refreshers_left = false;
+  {
+    unique_lock<mutex> lock(lease_refreshers_mutex_);
+    auto it = find(lease_refreshers_.begin(), lease_refreshers_.end(),
+                   lease_refresher);
+    if (it == lease_refreshers_.end()) {
+      return FailureExecutionResult(errors::SC_LEASE_REFRESHER_NOT_RUNNING);
+    }
+    lease_refreshers_.erase(it);
+    no_lease_refreshers_left = lease_refreshers_.empty();
+  }
+  // Waits for the ongoing round, if any, so that the refresher is not used
+  // once removed.
+  { unique_lock<mutex> round_lock(lease_refresh_round_mutex_); }
+
+  if (no_lease_refreshers_left && is_running_) {
+    is_running_ = false;
+    if (lease_refresher_thread_->joinable()) {
+      lease_refresher_thread_->join();
+    }
+  }
+  return SuccessExecutionResult();
+}
+
+void MultiLeaseRefresher::PerformLeaseRefreshRound() noexcept {
+  unique_lock<mutex> round_lock(lease_refresh_round_mutex_);
+  vector<BatchedLeaseRefresher*> lease_refreshers;
+  {
+    unique_lock<mutex> lock(lease_refreshers_mutex_);
+    lease_refreshers = lease_refreshers_;
+  }
+  if (lease_refreshers.empty()) {
+    return;
+  }
+  auto refresh_start_timestamp = duration_cast<milliseconds>(
+      TimeProvider::GetSteadyTimestampInNanoseconds());
+
+  // The refreshers are not locked while the leases are refreshed, so a refresh
+  // mode set meanwhile only takes effect from the next round.
+  vector<bool> perform_lease_refresh(lease_refreshers.size(), false);
+  vector<shared_ptr<LeasableLockInterface>> leasable_locks;
+  vector<bool> is_read_only_lease_refresh;
+  for (size_t i = 0; i < lease_refreshers.size(); ++i) {
+    auto* lease_refresher = lease_refreshers[i];
+    auto lease_refresh_lock = lease_refresher->LockLeaseRefresh();
+    if (lease_refresher->GetLeasableLock()->ShouldRefreshLease()) {
+      perform_lease_refresh[i] = true;
+      leasable_locks.push_back(lease_refresher->GetLeasableLock());
+      is_read_only_lease_refresh.push_back(
+          lease_refresher->IsLeaseRefreshReadOnly());
+    }
+  }
+
+  vector<ExecutionResult> lease_refresh_results;
+  if (!leasable_locks.empty()) {
+    lease_refresh_results =
+        RefreshLeases(leasable_locks, is_read_only_lease_refresh);
+  }
+
+  SCP_DEBUG(kMultiLeaseRefresher, object_activity_id_,
+            "Refreshed '%llu' leases out of '%llu' locks in a round.",
+            leasable_locks.size(), lease_refreshers.size());
+
+  size_t refreshed_lease_index = 0;
+  for (size_t i = 0; i < lease_refreshers.size(); ++i) {
+    ExecutionResult lease_refresh_result = SuccessExecutionResult();
+    if (perform_lease_refresh[i]) {
+      lease_refresh_result =
+          refreshed_lease_index < lease_refresh_results.size()
+              ? lease_refresh_results[refreshed_lease_index]
+              : FailureExecutionResult(SC_UNKNOWN);
+      refreshed_lease_index++;
+    }
+    optional<BatchedLeaseRefresher::LeaseTransitionNotification>
+        lease_transition_notification;
+    {
+      auto lease_refresh_lock = lease_refreshers[i]->LockLeaseRefresh();
+      lease_transition_notification = lease_refreshers[i]->CompleteLeaseRefresh(
+          perform_lease_refresh[i], refresh_start_timestamp,
+          lease_refresh_result);
+    }
+    // Notified without the refresher locked, so that the lease event sink can
+    // e.g. set the lease refresh mode.
+    if (lease_transition_notification) {
+      lease_refreshers[i]->NotifyLeaseEventSink(*lease_transition_notification);
+    }
+  }
+}
+
+vector<ExecutionResult> MultiLeaseRefresher::RefreshLeases(
+    const vector<shared_ptr<LeasableLockInterface>>& leasable_locks,
+    const vector<bool>& is_read_only_lease_refresh) noexcept {
+  // A refresh which timed out in a previous round may still be ongoing, and is
+  // not started again until it finishes.
+  if (pending_lease_refresh_.valid() &&
+      pending_lease_refresh_.wait_for(milliseconds(0)) !=
+          future_status::ready) {
+    auto execution_result =
+        FailureExecutionResult(errors::SC_LEASE_REFRESHER_REFRESH_TIMED_OUT);
+    SCP_ERROR(kMultiLeaseRefresher, object_activity_id_, execution_result,
+              "The refresh of the leases of a previous round is still "
+              "ongoing. Failing the refresh of '%llu' leases.",
+              leasable_locks.size());
+    return vector<ExecutionResult>(leasable_locks.size(), execution_result);
+  }
+
+  // The refresh runs on a thread of its own, which only shares ownership of
+  // what it uses, so that it can outlive a round timing out.
+  promise<vector<ExecutionResult>> lease_refresh_promise;
+  pending_lease_refresh_ = lease_refresh_promise.get_future();
+  thread([lease_refresh_promise = move(lease_refresh_promise),
+          leasable_lock_batch_refresher = leasable_lock_batch_refresher_,
+          leasable_locks, is_read_only_lease_refresh]() mutable {
+    vector<ExecutionResult> lease_refresh_results;
+    if (leasable_lock_batch_refresher) {
+      lease_refresh_results = leasable_lock_batch_refresher->RefreshLeases(
+          leasable_locks, is_read_only_lease_refresh);
+    } else {
+      for (size_t i = 0; i < leasable_locks.size(); ++i) {
+        lease_refresh_results.push_back(
+            leasable_locks[i]->RefreshLease(is_read_only_lease_refresh[i]));
+      }
+    }
+    lease_refresh_promise.set_value(move(lease_refresh_results));
+  }).detach();
+
+  if (pending_lease_refresh_.wait_for(lease_refresh_round_timeout_) !=
+      future_status::ready) {
+    auto execution_result =
+        FailureExecutionResult(errors::SC_LEASE_REFRESHER_REFRESH_TIMED_OUT);
+    SCP_ERROR(kMultiLeaseRefresher, object_activity_id_, execution_result,
+              "The refresh of '%llu' leases timed out after '%llu' ms.",
+              leasable_locks.size(), lease_refresh_round_timeout_.count());
+    return vector<ExecutionResult>(leasable_locks.size(), execution_result);
+  }
+  return pending_lease_refresh_.get();
+}
+
+void MultiLeaseRefresher::LeaseRefreshThreadFunction() noexcept {
+  while (is_running_) {
+    PerformLeaseRefreshRound();
+    sleep_for(kLeaseRefreshInvocationIntervalInMilliseconds);
+  }
+}
+}  // namespace google::scp::core
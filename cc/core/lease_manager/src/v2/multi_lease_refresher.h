@@ -0,0 +1,178 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/interface/lease_manager_interface.h"
+
+#include "lease_refresher.h"
+
+namespace google::scp::core {
+/// How long a round of MultiLeaseRefresher waits for the leases to be
+/// refreshed before failing their refreshes.
+static constexpr std::chrono::milliseconds kDefaultLeaseRefreshRoundTimeout =
+    std::chrono::milliseconds(3000);
+
+class MultiLeaseRefresher;
+
+/**
+ * @copydoc LeaseRefresherInterface
+ *
+ * Lease refresher whose periodic refreshes are performed by a
+ * MultiLeaseRefresher together with the ones of the other locks, instead of
+ * by a worker thread of its own.
+ */
+class BatchedLeaseRefresher : public LeaseRefresher {
+ public:
+  BatchedLeaseRefresher(
+      const LeasableLockId& leasable_lock_id,
+      const std::shared_ptr<LeasableLockInterface>& leasable_lock,
+      const std::shared_ptr<LeaseEventSinkInterface>& lease_event_sink,
+      const std::shared_ptr<MultiLeaseRefresher>& multi_lease_refresher);
+
+  ExecutionResult Run() noexcept override;
+
+  ExecutionResult Stop() noexcept override;
+
+  /// @brief Returns the leasable lock that is managed by this refresher.
+  const std::shared_ptr<LeasableLockInterface>& GetLeasableLock()
+      const noexcept {
+    return leasable_lock_;
+  }
+
+  /**
+   * @brief Returns the lock to hold from deciding to refresh the lease until
+   * CompleteLeaseRefresh(), so that the refresh mode does not change midway.
+   */
+  std::unique_lock<std::mutex> LockLeaseRefresh() noexcept {
+    return std::unique_lock<std::mutex>(lease_refresh_mutex_);
+  }
+
+  using LeaseRefresher::LeaseTransitionNotification;
+  using LeaseRefresher::CompleteLeaseRefresh;
+  using LeaseRefresher::IsLeaseRefreshReadOnly;
+  using LeaseRefresher::NotifyLeaseEventSink;
+
+ protected:
+  /// @brief The refresher performing the periodic lease refreshes.
+  std::shared_ptr<MultiLeaseRefresher> multi_lease_refresher_;
+};
+
+/**
+ * @brief Periodically refreshes the leases of all of its running
+ * BatchedLeaseRefreshers in a single round with one worker thread. The locks
+ * which need a refresh in a round are refreshed together with a
+ * LeasableLockBatchRefresherInterface, e.g. with one database round trip for
+ * all of them, and then every refresher notifies its own lease event sink.
+ *
+ * No refresher is locked while the leases are refreshed or while the lease
+ * event sinks are notified, and a round waits at most
+ * lease_refresh_round_timeout for the leases to be refreshed.
+ *
+ * This keeps the number of threads and database round trips independent of
+ * the number of locks, e.g. of the partitions of a node.
+ */
+class MultiLeaseRefresher {
+ public:
+  /**
+   * @brief Construct a new Multi Lease Refresher object
+   *
+   * @param leasable_lock_batch_refresher refreshes the leases of the locks of
+   * a round together. If null, the locks are refreshed one by one.
+   * @param lease_refresh_round_timeout how long a round waits for the leases
+   * to be refreshed. The refreshes of a round timing out are failed, and the
+   * next rounds fail theirs until the timed out refresh finishes.
+   */
+  explicit MultiLeaseRefresher(
+      const std::shared_ptr<LeasableLockBatchRefresherInterface>&
+          leasable_lock_batch_refresher = nullptr,
+      std::chrono::milliseconds lease_refresh_round_timeout =
+          kDefaultLeaseRefreshRoundTimeout);
+
+  ~MultiLeaseRefresher();
+
+  /**
+   * @brief Starts refreshing the lease of the refresher periodically. The
+   * worker thread is started with the first refresher.
+   */
+  ExecutionResult AddLeaseRefresher(
+      BatchedLeaseRefresher* lease_refresher) noexcept;
+
+  /**
+   * @brief Stops refreshing the lease of the refresher. Once this returns, the
+   * refresher is not used anymore. The worker thread is stopped with the last
+   * refresher. Waits for the ongoing round, so this must not be called from a
+   * lease event sink.
+   */
+  ExecutionResult RemoveLeaseRefresher(
+      BatchedLeaseRefresher* lease_refresher) noexcept;
+
+  /**
+   * @brief Refreshes the leases of all the refreshers which need it, and
+   * notifies every refresher's lease event sink.
+   */
+  void PerformLeaseRefreshRound() noexcept;
+
+ protected:
+  /**
+   * @brief Lease refresh thread's function
+   */
+  void LeaseRefreshThreadFunction() noexcept;
+
+  /**
+   * @brief Refreshes the leases of the locks, waiting at most
+   * lease_refresh_round_timeout_ for them.
+   *
+   * @return the results of the refreshes, in the order of the locks.
+   */
+  std::vector<ExecutionResult> RefreshLeases(
+      const std::vector<std::shared_ptr<LeasableLockInterface>>& leasable_locks,
+      const std::vector<bool>& is_read_only_lease_refresh) noexcept;
+
+  /// @brief Refreshes the leases of the locks of a round together.
+  std::shared_ptr<LeasableLockBatchRefresherInterface>
+      leasable_lock_batch_refresher_;
+  /// @brief Serializes adding and removing refreshers, i.e. starting and
+  /// stopping the worker thread.
+  std::mutex lifecycle_mutex_;
+  /// @brief How long a round waits for the leases to be refreshed.
+  const std::chrono::milliseconds lease_refresh_round_timeout_;
+  /// @brief Held for a whole round, so that removing a refresher can wait for
+  /// the ongoing round.
+  std::mutex lease_refresh_round_mutex_;
+  /// @brief Guards lease_refreshers_.
+  std::mutex lease_refreshers_mutex_;
+  /// @brief The running refreshers, in the order they were added.
+  std::vector<BatchedLeaseRefresher*> lease_refreshers_;
+  /// @brief The results of the last refresh of the leases, which may still be
+  /// ongoing if it timed out.
+  std::future<std::vector<ExecutionResult>> pending_lease_refresh_;
+  /// @brief Lease refresher thread
+  std::unique_ptr<std::thread> lease_refresher_thread_;
+  /// @brief Is running?
+  std::atomic<bool> is_running_;
+  /// @brief Activity ID for the lifetime of the object
+  core::common::Uuid object_activity_id_;
+};
+}  // namespace google::scp::core
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "multi_lease_refresher_factory.h"
+
+#include <memory>
+
+#include "multi_lease_refresher.h"
+
+namespace google::scp::core {
+std::shared_ptr<LeaseRefresherInterface> MultiLeaseRefresherFactory::Construct(
+    const LeasableLockId& leasable_lock_id,
+    const std::shared_ptr<LeasableLockInterface>& leasable_lock,
+    const std::shared_ptr<LeaseEventSinkInterface>& lease_event_sink) noexcept {
+  return std::make_shared<BatchedLeaseRefresher>(
+      leasable_lock_id, leasable_lock, lease_event_sink,
+      multi_lease_refresher_);
+}
+}  // namespace google::scp::core
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "core/interface/lease_manager_interface.h"
+
+#include "multi_lease_refresher.h"
+
+namespace google::scp::core {
+/**
+ * @copydoc LeaseRefresherFactoryInterface
+ *
+ * Constructs lease refreshers which are all refreshed together by a single
+ * MultiLeaseRefresher.
+ */
+class MultiLeaseRefresherFactory : public LeaseRefresherFactoryInterface {
+ public:
+  /**
+   * @brief Construct a new Multi Lease Refresher Factory object
+   *
+   * @param leasable_lock_batch_refresher refreshes the leases of the locks of
+   * a round together. If null, the locks are refreshed one by one.
+   * @param lease_refresh_round_timeout how long a round waits for the leases
+   * to be refreshed.
+   */
+  explicit MultiLeaseRefresherFactory(
+      const std::shared_ptr<LeasableLockBatchRefresherInterface>&
+          leasable_lock_batch_refresher = nullptr,
+      std::chrono::milliseconds lease_refresh_round_timeout =
+          kDefaultLeaseRefreshRoundTimeout)
+      : multi_lease_refresher_(std::make_shared<MultiLeaseRefresher>(
+            leasable_lock_batch_refresher, lease_refresh_round_timeout)) {}
+
+  std::shared_ptr<LeaseRefresherInterface> Construct(
+      const LeasableLockId& leasable_lock_id,
+      const std::shared_ptr<LeasableLockInterface>& leasable_lock,
+      const std::shared_ptr<LeaseEventSinkInterface>& lease_event_sink) noexcept
+      override;
+
+ protected:
+  /// @brief Refresher shared by all the constructed lease refreshers.
+  std::shared_ptr<MultiLeaseRefresher> multi_lease_refresher_;
+};
+}  // namespace google::scp::core
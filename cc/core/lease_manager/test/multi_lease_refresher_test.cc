@@ -0,0 +1,314 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/lease_manager/src/v2/multi_lease_refresher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/lease_manager/mock/mock_leasable_lock_gmock.h"
+#include "core/lease_manager/mock/mock_lease_event_sink.h"
+#include "core/lease_manager/src/v2/error_codes.h"
+#include "core/lease_manager/src/v2/multi_lease_refresher_factory.h"
+#include "core/test/utils/conditional_wait.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::lease_manager::mock::MockLeasableLock;
+using google::scp::core::lease_manager::mock::MockLeaseEventSink;
+using std::atomic;
+using std::condition_variable;
+using std::make_shared;
+using std::mutex;
+using std::shared_ptr;
+using std::unique_lock;
+using std::vector;
+using std::chrono::milliseconds;
+using ::testing::_;
+using ::testing::Return;
+
+namespace google::scp::core::test {
+/// Refreshes the locks one by one and records every batch.
+class RecordingLeasableLockBatchRefresher
+    : public LeasableLockBatchRefresherInterface {
+ public:
+  vector<ExecutionResult> RefreshLeases(
+      const vector<shared_ptr<LeasableLockInterface>>& leasable_locks,
+      const vector<bool>& is_read_only_lease_refresh) noexcept override {
+    vector<ExecutionResult> results;
+    for (size_t i = 0; i < leasable_locks.size(); ++i) {
+      results.push_back(
+          leasable_locks[i]->RefreshLease(is_read_only_lease_refresh[i]));
+    }
+    unique_lock<mutex> lock(mutex_);
+    batches_.push_back(leasable_locks);
+    read_only_flags_.push_back(is_read_only_lease_refresh);
+    return results;
+  }
+
+  size_t GetBatchCount() {
+    unique_lock<mutex> lock(mutex_);
+    return batches_.size();
+  }
+
+  mutex mutex_;
+  vector<vector<shared_ptr<LeasableLockInterface>>> batches_;
+  vector<vector<bool>> read_only_flags_;
+};
+
+/// Blocks every batch until released.
+class BlockingLeasableLockBatchRefresher
+    : public LeasableLockBatchRefresherInterface {
+ public:
+  vector<ExecutionResult> RefreshLeases(
+      const vector<shared_ptr<LeasableLockInterface>>& leasable_locks,
+      const vector<bool>& is_read_only_lease_refresh) noexcept override {
+    unique_lock<mutex> lock(mutex_);
+    batch_count_++;
+    condition_variable_.wait(lock, [this]() { return is_released_; });
+    return vector<ExecutionResult>(leasable_locks.size(),
+                                   SuccessExecutionResult());
+  }
+
+  size_t GetBatchCount() {
+    unique_lock<mutex> lock(mutex_);
+    return batch_count_;
+  }
+
+  void Release() {
+    unique_lock<mutex> lock(mutex_);
+    is_released_ = true;
+    condition_variable_.notify_all();
+  }
+
+  mutex mutex_;
+  condition_variable condition_variable_;
+  size_t batch_count_ = 0;
+  bool is_released_ = false;
+};
+
+class MultiLeaseRefresherTest : public ::testing::Test {
+ protected:
+  MultiLeaseRefresherTest()
+      : batch_refresher_(make_shared<RecordingLeasableLockBatchRefresher>()),
+        factory_(batch_refresher_) {
+    for (size_t i = 0; i < 2; ++i) {
+      auto mock_lock = make_shared<MockLeasableLock>();
+      ON_CALL(*mock_lock, ShouldRefreshLease()).WillByDefault(Return(true));
+      ON_CALL(*mock_lock, RefreshLease(_))
+          .WillByDefault(Return(SuccessExecutionResult()));
+      ON_CALL(*mock_lock, IsCurrentLeaseOwner()).WillByDefault(Return(false));
+      mock_locks_.push_back(mock_lock);
+      mock_event_sinks_.push_back(make_shared<MockLeaseEventSink>());
+      lock_ids_.push_back({i, i});
+      refreshers_.push_back(factory_.Construct(
+          lock_ids_[i], mock_locks_[i], mock_event_sinks_[i]));
+      EXPECT_SUCCESS(refreshers_[i]->Init());
+    }
+  }
+
+  shared_ptr<RecordingLeasableLockBatchRefresher> batch_refresher_;
+  MultiLeaseRefresherFactory factory_;
+  vector<shared_ptr<MockLeasableLock>> mock_locks_;
+  vector<shared_ptr<MockLeaseEventSink>> mock_event_sinks_;
+  vector<LeasableLockId> lock_ids_;
+  vector<shared_ptr<LeaseRefresherInterface>> refreshers_;
+};
+
+TEST_F(MultiLeaseRefresherTest, RunStop) {
+  EXPECT_SUCCESS(refreshers_[0]->Run());
+  EXPECT_SUCCESS(refreshers_[1]->Run());
+  EXPECT_THAT(refreshers_[0]->Run(),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_LEASE_REFRESHER_ALREADY_RUNNING)));
+  EXPECT_SUCCESS(refreshers_[0]->Stop());
+  EXPECT_SUCCESS(refreshers_[1]->Stop());
+  EXPECT_THAT(
+      refreshers_[1]->Stop(),
+      ResultIs(FailureExecutionResult(errors::SC_LEASE_REFRESHER_NOT_RUNNING)));
+
+  // Refreshers can be run again once all of them are stopped.
+  EXPECT_SUCCESS(refreshers_[1]->Run());
+  EXPECT_SUCCESS(refreshers_[1]->Stop());
+}
+
+TEST_F(MultiLeaseRefresherTest, RefreshesAllLocksInOneBatchAndNotifiesSinks) {
+  EXPECT_SUCCESS(refreshers_[0]->SetLeaseRefreshMode(
+      LeaseRefreshMode::RefreshWithIntentionToHoldLease));
+  ON_CALL(*mock_locks_[0], IsCurrentLeaseOwner()).WillByDefault(Return(true));
+  EXPECT_CALL(*mock_locks_[0], RefreshLease(false))
+      .WillRepeatedly(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*mock_locks_[1], RefreshLease(true))
+      .WillRepeatedly(Return(SuccessExecutionResult()));
+
+  atomic<bool> is_lease_acquired(false);
+  atomic<bool> is_lease_not_acquired(false);
+  EXPECT_CALL(
+      *mock_event_sinks_[0],
+      OnLeaseTransition(lock_ids_[0], LeaseTransitionType::kAcquired, _))
+      .WillOnce([&]() { is_lease_acquired = true; });
+  EXPECT_CALL(*mock_event_sinks_[0],
+              OnLeaseTransition(lock_ids_[0], LeaseTransitionType::kRenewed, _))
+      .WillRepeatedly(Return());
+  EXPECT_CALL(
+      *mock_event_sinks_[1],
+      OnLeaseTransition(lock_ids_[1], LeaseTransitionType::kNotAcquired, _))
+      .WillRepeatedly([&]() { is_lease_not_acquired = true; });
+
+  EXPECT_SUCCESS(refreshers_[0]->Run());
+  EXPECT_SUCCESS(refreshers_[1]->Run());
+  WaitUntil([&]() {
+    return is_lease_acquired.load() && is_lease_not_acquired.load();
+  });
+  EXPECT_SUCCESS(refreshers_[0]->Stop());
+  EXPECT_SUCCESS(refreshers_[1]->Stop());
+
+  // The rounds started before the second refresher ran only have the first.
+  auto& batches = batch_refresher_->batches_;
+  ASSERT_FALSE(batches.empty());
+  ASSERT_EQ(batches.back().size(), 2);
+  EXPECT_EQ(batches.back()[0], mock_locks_[0]);
+  EXPECT_EQ(batches.back()[1], mock_locks_[1]);
+  EXPECT_EQ(batch_refresher_->read_only_flags_.back(),
+            (vector<bool>{false, true}));
+}
+
+TEST_F(MultiLeaseRefresherTest, SkipsLocksWhichDoNotNeedRefresh) {
+  ON_CALL(*mock_locks_[0], ShouldRefreshLease()).WillByDefault(Return(false));
+  EXPECT_CALL(*mock_locks_[0], RefreshLease(_)).Times(0);
+  EXPECT_CALL(*mock_event_sinks_[0], OnLeaseTransition(_, _, _)).Times(0);
+
+  auto liveness_check =
+      std::dynamic_pointer_cast<LeaseRefreshLivenessCheckInterface>(
+          refreshers_[0]);
+  auto previous_timestamp = liveness_check->GetLastLeaseRefreshTimestamp();
+  EXPECT_SUCCESS(refreshers_[0]->Run());
+  EXPECT_SUCCESS(refreshers_[1]->Run());
+  WaitUntil([&]() { return batch_refresher_->GetBatchCount() > 0; });
+  // The refresher is live even if its lease did not need a refresh.
+  WaitUntil([&]() {
+    return liveness_check->GetLastLeaseRefreshTimestamp() > previous_timestamp;
+  });
+  EXPECT_SUCCESS(refreshers_[0]->Stop());
+  EXPECT_SUCCESS(refreshers_[1]->Stop());
+
+  for (const auto& batch : batch_refresher_->batches_) {
+    ASSERT_EQ(batch.size(), 1);
+    EXPECT_EQ(batch[0], mock_locks_[1]);
+  }
+}
+
+TEST_F(MultiLeaseRefresherTest, NotifiesSinkWhenLeaseRefreshFails) {
+  EXPECT_CALL(*mock_locks_[0], RefreshLease(_))
+      .WillRepeatedly(Return(FailureExecutionResult(SC_UNKNOWN)));
+  atomic<bool> is_invoked(false);
+  EXPECT_CALL(
+      *mock_event_sinks_[0],
+      OnLeaseTransition(lock_ids_[0], LeaseTransitionType::kNotAcquired, _))
+      .WillRepeatedly([&]() { is_invoked = true; });
+
+  EXPECT_SUCCESS(refreshers_[0]->Run());
+  WaitUntil([&]() { return is_invoked.load(); });
+  EXPECT_SUCCESS(refreshers_[0]->Stop());
+}
+
+TEST_F(MultiLeaseRefresherTest, LeaseEventSinkCanSetLeaseRefreshMode) {
+  atomic<bool> is_lease_refresh_mode_set(false);
+  EXPECT_CALL(
+      *mock_event_sinks_[0],
+      OnLeaseTransition(lock_ids_[0], LeaseTransitionType::kNotAcquired, _))
+      .WillRepeatedly([&]() {
+        EXPECT_SUCCESS(refreshers_[0]->SetLeaseRefreshMode(
+            LeaseRefreshMode::RefreshWithNoIntentionToHoldLease));
+        is_lease_refresh_mode_set = true;
+      });
+
+  EXPECT_SUCCESS(refreshers_[0]->Run());
+  WaitUntil([&]() { return is_lease_refresh_mode_set.load(); });
+  EXPECT_SUCCESS(refreshers_[0]->Stop());
+}
+
+TEST(MultiLeaseRefresherWithBlockingBatchRefresherTest,
+     SetLeaseRefreshModeDoesNotWaitForTheRefresh) {
+  auto batch_refresher = make_shared<BlockingLeasableLockBatchRefresher>();
+  MultiLeaseRefresherFactory factory(batch_refresher, milliseconds(60000));
+  auto mock_lock = make_shared<MockLeasableLock>();
+  ON_CALL(*mock_lock, ShouldRefreshLease()).WillByDefault(Return(true));
+  auto refresher = factory.Construct(LeasableLockId{0, 0}, mock_lock,
+                                     make_shared<MockLeaseEventSink>());
+
+  EXPECT_SUCCESS(refresher->Run());
+  WaitUntil([&]() { return batch_refresher->GetBatchCount() > 0; });
+  EXPECT_SUCCESS(refresher->SetLeaseRefreshMode(
+      LeaseRefreshMode::RefreshWithIntentionToHoldLease));
+  batch_refresher->Release();
+  EXPECT_SUCCESS(refresher->Stop());
+}
+
+TEST(MultiLeaseRefresherWithBlockingBatchRefresherTest,
+     FailsRefreshesOfRoundsTimingOut) {
+  auto batch_refresher = make_shared<BlockingLeasableLockBatchRefresher>();
+  MultiLeaseRefresherFactory factory(batch_refresher, milliseconds(10));
+  auto mock_lock = make_shared<MockLeasableLock>();
+  ON_CALL(*mock_lock, ShouldRefreshLease()).WillByDefault(Return(true));
+  ON_CALL(*mock_lock, IsCurrentLeaseOwner()).WillByDefault(Return(false));
+  auto mock_event_sink = make_shared<MockLeaseEventSink>();
+  atomic<size_t> not_acquired_count(0);
+  EXPECT_CALL(*mock_event_sink,
+              OnLeaseTransition(_, LeaseTransitionType::kNotAcquired, _))
+      .WillRepeatedly([&]() { not_acquired_count++; });
+  auto refresher =
+      factory.Construct(LeasableLockId{0, 0}, mock_lock, mock_event_sink);
+
+  EXPECT_SUCCESS(refresher->Run());
+  // The rounds complete while the refresh of the first one is blocked, and do
+  // not start another refresh meanwhile.
+  WaitUntil([&]() { return not_acquired_count.load() >= 2; });
+  EXPECT_EQ(batch_refresher->GetBatchCount(), 1);
+
+  // Once the blocked refresh finishes, the leases are refreshed again.
+  batch_refresher->Release();
+  WaitUntil([&]() { return batch_refresher->GetBatchCount() > 1; });
+  EXPECT_SUCCESS(refresher->Stop());
+}
+
+TEST(MultiLeaseRefresherWithoutBatchRefresherTest, RefreshesLocksOneByOne) {
+  MultiLeaseRefresherFactory factory;
+  vector<shared_ptr<MockLeasableLock>> mock_locks;
+  vector<shared_ptr<LeaseRefresherInterface>> refreshers;
+  atomic<size_t> refresh_count(0);
+  for (size_t i = 0; i < 2; ++i) {
+    auto mock_lock = make_shared<MockLeasableLock>();
+    ON_CALL(*mock_lock, ShouldRefreshLease()).WillByDefault(Return(true));
+    ON_CALL(*mock_lock, RefreshLease(true)).WillByDefault([&](bool) {
+      refresh_count++;
+      return SuccessExecutionResult();
+    });
+    mock_locks.push_back(mock_lock);
+    refreshers.push_back(factory.Construct(
+        LeasableLockId{i, i}, mock_lock, make_shared<MockLeaseEventSink>()));
+    EXPECT_SUCCESS(refreshers[i]->Run());
+  }
+  WaitUntil([&]() { return refresh_count.load() >= 2; });
+  for (auto& refresher : refreshers) {
+    EXPECT_SUCCESS(refresher->Stop());
+  }
+}
+}  // namespace google::scp::core::test
@@ -19,6 +19,8 @@
 #include <memory>
 
 #include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/dynamodb/model/BatchGetItemRequest.h>
+#include <aws/dynamodb/model/BatchWriteItemRequest.h>
 #include <aws/dynamodb/model/QueryRequest.h>
 #include <aws/dynamodb/model/UpdateItemRequest.h>
 
@@ -43,6 +45,18 @@ class MockAwsDynamoDBClient : public Aws::DynamoDB::DynamoDBClient {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>&)>
       update_item_async_mock;
 
+  std::function<void(
+      const Aws::DynamoDB::Model::BatchGetItemRequest&,
+      const Aws::DynamoDB::BatchGetItemResponseReceivedHandler&,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>&)>
+      batch_get_item_async_mock;
+
+  std::function<void(
+      const Aws::DynamoDB::Model::BatchWriteItemRequest&,
+      const Aws::DynamoDB::BatchWriteItemResponseReceivedHandler&,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>&)>
+      batch_write_item_async_mock;
+
   void QueryAsync(const Aws::DynamoDB::Model::QueryRequest& request,
                   const Aws::DynamoDB::QueryResponseReceivedHandler& handler,
                   const std::shared_ptr<const Aws::Client::AsyncCallerContext>&
@@ -67,5 +81,31 @@ class MockAwsDynamoDBClient : public Aws::DynamoDB::DynamoDBClient {
 
     DynamoDBClient::UpdateItemAsync(request, handler, context);
   }
+
+  void BatchGetItemAsync(
+      const Aws::DynamoDB::Model::BatchGetItemRequest& request,
+      const Aws::DynamoDB::BatchGetItemResponseReceivedHandler& handler,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>& context =
+          nullptr) const override {
+    if (batch_get_item_async_mock) {
+      batch_get_item_async_mock(request, handler, context);
+      return;
+    }
+
+    DynamoDBClient::BatchGetItemAsync(request, handler, context);
+  }
+
+  void BatchWriteItemAsync(
+      const Aws::DynamoDB::Model::BatchWriteItemRequest& request,
+      const Aws::DynamoDB::BatchWriteItemResponseReceivedHandler& handler,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>& context =
+          nullptr) const override {
+    if (batch_write_item_async_mock) {
+      batch_write_item_async_mock(request, handler, context);
+      return;
+    }
+
+    DynamoDBClient::BatchWriteItemAsync(request, handler, context);
+  }
 };
 }  // namespace google::scp::core::nosql_database_provider::aws::mock
@@ -25,6 +25,7 @@
 
 #include "core/common/concurrent_map/src/concurrent_map.h"
 #include "core/interface/nosql_database_provider_interface.h"
+#include "core/nosql_database_provider/src/common/batch_database_items_tracker.h"
 #include "core/nosql_database_provider/src/common/error_codes.h"
 
 namespace google::scp::core::nosql_database_provider::mock {
@@ -346,6 +347,69 @@ class MockNoSQLDatabaseProvider : public NoSQLDatabaseProviderInterface {
     return SuccessExecutionResult();
   }
 
+  ExecutionResult BatchGetDatabaseItems(
+      AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+          batch_get_database_items_context) noexcept override {
+    if (!batch_get_database_items_context.request) {
+      batch_get_database_items_context.result =
+          FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST);
+      batch_get_database_items_context.Finish();
+      return SuccessExecutionResult();
+    }
+
+    // Items are served one by one, each finishing inline.
+    auto tracker = std::make_shared<BatchDatabaseItemsTracker<
+        BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>>(
+        batch_get_database_items_context,
+        [](AsyncContext<BatchGetDatabaseItemsRequest,
+                        BatchGetDatabaseItemsResponse>& context) {
+          context.Finish();
+        });
+    for (size_t i = 0; i < tracker->ItemCount(); ++i) {
+      ExecuteBatchItemOneByOne(
+          tracker, i,
+          [this](AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>&
+                     context) { return GetDatabaseItem(context); });
+    }
+    tracker->FinishIfEmpty();
+    return SuccessExecutionResult();
+  }
+
+  ExecutionResult BatchUpsertDatabaseItems(
+      AsyncContext<BatchUpsertDatabaseItemsRequest,
+                   BatchUpsertDatabaseItemsResponse>&
+          batch_upsert_database_items_context) noexcept override {
+    if (!batch_upsert_database_items_context.request) {
+      batch_upsert_database_items_context.result =
+          FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST);
+      batch_upsert_database_items_context.Finish();
+      return SuccessExecutionResult();
+    }
+
+    // Items are served one by one, each finishing inline.
+    auto tracker = std::make_shared<BatchDatabaseItemsTracker<
+        BatchUpsertDatabaseItemsRequest, BatchUpsertDatabaseItemsResponse>>(
+        batch_upsert_database_items_context,
+        [](AsyncContext<BatchUpsertDatabaseItemsRequest,
+                        BatchUpsertDatabaseItemsResponse>& context) {
+          context.Finish();
+        });
+    auto is_duplicate = FailDuplicateBatchItems(tracker);
+    for (size_t i = 0; i < tracker->ItemCount(); ++i) {
+      if (is_duplicate[i]) {
+        continue;
+      }
+      ExecuteBatchItemOneByOne(
+          tracker, i,
+          [this](AsyncContext<UpsertDatabaseItemRequest,
+                              UpsertDatabaseItemResponse>& context) {
+            return UpsertDatabaseItem(context);
+          });
+    }
+    tracker->FinishIfEmpty();
+    return SuccessExecutionResult();
+  }
+
   ExecutionResult GetRecord(std::shared_ptr<SortKey>& sort_key,
                             std::shared_ptr<Record>& out_record) {
     if (sort_key->record) {
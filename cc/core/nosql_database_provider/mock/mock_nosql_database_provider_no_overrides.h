@@ -48,5 +48,15 @@ class MockNoSQLDatabaseProviderNoOverrides
       ExecutionResult, UpsertDatabaseItem,
       ((AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>&)),
       (noexcept, override));
+
+  MOCK_METHOD(ExecutionResult, BatchGetDatabaseItems,
+              ((AsyncContext<BatchGetDatabaseItemsRequest,
+                             BatchGetDatabaseItemsResponse>&)),
+              (noexcept, override));
+
+  MOCK_METHOD(ExecutionResult, BatchUpsertDatabaseItems,
+              ((AsyncContext<BatchUpsertDatabaseItemsRequest,
+                             BatchUpsertDatabaseItemsResponse>&)),
+              (noexcept, override));
 };
 }  // namespace google::scp::core::nosql_database_provider::mock
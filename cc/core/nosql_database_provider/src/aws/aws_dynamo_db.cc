@@ -16,18 +16,26 @@
 
 #include "aws_dynamo_db.h"
 
+#include <chrono>
+#include <iomanip>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <aws/core/Aws.h>
 #include <aws/core/utils/Outcome.h>
 #include <aws/dynamodb/model/AttributeDefinition.h>
+#include <aws/dynamodb/model/BatchGetItemRequest.h>
+#include <aws/dynamodb/model/BatchWriteItemRequest.h>
 #include <aws/dynamodb/model/QueryRequest.h>
 #include <aws/dynamodb/model/UpdateItemRequest.h>
 
 #include "core/async_executor/src/aws/aws_async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
 #include "core/interface/configuration_keys.h"
 #include "core/nosql_database_provider/src/common/nosql_database_provider_utils.h"
 
@@ -40,21 +48,34 @@ using Aws::Client::AWSError;
 using Aws::Client::ClientConfiguration;
 using Aws::DynamoDB::DynamoDBClient;
 using Aws::DynamoDB::DynamoDBError;
+using Aws::Vector;
 using Aws::DynamoDB::Model::AttributeValue;
+using Aws::DynamoDB::Model::BatchGetItemRequest;
+using Aws::DynamoDB::Model::BatchGetItemResult;
+using Aws::DynamoDB::Model::BatchWriteItemRequest;
+using Aws::DynamoDB::Model::BatchWriteItemResult;
+using Aws::DynamoDB::Model::KeysAndAttributes;
+using Aws::DynamoDB::Model::PutRequest;
 using Aws::DynamoDB::Model::QueryRequest;
 using Aws::DynamoDB::Model::QueryResult;
 using Aws::DynamoDB::Model::UpdateItemRequest;
 using Aws::DynamoDB::Model::UpdateItemResult;
+using Aws::DynamoDB::Model::ValueType;
+using Aws::DynamoDB::Model::WriteRequest;
 using Aws::Utils::Outcome;
 using google::scp::core::async_executor::aws::AwsAsyncExecutor;
+using google::scp::core::common::TimeProvider;
 using google::scp::core::nosql_database_provider::AwsDynamoDBUtils;
 using google::scp::core::nosql_database_provider::NoSQLDatabaseProviderUtils;
 using std::bind;
 using std::make_shared;
 using std::move;
+using std::pair;
 using std::shared_ptr;
 using std::string;
+using std::unordered_set;
 using std::vector;
+using std::chrono::milliseconds;
 using std::placeholders::_1;
 using std::placeholders::_2;
 using std::placeholders::_3;
@@ -63,6 +84,62 @@ using std::placeholders::_4;
 static constexpr size_t kExpressionsInitialByteSize = 1024;
 static constexpr char kDynamoDB[] = "DynamoDB";
 static constexpr size_t kMaxConcurrentConnections = 1000;
+// Limits of DynamoDB on the number of items of a batch request.
+static constexpr size_t kMaxBatchGetItemKeys = 100;
+static constexpr size_t kMaxBatchWriteItemRequests = 25;
+// Unprocessed items are retried with exponential backoff, and fail with a
+// retriable error once all the attempts are used.
+static constexpr size_t kMaxBatchRequestAttempts = 4;
+static constexpr milliseconds kBatchRequestRetryBaseDelay = milliseconds(50);
+
+namespace {
+/**
+ * @brief Appends the value of the key attribute of the DynamoDB item to the
+ * string identifying the item in a batch. Numbers are normalized since
+ * DynamoDB does not return them as they were sent.
+ *
+ * @return bool False if the item does not have the key attribute.
+ */
+bool AppendDynamoDBKeyValue(const Map<String, AttributeValue>& item,
+                            const string& key_name, string& item_key) {
+  item_key += '\0';
+  if (key_name.empty()) {
+    return true;
+  }
+  auto key_value = item.find(String(key_name.c_str()));
+  if (key_value == item.end()) {
+    return false;
+  }
+  if (key_value->second.GetType() == ValueType::STRING) {
+    item_key += "S:";
+    item_key += key_value->second.GetS().c_str();
+    return true;
+  }
+  if (key_value->second.GetType() == ValueType::NUMBER) {
+    try {
+      std::ostringstream number;
+      number << std::setprecision(std::numeric_limits<double>::max_digits10)
+             << std::stod(key_value->second.GetN().c_str());
+      item_key += "N:" + number.str();
+      return true;
+    } catch (...) {}
+  }
+  return false;
+}
+
+/**
+ * @brief Returns the string identifying the DynamoDB item in a batch, from
+ * the names of its key attributes.
+ */
+bool GetDynamoDBItemKey(const string& table_name,
+                        const pair<string, string>& key_names,
+                        const Map<String, AttributeValue>& item,
+                        string& item_key) {
+  item_key = table_name;
+  return AppendDynamoDBKeyValue(item, key_names.first, item_key) &&
+         AppendDynamoDBKeyValue(item, key_names.second, item_key);
+}
+}  // namespace
 
 namespace google::scp::core::nosql_database_provider {
 ExecutionResult AwsDynamoDB::CreateClientConfig() noexcept {
@@ -469,4 +546,486 @@ void AwsDynamoDB::OnUpsertDatabaseItemCallback(
     upsert_database_item_context.Finish();
   }
 }
+
+template <typename BatchContext>
+void AwsDynamoDB::FinishBatchContext(BatchContext& batch_context) noexcept {
+  if (!async_executor_
+           ->Schedule(
+               [batch_context]() mutable { batch_context.Finish(); },
+               AsyncPriority::High)
+           .Successful()) {
+    batch_context.Finish();
+  }
+}
+
+template <typename Tracker>
+ExecutionResult AwsDynamoDB::AddItemKeyToChunk(
+    BatchItemsChunk<Tracker>& chunk, const SingleDatabaseItemRequest& item,
+    Map<String, AttributeValue>& key, string& item_key) noexcept {
+  pair<string, string> key_names(
+      *item.partition_key->attribute_name,
+      item.sort_key ? *item.sort_key->attribute_name : "");
+  auto table_key_names = chunk.key_names.emplace(*item.table_name, key_names);
+  // The response items are matched with the key names of their table.
+  if (table_key_names.first->second != key_names) {
+    return FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST);
+  }
+
+  AttributeValue partition_key_value;
+  auto execution_result = AwsDynamoDBUtils::
+      ConvertNoSQLDatabaseValidAttributeValueTypeToDynamoDBType(
+          *item.partition_key->attribute_value, partition_key_value);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+  key.emplace(String(key_names.first.c_str()), partition_key_value);
+
+  if (item.sort_key) {
+    AttributeValue sort_key_value;
+    execution_result = AwsDynamoDBUtils::
+        ConvertNoSQLDatabaseValidAttributeValueTypeToDynamoDBType(
+            *item.sort_key->attribute_value, sort_key_value);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    key.emplace(String(key_names.second.c_str()), sort_key_value);
+  }
+
+  if (!GetDynamoDBItemKey(*item.table_name, key_names, key, item_key)) {
+    return FailureExecutionResult(
+        errors::SC_NO_SQL_DATABASE_INVALID_PARAMETER_TYPE);
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult AwsDynamoDB::BatchGetDatabaseItems(
+    AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+        batch_get_database_items_context) noexcept {
+  if (!batch_get_database_items_context.request) {
+    return FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST);
+  }
+
+  auto tracker = make_shared<BatchGetTracker>(
+      batch_get_database_items_context,
+      [this](AsyncContext<BatchGetDatabaseItemsRequest,
+                          BatchGetDatabaseItemsResponse>& batch_context) {
+        FinishBatchContext(batch_context);
+      });
+
+  shared_ptr<BatchItemsChunk<BatchGetTracker>> chunk;
+  Map<String, KeysAndAttributes> request_items;
+  size_t chunk_key_count = 0;
+  auto send_chunk = [&]() {
+    BatchGetItemRequest batch_get_item_request;
+    batch_get_item_request.SetRequestItems(move(request_items));
+    SendBatchGetItemRequest(chunk, batch_get_item_request);
+    chunk = nullptr;
+    request_items = Map<String, KeysAndAttributes>();
+    chunk_key_count = 0;
+  };
+
+  for (size_t index = 0; index < tracker->ItemCount(); ++index) {
+    const auto& item = tracker->GetItem(index);
+    if (!IsValidBatchItem(item)) {
+      tracker->CompleteItem(
+          index,
+          FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST));
+      continue;
+    }
+
+    auto get_database_item =
+        [this](AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>&
+                   context) { return GetDatabaseItem(context); };
+    // BatchGetItem cannot filter on attributes.
+    if (HasAttributeConditions(*item)) {
+      ExecuteBatchItemOneByOne(tracker, index, get_database_item);
+      continue;
+    }
+
+    if (!chunk) {
+      chunk = make_shared<BatchItemsChunk<BatchGetTracker>>();
+      chunk->tracker = tracker;
+    }
+    Map<String, AttributeValue> key;
+    string item_key;
+    if (!AddItemKeyToChunk(*chunk, *item, key, item_key).Successful()) {
+      ExecuteBatchItemOneByOne(tracker, index, get_database_item);
+      continue;
+    }
+
+    // BatchGetItem rejects a key requested twice, the item is read once for
+    // all its indices.
+    auto& indices = chunk->pending_items[item_key];
+    indices.push_back(index);
+    if (indices.size() > 1) {
+      continue;
+    }
+    request_items[String(item->table_name->c_str())].AddKeys(move(key));
+    if (++chunk_key_count == kMaxBatchGetItemKeys) {
+      send_chunk();
+    }
+  }
+
+  if (chunk_key_count > 0) {
+    send_chunk();
+  }
+  tracker->FinishIfEmpty();
+  return SuccessExecutionResult();
+}
+
+void AwsDynamoDB::SendBatchGetItemRequest(
+    const shared_ptr<BatchItemsChunk<BatchGetTracker>>& chunk,
+    const BatchGetItemRequest& batch_get_item_request) noexcept {
+  auto send_request = [this, chunk, batch_get_item_request]() {
+    chunk->attempt_count++;
+    dynamo_db_client_->BatchGetItemAsync(
+        batch_get_item_request,
+        bind(&AwsDynamoDB::OnBatchGetDatabaseItemsCallback, this, chunk, _1,
+             _2, _3, _4),
+        nullptr);
+  };
+
+  if (chunk->attempt_count == 0) {
+    send_request();
+    return;
+  }
+  auto delay = kBatchRequestRetryBaseDelay * (1 << (chunk->attempt_count - 1));
+  if (!async_executor_
+           ->ScheduleFor(send_request,
+                         (TimeProvider::GetSteadyTimestampInNanoseconds() +
+                          delay)
+                             .count())
+           .Successful()) {
+    send_request();
+  }
+}
+
+void AwsDynamoDB::OnBatchGetDatabaseItemsCallback(
+    const shared_ptr<BatchItemsChunk<BatchGetTracker>>& chunk,
+    const DynamoDBClient* dynamo_db_client,
+    const BatchGetItemRequest& batch_get_item_request,
+    const Outcome<BatchGetItemResult, DynamoDBError>& outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  const auto& tracker = chunk->tracker;
+  if (!outcome.IsSuccess()) {
+    SCP_DEBUG_CONTEXT(
+        kDynamoDB, tracker->GetBatchContext(),
+        "DynamoDB batch get database items request failed. Error code: %d, "
+        "message: %s",
+        outcome.GetError().GetResponseCode(),
+        outcome.GetError().GetMessage().c_str());
+    auto execution_result =
+        AwsDynamoDBUtils::ConvertDynamoErrorToExecutionResult(
+            outcome.GetError().GetErrorType());
+    for (const auto& pending_item : chunk->pending_items) {
+      for (auto index : pending_item.second) {
+        tracker->CompleteItem(index, execution_result);
+      }
+    }
+    return;
+  }
+
+  for (const auto& table_items : outcome.GetResult().GetResponses()) {
+    auto key_names = chunk->key_names.find(table_items.first.c_str());
+    if (key_names == chunk->key_names.end()) {
+      continue;
+    }
+
+    for (const auto& item : table_items.second) {
+      string item_key;
+      if (!GetDynamoDBItemKey(key_names->first, key_names->second, item,
+                              item_key)) {
+        continue;
+      }
+      auto pending_item = chunk->pending_items.find(item_key);
+      if (pending_item == chunk->pending_items.end()) {
+        continue;
+      }
+
+      ExecutionResult execution_result = SuccessExecutionResult();
+      auto attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+      for (const auto& attribute_key_value_pair : item) {
+        if (key_names->second.first == attribute_key_value_pair.first.c_str() ||
+            key_names->second.second ==
+                attribute_key_value_pair.first.c_str()) {
+          continue;
+        }
+
+        NoSQLDatabaseValidAttributeValueTypes attribute_value;
+        execution_result = AwsDynamoDBUtils::
+            ConvertDynamoDBTypeToNoSQLDatabaseValidAttributeValueType(
+                attribute_key_value_pair.second, attribute_value);
+        if (!execution_result.Successful()) {
+          break;
+        }
+
+        NoSqlDatabaseKeyValuePair key_value_pair;
+        key_value_pair.attribute_name =
+            make_shared<string>(attribute_key_value_pair.first.c_str());
+        key_value_pair.attribute_value =
+            make_shared<NoSQLDatabaseValidAttributeValueTypes>(
+                move(attribute_value));
+        attributes->push_back(key_value_pair);
+      }
+
+      for (auto index : pending_item->second) {
+        if (!execution_result.Successful()) {
+          tracker->CompleteItem(index, execution_result);
+          continue;
+        }
+        const auto& request = tracker->GetItem(index);
+        auto response = make_shared<GetDatabaseItemResponse>();
+        response->table_name = request->table_name;
+        response->partition_key = request->partition_key;
+        response->sort_key = request->sort_key;
+        response->attributes =
+            make_shared<vector<NoSqlDatabaseKeyValuePair>>(*attributes);
+        tracker->CompleteItem(index, execution_result, response);
+      }
+      chunk->pending_items.erase(pending_item);
+    }
+  }
+
+  // The keys neither returned nor unprocessed do not exist.
+  const auto& unprocessed_keys = outcome.GetResult().GetUnprocessedKeys();
+  unordered_set<string> unprocessed_item_keys;
+  for (const auto& table_keys : unprocessed_keys) {
+    auto key_names = chunk->key_names.find(table_keys.first.c_str());
+    if (key_names == chunk->key_names.end()) {
+      continue;
+    }
+    for (const auto& key : table_keys.second.GetKeys()) {
+      string item_key;
+      if (GetDynamoDBItemKey(key_names->first, key_names->second, key,
+                             item_key)) {
+        unprocessed_item_keys.insert(move(item_key));
+      }
+    }
+  }
+
+  bool can_retry = chunk->attempt_count < kMaxBatchRequestAttempts;
+  for (auto pending_item = chunk->pending_items.begin();
+       pending_item != chunk->pending_items.end();) {
+    bool is_unprocessed = unprocessed_item_keys.count(pending_item->first) > 0;
+    if (is_unprocessed && can_retry) {
+      ++pending_item;
+      continue;
+    }
+    auto execution_result =
+        is_unprocessed
+            ? ExecutionResult(RetryExecutionResult(
+                  errors::SC_NO_SQL_DATABASE_RETRIABLE_ERROR))
+            : ExecutionResult(FailureExecutionResult(
+                  errors::SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND));
+    for (auto index : pending_item->second) {
+      tracker->CompleteItem(index, execution_result);
+    }
+    pending_item = chunk->pending_items.erase(pending_item);
+  }
+
+  if (!chunk->pending_items.empty()) {
+    BatchGetItemRequest retry_request;
+    retry_request.SetRequestItems(unprocessed_keys);
+    SendBatchGetItemRequest(chunk, retry_request);
+  }
+}
+
+ExecutionResult AwsDynamoDB::BatchUpsertDatabaseItems(
+    AsyncContext<BatchUpsertDatabaseItemsRequest,
+                 BatchUpsertDatabaseItemsResponse>&
+        batch_upsert_database_items_context) noexcept {
+  if (!batch_upsert_database_items_context.request) {
+    return FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST);
+  }
+
+  auto tracker = make_shared<BatchUpsertTracker>(
+      batch_upsert_database_items_context,
+      [this](AsyncContext<BatchUpsertDatabaseItemsRequest,
+                          BatchUpsertDatabaseItemsResponse>& batch_context) {
+        FinishBatchContext(batch_context);
+      });
+  // BatchWriteItem rejects an item written twice.
+  auto is_duplicate = FailDuplicateBatchItems(tracker);
+
+  shared_ptr<BatchItemsChunk<BatchUpsertTracker>> chunk;
+  Map<String, Vector<WriteRequest>> request_items;
+  size_t chunk_item_count = 0;
+  auto send_chunk = [&]() {
+    BatchWriteItemRequest batch_write_item_request;
+    batch_write_item_request.SetRequestItems(move(request_items));
+    SendBatchWriteItemRequest(chunk, batch_write_item_request);
+    chunk = nullptr;
+    request_items = Map<String, Vector<WriteRequest>>();
+    chunk_item_count = 0;
+  };
+
+  for (size_t index = 0; index < tracker->ItemCount(); ++index) {
+    if (is_duplicate[index]) {
+      continue;
+    }
+    const auto& item = tracker->GetItem(index);
+    if (!IsValidBatchItem(item) || !item->new_attributes ||
+        item->new_attributes->empty()) {
+      tracker->CompleteItem(
+          index,
+          FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST));
+      continue;
+    }
+
+    auto upsert_database_item =
+        [this](AsyncContext<UpsertDatabaseItemRequest,
+                            UpsertDatabaseItemResponse>& context) {
+          return UpsertDatabaseItem(context);
+        };
+    // BatchWriteItem replaces the whole item and cannot have conditions.
+    if (HasAttributeConditions(*item) || !item->replace_existing_attributes) {
+      ExecuteBatchItemOneByOne(tracker, index, upsert_database_item);
+      continue;
+    }
+
+    if (!chunk) {
+      chunk = make_shared<BatchItemsChunk<BatchUpsertTracker>>();
+      chunk->tracker = tracker;
+    }
+    Map<String, AttributeValue> put_item;
+    string item_key;
+    auto execution_result =
+        AddItemKeyToChunk(*chunk, *item, put_item, item_key);
+    for (const auto& attribute : *item->new_attributes) {
+      if (!execution_result.Successful()) {
+        break;
+      }
+      AttributeValue attribute_value;
+      execution_result = AwsDynamoDBUtils::
+          ConvertNoSQLDatabaseValidAttributeValueTypeToDynamoDBType(
+              *attribute.attribute_value, attribute_value);
+      put_item.emplace(String(attribute.attribute_name->c_str()),
+                       attribute_value);
+    }
+    if (!execution_result.Successful()) {
+      ExecuteBatchItemOneByOne(tracker, index, upsert_database_item);
+      continue;
+    }
+
+    chunk->pending_items[item_key].push_back(index);
+    PutRequest put_request;
+    put_request.SetItem(move(put_item));
+    WriteRequest write_request;
+    write_request.SetPutRequest(move(put_request));
+    request_items[String(item->table_name->c_str())].push_back(
+        move(write_request));
+    if (++chunk_item_count == kMaxBatchWriteItemRequests) {
+      send_chunk();
+    }
+  }
+
+  if (chunk_item_count > 0) {
+    send_chunk();
+  }
+  tracker->FinishIfEmpty();
+  return SuccessExecutionResult();
+}
+
+void AwsDynamoDB::SendBatchWriteItemRequest(
+    const shared_ptr<BatchItemsChunk<BatchUpsertTracker>>& chunk,
+    const BatchWriteItemRequest& batch_write_item_request) noexcept {
+  auto send_request = [this, chunk, batch_write_item_request]() {
+    chunk->attempt_count++;
+    dynamo_db_client_->BatchWriteItemAsync(
+        batch_write_item_request,
+        bind(&AwsDynamoDB::OnBatchUpsertDatabaseItemsCallback, this, chunk,
+             _1, _2, _3, _4),
+        nullptr);
+  };
+
+  if (chunk->attempt_count == 0) {
+    send_request();
+    return;
+  }
+  auto delay = kBatchRequestRetryBaseDelay * (1 << (chunk->attempt_count - 1));
+  if (!async_executor_
+           ->ScheduleFor(send_request,
+                         (TimeProvider::GetSteadyTimestampInNanoseconds() +
+                          delay)
+                             .count())
+           .Successful()) {
+    send_request();
+  }
+}
+
+void AwsDynamoDB::OnBatchUpsertDatabaseItemsCallback(
+    const shared_ptr<BatchItemsChunk<BatchUpsertTracker>>& chunk,
+    const DynamoDBClient* dynamo_db_client,
+    const BatchWriteItemRequest& batch_write_item_request,
+    const Outcome<BatchWriteItemResult, DynamoDBError>& outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  const auto& tracker = chunk->tracker;
+  if (!outcome.IsSuccess()) {
+    SCP_DEBUG_CONTEXT(
+        kDynamoDB, tracker->GetBatchContext(),
+        "DynamoDB batch upsert database items request failed. Error code: %d, "
+        "message: %s",
+        outcome.GetError().GetResponseCode(),
+        outcome.GetError().GetMessage().c_str());
+    auto execution_result =
+        AwsDynamoDBUtils::ConvertDynamoErrorToExecutionResult(
+            outcome.GetError().GetErrorType());
+    for (const auto& pending_item : chunk->pending_items) {
+      for (auto index : pending_item.second) {
+        tracker->CompleteItem(index, execution_result);
+      }
+    }
+    return;
+  }
+
+  // The items not unprocessed are written.
+  const auto& unprocessed_items = outcome.GetResult().GetUnprocessedItems();
+  unordered_set<string> unprocessed_item_keys;
+  for (const auto& table_write_requests : unprocessed_items) {
+    auto key_names = chunk->key_names.find(table_write_requests.first.c_str());
+    if (key_names == chunk->key_names.end()) {
+      continue;
+    }
+    for (const auto& write_request : table_write_requests.second) {
+      string item_key;
+      if (GetDynamoDBItemKey(key_names->first, key_names->second,
+                             write_request.GetPutRequest().GetItem(),
+                             item_key)) {
+        unprocessed_item_keys.insert(move(item_key));
+      }
+    }
+  }
+
+  bool can_retry = chunk->attempt_count < kMaxBatchRequestAttempts;
+  for (auto pending_item = chunk->pending_items.begin();
+       pending_item != chunk->pending_items.end();) {
+    bool is_unprocessed = unprocessed_item_keys.count(pending_item->first) > 0;
+    if (is_unprocessed && can_retry) {
+      ++pending_item;
+      continue;
+    }
+    for (auto index : pending_item->second) {
+      if (is_unprocessed) {
+        tracker->CompleteItem(index,
+                              RetryExecutionResult(
+                                  errors::SC_NO_SQL_DATABASE_RETRIABLE_ERROR));
+        continue;
+      }
+      const auto& request = tracker->GetItem(index);
+      auto response = make_shared<UpsertDatabaseItemResponse>();
+      response->table_name = request->table_name;
+      response->partition_key = request->partition_key;
+      response->sort_key = request->sort_key;
+      response->attributes = request->new_attributes;
+      tracker->CompleteItem(index, SuccessExecutionResult(), response);
+    }
+    pending_item = chunk->pending_items.erase(pending_item);
+  }
+
+  if (!chunk->pending_items.empty()) {
+    BatchWriteItemRequest retry_request;
+    retry_request.SetRequestItems(unprocessed_items);
+    SendBatchWriteItemRequest(chunk, retry_request);
+  }
+}
 }  // namespace google::scp::core::nosql_database_provider
@@ -19,16 +19,22 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <aws/core/Aws.h>
 #include <aws/dynamodb/DynamoDBClient.h>
 #include <aws/dynamodb/model/AttributeDefinition.h>
+#include <aws/dynamodb/model/BatchGetItemRequest.h>
+#include <aws/dynamodb/model/BatchWriteItemRequest.h>
 #include <aws/dynamodb/model/QueryRequest.h>
 #include <aws/dynamodb/model/UpdateItemRequest.h>
 
 #include "core/interface/async_executor_interface.h"
 #include "core/interface/config_provider_interface.h"
 #include "core/interface/nosql_database_provider_interface.h"
+#include "core/nosql_database_provider/src/common/batch_database_items_tracker.h"
 #include "core/nosql_database_provider/src/common/nosql_database_provider_utils.h"
 
 namespace google::scp::core::nosql_database_provider {
@@ -64,10 +70,138 @@ class AwsDynamoDB : public NoSQLDatabaseProviderInterface {
       AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>&
           upsert_database_item_context) noexcept override;
 
+  /**
+   * @copydoc NoSQLDatabaseProviderInterface::BatchGetDatabaseItems
+   *
+   * Items without attribute conditions are read with BatchGetItem, up to 100
+   * keys per request.
+   */
+  ExecutionResult BatchGetDatabaseItems(
+      AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+          batch_get_database_items_context) noexcept override;
+
+  /**
+   * @copydoc NoSQLDatabaseProviderInterface::BatchUpsertDatabaseItems
+   *
+   * Items without attribute conditions which replace the existing attributes
+   * are written with BatchWriteItem, up to 25 items per request.
+   */
+  ExecutionResult BatchUpsertDatabaseItems(
+      AsyncContext<BatchUpsertDatabaseItemsRequest,
+                   BatchUpsertDatabaseItemsResponse>&
+          batch_upsert_database_items_context) noexcept override;
+
  protected:
+  using BatchGetTracker =
+      BatchDatabaseItemsTracker<BatchGetDatabaseItemsRequest,
+                                BatchGetDatabaseItemsResponse>;
+  using BatchUpsertTracker =
+      BatchDatabaseItemsTracker<BatchUpsertDatabaseItemsRequest,
+                                BatchUpsertDatabaseItemsResponse>;
+
+  /**
+   * @brief The items of a batch sent in a single BatchGetItem or
+   * BatchWriteItem request, until all of them are processed.
+   *
+   * @tparam Tracker The tracker of the batch.
+   */
+  template <typename Tracker>
+  struct BatchItemsChunk {
+    std::shared_ptr<Tracker> tracker;
+    /// The partition key name and the sort key name, if any, of every table.
+    std::unordered_map<std::string, std::pair<std::string, std::string>>
+        key_names;
+    /// The indices of the pending items by the key of their record.
+    std::unordered_map<std::string, std::vector<size_t>> pending_items;
+    /// The number of requests sent for the chunk.
+    size_t attempt_count = 0;
+  };
+
   /// Creates ClientConfig to create DynamoDbClient.
   virtual ExecutionResult CreateClientConfig() noexcept;
 
+  /**
+   * @brief Sends the BatchGetItem request of the chunk.
+   *
+   * @param chunk The chunk of the batch.
+   * @param batch_get_item_request The request with the keys not processed
+   * yet.
+   */
+  virtual void SendBatchGetItemRequest(
+      const std::shared_ptr<BatchItemsChunk<BatchGetTracker>>& chunk,
+      const Aws::DynamoDB::Model::BatchGetItemRequest&
+          batch_get_item_request) noexcept;
+
+  /**
+   * @brief Is called when the response of batch get item request is ready.
+   * Completes the items read or not found, and retries the unprocessed keys.
+   *
+   * @param chunk The chunk of the batch.
+   * @param dynamo_db_client An instance of the dynamo db client.
+   * @param batch_get_item_request The batch get item request object.
+   * @param outcome The outcome of the operation.
+   * @param async_context The async context of the sender. This is not used
+   * based on SCP architecture.
+   */
+  virtual void OnBatchGetDatabaseItemsCallback(
+      const std::shared_ptr<BatchItemsChunk<BatchGetTracker>>& chunk,
+      const Aws::DynamoDB::DynamoDBClient* dynamo_db_client,
+      const Aws::DynamoDB::Model::BatchGetItemRequest& batch_get_item_request,
+      const Aws::Utils::Outcome<Aws::DynamoDB::Model::BatchGetItemResult,
+                                Aws::DynamoDB::DynamoDBError>& outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
+  /**
+   * @brief Sends the BatchWriteItem request of the chunk.
+   *
+   * @param chunk The chunk of the batch.
+   * @param batch_write_item_request The request with the items not processed
+   * yet.
+   */
+  virtual void SendBatchWriteItemRequest(
+      const std::shared_ptr<BatchItemsChunk<BatchUpsertTracker>>& chunk,
+      const Aws::DynamoDB::Model::BatchWriteItemRequest&
+          batch_write_item_request) noexcept;
+
+  /**
+   * @brief Is called when the response of batch write item request is ready.
+   * Completes the items written, and retries the unprocessed items.
+   *
+   * @param chunk The chunk of the batch.
+   * @param dynamo_db_client An instance of the dynamo db client.
+   * @param batch_write_item_request The batch write item request object.
+   * @param outcome The outcome of the operation.
+   * @param async_context The async context of the sender. This is not used
+   * based on SCP architecture.
+   */
+  virtual void OnBatchUpsertDatabaseItemsCallback(
+      const std::shared_ptr<BatchItemsChunk<BatchUpsertTracker>>& chunk,
+      const Aws::DynamoDB::DynamoDBClient* dynamo_db_client,
+      const Aws::DynamoDB::Model::BatchWriteItemRequest&
+          batch_write_item_request,
+      const Aws::Utils::Outcome<Aws::DynamoDB::Model::BatchWriteItemResult,
+                                Aws::DynamoDB::DynamoDBError>& outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
+  /**
+   * @brief Builds the DynamoDB key of the item and the string identifying it
+   * in the chunk, and records the key names of its table.
+   *
+   * @return ExecutionResult Failure if the key cannot be converted or the
+   * table has other key names in the chunk.
+   */
+  template <typename Tracker>
+  static ExecutionResult AddItemKeyToChunk(
+      BatchItemsChunk<Tracker>& chunk, const SingleDatabaseItemRequest& item,
+      Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>& key,
+      std::string& item_key) noexcept;
+
+  /// Schedules the completion of the batch context on the async executor.
+  template <typename BatchContext>
+  void FinishBatchContext(BatchContext& batch_context) noexcept;
+
   /**
    * @brief Is called when the response of query item request is ready.
    *
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/nosql_database_provider_interface.h"
+#include "core/nosql_database_provider/src/common/error_codes.h"
+
+namespace google::scp::core::nosql_database_provider {
+/**
+ * @brief Collects the results of the items of a batch operation, which may
+ * complete in any order and on any thread, and finishes the batch context
+ * once all the items are complete.
+ *
+ * @tparam BatchRequest The batch request type.
+ * @tparam BatchResponse The batch response type.
+ */
+template <typename BatchRequest, typename BatchResponse>
+class BatchDatabaseItemsTracker {
+ public:
+  using BatchContext = AsyncContext<BatchRequest, BatchResponse>;
+  using ItemRequest = typename std::remove_reference_t<decltype(
+      std::declval<BatchRequest>().items)>::value_type::element_type;
+  using ItemResponse = typename std::remove_reference_t<decltype(
+      std::declval<BatchResponse>().items)>::value_type::element_type;
+
+  /**
+   * @brief Constructs a new tracker for the items of the batch.
+   *
+   * @param batch_context The context of the batch operation.
+   * @param finish_batch Finishes the batch context once all the items are
+   * complete, e.g. on an async executor.
+   */
+  BatchDatabaseItemsTracker(const BatchContext& batch_context,
+                            std::function<void(BatchContext&)> finish_batch)
+      : batch_context_(batch_context),
+        finish_batch_(std::move(finish_batch)),
+        item_count_(batch_context.request->items.size()),
+        pending_item_count_(item_count_),
+        is_item_complete_(
+            std::make_unique<std::atomic<bool>[]>(item_count_)) {
+    batch_context_.response = std::make_shared<BatchResponse>();
+    batch_context_.response->item_results.resize(
+        item_count_,
+        FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST));
+    batch_context_.response->items.resize(item_count_);
+    for (size_t i = 0; i < item_count_; ++i) {
+      is_item_complete_[i] = false;
+    }
+  }
+
+  /// Returns the number of items in the batch.
+  size_t ItemCount() const noexcept { return item_count_; }
+
+  /// Returns the request of the item.
+  const std::shared_ptr<ItemRequest>& GetItem(size_t index) const noexcept {
+    return batch_context_.request->items[index];
+  }
+
+  /// Returns the batch context, e.g. to log with its ids.
+  const BatchContext& GetBatchContext() const noexcept {
+    return batch_context_;
+  }
+
+  /**
+   * @brief Records the result of the item, only the first completion of an
+   * item counts. Finishes the batch context once all the items are complete.
+   *
+   * @param index The index of the item in the batch request.
+   * @param result The result of the item.
+   * @param response The response of the item, if successful.
+   */
+  void CompleteItem(size_t index, const ExecutionResult& result,
+                    std::shared_ptr<ItemResponse> response = nullptr) noexcept {
+    if (is_item_complete_[index].exchange(true)) {
+      return;
+    }
+
+    // Every index is written by a single thread, and the release of the
+    // decrement below publishes it to the thread finishing the batch.
+    batch_context_.response->item_results[index] = result;
+    batch_context_.response->items[index] = std::move(response);
+    if (pending_item_count_.fetch_sub(1) == 1) {
+      batch_context_.result = SuccessExecutionResult();
+      finish_batch_(batch_context_);
+    }
+  }
+
+  /// Finishes the batch context right away if it has no items.
+  void FinishIfEmpty() noexcept {
+    if (item_count_ == 0) {
+      batch_context_.result = SuccessExecutionResult();
+      finish_batch_(batch_context_);
+    }
+  }
+
+ private:
+  BatchContext batch_context_;
+  const std::function<void(BatchContext&)> finish_batch_;
+  const size_t item_count_;
+  std::atomic<size_t> pending_item_count_;
+  std::unique_ptr<std::atomic<bool>[]> is_item_complete_;
+};
+
+/**
+ * @brief Executes an item of a batch with the single item operation of the
+ * provider, e.g. for the items which cannot be batched by the database, and
+ * records its result on the tracker.
+ *
+ * @param tracker The tracker of the batch.
+ * @param index The index of the item in the batch request.
+ * @param operation The single item operation, e.g. GetDatabaseItem.
+ */
+template <typename Tracker>
+void ExecuteBatchItemOneByOne(
+    const std::shared_ptr<Tracker>& tracker, size_t index,
+    const std::function<ExecutionResult(
+        AsyncContext<typename Tracker::ItemRequest,
+                     typename Tracker::ItemResponse>&)>& operation) noexcept {
+  AsyncContext<typename Tracker::ItemRequest, typename Tracker::ItemResponse>
+      item_context(
+          tracker->GetItem(index),
+          [tracker, index](AsyncContext<typename Tracker::ItemRequest,
+                                        typename Tracker::ItemResponse>&
+                               item_context) {
+            tracker->CompleteItem(index, item_context.result,
+                                  item_context.response);
+          },
+          tracker->GetBatchContext());
+  // Operations may or may not finish the context when failing synchronously.
+  // Only the first completion of an item counts, so both are fine.
+  auto execution_result = operation(item_context);
+  if (!execution_result.Successful()) {
+    tracker->CompleteItem(index, execution_result);
+  }
+}
+
+/// Returns true if the item has a table name and a partition key.
+inline bool IsValidBatchItem(
+    const std::shared_ptr<SingleDatabaseItemRequest>& item) noexcept {
+  return item && item->table_name && item->partition_key &&
+         item->partition_key->attribute_name &&
+         item->partition_key->attribute_value &&
+         (!item->sort_key || (item->sort_key->attribute_name &&
+                              item->sort_key->attribute_value));
+}
+
+/// Returns true if the item has attribute conditions.
+inline bool HasAttributeConditions(
+    const SingleDatabaseItemRequest& item) noexcept {
+  return item.attributes && !item.attributes->empty();
+}
+
+/**
+ * @brief Returns a string identifying the table and keys of the item, which is
+ * equal for two items if and only if they refer to the same record.
+ */
+inline std::string GetBatchItemKey(
+    const SingleDatabaseItemRequest& item) noexcept {
+  auto append_value = [](std::string& key,
+                         const std::shared_ptr<NoSqlDatabaseKeyValuePair>&
+                             key_value_pair) {
+    key += '\0';
+    if (!key_value_pair || !key_value_pair->attribute_value) {
+      return;
+    }
+    const auto& value = *key_value_pair->attribute_value;
+    // The type index keeps the int 1 and the string "1" apart.
+    key += std::to_string(value.index());
+    key += ':';
+    std::visit(
+        [&key](const auto& typed_value) {
+          if constexpr (std::is_same_v<std::decay_t<decltype(typed_value)>,
+                                       std::string>) {
+            key += typed_value;
+          } else {
+            key += std::to_string(typed_value);
+          }
+        },
+        value);
+  };
+
+  std::string key = item.table_name ? *item.table_name : "";
+  append_value(key, item.partition_key);
+  append_value(key, item.sort_key);
+  return key;
+}
+
+/**
+ * @brief Fails the items of the batch which refer to the same record as an
+ * earlier item, since databases do not define which write wins.
+ *
+ * @param tracker The tracker of the batch.
+ * @return std::vector<bool> Whether each item was failed as a duplicate.
+ */
+template <typename Tracker>
+std::vector<bool> FailDuplicateBatchItems(
+    const std::shared_ptr<Tracker>& tracker) noexcept {
+  std::vector<bool> is_duplicate(tracker->ItemCount(), false);
+  std::unordered_set<std::string> keys;
+  for (size_t i = 0; i < tracker->ItemCount(); ++i) {
+    // Invalid items are left to the provider to fail.
+    if (!tracker->GetItem(i)) {
+      continue;
+    }
+    if (!keys.insert(GetBatchItemKey(*tracker->GetItem(i))).second) {
+      is_duplicate[i] = true;
+    }
+  }
+  for (size_t i = 0; i < tracker->ItemCount(); ++i) {
+    if (is_duplicate[i]) {
+      tracker->CompleteItem(
+          i, FailureExecutionResult(
+                 errors::SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM));
+    }
+  }
+  return is_duplicate;
+}
+}  // namespace google::scp::core::nosql_database_provider
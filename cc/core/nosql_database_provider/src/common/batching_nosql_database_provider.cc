@@ -0,0 +1,185 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "batching_nosql_database_provider.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "error_codes.h"
+
+using std::bind;
+using std::lock_guard;
+using std::make_shared;
+using std::min;
+using std::shared_ptr;
+using std::vector;
+using std::placeholders::_1;
+
+namespace google::scp::core::nosql_database_provider {
+BatchingNoSQLDatabaseProvider::BatchingNoSQLDatabaseProvider(
+    const shared_ptr<NoSQLDatabaseProviderInterface>& nosql_database_provider,
+    size_t upsert_batch_size)
+    : nosql_database_provider_(nosql_database_provider),
+      upsert_batch_size_(upsert_batch_size),
+      is_upsert_batch_in_flight_(false) {}
+
+ExecutionResult BatchingNoSQLDatabaseProvider::Init() noexcept {
+  return nosql_database_provider_->Init();
+}
+
+ExecutionResult BatchingNoSQLDatabaseProvider::Run() noexcept {
+  return nosql_database_provider_->Run();
+}
+
+ExecutionResult BatchingNoSQLDatabaseProvider::Stop() noexcept {
+  return nosql_database_provider_->Stop();
+}
+
+ExecutionResult BatchingNoSQLDatabaseProvider::GetDatabaseItem(
+    AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>&
+        get_database_item_context) noexcept {
+  return nosql_database_provider_->GetDatabaseItem(get_database_item_context);
+}
+
+ExecutionResult BatchingNoSQLDatabaseProvider::UpsertDatabaseItem(
+    AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>&
+        upsert_database_item_context) noexcept {
+  // Upserts with attribute conditions, or which keep the existing attributes,
+  // would be sent one by one by the provider anyway.
+  const auto& request = upsert_database_item_context.request;
+  if (upsert_batch_size_ <= 1 || !request ||
+      !request->replace_existing_attributes ||
+      (request->attributes && !request->attributes->empty())) {
+    return nosql_database_provider_->UpsertDatabaseItem(
+        upsert_database_item_context);
+  }
+
+  {
+    lock_guard lock(pending_upsert_contexts_mutex_);
+    pending_upsert_contexts_.push_back(upsert_database_item_context);
+    if (is_upsert_batch_in_flight_) {
+      return SuccessExecutionResult();
+    }
+    is_upsert_batch_in_flight_ = true;
+  }
+
+  SendPendingUpsertBatches();
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BatchingNoSQLDatabaseProvider::BatchGetDatabaseItems(
+    AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+        batch_get_database_items_context) noexcept {
+  return nosql_database_provider_->BatchGetDatabaseItems(
+      batch_get_database_items_context);
+}
+
+ExecutionResult BatchingNoSQLDatabaseProvider::BatchUpsertDatabaseItems(
+    AsyncContext<BatchUpsertDatabaseItemsRequest,
+                 BatchUpsertDatabaseItemsResponse>&
+        batch_upsert_database_items_context) noexcept {
+  return nosql_database_provider_->BatchUpsertDatabaseItems(
+      batch_upsert_database_items_context);
+}
+
+void BatchingNoSQLDatabaseProvider::SendPendingUpsertBatches() noexcept {
+  while (true) {
+    vector<UpsertDatabaseItemContext> upsert_contexts;
+    {
+      lock_guard lock(pending_upsert_contexts_mutex_);
+      if (pending_upsert_contexts_.empty()) {
+        is_upsert_batch_in_flight_ = false;
+        return;
+      }
+
+      auto batch_size =
+          min(pending_upsert_contexts_.size(), upsert_batch_size_);
+      upsert_contexts.assign(pending_upsert_contexts_.begin(),
+                             pending_upsert_contexts_.begin() + batch_size);
+      pending_upsert_contexts_.erase(
+          pending_upsert_contexts_.begin(),
+          pending_upsert_contexts_.begin() + batch_size);
+    }
+
+    AsyncContext<BatchUpsertDatabaseItemsRequest,
+                 BatchUpsertDatabaseItemsResponse>
+        batch_context(
+            make_shared<BatchUpsertDatabaseItemsRequest>(),
+            bind(&BatchingNoSQLDatabaseProvider::
+                     OnBatchUpsertDatabaseItemsCallback,
+                 this, upsert_contexts, _1),
+            upsert_contexts.front());
+    for (const auto& upsert_context : upsert_contexts) {
+      batch_context.request->items.push_back(upsert_context.request);
+    }
+
+    auto execution_result =
+        nosql_database_provider_->BatchUpsertDatabaseItems(batch_context);
+    if (execution_result.Successful()) {
+      // The callback of the batch sends the next one.
+      return;
+    }
+    for (auto& upsert_context : upsert_contexts) {
+      upsert_context.result = execution_result;
+      upsert_context.Finish();
+    }
+  }
+}
+
+void BatchingNoSQLDatabaseProvider::OnBatchUpsertDatabaseItemsCallback(
+    const vector<UpsertDatabaseItemContext>& upsert_contexts,
+    AsyncContext<BatchUpsertDatabaseItemsRequest,
+                 BatchUpsertDatabaseItemsResponse>& batch_context) noexcept {
+  auto contexts = upsert_contexts;
+  if (!batch_context.result.Successful() || !batch_context.response ||
+      batch_context.response->item_results.size() != contexts.size() ||
+      batch_context.response->items.size() != contexts.size()) {
+    auto execution_result = batch_context.result.Successful()
+                                ? FailureExecutionResult(SC_UNKNOWN)
+                                : batch_context.result;
+    for (auto& context : contexts) {
+      context.result = execution_result;
+      context.Finish();
+    }
+  } else {
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      auto& item_result = batch_context.response->item_results[i];
+      // An item upserted twice in a batch is upserted again on its own, now
+      // that the earlier upsert is complete.
+      if (item_result == FailureExecutionResult(
+                             errors::SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM)) {
+        auto execution_result =
+            nosql_database_provider_->UpsertDatabaseItem(contexts[i]);
+        if (execution_result.Successful()) {
+          continue;
+        }
+        item_result = execution_result;
+      }
+      contexts[i].result = item_result;
+      if (contexts[i].result.Successful()) {
+        contexts[i].response = batch_context.response->items[i];
+      }
+      contexts[i].Finish();
+    }
+  }
+
+  SendPendingUpsertBatches();
+}
+}  // namespace google::scp::core::nosql_database_provider
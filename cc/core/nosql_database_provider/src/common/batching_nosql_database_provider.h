@@ -0,0 +1,109 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/nosql_database_provider_interface.h"
+
+namespace google::scp::core::nosql_database_provider {
+/**
+ * @copydoc NoSQLDatabaseProviderInterface
+ *
+ * Sends the upserts which replace all the attributes of an item, e.g. the
+ * write-backs of evicted budget key timeframes, to the wrapped provider with
+ * BatchUpsertDatabaseItems. One batch is in flight at a time, and the upserts
+ * which arrive meanwhile are sent together in the next batch, so the batches
+ * grow with the load without delaying the upserts when the load is low. All
+ * the other operations are forwarded as they are.
+ */
+class BatchingNoSQLDatabaseProvider : public NoSQLDatabaseProviderInterface {
+ public:
+  /**
+   * @brief Constructs a new Batching NoSQL Database Provider object.
+   *
+   * @param nosql_database_provider The provider to send the operations to. Its
+   * lifecycle is managed by this object.
+   * @param upsert_batch_size The maximum number of upserts sent in a batch.
+   * Upserts are forwarded one by one if this is 1.
+   */
+  BatchingNoSQLDatabaseProvider(
+      const std::shared_ptr<NoSQLDatabaseProviderInterface>&
+          nosql_database_provider,
+      size_t upsert_batch_size);
+
+  ExecutionResult Init() noexcept override;
+
+  ExecutionResult Run() noexcept override;
+
+  ExecutionResult Stop() noexcept override;
+
+  ExecutionResult GetDatabaseItem(
+      AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>&
+          get_database_item_context) noexcept override;
+
+  ExecutionResult UpsertDatabaseItem(
+      AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>&
+          upsert_database_item_context) noexcept override;
+
+  ExecutionResult BatchGetDatabaseItems(
+      AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+          batch_get_database_items_context) noexcept override;
+
+  ExecutionResult BatchUpsertDatabaseItems(
+      AsyncContext<BatchUpsertDatabaseItemsRequest,
+                   BatchUpsertDatabaseItemsResponse>&
+          batch_upsert_database_items_context) noexcept override;
+
+ protected:
+  using UpsertDatabaseItemContext =
+      AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>;
+
+  /**
+   * @brief Sends the pending upserts in batches of up to upsert_batch_size_,
+   * one batch at a time.
+   */
+  virtual void SendPendingUpsertBatches() noexcept;
+
+  /**
+   * @brief Is called when a batch of upserts completes.
+   *
+   * @param upsert_contexts The upserts of the batch.
+   * @param batch_context The context of the batch operation.
+   */
+  virtual void OnBatchUpsertDatabaseItemsCallback(
+      const std::vector<UpsertDatabaseItemContext>& upsert_contexts,
+      AsyncContext<BatchUpsertDatabaseItemsRequest,
+                   BatchUpsertDatabaseItemsResponse>& batch_context) noexcept;
+
+  /// The provider the operations are sent to.
+  const std::shared_ptr<NoSQLDatabaseProviderInterface>
+      nosql_database_provider_;
+  /// The maximum number of upserts in a batch.
+  const size_t upsert_batch_size_;
+  /// Mutex to protect the pending upserts.
+  std::mutex pending_upsert_contexts_mutex_;
+  /// The upserts waiting for the batch in flight to complete.
+  std::deque<UpsertDatabaseItemContext> pending_upsert_contexts_;
+  /// Whether a batch of upserts is in flight.
+  bool is_upsert_batch_in_flight_;
+};
+}  // namespace google::scp::core::nosql_database_provider
@@ -71,4 +71,10 @@ DEFINE_ERROR_CODE(SC_NO_SQL_DATABASE_PROVIDER_RECORD_CORRUPTED,
                   "NoSQL Database record corrupted.",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM,
+                  SC_NO_SQL_DATABASE_PROVIDER, 0x000B,
+                  "The NoSQL Database item appears more than once in the "
+                  "batch.",
+                  HttpStatusCode::BAD_REQUEST)
+
 }  // namespace google::scp::core::errors
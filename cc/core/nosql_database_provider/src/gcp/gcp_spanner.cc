@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -27,6 +28,7 @@
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "core/async_executor/src/async_executor.h"
 #include "core/common/time_provider/src/time_provider.h"
 #include "core/interface/async_context.h"
 #include "core/interface/configuration_keys.h"
@@ -44,6 +46,8 @@ using google::cloud::spanner::Database;
 using SpannerJson = google::cloud::spanner::Json;
 using google::cloud::StatusOr;
 using google::cloud::spanner::ExponentialBackoffPolicy;
+using google::cloud::spanner::Key;
+using google::cloud::spanner::KeySet;
 using google::cloud::spanner::LimitedTimeTransactionRerunPolicy;
 using google::cloud::spanner::MakeConnection;
 using google::cloud::spanner::Mutation;
@@ -52,6 +56,7 @@ using google::cloud::spanner::RowStream;
 using google::cloud::spanner::SqlStatement;
 using google::cloud::spanner::Transaction;
 using google::cloud::spanner::Value;
+using google::scp::core::AsyncExecutor;
 using google::scp::core::FinishContext;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::common ::TimeProvider;
@@ -61,6 +66,7 @@ using std::chrono::duration_cast;
 using std::chrono::milliseconds;
 using json = nlohmann::json;
 using google::cloud::spanner::MakeInsertOrUpdateMutation;
+using std::ostringstream;
 using std::bind;
 using std::make_pair;
 using std::make_shared;
@@ -91,6 +97,13 @@ constexpr std::chrono::milliseconds kTransactionRetryBackOffDurationInMs =
 
 constexpr double kTransactionRetryBackoffMultiplier = 2.0;
 
+constexpr size_t kDefaultSpannerCallExecutorQueueCap = 100000;
+
+// Limits on the keys of a batch Read and the mutations of a batch Commit,
+// well below the limits of Spanner on the size of a request.
+constexpr size_t kMaxBatchReadKeys = 1000;
+constexpr size_t kMaxBatchUpsertRows = 1000;
+
 // Returns success if the partition and sort key in req match the stored
 // values in table_name_to_keys. Returns success if table_name_to_keys is
 // not present.
@@ -128,6 +141,75 @@ ExecutionResult ValidatePartitionAndSortKey(
   return SuccessExecutionResult();
 }
 
+// Returns true if the keys of the request are the primary key of a table in
+// table_name_to_keys, in which case the item can be read and written by key
+// rather than with a query. Must be called after ValidatePartitionAndSortKey.
+template <typename Request>
+bool IsPrimaryKeyRequest(
+    const unordered_map<string, pair<string, optional<string>>>*
+        table_name_to_keys,
+    const Request& req) {
+  return table_name_to_keys &&
+         table_name_to_keys->find(*req.table_name) != table_name_to_keys->end();
+}
+
+// Builds the primary key of the row of the request.
+ExecutionResult BuildPrimaryKey(const SingleDatabaseItemRequest& req,
+                                Key& key) {
+  Value spanner_key_val;
+  RETURN_IF_FAILURE(
+      GcpSpannerUtils::ConvertNoSQLDatabaseAttributeValueTypeToSpannerValue(
+          *req.partition_key->attribute_value, spanner_key_val));
+  key.push_back(move(spanner_key_val));
+  const auto& sort_key = req.sort_key;
+  if (sort_key && sort_key->attribute_name &&
+      !sort_key->attribute_name->empty()) {
+    RETURN_IF_FAILURE(
+        GcpSpannerUtils::ConvertNoSQLDatabaseAttributeValueTypeToSpannerValue(
+            *sort_key->attribute_value, spanner_key_val));
+    key.push_back(move(spanner_key_val));
+  }
+  return SuccessExecutionResult();
+}
+
+// Returns a string identifying the row with the first key_size values as
+// its primary key, to match the rows of a batch Read with the requests.
+string GetRowKey(const vector<Value>& values, size_t key_size) {
+  ostringstream row_key;
+  for (size_t i = 0; i < key_size && i < values.size(); ++i) {
+    row_key << values[i] << '\0';
+  }
+  return row_key.str();
+}
+
+// Populates attributes from all of the elements of the JSON Value column.
+ExecutionResult ConvertValueColumnToAttributes(
+    const string& value, vector<NoSqlDatabaseKeyValuePair>& attributes) {
+  json value_json;
+  try {
+    value_json = json::parse(value);
+  } catch (...) {
+    return FailureExecutionResult(
+        errors::SC_NO_SQL_DATABASE_JSON_FAILED_TO_PARSE);
+  }
+
+  for (auto& [json_attr_name, json_attr_value] : value_json.items()) {
+    auto attr_value = make_shared<NoSQLDatabaseValidAttributeValueTypes>();
+    if (!GcpSpannerUtils::ConvertJsonTypeToNoSQLDatabaseValidAttributeValueType(
+             json_attr_value, *attr_value)
+             .Successful()) {
+      // If conversion fails, it is likely a list, struct, or other
+      // unsupported type. Continue without failing.
+      // TODO Log this?
+      continue;
+    }
+    NoSqlDatabaseKeyValuePair& key_value_pair = attributes.emplace_back();
+    key_value_pair.attribute_name = make_shared<string>(json_attr_name);
+    key_value_pair.attribute_value = attr_value;
+  }
+  return SuccessExecutionResult();
+}
+
 // Given attributes, adds a condition to out to match a member in the Value
 // column to the attribute. Also adds these parameters to params.
 // All members of attributes are assumed to be nested inside of the Value
@@ -179,6 +261,20 @@ ExecutionResult GcpSpanner::Init() noexcept {
 
   CreateSpanner(project, instance, database);
 
+  // The Spanner client only has blocking calls, each holding a thread until
+  // it returns. Running them on a dedicated executor keeps them from
+  // starving the IO executor; it does not make them any less blocking.
+  size_t thread_count = 0;
+  if (config_provider_->Get(kSpannerCallExecutorThreadCount, thread_count)
+          .Successful() &&
+      thread_count > 0) {
+    size_t queue_cap = kDefaultSpannerCallExecutorQueueCap;
+    config_provider_->Get(kSpannerCallExecutorQueueCap, queue_cap);
+    spanner_call_executor_ =
+        make_shared<AsyncExecutor>(thread_count, queue_cap);
+    RETURN_IF_FAILURE(spanner_call_executor_->Init());
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -190,10 +286,16 @@ void GcpSpanner::CreateSpanner(const std::string& project,
 }
 
 ExecutionResult GcpSpanner::Run() noexcept {
+  if (spanner_call_executor_) {
+    return spanner_call_executor_->Run();
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult GcpSpanner::Stop() noexcept {
+  if (spanner_call_executor_) {
+    return spanner_call_executor_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
@@ -239,6 +341,64 @@ void GcpSpanner::GetDatabaseItemAsync(
     return;
   }
 
+  FinishGetDatabaseItem(get_database_item_context, string(*spanner_json_or));
+}
+
+void GcpSpanner::GetDatabaseItemByKeyAsync(
+    AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>
+        get_database_item_context,
+    Key key) noexcept {
+  Client spanner_client(*spanner_client_shared_);
+  auto rows = spanner_client.Read(
+      *get_database_item_context.request->table_name,
+      KeySet().AddKey(move(key)), {kValueColumnName});
+
+  auto row_it = rows.begin();
+  if (row_it == rows.end() || !row_it->ok()) {
+    ExecutionResult result = FailureExecutionResult(
+        errors::SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND);
+    if (row_it != rows.end()) {
+      result = GcpSpannerUtils::ConvertCloudSpannerErrorToExecutionResult(
+          row_it->status().code());
+      SCP_ERROR_CONTEXT(
+          kGcpSpanner, get_database_item_context, result,
+          absl::StrFormat(
+              "Spanner read database item request failed. Error code: %d, "
+              "message: %s",
+              row_it->status().code(), row_it->status().message()));
+    }
+    FinishContext(result, get_database_item_context, async_executor_,
+                  async_execution_priority_);
+    return;
+  }
+
+  // The Value column may be NULL, which is read as an empty JSON like the
+  // IFNULL of the query path.
+  const auto spanner_json_or =
+      row_it->value().get<optional<SpannerJson>>(kValueColumnIndex);
+  if (!spanner_json_or.ok()) {
+    auto result = GcpSpannerUtils::ConvertCloudSpannerErrorToExecutionResult(
+        spanner_json_or.status().code());
+    SCP_ERROR_CONTEXT(
+        kGcpSpanner, get_database_item_context, result,
+        absl::StrFormat("Spanner get JSON Value column failed. Error code: %d, "
+                        "message: %s",
+                        spanner_json_or.status().code(),
+                        spanner_json_or.status().message()));
+    FinishContext(result, get_database_item_context, async_executor_,
+                  async_execution_priority_);
+    return;
+  }
+
+  FinishGetDatabaseItem(
+      get_database_item_context,
+      spanner_json_or->has_value() ? string(**spanner_json_or) : "{}");
+}
+
+void GcpSpanner::FinishGetDatabaseItem(
+    AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>&
+        get_database_item_context,
+    const string& value) noexcept {
   get_database_item_context.response = make_shared<GetDatabaseItemResponse>();
   get_database_item_context.response->table_name =
       get_database_item_context.request->table_name;
@@ -249,34 +409,14 @@ void GcpSpanner::GetDatabaseItemAsync(
   get_database_item_context.response->attributes =
       make_shared<vector<NoSqlDatabaseKeyValuePair>>();
 
-  json value_json;
-  try {
-    value_json = json::parse(string(*spanner_json_or));
-  } catch (...) {
-    FinishContext(
-        FailureExecutionResult(errors::SC_NO_SQL_DATABASE_JSON_FAILED_TO_PARSE),
-        get_database_item_context, async_executor_, async_execution_priority_);
+  if (auto execution_result = ConvertValueColumnToAttributes(
+          value, *get_database_item_context.response->attributes);
+      !execution_result.Successful()) {
+    FinishContext(execution_result, get_database_item_context,
+                  async_executor_, async_execution_priority_);
     return;
   }
 
-  // Populate response attributes from all of the elements in the Value
-  // column.
-  for (auto& [json_attr_name, json_attr_value] : value_json.items()) {
-    auto attr_value = make_shared<NoSQLDatabaseValidAttributeValueTypes>();
-    if (!GcpSpannerUtils::ConvertJsonTypeToNoSQLDatabaseValidAttributeValueType(
-             json_attr_value, *attr_value)
-             .Successful()) {
-      // If conversion fails, it is likely a list, struct, or other
-      // unsupported type. Continue without failing.
-      // TODO Log this?
-      continue;
-    }
-    NoSqlDatabaseKeyValuePair& key_value_pair =
-        get_database_item_context.response->attributes->emplace_back();
-    key_value_pair.attribute_name = make_shared<string>(json_attr_name);
-    key_value_pair.attribute_value = attr_value;
-  }
-
   // Executed on non-IO pool to keep it separate from IO aspects.
   FinishContext(SuccessExecutionResult(), get_database_item_context,
                 async_executor_, async_execution_priority_);
@@ -290,6 +430,28 @@ ExecutionResult GcpSpanner::GetDatabaseItem(
       !execution_result.Successful()) {
     return execution_result;
   }
+
+  // Without attribute conditions, a lookup on the primary key does not need a
+  // query.
+  const auto& attributes = get_database_item_context.request->attributes;
+  if ((!attributes || attributes->empty()) &&
+      IsPrimaryKeyRequest(table_name_to_keys_.get(),
+                          *get_database_item_context.request)) {
+    Key key;
+    RETURN_IF_FAILURE(BuildPrimaryKey(*get_database_item_context.request, key));
+
+    if (auto schedule_result = GetSpannerCallExecutor().Schedule(
+            bind(&GcpSpanner::GetDatabaseItemByKeyAsync, this,
+                 get_database_item_context, move(key)),
+            io_async_execution_priority_);
+        !schedule_result.Successful()) {
+      get_database_item_context.result = schedule_result;
+      get_database_item_context.Finish();
+      return schedule_result;
+    }
+    return SuccessExecutionResult();
+  }
+
   // Build a query like:
   // SELECT IFNULL(Value, JSON '{}')
   // FROM BudgetKeys
@@ -342,7 +504,7 @@ ExecutionResult GcpSpanner::GetDatabaseItem(
     return execution_result;
   }
 
-  if (auto schedule_result = io_async_executor_->Schedule(
+  if (auto schedule_result = GetSpannerCallExecutor().Schedule(
           bind(&GcpSpanner::GetDatabaseItemAsync, this,
                get_database_item_context, move(query), move(params)),
           io_async_execution_priority_);
@@ -488,17 +650,24 @@ Mutations GcpSpanner::UpsertFunctor(
     return Mutations{};
   }
 
+  return Mutations{BuildInsertOrUpdateMutation(
+      table_name, upsert_select_options, move(spanner_json))};
+}
+
+Mutation GcpSpanner::BuildInsertOrUpdateMutation(
+    const string& table_name, const UpsertSelectOptions& upsert_select_options,
+    optional<SpannerJson> value) {
   if (upsert_select_options.sort_key_val.get<string>().ok()) {
     // Include the sort_key column value.
-    return Mutations{MakeInsertOrUpdateMutation(
+    return MakeInsertOrUpdateMutation(
         table_name, upsert_select_options.column_names,
         upsert_select_options.partition_key_val,
-        upsert_select_options.sort_key_val, Value(spanner_json))};
-  } else {
-    return Mutations{MakeInsertOrUpdateMutation(
-        table_name, upsert_select_options.column_names,
-        upsert_select_options.partition_key_val, Value(spanner_json))};
+        upsert_select_options.sort_key_val, Value(move(value)));
   }
+  return MakeInsertOrUpdateMutation(table_name,
+                                    upsert_select_options.column_names,
+                                    upsert_select_options.partition_key_val,
+                                    Value(move(value)));
 }
 
 void GcpSpanner::UpsertDatabaseItemAsync(
@@ -544,6 +713,38 @@ void GcpSpanner::UpsertDatabaseItemAsync(
                 async_executor_, async_execution_priority_);
 }
 
+void GcpSpanner::BlindUpsertDatabaseItemAsync(
+    AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
+        upsert_database_item_context,
+    UpsertSelectOptions upsert_select_options,
+    nlohmann::json new_attributes) noexcept {
+  Client client(*spanner_client_shared_);
+
+  optional<SpannerJson> spanner_json;
+  if (!new_attributes.empty()) {
+    spanner_json = SpannerJson(new_attributes.dump());
+  }
+
+  const auto& table_name = *upsert_database_item_context.request->table_name;
+  auto commit_result_or = client.Commit(Mutations{BuildInsertOrUpdateMutation(
+      table_name, upsert_select_options, move(spanner_json))});
+  if (!commit_result_or.ok()) {
+    auto result = GcpSpannerUtils::ConvertCloudSpannerErrorToExecutionResult(
+        commit_result_or.status().code());
+    SCP_ERROR_CONTEXT(
+        kGcpSpanner, upsert_database_item_context, result,
+        absl::StrFormat("Spanner upsert mutation failed. Error code: %d, "
+                        "message: %s",
+                        commit_result_or.status().code(),
+                        commit_result_or.status().message()));
+    FinishContext(result, upsert_database_item_context, async_executor_,
+                  async_execution_priority_);
+    return;
+  }
+  FinishContext(SuccessExecutionResult(), upsert_database_item_context,
+                async_executor_, async_execution_priority_);
+}
+
 ExecutionResult GcpSpanner::UpsertDatabaseItem(
     AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>&
         upsert_database_item_context) noexcept {
@@ -582,7 +783,27 @@ ExecutionResult GcpSpanner::UpsertDatabaseItem(
     }
   }
 
-  if (auto schedule_result = io_async_executor_->Schedule(
+  // Without attribute conditions, a record which is replaced as a whole is
+  // written with a single mutation rather than read and then written in a
+  // read-write transaction.
+  if (!enforce_row_existence &&
+      upsert_database_item_context.request->replace_existing_attributes &&
+      IsPrimaryKeyRequest(table_name_to_keys_.get(),
+                          *upsert_database_item_context.request)) {
+    if (auto schedule_result = GetSpannerCallExecutor().Schedule(
+            bind(&GcpSpanner::BlindUpsertDatabaseItemAsync, this,
+                 upsert_database_item_context, move(*select_options_or),
+                 move(new_attributes)),
+            io_async_execution_priority_);
+        !schedule_result.Successful()) {
+      upsert_database_item_context.result = schedule_result;
+      upsert_database_item_context.Finish();
+      return schedule_result;
+    }
+    return SuccessExecutionResult();
+  }
+
+  if (auto schedule_result = GetSpannerCallExecutor().Schedule(
           bind(&GcpSpanner::UpsertDatabaseItemAsync, this,
                upsert_database_item_context, move(*select_options_or),
                enforce_row_existence, move(new_attributes)),
@@ -596,4 +817,303 @@ ExecutionResult GcpSpanner::UpsertDatabaseItem(
   return SuccessExecutionResult();
 }
 
+ExecutionResult GcpSpanner::BatchGetDatabaseItems(
+    AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+        batch_get_database_items_context) noexcept {
+  if (!batch_get_database_items_context.request) {
+    return FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST);
+  }
+
+  auto tracker = make_shared<BatchGetTracker>(
+      batch_get_database_items_context,
+      [this](AsyncContext<BatchGetDatabaseItemsRequest,
+                          BatchGetDatabaseItemsResponse>& batch_context) {
+        FinishContext(SuccessExecutionResult(), batch_context, async_executor_,
+                      async_execution_priority_);
+      });
+
+  auto schedule_chunk = [this](const shared_ptr<BatchGetItemsChunk>& chunk) {
+    if (auto schedule_result = GetSpannerCallExecutor().Schedule(
+            bind(&GcpSpanner::BatchGetDatabaseItemsAsync, this, chunk),
+            io_async_execution_priority_);
+        !schedule_result.Successful()) {
+      for (const auto& [row_key, indices] : chunk->pending_items) {
+        for (auto index : indices) {
+          chunk->tracker->CompleteItem(index, schedule_result);
+        }
+      }
+    }
+  };
+
+  // Rows are read by key from each table, the other items one by one.
+  unordered_map<string, shared_ptr<BatchGetItemsChunk>> table_chunks;
+  for (size_t index = 0; index < tracker->ItemCount(); ++index) {
+    const auto& item = tracker->GetItem(index);
+    if (!IsValidBatchItem(item)) {
+      tracker->CompleteItem(
+          index,
+          FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST));
+      continue;
+    }
+    if (auto execution_result =
+            ValidatePartitionAndSortKey(table_name_to_keys_.get(), *item);
+        !execution_result.Successful()) {
+      tracker->CompleteItem(index, execution_result);
+      continue;
+    }
+
+    Key key;
+    if (HasAttributeConditions(*item) ||
+        !IsPrimaryKeyRequest(table_name_to_keys_.get(), *item) ||
+        !BuildPrimaryKey(*item, key).Successful()) {
+      ExecuteBatchItemOneByOne(
+          tracker, index,
+          [this](AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>&
+                     context) { return GetDatabaseItem(context); });
+      continue;
+    }
+
+    auto& chunk = table_chunks[*item->table_name];
+    if (!chunk) {
+      chunk = make_shared<BatchGetItemsChunk>();
+      chunk->tracker = tracker;
+      chunk->table_name = *item->table_name;
+      const auto& [partition_key, sort_key] =
+          table_name_to_keys_->at(*item->table_name);
+      chunk->column_names.push_back(partition_key);
+      if (sort_key) {
+        chunk->column_names.push_back(*sort_key);
+      }
+      chunk->column_names.push_back(kValueColumnName);
+    }
+
+    auto& indices = chunk->pending_items[GetRowKey(key, key.size())];
+    indices.push_back(index);
+    if (indices.size() > 1) {
+      continue;
+    }
+    chunk->key_set.AddKey(move(key));
+    if (++chunk->key_count == kMaxBatchReadKeys) {
+      schedule_chunk(chunk);
+      chunk = nullptr;
+    }
+  }
+
+  for (const auto& [table_name, chunk] : table_chunks) {
+    if (chunk) {
+      schedule_chunk(chunk);
+    }
+  }
+  tracker->FinishIfEmpty();
+  return SuccessExecutionResult();
+}
+
+void GcpSpanner::BatchGetDatabaseItemsAsync(
+    shared_ptr<BatchGetItemsChunk> chunk) noexcept {
+  const auto& tracker = chunk->tracker;
+  const size_t key_size = chunk->column_names.size() - 1;
+
+  Client spanner_client(*spanner_client_shared_);
+  auto rows = spanner_client.Read(chunk->table_name, move(chunk->key_set),
+                                  chunk->column_names);
+  for (const auto& row : rows) {
+    if (!row.ok()) {
+      auto result = GcpSpannerUtils::ConvertCloudSpannerErrorToExecutionResult(
+          row.status().code());
+      SCP_ERROR_CONTEXT(
+          kGcpSpanner, tracker->GetBatchContext(), result,
+          absl::StrFormat(
+              "Spanner batch read database items request failed. Error code: "
+              "%d, message: %s",
+              row.status().code(), row.status().message()));
+      for (const auto& [row_key, indices] : chunk->pending_items) {
+        for (auto index : indices) {
+          tracker->CompleteItem(index, result);
+        }
+      }
+      return;
+    }
+
+    auto pending_item =
+        chunk->pending_items.find(GetRowKey(row->values(), key_size));
+    if (pending_item == chunk->pending_items.end()) {
+      continue;
+    }
+
+    // The Value column may be NULL, which is read as an empty JSON.
+    auto attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+    ExecutionResult result = SuccessExecutionResult();
+    const auto spanner_json_or = row->get<optional<SpannerJson>>(key_size);
+    if (!spanner_json_or.ok()) {
+      result = GcpSpannerUtils::ConvertCloudSpannerErrorToExecutionResult(
+          spanner_json_or.status().code());
+    } else {
+      result = ConvertValueColumnToAttributes(
+          spanner_json_or->has_value() ? string(**spanner_json_or) : "{}",
+          *attributes);
+    }
+
+    for (auto index : pending_item->second) {
+      if (!result.Successful()) {
+        tracker->CompleteItem(index, result);
+        continue;
+      }
+      const auto& request = tracker->GetItem(index);
+      auto response = make_shared<GetDatabaseItemResponse>();
+      response->table_name = request->table_name;
+      response->partition_key = request->partition_key;
+      response->sort_key = request->sort_key;
+      response->attributes =
+          make_shared<vector<NoSqlDatabaseKeyValuePair>>(*attributes);
+      tracker->CompleteItem(index, result, response);
+    }
+    chunk->pending_items.erase(pending_item);
+  }
+
+  // The keys without a row do not exist.
+  for (const auto& [row_key, indices] : chunk->pending_items) {
+    for (auto index : indices) {
+      tracker->CompleteItem(
+          index, FailureExecutionResult(
+                     errors::SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND));
+    }
+  }
+}
+
+ExecutionResult GcpSpanner::BatchUpsertDatabaseItems(
+    AsyncContext<BatchUpsertDatabaseItemsRequest,
+                 BatchUpsertDatabaseItemsResponse>&
+        batch_upsert_database_items_context) noexcept {
+  if (!batch_upsert_database_items_context.request) {
+    return FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST);
+  }
+
+  auto tracker = make_shared<BatchUpsertTracker>(
+      batch_upsert_database_items_context,
+      [this](AsyncContext<BatchUpsertDatabaseItemsRequest,
+                          BatchUpsertDatabaseItemsResponse>& batch_context) {
+        FinishContext(SuccessExecutionResult(), batch_context, async_executor_,
+                      async_execution_priority_);
+      });
+  // Upserts of the same row in a batch have no defined order.
+  auto is_duplicate = FailDuplicateBatchItems(tracker);
+
+  shared_ptr<BatchUpsertItemsChunk> chunk;
+  auto schedule_chunk = [this, &chunk]() {
+    if (auto schedule_result = GetSpannerCallExecutor().Schedule(
+            bind(&GcpSpanner::BatchUpsertDatabaseItemsAsync, this, chunk),
+            io_async_execution_priority_);
+        !schedule_result.Successful()) {
+      for (auto index : chunk->indices) {
+        chunk->tracker->CompleteItem(index, schedule_result);
+      }
+    }
+    chunk = nullptr;
+  };
+
+  for (size_t index = 0; index < tracker->ItemCount(); ++index) {
+    if (is_duplicate[index]) {
+      continue;
+    }
+    const auto& item = tracker->GetItem(index);
+    if (!IsValidBatchItem(item)) {
+      tracker->CompleteItem(
+          index,
+          FailureExecutionResult(errors::SC_NO_SQL_DATABASE_INVALID_REQUEST));
+      continue;
+    }
+    if (auto execution_result =
+            ValidatePartitionAndSortKey(table_name_to_keys_.get(), *item);
+        !execution_result.Successful()) {
+      tracker->CompleteItem(index, execution_result);
+      continue;
+    }
+
+    // Only the rows replaced as a whole are written without being read.
+    if (HasAttributeConditions(*item) || !item->replace_existing_attributes ||
+        !IsPrimaryKeyRequest(table_name_to_keys_.get(), *item)) {
+      ExecuteBatchItemOneByOne(
+          tracker, index,
+          [this](AsyncContext<UpsertDatabaseItemRequest,
+                              UpsertDatabaseItemResponse>& context) {
+            return UpsertDatabaseItem(context);
+          });
+      continue;
+    }
+
+    auto select_options_or =
+        UpsertSelectOptions::BuildUpsertSelectOptions(*item);
+    ExecutionResult execution_result = select_options_or.result();
+    json new_attributes = json::object();
+    if (execution_result.Successful() && item->new_attributes) {
+      for (const auto& new_attr : *item->new_attributes) {
+        execution_result = GcpSpannerUtils::
+            ConvertNoSQLDatabaseValidAttributeValueTypeToJsonType(
+                *new_attr.attribute_value,
+                new_attributes[*new_attr.attribute_name]);
+        if (!execution_result.Successful()) {
+          break;
+        }
+      }
+    }
+    if (!execution_result.Successful()) {
+      tracker->CompleteItem(index, execution_result);
+      continue;
+    }
+
+    if (!chunk) {
+      chunk = make_shared<BatchUpsertItemsChunk>();
+      chunk->tracker = tracker;
+    }
+    optional<SpannerJson> spanner_json;
+    if (!new_attributes.empty()) {
+      spanner_json = SpannerJson(new_attributes.dump());
+    }
+    chunk->mutations.push_back(BuildInsertOrUpdateMutation(
+        *item->table_name, *select_options_or, move(spanner_json)));
+    chunk->indices.push_back(index);
+    if (chunk->indices.size() == kMaxBatchUpsertRows) {
+      schedule_chunk();
+    }
+  }
+
+  if (chunk) {
+    schedule_chunk();
+  }
+  tracker->FinishIfEmpty();
+  return SuccessExecutionResult();
+}
+
+void GcpSpanner::BatchUpsertDatabaseItemsAsync(
+    shared_ptr<BatchUpsertItemsChunk> chunk) noexcept {
+  const auto& tracker = chunk->tracker;
+
+  Client client(*spanner_client_shared_);
+  auto commit_result_or = client.Commit(move(chunk->mutations));
+  if (!commit_result_or.ok()) {
+    auto result =
+        core::RetryExecutionResult(errors::SC_NO_SQL_DATABASE_RETRIABLE_ERROR);
+    SCP_ERROR_CONTEXT(
+        kGcpSpanner, tracker->GetBatchContext(), result,
+        absl::StrFormat("Spanner batch upsert commit failed. Error code: %d, "
+                        "message: %s",
+                        commit_result_or.status().code(),
+                        commit_result_or.status().message()));
+    for (auto index : chunk->indices) {
+      tracker->CompleteItem(index, result);
+    }
+    return;
+  }
+
+  for (auto index : chunk->indices) {
+    const auto& request = tracker->GetItem(index);
+    auto response = make_shared<UpsertDatabaseItemResponse>();
+    response->table_name = request->table_name;
+    response->partition_key = request->partition_key;
+    response->sort_key = request->sort_key;
+    response->attributes = request->new_attributes;
+    tracker->CompleteItem(index, SuccessExecutionResult(), response);
+  }
+}
+
 }  // namespace google::scp::core::nosql_database_provider
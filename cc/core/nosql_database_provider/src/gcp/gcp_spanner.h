@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -28,6 +29,7 @@
 #include "core/interface/async_executor_interface.h"
 #include "core/interface/config_provider_interface.h"
 #include "core/interface/nosql_database_provider_interface.h"
+#include "core/nosql_database_provider/src/common/batch_database_items_tracker.h"
 #include "google/cloud/spanner/client.h"
 #include "google/cloud/spanner/mutations.h"
 
@@ -76,7 +78,61 @@ class GcpSpanner : public NoSQLDatabaseProviderInterface {
       AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>&
           upsert_database_item_context) noexcept override;
 
+  /**
+   * @copydoc NoSQLDatabaseProviderInterface::BatchGetDatabaseItems
+   *
+   * Items of the tables in table_name_to_keys without attribute conditions
+   * are read with a single Read of up to 1000 keys per table.
+   */
+  ExecutionResult BatchGetDatabaseItems(
+      AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>&
+          batch_get_database_items_context) noexcept override;
+
+  /**
+   * @copydoc NoSQLDatabaseProviderInterface::BatchUpsertDatabaseItems
+   *
+   * Items of the tables in table_name_to_keys without attribute conditions
+   * which replace the existing attributes are written with a single Commit
+   * of up to 1000 InsertOrUpdate mutations.
+   */
+  ExecutionResult BatchUpsertDatabaseItems(
+      AsyncContext<BatchUpsertDatabaseItemsRequest,
+                   BatchUpsertDatabaseItemsResponse>&
+          batch_upsert_database_items_context) noexcept override;
+
  protected:
+  using BatchGetTracker =
+      BatchDatabaseItemsTracker<BatchGetDatabaseItemsRequest,
+                                BatchGetDatabaseItemsResponse>;
+  using BatchUpsertTracker =
+      BatchDatabaseItemsTracker<BatchUpsertDatabaseItemsRequest,
+                                BatchUpsertDatabaseItemsResponse>;
+
+  /// The items of a batch read from a table with a single Read.
+  struct BatchGetItemsChunk {
+    std::shared_ptr<BatchGetTracker> tracker;
+    std::string table_name;
+    /// The key columns of the table followed by the Value column.
+    std::vector<std::string> column_names;
+    google::cloud::spanner::KeySet key_set;
+    size_t key_count = 0;
+    /// The indices of the pending items by the key of their row.
+    std::unordered_map<std::string, std::vector<size_t>> pending_items;
+  };
+
+  /// The items of a batch written with a single Commit.
+  struct BatchUpsertItemsChunk {
+    std::shared_ptr<BatchUpsertTracker> tracker;
+    google::cloud::spanner::Mutations mutations;
+    std::vector<size_t> indices;
+  };
+
+  /// Returns the executor running the blocking Spanner calls.
+  core::AsyncExecutorInterface& GetSpannerCallExecutor() noexcept {
+    return spanner_call_executor_ ? *spanner_call_executor_
+                                  : *io_async_executor_;
+  }
+
   virtual void CreateSpanner(const std::string& project,
                              const std::string& instance,
                              const std::string& database) noexcept;
@@ -110,6 +166,32 @@ class GcpSpanner : public NoSQLDatabaseProviderInterface {
       std::string query,
       google::cloud::spanner::SqlStatement::ParamType params) noexcept;
 
+  /**
+   * @brief Is called by async executor in order to read the DB item by its
+   * primary key, without a query.
+   *
+   * @param get_database_item_context The context object of the get database
+   * item operation.
+   * @param key The primary key of the DB item.
+   */
+  virtual void GetDatabaseItemByKeyAsync(
+      AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>
+          get_database_item_context,
+      google::cloud::spanner::Key key) noexcept;
+
+  /**
+   * @brief Populates the response attributes from the Value column of the DB
+   * item and finishes the context.
+   *
+   * @param get_database_item_context The context object of the get database
+   * item operation.
+   * @param value The JSON value of the Value column.
+   */
+  void FinishGetDatabaseItem(
+      AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>&
+          get_database_item_context,
+      const std::string& value) noexcept;
+
   struct UpsertSelectOptions {
     static ExecutionResultOr<UpsertSelectOptions> BuildUpsertSelectOptions(
         const UpsertDatabaseItemRequest& request);
@@ -168,12 +250,58 @@ class GcpSpanner : public NoSQLDatabaseProviderInterface {
       UpsertSelectOptions upsert_select_options, bool enforce_row_existence,
       nlohmann::json new_attributes) noexcept;
 
+  /**
+   * @brief Is called by async executor in order to write the DB item with a
+   * single InsertOrUpdate mutation, without reading the existing item. Only
+   * used if the request has no attribute conditions and replaces the existing
+   * attributes.
+   *
+   * @param upsert_database_item_context The context object of the upsert
+   * database item operation.
+   * @param upsert_select_options The options for upserting the item.
+   * @param new_attributes A JSON holding the new_attributes we extracted
+   * from UpsertDatabaseItemRequest.
+   */
+  virtual void BlindUpsertDatabaseItemAsync(
+      AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
+          upsert_database_item_context,
+      UpsertSelectOptions upsert_select_options,
+      nlohmann::json new_attributes) noexcept;
+
+  /**
+   * @brief Is called by async executor in order to read the DB items of the
+   * chunk and complete them on the tracker of the batch.
+   *
+   * @param chunk The items of the batch to read.
+   */
+  virtual void BatchGetDatabaseItemsAsync(
+      std::shared_ptr<BatchGetItemsChunk> chunk) noexcept;
+
+  /**
+   * @brief Is called by async executor in order to write the DB items of the
+   * chunk and complete them on the tracker of the batch.
+   *
+   * @param chunk The items of the batch to write.
+   */
+  virtual void BatchUpsertDatabaseItemsAsync(
+      std::shared_ptr<BatchUpsertItemsChunk> chunk) noexcept;
+
+  /// Builds the InsertOrUpdate mutation writing value to the Value column.
+  static google::cloud::spanner::Mutation BuildInsertOrUpdateMutation(
+      const std::string& table_name,
+      const UpsertSelectOptions& upsert_select_options,
+      std::optional<google::cloud::spanner::Json> value);
+
   /// An instance of the async executor.
   const std::shared_ptr<core::AsyncExecutorInterface> async_executor_;
 
   /// An instance of the IO async executor.
   const std::shared_ptr<core::AsyncExecutorInterface> io_async_executor_;
 
+  /// The dedicated executor of the blocking Spanner calls, if
+  /// kSpannerCallExecutorThreadCount is set.
+  std::shared_ptr<core::AsyncExecutorInterface> spanner_call_executor_;
+
   /// An instance of the GCP Spanner client. To enable thread safety of the
   /// encapsulating class, this instance is marked as const so it can't actually
   /// be used to query Spanner. Instead, Get/Upsert create a copy of this Client
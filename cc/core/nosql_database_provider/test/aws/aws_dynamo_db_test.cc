@@ -0,0 +1,463 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/nosql_database_provider/src/aws/aws_dynamo_db.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <aws/core/Aws.h>
+#include <aws/dynamodb/model/BatchGetItemRequest.h>
+#include <aws/dynamodb/model/BatchWriteItemRequest.h>
+#include <aws/dynamodb/model/UpdateItemRequest.h>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/interface/async_context.h"
+#include "core/nosql_database_provider/mock/aws/mock_aws_dynamo_db.h"
+#include "core/nosql_database_provider/mock/aws/mock_aws_dynamo_db_client.h"
+#include "core/nosql_database_provider/src/common/error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using Aws::InitAPI;
+using Aws::Map;
+using Aws::SDKOptions;
+using Aws::ShutdownAPI;
+using Aws::String;
+using Aws::Vector;
+using Aws::Client::AsyncCallerContext;
+using Aws::DynamoDB::BatchGetItemResponseReceivedHandler;
+using Aws::DynamoDB::BatchWriteItemResponseReceivedHandler;
+using Aws::DynamoDB::DynamoDBError;
+using Aws::DynamoDB::DynamoDBErrors;
+using Aws::DynamoDB::UpdateItemResponseReceivedHandler;
+using Aws::DynamoDB::Model::AttributeValue;
+using Aws::DynamoDB::Model::BatchGetItemOutcome;
+using Aws::DynamoDB::Model::BatchGetItemRequest;
+using Aws::DynamoDB::Model::BatchGetItemResult;
+using Aws::DynamoDB::Model::BatchWriteItemOutcome;
+using Aws::DynamoDB::Model::BatchWriteItemRequest;
+using Aws::DynamoDB::Model::BatchWriteItemResult;
+using Aws::DynamoDB::Model::KeysAndAttributes;
+using Aws::DynamoDB::Model::UpdateItemOutcome;
+using Aws::DynamoDB::Model::UpdateItemRequest;
+using Aws::DynamoDB::Model::UpdateItemResult;
+using Aws::DynamoDB::Model::WriteRequest;
+using google::scp::core::AsyncContext;
+using google::scp::core::BatchGetDatabaseItemsRequest;
+using google::scp::core::BatchGetDatabaseItemsResponse;
+using google::scp::core::BatchUpsertDatabaseItemsRequest;
+using google::scp::core::BatchUpsertDatabaseItemsResponse;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::GetDatabaseItemRequest;
+using google::scp::core::NoSqlDatabaseKeyValuePair;
+using google::scp::core::NoSQLDatabaseValidAttributeValueTypes;
+using google::scp::core::RetryExecutionResult;
+using google::scp::core::UpsertDatabaseItemRequest;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_RETRIABLE_ERROR;
+using google::scp::core::nosql_database_provider::aws::mock::MockAwsDynamoDB;
+using google::scp::core::nosql_database_provider::aws::mock::
+    MockAwsDynamoDBClient;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+
+constexpr char kTableName[] = "BudgetKeys";
+constexpr char kPartitionKeyName[] = "BudgetKeyId";
+constexpr char kSortKeyName[] = "Timeframe";
+
+}  // namespace
+
+namespace google::scp::core::nosql_database_provider::test {
+
+class AwsDynamoDBTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    SDKOptions options;
+    InitAPI(options);
+  }
+
+  static void TearDownTestSuite() {
+    SDKOptions options;
+    ShutdownAPI(options);
+  }
+
+  AwsDynamoDBTest()
+      : dynamo_db_client_(make_shared<MockAwsDynamoDBClient>()),
+        aws_dynamo_db_(dynamo_db_client_, make_shared<MockAsyncExecutor>()) {}
+
+  static shared_ptr<NoSqlDatabaseKeyValuePair> CreateKey(const string& name,
+                                                         const string& value) {
+    auto key = make_shared<NoSqlDatabaseKeyValuePair>();
+    key->attribute_name = make_shared<string>(name);
+    key->attribute_value =
+        make_shared<NoSQLDatabaseValidAttributeValueTypes>(value);
+    return key;
+  }
+
+  template <typename Request>
+  static shared_ptr<Request> CreateRequest(const string& budget_key) {
+    auto request = make_shared<Request>();
+    request->table_name = make_shared<string>(kTableName);
+    request->partition_key = CreateKey(kPartitionKeyName, budget_key);
+    request->sort_key = CreateKey(kSortKeyName, "timeframe");
+    return request;
+  }
+
+  static shared_ptr<UpsertDatabaseItemRequest> CreateUpsertRequest(
+      const string& budget_key, const string& token_count,
+      bool replace_existing_attributes) {
+    auto request = CreateRequest<UpsertDatabaseItemRequest>(budget_key);
+    request->new_attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+    request->new_attributes->push_back(*CreateKey("token_count", token_count));
+    request->replace_existing_attributes = replace_existing_attributes;
+    return request;
+  }
+
+  /// Returns the DynamoDB item of the budget key, with its token count if
+  /// any.
+  static Map<String, AttributeValue> CreateItem(
+      const string& budget_key, const string& token_count = "") {
+    Map<String, AttributeValue> item;
+    item[kPartitionKeyName].SetS(budget_key.c_str());
+    item[kSortKeyName].SetS("timeframe");
+    if (!token_count.empty()) {
+      item["token_count"].SetS(token_count.c_str());
+    }
+    return item;
+  }
+
+  /// Returns the budget keys of the items of the batch get item request.
+  static vector<string> GetRequestedBudgetKeys(
+      const BatchGetItemRequest& request) {
+    vector<string> budget_keys;
+    for (const auto& key : request.GetRequestItems().at(kTableName).GetKeys()) {
+      budget_keys.push_back(key.at(kPartitionKeyName).GetS().c_str());
+    }
+    return budget_keys;
+  }
+
+  /// Returns the budget keys of the items of the batch write item request.
+  static vector<string> GetWrittenBudgetKeys(
+      const BatchWriteItemRequest& request) {
+    vector<string> budget_keys;
+    for (const auto& write_request : request.GetRequestItems().at(kTableName)) {
+      budget_keys.push_back(write_request.GetPutRequest()
+                                .GetItem()
+                                .at(kPartitionKeyName)
+                                .GetS()
+                                .c_str());
+    }
+    return budget_keys;
+  }
+
+  shared_ptr<MockAwsDynamoDBClient> dynamo_db_client_;
+  MockAwsDynamoDB aws_dynamo_db_;
+};
+
+TEST_F(AwsDynamoDBTest, BatchGetItemsReadsItemsWithOneRequest) {
+  size_t request_count = 0;
+  dynamo_db_client_->batch_get_item_async_mock =
+      [&](const BatchGetItemRequest& request,
+          const BatchGetItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        request_count++;
+        EXPECT_EQ(GetRequestedBudgetKeys(request),
+                  vector<string>({"key_1", "key_2"}));
+        BatchGetItemResult result;
+        result.SetResponses({{kTableName, {CreateItem("key_1", "1 2")}}});
+        handler(dynamo_db_client_.get(), request, BatchGetItemOutcome(result),
+                context);
+      };
+
+  auto request = make_shared<BatchGetDatabaseItemsRequest>();
+  request->items = {CreateRequest<GetDatabaseItemRequest>("key_1"),
+                    CreateRequest<GetDatabaseItemRequest>("key_2"),
+                    CreateRequest<GetDatabaseItemRequest>("key_1")};
+  bool finished = false;
+  AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        const auto& response = *context.response;
+        EXPECT_SUCCESS(response.item_results[0]);
+        ASSERT_EQ(response.items[0]->attributes->size(), 1);
+        EXPECT_EQ(*response.items[0]->attributes->at(0).attribute_name,
+                  "token_count");
+        EXPECT_THAT(response.item_results[1],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND)));
+        // The item requested twice is read once.
+        EXPECT_SUCCESS(response.item_results[2]);
+        finished = true;
+      });
+  EXPECT_SUCCESS(aws_dynamo_db_.BatchGetDatabaseItems(context));
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(request_count, 1);
+}
+
+TEST_F(AwsDynamoDBTest, BatchGetItemsRetriesUnprocessedKeys) {
+  size_t request_count = 0;
+  dynamo_db_client_->batch_get_item_async_mock =
+      [&](const BatchGetItemRequest& request,
+          const BatchGetItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        BatchGetItemResult result;
+        if (++request_count == 1) {
+          EXPECT_EQ(GetRequestedBudgetKeys(request),
+                    vector<string>({"key_1", "key_2"}));
+          result.SetResponses({{kTableName, {CreateItem("key_1", "1 2")}}});
+          KeysAndAttributes unprocessed_keys;
+          unprocessed_keys.AddKeys(CreateItem("key_2"));
+          result.SetUnprocessedKeys({{kTableName, unprocessed_keys}});
+        } else {
+          EXPECT_EQ(GetRequestedBudgetKeys(request),
+                    vector<string>({"key_2"}));
+          result.SetResponses({{kTableName, {CreateItem("key_2", "3 4")}}});
+        }
+        handler(dynamo_db_client_.get(), request, BatchGetItemOutcome(result),
+                context);
+      };
+
+  auto request = make_shared<BatchGetDatabaseItemsRequest>();
+  request->items = {CreateRequest<GetDatabaseItemRequest>("key_1"),
+                    CreateRequest<GetDatabaseItemRequest>("key_2")};
+  bool finished = false;
+  AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.response->item_results[0]);
+        EXPECT_SUCCESS(context.response->item_results[1]);
+        EXPECT_EQ(std::get<string>(*context.response->items[1]
+                                        ->attributes->at(0)
+                                        .attribute_value),
+                  "3 4");
+        finished = true;
+      });
+  EXPECT_SUCCESS(aws_dynamo_db_.BatchGetDatabaseItems(context));
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(request_count, 2);
+}
+
+TEST_F(AwsDynamoDBTest, BatchGetItemsFailsKeysUnprocessedAfterRetries) {
+  size_t request_count = 0;
+  dynamo_db_client_->batch_get_item_async_mock =
+      [&](const BatchGetItemRequest& request,
+          const BatchGetItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        request_count++;
+        BatchGetItemResult result;
+        if (request_count == 1) {
+          result.SetResponses({{kTableName, {CreateItem("key_1", "1 2")}}});
+        }
+        KeysAndAttributes unprocessed_keys;
+        unprocessed_keys.AddKeys(CreateItem("key_2"));
+        result.SetUnprocessedKeys({{kTableName, unprocessed_keys}});
+        handler(dynamo_db_client_.get(), request, BatchGetItemOutcome(result),
+                context);
+      };
+
+  auto request = make_shared<BatchGetDatabaseItemsRequest>();
+  request->items = {CreateRequest<GetDatabaseItemRequest>("key_1"),
+                    CreateRequest<GetDatabaseItemRequest>("key_2")};
+  bool finished = false;
+  AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_SUCCESS(context.response->item_results[0]);
+        EXPECT_THAT(context.response->item_results[1],
+                    ResultIs(RetryExecutionResult(
+                        SC_NO_SQL_DATABASE_RETRIABLE_ERROR)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(aws_dynamo_db_.BatchGetDatabaseItems(context));
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(request_count, 4);
+}
+
+TEST_F(AwsDynamoDBTest, BatchGetItemsFailsOnlyTheItemsOfAFailedRequest) {
+  dynamo_db_client_->batch_get_item_async_mock =
+      [&](const BatchGetItemRequest& request,
+          const BatchGetItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        handler(dynamo_db_client_.get(), request,
+                BatchGetItemOutcome(
+                    DynamoDBError(DynamoDBErrors::THROTTLING, "throttling")),
+                context);
+      };
+  // The item with attribute conditions is read with a query.
+  dynamo_db_client_->query_async_mock =
+      [&](const auto& request, const auto& handler, const auto& context) {
+        Aws::DynamoDB::Model::QueryResult result;
+        result.SetItems({CreateItem("key_2", "3 4")});
+        handler(dynamo_db_client_.get(), request,
+                Aws::DynamoDB::Model::QueryOutcome(result), context);
+      };
+
+  auto request = make_shared<BatchGetDatabaseItemsRequest>();
+  request->items = {CreateRequest<GetDatabaseItemRequest>("key_1"),
+                    CreateRequest<GetDatabaseItemRequest>("key_2")};
+  request->items[1]->attributes =
+      make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  request->items[1]->attributes->push_back(*CreateKey("token_count", "3 4"));
+  bool finished = false;
+  AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_THAT(context.response->item_results[0],
+                    ResultIs(RetryExecutionResult(
+                        SC_NO_SQL_DATABASE_RETRIABLE_ERROR)));
+        EXPECT_SUCCESS(context.response->item_results[1]);
+        finished = true;
+      });
+  EXPECT_SUCCESS(aws_dynamo_db_.BatchGetDatabaseItems(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(AwsDynamoDBTest, BatchUpsertItemsWritesItemsWithOneRequest) {
+  size_t request_count = 0;
+  dynamo_db_client_->batch_write_item_async_mock =
+      [&](const BatchWriteItemRequest& request,
+          const BatchWriteItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        request_count++;
+        EXPECT_EQ(GetWrittenBudgetKeys(request),
+                  vector<string>({"key_1", "key_2"}));
+        handler(dynamo_db_client_.get(), request,
+                BatchWriteItemOutcome(BatchWriteItemResult()), context);
+      };
+  // The item merging attributes is updated on its own.
+  size_t update_count = 0;
+  dynamo_db_client_->update_item_async_mock =
+      [&](const UpdateItemRequest& request,
+          const UpdateItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        update_count++;
+        handler(dynamo_db_client_.get(), request,
+                UpdateItemOutcome(UpdateItemResult()), context);
+      };
+
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  request->items = {
+      CreateUpsertRequest("key_1", "1 2", /*replace_existing_attributes=*/true),
+      CreateUpsertRequest("key_2", "3 4", /*replace_existing_attributes=*/true),
+      CreateUpsertRequest("key_3", "5 6",
+                          /*replace_existing_attributes=*/false),
+      CreateUpsertRequest("key_1", "7 8",
+                          /*replace_existing_attributes=*/true)};
+  bool finished = false;
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        const auto& response = *context.response;
+        EXPECT_SUCCESS(response.item_results[0]);
+        EXPECT_SUCCESS(response.item_results[1]);
+        EXPECT_SUCCESS(response.item_results[2]);
+        EXPECT_THAT(response.item_results[3],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(aws_dynamo_db_.BatchUpsertDatabaseItems(context));
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(request_count, 1);
+  EXPECT_EQ(update_count, 1);
+}
+
+TEST_F(AwsDynamoDBTest, BatchUpsertItemsRetriesUnprocessedItems) {
+  size_t request_count = 0;
+  dynamo_db_client_->batch_write_item_async_mock =
+      [&](const BatchWriteItemRequest& request,
+          const BatchWriteItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        BatchWriteItemResult result;
+        if (++request_count == 1) {
+          EXPECT_EQ(GetWrittenBudgetKeys(request),
+                    vector<string>({"key_1", "key_2"}));
+          Map<String, Vector<WriteRequest>> unprocessed_items;
+          unprocessed_items[kTableName].push_back(
+              request.GetRequestItems().at(kTableName)[1]);
+          result.SetUnprocessedItems(unprocessed_items);
+        } else {
+          EXPECT_EQ(GetWrittenBudgetKeys(request), vector<string>({"key_2"}));
+        }
+        handler(dynamo_db_client_.get(), request,
+                BatchWriteItemOutcome(result), context);
+      };
+
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  request->items = {
+      CreateUpsertRequest("key_1", "1 2", /*replace_existing_attributes=*/true),
+      CreateUpsertRequest("key_2", "3 4",
+                          /*replace_existing_attributes=*/true)};
+  bool finished = false;
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.response->item_results[0]);
+        EXPECT_SUCCESS(context.response->item_results[1]);
+        finished = true;
+      });
+  EXPECT_SUCCESS(aws_dynamo_db_.BatchUpsertDatabaseItems(context));
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(request_count, 2);
+}
+
+TEST_F(AwsDynamoDBTest, BatchUpsertItemsFailsItemsUnprocessedAfterRetries) {
+  size_t request_count = 0;
+  dynamo_db_client_->batch_write_item_async_mock =
+      [&](const BatchWriteItemRequest& request,
+          const BatchWriteItemResponseReceivedHandler& handler,
+          const shared_ptr<const AsyncCallerContext>& context) {
+        request_count++;
+        Map<String, Vector<WriteRequest>> unprocessed_items;
+        unprocessed_items[kTableName].push_back(
+            request.GetRequestItems().at(kTableName).back());
+        BatchWriteItemResult result;
+        result.SetUnprocessedItems(unprocessed_items);
+        handler(dynamo_db_client_.get(), request,
+                BatchWriteItemOutcome(result), context);
+      };
+
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  request->items = {
+      CreateUpsertRequest("key_1", "1 2", /*replace_existing_attributes=*/true),
+      CreateUpsertRequest("key_2", "3 4",
+                          /*replace_existing_attributes=*/true)};
+  bool finished = false;
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_SUCCESS(context.response->item_results[0]);
+        EXPECT_THAT(context.response->item_results[1],
+                    ResultIs(RetryExecutionResult(
+                        SC_NO_SQL_DATABASE_RETRIABLE_ERROR)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(aws_dynamo_db_.BatchUpsertDatabaseItems(context));
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(request_count, 4);
+}
+
+}  // namespace google::scp::core::nosql_database_provider::test
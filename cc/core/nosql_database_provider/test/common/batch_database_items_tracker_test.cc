@@ -0,0 +1,202 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/nosql_database_provider/src/common/batch_database_items_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/nosql_database_provider_interface.h"
+#include "core/nosql_database_provider/mock/mock_nosql_database_provider.h"
+#include "core/nosql_database_provider/src/common/error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::BatchGetDatabaseItemsRequest;
+using google::scp::core::BatchGetDatabaseItemsResponse;
+using google::scp::core::BatchUpsertDatabaseItemsRequest;
+using google::scp::core::BatchUpsertDatabaseItemsResponse;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::GetDatabaseItemRequest;
+using google::scp::core::NoSqlDatabaseKeyValuePair;
+using google::scp::core::NoSQLDatabaseValidAttributeValueTypes;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::UpsertDatabaseItemRequest;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_INVALID_REQUEST;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND;
+using google::scp::core::nosql_database_provider::mock::
+    MockNoSQLDatabaseProvider;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google::scp::core::nosql_database_provider::test {
+using BatchUpsertTracker =
+    BatchDatabaseItemsTracker<BatchUpsertDatabaseItemsRequest,
+                              BatchUpsertDatabaseItemsResponse>;
+
+static shared_ptr<UpsertDatabaseItemRequest> CreateUpsertRequest(
+    const string& partition_key, const string& value) {
+  auto request = make_shared<UpsertDatabaseItemRequest>();
+  request->table_name = make_shared<string>("Table");
+  request->partition_key = make_shared<NoSqlDatabaseKeyValuePair>();
+  request->partition_key->attribute_name = make_shared<string>("Key");
+  request->partition_key->attribute_value =
+      make_shared<NoSQLDatabaseValidAttributeValueTypes>(partition_key);
+  request->attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  request->new_attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  NoSqlDatabaseKeyValuePair attribute;
+  attribute.attribute_name = make_shared<string>("Value");
+  attribute.attribute_value =
+      make_shared<NoSQLDatabaseValidAttributeValueTypes>(value);
+  request->new_attributes->push_back(attribute);
+  return request;
+}
+
+TEST(BatchDatabaseItemsTrackerTest, FinishesOnceAllItemsComplete) {
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  request->items = {CreateUpsertRequest("a", "1"),
+                    CreateUpsertRequest("b", "2")};
+  size_t finish_count = 0;
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(request, [](auto&) {});
+  auto tracker = make_shared<BatchUpsertTracker>(
+      context, [&](auto& batch_context) {
+        finish_count++;
+        EXPECT_SUCCESS(batch_context.result);
+        EXPECT_SUCCESS(batch_context.response->item_results[0]);
+        EXPECT_THAT(batch_context.response->item_results[1],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_INVALID_REQUEST)));
+      });
+  EXPECT_EQ(tracker->ItemCount(), 2);
+
+  tracker->FinishIfEmpty();
+  tracker->CompleteItem(0, SuccessExecutionResult());
+  EXPECT_EQ(finish_count, 0);
+  // Only the first completion of an item counts.
+  tracker->CompleteItem(0, FailureExecutionResult(1));
+  EXPECT_EQ(finish_count, 0);
+  tracker->CompleteItem(
+      1, FailureExecutionResult(SC_NO_SQL_DATABASE_INVALID_REQUEST));
+  EXPECT_EQ(finish_count, 1);
+  tracker->CompleteItem(1, SuccessExecutionResult());
+  EXPECT_EQ(finish_count, 1);
+}
+
+TEST(BatchDatabaseItemsTrackerTest, FinishesEmptyBatch) {
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(make_shared<BatchUpsertDatabaseItemsRequest>(), [](auto&) {});
+  size_t finish_count = 0;
+  auto tracker = make_shared<BatchUpsertTracker>(
+      context, [&](auto& batch_context) {
+        finish_count++;
+        EXPECT_SUCCESS(batch_context.result);
+      });
+  tracker->FinishIfEmpty();
+  EXPECT_EQ(finish_count, 1);
+}
+
+TEST(BatchDatabaseItemsTrackerTest, FailsDuplicateItems) {
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  request->items = {CreateUpsertRequest("a", "1"),
+                    CreateUpsertRequest("b", "2"),
+                    CreateUpsertRequest("a", "3"), nullptr};
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(request, [](auto&) {});
+  shared_ptr<BatchUpsertDatabaseItemsResponse> response;
+  auto tracker = make_shared<BatchUpsertTracker>(
+      context,
+      [&](auto& batch_context) { response = batch_context.response; });
+
+  EXPECT_EQ(FailDuplicateBatchItems(tracker),
+            vector<bool>({false, false, true, false}));
+  tracker->CompleteItem(0, SuccessExecutionResult());
+  tracker->CompleteItem(1, SuccessExecutionResult());
+  tracker->CompleteItem(
+      3, FailureExecutionResult(SC_NO_SQL_DATABASE_INVALID_REQUEST));
+  ASSERT_NE(response, nullptr);
+  EXPECT_THAT(response->item_results[2],
+              ResultIs(FailureExecutionResult(
+                  SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM)));
+}
+
+TEST(BatchDatabaseItemsTrackerTest, BatchKeyDistinguishesTypes) {
+  auto string_key = CreateUpsertRequest("1", "1");
+  auto int_key = CreateUpsertRequest("1", "1");
+  *int_key->partition_key->attribute_value = 1;
+  EXPECT_NE(GetBatchItemKey(*string_key), GetBatchItemKey(*int_key));
+  EXPECT_EQ(GetBatchItemKey(*string_key),
+            GetBatchItemKey(*CreateUpsertRequest("1", "2")));
+}
+
+TEST(BatchDatabaseItemsTrackerTest, ExecutesItemsOneByOne) {
+  MockNoSQLDatabaseProvider database;
+  database.InitializeTable("Table", "Key");
+
+  auto upsert_request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  upsert_request->items = {CreateUpsertRequest("a", "1"),
+                           CreateUpsertRequest("b", "2"), nullptr};
+  bool upserted = false;
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      upsert_context(upsert_request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_SUCCESS(context.response->item_results[0]);
+        EXPECT_SUCCESS(context.response->item_results[1]);
+        EXPECT_THAT(context.response->item_results[2],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_INVALID_REQUEST)));
+        upserted = true;
+      });
+  EXPECT_SUCCESS(database.BatchUpsertDatabaseItems(upsert_context));
+  EXPECT_TRUE(upserted);
+
+  auto get_request = make_shared<BatchGetDatabaseItemsRequest>();
+  for (const auto& key : {"b", "c"}) {
+    auto item = make_shared<GetDatabaseItemRequest>();
+    item->table_name = make_shared<string>("Table");
+    item->partition_key = CreateUpsertRequest(key, "")->partition_key;
+    get_request->items.push_back(item);
+  }
+  bool read = false;
+  AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>
+      get_context(get_request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_SUCCESS(context.response->item_results[0]);
+        ASSERT_NE(context.response->items[0], nullptr);
+        const auto& attribute = context.response->items[0]->attributes->at(0);
+        EXPECT_EQ(*attribute.attribute_value,
+                  NoSQLDatabaseValidAttributeValueTypes("2"));
+        EXPECT_THAT(context.response->item_results[1],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND)));
+        EXPECT_EQ(context.response->items[1], nullptr);
+        read = true;
+      });
+  EXPECT_SUCCESS(database.BatchGetDatabaseItems(get_context));
+  EXPECT_TRUE(read);
+}
+}  // namespace google::scp::core::nosql_database_provider::test
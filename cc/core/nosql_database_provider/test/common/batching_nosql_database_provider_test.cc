@@ -0,0 +1,209 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/nosql_database_provider/src/common/batching_nosql_database_provider.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/nosql_database_provider_interface.h"
+#include "core/nosql_database_provider/mock/mock_nosql_database_provider.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::BatchUpsertDatabaseItemsRequest;
+using google::scp::core::BatchUpsertDatabaseItemsResponse;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::GetDatabaseItemRequest;
+using google::scp::core::GetDatabaseItemResponse;
+using google::scp::core::NoSqlDatabaseKeyValuePair;
+using google::scp::core::NoSQLDatabaseValidAttributeValueTypes;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::UpsertDatabaseItemRequest;
+using google::scp::core::UpsertDatabaseItemResponse;
+using google::scp::core::nosql_database_provider::mock::
+    MockNoSQLDatabaseProvider;
+using google::scp::core::test::ResultIs;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google::scp::core::nosql_database_provider::test {
+/// Holds the batch upserts until the test executes them.
+class DeferringNoSQLDatabaseProvider : public MockNoSQLDatabaseProvider {
+ public:
+  ExecutionResult BatchUpsertDatabaseItems(
+      AsyncContext<BatchUpsertDatabaseItemsRequest,
+                   BatchUpsertDatabaseItemsResponse>&
+          batch_upsert_database_items_context) noexcept override {
+    batch_contexts.push_back(batch_upsert_database_items_context);
+    return SuccessExecutionResult();
+  }
+
+  /// Executes the batch upsert, which finishes inline.
+  void ExecuteBatch(size_t index) {
+    MockNoSQLDatabaseProvider::BatchUpsertDatabaseItems(batch_contexts[index]);
+  }
+
+  vector<AsyncContext<BatchUpsertDatabaseItemsRequest,
+                      BatchUpsertDatabaseItemsResponse>>
+      batch_contexts;
+};
+
+class BatchingNoSQLDatabaseProviderTest : public ::testing::Test {
+ protected:
+  BatchingNoSQLDatabaseProviderTest()
+      : database_(make_shared<DeferringNoSQLDatabaseProvider>()) {
+    database_->InitializeTable("Table", "Key");
+  }
+
+  /// Upserts the value of the key, recording the result once finished.
+  ExecutionResult Upsert(BatchingNoSQLDatabaseProvider& provider,
+                         const string& key, const string& value,
+                         bool replace_existing_attributes = true) {
+    auto request = make_shared<UpsertDatabaseItemRequest>();
+    request->table_name = make_shared<string>("Table");
+    request->partition_key = make_shared<NoSqlDatabaseKeyValuePair>();
+    request->partition_key->attribute_name = make_shared<string>("Key");
+    request->partition_key->attribute_value =
+        make_shared<NoSQLDatabaseValidAttributeValueTypes>(key);
+    request->attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+    request->new_attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+    NoSqlDatabaseKeyValuePair attribute;
+    attribute.attribute_name = make_shared<string>("Value");
+    attribute.attribute_value =
+        make_shared<NoSQLDatabaseValidAttributeValueTypes>(value);
+    request->new_attributes->push_back(attribute);
+    request->replace_existing_attributes = replace_existing_attributes;
+    AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
+        context(request,
+                [this](auto& context) { results_.push_back(context.result); });
+    return provider.UpsertDatabaseItem(context);
+  }
+
+  /// Returns the value of the key in the database.
+  string GetValue(const string& key) {
+    auto request = make_shared<GetDatabaseItemRequest>();
+    request->table_name = make_shared<string>("Table");
+    request->partition_key = make_shared<NoSqlDatabaseKeyValuePair>();
+    request->partition_key->attribute_name = make_shared<string>("Key");
+    request->partition_key->attribute_value =
+        make_shared<NoSQLDatabaseValidAttributeValueTypes>(key);
+    string value;
+    AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse> context(
+        request, [&value](auto& context) {
+          if (context.result.Successful()) {
+            value =
+                std::get<string>(*context.response->attributes->at(0)
+                                      .attribute_value);
+          }
+        });
+    database_->GetDatabaseItem(context);
+    return value;
+  }
+
+  shared_ptr<DeferringNoSQLDatabaseProvider> database_;
+  vector<ExecutionResult> results_;
+};
+
+TEST_F(BatchingNoSQLDatabaseProviderTest, BatchesUpsertsWhileBatchInFlight) {
+  BatchingNoSQLDatabaseProvider provider(database_, /*upsert_batch_size=*/2);
+
+  // The first upsert is sent right away and the next ones wait for it.
+  for (const auto& key : {"a", "b", "c", "d"}) {
+    EXPECT_SUCCESS(Upsert(provider, key, string(key) + "1"));
+  }
+  ASSERT_EQ(database_->batch_contexts.size(), 1);
+  EXPECT_EQ(database_->batch_contexts[0].request->items.size(), 1);
+
+  database_->ExecuteBatch(0);
+  EXPECT_EQ(results_.size(), 1);
+  ASSERT_EQ(database_->batch_contexts.size(), 2);
+  EXPECT_EQ(database_->batch_contexts[1].request->items.size(), 2);
+
+  database_->ExecuteBatch(1);
+  EXPECT_EQ(results_.size(), 3);
+  ASSERT_EQ(database_->batch_contexts.size(), 3);
+  EXPECT_EQ(database_->batch_contexts[2].request->items.size(), 1);
+
+  database_->ExecuteBatch(2);
+  ASSERT_EQ(results_.size(), 4);
+  for (const auto& result : results_) {
+    EXPECT_SUCCESS(result);
+  }
+  for (const auto& key : {"a", "b", "c", "d"}) {
+    EXPECT_EQ(GetValue(key), string(key) + "1");
+  }
+
+  // Nothing is in flight anymore, so the next upsert is sent right away.
+  EXPECT_SUCCESS(Upsert(provider, "a", "a2"));
+  EXPECT_EQ(database_->batch_contexts.size(), 4);
+}
+
+TEST_F(BatchingNoSQLDatabaseProviderTest,
+       UpsertsKeepingExistingAttributesAreNotBatched) {
+  BatchingNoSQLDatabaseProvider provider(database_, /*upsert_batch_size=*/2);
+
+  EXPECT_SUCCESS(Upsert(provider, "a", "a1",
+                        /*replace_existing_attributes=*/false));
+  EXPECT_TRUE(database_->batch_contexts.empty());
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_SUCCESS(results_[0]);
+  EXPECT_EQ(GetValue("a"), "a1");
+}
+
+TEST_F(BatchingNoSQLDatabaseProviderTest, DuplicateUpsertsAreUpsertedInOrder) {
+  BatchingNoSQLDatabaseProvider provider(database_, /*upsert_batch_size=*/10);
+
+  EXPECT_SUCCESS(Upsert(provider, "a", "a1"));
+  EXPECT_SUCCESS(Upsert(provider, "a", "a2"));
+  EXPECT_SUCCESS(Upsert(provider, "a", "a3"));
+  database_->ExecuteBatch(0);
+  ASSERT_EQ(database_->batch_contexts.size(), 2);
+  EXPECT_EQ(database_->batch_contexts[1].request->items.size(), 2);
+
+  // The later upsert of the batch is upserted again on its own.
+  database_->ExecuteBatch(1);
+  ASSERT_EQ(results_.size(), 3);
+  for (const auto& result : results_) {
+    EXPECT_SUCCESS(result);
+  }
+  EXPECT_EQ(GetValue("a"), "a3");
+}
+
+TEST_F(BatchingNoSQLDatabaseProviderTest, FailedBatchFailsItsUpserts) {
+  BatchingNoSQLDatabaseProvider provider(database_, /*upsert_batch_size=*/10);
+
+  EXPECT_SUCCESS(Upsert(provider, "a", "a1"));
+  EXPECT_SUCCESS(Upsert(provider, "b", "b1"));
+  auto& batch_context = database_->batch_contexts[0];
+  batch_context.result = FailureExecutionResult(1234);
+  batch_context.Finish();
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_THAT(results_[0], ResultIs(FailureExecutionResult(1234)));
+
+  // The next batch is sent regardless.
+  ASSERT_EQ(database_->batch_contexts.size(), 2);
+  database_->ExecuteBatch(1);
+  ASSERT_EQ(results_.size(), 2);
+  EXPECT_SUCCESS(results_[1]);
+}
+}  // namespace google::scp::core::nosql_database_provider::test
@@ -0,0 +1,587 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/nosql_database_provider/src/gcp/gcp_spanner.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/config_provider/mock/mock_config_provider.h"
+#include "core/interface/async_context.h"
+#include "core/interface/configuration_keys.h"
+#include "core/nosql_database_provider/src/common/error_codes.h"
+#include "core/test/utils/conditional_wait.h"
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/mocks/row.h"
+#include "google/cloud/spanner/mutations.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::cloud::spanner::Client;
+using google::cloud::spanner::CommitResult;
+using google::cloud::spanner::Connection;
+using google::cloud::spanner::Json;
+using google::cloud::spanner::KeySet;
+using google::cloud::spanner::MakeInsertOrUpdateMutation;
+using google::cloud::spanner::MakeKey;
+using google::cloud::spanner::Mutation;
+using google::cloud::spanner::Row;
+using google::cloud::spanner::RowStream;
+using google::cloud::spanner::Value;
+using google::cloud::spanner_mocks::MakeRow;
+using google::cloud::spanner_mocks::MockConnection;
+using google::cloud::spanner_mocks::MockResultSetSource;
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncOperation;
+using google::scp::core::AsyncPriority;
+using google::scp::core::BatchGetDatabaseItemsRequest;
+using google::scp::core::BatchGetDatabaseItemsResponse;
+using google::scp::core::BatchUpsertDatabaseItemsRequest;
+using google::scp::core::BatchUpsertDatabaseItemsResponse;
+using google::scp::core::ConfigProviderInterface;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::GetDatabaseItemRequest;
+using google::scp::core::GetDatabaseItemResponse;
+using google::scp::core::kGcpProjectId;
+using google::scp::core::kSpannerCallExecutorThreadCount;
+using google::scp::core::kSpannerDatabase;
+using google::scp::core::kSpannerInstance;
+using google::scp::core::NoSqlDatabaseKeyValuePair;
+using google::scp::core::NoSQLDatabaseValidAttributeValueTypes;
+using google::scp::core::RetryExecutionResult;
+using google::scp::core::UpsertDatabaseItemRequest;
+using google::scp::core::UpsertDatabaseItemResponse;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::config_provider::mock::MockConfigProvider;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM;
+using google::scp::core::errors::
+    SC_NO_SQL_DATABASE_PROVIDER_INVALID_PARTITION_KEY_NAME;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_PROVIDER_TABLE_NOT_FOUND;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_RETRIABLE_ERROR;
+using google::scp::core::errors::SC_NO_SQL_DATABASE_UNRETRIABLE_ERROR;
+using google::scp::core::test::ResultIs;
+using std::atomic;
+using std::make_pair;
+using std::make_shared;
+using std::make_unique;
+using std::move;
+using std::optional;
+using std::pair;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+using testing::_;
+using testing::AllOf;
+using testing::ByMove;
+using testing::ElementsAre;
+using testing::Eq;
+using testing::Field;
+using testing::FieldsAre;
+using google::scp::core::test::WaitUntil;
+using testing::NiceMock;
+using testing::Return;
+using testing::UnorderedElementsAre;
+
+namespace {
+
+constexpr char kBudgetKeyTableName[] = "BudgetKeys";
+constexpr char kBudgetKeyPartitionKeyName[] = "BudgetKeyId";
+constexpr char kBudgetKeySortKeyName[] = "Timeframe";
+
+}  // namespace
+
+namespace google::scp::core::nosql_database_provider::test {
+
+class TestGcpSpanner : public GcpSpanner {
+ public:
+  TestGcpSpanner(
+      const shared_ptr<AsyncExecutorInterface>& async_executor,
+      const shared_ptr<AsyncExecutorInterface>& io_async_executor,
+      const shared_ptr<ConfigProviderInterface>& config_provider,
+      const shared_ptr<Connection>& connection)
+      : GcpSpanner(async_executor, io_async_executor, config_provider,
+                   GetTableNameToKeysMap(), AsyncPriority::Normal,
+                   AsyncPriority::Normal),
+        connection_(connection) {}
+
+ protected:
+  static unique_ptr<unordered_map<string, pair<string, optional<string>>>>
+  GetTableNameToKeysMap() {
+    auto table_name_to_keys =
+        make_unique<unordered_map<string, pair<string, optional<string>>>>();
+    table_name_to_keys->emplace(
+        kBudgetKeyTableName,
+        make_pair(kBudgetKeyPartitionKeyName, kBudgetKeySortKeyName));
+    return table_name_to_keys;
+  }
+
+  void CreateSpanner(const string&, const string&,
+                     const string&) noexcept override {
+    spanner_client_shared_ = make_shared<Client>(connection_);
+  }
+
+  shared_ptr<Connection> connection_;
+};
+
+class GcpSpannerTest : public testing::Test {
+ protected:
+  GcpSpannerTest()
+      : connection_(make_shared<NiceMock<MockConnection>>()),
+        io_async_executor_(make_shared<MockAsyncExecutor>()),
+        config_provider_(make_shared<MockConfigProvider>()) {
+    config_provider_->Set(kGcpProjectId, "project");
+    config_provider_->Set(kSpannerInstance, "instance");
+    config_provider_->Set(kSpannerDatabase, "database");
+  }
+
+  void SetUp() override {
+    gcp_spanner_ = make_unique<TestGcpSpanner>(
+        make_shared<MockAsyncExecutor>(), io_async_executor_,
+        config_provider_, connection_);
+    EXPECT_SUCCESS(gcp_spanner_->Init());
+    EXPECT_SUCCESS(gcp_spanner_->Run());
+  }
+
+  void TearDown() override { EXPECT_SUCCESS(gcp_spanner_->Stop()); }
+
+  static shared_ptr<NoSqlDatabaseKeyValuePair> CreateKey(const string& name,
+                                                         const string& value) {
+    auto key = make_shared<NoSqlDatabaseKeyValuePair>();
+    key->attribute_name = make_shared<string>(name);
+    key->attribute_value =
+        make_shared<NoSQLDatabaseValidAttributeValueTypes>(value);
+    return key;
+  }
+
+  template <typename Request>
+  static shared_ptr<Request> CreateRequest(const string& budget_key,
+                                           const string& timeframe) {
+    auto request = make_shared<Request>();
+    request->table_name = make_shared<string>(kBudgetKeyTableName);
+    request->partition_key = CreateKey(kBudgetKeyPartitionKeyName, budget_key);
+    request->sort_key = CreateKey(kBudgetKeySortKeyName, timeframe);
+    return request;
+  }
+
+  static shared_ptr<UpsertDatabaseItemRequest> CreateUpsertRequest(
+      const string& budget_key, const string& timeframe,
+      const string& token_count, bool replace_existing_attributes) {
+    auto request =
+        CreateRequest<UpsertDatabaseItemRequest>(budget_key, timeframe);
+    request->new_attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+    request->new_attributes->push_back(*CreateKey("token_count", token_count));
+    request->replace_existing_attributes = replace_existing_attributes;
+    return request;
+  }
+
+  static Mutation CreateInsertOrUpdateMutation(const string& budget_key,
+                                               const string& timeframe,
+                                               const string& value) {
+    return MakeInsertOrUpdateMutation(
+        kBudgetKeyTableName,
+        {kBudgetKeyPartitionKeyName, kBudgetKeySortKeyName, "Value"},
+        Value(budget_key), Value(timeframe),
+        Value(optional<Json>(Json(value))));
+  }
+
+  /// Returns a stream of the rows, ending with the status.
+  static RowStream CreateRowStream(
+      vector<Row> rows, google::cloud::Status status = {}) {
+    auto source = make_unique<MockResultSetSource>();
+    auto& expectation = EXPECT_CALL(*source, NextRow);
+    for (auto& row : rows) {
+      expectation.WillOnce(Return(move(row)));
+    }
+    if (status.ok()) {
+      expectation.WillRepeatedly(Return(Row()));
+    } else {
+      expectation.WillRepeatedly(Return(status));
+    }
+    return RowStream(move(source));
+  }
+
+  shared_ptr<MockConnection> connection_;
+  shared_ptr<MockAsyncExecutor> io_async_executor_;
+  shared_ptr<MockConfigProvider> config_provider_;
+  unique_ptr<TestGcpSpanner> gcp_spanner_;
+};
+
+TEST_F(GcpSpannerTest, GetItemWithoutAttributesReadsRowByKey) {
+  EXPECT_CALL(*connection_, ExecuteQuery).Times(0);
+  EXPECT_CALL(
+      *connection_,
+      Read(AllOf(
+          Field(&Connection::ReadParams::table, Eq(kBudgetKeyTableName)),
+          Field(&Connection::ReadParams::keys,
+                Eq(KeySet().AddKey(MakeKey("budget_key", "timeframe")))),
+          Field(&Connection::ReadParams::columns, ElementsAre("Value")))))
+      .WillOnce(Return(ByMove(CreateRowStream(
+          {MakeRow(optional<Json>(Json(R"({"token_count":"1 2"})")))}))));
+
+  bool finished = false;
+  AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse> context(
+      CreateRequest<GetDatabaseItemRequest>("budget_key", "timeframe"),
+      [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        ASSERT_EQ(context.response->attributes->size(), 1);
+        const auto& attribute = context.response->attributes->at(0);
+        EXPECT_EQ(*attribute.attribute_name, "token_count");
+        EXPECT_EQ(std::get<string>(*attribute.attribute_value), "1 2");
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->GetDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, GetItemByKeyReadsNullValueAsEmptyAttributes) {
+  EXPECT_CALL(*connection_, Read)
+      .WillOnce(
+          Return(ByMove(CreateRowStream({MakeRow(optional<Json>())}))));
+
+  bool finished = false;
+  AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse> context(
+      CreateRequest<GetDatabaseItemRequest>("budget_key", "timeframe"),
+      [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_TRUE(context.response->attributes->empty());
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->GetDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, GetItemByKeyWithoutRowIsNotFound) {
+  EXPECT_CALL(*connection_, Read)
+      .WillOnce(Return(ByMove(CreateRowStream({}))));
+
+  bool finished = false;
+  AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse> context(
+      CreateRequest<GetDatabaseItemRequest>("budget_key", "timeframe"),
+      [&](auto& context) {
+        EXPECT_THAT(context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->GetDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, GetItemWithAttributesExecutesQuery) {
+  EXPECT_CALL(*connection_, Read).Times(0);
+  EXPECT_CALL(*connection_, ExecuteQuery)
+      .WillOnce(Return(ByMove(
+          CreateRowStream({MakeRow(Json(R"({"token_count":"1 2"})"))}))));
+
+  auto request =
+      CreateRequest<GetDatabaseItemRequest>("budget_key", "timeframe");
+  request->attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  request->attributes->push_back(*CreateKey("token_count", "1 2"));
+  bool finished = false;
+  AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse> context(
+      request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->attributes->size(), 1);
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->GetDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, UpsertItemReplacingAttributesWritesWithoutRead) {
+  auto mutation = CreateInsertOrUpdateMutation("budget_key", "timeframe",
+                                               R"({"token_count":"1 2"})");
+  EXPECT_CALL(*connection_, ExecuteQuery).Times(0);
+  EXPECT_CALL(*connection_,
+              Commit(FieldsAre(_, UnorderedElementsAre(mutation), _)))
+      .WillOnce(Return(CommitResult{}));
+
+  bool finished = false;
+  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse> context(
+      CreateUpsertRequest("budget_key", "timeframe", "1 2",
+                          /*replace_existing_attributes=*/true),
+      [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->UpsertDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, UpsertItemReplacingAttributesFailsIfCommitFails) {
+  EXPECT_CALL(*connection_, Commit)
+      .WillOnce(Return(google::cloud::Status(
+          google::cloud::StatusCode::kUnavailable, "unavailable")));
+
+  bool finished = false;
+  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse> context(
+      CreateUpsertRequest("budget_key", "timeframe", "1 2",
+                          /*replace_existing_attributes=*/true),
+      [&](auto& context) {
+        EXPECT_THAT(context.result, ResultIs(RetryExecutionResult(
+                                        SC_NO_SQL_DATABASE_RETRIABLE_ERROR)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->UpsertDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest,
+       UpsertItemReplacingAttributesDoesNotRetryUnretriableCommitFailures) {
+  EXPECT_CALL(*connection_, Commit)
+      .WillOnce(Return(google::cloud::Status(
+          google::cloud::StatusCode::kPermissionDenied, "denied")));
+
+  bool finished = false;
+  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse> context(
+      CreateUpsertRequest("budget_key", "timeframe", "1 2",
+                          /*replace_existing_attributes=*/true),
+      [&](auto& context) {
+        EXPECT_THAT(context.result,
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_UNRETRIABLE_ERROR)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->UpsertDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, UpsertItemMergingAttributesReadsRowInTransaction) {
+  EXPECT_CALL(*connection_, ExecuteQuery)
+      .WillOnce(Return(ByMove(CreateRowStream(
+          {MakeRow(Json(R"({"token_count":"0 0","other":"value"})"))}))));
+  auto mutation = CreateInsertOrUpdateMutation(
+      "budget_key", "timeframe", R"({"other":"value","token_count":"1 2"})");
+  EXPECT_CALL(*connection_,
+              Commit(FieldsAre(_, UnorderedElementsAre(mutation), _)))
+      .WillOnce(Return(CommitResult{}));
+
+  bool finished = false;
+  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse> context(
+      CreateUpsertRequest("budget_key", "timeframe", "1 2",
+                          /*replace_existing_attributes=*/false),
+      [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->UpsertDatabaseItem(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, BatchGetItemsReadsRowsOfATableWithOneRead) {
+  EXPECT_CALL(
+      *connection_,
+      Read(AllOf(
+          Field(&Connection::ReadParams::table, Eq(kBudgetKeyTableName)),
+          Field(&Connection::ReadParams::keys,
+                Eq(KeySet()
+                       .AddKey(MakeKey("key_1", "timeframe"))
+                       .AddKey(MakeKey("key_2", "timeframe")))),
+          Field(&Connection::ReadParams::columns,
+                ElementsAre(kBudgetKeyPartitionKeyName, kBudgetKeySortKeyName,
+                            "Value")))))
+      .WillOnce(Return(ByMove(CreateRowStream({MakeRow(
+          "key_2", "timeframe",
+          optional<Json>(Json(R"({"token_count":"1 2"})")))}))));
+
+  auto request = make_shared<BatchGetDatabaseItemsRequest>();
+  request->items = {
+      CreateRequest<GetDatabaseItemRequest>("key_1", "timeframe"),
+      CreateRequest<GetDatabaseItemRequest>("key_2", "timeframe"),
+      CreateRequest<GetDatabaseItemRequest>("key_3", "timeframe")};
+  *request->items[2]->table_name = "UnknownTable";
+  bool finished = false;
+  AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        const auto& response = *context.response;
+        EXPECT_THAT(response.item_results[0],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND)));
+        EXPECT_SUCCESS(response.item_results[1]);
+        ASSERT_EQ(response.items[1]->attributes->size(), 1);
+        EXPECT_EQ(std::get<string>(
+                      *response.items[1]->attributes->at(0).attribute_value),
+                  "1 2");
+        EXPECT_THAT(response.item_results[2],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_PROVIDER_TABLE_NOT_FOUND)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->BatchGetDatabaseItems(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, BatchGetItemsFailsOnlyTheItemsOfAFailedRead) {
+  EXPECT_CALL(*connection_, Read)
+      .WillOnce(Return(ByMove(CreateRowStream({}, google::cloud::Status(
+          google::cloud::StatusCode::kUnavailable, "unavailable")))));
+  // The item with attribute conditions is read with a query.
+  EXPECT_CALL(*connection_, ExecuteQuery)
+      .WillOnce(Return(ByMove(
+          CreateRowStream({MakeRow(Json(R"({"token_count":"1 2"})"))}))));
+
+  auto request = make_shared<BatchGetDatabaseItemsRequest>();
+  request->items = {
+      CreateRequest<GetDatabaseItemRequest>("key_1", "timeframe"),
+      CreateRequest<GetDatabaseItemRequest>("key_2", "timeframe")};
+  request->items[1]->attributes =
+      make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  request->items[1]->attributes->push_back(*CreateKey("token_count", "1 2"));
+  bool finished = false;
+  AsyncContext<BatchGetDatabaseItemsRequest, BatchGetDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_THAT(context.response->item_results[0],
+                    ResultIs(RetryExecutionResult(
+                        SC_NO_SQL_DATABASE_RETRIABLE_ERROR)));
+        EXPECT_SUCCESS(context.response->item_results[1]);
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->BatchGetDatabaseItems(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, BatchUpsertItemsCommitsMutationsOfItemsTogether) {
+  auto first_mutation = CreateInsertOrUpdateMutation(
+      "key_1", "timeframe", R"({"token_count":"1 2"})");
+  auto second_mutation = CreateInsertOrUpdateMutation(
+      "key_2", "timeframe", R"({"token_count":"3 4"})");
+  EXPECT_CALL(*connection_,
+              Commit(FieldsAre(_,
+                               ElementsAre(first_mutation, second_mutation),
+                               _)))
+      .WillOnce(Return(CommitResult{}));
+  // The item merging attributes is upserted in its own transaction.
+  EXPECT_CALL(*connection_, ExecuteQuery)
+      .WillOnce(Return(ByMove(CreateRowStream({}))));
+  auto merged_mutation = CreateInsertOrUpdateMutation(
+      "key_3", "timeframe", R"({"token_count":"5 6"})");
+  EXPECT_CALL(*connection_,
+              Commit(FieldsAre(_, ElementsAre(merged_mutation), _)))
+      .WillOnce(Return(CommitResult{}));
+
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  request->items = {
+      CreateUpsertRequest("key_1", "timeframe", "1 2",
+                          /*replace_existing_attributes=*/true),
+      CreateUpsertRequest("key_2", "timeframe", "3 4",
+                          /*replace_existing_attributes=*/true),
+      CreateUpsertRequest("key_3", "timeframe", "5 6",
+                          /*replace_existing_attributes=*/false),
+      CreateUpsertRequest("key_1", "timeframe", "7 8",
+                          /*replace_existing_attributes=*/true)};
+  bool finished = false;
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        const auto& response = *context.response;
+        EXPECT_SUCCESS(response.item_results[0]);
+        EXPECT_SUCCESS(response.item_results[1]);
+        EXPECT_SUCCESS(response.item_results[2]);
+        EXPECT_THAT(response.item_results[3],
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_DUPLICATE_BATCH_ITEM)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->BatchUpsertDatabaseItems(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, BatchUpsertItemsFailsOnlyTheItemsOfAFailedCommit) {
+  EXPECT_CALL(*connection_, Commit)
+      .WillOnce(Return(google::cloud::Status(
+          google::cloud::StatusCode::kUnavailable, "unavailable")));
+
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  request->items = {
+      CreateUpsertRequest("key_1", "timeframe", "1 2",
+                          /*replace_existing_attributes=*/true),
+      CreateUpsertRequest("key_2", "timeframe", "3 4",
+                          /*replace_existing_attributes=*/true)};
+  request->items[1]->partition_key->attribute_name =
+      make_shared<string>("UnknownKey");
+  bool finished = false;
+  AsyncContext<BatchUpsertDatabaseItemsRequest,
+               BatchUpsertDatabaseItemsResponse>
+      context(request, [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        const auto& response = *context.response;
+        EXPECT_THAT(response.item_results[0],
+                    ResultIs(RetryExecutionResult(
+                        SC_NO_SQL_DATABASE_RETRIABLE_ERROR)));
+        EXPECT_THAT(
+            response.item_results[1],
+            ResultIs(FailureExecutionResult(
+                SC_NO_SQL_DATABASE_PROVIDER_INVALID_PARTITION_KEY_NAME)));
+        finished = true;
+      });
+  EXPECT_SUCCESS(gcp_spanner_->BatchUpsertDatabaseItems(context));
+  EXPECT_TRUE(finished);
+}
+
+TEST_F(GcpSpannerTest, CallsRunOnTheSpannerCallExecutorIfConfigured) {
+  config_provider_->SetInt(kSpannerCallExecutorThreadCount, 2);
+  TestGcpSpanner gcp_spanner(make_shared<MockAsyncExecutor>(),
+                             io_async_executor_, config_provider_,
+                             connection_);
+  EXPECT_SUCCESS(gcp_spanner.Init());
+  EXPECT_SUCCESS(gcp_spanner.Run());
+
+  // The blocking Spanner calls must not hold the IO executor threads.
+  io_async_executor_->schedule_mock = [](const AsyncOperation&) {
+    ADD_FAILURE() << "Spanner call scheduled on the IO executor";
+    return FailureExecutionResult(SC_UNKNOWN);
+  };
+  EXPECT_CALL(*connection_, Read)
+      .WillOnce(Return(ByMove(CreateRowStream(
+          {MakeRow(optional<Json>(Json(R"({"token_count":"1 2"})")))}))));
+  EXPECT_CALL(*connection_, Commit).WillOnce(Return(CommitResult()));
+
+  atomic<size_t> finished_count = 0;
+  AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse> get_context(
+      CreateRequest<GetDatabaseItemRequest>("budget_key", "timeframe"),
+      [&](auto& context) {
+        EXPECT_SUCCESS(context.result);
+        finished_count++;
+      });
+  EXPECT_SUCCESS(gcp_spanner.GetDatabaseItem(get_context));
+  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
+      upsert_context(CreateUpsertRequest("budget_key", "timeframe", "1 2",
+                                         /*replace_existing_attributes=*/true),
+                     [&](auto& context) {
+                       EXPECT_SUCCESS(context.result);
+                       finished_count++;
+                     });
+  EXPECT_SUCCESS(gcp_spanner.UpsertDatabaseItem(upsert_context));
+
+  WaitUntil([&]() { return finished_count.load() == 2; });
+  EXPECT_SUCCESS(gcp_spanner.Stop());
+}
+
+}  // namespace google::scp::core::nosql_database_provider::test
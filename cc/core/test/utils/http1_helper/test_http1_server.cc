@@ -84,6 +84,9 @@ TestHttp1Server::TestHttp1Server() {
     // Attempt to handle a request for 1 second - if run_ becomes false, stop
     // accepting requests and finish.
     // If run_ is still true, continue accepting requests.
+    // ready lives on the constructor's stack, so it is only written before
+    // the constructor returns.
+    bool signaled_ready = false;
     while (run_) {
       acceptor.async_accept(socket, [this, &socket](beast::error_code ec) {
         if (!ec) {
@@ -93,7 +96,10 @@ TestHttp1Server::TestHttp1Server() {
           exit(EXIT_FAILURE);
         }
       });
-      ready = true;
+      if (!signaled_ready) {
+        signaled_ready = true;
+        ready = true;
+      }
       ioc.run_for(milliseconds(100));
       ioc.reset();
     }
@@ -206,6 +206,14 @@ class MockTransactionEngine : public core::TransactionEngine {
     return core::TransactionEngine::SerializeState(transaction, output_buffer);
   }
 
+  ExecutionResult SerializePhaseState(
+      std::shared_ptr<Transaction>& transaction,
+      transaction_manager::TransactionPhase phase,
+      BytesBuffer& output_buffer) noexcept override {
+    return core::TransactionEngine::SerializePhaseState(transaction, phase,
+                                                        output_buffer);
+  }
+
   void ProceedToNextPhase(
       transaction_manager::TransactionPhase current_phase,
       std::shared_ptr<Transaction>& transaction) noexcept override {
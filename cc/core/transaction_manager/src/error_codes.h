@@ -197,4 +197,10 @@ DEFINE_ERROR_CODE(SC_TRANSACTION_MANAGER_TRANSACTION_ALREADY_EXISTS,
                   "The entry already exists in the transaction map.",
                   HttpStatusCode::PRECONDITION_FAILED)
 
+DEFINE_ERROR_CODE(SC_TRANSACTION_MANAGER_PHASE_COLLAPSED_TRANSACTION_RECOVERED,
+                  SC_TRANSACTION_MANAGER, 0x0025,
+                  "The phase collapsed transaction was interrupted before its "
+                  "commit decision and is aborted on recovery.",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
+
 }  // namespace google::scp::core::errors
@@ -26,6 +26,7 @@
 #include <utility>
 #include <vector>
 
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/common/serialization/src/serialization.h"
 #include "core/common/time_provider/src/time_provider.h"
 #include "core/common/uuid/src/uuid.h"
@@ -40,6 +41,7 @@
 
 using google::scp::core::JournalServiceInterface;
 using google::scp::core::Version;
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::common::Serialization;
 using google::scp::core::common::TimeProvider;
 using google::scp::core::common::Uuid;
@@ -178,6 +180,12 @@ ExecutionResult TransactionEngine::Init() noexcept {
     skip_duplicate_transaction_in_recovery_ = false;
   }
 
+  execution_result = config_provider_->Get(kTransactionManagerCoalescePhaseLogs,
+                                           coalesce_phase_logs_);
+  if (!execution_result.Successful()) {
+    coalesce_phase_logs_ = false;
+  }
+
   execution_result = config_provider_->Get(
       kTransactionTimeoutInSecondsConfigName, transaction_timeout_in_seconds_);
   if (execution_result != SuccessExecutionResult()) {
@@ -824,6 +832,8 @@ ExecutionResult TransactionEngine::OnJournalServiceRecoverCallback(
     transaction_context.request->transaction_secret = transaction_secret;
     transaction_context.request->transaction_origin = transaction_origin;
     transaction_context.request->is_journal_recovery = true;
+    transaction_context.request->is_phase_collapsed =
+        transaction_log_1_0.is_phase_collapsed();
 
     for (int command_index = 0;
          command_index < transaction_log_1_0.commands_size(); ++command_index) {
@@ -954,6 +964,8 @@ ExecutionResult TransactionEngine::InitializeTransaction(
       FailureExecutionResult(errors::SC_TRANSACTION_MANAGER_NOT_FINISHED);
   transaction->is_coordinated_remotely =
       transaction_context.request->is_coordinated_remotely;
+  transaction->is_phase_collapsed =
+      transaction_context.request->is_phase_collapsed;
   transaction->transaction_secret =
       transaction_context.request->transaction_secret;
   transaction->transaction_origin =
@@ -969,6 +981,11 @@ ExecutionResult TransactionEngine::InitializeTransaction(
       return FailureExecutionResult(
           errors::SC_TRANSACTION_ENGINE_INVALID_TRANSACTION_REQUEST);
     }
+    // The remote coordinator drives the phases one by one.
+    if (transaction->is_phase_collapsed) {
+      return FailureExecutionResult(
+          errors::SC_TRANSACTION_ENGINE_INVALID_TRANSACTION_REQUEST);
+    }
   }
   transaction->is_waiting_for_remote = false;
   transaction->current_phase_execution_result = SuccessExecutionResult();
@@ -1022,6 +1039,8 @@ ExecutionResult TransactionEngine::SerializeTransaction(
   transaction_log_1_0.set_timeout(transaction->context.request->timeout_time);
   transaction_log_1_0.set_is_coordinated_remotely(
       transaction->context.request->is_coordinated_remotely);
+  transaction_log_1_0.set_is_phase_collapsed(
+      transaction->context.request->is_phase_collapsed);
 
   if (transaction->context.request->is_coordinated_remotely) {
     transaction_log_1_0.set_transaction_secret(
@@ -1053,8 +1072,8 @@ ExecutionResult TransactionEngine::SerializeTransaction(
                                       bytes_buffer.length);
   }
 
-  BytesBuffer transaction_log_1_0_bytes_buffer(
-      transaction_log_1_0.ByteSizeLong());
+  BytesBuffer transaction_log_1_0_bytes_buffer =
+      BytesBufferPool::Allocate(transaction_log_1_0.ByteSizeLong());
   size_t offset = 0;
   size_t bytes_serialized = 0;
   auto execution_result =
@@ -1075,8 +1094,8 @@ ExecutionResult TransactionEngine::SerializeTransaction(
 
   bytes_serialized = 0;
   offset = 0;
-  BytesBuffer transaction_engine_log_1_0_bytes_buffer(
-      transaction_engine_log_1_0.ByteSizeLong());
+  BytesBuffer transaction_engine_log_1_0_bytes_buffer =
+      BytesBufferPool::Allocate(transaction_engine_log_1_0.ByteSizeLong());
   execution_result =
       Serialization::SerializeProtoMessage<TransactionEngineLog_1_0>(
           transaction_engine_log_1_0_bytes_buffer, offset,
@@ -1094,7 +1113,7 @@ ExecutionResult TransactionEngine::SerializeTransaction(
   offset = 0;
   bytes_serialized = 0;
   transaction_engine_log_bytes_buffer.bytes =
-      make_shared<vector<Byte>>(transaction_engine_log.ByteSizeLong());
+      BytesBufferPool::AllocateBytes(transaction_engine_log.ByteSizeLong());
   transaction_engine_log_bytes_buffer.capacity =
       transaction_engine_log.ByteSizeLong();
   execution_result = Serialization::SerializeProtoMessage<TransactionEngineLog>(
@@ -1170,6 +1189,13 @@ void TransactionEngine::OnLogTransactionCallback(
 ExecutionResult TransactionEngine::SerializeState(
     std::shared_ptr<Transaction>& transaction,
     BytesBuffer& transaction_engine_log_bytes_buffer) noexcept {
+  return SerializePhaseState(transaction, transaction->current_phase.load(),
+                             transaction_engine_log_bytes_buffer);
+}
+
+ExecutionResult TransactionEngine::SerializePhaseState(
+    std::shared_ptr<Transaction>& transaction, TransactionPhase phase,
+    BytesBuffer& transaction_engine_log_bytes_buffer) noexcept {
   TransactionEngineLog transaction_engine_log;
   transaction_engine_log.mutable_version()->set_major(kCurrentVersion.major);
   transaction_engine_log.mutable_version()->set_minor(kCurrentVersion.minor);
@@ -1181,8 +1207,7 @@ ExecutionResult TransactionEngine::SerializeState(
   TransactionPhaseLog_1_0 transaction_phase_log_1_0;
   transaction_phase_log_1_0.mutable_id()->set_high(transaction->id.high);
   transaction_phase_log_1_0.mutable_id()->set_low(transaction->id.low);
-  transaction_phase_log_1_0.set_phase(
-      ConvertPhaseToProtoPhase(transaction->current_phase.load()));
+  transaction_phase_log_1_0.set_phase(ConvertPhaseToProtoPhase(phase));
   transaction_phase_log_1_0.set_failed(transaction->transaction_failed.load());
   transaction_phase_log_1_0.mutable_result()->set_status(
       ToStatusProto(transaction->transaction_execution_result.status));
@@ -1191,8 +1216,8 @@ ExecutionResult TransactionEngine::SerializeState(
 
   size_t offset = 0;
   size_t bytes_serialized = 0;
-  BytesBuffer transaction_phase_log_1_0_bytes_buffer(
-      transaction_phase_log_1_0.ByteSizeLong());
+  BytesBuffer transaction_phase_log_1_0_bytes_buffer =
+      BytesBufferPool::Allocate(transaction_phase_log_1_0.ByteSizeLong());
 
   auto execution_result =
       Serialization::SerializeProtoMessage<TransactionPhaseLog_1_0>(
@@ -1212,8 +1237,8 @@ ExecutionResult TransactionEngine::SerializeState(
 
   offset = 0;
   bytes_serialized = 0;
-  BytesBuffer transaction_engine_log_1_0_bytes_buffer(
-      transaction_engine_log_1_0.ByteSizeLong());
+  BytesBuffer transaction_engine_log_1_0_bytes_buffer =
+      BytesBufferPool::Allocate(transaction_engine_log_1_0.ByteSizeLong());
   execution_result =
       Serialization::SerializeProtoMessage<TransactionEngineLog_1_0>(
           transaction_engine_log_1_0_bytes_buffer, offset,
@@ -1232,7 +1257,7 @@ ExecutionResult TransactionEngine::SerializeState(
   offset = 0;
   bytes_serialized = 0;
   transaction_engine_log_bytes_buffer.bytes =
-      make_shared<vector<Byte>>(transaction_engine_log.ByteSizeLong());
+      BytesBufferPool::AllocateBytes(transaction_engine_log.ByteSizeLong());
   transaction_engine_log_bytes_buffer.capacity =
       transaction_engine_log.ByteSizeLong();
   execution_result = Serialization::SerializeProtoMessage<TransactionEngineLog>(
@@ -1300,6 +1325,54 @@ ExecutionResult TransactionEngine::LogStateAndExecuteDistributedPhase(
            this, _1, current_phase, transaction));
 }
 
+ExecutionResult TransactionEngine::LogStateWithEndStateAndProceedToNextPhase(
+    TransactionPhase current_phase,
+    shared_ptr<Transaction>& transaction) noexcept {
+  JournalLogRecord state_record;
+  state_record.component_id = kTransactionEngineId;
+  state_record.data = make_shared<BytesBuffer>();
+  auto execution_result = SerializeState(transaction, *state_record.data);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  JournalLogRecord end_state_record;
+  end_state_record.component_id = kTransactionEngineId;
+  end_state_record.data = make_shared<BytesBuffer>();
+  execution_result = SerializePhaseState(transaction, TransactionPhase::End,
+                                         *end_state_record.data);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  AsyncContext<JournalLogRequest, JournalLogResponse> journal_log_context;
+  journal_log_context.parent_activity_id = transaction->context.activity_id;
+  journal_log_context.correlation_id = transaction->context.correlation_id;
+  journal_log_context.request = make_shared<JournalLogRequest>();
+  journal_log_context.request->component_id = kTransactionEngineId;
+  journal_log_context.request->log_id = Uuid::GenerateUuid();
+  journal_log_context.request->log_status = JournalLogStatus::Log;
+  journal_log_context.request->records = {move(state_record),
+                                          move(end_state_record)};
+  journal_log_context.callback =
+      bind(&TransactionEngine::OnLogStateAndProceedToNextPhaseCallback, this,
+           _1, current_phase, transaction);
+
+  // The log is retried until it succeeds, and the end phase is only reached
+  // after that.
+  transaction->is_end_phase_logged = true;
+  operation_dispatcher_
+      .Dispatch<AsyncContext<JournalLogRequest, JournalLogResponse>>(
+          journal_log_context,
+          [journal_service = journal_service_](
+              AsyncContext<JournalLogRequest, JournalLogResponse>&
+                  journal_log_context) {
+            return journal_service->Log(journal_log_context);
+          });
+
+  return SuccessExecutionResult();
+}
+
 void TransactionEngine::OnLogStateAndProceedToNextPhaseCallback(
     AsyncContext<JournalLogRequest, JournalLogResponse>& journal_log_context,
     TransactionPhase current_phase,
@@ -1615,6 +1688,17 @@ ExecutionResult TransactionEngine::Checkpoint(
 
 void TransactionEngine::ProceedToNextPhaseAfterRecovery(
     shared_ptr<Transaction>& transaction) noexcept {
+  // Phase collapsed transactions do not journal the phases before their commit
+  // decision, so their commands may have been prepared or committed. Nothing
+  // has been notified yet, so they can always be aborted.
+  if (transaction->is_phase_collapsed &&
+      transaction->current_phase < TransactionPhase::CommitNotify) {
+    transaction->current_phase = TransactionPhase::AbortNotify;
+    transaction->transaction_failed = true;
+    transaction->transaction_execution_result = FailureExecutionResult(
+        errors::SC_TRANSACTION_MANAGER_PHASE_COLLAPSED_TRANSACTION_RECOVERED);
+  }
+
   switch (transaction->current_phase) {
     case TransactionPhase::NotStarted:
     case TransactionPhase::Begin:
@@ -1673,6 +1757,12 @@ void TransactionEngine::ProceedToNextPhase(
       transaction->context.response->transaction_id = transaction->id;
       transaction->context.response->last_execution_timestamp =
           transaction->last_execution_timestamp;
+      for (auto failed_index : transaction->failed_command_indices) {
+        transaction->context.response->failed_commands_indices.push_back(
+            failed_index);
+        transaction->context.response->failed_commands.push_back(
+            transaction->context.request->commands[failed_index]);
+      }
       transaction->context.result =
           transaction->transaction_failed
               ? transaction->transaction_execution_result
@@ -1719,6 +1809,7 @@ void TransactionEngine::ProceedToNextPhase(
     if (transaction->transaction_failed.compare_exchange_strong(failed, true)) {
       transaction->transaction_execution_result =
           transaction->current_phase_execution_result;
+      transaction->failed_command_indices = failed_indices;
     }
     // Reset the state before continuing to the next phase.
     transaction->current_phase_failed = false;
@@ -1815,11 +1906,19 @@ void TransactionEngine::BeginTransaction(
 
 void TransactionEngine::PrepareTransaction(
     shared_ptr<Transaction>& transaction) noexcept {
+  if (transaction->is_phase_collapsed) {
+    ExecuteDistributedPhase(TransactionPhase::Prepare, transaction);
+    return;
+  }
   LogStateAndExecuteDistributedPhase(TransactionPhase::Prepare, transaction);
 }
 
 void TransactionEngine::CommitTransaction(
     shared_ptr<Transaction>& transaction) noexcept {
+  if (transaction->is_phase_collapsed) {
+    ExecuteDistributedPhase(TransactionPhase::Commit, transaction);
+    return;
+  }
   LogStateAndExecuteDistributedPhase(TransactionPhase::Commit, transaction);
 }
 
@@ -1831,22 +1930,50 @@ void TransactionEngine::CommitNotifyTransaction(
 
 void TransactionEngine::CommittedTransaction(
     shared_ptr<Transaction>& transaction) noexcept {
+  if (transaction->is_phase_collapsed) {
+    ProceedToNextPhase(TransactionPhase::Committed, transaction);
+    return;
+  }
+  if (coalesce_phase_logs_) {
+    LogStateWithEndStateAndProceedToNextPhase(TransactionPhase::Committed,
+                                              transaction);
+    return;
+  }
   LogStateAndProceedToNextPhase(TransactionPhase::Committed, transaction);
 }
 
 void TransactionEngine::AbortNotifyTransaction(
     shared_ptr<Transaction>& transaction) noexcept {
+  // Aborting is idempotent, and a phase collapsed transaction is aborted again
+  // if it is recovered before its end.
+  if (transaction->is_phase_collapsed) {
+    ExecuteDistributedPhase(TransactionPhase::AbortNotify, transaction);
+    return;
+  }
   LogStateAndExecuteDistributedPhase(TransactionPhase::AbortNotify,
                                      transaction);
 }
 
 void TransactionEngine::AbortedTransaction(
     shared_ptr<Transaction>& transaction) noexcept {
+  if (transaction->is_phase_collapsed) {
+    ProceedToNextPhase(TransactionPhase::Aborted, transaction);
+    return;
+  }
+  if (coalesce_phase_logs_) {
+    LogStateWithEndStateAndProceedToNextPhase(TransactionPhase::Aborted,
+                                              transaction);
+    return;
+  }
   LogStateAndProceedToNextPhase(TransactionPhase::Aborted, transaction);
 }
 
 void TransactionEngine::EndTransaction(
     shared_ptr<Transaction>& transaction) noexcept {
+  if (transaction->is_end_phase_logged) {
+    ExecuteDistributedPhase(TransactionPhase::End, transaction);
+    return;
+  }
   LogStateAndExecuteDistributedPhase(TransactionPhase::End, transaction);
 }
 
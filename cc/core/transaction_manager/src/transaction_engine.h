@@ -70,6 +70,8 @@ struct Transaction : public LoadableObject {
         current_phase_failed_command_indices(INT32_MAX),
         last_execution_timestamp(0),
         is_coordinated_remotely(false),
+        is_phase_collapsed(false),
+        is_end_phase_logged(false),
         is_waiting_for_remote(false) {}
 
   /// The current transaction id.
@@ -100,6 +102,10 @@ struct Transaction : public LoadableObject {
   /// The commands that failed in the current phase.
   common::ConcurrentQueue<size_t> current_phase_failed_command_indices;
 
+  /// The commands that failed the transaction, reported to the caller of a
+  /// locally coordinated transaction once it ends.
+  std::list<size_t> failed_command_indices;
+
   /// Last execution timestamp of any phases of the current transaction to
   /// support optimistic concurrency. This timestamp needs to be wall-clock
   /// timestamp.
@@ -109,6 +115,14 @@ struct Transaction : public LoadableObject {
   /// manager.
   bool is_coordinated_remotely;
 
+  /// Indicates whether only the commit decision and the end of the transaction
+  /// are journaled on top of the transaction itself.
+  bool is_phase_collapsed;
+
+  /// Indicates whether the state of the end phase has already been journaled
+  /// together with the state of the phase before it.
+  bool is_end_phase_logged;
+
   /// Indicates whether the transaction is waiting for a remote command from
   /// either remote transaction manager, or remote PBS instance in the case of
   /// transaction resolution after transaction expiry.
@@ -219,6 +233,8 @@ class TransactionEngine
             transaction_engine_cache_lifetime_seconds),
         config_provider_(config_provider),
         skip_log_recovery_failures_(false),
+        skip_duplicate_transaction_in_recovery_(false),
+        coalesce_phase_logs_(false),
         transaction_timeout_in_seconds_(kTransactionTimeoutSeconds),
         transaction_resolution_with_remote_enabled_(true),
         activity_id_(core::common::Uuid::GenerateUuid()) {}
@@ -405,6 +421,21 @@ class TransactionEngine
       std::shared_ptr<Transaction>& transaction,
       BytesBuffer& output_buffer) noexcept;
 
+  /**
+   * @brief Serializes the provided transaction state as if the transaction was
+   * in the provided phase and writes the output in the output_buffer.
+   *
+   * @param transaction The transaction state to be serialized.
+   * @param phase The phase to serialize the transaction state with.
+   * @param output_buffer The output buffer to write the serialized transaction
+   * state to.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual ExecutionResult SerializePhaseState(
+      std::shared_ptr<Transaction>& transaction,
+      transaction_manager::TransactionPhase phase,
+      BytesBuffer& output_buffer) noexcept;
+
   /**
    * @brief Logs the transaction object and then proceeds to the next phase of
    * the transaction. This is always called before the transaction starts to
@@ -468,6 +499,21 @@ class TransactionEngine
       transaction_manager::TransactionPhase current_phase,
       std::shared_ptr<Transaction>& transaction) noexcept;
 
+  /**
+   * @brief Logs the transaction's current state together with the state of
+   * its end phase as a single journal entry, and then proceeds to the end
+   * phase, which does not log its state again. Nothing is executed between the
+   * committed or aborted phase and the end phase of a local transaction, so
+   * both of their states can be made durable at once.
+   *
+   * @param current_phase The current phase of the transaction.
+   * @param transaction The transaction object.
+   * @return ExecutionResult
+   */
+  virtual ExecutionResult LogStateWithEndStateAndProceedToNextPhase(
+      transaction_manager::TransactionPhase current_phase,
+      std::shared_ptr<Transaction>& transaction) noexcept;
+
   /**
    * @brief Is called once the journaling operation is completed and the state
    * machine is about to proceed.
@@ -763,6 +809,10 @@ class TransactionEngine
   /// Whether to skip duplicate transaction during recovery.
   bool skip_duplicate_transaction_in_recovery_;
 
+  /// Whether to journal the states of the back to back phases of a local
+  /// transaction as a single journal entry.
+  bool coalesce_phase_logs_;
+
   /// Transaction lifetime in seconds
   size_t transaction_timeout_in_seconds_;
 
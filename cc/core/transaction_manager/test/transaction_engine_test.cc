@@ -2746,6 +2746,229 @@ TEST_F(TransactionEngineTest, ProceedToNextPhaseAfterRecovery) {
   }
 }
 
+TEST_F(TransactionEngineTest, PhaseCollapsedTransactionLogsOnlyCommitDecision) {
+  auto mock_journal_service = make_shared<MockJournalService>();
+  shared_ptr<JournalServiceInterface> journal_service =
+      static_pointer_cast<JournalServiceInterface>(mock_journal_service);
+  shared_ptr<TransactionCommandSerializerInterface>
+      mock_transaction_command_serializer =
+          make_shared<MockTransactionCommandSerializer>();
+  shared_ptr<AsyncExecutorInterface> async_executor =
+      make_shared<MockAsyncExecutorWithInternals>(2, 100);
+  shared_ptr<RemoteTransactionManagerInterface> remote_transaction_manager;
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  MockTransactionEngine mock_transaction_engine(
+      async_executor, mock_transaction_command_serializer, journal_service,
+      remote_transaction_manager, mock_metric_client);
+
+  vector<TransactionPhase> logged_phases;
+  vector<TransactionPhase> executed_phases;
+  mock_transaction_engine.log_state_and_execute_distributed_phase_mock =
+      [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+        logged_phases.push_back(phase);
+        return SuccessExecutionResult();
+      };
+  mock_transaction_engine.log_state_and_proceed_to_next_phase_mock =
+      [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+        logged_phases.push_back(phase);
+        return SuccessExecutionResult();
+      };
+  mock_transaction_engine.execute_distributed_phase_mock =
+      [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+        executed_phases.push_back(phase);
+      };
+  mock_transaction_engine.proceed_to_next_phase_mock =
+      [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+        executed_phases.push_back(phase);
+      };
+
+  auto transaction = make_shared<Transaction>();
+  transaction->is_phase_collapsed = true;
+  transaction->context.request = make_shared<TransactionRequest>();
+  mock_transaction_engine.PrepareTransaction(transaction);
+  mock_transaction_engine.CommitTransaction(transaction);
+  mock_transaction_engine.CommitNotifyTransaction(transaction);
+  mock_transaction_engine.CommittedTransaction(transaction);
+  mock_transaction_engine.AbortNotifyTransaction(transaction);
+  mock_transaction_engine.AbortedTransaction(transaction);
+
+  // Only the commit decision is logged, the transaction itself and its end are
+  // logged as for any other transaction.
+  EXPECT_EQ(logged_phases,
+            vector<TransactionPhase>({TransactionPhase::CommitNotify}));
+  EXPECT_EQ(executed_phases,
+            vector<TransactionPhase>(
+                {TransactionPhase::Prepare, TransactionPhase::Commit,
+                 TransactionPhase::Committed, TransactionPhase::AbortNotify,
+                 TransactionPhase::Aborted}));
+}
+
+TEST_F(TransactionEngineTest, PhaseCollapsedTransactionRemotelyCoordinated) {
+  auto mock_journal_service = make_shared<MockJournalService>();
+  shared_ptr<JournalServiceInterface> journal_service =
+      static_pointer_cast<JournalServiceInterface>(mock_journal_service);
+  shared_ptr<TransactionCommandSerializerInterface>
+      mock_transaction_command_serializer =
+          make_shared<MockTransactionCommandSerializer>();
+  shared_ptr<AsyncExecutorInterface> async_executor =
+      make_shared<MockAsyncExecutorWithInternals>(2, 100);
+  shared_ptr<RemoteTransactionManagerInterface> remote_transaction_manager;
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  MockTransactionEngine mock_transaction_engine(
+      async_executor, mock_transaction_command_serializer, journal_service,
+      remote_transaction_manager, mock_metric_client);
+
+  AsyncContext<TransactionRequest, TransactionResponse> transaction_context;
+  transaction_context.request = make_shared<TransactionRequest>();
+  transaction_context.request->transaction_id = Uuid::GenerateUuid();
+  transaction_context.request->is_coordinated_remotely = true;
+  transaction_context.request->is_phase_collapsed = true;
+  transaction_context.request->transaction_secret =
+      make_shared<string>("secret");
+  transaction_context.request->transaction_origin =
+      make_shared<string>("origin");
+
+  shared_ptr<Transaction> transaction;
+  EXPECT_THAT(mock_transaction_engine.InitializeTransaction(transaction_context,
+                                                            transaction),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_TRANSACTION_ENGINE_INVALID_TRANSACTION_REQUEST)));
+}
+
+TEST_F(TransactionEngineTest, ProceedToNextPhaseAfterRecoveryPhaseCollapsed) {
+  auto mock_journal_service = make_shared<MockJournalService>();
+  shared_ptr<JournalServiceInterface> journal_service =
+      static_pointer_cast<JournalServiceInterface>(mock_journal_service);
+  shared_ptr<TransactionCommandSerializerInterface>
+      mock_transaction_command_serializer =
+          make_shared<MockTransactionCommandSerializer>();
+  shared_ptr<AsyncExecutorInterface> async_executor =
+      make_shared<MockAsyncExecutorWithInternals>(2, 100);
+  shared_ptr<RemoteTransactionManagerInterface> remote_transaction_manager;
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  MockTransactionEngine mock_transaction_engine(
+      async_executor, mock_transaction_command_serializer, journal_service,
+      remote_transaction_manager, mock_metric_client);
+
+  // Transactions are aborted unless their commit decision was logged.
+  vector<TransactionPhase> current_phases = {
+      TransactionPhase::NotStarted, TransactionPhase::Begin,
+      TransactionPhase::Prepare, TransactionPhase::Commit,
+      TransactionPhase::CommitNotify};
+  vector<TransactionPhase> next_phases = {
+      TransactionPhase::AbortNotify, TransactionPhase::AbortNotify,
+      TransactionPhase::AbortNotify, TransactionPhase::AbortNotify,
+      TransactionPhase::CommitNotify};
+
+  for (size_t i = 0; i < current_phases.size(); ++i) {
+    TransactionPhase executed_phase = TransactionPhase::Unknown;
+    mock_transaction_engine.execute_distributed_phase_mock =
+        [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+          executed_phase = phase;
+        };
+    mock_transaction_engine.log_state_and_execute_distributed_phase_mock =
+        [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+          executed_phase = phase;
+          return SuccessExecutionResult();
+        };
+
+    auto transaction = make_shared<Transaction>();
+    transaction->is_phase_collapsed = true;
+    transaction->current_phase = current_phases[i];
+    transaction->context.request = make_shared<TransactionRequest>();
+
+    mock_transaction_engine.ProceedToNextPhaseAfterRecovery(transaction);
+
+    EXPECT_EQ(executed_phase, next_phases[i]);
+    EXPECT_EQ(transaction->transaction_failed.load(),
+              next_phases[i] == TransactionPhase::AbortNotify);
+    if (next_phases[i] == TransactionPhase::AbortNotify) {
+      auto recovered_error_code =
+          errors::SC_TRANSACTION_MANAGER_PHASE_COLLAPSED_TRANSACTION_RECOVERED;
+      EXPECT_THAT(transaction->transaction_execution_result,
+                  ResultIs(FailureExecutionResult(recovered_error_code)));
+    }
+  }
+}
+
+TEST_F(TransactionEngineTest, CoalescedPhaseLogsJournalEndStateOnce) {
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  mock_config_provider->SetBool(kTransactionManagerCoalescePhaseLogs, true);
+  auto mock_journal_service = make_shared<MockJournalService>();
+  shared_ptr<JournalServiceInterface> journal_service =
+      static_pointer_cast<JournalServiceInterface>(mock_journal_service);
+  shared_ptr<TransactionCommandSerializerInterface>
+      mock_transaction_command_serializer =
+          make_shared<MockTransactionCommandSerializer>();
+  shared_ptr<AsyncExecutorInterface> async_executor =
+      make_shared<MockAsyncExecutorWithInternals>(2, 100);
+  shared_ptr<RemoteTransactionManagerInterface> remote_transaction_manager;
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  MockTransactionEngine mock_transaction_engine(
+      async_executor, mock_transaction_command_serializer, journal_service,
+      remote_transaction_manager, mock_metric_client, mock_config_provider);
+  EXPECT_SUCCESS(mock_transaction_engine.Init());
+
+  vector<shared_ptr<JournalLogRequest>> log_requests;
+  mock_journal_service->log_mock =
+      [&](AsyncContext<JournalLogRequest, JournalLogResponse>& log_context) {
+        log_requests.push_back(log_context.request);
+        log_context.result = SuccessExecutionResult();
+        log_context.Finish();
+        return SuccessExecutionResult();
+      };
+  vector<TransactionPhase> executed_phases;
+  mock_transaction_engine.execute_distributed_phase_mock =
+      [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+        executed_phases.push_back(phase);
+      };
+  mock_transaction_engine.proceed_to_next_phase_mock =
+      [&](TransactionPhase phase, shared_ptr<Transaction>& transaction) {
+        executed_phases.push_back(phase);
+      };
+
+  for (auto phase : {TransactionPhase::Committed, TransactionPhase::Aborted}) {
+    log_requests.clear();
+    executed_phases.clear();
+    auto transaction = make_shared<Transaction>();
+    transaction->id = Uuid::GenerateUuid();
+    transaction->context.request = make_shared<TransactionRequest>();
+    transaction->current_phase = phase;
+    if (phase == TransactionPhase::Committed) {
+      mock_transaction_engine.CommittedTransaction(transaction);
+    } else {
+      mock_transaction_engine.AbortedTransaction(transaction);
+    }
+
+    // The states of the phase and of the end are journaled as one entry.
+    ASSERT_EQ(log_requests.size(), 1);
+    EXPECT_EQ(log_requests[0]->data, nullptr);
+    ASSERT_EQ(log_requests[0]->records.size(), 2);
+    BytesBuffer state;
+    EXPECT_SUCCESS(mock_transaction_engine.SerializeState(transaction, state));
+    BytesBuffer end_state;
+    EXPECT_SUCCESS(mock_transaction_engine.SerializePhaseState(
+        transaction, TransactionPhase::End, end_state));
+    vector<BytesBuffer> expected_records = {state, end_state};
+    for (size_t i = 0; i < expected_records.size(); ++i) {
+      const auto& record = log_requests[0]->records[i];
+      EXPECT_EQ(record.component_id, log_requests[0]->component_id);
+      EXPECT_EQ(vector<Byte>(record.data->bytes->begin(),
+                             record.data->bytes->begin() + record.data->length),
+                vector<Byte>(expected_records[i].bytes->begin(),
+                             expected_records[i].bytes->begin() +
+                                 expected_records[i].length));
+    }
+
+    // The end phase does not journal its state again.
+    transaction->current_phase = TransactionPhase::End;
+    mock_transaction_engine.EndTransaction(transaction);
+    EXPECT_EQ(log_requests.size(), 1);
+    EXPECT_EQ(executed_phases,
+              vector<TransactionPhase>({phase, TransactionPhase::End}));
+  }
+}
+
 TEST_F(TransactionEngineTest, Checkpoint) {
   auto mock_journal_service = make_shared<MockJournalService>();
   shared_ptr<JournalServiceInterface> journal_service =
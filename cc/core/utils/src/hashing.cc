@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <openssl/md5.h>
 
@@ -27,7 +28,9 @@
 
 using google::scp::core::BytesBuffer;
 using std::make_unique;
+using std::shared_ptr;
 using std::string;
+using std::vector;
 
 namespace google::scp::core::utils {
 ExecutionResultOr<string> CalculateMd5Hash(const BytesBuffer& buffer) {
@@ -59,6 +62,26 @@ ExecutionResultOr<string> CalculateMd5Hash(const string& buffer) {
   return string(reinterpret_cast<char*>(digest_length), MD5_DIGEST_LENGTH);
 }
 
+ExecutionResultOr<string> CalculateMd5Hash(
+    const vector<shared_ptr<BytesBuffer>>& buffers) {
+  unsigned char digest_length[MD5_DIGEST_LENGTH];
+  MD5_CTX md5_context;
+  MD5_Init(&md5_context);
+  size_t length = 0;
+  for (const auto& buffer : buffers) {
+    if (buffer->length > 0) {
+      MD5_Update(&md5_context, buffer->bytes->data(), buffer->length);
+      length += buffer->length;
+    }
+  }
+  if (length == 0) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+
+  MD5_Final(digest_length, &md5_context);
+  return string(reinterpret_cast<char*>(digest_length), MD5_DIGEST_LENGTH);
+}
+
 ExecutionResult CalculateMd5Hash(const BytesBuffer& buffer, string& checksum) {
   ASSIGN_OR_RETURN(checksum, CalculateMd5Hash(buffer));
   return SuccessExecutionResult();
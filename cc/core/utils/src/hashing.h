@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "core/interface/type_def.h"
 #include "public/core/interface/execution_result.h"
@@ -34,6 +36,10 @@ ExecutionResultOr<std::string> CalculateMd5Hash(const BytesBuffer& buffer);
 // Same as above but accepts a string.
 ExecutionResultOr<std::string> CalculateMd5Hash(const std::string& buffer);
 
+// Same as above but hashes the buffers one after another.
+ExecutionResultOr<std::string> CalculateMd5Hash(
+    const std::vector<std::shared_ptr<BytesBuffer>>& buffers);
+
 // DEPRECATED, please use the above options.
 ExecutionResult CalculateMd5Hash(const BytesBuffer& buffer,
                                  std::string& checksum);
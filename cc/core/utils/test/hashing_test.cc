@@ -28,6 +28,7 @@ using google::scp::core::BytesBuffer;
 using google::scp::core::test::IsSuccessfulAndHolds;
 using google::scp::core::test::ResultIs;
 using std::make_shared;
+using std::shared_ptr;
 using std::string;
 using std::vector;
 
@@ -63,6 +64,23 @@ TEST(HashingTest, ValidMD5HashOLD) {
   EXPECT_EQ(md5_hash, "!\x87\x9D\x8C\x7Fy\x93j\xCD\xB6\xE2\x86&\xEA\x1B\xD8");
 }
 
+TEST(HashingTest, ValidMD5HashOfSegments) {
+  string value("this_is_a_test_string");
+  vector<shared_ptr<BytesBuffer>> buffers;
+  buffers.push_back(make_shared<BytesBuffer>(value.substr(0, 8)));
+  buffers.push_back(make_shared<BytesBuffer>(0));
+  buffers.push_back(make_shared<BytesBuffer>(value.substr(8)));
+
+  EXPECT_THAT(CalculateMd5Hash(buffers),
+              IsSuccessfulAndHolds(
+                  "!\x87\x9D\x8C\x7Fy\x93j\xCD\xB6\xE2\x86&\xEA\x1B\xD8"));
+
+  buffers = {make_shared<BytesBuffer>(0)};
+  EXPECT_THAT(
+      CalculateMd5Hash(buffers),
+      ResultIs(FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT)));
+}
+
 TEST(HashingTest, InvalidMD5HashString) {
   string empty;
 
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -114,17 +115,21 @@ using google::scp::core::utils::Base64Encode;
 using google::scp::core::utils::CalculateMd5Hash;
 using google::scp::cpio::client_providers::AwsInstanceClientUtils;
 using std::bind;
+using std::function;
+using std::lock_guard;
 using std::make_shared;
 using std::move;
+using std::mutex;
 using std::optional;
+using std::pair;
 using std::shared_ptr;
 using std::string;
 using std::stringstream;
 using std::vector;
+using std::weak_ptr;
 using std::chrono::duration_cast;
 using std::chrono::minutes;
 using std::chrono::nanoseconds;
-using std::chrono::seconds;
 using std::placeholders::_1;
 using std::placeholders::_2;
 using std::placeholders::_3;
@@ -140,7 +145,6 @@ constexpr nanoseconds kDefaultStreamKeepaliveNanos =
     duration_cast<nanoseconds>(minutes(5));
 constexpr nanoseconds kMaximumStreamKeepaliveNanos =
     duration_cast<nanoseconds>(minutes(10));
-constexpr seconds kPutBlobRescanTime = seconds(5);
 
 template <typename Context, typename Request>
 ExecutionResult SetContentMd5(Context& context, Request& request,
@@ -310,60 +314,80 @@ ExecutionResult AwsS3ClientProvider::GetBlobStream(
   tracker->max_bytes_per_response = request.max_bytes_per_response() == 0
                                         ? k64KbCount
                                         : request.max_bytes_per_response();
-  size_t read_size = tracker->max_bytes_per_response;
 
   // If the end index is out of bounds of the object, that's fine - S3 will
   // truncate the response to the end of the object. If the begin index is out
   // of bounds, S3 will fail but this is OK to propagate to the client.
-  optional<string> range;
+  // The size of the object is only known once the first range completes, so
+  // the readahead starts after it.
+  int64_t begin_index = 0;
+  // We end one space before the read size since ranges are inclusive on both
+  // ends.
+  int64_t end_index = tracker->max_bytes_per_response - 1;
   if (request.has_byte_range()) {
     // The initial value should be
     // <begin_index, min(begin_index + read_size - 1, end_index)>
-    auto end_index =
-        std::min(request.byte_range().end_byte_index(),
-                 request.byte_range().begin_byte_index() + read_size - 1);
-    // SetRange is inclusive on both ends.
-    range = absl::StrCat("bytes=", request.byte_range().begin_byte_index(), "-",
-                         end_index);
-    tracker->last_begin_byte_index = request.byte_range().begin_byte_index();
-    tracker->last_end_byte_index = end_index;
-  } else {
-    // We end one space before the read size since SetRange is inclusive on both
-    // ends.
-    range = absl::StrCat("bytes=", 0, "-", read_size - 1);
-    tracker->last_begin_byte_index = 0;
-    tracker->last_end_byte_index = read_size - 1;
+    begin_index = request.byte_range().begin_byte_index();
+    end_index =
+        std::min(static_cast<int64_t>(request.byte_range().end_byte_index()),
+                 begin_index + tracker->max_bytes_per_response - 1);
   }
+  tracker->next_begin_byte_index = end_index + 1;
+  tracker->next_push_byte_index = begin_index;
+
+  GetObjectRange(get_blob_stream_context, tracker, {begin_index, end_index});
+  return SuccessExecutionResult();
+}
 
+void AwsS3ClientProvider::GetObjectRange(
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>&
+        get_blob_stream_context,
+    shared_ptr<GetBlobStreamTracker> tracker,
+    pair<int64_t, int64_t> byte_range) noexcept {
+  // SetRange is inclusive on both ends.
+  optional<string> range =
+      absl::StrCat("bytes=", byte_range.first, "-", byte_range.second);
   s3_client_->GetObjectAsync(
-      MakeGetObjectRequest(request, move(range)),
+      MakeGetObjectRequest(*get_blob_stream_context.request, move(range)),
       bind(&AwsS3ClientProvider::OnGetObjectStreamCallback, this,
-           get_blob_stream_context, tracker, _1, _2, _3, _4),
+           get_blob_stream_context, tracker, byte_range.first,
+           byte_range.second, _1, _2, _3, _4),
       nullptr);
+}
 
-  return SuccessExecutionResult();
+void AwsS3ClientProvider::FinishGetBlobStream(
+    ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>&
+        get_blob_stream_context,
+    GetBlobStreamTracker& tracker, const ExecutionResult& result) noexcept {
+  if (tracker.is_finished) {
+    return;
+  }
+  tracker.is_finished = true;
+  tracker.completed_responses.clear();
+  get_blob_stream_context.result = result;
+  FinishStreamingContext(result, get_blob_stream_context, cpu_async_executor_,
+                         AsyncPriority::High);
 }
 
 void AwsS3ClientProvider::OnGetObjectStreamCallback(
     ConsumerStreamingContext<GetBlobStreamRequest, GetBlobStreamResponse>&
         get_blob_stream_context,
-    shared_ptr<GetBlobStreamTracker> tracker, const S3Client* s3_client,
+    shared_ptr<GetBlobStreamTracker> tracker, int64_t begin_byte_index,
+    int64_t end_byte_index, const S3Client* s3_client,
     const GetObjectRequest& get_object_request,
     GetObjectOutcome get_object_outcome,
     const shared_ptr<const AsyncCallerContext> async_context) noexcept {
   if (!get_object_outcome.IsSuccess()) {
-    get_blob_stream_context.result =
-        AwsS3Utils::ConvertS3ErrorToExecutionResult(
-            get_object_outcome.GetError().GetErrorType());
+    auto result = AwsS3Utils::ConvertS3ErrorToExecutionResult(
+        get_object_outcome.GetError().GetErrorType());
 
     SCP_ERROR_CONTEXT(
-        kAwsS3Provider, get_blob_stream_context, get_blob_stream_context.result,
+        kAwsS3Provider, get_blob_stream_context, result,
         "Get blob stream request failed. Error code: %d, message: %s",
         get_object_outcome.GetError().GetResponseCode(),
         get_object_outcome.GetError().GetMessage().c_str());
-    FinishStreamingContext(get_blob_stream_context.result,
-                           get_blob_stream_context, cpu_async_executor_,
-                           AsyncPriority::High);
+    lock_guard<mutex> lock(tracker->mutex);
+    FinishGetBlobStream(get_blob_stream_context, *tracker, result);
     return;
   }
   if (get_blob_stream_context.IsCancelled()) {
@@ -371,113 +395,152 @@ void AwsS3ClientProvider::OnGetObjectStreamCallback(
         SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
     SCP_WARNING_CONTEXT(kAwsS3Provider, get_blob_stream_context,
                         "Get blob stream request was cancelled.");
-    FinishStreamingContext(result, get_blob_stream_context,
-                           cpu_async_executor_);
+    lock_guard<mutex> lock(tracker->mutex);
+    FinishGetBlobStream(get_blob_stream_context, *tracker, result);
     return;
   }
 
   auto& request = *get_blob_stream_context.request;
 
   auto& result = get_object_outcome.GetResult();
-  // ContentLength contains the actual amount of bytes in this read.
+  // ContentLength contains the actual amount of bytes in this read, which is
+  // less than requested for the last range of the object.
   auto actual_length_read = result.GetContentLength();
-  // If the amount read is less than the amount we told it to read, reset
-  // end_index.
-  if (actual_length_read <
-      (1 + tracker->last_end_byte_index - tracker->last_begin_byte_index)) {
-    tracker->last_end_byte_index =
-        tracker->last_begin_byte_index + actual_length_read - 1;
-  }
 
-  // Populate the response and push.
+  // Populate the response.
   GetBlobStreamResponse response;
   response.mutable_blob_portion()->mutable_metadata()->CopyFrom(
       request.blob_metadata());
-  response.mutable_byte_range()->set_begin_byte_index(
-      tracker->last_begin_byte_index);
-  response.mutable_byte_range()->set_end_byte_index(
-      tracker->last_end_byte_index);
+  response.mutable_byte_range()->set_begin_byte_index(begin_byte_index);
+  response.mutable_byte_range()->set_end_byte_index(begin_byte_index +
+                                                    actual_length_read - 1);
   response.mutable_blob_portion()->mutable_data()->resize(actual_length_read);
   auto& body = result.GetBody();
   if (!body.read(response.mutable_blob_portion()->mutable_data()->data(),
                  actual_length_read)) {
-    get_blob_stream_context.result =
+    auto read_result =
         FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
-    SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_stream_context,
-                      get_blob_stream_context.result,
+    SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_stream_context, read_result,
                       "Reading GetBlobStream body failed");
-    FinishStreamingContext(get_blob_stream_context.result,
-                           get_blob_stream_context, cpu_async_executor_);
+    lock_guard<mutex> lock(tracker->mutex);
+    FinishGetBlobStream(get_blob_stream_context, *tracker, read_result);
     return;
   }
 
-  auto push_result = get_blob_stream_context.TryPushResponse(move(response));
-  if (!push_result.Successful()) {
-    get_blob_stream_context.result = push_result;
-    SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_stream_context, push_result,
-                      "Failed to push new message.");
-    FinishStreamingContext(push_result, get_blob_stream_context,
-                           cpu_async_executor_);
-    return;
-  }
-  // Schedule processing the next message.
-  auto schedule_result = cpu_async_executor_->Schedule(
-      [get_blob_stream_context]() mutable {
-        get_blob_stream_context.ProcessNextMessage();
-      },
-      AsyncPriority::Normal);
-  if (!schedule_result.Successful()) {
-    get_blob_stream_context.result = schedule_result;
-    SCP_ERROR_CONTEXT(
-        kAwsS3Provider, get_blob_stream_context, get_blob_stream_context.result,
-        "Get blob stream process next message failed to be scheduled");
-    FinishStreamingContext(schedule_result, get_blob_stream_context,
-                           cpu_async_executor_);
-    return;
-  }
-  // ContentLength contains info only about the acquired contents,
-  // ContentRange contains the total size of the object.
-  // ContentRange is of the form "bytes 0-83886079/1258291200"
-  // 0 - the begin index of the response
-  // 83886079 - the end index of the response
-  // 1258291200 - the total size of the object in storage.
-  vector<string> total_length_str =
-      absl::StrSplit(result.GetContentRange(), "/");
-  int64_t total_length = strtol(total_length_str[1].c_str(), nullptr, 10);
-  // Now we know the total size of the object.
-  bool is_all_object_downloaded =
-      tracker->last_end_byte_index >= (total_length - 1);
-  bool is_end_index_reached =
-      tracker->last_end_byte_index == request.byte_range().end_byte_index();
-  if (is_all_object_downloaded || is_end_index_reached) {
-    FinishStreamingContext(SuccessExecutionResult(), get_blob_stream_context,
-                           cpu_async_executor_);
-    return;
-  }
+  vector<pair<int64_t, int64_t>> ranges_to_get;
+  {
+    lock_guard<mutex> lock(tracker->mutex);
+    if (tracker->is_finished) {
+      return;
+    }
+    if (!tracker->end_byte_index.has_value()) {
+      // ContentLength contains info only about the acquired contents,
+      // ContentRange contains the total size of the object.
+      // ContentRange is of the form "bytes 0-83886079/1258291200"
+      // 0 - the begin index of the response
+      // 83886079 - the end index of the response
+      // 1258291200 - the total size of the object in storage.
+      vector<string> total_length_str =
+          absl::StrSplit(result.GetContentRange(), "/");
+      int64_t total_length = strtol(total_length_str[1].c_str(), nullptr, 10);
+      // Now we know the total size of the object.
+      tracker->end_byte_index = total_length - 1;
+      if (request.has_byte_range()) {
+        tracker->end_byte_index = std::min(
+            *tracker->end_byte_index,
+            static_cast<int64_t>(request.byte_range().end_byte_index()));
+      }
+    }
+    // Only the last range of the object may be shorter than requested. The
+    // missing bytes of any other range are requested again, otherwise the
+    // stream would wait for them forever.
+    auto expected_end_byte_index =
+        std::min(end_byte_index, *tracker->end_byte_index);
+    auto actual_end_byte_index = begin_byte_index + actual_length_read - 1;
+    if (actual_end_byte_index < expected_end_byte_index) {
+      if (actual_length_read <= 0) {
+        auto read_result =
+            FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB);
+        SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_stream_context, read_result,
+                          "GetBlobStream range %lld-%lld returned no bytes",
+                          begin_byte_index, expected_end_byte_index);
+        FinishGetBlobStream(get_blob_stream_context, *tracker, read_result);
+        return;
+      }
+      SCP_WARNING_CONTEXT(kAwsS3Provider, get_blob_stream_context,
+                          "GetBlobStream range %lld-%lld returned up to %lld. "
+                          "Requesting the rest again.",
+                          begin_byte_index, expected_end_byte_index,
+                          actual_end_byte_index);
+      ranges_to_get.emplace_back(actual_end_byte_index + 1,
+                                 expected_end_byte_index);
+    }
+    tracker->completed_responses.emplace(begin_byte_index, move(response));
+
+    // Push the completed ranges which are next in order.
+    for (auto it = tracker->completed_responses.find(
+             tracker->next_push_byte_index);
+         it != tracker->completed_responses.end();
+         it = tracker->completed_responses.find(
+             tracker->next_push_byte_index)) {
+      tracker->next_push_byte_index =
+          it->second.byte_range().end_byte_index() + 1;
+      auto push_result =
+          get_blob_stream_context.TryPushResponse(move(it->second));
+      tracker->completed_responses.erase(it);
+      if (!push_result.Successful()) {
+        SCP_ERROR_CONTEXT(kAwsS3Provider, get_blob_stream_context, push_result,
+                          "Failed to push new message.");
+        FinishGetBlobStream(get_blob_stream_context, *tracker, push_result);
+        return;
+      }
+      // Schedule processing the next message.
+      auto schedule_result = cpu_async_executor_->Schedule(
+          [get_blob_stream_context]() mutable {
+            get_blob_stream_context.ProcessNextMessage();
+          },
+          AsyncPriority::Normal);
+      if (!schedule_result.Successful()) {
+        SCP_ERROR_CONTEXT(
+            kAwsS3Provider, get_blob_stream_context, schedule_result,
+            "Get blob stream process next message failed to be scheduled");
+        FinishGetBlobStream(get_blob_stream_context, *tracker,
+                            schedule_result);
+        return;
+      }
+    }
 
-  // The + 1 and - 1 cancel out but we leave them to show that we are adding
-  // "the new start index" + "the size of the read (- 1 to account for
-  // inclusivity)".
-  auto new_end_index = (tracker->last_end_byte_index + 1) +
-                       (tracker->max_bytes_per_response - 1);
-  if (request.has_byte_range() &&
-      (request.byte_range().end_byte_index() < new_end_index)) {
-    new_end_index = request.byte_range().end_byte_index();
-  }
-  // We can safely start at last_end_index + 1 because it is in bounds.
-  // We can safely end at the computed new_end_index because even if it is out
-  // of bounds, S3 will still succeed but truncate the response.
-  optional<string> range = absl::StrCat(
-      "bytes=", tracker->last_end_byte_index + 1, "-", new_end_index);
+    if (tracker->next_push_byte_index > *tracker->end_byte_index) {
+      FinishGetBlobStream(get_blob_stream_context, *tracker,
+                          SuccessExecutionResult());
+      return;
+    }
 
-  tracker->last_begin_byte_index = tracker->last_end_byte_index + 1;
-  tracker->last_end_byte_index = new_end_index;
+    // Keep up to get_blob_stream_readahead_count_ ranges past the next byte
+    // to push in flight or completed.
+    auto readahead_end_index =
+        tracker->next_push_byte_index +
+        static_cast<int64_t>(get_blob_stream_readahead_count_) *
+            tracker->max_bytes_per_response;
+    while (tracker->next_begin_byte_index <= *tracker->end_byte_index &&
+           tracker->next_begin_byte_index < readahead_end_index) {
+      // The + 1 and - 1 cancel out but we leave them to show that we are
+      // adding "the new start index" + "the size of the read (- 1 to account
+      // for inclusivity)".
+      auto new_end_index = std::min(*tracker->end_byte_index,
+                                    tracker->next_begin_byte_index +
+                                        (tracker->max_bytes_per_response - 1));
+      ranges_to_get.emplace_back(tracker->next_begin_byte_index,
+                                 new_end_index);
+      tracker->next_begin_byte_index = new_end_index + 1;
+    }
+  }
 
-  s3_client_->GetObjectAsync(
-      MakeGetObjectRequest(request, move(range)),
-      bind(&AwsS3ClientProvider::OnGetObjectStreamCallback, this,
-           get_blob_stream_context, tracker, _1, _2, _3, _4),
-      nullptr);
+  // The ranges are requested without the lock, as their callbacks may run
+  // inline.
+  for (const auto& byte_range : ranges_to_get) {
+    GetObjectRange(get_blob_stream_context, tracker, byte_range);
+  }
 }
 
 ExecutionResult AwsS3ClientProvider::ListBlobsMetadata(
@@ -716,67 +779,247 @@ void AwsS3ClientProvider::OnCreateMultipartUploadCallback(
   tracker->expiry_time_ns =
       TimeProvider::GetWallTimestampInNanoseconds() + duration;
 
-  if (request.blob_portion().data().size() < kMinimumPartSize) {
-    // Not enough data to upload in a part yet.
-    // Copy data into a staging variable.
-    tracker->accumulated_contents =
-        move(*request.mutable_blob_portion()->mutable_data());
-    UploadPartRequest part_request;
-    // Set part number to 0. OnUploadPartCallback expects the part number to be
-    // the last successfully uploaded part - we haven't uploaded any yet.
-    part_request.SetPartNumber(0);
-    ScheduleAnotherPutBlobStreamPoll(
-        put_blob_stream_context, tracker, s3_client, part_request,
-        UploadPartOutcome() /*unneeded*/, async_context);
-    return;
+  // The initial portion is uploaded as any later one, once there is enough
+  // data for a part.
+  tracker->accumulated_contents =
+      move(*request.mutable_blob_portion()->mutable_data());
+
+  // Wake up on pushed requests rather than polling the context for them. The
+  // producer's thread is not used for the upload itself.
+  put_blob_stream_context.SetRequestNotifier(
+      [this, put_blob_stream_context, tracker]() mutable {
+        if (!io_async_executor_
+                 ->Schedule(
+                     [this, put_blob_stream_context, tracker]() mutable {
+                       ContinuePutBlobStream(put_blob_stream_context, tracker);
+                     },
+                     AsyncPriority::Normal)
+                 .Successful()) {
+          ContinuePutBlobStream(put_blob_stream_context, tracker);
+        }
+      });
+  ContinuePutBlobStream(put_blob_stream_context, tracker);
+
+  bool is_finished;
+  {
+    lock_guard<mutex> lock(tracker->mutex);
+    is_finished = tracker->is_finished;
+  }
+  if (!is_finished) {
+    SchedulePutBlobStreamExpiry(put_blob_stream_context, tracker);
+  }
+}
+
+void AwsS3ClientProvider::ContinuePutBlobStream(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
+        put_blob_stream_context,
+    shared_ptr<PutBlobStreamTracker> tracker) noexcept {
+  enum class Step { kUploadPart, kCompleteUpload, kAbortUpload, kFail };
+
+  // Takes one step at a time under the lock. Requests are issued outside of
+  // it since their callbacks may run inline and continue the session.
+  while (true) {
+    Step step;
+    ExecutionResult result = SuccessExecutionResult();
+    int64_t part_number = 0;
+    string part_contents;
+    {
+      lock_guard<mutex> lock(tracker->mutex);
+      if (tracker->is_finished) {
+        return;
+      }
+      if (put_blob_stream_context.IsCancelled()) {
+        result = FailureExecutionResult(
+            SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
+        SCP_WARNING_CONTEXT(kAwsS3Provider, put_blob_stream_context,
+                            "Put blob stream request was cancelled");
+        step = Step::kAbortUpload;
+      } else if (tracker->parts_in_flight >=
+                 put_blob_stream_max_concurrent_parts_) {
+        // An UploadPart completion continues the session.
+        return;
+      } else if (tracker->accumulated_contents.size() >= kMinimumPartSize) {
+        step = Step::kUploadPart;
+      } else {
+        // Checked before dequeueing so that a request pushed right before the
+        // context is marked done is not missed.
+        bool is_marked_done = put_blob_stream_context.IsMarkedDone();
+        auto request = put_blob_stream_context.TryGetNextRequest();
+        if (request != nullptr) {
+          // Validate that the new request specifies the same blob.
+          if (request->blob_portion().metadata().bucket_name() !=
+                  tracker->bucket_name ||
+              request->blob_portion().metadata().blob_name() !=
+                  tracker->blob_name) {
+            result =
+                FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
+            SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context, result,
+                              "Enqueued message does not specify the same "
+                              "blob (bucket name, blob name) as previously.");
+            step = Step::kFail;
+          } else {
+            if (tracker->accumulated_contents.empty()) {
+              tracker->accumulated_contents =
+                  move(*request->mutable_blob_portion()->mutable_data());
+            } else {
+              absl::StrAppend(&tracker->accumulated_contents,
+                              request->blob_portion().data());
+            }
+            continue;
+          }
+        } else if (!is_marked_done) {
+          // If this session expired, cancel the upload and finish. Otherwise
+          // the next pushed request continues the session.
+          if (TimeProvider::GetWallTimestampInNanoseconds() <
+              tracker->expiry_time_ns) {
+            return;
+          }
+          result = FailureExecutionResult(
+              SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED);
+          SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context, result,
+                            "Put blob stream session expired.");
+          step = Step::kAbortUpload;
+        } else if (!tracker->accumulated_contents.empty()) {
+          // The last part may be smaller than the minimum part size.
+          step = Step::kUploadPart;
+        } else if (tracker->parts_in_flight == 0) {
+          step = Step::kCompleteUpload;
+        } else {
+          // The last UploadPart completion completes the upload.
+          return;
+        }
+      }
+
+      if (step == Step::kUploadPart) {
+        part_number = tracker->next_part_number++;
+        part_contents = move(tracker->accumulated_contents);
+        tracker->accumulated_contents.clear();
+        tracker->parts_in_flight++;
+      } else {
+        tracker->is_finished = true;
+      }
+    }
+
+    switch (step) {
+      case Step::kUploadPart:
+        UploadPart(put_blob_stream_context, tracker, part_number,
+                   part_contents);
+        break;
+      case Step::kCompleteUpload:
+        CompleteUpload(put_blob_stream_context, tracker);
+        return;
+      case Step::kAbortUpload:
+        put_blob_stream_context.result = result;
+        AbortUpload(put_blob_stream_context, tracker);
+        return;
+      case Step::kFail:
+        CancelPutBlobStreamExpiry(*tracker);
+        FinishStreamingContext(result, put_blob_stream_context,
+                               cpu_async_executor_);
+        return;
+    }
   }
+}
 
-  // Upload the first part as it is in this request.
+void AwsS3ClientProvider::UploadPart(
+    ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
+        put_blob_stream_context,
+    shared_ptr<PutBlobStreamTracker> tracker, int64_t part_number,
+    const string& part_contents) noexcept {
   UploadPartRequest part_request;
   part_request.SetBucket(tracker->bucket_name.c_str());
   part_request.SetKey(tracker->blob_name.c_str());
-  part_request.SetPartNumber(1);
+  part_request.SetPartNumber(part_number);
   part_request.SetUploadId(tracker->upload_id.c_str());
 
-  part_request.SetBody(MakeShared<StringStream>("WriteStream::Upload",
-                                                request.blob_portion().data()));
+  part_request.SetBody(
+      MakeShared<StringStream>("WriteStream::Upload", part_contents));
 
-  if (auto md5_result = SetContentMd5(put_blob_stream_context, part_request,
-                                      request.blob_portion().data());
+  if (auto md5_result =
+          SetContentMd5(put_blob_stream_context, part_request, part_contents);
       !md5_result.Successful()) {
+    {
+      lock_guard<mutex> lock(tracker->mutex);
+      tracker->parts_in_flight--;
+      if (tracker->is_finished) {
+        return;
+      }
+      tracker->is_finished = true;
+    }
     put_blob_stream_context.result = md5_result;
-    FinishStreamingContext(put_blob_stream_context.result,
-                           put_blob_stream_context, cpu_async_executor_);
+    AbortUpload(put_blob_stream_context, tracker);
     return;
   }
 
-  s3_client->UploadPartAsync(
+  s3_client_->UploadPartAsync(
       part_request,
       bind(&AwsS3ClientProvider::OnUploadPartCallback, this,
            put_blob_stream_context, tracker, _1, _2, _3, _4),
       nullptr);
 }
 
-void AwsS3ClientProvider::ScheduleAnotherPutBlobStreamPoll(
+void AwsS3ClientProvider::SchedulePutBlobStreamExpiry(
     ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
         put_blob_stream_context,
-    shared_ptr<PutBlobStreamTracker> tracker, const S3Client* s3_client,
-    const UploadPartRequest& upload_part_request,
-    UploadPartOutcome upload_part_outcome,
-    const shared_ptr<const AsyncCallerContext> async_context) {
+    shared_ptr<PutBlobStreamTracker> tracker) noexcept {
+  // The timer does not keep a finished session alive.
+  weak_ptr<PutBlobStreamTracker> weak_tracker = tracker;
+  auto time_to_expiry =
+      tracker->expiry_time_ns - TimeProvider::GetWallTimestampInNanoseconds();
+  function<bool()> cancel_expiry_timer;
   auto schedule_result = io_async_executor_->ScheduleFor(
-      bind(&AwsS3ClientProvider::OnUploadPartCallback, this,
-           put_blob_stream_context, tracker, s3_client, upload_part_request,
-           upload_part_outcome, async_context),
-      (TimeProvider::GetSteadyTimestampInNanoseconds() + kPutBlobRescanTime)
-          .count());
+      [this, put_blob_stream_context, weak_tracker]() mutable {
+        auto tracker = weak_tracker.lock();
+        if (!tracker) {
+          return;
+        }
+        // The expiry is on the wall clock, the executor may wake up early.
+        if (TimeProvider::GetWallTimestampInNanoseconds() <
+            tracker->expiry_time_ns) {
+          SchedulePutBlobStreamExpiry(put_blob_stream_context, tracker);
+          return;
+        }
+        ContinuePutBlobStream(put_blob_stream_context, tracker);
+      },
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + time_to_expiry)
+          .count(),
+      cancel_expiry_timer);
+
+  bool is_finished;
+  {
+    lock_guard<mutex> lock(tracker->mutex);
+    is_finished = tracker->is_finished;
+    if (!is_finished && schedule_result.Successful()) {
+      tracker->cancel_expiry_timer = move(cancel_expiry_timer);
+    } else if (!is_finished) {
+      tracker->is_finished = true;
+    }
+  }
+  if (is_finished) {
+    if (schedule_result.Successful() && cancel_expiry_timer) {
+      cancel_expiry_timer();
+    }
+    return;
+  }
   if (!schedule_result.Successful()) {
     put_blob_stream_context.result = schedule_result;
     SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context,
                       put_blob_stream_context.result,
                       "Put blob stream request failed to be scheduled");
-    FinishStreamingContext(schedule_result, put_blob_stream_context,
-                           cpu_async_executor_);
+    AbortUpload(put_blob_stream_context, tracker);
+  }
+}
+
+void AwsS3ClientProvider::CancelPutBlobStreamExpiry(
+    PutBlobStreamTracker& tracker) noexcept {
+  function<bool()> cancel_expiry_timer;
+  {
+    lock_guard<mutex> lock(tracker.mutex);
+    cancel_expiry_timer = move(tracker.cancel_expiry_timer);
+    tracker.cancel_expiry_timer = nullptr;
+  }
+  if (cancel_expiry_timer) {
+    cancel_expiry_timer();
   }
 }
 
@@ -787,201 +1030,63 @@ void AwsS3ClientProvider::OnUploadPartCallback(
     const UploadPartRequest& upload_part_request,
     UploadPartOutcome upload_part_outcome,
     const shared_ptr<const AsyncCallerContext> async_context) noexcept {
-  // We get called in 2 ways:
-  // 1. UploadPart succeeds
-  // 2. The wakeup time has elapsed.
-  //
-  // In the case of 1, the part number in the request will be equal to our
-  // next_part_number. In the case of 2, the part number in the request will be
-  // the part number of the previously uploaded part - i.e. next_part_number
-  // - 1.
-  if (tracker->next_part_number == upload_part_request.GetPartNumber()) {
-    // If the most recently uploaded part is the same as the "next" one, update
-    // the trackers.
-    if (!upload_part_outcome.IsSuccess()) {
-      put_blob_stream_context.result =
-          AwsS3Utils::ConvertS3ErrorToExecutionResult(
-              upload_part_outcome.GetError().GetErrorType());
-      SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context,
-                        put_blob_stream_context.result,
-                        "Upload part request failed. Error code: %d, "
-                        "message: %s",
-                        upload_part_outcome.GetError().GetResponseCode(),
-                        upload_part_outcome.GetError().GetMessage().c_str());
-      AbortUpload(put_blob_stream_context, tracker);
-      return;
-    }
-    CompletedPart completed_part;
-    completed_part.SetPartNumber(upload_part_request.GetPartNumber());
-    const auto& etag = upload_part_outcome.GetResult().GetETag();
-    if (etag.empty()) {
-      put_blob_stream_context.result =
-          FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_EMPTY_ETAG);
-      SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context,
-                        put_blob_stream_context.result,
-                        "Upload part request failed. Error code: %d, "
-                        "message: %s",
-                        upload_part_outcome.GetError().GetResponseCode(),
-                        upload_part_outcome.GetError().GetMessage().c_str());
-      AbortUpload(put_blob_stream_context, tracker);
-      return;
-    }
-    completed_part.SetETag(etag);
-    tracker->completed_multipart_upload.AddParts(move(completed_part));
-    tracker->next_part_number++;
+  ExecutionResult result = SuccessExecutionResult();
+  if (!upload_part_outcome.IsSuccess()) {
+    result = AwsS3Utils::ConvertS3ErrorToExecutionResult(
+        upload_part_outcome.GetError().GetErrorType());
+  } else if (upload_part_outcome.GetResult().GetETag().empty()) {
+    result = FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_EMPTY_ETAG);
   }
 
-  if (put_blob_stream_context.IsCancelled()) {
-    put_blob_stream_context.result = FailureExecutionResult(
-        SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED);
-    SCP_WARNING_CONTEXT(kAwsS3Provider, put_blob_stream_context,
-                        "Put blob stream request was cancelled");
-    AbortUpload(put_blob_stream_context, tracker);
-    return;
-  }
-  // If there's no message, schedule again. If there's a message - write it.
-  auto request = put_blob_stream_context.TryGetNextRequest();
-  if (request == nullptr) {
-    if (put_blob_stream_context.IsMarkedDone()) {
-      CompleteUpload(put_blob_stream_context, tracker);
-      return;
-    }
-    // If this session expired, cancel the upload and finish.
-    if (TimeProvider::GetWallTimestampInNanoseconds() >=
-        tracker->expiry_time_ns) {
-      put_blob_stream_context.result = FailureExecutionResult(
-          SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_EXPIRED);
-      SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context,
-                        put_blob_stream_context.result,
-                        "Put blob stream session expired.");
-      AbortUpload(put_blob_stream_context, tracker);
+  {
+    lock_guard<mutex> lock(tracker->mutex);
+    tracker->parts_in_flight--;
+    if (tracker->is_finished) {
       return;
     }
-    // Schedule checking for a new message.
-    // Forward the old arguments to this callback so it knows that an upload was
-    // not done.
-    ScheduleAnotherPutBlobStreamPoll(put_blob_stream_context, tracker,
-                                     s3_client, upload_part_request,
-                                     upload_part_outcome, async_context);
-    return;
-  }
-  // Validate that the new request specifies the same blob.
-  if (request->blob_portion().metadata().bucket_name() !=
-          tracker->bucket_name ||
-      request->blob_portion().metadata().blob_name() != tracker->blob_name) {
-    auto result = FailureExecutionResult(SC_BLOB_STORAGE_PROVIDER_INVALID_ARGS);
-    SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context, result,
-                      "Enqueued message does not specify the same blob (bucket "
-                      "name, blob name) as previously.");
-    FinishStreamingContext(result, put_blob_stream_context,
-                           cpu_async_executor_);
-    return;
-  }
-
-  auto stream_to_write = MakeShared<StringStream>("WriteStream::Upload");
-  if (tracker->accumulated_contents.empty()) {
-    if (request->blob_portion().data().size() >= kMinimumPartSize) {
-      // This portion of data is sufficient for one part.
-      stream_to_write->write(request->blob_portion().data().c_str(),
-                             request->blob_portion().data().size());
+    if (result.Successful()) {
+      CompletedPart completed_part;
+      completed_part.SetPartNumber(upload_part_request.GetPartNumber());
+      completed_part.SetETag(upload_part_outcome.GetResult().GetETag());
+      tracker->completed_parts[upload_part_request.GetPartNumber()] =
+          move(completed_part);
     } else {
-      // Copy data into a staging variable.
-      tracker->accumulated_contents =
-          move(*request->mutable_blob_portion()->mutable_data());
-      // Forward the old arguments to this callback so it knows that an upload
-      // was not done.
-      ScheduleAnotherPutBlobStreamPoll(put_blob_stream_context, tracker,
-                                       s3_client, upload_part_request,
-                                       upload_part_outcome, async_context);
-      return;
+      tracker->is_finished = true;
     }
-  } else if ((tracker->accumulated_contents.size() +
-              request->blob_portion().data().size()) >= kMinimumPartSize) {
-    // Combine the accumulated contents and the new portion and upload.
-    stream_to_write->write(tracker->accumulated_contents.c_str(),
-                           tracker->accumulated_contents.size());
-    stream_to_write->write(request->blob_portion().data().c_str(),
-                           request->blob_portion().data().size());
-  } else {
-    // Copy the new portion into the accumulator.
-    absl::StrAppend(&tracker->accumulated_contents,
-                    request->blob_portion().data());
-    // Forward the old arguments to this callback so it knows that an upload was
-    // not done.
-    ScheduleAnotherPutBlobStreamPoll(put_blob_stream_context, tracker,
-                                     s3_client, upload_part_request,
-                                     upload_part_outcome, async_context);
-    return;
   }
 
-  // Upload the next part.
-  UploadPartRequest new_upload_request;
-  new_upload_request.SetBucket(tracker->bucket_name.c_str());
-  new_upload_request.SetKey(tracker->blob_name.c_str());
-  new_upload_request.SetPartNumber(tracker->next_part_number);
-  new_upload_request.SetUploadId(tracker->upload_id.c_str());
-
-  new_upload_request.SetBody(stream_to_write);
-
-  if (auto md5_result = SetContentMd5(
-          put_blob_stream_context, new_upload_request, stream_to_write->str());
-      !md5_result.Successful()) {
-    put_blob_stream_context.result = md5_result;
-    FinishStreamingContext(put_blob_stream_context.result,
-                           put_blob_stream_context, cpu_async_executor_);
+  if (!result.Successful()) {
+    put_blob_stream_context.result = result;
+    SCP_ERROR_CONTEXT(kAwsS3Provider, put_blob_stream_context,
+                      put_blob_stream_context.result,
+                      "Upload part request failed. Error code: %d, "
+                      "message: %s",
+                      upload_part_outcome.GetError().GetResponseCode(),
+                      upload_part_outcome.GetError().GetMessage().c_str());
+    AbortUpload(put_blob_stream_context, tracker);
     return;
   }
 
-  // Clear contents since they're uploaded below.
-  tracker->accumulated_contents.clear();
-
-  s3_client->UploadPartAsync(
-      new_upload_request,
-      bind(&AwsS3ClientProvider::OnUploadPartCallback, this,
-           put_blob_stream_context, tracker, _1, _2, _3, _4),
-      nullptr);
+  ContinuePutBlobStream(put_blob_stream_context, tracker);
 }
 
 void AwsS3ClientProvider::CompleteUpload(
     ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
         put_blob_stream_context,
     shared_ptr<PutBlobStreamTracker> tracker) {
-  if (!tracker->accumulated_contents.empty()) {
-    // We need to upload one final part with the accumulated contents.
-    UploadPartRequest new_upload_request;
-    new_upload_request.SetBucket(tracker->bucket_name.c_str());
-    new_upload_request.SetKey(tracker->blob_name.c_str());
-    new_upload_request.SetPartNumber(tracker->next_part_number);
-    new_upload_request.SetUploadId(tracker->upload_id.c_str());
-
-    new_upload_request.SetBody(MakeShared<StringStream>(
-        "WriteStream::Upload", tracker->accumulated_contents));
-
-    if (auto md5_result =
-            SetContentMd5(put_blob_stream_context, new_upload_request,
-                          tracker->accumulated_contents);
-        !md5_result.Successful()) {
-      put_blob_stream_context.result = md5_result;
-      FinishStreamingContext(put_blob_stream_context.result,
-                             put_blob_stream_context, cpu_async_executor_);
-      return;
-    }
-
-    // Clear contents since they're uploaded below.
-    tracker->accumulated_contents.clear();
+  CancelPutBlobStreamExpiry(*tracker);
 
-    s3_client_->UploadPartAsync(
-        new_upload_request,
-        bind(&AwsS3ClientProvider::OnUploadPartCallback, this,
-             put_blob_stream_context, tracker, _1, _2, _3, _4),
-        nullptr);
-    return;
+  // No part is in flight anymore, the parts are complete and in order.
+  CompletedMultipartUpload completed_multipart_upload;
+  for (const auto& [part_number, completed_part] : tracker->completed_parts) {
+    completed_multipart_upload.AddParts(completed_part);
   }
+
   CompleteMultipartUploadRequest complete_request;
   complete_request.SetBucket(tracker->bucket_name.c_str());
   complete_request.SetKey(tracker->blob_name.c_str());
   complete_request.SetUploadId(tracker->upload_id.c_str());
-  complete_request.WithMultipartUpload(tracker->completed_multipart_upload);
+  complete_request.WithMultipartUpload(move(completed_multipart_upload));
 
   s3_client_->CompleteMultipartUploadAsync(
       complete_request,
@@ -1019,6 +1124,8 @@ void AwsS3ClientProvider::AbortUpload(
     ProducerStreamingContext<PutBlobStreamRequest, PutBlobStreamResponse>&
         put_blob_stream_context,
     shared_ptr<PutBlobStreamTracker> tracker) {
+  CancelPutBlobStreamExpiry(*tracker);
+
   AbortMultipartUploadRequest abort_request;
   abort_request.SetBucket(tracker->bucket_name.c_str());
   abort_request.SetKey(tracker->blob_name.c_str());
@@ -16,14 +16,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <aws/core/Aws.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/CompleteMultipartUploadRequest.h>
 #include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
 #include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
@@ -50,7 +58,15 @@ class AwsS3ClientProvider : public BlobStorageClientProviderInterface {
       const std::shared_ptr<core::AsyncExecutorInterface>& io_async_executor,
       std::shared_ptr<AwsS3Factory> s3_factory =
           std::make_shared<AwsS3Factory>())
-      : instance_client_(instance_client),
+      : get_blob_stream_readahead_count_(
+            options ? std::max<size_t>(options->get_blob_stream_readahead_count,
+                                       1)
+                    : 1),
+        put_blob_stream_max_concurrent_parts_(
+            options ? std::max<size_t>(
+                          options->put_blob_stream_max_concurrent_parts, 1)
+                    : 1),
+        instance_client_(instance_client),
         cpu_async_executor_(cpu_async_executor),
         io_async_executor_(io_async_executor),
         s3_factory_(s3_factory) {}
@@ -115,18 +131,63 @@ class AwsS3ClientProvider : public BlobStorageClientProviderInterface {
           async_context) noexcept;
 
   struct GetBlobStreamTracker {
-    // What byte indices were just used.
-    int64_t last_begin_byte_index, last_end_byte_index;
-    // How many bytes remain in the object.
-    int64_t bytes_remaining;
     // How many bytes (maximum) should be placed in each GetBlobStreamResponse.
     int64_t max_bytes_per_response;
+    // Guards the members below, as the ranges complete concurrently.
+    std::mutex mutex;
+    // The index of the first byte which is not requested yet.
+    int64_t next_begin_byte_index;
+    // The index of the first byte which is not pushed to the context yet.
+    int64_t next_push_byte_index;
+    // The index of the last byte to read, known once the first range
+    // completes.
+    std::optional<int64_t> end_byte_index;
+    // The completed ranges waiting for the ranges before them, by their begin
+    // index.
+    std::map<int64_t,
+             cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>
+        completed_responses;
+    // Whether the context is finished, the ranges in flight are then dropped.
+    bool is_finished = false;
   };
 
+  /**
+   * @brief Requests the range of the object, inclusive on both ends.
+   *
+   * @param get_blob_stream_context The get blob stream context object.
+   * @param tracker The tracker of the stream.
+   * @param byte_range The begin and end indices of the range.
+   */
+  void GetObjectRange(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>&
+          get_blob_stream_context,
+      std::shared_ptr<GetBlobStreamTracker> tracker,
+      std::pair<int64_t, int64_t> byte_range) noexcept;
+
+  /**
+   * @brief Finishes the stream with the result unless it is already finished.
+   *
+   * @param get_blob_stream_context The get blob stream context object.
+   * @param tracker The tracker of the stream, whose mutex must be held.
+   * @param result The result to finish the context with.
+   */
+  void FinishGetBlobStream(
+      core::ConsumerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>&
+          get_blob_stream_context,
+      GetBlobStreamTracker& tracker,
+      const core::ExecutionResult& result) noexcept;
+
   /**
    * @brief Is called when a partial GetObject call is done.
    *
    * @param get_blob_stream_context The get blob stream context object.
+   * @param tracker The tracker of the stream.
+   * @param begin_byte_index The begin index of the requested range.
+   * @param end_byte_index The end index of the requested range, inclusive.
    * @param s3_client An instance of the S3 client.
    * @param get_object_request The get object request.
    * @param get_object_outcome The get object outcome
@@ -138,8 +199,8 @@ class AwsS3ClientProvider : public BlobStorageClientProviderInterface {
           cmrt::sdk::blob_storage_service::v1::GetBlobStreamRequest,
           cmrt::sdk::blob_storage_service::v1::GetBlobStreamResponse>&
           get_blob_stream_context,
-      std::shared_ptr<GetBlobStreamTracker> tracker,
-      const Aws::S3::S3Client* s3_client,
+      std::shared_ptr<GetBlobStreamTracker> tracker, int64_t begin_byte_index,
+      int64_t end_byte_index, const Aws::S3::S3Client* s3_client,
       const Aws::S3::Model::GetObjectRequest& get_object_request,
       Aws::S3::Model::GetObjectOutcome get_object_outcome,
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
@@ -192,14 +253,25 @@ class AwsS3ClientProvider : public BlobStorageClientProviderInterface {
     std::string bucket_name, blob_name;
     // The unique identifier to use for this upload.
     std::string upload_id;
+
+    // Guards the fields below, which are accessed by the pushes of the
+    // producer, the UploadPart callbacks and the expiry timer.
+    std::mutex mutex;
     // The part number to use for the next part.
     int64_t next_part_number = 1;
+    // The number of parts being uploaded.
+    size_t parts_in_flight = 0;
     // S3 requires each upload except the last must be at least 5MiB.
     // https://docs.aws.amazon.com/AmazonS3/latest/userguide/qfacts.html
     // Any partial data will be stored here.
     std::string accumulated_contents;
-    // The object used to complete the upload.
-    Aws::S3::Model::CompletedMultipartUpload completed_multipart_upload;
+    // The uploaded parts by part number, as they may complete out of order.
+    std::map<int64_t, Aws::S3::Model::CompletedPart> completed_parts;
+    // Whether the upload is being completed or aborted, after which nothing
+    // else is done for this session.
+    bool is_finished = false;
+    // Cancels the expiry timer once the session is finished.
+    std::function<bool()> cancel_expiry_timer;
 
     // Timestamp in nanoseconds of when this PutBlobStream session should
     // expire.
@@ -207,18 +279,55 @@ class AwsS3ClientProvider : public BlobStorageClientProviderInterface {
         std::chrono::duration<int64_t>::min();
   };
 
-  // Schedules another poll for the next message in PutBlobStream.
-  void ScheduleAnotherPutBlobStreamPoll(
+  /**
+   * @brief Uploads the parts of the requests pushed so far, up to
+   * put_blob_stream_max_concurrent_parts_ at a time, and completes the upload
+   * once the context is done. Aborts the upload if the context is cancelled
+   * or the session expired. Is called whenever the session may progress, i.e.
+   * on new requests, on UploadPart completions and on expiry.
+   *
+   * @param put_blob_stream_context The put blob stream context object.
+   * @param tracker The tracker of the upload.
+   */
+  void ContinuePutBlobStream(
       core::ProducerStreamingContext<
           cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
           cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>&
           put_blob_stream_context,
-      std::shared_ptr<PutBlobStreamTracker> tracker,
-      const Aws::S3::S3Client* s3_client,
-      const Aws::S3::Model::UploadPartRequest& upload_part_request,
-      Aws::S3::Model::UploadPartOutcome upload_part_outcome,
-      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
-          async_context);
+      std::shared_ptr<PutBlobStreamTracker> tracker) noexcept;
+
+  /**
+   * @brief Uploads a part of a PutBlobStream.
+   *
+   * @param put_blob_stream_context The put blob stream context object.
+   * @param tracker The tracker of the upload.
+   * @param part_number The part number of the part.
+   * @param part_contents The contents of the part.
+   */
+  void UploadPart(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>&
+          put_blob_stream_context,
+      std::shared_ptr<PutBlobStreamTracker> tracker, int64_t part_number,
+      const std::string& part_contents) noexcept;
+
+  /**
+   * @brief Schedules the check of the expiry of a PutBlobStream session, for
+   * the case no request is pushed anymore.
+   *
+   * @param put_blob_stream_context The put blob stream context object.
+   * @param tracker The tracker of the upload.
+   */
+  void SchedulePutBlobStreamExpiry(
+      core::ProducerStreamingContext<
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamRequest,
+          cmrt::sdk::blob_storage_service::v1::PutBlobStreamResponse>&
+          put_blob_stream_context,
+      std::shared_ptr<PutBlobStreamTracker> tracker) noexcept;
+
+  /// Cancels the expiry timer of a finished PutBlobStream session, if any.
+  void CancelPutBlobStreamExpiry(PutBlobStreamTracker& tracker) noexcept;
 
   /**
    * @brief Is called when the multipart upload is created.
@@ -369,6 +478,11 @@ class AwsS3ClientProvider : public BlobStorageClientProviderInterface {
   virtual std::shared_ptr<Aws::Client::ClientConfiguration>
   CreateClientConfiguration(const std::string& region) noexcept;
 
+  /// How many ranges of a GetBlobStream are downloaded concurrently.
+  const size_t get_blob_stream_readahead_count_;
+  /// How many parts of a PutBlobStream are uploaded concurrently.
+  const size_t put_blob_stream_max_concurrent_parts_;
+
   std::shared_ptr<InstanceClientProviderInterface> instance_client_;
 
   /// Instances of the async executor for local compute and blocking IO
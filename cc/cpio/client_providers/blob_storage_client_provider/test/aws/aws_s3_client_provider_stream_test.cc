@@ -77,8 +77,10 @@ using google::scp::core::AsyncExecutor;
 using google::scp::core::ConsumerStreamingContext;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::ProducerStreamingContext;
+using google::scp::core::SuccessExecutionResult;
 using google::scp::core::async_executor::mock::MockAsyncExecutor;
 using google::scp::core::errors::SC_AWS_INTERNAL_SERVICE_ERROR;
+using google::scp::core::errors::SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB;
 using google::scp::core::errors::
     SC_BLOB_STORAGE_PROVIDER_STREAM_SESSION_CANCELLED;
 using google::scp::core::errors::
@@ -585,6 +587,120 @@ TEST_F(AwsS3ClientProviderStreamTest,
   cpu_async_executor->Stop();
 }
 
+TEST_F(AwsS3ClientProviderStreamTest,
+       PutBlobStreamWakesOnPushAndUploadsPartsConcurrently) {
+  auto options = make_shared<BlobStorageClientOptions>();
+  options->put_blob_stream_max_concurrent_parts = 2;
+  // The session does not expire during the test.
+  auto io_async_executor = make_shared<MockAsyncExecutor>();
+  io_async_executor->schedule_for_mock = [](auto&, auto, auto&) {
+    return SuccessExecutionResult();
+  };
+  AwsS3ClientProvider provider(options, instance_client_,
+                               make_shared<MockAsyncExecutor>(),
+                               io_async_executor, s3_factory_);
+  EXPECT_SUCCESS(provider.Init());
+  EXPECT_SUCCESS(provider.Run());
+
+  put_blob_stream_context_.request->mutable_blob_portion()
+      ->mutable_metadata()
+      ->set_bucket_name(kBucketName);
+  put_blob_stream_context_.request->mutable_blob_portion()
+      ->mutable_metadata()
+      ->set_blob_name(kBlobName);
+  put_blob_stream_context_.request->mutable_blob_portion()->set_data(
+      string(kMinimumPartSize, 'a'));
+
+  vector<PutBlobStreamRequest> requests;
+  for (const auto& data :
+       {string(kMinimumPartSize, 'b'), string(kMinimumPartSize, 'c'),
+        string("final one")}) {
+    auto request = *put_blob_stream_context_.request;
+    request.mutable_blob_portion()->set_data(data);
+    requests.push_back(request);
+  }
+
+  put_blob_stream_context_.callback = [this](auto& context) {
+    EXPECT_SUCCESS(context.result);
+
+    finish_called_ = true;
+  };
+
+  string upload_id = "upload id";
+  EXPECT_CALL(*s3_client_, CreateMultipartUploadAsync(
+                               HasBucketAndKey(kBucketName, kBlobName), _, _))
+      .WillOnce([this, &upload_id](auto request, auto& callback, auto) {
+        CreateMultipartUploadResult result;
+        result.SetUploadId(upload_id);
+        CreateMultipartUploadOutcome outcome(move(result));
+        callback(abstract_client_, request, move(outcome), nullptr);
+      });
+
+  // The parts are completed by the test, in any order.
+  vector<std::pair<UploadPartRequest,
+                   Aws::S3::UploadPartResponseReceivedHandler>>
+      pending_uploads;
+  EXPECT_CALL(*s3_client_, UploadPartAsync)
+      .WillRepeatedly([&pending_uploads](auto request, auto& callback, auto) {
+        pending_uploads.emplace_back(request, callback);
+      });
+  auto complete_upload = [this, &pending_uploads](size_t index) {
+    auto [request, callback] = pending_uploads[index];
+    pending_uploads.erase(pending_uploads.begin() + index);
+    UploadPartResult result;
+    result.SetETag(absl::StrCat("tag ", request.GetPartNumber()));
+    UploadPartOutcome outcome(move(result));
+    callback(abstract_client_, request, move(outcome), nullptr);
+  };
+  auto pending_part_numbers = [&pending_uploads]() {
+    vector<int> part_numbers;
+    for (const auto& [request, callback] : pending_uploads) {
+      part_numbers.push_back(request.GetPartNumber());
+    }
+    return part_numbers;
+  };
+
+  CompletedMultipartUpload upload;
+  for (int part_number = 1; part_number <= 4; ++part_number) {
+    upload.AddParts(
+        MakeCompletedPart(absl::StrCat("tag ", part_number), part_number));
+  }
+  EXPECT_CALL(*s3_client_,
+              CompleteMultipartUploadAsync(
+                  HasBucketKeyAndUpload(kBucketName, kBlobName, upload), _, _))
+      .WillOnce([this](auto request, auto& callback, auto) {
+        CompleteMultipartUploadResult result;
+        CompleteMultipartUploadOutcome outcome(move(result));
+        callback(abstract_client_, request, outcome, nullptr);
+      });
+
+  EXPECT_SUCCESS(provider.PutBlobStream(put_blob_stream_context_));
+  EXPECT_THAT(pending_part_numbers(), ElementsAre(1));
+
+  // Pushed requests are uploaded right away, up to 2 parts at a time.
+  EXPECT_SUCCESS(put_blob_stream_context_.TryPushRequest(requests[0]));
+  EXPECT_THAT(pending_part_numbers(), ElementsAre(1, 2));
+  EXPECT_SUCCESS(put_blob_stream_context_.TryPushRequest(requests[1]));
+  EXPECT_THAT(pending_part_numbers(), ElementsAre(1, 2));
+
+  complete_upload(1);
+  EXPECT_THAT(pending_part_numbers(), ElementsAre(1, 3));
+  complete_upload(0);
+  EXPECT_THAT(pending_part_numbers(), ElementsAre(3));
+
+  // The last part is uploaded once the context is done.
+  EXPECT_SUCCESS(put_blob_stream_context_.TryPushRequest(requests[2]));
+  EXPECT_THAT(pending_part_numbers(), ElementsAre(3));
+  put_blob_stream_context_.MarkDone();
+  EXPECT_THAT(pending_part_numbers(), ElementsAre(3, 4));
+
+  complete_upload(1);
+  EXPECT_FALSE(finish_called_.load());
+  complete_upload(0);
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_F(AwsS3ClientProviderStreamTest, PutBlobStreamFailsIfCreateFails) {
   put_blob_stream_context_.request->mutable_blob_portion()
       ->mutable_metadata()
@@ -1008,6 +1124,215 @@ TEST_F(AwsS3ClientProviderStreamTest, GetBlobStreamMultipleResponses) {
               Pointwise(GetBlobStreamResponseEquals(), expected_responses));
 }
 
+TEST_F(AwsS3ClientProviderStreamTest, GetBlobStreamReadsAheadInOrder) {
+  auto options = make_shared<BlobStorageClientOptions>();
+  options->get_blob_stream_readahead_count = 3;
+  AwsS3ClientProvider provider(options, instance_client_,
+                               make_shared<MockAsyncExecutor>(),
+                               make_shared<MockAsyncExecutor>(), s3_factory_);
+  EXPECT_SUCCESS(provider.Init());
+  EXPECT_SUCCESS(provider.Run());
+
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
+      kBucketName);
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_blob_name(
+      kBlobName);
+  get_blob_stream_context_.request->set_max_bytes_per_response(2);
+
+  // 15 chars.
+  string bytes_str = "response_string";
+  vector<GetBlobStreamResponse> expected_responses;
+  for (size_t i = 0; i < bytes_str.length(); i += 2) {
+    auto end_index = std::min(i + 1, bytes_str.length() - 1);
+    GetBlobStreamResponse resp;
+    resp.mutable_blob_portion()->mutable_metadata()->CopyFrom(
+        get_blob_stream_context_.request->blob_metadata());
+    *resp.mutable_blob_portion()->mutable_data() =
+        bytes_str.substr(i, end_index - i + 1);
+    resp.mutable_byte_range()->set_begin_byte_index(i);
+    resp.mutable_byte_range()->set_end_byte_index(end_index);
+    expected_responses.push_back(resp);
+  }
+
+  // The ranges are completed by the test, in any order.
+  vector<std::pair<GetObjectRequest, Aws::S3::GetObjectResponseReceivedHandler>>
+      pending_gets;
+  EXPECT_CALL(*s3_client_, GetObjectAsync)
+      .WillRepeatedly([&pending_gets](auto request, auto& callback, auto) {
+        pending_gets.emplace_back(request, callback);
+      });
+  auto complete_get = [this, &bytes_str, &pending_gets](size_t index) {
+    auto [request, callback] = pending_gets[index];
+    pending_gets.erase(pending_gets.begin() + index);
+    size_t begin_index = 0;
+    size_t end_index = 0;
+    sscanf(request.GetRange().c_str(), "bytes=%zu-%zu", &begin_index,
+           &end_index);
+    end_index = std::min<size_t>(end_index, bytes_str.length() - 1);
+    GetObjectResult result;
+    result.ReplaceBody(new StringStream(
+        bytes_str.substr(begin_index, end_index - begin_index + 1)));
+    result.SetContentRange(
+        absl::StrCat("bytes ", begin_index, "-", end_index, "/15"));
+    result.SetContentLength(end_index - begin_index + 1);
+    GetObjectOutcome outcome(move(result));
+    callback(abstract_client_, request, move(outcome), nullptr);
+  };
+  auto pending_ranges = [&pending_gets]() {
+    vector<string> ranges;
+    for (const auto& [request, callback] : pending_gets) {
+      ranges.push_back(request.GetRange().c_str());
+    }
+    return ranges;
+  };
+
+  vector<GetBlobStreamResponse> actual_responses;
+  get_blob_stream_context_.process_callback = [this, &actual_responses](
+                                                  auto& context, bool) {
+    auto resp = context.TryGetNextResponse();
+    if (resp != nullptr) {
+      actual_responses.push_back(move(*resp));
+    } else {
+      EXPECT_TRUE(context.IsMarkedDone());
+      EXPECT_SUCCESS(context.result);
+      finish_called_ = true;
+    }
+  };
+
+  EXPECT_SUCCESS(provider.GetBlobStream(get_blob_stream_context_));
+
+  // The size of the object is only known after the first range.
+  EXPECT_THAT(pending_ranges(), ElementsAre("bytes=0-1"));
+  complete_get(0);
+  EXPECT_THAT(pending_ranges(),
+              ElementsAre("bytes=2-3", "bytes=4-5", "bytes=6-7"));
+
+  // Later ranges wait for the earlier ones and do not extend the window.
+  complete_get(2);
+  complete_get(1);
+  EXPECT_EQ(actual_responses.size(), 1);
+  EXPECT_THAT(pending_ranges(), ElementsAre("bytes=2-3"));
+
+  complete_get(0);
+  EXPECT_EQ(actual_responses.size(), 4);
+  EXPECT_THAT(pending_ranges(),
+              ElementsAre("bytes=8-9", "bytes=10-11", "bytes=12-13"));
+
+  while (!pending_gets.empty()) {
+    complete_get(pending_gets.size() - 1);
+  }
+
+  WaitUntil([this]() { return finish_called_.load(); });
+  EXPECT_TRUE(get_blob_stream_context_.IsMarkedDone());
+  EXPECT_THAT(actual_responses,
+              Pointwise(GetBlobStreamResponseEquals(), expected_responses));
+}
+
+TEST_F(AwsS3ClientProviderStreamTest, GetBlobStreamRequestsShortRangesAgain) {
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
+      kBucketName);
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_blob_name(
+      kBlobName);
+  get_blob_stream_context_.request->set_max_bytes_per_response(4);
+
+  string bytes_str = "0123456789";
+  vector<GetBlobStreamResponse> expected_responses;
+  for (auto [begin_index, end_index] :
+       vector<std::pair<size_t, size_t>>{{0, 1}, {2, 3}, {4, 7}, {8, 9}}) {
+    GetBlobStreamResponse resp;
+    resp.mutable_blob_portion()->mutable_metadata()->CopyFrom(
+        get_blob_stream_context_.request->blob_metadata());
+    *resp.mutable_blob_portion()->mutable_data() =
+        bytes_str.substr(begin_index, end_index - begin_index + 1);
+    resp.mutable_byte_range()->set_begin_byte_index(begin_index);
+    resp.mutable_byte_range()->set_end_byte_index(end_index);
+    expected_responses.push_back(resp);
+  }
+
+  vector<std::pair<GetObjectRequest, Aws::S3::GetObjectResponseReceivedHandler>>
+      pending_gets;
+  EXPECT_CALL(*s3_client_, GetObjectAsync)
+      .WillRepeatedly([&pending_gets](auto request, auto& callback, auto) {
+        pending_gets.emplace_back(request, callback);
+      });
+  // Completes the first pending range with at most max_length bytes.
+  auto complete_get = [this, &bytes_str, &pending_gets](size_t max_length) {
+    auto [request, callback] = pending_gets.front();
+    pending_gets.erase(pending_gets.begin());
+    size_t begin_index = 0;
+    size_t end_index = 0;
+    sscanf(request.GetRange().c_str(), "bytes=%zu-%zu", &begin_index,
+           &end_index);
+    end_index = std::min<size_t>(
+        {end_index, bytes_str.length() - 1, begin_index + max_length - 1});
+    GetObjectResult result;
+    result.ReplaceBody(new StringStream(
+        bytes_str.substr(begin_index, end_index - begin_index + 1)));
+    result.SetContentRange(
+        absl::StrCat("bytes ", begin_index, "-", end_index, "/10"));
+    result.SetContentLength(end_index - begin_index + 1);
+    GetObjectOutcome outcome(move(result));
+    callback(abstract_client_, request, move(outcome), nullptr);
+  };
+
+  vector<GetBlobStreamResponse> actual_responses;
+  get_blob_stream_context_.process_callback = [this, &actual_responses](
+                                                  auto& context, bool) {
+    auto resp = context.TryGetNextResponse();
+    if (resp != nullptr) {
+      actual_responses.push_back(move(*resp));
+    } else {
+      EXPECT_TRUE(context.IsMarkedDone());
+      EXPECT_SUCCESS(context.result);
+      finish_called_ = true;
+    }
+  };
+
+  EXPECT_SUCCESS(provider_.GetBlobStream(get_blob_stream_context_));
+
+  // The first range returns only 2 of its 4 bytes.
+  complete_get(2);
+  ASSERT_EQ(pending_gets.size(), 2);
+  EXPECT_EQ(pending_gets[0].first.GetRange(), "bytes=2-3");
+  EXPECT_EQ(pending_gets[1].first.GetRange(), "bytes=4-7");
+
+  while (!pending_gets.empty()) {
+    complete_get(bytes_str.length());
+  }
+
+  WaitUntil([this]() { return finish_called_.load(); });
+  EXPECT_THAT(actual_responses,
+              Pointwise(GetBlobStreamResponseEquals(), expected_responses));
+}
+
+TEST_F(AwsS3ClientProviderStreamTest, GetBlobStreamFailsIfRangeReturnsNoBytes) {
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
+      kBucketName);
+  get_blob_stream_context_.request->mutable_blob_metadata()->set_blob_name(
+      kBlobName);
+  get_blob_stream_context_.request->set_max_bytes_per_response(4);
+
+  EXPECT_CALL(*s3_client_, GetObjectAsync)
+      .WillOnce([this](auto request, auto& callback, auto) {
+        GetObjectResult result;
+        result.ReplaceBody(new StringStream(""));
+        result.SetContentRange("bytes 0-3/10");
+        result.SetContentLength(0);
+        GetObjectOutcome outcome(move(result));
+        callback(abstract_client_, request, move(outcome), nullptr);
+      });
+
+  get_blob_stream_context_.process_callback = [this](auto& context, bool) {
+    EXPECT_THAT(context.result,
+                ResultIs(FailureExecutionResult(
+                    SC_BLOB_STORAGE_PROVIDER_ERROR_GETTING_BLOB)));
+    finish_called_ = true;
+  };
+
+  EXPECT_SUCCESS(provider_.GetBlobStream(get_blob_stream_context_));
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_F(AwsS3ClientProviderStreamTest, GetBlobStreamByteRange) {
   get_blob_stream_context_.request->mutable_blob_metadata()->set_bucket_name(
       kBucketName);
@@ -42,6 +42,7 @@ using google::scp::core::AsyncExecutorInterface;
 using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::Http1CurlClient;
+using google::scp::core::Http1CurlMultiEngine;
 using google::scp::core::HttpClient;
 using google::scp::core::HttpClientInterface;
 using google::scp::core::MessageRouter;
@@ -216,8 +217,14 @@ ExecutionResult LibCpioProvider::GetHttp1Client(
     return execution_result;
   }
 
-  http1_client_ =
-      make_shared<Http1CurlClient>(cpu_async_executor, io_async_executor);
+  if (cpio_options_->http1_curl_multi_engine_enabled) {
+    http1_client_ =
+        make_shared<Http1CurlClient>(cpu_async_executor, io_async_executor,
+                                     make_shared<Http1CurlMultiEngine>());
+  } else {
+    http1_client_ =
+        make_shared<Http1CurlClient>(cpu_async_executor, io_async_executor);
+  }
   execution_result = http1_client_->Init();
   if (!execution_result.Successful()) {
     SCP_ERROR(kLibCpioProvider, kZeroUuid, execution_result,
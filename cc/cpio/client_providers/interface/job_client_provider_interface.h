@@ -52,6 +52,15 @@ class JobClientProviderInterface : public core::ServiceInterface {
       core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobRequest,
                          cmrt::sdk::job_service::v1::GetNextJobResponse>&
           get_next_job_context) noexcept = 0;
+  /**
+   * @brief Get up to the requested number of available Jobs.
+   * @param get_next_jobs_context context of the operation.
+   * @return ExecutionResult result of the operation.
+   */
+  virtual core::ExecutionResult GetNextJobs(
+      core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobsRequest,
+                         cmrt::sdk::job_service::v1::GetNextJobsResponse>&
+          get_next_jobs_context) noexcept = 0;
   /**
    * @brief Get a Job by job id.
    * @param get_job_by_id_context context of the operation.
@@ -52,6 +52,15 @@ class QueueClientProviderInterface : public core::ServiceInterface {
       core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessageRequest,
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept = 0;
+  /**
+   * @brief Get up to the requested number of top messages from the queue.
+   * @param get_top_messages_context context of the operation.
+   * @return ExecutionResult result of the operation.
+   */
+  virtual core::ExecutionResult GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept = 0;
   /**
    * @brief Update visibility timeout of a message from the queue.
    * @param update_message_visibility_timeout_context context of the operation.
@@ -85,6 +94,28 @@ struct QueueClientOptions {
    *
    */
   std::string queue_name;
+
+  /**
+   * @brief AWS only. The number of messages received per SQS ReceiveMessage
+   * call, capped at 10. The messages beyond the requested ones are kept in a
+   * local prefetch buffer and handed out by the next GetTopMessage(s) calls.
+   */
+  size_t max_messages_per_receive = 1;
+
+  /**
+   * @brief AWS only. The long polling wait time of SQS ReceiveMessage calls,
+   * capped at 20 seconds. Zero returns right away if the queue is empty.
+   */
+  size_t receive_wait_time_seconds = 0;
+
+  /**
+   * @brief AWS only. The visibility timeout set on the messages kept in the
+   * prefetch buffer, capped at 600 seconds. The requested messages keep the
+   * visibility timeout of the queue. Prefetched messages are dropped from the
+   * local buffer after half of it, so that they are not handed out close to
+   * becoming visible to other receivers again.
+   */
+  size_t prefetched_message_visibility_timeout_seconds = 30;
 };
 
 class QueueClientProviderFactory {
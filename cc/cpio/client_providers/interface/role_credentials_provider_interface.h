@@ -43,6 +43,9 @@ struct GetRoleCredentialsResponse {
   std::shared_ptr<std::string> access_key_id;
   std::shared_ptr<std::string> access_key_secret;
   std::shared_ptr<std::string> security_token;
+  /// The wall clock time in nanoseconds when the credentials expire. 0 if the
+  /// expiration is not known.
+  core::Timestamp expiration_timestamp = 0;
 };
 
 /// Provides cloud role credentials functionality.
@@ -51,6 +51,12 @@ class MockJobClientProvider : public JobClientProviderInterface {
                            cmrt::sdk::job_service::v1::GetNextJobResponse>&)),
       (noexcept, override));
 
+  MOCK_METHOD(
+      core::ExecutionResult, GetNextJobs,
+      ((core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobsRequest,
+                           cmrt::sdk::job_service::v1::GetNextJobsResponse>&)),
+      (noexcept, override));
+
   MOCK_METHOD(
       core::ExecutionResult, GetJobById,
       ((core::AsyncContext<cmrt::sdk::job_service::v1::GetJobByIdRequest,
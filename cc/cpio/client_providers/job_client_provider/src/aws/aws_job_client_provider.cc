@@ -53,6 +53,10 @@ shared_ptr<JobClientProviderInterface> JobClientProviderFactory::Create(
         io_async_executor) noexcept {
   auto queue_options = make_shared<QueueClientOptions>();
   queue_options->queue_name = options->job_queue_name;
+  queue_options->max_messages_per_receive =
+      options->aws_queue_max_messages_per_receive;
+  queue_options->receive_wait_time_seconds =
+      options->aws_queue_receive_wait_time_seconds;
   auto queue_client = QueueClientProviderFactory::Create(
       queue_options, instance_client, cpu_async_executor, io_async_executor);
 
@@ -36,6 +36,8 @@ using google::cmrt::sdk::job_service::v1::GetJobByIdRequest;
 using google::cmrt::sdk::job_service::v1::GetJobByIdResponse;
 using google::cmrt::sdk::job_service::v1::GetNextJobRequest;
 using google::cmrt::sdk::job_service::v1::GetNextJobResponse;
+using google::cmrt::sdk::job_service::v1::GetNextJobsRequest;
+using google::cmrt::sdk::job_service::v1::GetNextJobsResponse;
 using google::cmrt::sdk::job_service::v1::Job;
 using google::cmrt::sdk::job_service::v1::JobStatus;
 using google::cmrt::sdk::job_service::v1::PutJobRequest;
@@ -57,6 +59,8 @@ using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -274,9 +278,15 @@ void JobClientProvider::OnGetTopMessageCallback(
     return;
   }
 
-  const string& job_id = get_top_message_context.response->message_body();
-  shared_ptr<string> receipt_info(
-      get_top_message_context.response->release_receipt_info());
+  GetJobOfMessage(get_next_job_context, *get_top_message_context.response);
+}
+
+void JobClientProvider::GetJobOfMessage(
+    AsyncContext<GetNextJobRequest, GetNextJobResponse>& get_next_job_context,
+    GetTopMessageResponse& message) noexcept {
+  const string& server_job_id = message.message_id();
+  const string& job_id = message.message_body();
+  shared_ptr<string> receipt_info(message.release_receipt_info());
 
   auto get_database_item_request = JobClientUtils::CreateGetNextJobRequest(
       job_table_name_, job_id, server_job_id);
@@ -300,6 +310,92 @@ void JobClientProvider::OnGetTopMessageCallback(
   }
 }
 
+ExecutionResult JobClientProvider::GetNextJobs(
+    AsyncContext<GetNextJobsRequest, GetNextJobsResponse>&
+        get_next_jobs_context) noexcept {
+  auto get_top_messages_request = make_shared<GetTopMessagesRequest>();
+  get_top_messages_request->set_max_number_of_messages(
+      get_next_jobs_context.request->max_number_of_jobs());
+  AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+      get_top_messages_context(
+          move(get_top_messages_request),
+          bind(&JobClientProvider::OnGetTopMessagesCallback, this,
+               get_next_jobs_context, _1),
+          get_next_jobs_context);
+
+  return queue_client_provider_->GetTopMessages(get_top_messages_context);
+}
+
+void JobClientProvider::OnGetTopMessagesCallback(
+    AsyncContext<GetNextJobsRequest, GetNextJobsResponse>&
+        get_next_jobs_context,
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  if (!get_top_messages_context.result.Successful()) {
+    auto execution_result = get_top_messages_context.result;
+    SCP_ERROR_CONTEXT(
+        kJobClientProvider, get_next_jobs_context, execution_result,
+        "Failed to get next jobs due to get job messages from queue failed.");
+    get_next_jobs_context.result = execution_result;
+    get_next_jobs_context.Finish();
+    return;
+  }
+
+  auto& messages = *get_top_messages_context.response->mutable_messages();
+  get_next_jobs_context.response = make_shared<GetNextJobsResponse>();
+  if (messages.empty()) {
+    SCP_INFO_CONTEXT(kJobClientProvider, get_next_jobs_context,
+                     "No jobs received from the job queue.");
+    get_next_jobs_context.result = SuccessExecutionResult();
+    get_next_jobs_context.Finish();
+    return;
+  }
+
+  // The jobs are added upfront, so that the concurrent lookups below only
+  // write to their own job.
+  for (int i = 0; i < messages.size(); ++i) {
+    get_next_jobs_context.response->add_jobs();
+  }
+  auto tracker = make_shared<GetNextJobsTracker>(messages.size());
+  for (int i = 0; i < messages.size(); ++i) {
+    AsyncContext<GetNextJobRequest, GetNextJobResponse> get_next_job_context(
+        make_shared<GetNextJobRequest>(),
+        bind(&JobClientProvider::OnGetNextJobsItemCallback, this,
+             get_next_jobs_context, tracker, i, messages[i].receipt_info(),
+             _1),
+        get_next_jobs_context);
+    GetJobOfMessage(get_next_job_context, messages[i]);
+  }
+}
+
+void JobClientProvider::OnGetNextJobsItemCallback(
+    AsyncContext<GetNextJobsRequest, GetNextJobsResponse>&
+        get_next_jobs_context,
+    shared_ptr<GetNextJobsTracker> tracker, size_t index,
+    const string& receipt_info,
+    AsyncContext<GetNextJobRequest, GetNextJobResponse>&
+        get_next_job_context) noexcept {
+  // A failing lookup may finish the job context more than once.
+  if (tracker->is_job_complete[index].exchange(true)) {
+    return;
+  }
+
+  auto* job_response = get_next_jobs_context.response->mutable_jobs(index);
+  if (get_next_job_context.result.Successful() &&
+      get_next_job_context.response) {
+    *job_response = move(*get_next_job_context.response);
+  } else {
+    // Keeps the receipt info, e.g. to delete an orphaned job message.
+    job_response->set_receipt_info(receipt_info);
+  }
+  *job_response->mutable_result() = get_next_job_context.result.ToProto();
+
+  if (tracker->pending_job_count.fetch_sub(1) == 1) {
+    get_next_jobs_context.result = SuccessExecutionResult();
+    get_next_jobs_context.Finish();
+  }
+}
+
 void JobClientProvider::OnGetNextJobItemCallback(
     AsyncContext<GetNextJobRequest, GetNextJobResponse>& get_next_job_context,
     shared_ptr<string> receipt_info,
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
@@ -63,6 +64,11 @@ class JobClientProvider : public JobClientProviderInterface {
                          cmrt::sdk::job_service::v1::GetNextJobResponse>&
           get_next_job_context) noexcept override;
 
+  core::ExecutionResult GetNextJobs(
+      core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobsRequest,
+                         cmrt::sdk::job_service::v1::GetNextJobsResponse>&
+          get_next_jobs_context) noexcept override;
+
   core::ExecutionResult GetJobById(
       core::AsyncContext<cmrt::sdk::job_service::v1::GetJobByIdRequest,
                          cmrt::sdk::job_service::v1::GetJobByIdResponse>&
@@ -139,6 +145,69 @@ class JobClientProvider : public JobClientProviderInterface {
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept;
 
+  /**
+   * @brief Gets the job entry of the job message from the database.
+   *
+   * @param get_next_job_context the get next job context.
+   * @param message the job message from queue.
+   */
+  void GetJobOfMessage(
+      core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobRequest,
+                         cmrt::sdk::job_service::v1::GetNextJobResponse>&
+          get_next_job_context,
+      cmrt::sdk::queue_service::v1::GetTopMessageResponse& message) noexcept;
+
+  /// Tracks the jobs of a GetNextJobs call, which are read concurrently.
+  struct GetNextJobsTracker {
+    explicit GetNextJobsTracker(size_t job_count)
+        : pending_job_count(job_count),
+          is_job_complete(std::make_unique<std::atomic<bool>[]>(job_count)) {
+      for (size_t i = 0; i < job_count; ++i) {
+        is_job_complete[i] = false;
+      }
+    }
+
+    /// The number of jobs which are not complete yet.
+    std::atomic<size_t> pending_job_count;
+    /// Whether each job is complete, only the first completion counts.
+    std::unique_ptr<std::atomic<bool>[]> is_job_complete;
+  };
+
+  /**
+   * @brief Is called when the object is returned from the get top messages
+   * callback.
+   *
+   * @param get_next_jobs_context the get next jobs context.
+   * @param get_top_messages_context the get top messages context.
+   */
+  void OnGetTopMessagesCallback(
+      core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobsRequest,
+                         cmrt::sdk::job_service::v1::GetNextJobsResponse>&
+          get_next_jobs_context,
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept;
+
+  /**
+   * @brief Is called when a job of GetNextJobs is complete, and finishes the
+   * get next jobs context once all of them are.
+   *
+   * @param get_next_jobs_context the get next jobs context.
+   * @param tracker the tracker of the jobs.
+   * @param index the index of the job in the response.
+   * @param receipt_info the receipt info of the job message from queue.
+   * @param get_next_job_context the get next job context of the job.
+   */
+  void OnGetNextJobsItemCallback(
+      core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobsRequest,
+                         cmrt::sdk::job_service::v1::GetNextJobsResponse>&
+          get_next_jobs_context,
+      std::shared_ptr<GetNextJobsTracker> tracker, size_t index,
+      const std::string& receipt_info,
+      core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobRequest,
+                         cmrt::sdk::job_service::v1::GetNextJobResponse>&
+          get_next_job_context) noexcept;
+
   /**
    * @brief Is called when the object is returned from the get next job item
    * from database callback.
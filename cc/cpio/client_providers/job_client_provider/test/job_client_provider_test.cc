@@ -39,6 +39,8 @@ using google::cmrt::sdk::job_service::v1::GetJobByIdRequest;
 using google::cmrt::sdk::job_service::v1::GetJobByIdResponse;
 using google::cmrt::sdk::job_service::v1::GetNextJobRequest;
 using google::cmrt::sdk::job_service::v1::GetNextJobResponse;
+using google::cmrt::sdk::job_service::v1::GetNextJobsRequest;
+using google::cmrt::sdk::job_service::v1::GetNextJobsResponse;
 using google::cmrt::sdk::job_service::v1::Job;
 using google::cmrt::sdk::job_service::v1::JobStatus;
 using google::cmrt::sdk::job_service::v1::PutJobRequest;
@@ -55,6 +57,7 @@ using google::cmrt::sdk::nosql_database_service::v1::UpsertDatabaseItemResponse;
 using google::cmrt::sdk::queue_service::v1::DeleteMessageResponse;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutResponse;
 using google::protobuf::Any;
@@ -119,7 +122,9 @@ const google::protobuf::Timestamp kDefaultTimestamp =
     TimeUtil::SecondsToTimestamp(0);
 
 constexpr char kQueueMessageReceiptInfo[] = "receipt-info";
+constexpr char kQueueMessageReceiptInfo2[] = "receipt-info-2";
 constexpr char kJobId[] = "job-id";
+constexpr char kJobId2[] = "job-id-2";
 constexpr char kServerJobId[] = "server-job-id";
 constexpr char kServerJobId2[] = "server-job-id-2";
 constexpr char kDefaultTimestampValueInString[] = "0";
@@ -732,6 +737,114 @@ TEST_F(JobClientProviderTest, GetNextJobWithInvalidDatabaseItemFailure) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(JobClientProviderTest, GetNextJobsReadsEachJobEntry) {
+  EXPECT_SUCCESS(job_client_provider_->Init());
+  EXPECT_SUCCESS(job_client_provider_->Run());
+
+  EXPECT_CALL(*queue_client_provider_, GetTopMessages)
+      .WillOnce([](auto& get_top_messages_context) {
+        EXPECT_EQ(get_top_messages_context.request->max_number_of_messages(),
+                  5);
+        get_top_messages_context.response =
+            make_shared<GetTopMessagesResponse>();
+        auto* message = get_top_messages_context.response->add_messages();
+        message->set_message_id(kServerJobId);
+        message->set_message_body(kJobId);
+        message->set_receipt_info(kQueueMessageReceiptInfo);
+        message = get_top_messages_context.response->add_messages();
+        message->set_message_id(kServerJobId2);
+        message->set_message_body(kJobId2);
+        message->set_receipt_info(kQueueMessageReceiptInfo2);
+        get_top_messages_context.result = SuccessExecutionResult();
+        get_top_messages_context.Finish();
+        return SuccessExecutionResult();
+      });
+
+  auto created_time = TimeUtil::GetCurrentTime();
+  auto item = CreateJobAsDatabaseItem(
+      CreateHelloWorldProtoAsAny(), JobStatus::JOB_STATUS_CREATED,
+      created_time, created_time, kDefaultRetryCount,
+      TimeUtil::SecondsToTimestamp(0));
+
+  EXPECT_CALL(*nosql_database_client_provider_,
+              GetDatabaseItem(HasGetDatabaseItemParamsForGetNextJob(
+                  kJobsTableName, kJobId, kServerJobId)))
+      .WillOnce([&item](auto& get_database_item_context) {
+        get_database_item_context.response =
+            make_shared<GetDatabaseItemResponse>();
+        *get_database_item_context.response->mutable_item() = item;
+        get_database_item_context.result = SuccessExecutionResult();
+        get_database_item_context.Finish();
+        return SuccessExecutionResult();
+      });
+  // The second job entry is missing, and the provider finishes the context
+  // and fails synchronously.
+  EXPECT_CALL(*nosql_database_client_provider_,
+              GetDatabaseItem(HasGetDatabaseItemParamsForGetNextJob(
+                  kJobsTableName, kJobId2, kServerJobId2)))
+      .WillOnce([](auto& get_database_item_context) {
+        get_database_item_context.result = FailureExecutionResult(
+            SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND);
+        get_database_item_context.Finish();
+        return get_database_item_context.result;
+      });
+
+  std::atomic<int> finish_count{0};
+  AsyncContext<GetNextJobsRequest, GetNextJobsResponse> get_next_jobs_context(
+      make_shared<GetNextJobsRequest>(),
+      [this, &finish_count](
+          AsyncContext<GetNextJobsRequest, GetNextJobsResponse>&
+              get_next_jobs_context) {
+        finish_count++;
+        EXPECT_SUCCESS(get_next_jobs_context.result);
+        const auto& jobs = get_next_jobs_context.response->jobs();
+        ASSERT_EQ(jobs.size(), 2);
+
+        EXPECT_SUCCESS(ExecutionResult(jobs[0].result()));
+        EXPECT_EQ(jobs[0].job().job_id(), kJobId);
+        EXPECT_EQ(jobs[0].job().server_job_id(), kServerJobId);
+        EXPECT_EQ(jobs[0].receipt_info(), kQueueMessageReceiptInfo);
+
+        EXPECT_THAT(ExecutionResult(jobs[1].result()),
+                    ResultIs(FailureExecutionResult(
+                        SC_NO_SQL_DATABASE_PROVIDER_RECORD_NOT_FOUND)));
+        EXPECT_TRUE(jobs[1].job().job_id().empty());
+        EXPECT_EQ(jobs[1].receipt_info(), kQueueMessageReceiptInfo2);
+        finish_called_ = true;
+      });
+  get_next_jobs_context.request->set_max_number_of_jobs(5);
+
+  EXPECT_SUCCESS(job_client_provider_->GetNextJobs(get_next_jobs_context));
+
+  WaitUntil([this]() { return finish_called_.load(); });
+  EXPECT_EQ(finish_count, 1);
+}
+
+TEST_F(JobClientProviderTest, GetNextJobsWithNoMessagesAvailable) {
+  EXPECT_CALL(*queue_client_provider_, GetTopMessages)
+      .WillOnce([](auto& get_top_messages_context) {
+        get_top_messages_context.response =
+            make_shared<GetTopMessagesResponse>();
+        get_top_messages_context.result = SuccessExecutionResult();
+        get_top_messages_context.Finish();
+        return SuccessExecutionResult();
+      });
+
+  AsyncContext<GetNextJobsRequest, GetNextJobsResponse> get_next_jobs_context(
+      make_shared<GetNextJobsRequest>(),
+      [this](AsyncContext<GetNextJobsRequest, GetNextJobsResponse>&
+                 get_next_jobs_context) {
+        EXPECT_SUCCESS(get_next_jobs_context.result);
+        EXPECT_EQ(get_next_jobs_context.response->jobs().size(), 0);
+        finish_called_ = true;
+      });
+  get_next_jobs_context.request->set_max_number_of_jobs(5);
+
+  EXPECT_SUCCESS(job_client_provider_->GetNextJobs(get_next_jobs_context));
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 MATCHER_P2(HasGetDatabaseItemParamsForGetJobById, table_name, job_id, "") {
   return ExplainMatchResult(Eq(table_name),
                             arg.request->mutable_key()->table_name(),
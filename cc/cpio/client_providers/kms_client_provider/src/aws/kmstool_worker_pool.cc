@@ -0,0 +1,366 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "kmstool_worker_pool.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "core/common/global_logger/src/global_logger.h"
+#include "core/common/uuid/src/uuid.h"
+
+#include "tee_error_codes.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::kZeroUuid;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_INVALID_KMSTOOL_WORKER_OPTIONS;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_QUEUE_FULL;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_TIMEOUT;
+using std::array;
+using std::deque;
+using std::lock_guard;
+using std::make_unique;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+/// Filename for logging errors
+static constexpr char kKmstoolWorkerPool[] = "KmstoolWorkerPool";
+
+static constexpr char kErrorResponsePrefix[] = "ERROR";
+static constexpr size_t kReadBufferSize = 4096;
+/// Bounds how long Stop waits for a request in flight.
+static constexpr milliseconds kPollInterval = milliseconds(100);
+
+namespace google::scp::cpio::client_providers {
+
+KmstoolWorkerPool::~KmstoolWorkerPool() {
+  if (is_running_) {
+    Stop();
+  }
+}
+
+ExecutionResult KmstoolWorkerPool::Init() noexcept {
+  if (options_.worker_command.empty() || options_.worker_count == 0 ||
+      options_.max_pending_requests == 0) {
+    auto execution_result = FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_INVALID_KMSTOOL_WORKER_OPTIONS);
+    SCP_ERROR(kKmstoolWorkerPool, kZeroUuid, execution_result,
+              "The worker command, worker count and max pending requests "
+              "must be set.");
+    return execution_result;
+  }
+
+  for (size_t i = 0; i < options_.worker_count; ++i) {
+    workers_.push_back(make_unique<Worker>());
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult KmstoolWorkerPool::Run() noexcept {
+  is_running_ = true;
+  // Workers are started lazily by their first request so that a worker
+  // which fails to start is retried.
+  for (auto& worker : workers_) {
+    worker->thread =
+        thread([this, worker = worker.get()]() { ServeRequests(*worker); });
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult KmstoolWorkerPool::Stop() noexcept {
+  {
+    lock_guard lock(pending_requests_mutex_);
+    is_running_ = false;
+  }
+  pending_requests_condition_.notify_all();
+
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+    StopWorker(*worker);
+  }
+
+  deque<PendingRequest> pending_requests;
+  {
+    lock_guard lock(pending_requests_mutex_);
+    pending_requests.swap(pending_requests_);
+  }
+  for (auto& pending_request : pending_requests) {
+    pending_request.context.result = FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING);
+    pending_request.context.Finish();
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult KmstoolWorkerPool::Execute(
+    AsyncContext<string, string>& context) noexcept {
+  {
+    lock_guard lock(pending_requests_mutex_);
+    if (!is_running_) {
+      return FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING);
+    }
+    if (pending_requests_.size() >= options_.max_pending_requests) {
+      auto execution_result = FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_QUEUE_FULL);
+      SCP_ERROR_CONTEXT(kKmstoolWorkerPool, context, execution_result,
+                        "Too many pending requests: %zu.",
+                        pending_requests_.size());
+      return execution_result;
+    }
+    pending_requests_.push_back(
+        {context, steady_clock::now() + options_.request_timeout});
+  }
+  pending_requests_condition_.notify_one();
+  return SuccessExecutionResult();
+}
+
+void KmstoolWorkerPool::ServeRequests(Worker& worker) noexcept {
+  while (true) {
+    PendingRequest pending_request;
+    {
+      unique_lock lock(pending_requests_mutex_);
+      pending_requests_condition_.wait(lock, [this]() {
+        return !is_running_ || !pending_requests_.empty();
+      });
+      if (!is_running_) {
+        return;
+      }
+      pending_request = std::move(pending_requests_.front());
+      pending_requests_.pop_front();
+    }
+
+    auto& context = pending_request.context;
+    auto response = std::make_shared<string>();
+    if (steady_clock::now() >= pending_request.deadline) {
+      // Waited too long for a worker, the worker itself is fine.
+      context.result = FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_TIMEOUT);
+    } else {
+      context.result = ExchangeWithWorker(worker, *context.request,
+                                          pending_request.deadline, *response);
+    }
+
+    if (!context.result.Successful()) {
+      SCP_ERROR_CONTEXT(kKmstoolWorkerPool, context, context.result,
+                        "Kmstool worker request failed.");
+    } else {
+      context.response = std::move(response);
+    }
+    context.Finish();
+  }
+}
+
+ExecutionResult KmstoolWorkerPool::ExchangeWithWorker(
+    Worker& worker, const string& request, steady_clock::time_point deadline,
+    string& response) noexcept {
+  auto is_new_worker = worker.pid < 0;
+  if (is_new_worker) {
+    auto execution_result = StartWorker(worker);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  }
+
+  auto execution_result = SendAndReceive(worker, request, deadline, response);
+  if (!is_new_worker &&
+      execution_result.status_code ==
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED) {
+    // The worker may have exited while idle, which is only noticed once it
+    // is used. The request is retried once on a new worker.
+    execution_result = StartWorker(worker);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    execution_result = SendAndReceive(worker, request, deadline, response);
+  }
+  return execution_result;
+}
+
+ExecutionResult KmstoolWorkerPool::SendAndReceive(
+    Worker& worker, const string& request, steady_clock::time_point deadline,
+    string& response) noexcept {
+  auto message = request + "\n";
+  size_t sent = 0;
+  while (sent < message.size()) {
+    // MSG_NOSIGNAL prevents SIGPIPE if the worker has exited.
+    auto result = send(worker.fd, message.data() + sent, message.size() - sent,
+                       MSG_NOSIGNAL);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      StopWorker(worker);
+      return FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED);
+    }
+    sent += result;
+  }
+
+  array<char, kReadBufferSize> buffer;
+  while (true) {
+    auto new_line = worker.read_buffer.find('\n');
+    if (new_line != string::npos) {
+      response = worker.read_buffer.substr(0, new_line);
+      worker.read_buffer.erase(0, new_line + 1);
+      break;
+    }
+
+    if (!is_running_) {
+      StopWorker(worker);
+      return FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING);
+    }
+
+    auto remaining =
+        duration_cast<milliseconds>(deadline - steady_clock::now());
+    if (remaining.count() <= 0) {
+      // The response of a timed out request cannot be told apart from the
+      // next one, so the worker is restarted.
+      StopWorker(worker);
+      return FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_TIMEOUT);
+    }
+
+    pollfd poll_fd = {worker.fd, POLLIN, 0};
+    auto poll_result =
+        poll(&poll_fd, 1, std::min(remaining, kPollInterval).count());
+    if (poll_result < 0 && errno != EINTR) {
+      StopWorker(worker);
+      return FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED);
+    }
+    if (poll_result <= 0) {
+      continue;
+    }
+
+    auto read_bytes = recv(worker.fd, buffer.data(), buffer.size(), 0);
+    if (read_bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (read_bytes <= 0) {
+      // The worker exited.
+      StopWorker(worker);
+      return FailureExecutionResult(
+          SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED);
+    }
+    worker.read_buffer.append(buffer.data(), read_bytes);
+  }
+
+  if (response.rfind(kErrorResponsePrefix, 0) == 0) {
+    auto execution_result = FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED);
+    SCP_ERROR(kKmstoolWorkerPool, kZeroUuid, execution_result,
+              "Kmstool worker returned an error: %s", response.c_str());
+    return execution_result;
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult KmstoolWorkerPool::StartWorker(Worker& worker) noexcept {
+  int fds[2];
+  // Close on exec keeps the other workers from inheriting this socket.
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    auto execution_result = FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED);
+    char buffer_arr[1024];
+    char* error_msg = strerror_r(errno, buffer_arr, sizeof(buffer_arr));
+    SCP_ERROR(kKmstoolWorkerPool, kZeroUuid, execution_result,
+              "Failed to create the kmstool worker socket. Error message: %s",
+              error_msg);
+    return execution_result;
+  }
+
+  auto pid = fork();
+  if (pid == 0) {
+    // Only async signal safe calls are allowed in the child before exec.
+    // The worker gets its own process group so that its children are killed
+    // along with it.
+    setpgid(0, 0);
+    dup2(fds[1], STDIN_FILENO);
+    dup2(fds[1], STDOUT_FILENO);
+    execl("/bin/sh", "sh", "-c", options_.worker_command.c_str(), nullptr);
+    _exit(EXIT_FAILURE);
+  }
+
+  close(fds[1]);
+  if (pid > 0) {
+    // Also set in the parent, so that the process group exists before the
+    // worker can be killed even if the child has not run yet. Fails harmlessly
+    // if the child already called exec.
+    setpgid(pid, pid);
+  }
+  if (pid < 0) {
+    close(fds[0]);
+    auto execution_result = FailureExecutionResult(
+        SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED);
+    char buffer_arr[1024];
+    char* error_msg = strerror_r(errno, buffer_arr, sizeof(buffer_arr));
+    SCP_ERROR(kKmstoolWorkerPool, kZeroUuid, execution_result,
+              "Failed to start the kmstool worker. Command: %s Error "
+              "message: %s",
+              options_.worker_command.c_str(), error_msg);
+    return execution_result;
+  }
+
+  worker.pid = pid;
+  worker.fd = fds[0];
+  worker.read_buffer.clear();
+  return SuccessExecutionResult();
+}
+
+void KmstoolWorkerPool::StopWorker(Worker& worker) noexcept {
+  if (worker.fd >= 0) {
+    close(worker.fd);
+    worker.fd = -1;
+  }
+  if (worker.pid > 0) {
+    kill(-worker.pid, SIGKILL);
+    waitpid(worker.pid, nullptr, 0);
+    worker.pid = -1;
+  }
+  worker.read_buffer.clear();
+}
+}  // namespace google::scp::cpio::client_providers
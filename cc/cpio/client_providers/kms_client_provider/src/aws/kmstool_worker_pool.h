@@ -0,0 +1,132 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/interface/service_interface.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::cpio::client_providers {
+/// Configurations of the KmstoolWorkerPool.
+struct KmstoolWorkerPoolOptions {
+  /// Shell command starting one worker process.
+  std::string worker_command;
+  /// Number of worker processes, each serving one request at a time.
+  size_t worker_count = 4;
+  /// Requests are rejected beyond this many waiting for a worker.
+  size_t max_pending_requests = 1000;
+  /// Time allowed for a request from being queued until its response is read.
+  /// A worker that does not respond in time is killed and restarted.
+  std::chrono::milliseconds request_timeout = std::chrono::seconds(10);
+};
+
+/**
+ * @brief Keeps a pool of long running kmstool worker processes and
+ * multiplexes requests on them, so that a process is not started for every
+ * decryption.
+ *
+ * A worker reads one request per line from its stdin and writes one response
+ * per line to its stdout. The request is the kmstool_enclave_cli arguments,
+ * e.g. "decrypt --region ... --ciphertext ...", and the response is the
+ * kmstool_enclave_cli output, e.g. "PLAINTEXT: ...". A response starting with
+ * "ERROR" fails the request. A worker which exits is restarted on its next
+ * request.
+ */
+class KmstoolWorkerPool : public core::ServiceInterface {
+ public:
+  explicit KmstoolWorkerPool(const KmstoolWorkerPoolOptions& options)
+      : options_(options), is_running_(false) {}
+
+  ~KmstoolWorkerPool() override;
+
+  core::ExecutionResult Init() noexcept override;
+
+  core::ExecutionResult Run() noexcept override;
+
+  core::ExecutionResult Stop() noexcept override;
+
+  /**
+   * @brief Queues a request for the next available worker.
+   *
+   * @param context the request line without the trailing new line, and the
+   * response line once finished.
+   * @return core::ExecutionResult whether the request was queued.
+   */
+  core::ExecutionResult Execute(
+      core::AsyncContext<std::string, std::string>& context) noexcept;
+
+ protected:
+  struct Worker {
+    pid_t pid = -1;
+    /// The parent end of the socket pair connected to the worker's stdin
+    /// and stdout.
+    int fd = -1;
+    /// Bytes read from the worker past the last returned response.
+    std::string read_buffer;
+    std::thread thread;
+  };
+
+  struct PendingRequest {
+    core::AsyncContext<std::string, std::string> context;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  /// Serves the pending requests on the worker until the pool is stopped.
+  void ServeRequests(Worker& worker) noexcept;
+
+  /**
+   * @brief Sends the request to the worker and reads its response, starting
+   * the worker first if it is not running.
+   */
+  core::ExecutionResult ExchangeWithWorker(
+      Worker& worker, const std::string& request,
+      std::chrono::steady_clock::time_point deadline,
+      std::string& response) noexcept;
+
+  /// Sends the request to the running worker and reads its response.
+  core::ExecutionResult SendAndReceive(
+      Worker& worker, const std::string& request,
+      std::chrono::steady_clock::time_point deadline,
+      std::string& response) noexcept;
+
+  /// Starts the worker process.
+  core::ExecutionResult StartWorker(Worker& worker) noexcept;
+
+  /// Kills the worker process, if any, and waits for it to exit.
+  void StopWorker(Worker& worker) noexcept;
+
+  const KmstoolWorkerPoolOptions options_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex pending_requests_mutex_;
+  std::condition_variable pending_requests_condition_;
+  std::deque<PendingRequest> pending_requests_;
+  std::atomic<bool> is_running_;
+};
+}  // namespace google::scp::cpio::client_providers
@@ -17,12 +17,16 @@
 #include "nontee_aws_kms_client_provider.h"
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 
 #include "core/async_executor/src/aws/aws_async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
 #include "core/utils/src/base64.h"
 #include "cpio/client_providers/interface/role_credentials_provider_interface.h"
 #include "cpio/common/src/aws/aws_utils.h"
@@ -41,8 +45,11 @@ using google::scp::core::AsyncContext;
 using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
 using google::scp::core::async_executor::aws::AwsAsyncExecutor;
 using google::scp::core::common::kZeroUuid;
+using google::scp::core::common::TimeProvider;
+using google::scp::core::common::Uuid;
 using google::scp::core::errors::
     SC_AWS_KMS_CLIENT_PROVIDER_ASSUME_ROLE_NOT_FOUND;
 using google::scp::core::errors::
@@ -56,10 +63,14 @@ using google::scp::core::errors::SC_AWS_KMS_CLIENT_PROVIDER_REGION_NOT_FOUND;
 using google::scp::core::utils::Base64Decode;
 using google::scp::cpio::common::CreateClientConfiguration;
 using std::bind;
+using std::lock_guard;
 using std::make_shared;
 using std::move;
+using std::mutex;
 using std::shared_ptr;
 using std::string;
+using std::vector;
+using std::chrono::nanoseconds;
 using std::placeholders::_1;
 
 /// Filename for logging errors
@@ -81,10 +92,20 @@ ExecutionResult NonteeAwsKmsClientProvider::Init() noexcept {
 }
 
 ExecutionResult NonteeAwsKmsClientProvider::Run() noexcept {
-  return SuccessExecutionResult();
+  {
+    lock_guard<mutex> lock(refresh_mutex_);
+    is_running_ = true;
+  }
+  return ScheduleKmsClientsRefresh();
 }
 
 ExecutionResult NonteeAwsKmsClientProvider::Stop() noexcept {
+  lock_guard<mutex> lock(refresh_mutex_);
+  is_running_ = false;
+  if (refresh_canceller_) {
+    refresh_canceller_();
+    refresh_canceller_ = nullptr;
+  }
   return SuccessExecutionResult();
 }
 
@@ -222,22 +243,69 @@ void NonteeAwsKmsClientProvider::CreateKmsCallbackToCreateAead(
 
 ExecutionResult NonteeAwsKmsClientProvider::CreateKmsClient(
     AsyncContext<DecryptRequest, KMSClient>& create_kms_context) noexcept {
+  const auto& account_identity = create_kms_context.request->account_identity();
+  const auto& kms_region = create_kms_context.request->kms_region();
+  auto cache_key = account_identity + "/" + kms_region;
+
+  shared_ptr<KMSClient> kms_client;
+  {
+    lock_guard<mutex> lock(kms_clients_mutex_);
+    auto& cached_kms_client = kms_clients_[cache_key];
+    auto usable_until_timestamp =
+        TimeProvider::GetWallTimestampInNanosecondsAsClockTicks() +
+        nanoseconds(kKmsClientCredentialsExpirationMargin).count();
+    if (cached_kms_client.kms_client &&
+        usable_until_timestamp < cached_kms_client.expiration_timestamp) {
+      kms_client = cached_kms_client.kms_client;
+    } else {
+      cached_kms_client.pending_contexts.push_back(create_kms_context);
+      if (cached_kms_client.is_refreshing) {
+        // Joins the request already fetching credentials for this client.
+        return SuccessExecutionResult();
+      }
+      cached_kms_client.is_refreshing = true;
+    }
+  }
+
+  if (kms_client) {
+    create_kms_context.response = kms_client;
+    create_kms_context.result = SuccessExecutionResult();
+    create_kms_context.Finish();
+    return SuccessExecutionResult();
+  }
+
+  return FetchCredentialsForKmsClient(
+      cache_key, account_identity, kms_region, create_kms_context.activity_id,
+      create_kms_context.correlation_id);
+}
+
+ExecutionResult NonteeAwsKmsClientProvider::FetchCredentialsForKmsClient(
+    const string& cache_key, const string& account_identity,
+    const string& kms_region, const Uuid& parent_activity_id,
+    const Uuid& correlation_id) noexcept {
   auto request = make_shared<GetRoleCredentialsRequest>();
-  request->account_identity = make_shared<AccountIdentity>(
-      create_kms_context.request->account_identity());
+  request->account_identity = make_shared<AccountIdentity>(account_identity);
   AsyncContext<GetRoleCredentialsRequest, GetRoleCredentialsResponse>
       get_role_credentials_context(
           move(request),
           bind(&NonteeAwsKmsClientProvider::
                    GetSessionCredentialsCallbackToCreateKms,
-               this, create_kms_context, _1),
-          create_kms_context);
-  return role_credentials_provider_->GetRoleCredentials(
+               this, cache_key, kms_region, _1),
+          parent_activity_id, correlation_id);
+  auto execution_result = role_credentials_provider_->GetRoleCredentials(
       get_role_credentials_context);
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kNonteeAwsKmsClientProvider, kZeroUuid, execution_result,
+              "Failed to fetch AWS Credentials for %s.", cache_key.c_str());
+    // The pending requests, including the one that triggered the fetch, are
+    // finished with the failure, so it is not returned to be finished again.
+    FailPendingKmsClientRequests(cache_key, execution_result);
+  }
+  return SuccessExecutionResult();
 }
 
 void NonteeAwsKmsClientProvider::GetSessionCredentialsCallbackToCreateKms(
-    AsyncContext<DecryptRequest, KMSClient>& create_kms_context,
+    const string& cache_key, const string& kms_region,
     AsyncContext<GetRoleCredentialsRequest, GetRoleCredentialsResponse>&
         get_session_credentials_context) noexcept {
   auto execution_result = get_session_credentials_context.result;
@@ -245,8 +313,7 @@ void NonteeAwsKmsClientProvider::GetSessionCredentialsCallbackToCreateKms(
     SCP_ERROR_CONTEXT(kNonteeAwsKmsClientProvider,
                       get_session_credentials_context, execution_result,
                       "Failed to get AWS Credentials.");
-    create_kms_context.result = execution_result;
-    create_kms_context.Finish();
+    FailPendingKmsClientRequests(cache_key, execution_result);
     return;
   }
 
@@ -256,12 +323,99 @@ void NonteeAwsKmsClientProvider::GetSessionCredentialsCallbackToCreateKms(
       response.access_key_id->c_str(), response.access_key_secret->c_str(),
       response.security_token->c_str());
 
-  auto kms_client = GetKmsClient(
-      move(aws_credentials),
-      make_shared<string>(create_kms_context.request->kms_region()));
-  create_kms_context.response = kms_client;
-  create_kms_context.result = SuccessExecutionResult();
-  create_kms_context.Finish();
+  auto kms_client =
+      GetKmsClient(move(aws_credentials), make_shared<string>(kms_region));
+  Timestamp expiration_timestamp = response.expiration_timestamp;
+  if (expiration_timestamp == 0) {
+    expiration_timestamp =
+        TimeProvider::GetWallTimestampInNanosecondsAsClockTicks() +
+        nanoseconds(kDefaultKmsClientCredentialsLifetime).count();
+  }
+
+  vector<AsyncContext<DecryptRequest, KMSClient>> pending_contexts;
+  {
+    lock_guard<mutex> lock(kms_clients_mutex_);
+    auto& cached_kms_client = kms_clients_[cache_key];
+    cached_kms_client.kms_client = kms_client;
+    cached_kms_client.expiration_timestamp = expiration_timestamp;
+    cached_kms_client.is_refreshing = false;
+    pending_contexts.swap(cached_kms_client.pending_contexts);
+  }
+
+  for (auto& create_kms_context : pending_contexts) {
+    create_kms_context.response = kms_client;
+    create_kms_context.result = SuccessExecutionResult();
+    create_kms_context.Finish();
+  }
+}
+
+void NonteeAwsKmsClientProvider::FailPendingKmsClientRequests(
+    const string& cache_key, const ExecutionResult& execution_result) noexcept {
+  vector<AsyncContext<DecryptRequest, KMSClient>> pending_contexts;
+  {
+    lock_guard<mutex> lock(kms_clients_mutex_);
+    auto& cached_kms_client = kms_clients_[cache_key];
+    cached_kms_client.is_refreshing = false;
+    pending_contexts.swap(cached_kms_client.pending_contexts);
+  }
+
+  for (auto& create_kms_context : pending_contexts) {
+    create_kms_context.result = execution_result;
+    create_kms_context.Finish();
+  }
+}
+
+void NonteeAwsKmsClientProvider::RefreshKmsClients() noexcept {
+  {
+    lock_guard<mutex> lock(refresh_mutex_);
+    if (!is_running_) {
+      return;
+    }
+  }
+
+  // The clients are refreshed while still valid, so requests keep using the
+  // current client until the new one is created.
+  vector<string> cache_keys_to_refresh;
+  {
+    lock_guard<mutex> lock(kms_clients_mutex_);
+    auto refresh_after_timestamp =
+        TimeProvider::GetWallTimestampInNanosecondsAsClockTicks() +
+        nanoseconds(kKmsClientCredentialsRefreshWindow).count();
+    for (auto& [cache_key, cached_kms_client] : kms_clients_) {
+      if (cached_kms_client.kms_client && !cached_kms_client.is_refreshing &&
+          cached_kms_client.expiration_timestamp < refresh_after_timestamp) {
+        cached_kms_client.is_refreshing = true;
+        cache_keys_to_refresh.push_back(cache_key);
+      }
+    }
+  }
+
+  for (const auto& cache_key : cache_keys_to_refresh) {
+    auto separator = cache_key.rfind('/');
+    FetchCredentialsForKmsClient(cache_key, cache_key.substr(0, separator),
+                                 cache_key.substr(separator + 1), kZeroUuid,
+                                 kZeroUuid);
+  }
+
+  auto execution_result = ScheduleKmsClientsRefresh();
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kNonteeAwsKmsClientProvider, kZeroUuid, execution_result,
+              "Failed to schedule the refresh of the KMS Clients.");
+  }
+}
+
+ExecutionResult
+NonteeAwsKmsClientProvider::ScheduleKmsClientsRefresh() noexcept {
+  lock_guard<mutex> lock(refresh_mutex_);
+  if (!is_running_) {
+    return SuccessExecutionResult();
+  }
+  return io_async_executor_->ScheduleFor(
+      [this]() { RefreshKmsClients(); },
+      (TimeProvider::GetSteadyTimestampInNanoseconds() +
+       kKmsClientsRefreshInterval)
+          .count(),
+      refresh_canceller_);
 }
 
 shared_ptr<ClientConfiguration>
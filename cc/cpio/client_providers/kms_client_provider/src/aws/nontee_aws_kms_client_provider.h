@@ -16,8 +16,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
@@ -25,13 +29,33 @@
 #include <aws/kms/KMSClient.h>
 #include <tink/aead.h>
 
+#include "absl/container/flat_hash_map.h"
 #include "core/interface/async_context.h"
 #include "cpio/client_providers/interface/kms_client_provider_interface.h"
 #include "cpio/client_providers/interface/role_credentials_provider_interface.h"
 #include "public/core/interface/execution_result.h"
 
 namespace google::scp::cpio::client_providers {
+/// Credentials with an unknown expiration are refreshed after this long.
+static constexpr std::chrono::minutes kDefaultKmsClientCredentialsLifetime =
+    std::chrono::minutes(15);
+/// Cached KMS clients are not used within this time of their expiration.
+static constexpr std::chrono::minutes kKmsClientCredentialsExpirationMargin =
+    std::chrono::minutes(1);
+/// Cached KMS clients are refreshed in the background within this time of
+/// their expiration.
+static constexpr std::chrono::minutes kKmsClientCredentialsRefreshWindow =
+    std::chrono::minutes(5);
+/// How often the cached KMS clients are checked for refresh.
+static constexpr std::chrono::seconds kKmsClientsRefreshInterval =
+    std::chrono::seconds(60);
+
 /*! @copydoc KmsClientProviderInterface
+ *
+ * One KMS client is kept per role and region and shared by all the
+ * decryptions, so that the role credentials and the connections to KMS are
+ * reused. The clients are recreated with fresh credentials in the background
+ * before the credentials expire.
  */
 class NonteeAwsKmsClientProvider : public KmsClientProviderInterface {
  public:
@@ -89,8 +113,24 @@ class NonteeAwsKmsClientProvider : public KmsClientProviderInterface {
   virtual std::shared_ptr<Aws::Client::ClientConfiguration>
   CreateClientConfiguration(const std::string& region) noexcept;
 
+  /// A KMS client shared by the decryptions of a role and region.
+  struct CachedKmsClient {
+    std::shared_ptr<Aws::KMS::KMSClient> kms_client;
+    /// The wall clock time in nanoseconds when the credentials of the client
+    /// expire.
+    core::Timestamp expiration_timestamp = 0;
+    /// Whether credentials are being fetched to create a new client.
+    bool is_refreshing = false;
+    /// The requests waiting for the new client.
+    std::vector<core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                                   Aws::KMS::KMSClient>>
+        pending_contexts;
+  };
+
   /**
-   * @brief Creates a KMS Client object.
+   * @brief Gets the KMS Client of the role and region of the request. The
+   * cached client is returned if its credentials are still valid, otherwise
+   * the request waits for a new client to be created.
    *
    * @param create_kms_context the context of created KMS Client.
    * @return core::ExecutionResult the creation results.
@@ -100,19 +140,56 @@ class NonteeAwsKmsClientProvider : public KmsClientProviderInterface {
                          Aws::KMS::KMSClient>& create_kms_context) noexcept;
 
   /**
-   * @brief Callback to pass session credentials to create KMS Client.
+   * @brief Fetches role credentials to create a new KMS Client for the cache
+   * entry.
    *
-   * @param create_kms_context the context of created KMS Client.
+   * @param cache_key the key of the cache entry.
+   * @param account_identity the role to assume.
+   * @param kms_region the region of the KMS Client.
+   * @param parent_activity_id the activity id of the request the credentials
+   * are fetched for, or kZeroUuid for a background refresh.
+   * @param correlation_id the correlation id of that request.
+   * @return core::ExecutionResult always successful, since the pending
+   * requests are finished with the failure if the fetch cannot start.
+   */
+  core::ExecutionResult FetchCredentialsForKmsClient(
+      const std::string& cache_key, const std::string& account_identity,
+      const std::string& kms_region,
+      const core::common::Uuid& parent_activity_id,
+      const core::common::Uuid& correlation_id) noexcept;
+
+  /**
+   * @brief Callback to pass session credentials to create KMS Client. The
+   * new client is cached and passed to all the waiting requests.
+   *
+   * @param cache_key the key of the cache entry.
+   * @param kms_region the region of the KMS Client.
    * @param get_session_credentials_contexts the context of fetched session
    * credentials.
-   * @return core::ExecutionResult the creation results.
    */
   void GetSessionCredentialsCallbackToCreateKms(
-      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
-                         Aws::KMS::KMSClient>& create_kms_context,
+      const std::string& cache_key, const std::string& kms_region,
       core::AsyncContext<GetRoleCredentialsRequest, GetRoleCredentialsResponse>&
           get_role_credentials_contexts) noexcept;
 
+  /**
+   * @brief Fails the requests waiting for a new KMS Client of the cache entry.
+   *
+   * @param cache_key the key of the cache entry.
+   * @param execution_result the failure.
+   */
+  void FailPendingKmsClientRequests(
+      const std::string& cache_key,
+      const core::ExecutionResult& execution_result) noexcept;
+
+  /// Refreshes the cached KMS Clients whose credentials expire soon and
+  /// schedules the next refresh.
+  void RefreshKmsClients() noexcept;
+
+  /// Schedules RefreshKmsClients after kKmsClientsRefreshInterval, unless the
+  /// provider is stopped.
+  core::ExecutionResult ScheduleKmsClientsRefresh() noexcept;
+
   /**
    * @brief Fetches session credentials.
    *
@@ -161,5 +238,16 @@ class NonteeAwsKmsClientProvider : public KmsClientProviderInterface {
 
   /// The instance of the io async executor.
   const std::shared_ptr<core::AsyncExecutorInterface> io_async_executor_;
+
+  /// The KMS Clients by role and region.
+  absl::flat_hash_map<std::string, CachedKmsClient> kms_clients_;
+  std::mutex kms_clients_mutex_;
+
+  /// Cancels the scheduled refresh of the KMS Clients.
+  std::function<bool()> refresh_canceller_;
+  bool is_running_ = false;
+  /// Mutex for refresh_canceller_ and is_running_, so that Stop cancels the
+  /// last scheduled refresh and no refresh is scheduled after it.
+  std::mutex refresh_mutex_;
 };
 }  // namespace google::scp::cpio::client_providers
@@ -71,32 +71,34 @@ static constexpr char kTeeAwsKmsClientProvider[] = "TeeAwsKmsClientProvider";
 
 static constexpr int kBufferSize = 1024;
 
-static void BuildDecryptCmd(const string& region, const string& ciphertext,
-                            const string& access_key_id,
-                            const string& access_key_secret,
-                            const string& security_token,
-                            string& command) noexcept {
+static constexpr char kKmstoolEnclaveCli[] = "/kmstool_enclave_cli";
+
+static void BuildDecryptArgs(const string& region, const string& ciphertext,
+                             const string& access_key_id,
+                             const string& access_key_secret,
+                             const string& security_token,
+                             string& args) noexcept {
   if (!region.empty()) {
-    command += string(" --region ") + region;
+    args += string(" --region ") + region;
   }
 
   if (!access_key_id.empty()) {
-    command += string(" --aws-access-key-id ") + access_key_id;
+    args += string(" --aws-access-key-id ") + access_key_id;
   }
 
   if (!access_key_secret.empty()) {
-    command += string(" --aws-secret-access-key ") + access_key_secret;
+    args += string(" --aws-secret-access-key ") + access_key_secret;
   }
 
   if (!security_token.empty()) {
-    command += string(" --aws-session-token ") + security_token;
+    args += string(" --aws-session-token ") + security_token;
   }
 
   if (!ciphertext.empty()) {
-    command += string(" --ciphertext ") + ciphertext;
+    args += string(" --ciphertext ") + ciphertext;
   }
 
-  command = "/kmstool_enclave_cli decrypt" + command;
+  args = "decrypt" + args;
 }
 
 namespace google::scp::cpio::client_providers {
@@ -110,14 +112,23 @@ ExecutionResult TeeAwsKmsClientProvider::Init() noexcept {
     return execution_result;
   }
 
+  if (kmstool_worker_pool_) {
+    return kmstool_worker_pool_->Init();
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult TeeAwsKmsClientProvider::Run() noexcept {
+  if (kmstool_worker_pool_) {
+    return kmstool_worker_pool_->Run();
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult TeeAwsKmsClientProvider::Stop() noexcept {
+  if (kmstool_worker_pool_) {
+    return kmstool_worker_pool_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
@@ -187,16 +198,34 @@ void TeeAwsKmsClientProvider::GetSessionCredentialsCallbackToDecrypt(
   const auto& get_session_credentials_response =
       *get_session_credentials_context.response;
 
-  string command;
-  BuildDecryptCmd(decrypt_context.request->kms_region(),
-                  decrypt_context.request->ciphertext(),
-                  get_session_credentials_response.access_key_id->c_str(),
-                  get_session_credentials_response.access_key_secret->c_str(),
-                  get_session_credentials_response.security_token->c_str(),
-                  command);
+  auto args = make_shared<string>();
+  BuildDecryptArgs(decrypt_context.request->kms_region(),
+                   decrypt_context.request->ciphertext(),
+                   get_session_credentials_response.access_key_id->c_str(),
+                   get_session_credentials_response.access_key_secret->c_str(),
+                   get_session_credentials_response.security_token->c_str(),
+                   *args);
+
+  if (kmstool_worker_pool_) {
+    AsyncContext<string, string> kmstool_context(
+        move(args),
+        bind(&TeeAwsKmsClientProvider::OnKmstoolWorkerDecryptCallback, this,
+             decrypt_context, _1),
+        decrypt_context);
+    auto execution_result = kmstool_worker_pool_->Execute(kmstool_context);
+    if (!execution_result.Successful()) {
+      SCP_ERROR_CONTEXT(kTeeAwsKmsClientProvider, decrypt_context,
+                        execution_result,
+                        "Failed to send the decryption to a kmstool worker.");
+      decrypt_context.result = execution_result;
+      decrypt_context.Finish();
+    }
+    return;
+  }
 
   string plaintext;
-  auto execute_result = DecryptUsingEnclavesKmstoolCli(command, plaintext);
+  auto execute_result = DecryptUsingEnclavesKmstoolCli(
+      string(kKmstoolEnclaveCli) + " " + *args, plaintext);
 
   if (!execute_result.Successful()) {
     decrypt_context.result = execute_result;
@@ -204,9 +233,30 @@ void TeeAwsKmsClientProvider::GetSessionCredentialsCallbackToDecrypt(
     return;
   }
 
+  FinishDecrypt(decrypt_context, plaintext);
+}
+
+void TeeAwsKmsClientProvider::OnKmstoolWorkerDecryptCallback(
+    AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context,
+    AsyncContext<string, string>& kmstool_context) noexcept {
+  if (!kmstool_context.result.Successful()) {
+    decrypt_context.result = kmstool_context.result;
+    decrypt_context.Finish();
+    return;
+  }
+
+  string plaintext;
+  TeeAwsKmsClientProviderUtils::ExtractPlaintext(*kmstool_context.response,
+                                                 plaintext);
+  FinishDecrypt(decrypt_context, plaintext);
+}
+
+void TeeAwsKmsClientProvider::FinishDecrypt(
+    AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context,
+    const string& plaintext) noexcept {
   // Decode the plaintext.
   string decoded_plaintext;
-  execute_result = Base64Decode(plaintext, decoded_plaintext);
+  auto execute_result = Base64Decode(plaintext, decoded_plaintext);
   if (!execute_result.Successful()) {
     SCP_ERROR_CONTEXT(kTeeAwsKmsClientProvider, decrypt_context, execute_result,
                       "Failed to decode data.");
@@ -269,6 +319,12 @@ std::shared_ptr<KmsClientProviderInterface> KmsClientProviderFactory::Create(
         role_credentials_provider,
     const shared_ptr<core::AsyncExecutorInterface>&
         io_async_executor) noexcept {
+  auto tee_options = std::dynamic_pointer_cast<TeeAwsKmsClientOptions>(options);
+  if (tee_options &&
+      !tee_options->kmstool_worker_pool_options.worker_command.empty()) {
+    return make_shared<TeeAwsKmsClientProvider>(
+        role_credentials_provider, tee_options->kmstool_worker_pool_options);
+  }
   return make_shared<TeeAwsKmsClientProvider>(role_credentials_provider);
 }
 #endif
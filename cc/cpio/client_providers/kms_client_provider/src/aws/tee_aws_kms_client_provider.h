@@ -24,8 +24,19 @@
 #include "cpio/client_providers/interface/kms_client_provider_interface.h"
 #include "cpio/client_providers/interface/role_credentials_provider_interface.h"
 #include "public/core/interface/execution_result.h"
+#include "public/cpio/interface/kms_client/type_def.h"
+
+#include "kmstool_worker_pool.h"
 
 namespace google::scp::cpio::client_providers {
+/// KmsClientOptions of the AWS Enclaves KMS client.
+struct TeeAwsKmsClientOptions : public KmsClientOptions {
+  /// If the worker command is set, decryptions are sent to a pool of long
+  /// running kmstool workers instead of starting kmstool_enclave_cli for
+  /// every decryption.
+  KmstoolWorkerPoolOptions kmstool_worker_pool_options;
+};
+
 /*! @copydoc KmsClientProviderInterface
  */
 class TeeAwsKmsClientProvider : public KmsClientProviderInterface {
@@ -40,6 +51,21 @@ class TeeAwsKmsClientProvider : public KmsClientProviderInterface {
           credential_provider)
       : credential_provider_(credential_provider) {}
 
+  /**
+   * @brief Constructs a new Aws Enclaves Kms Client Provider decrypting with
+   * a pool of kmstool workers.
+   *
+   * @param credential_provider the credential provider.
+   * @param kmstool_worker_pool_options the options of the kmstool workers.
+   */
+  TeeAwsKmsClientProvider(
+      const std::shared_ptr<RoleCredentialsProviderInterface>&
+          credential_provider,
+      const KmstoolWorkerPoolOptions& kmstool_worker_pool_options)
+      : credential_provider_(credential_provider),
+        kmstool_worker_pool_(
+            std::make_shared<KmstoolWorkerPool>(kmstool_worker_pool_options)) {}
+
   TeeAwsKmsClientProvider() = delete;
 
   core::ExecutionResult Init() noexcept override;
@@ -72,7 +98,34 @@ class TeeAwsKmsClientProvider : public KmsClientProviderInterface {
   virtual core::ExecutionResult DecryptUsingEnclavesKmstoolCli(
       const std::string& command, std::string& plaintext) noexcept;
 
+  /**
+   * @brief Callback of a decryption by a kmstool worker.
+   *
+   * @param decrypt_context the context of the decryption.
+   * @param kmstool_context the context of the kmstool worker request.
+   */
+  void OnKmstoolWorkerDecryptCallback(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&
+          decrypt_context,
+      core::AsyncContext<std::string, std::string>& kmstool_context) noexcept;
+
+  /**
+   * @brief Decodes the plaintext output by kmstool and finishes the
+   * decryption.
+   *
+   * @param decrypt_context the context of the decryption.
+   * @param plaintext the base64 encoded plaintext output by kmstool.
+   */
+  void FinishDecrypt(
+      core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
+                         cmrt::sdk::kms_service::v1::DecryptResponse>&
+          decrypt_context,
+      const std::string& plaintext) noexcept;
+
   /// Credential provider.
   const std::shared_ptr<RoleCredentialsProviderInterface> credential_provider_;
+  /// The pool of kmstool workers, if decryptions do not start a process.
+  const std::shared_ptr<KmstoolWorkerPool> kmstool_worker_pool_;
 };
 }  // namespace google::scp::cpio::client_providers
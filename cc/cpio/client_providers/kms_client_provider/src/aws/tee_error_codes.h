@@ -51,6 +51,31 @@ DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_CLI_EXECUTION_FAILED,
                   "Cannot execute enclaves kmstools cli",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_INVALID_KMSTOOL_WORKER_OPTIONS,
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x0008,
+                  "Invalid kmstool worker pool options",
+                  HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_QUEUE_FULL,
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x0009,
+                  "Too many pending kmstool worker requests",
+                  HttpStatusCode::TOO_MANY_REQUESTS)
+
+DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING,
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x000A,
+                  "The kmstool worker pool is not running",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_TIMEOUT,
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x000B,
+                  "The kmstool worker did not respond in time",
+                  HttpStatusCode::REQUEST_TIMEOUT)
+
+DEFINE_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED,
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER, 0x000C,
+                  "Cannot communicate with the kmstool worker",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 MAP_TO_PUBLIC_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_ASSUME_ROLE_NOT_FOUND,
                          SC_CPIO_COMPONENT_FAILED_INITIALIZED)
 MAP_TO_PUBLIC_ERROR_CODE(
@@ -67,5 +92,18 @@ MAP_TO_PUBLIC_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED,
 MAP_TO_PUBLIC_ERROR_CODE(
     SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_CLI_EXECUTION_FAILED,
     SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_INVALID_KMSTOOL_WORKER_OPTIONS,
+    SC_CPIO_COMPONENT_FAILED_INITIALIZED)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_QUEUE_FULL,
+    SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING,
+    SC_CPIO_COMPONENT_NOT_RUNNING)
+MAP_TO_PUBLIC_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_TIMEOUT,
+                         SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED,
+                         SC_CPIO_INTERNAL_ERROR)
 
 }  // namespace google::scp::core::errors
@@ -0,0 +1,267 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cpio/client_providers/kms_client_provider/src/aws/kmstool_worker_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "core/test/utils/conditional_wait.h"
+#include "cpio/client_providers/kms_client_provider/src/aws/tee_error_codes.h"
+#include "public/core/interface/execution_result.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_INVALID_KMSTOOL_WORKER_OPTIONS;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_QUEUE_FULL;
+using google::scp::core::errors::
+    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_TIMEOUT;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::WaitUntil;
+using std::atomic;
+using std::make_shared;
+using std::make_unique;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using std::chrono::milliseconds;
+
+/// Fake worker answering every request with its last argument.
+static constexpr char kEchoWorkerCommand[] =
+    "while read -r line; do echo \"PLAINTEXT: ${line##* }\"; done";
+
+namespace google::scp::cpio::client_providers::test {
+class KmstoolWorkerPoolWithPendingCount : public KmstoolWorkerPool {
+ public:
+  KmstoolWorkerPoolWithPendingCount(const string& worker_command,
+                                    size_t max_pending_requests)
+      : KmstoolWorkerPool(KmstoolWorkerPoolOptions{
+            worker_command, /*worker_count=*/1, max_pending_requests,
+            /*request_timeout=*/milliseconds(60000)}) {}
+
+  size_t GetPendingRequestCount() {
+    std::lock_guard lock(pending_requests_mutex_);
+    return pending_requests_.size();
+  }
+};
+
+class KmstoolWorkerPoolTest : public ::testing::Test {
+ protected:
+  void CreatePool(const string& worker_command, size_t worker_count = 2,
+                  size_t max_pending_requests = 100,
+                  milliseconds request_timeout = milliseconds(5000)) {
+    KmstoolWorkerPoolOptions options;
+    options.worker_command = worker_command;
+    options.worker_count = worker_count;
+    options.max_pending_requests = max_pending_requests;
+    options.request_timeout = request_timeout;
+    pool_ = make_unique<KmstoolWorkerPool>(options);
+    EXPECT_SUCCESS(pool_->Init());
+    EXPECT_SUCCESS(pool_->Run());
+  }
+
+  void TearDown() override {
+    if (pool_) {
+      EXPECT_SUCCESS(pool_->Stop());
+    }
+  }
+
+  /// Executes the request and waits for its completion.
+  ExecutionResult ExecuteAndWait(const string& request, string& response) {
+    atomic<bool> finished = false;
+    ExecutionResult result;
+    AsyncContext<string, string> context(
+        make_shared<string>(request),
+        [&](AsyncContext<string, string>& context) {
+          result = context.result;
+          if (context.response) {
+            response = *context.response;
+          }
+          finished = true;
+        });
+    auto execution_result = pool_->Execute(context);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+    WaitUntil([&]() { return finished.load(); });
+    return result;
+  }
+
+  unique_ptr<KmstoolWorkerPool> pool_;
+};
+
+TEST_F(KmstoolWorkerPoolTest, InvalidOptions) {
+  KmstoolWorkerPoolOptions options;
+  KmstoolWorkerPool pool(options);
+  EXPECT_THAT(pool.Init(),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_INVALID_KMSTOOL_WORKER_OPTIONS)));
+
+  options.worker_command = kEchoWorkerCommand;
+  options.worker_count = 0;
+  KmstoolWorkerPool pool_without_workers(options);
+  EXPECT_THAT(pool_without_workers.Init(),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_INVALID_KMSTOOL_WORKER_OPTIONS)));
+}
+
+TEST_F(KmstoolWorkerPoolTest, ExecuteBeforeRun) {
+  KmstoolWorkerPoolOptions options;
+  options.worker_command = kEchoWorkerCommand;
+  KmstoolWorkerPool pool(options);
+  EXPECT_SUCCESS(pool.Init());
+
+  AsyncContext<string, string> context(make_shared<string>("decrypt"),
+                                       [](AsyncContext<string, string>&) {});
+  EXPECT_THAT(pool.Execute(context),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING)));
+}
+
+TEST_F(KmstoolWorkerPoolTest, ReusesWorkersAcrossRequests) {
+  // Every response carries the pid of the worker, which must not change.
+  CreatePool("while read -r line; do echo \"PLAINTEXT: $$\"; done",
+             /*worker_count=*/1);
+
+  string first_response;
+  EXPECT_SUCCESS(ExecuteAndWait("decrypt --ciphertext a", first_response));
+  for (int i = 0; i < 10; ++i) {
+    string response;
+    EXPECT_SUCCESS(ExecuteAndWait("decrypt --ciphertext b", response));
+    EXPECT_EQ(response, first_response);
+  }
+}
+
+TEST_F(KmstoolWorkerPoolTest, MultiplexesConcurrentRequests) {
+  CreatePool(kEchoWorkerCommand, /*worker_count=*/3);
+
+  constexpr size_t kRequestCount = 100;
+  atomic<size_t> finished_count = 0;
+  atomic<size_t> succeeded_count = 0;
+  for (size_t i = 0; i < kRequestCount; ++i) {
+    auto ciphertext = std::to_string(i);
+    AsyncContext<string, string> context(
+        make_shared<string>("decrypt --ciphertext " + ciphertext),
+        [&, ciphertext](AsyncContext<string, string>& context) {
+          if (context.result.Successful() &&
+              *context.response == "PLAINTEXT: " + ciphertext) {
+            succeeded_count++;
+          }
+          finished_count++;
+        });
+    EXPECT_SUCCESS(pool_->Execute(context));
+  }
+
+  WaitUntil([&]() { return finished_count.load() == kRequestCount; });
+  EXPECT_EQ(succeeded_count.load(), kRequestCount);
+}
+
+TEST_F(KmstoolWorkerPoolTest, ErrorResponse) {
+  CreatePool("while read -r line; do echo 'ERROR: access denied'; done");
+
+  string response;
+  EXPECT_THAT(ExecuteAndWait("decrypt --ciphertext a", response),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_DECRYPTION_FAILED)));
+}
+
+TEST_F(KmstoolWorkerPoolTest, RestartsExitedWorker) {
+  // The worker answers a single request and exits.
+  CreatePool("read -r line; echo \"PLAINTEXT: ${line##* }\"",
+             /*worker_count=*/1);
+
+  for (int i = 0; i < 3; ++i) {
+    string response;
+    EXPECT_SUCCESS(ExecuteAndWait("decrypt --ciphertext a", response));
+    EXPECT_EQ(response, "PLAINTEXT: a");
+  }
+}
+
+TEST_F(KmstoolWorkerPoolTest, FailsWhenWorkerExitsWithoutResponse) {
+  CreatePool("read -r line; exit 1", /*worker_count=*/1);
+
+  string response;
+  EXPECT_THAT(ExecuteAndWait("decrypt --ciphertext a", response),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_FAILED)));
+}
+
+TEST_F(KmstoolWorkerPoolTest, TimesOutAndRestartsStuckWorker) {
+  // The worker hangs on the request "hang" and echoes any other one.
+  CreatePool(
+      "while read -r line; do case \"$line\" in *hang) sleep 60;; esac; "
+      "echo \"PLAINTEXT: ${line##* }\"; done",
+      /*worker_count=*/1, /*max_pending_requests=*/100,
+      /*request_timeout=*/milliseconds(200));
+
+  string response;
+  EXPECT_THAT(ExecuteAndWait("decrypt --ciphertext hang", response),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_TIMEOUT)));
+
+  EXPECT_SUCCESS(ExecuteAndWait("decrypt --ciphertext a", response));
+  EXPECT_EQ(response, "PLAINTEXT: a");
+}
+
+TEST_F(KmstoolWorkerPoolTest, RejectsRequestsBeyondQueueSize) {
+  auto pool = make_unique<KmstoolWorkerPoolWithPendingCount>(
+      "while read -r line; do sleep 60; done", /*max_pending_requests=*/2);
+  EXPECT_SUCCESS(pool->Init());
+  EXPECT_SUCCESS(pool->Run());
+
+  vector<ExecutionResult> results;
+  std::mutex results_mutex;
+  auto callback = [&](AsyncContext<string, string>& context) {
+    std::lock_guard lock(results_mutex);
+    results.push_back(context.result);
+  };
+
+  // The first request is taken by the worker and the next two are queued.
+  AsyncContext<string, string> context(make_shared<string>("decrypt"),
+                                       callback);
+  EXPECT_SUCCESS(pool->Execute(context));
+  WaitUntil([&]() { return pool->GetPendingRequestCount() == 0; });
+  EXPECT_SUCCESS(pool->Execute(context));
+  EXPECT_SUCCESS(pool->Execute(context));
+  EXPECT_THAT(pool->Execute(context),
+              ResultIs(FailureExecutionResult(
+                  SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_QUEUE_FULL)));
+
+  // Stopping fails the request in flight and the queued ones.
+  EXPECT_SUCCESS(pool->Stop());
+  EXPECT_EQ(results.size(), 3);
+  for (const auto& result : results) {
+    EXPECT_THAT(result,
+                ResultIs(FailureExecutionResult(
+                    SC_TEE_AWS_KMS_CLIENT_PROVIDER_KMSTOOL_WORKER_NOT_RUNNING)));
+  }
+}
+}  // namespace google::scp::cpio::client_providers::test
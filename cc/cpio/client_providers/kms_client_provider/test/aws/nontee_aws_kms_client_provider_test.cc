@@ -27,6 +27,7 @@
 #include <aws/kms/KMSErrors.h>
 
 #include "core/async_executor/mock/mock_async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
 #include "core/interface/async_context.h"
 #include "core/test/utils/conditional_wait.h"
 #include "core/utils/src/base64.h"
@@ -52,9 +53,14 @@ using google::cmrt::sdk::kms_service::v1::DecryptRequest;
 using google::cmrt::sdk::kms_service::v1::DecryptResponse;
 using google::scp::core::AsyncContext;
 using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncOperation;
 using google::scp::core::ExecutionStatus;
 using google::scp::core::FailureExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
 using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::common::TimeProvider;
+using google::scp::core::common::Uuid;
 using google::scp::core::test::ResultIs;
 using google::scp::core::utils::Base64Decode;
 
@@ -73,6 +79,7 @@ using google::scp::cpio::client_providers::mock::
     MockNonteeAwsKmsClientProviderWithOverrides;
 using google::scp::cpio::client_providers::mock::MockRoleCredentialsProvider;
 using std::atomic;
+using std::function;
 using std::make_shared;
 using std::make_unique;
 using std::map;
@@ -80,6 +87,9 @@ using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 using std::vector;
+using std::chrono::minutes;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
 
 static constexpr char kAssumeRoleArn[] = "assumeRoleArn";
 static constexpr char kKeyArn[] = "keyArn";
@@ -130,6 +140,38 @@ class TeeAwsKmsClientProviderTest : public ::testing::Test {
     mock_credentials_provider_ = make_shared<MockRoleCredentialsProvider>();
     client_ = make_unique<MockNonteeAwsKmsClientProviderWithOverrides>(
         mock_credentials_provider_, mock_kms_client_, mock_io_async_executor_);
+
+    // Keeps the periodic refresh of the KMS clients to run it on demand.
+    mock_io_async_executor_->schedule_for_mock =
+        [&](const AsyncOperation& work, Timestamp timestamp,
+            function<bool()>& cancellation_callback) {
+          refresh_kms_clients_ = work;
+          return SuccessExecutionResult();
+        };
+  }
+
+  void DecryptAndWait() {
+    auto kms_decrpyt_request = make_shared<DecryptRequest>();
+    kms_decrpyt_request->set_kms_region(kRegion);
+    kms_decrpyt_request->set_account_identity(kAssumeRoleArn);
+    kms_decrpyt_request->set_key_resource_name(kKeyArn);
+    kms_decrpyt_request->set_ciphertext(kCiphertext);
+    atomic<bool> condition = false;
+
+    AsyncContext<DecryptRequest, DecryptResponse> context(
+        kms_decrpyt_request,
+        [&](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+          EXPECT_SUCCESS(context.result);
+          condition = true;
+        });
+
+    EXPECT_SUCCESS(client_->Decrypt(context));
+    WaitUntil([&]() { return condition.load(); });
+  }
+
+  static Timestamp ExpiresIn(nanoseconds lifetime) {
+    return TimeProvider::GetWallTimestampInNanosecondsAsClockTicks() +
+           lifetime.count();
   }
 
   void TearDown() override { EXPECT_SUCCESS(client_->Stop()); }
@@ -138,7 +180,8 @@ class TeeAwsKmsClientProviderTest : public ::testing::Test {
   shared_ptr<MockKMSClient> mock_kms_client_;
   shared_ptr<MockAsyncExecutor> mock_io_async_executor_ =
       make_shared<MockAsyncExecutor>();
-  shared_ptr<RoleCredentialsProviderInterface> mock_credentials_provider_;
+  shared_ptr<MockRoleCredentialsProvider> mock_credentials_provider_;
+  AsyncOperation refresh_kms_clients_;
 };
 
 TEST_F(TeeAwsKmsClientProviderTest, MissingCredentialsProvider) {
@@ -279,4 +322,119 @@ TEST_F(TeeAwsKmsClientProviderTest, FailedDecryption) {
   EXPECT_SUCCESS(client_->Decrypt(context));
   WaitUntil([&]() { return condition.load(); });
 }
+
+TEST_F(TeeAwsKmsClientProviderTest, ReusesKmsClientOfSameRoleAndRegion) {
+  EXPECT_SUCCESS(client_->Init());
+  EXPECT_SUCCESS(client_->Run());
+
+  DecryptAndWait();
+  DecryptAndWait();
+  DecryptAndWait();
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 1);
+}
+
+TEST_F(TeeAwsKmsClientProviderTest, FetchesCredentialsAgainWhenExpired) {
+  EXPECT_SUCCESS(client_->Init());
+  EXPECT_SUCCESS(client_->Run());
+
+  // Within the expiration margin, so the client is never reused.
+  mock_credentials_provider_->expiration_timestamp = ExpiresIn(seconds(30));
+  DecryptAndWait();
+  DecryptAndWait();
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 2);
+}
+
+TEST_F(TeeAwsKmsClientProviderTest, RefreshesExpiringKmsClients) {
+  EXPECT_SUCCESS(client_->Init());
+  EXPECT_SUCCESS(client_->Run());
+  ASSERT_TRUE(refresh_kms_clients_);
+
+  // Within the refresh window but still usable.
+  mock_credentials_provider_->expiration_timestamp = ExpiresIn(minutes(3));
+  DecryptAndWait();
+  DecryptAndWait();
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 1);
+
+  mock_credentials_provider_->expiration_timestamp = ExpiresIn(minutes(60));
+  auto refresh_kms_clients = refresh_kms_clients_;
+  refresh_kms_clients();
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 2);
+
+  // The refreshed client is not within the refresh window anymore.
+  refresh_kms_clients = refresh_kms_clients_;
+  refresh_kms_clients();
+  DecryptAndWait();
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 2);
+}
+
+TEST_F(TeeAwsKmsClientProviderTest, DoesNotRefreshAfterStop) {
+  EXPECT_SUCCESS(client_->Init());
+  EXPECT_SUCCESS(client_->Run());
+  ASSERT_TRUE(refresh_kms_clients_);
+
+  mock_credentials_provider_->expiration_timestamp = ExpiresIn(minutes(3));
+  DecryptAndWait();
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 1);
+
+  // A refresh already running when the provider stops does nothing and is
+  // not scheduled again.
+  EXPECT_SUCCESS(client_->Stop());
+  auto refresh_kms_clients = refresh_kms_clients_;
+  refresh_kms_clients_ = nullptr;
+  refresh_kms_clients();
+  EXPECT_FALSE(refresh_kms_clients_);
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 1);
+}
+
+TEST_F(TeeAwsKmsClientProviderTest, FetchesCredentialsWithDecryptContext) {
+  EXPECT_SUCCESS(client_->Init());
+  EXPECT_SUCCESS(client_->Run());
+
+  auto kms_decrpyt_request = make_shared<DecryptRequest>();
+  kms_decrpyt_request->set_kms_region(kRegion);
+  kms_decrpyt_request->set_account_identity(kAssumeRoleArn);
+  kms_decrpyt_request->set_key_resource_name(kKeyArn);
+  kms_decrpyt_request->set_ciphertext(kCiphertext);
+  atomic<bool> condition = false;
+  AsyncContext<DecryptRequest, DecryptResponse> context(
+      kms_decrpyt_request,
+      [&](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+        EXPECT_SUCCESS(context.result);
+        condition = true;
+      },
+      Uuid::GenerateUuid(), Uuid::GenerateUuid());
+  EXPECT_SUCCESS(client_->Decrypt(context));
+  WaitUntil([&]() { return condition.load(); });
+
+  EXPECT_EQ(mock_credentials_provider_->correlation_id, context.correlation_id);
+}
+
+TEST_F(TeeAwsKmsClientProviderTest,
+       FinishesDecryptOnceIfCredentialsFetchFailsSynchronously) {
+  EXPECT_SUCCESS(client_->Init());
+  EXPECT_SUCCESS(client_->Run());
+  mock_credentials_provider_->fail_credentials_synchronously = true;
+
+  auto kms_decrpyt_request = make_shared<DecryptRequest>();
+  kms_decrpyt_request->set_kms_region(kRegion);
+  kms_decrpyt_request->set_account_identity(kAssumeRoleArn);
+  kms_decrpyt_request->set_key_resource_name(kKeyArn);
+  kms_decrpyt_request->set_ciphertext(kCiphertext);
+  atomic<size_t> callback_count = 0;
+  AsyncContext<DecryptRequest, DecryptResponse> context(
+      kms_decrpyt_request,
+      [&](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+        EXPECT_THAT(context.result,
+                    ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+        callback_count++;
+      });
+  // The failure is only reported through the callback.
+  EXPECT_SUCCESS(client_->Decrypt(context));
+  EXPECT_EQ(callback_count.load(), 1);
+
+  // The next request fetches the credentials again.
+  mock_credentials_provider_->fail_credentials_synchronously = false;
+  DecryptAndWait();
+  EXPECT_EQ(mock_credentials_provider_->get_role_credentials_count.load(), 2);
+}
 }  // namespace google::scp::cpio::client_providers::test
@@ -145,6 +145,44 @@ TEST_F(TeeAwsKmsClientProviderTest, SuccessToDecrypt) {
   WaitUntil([&]() { return condition.load(); });
 }
 
+TEST_F(TeeAwsKmsClientProviderTest, SuccessToDecryptWithKmstoolWorkers) {
+  // The fake worker answers with the ciphertext.
+  KmstoolWorkerPoolOptions kmstool_worker_pool_options;
+  kmstool_worker_pool_options.worker_command =
+      "while read -r line; do echo \"PLAINTEXT: ${line##* }\"; done";
+  kmstool_worker_pool_options.worker_count = 2;
+  auto client = make_unique<TeeAwsKmsClientProvider>(
+      mock_credentials_provider_, kmstool_worker_pool_options);
+  EXPECT_SUCCESS(client->Init());
+  EXPECT_SUCCESS(client->Run());
+
+  constexpr int kDecryptCount = 10;
+  atomic<int> finished_count = 0;
+  for (int i = 0; i < kDecryptCount; ++i) {
+    auto plaintext = "plaintext" + std::to_string(i);
+    string ciphertext;
+    EXPECT_SUCCESS(Base64Encode(plaintext, ciphertext));
+
+    auto kms_decrpyt_request = make_shared<DecryptRequest>();
+    kms_decrpyt_request->set_account_identity(kAssumeRoleArn);
+    kms_decrpyt_request->set_kms_region(kRegion);
+    kms_decrpyt_request->set_ciphertext(ciphertext);
+    AsyncContext<DecryptRequest, DecryptResponse> context(
+        kms_decrpyt_request,
+        [&, plaintext](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+          EXPECT_SUCCESS(context.result);
+          if (context.response) {
+            EXPECT_EQ(context.response->plaintext(), plaintext);
+          }
+          finished_count++;
+        });
+    EXPECT_SUCCESS(client->Decrypt(context));
+  }
+
+  WaitUntil([&]() { return finished_count.load() == kDecryptCount; });
+  EXPECT_SUCCESS(client->Stop());
+}
+
 TEST_F(TeeAwsKmsClientProviderTest, FailedToDecode) {
   EXPECT_SUCCESS(client_->Init());
   EXPECT_SUCCESS(client_->Run());
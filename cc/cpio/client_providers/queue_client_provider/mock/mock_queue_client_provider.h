@@ -44,6 +44,12 @@ class MockQueueClientProvider : public QueueClientProviderInterface {
                   cmrt::sdk::queue_service::v1::GetTopMessageResponse>&)),
               (noexcept, override));
 
+  MOCK_METHOD(core::ExecutionResult, GetTopMessages,
+              ((core::AsyncContext<
+                  cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                  cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&)),
+              (noexcept, override));
+
   MOCK_METHOD(
       core::ExecutionResult, UpdateMessageVisibilityTimeout,
       ((core::AsyncContext<
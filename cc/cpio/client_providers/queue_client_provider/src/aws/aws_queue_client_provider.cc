@@ -16,7 +16,9 @@
 
 #include "aws_queue_client_provider.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include <aws/sqs/model/ChangeMessageVisibilityRequest.h>
 #include <aws/sqs/model/DeleteMessageRequest.h>
@@ -26,6 +28,7 @@
 
 #include "aws/sqs/SQSClient.h"
 #include "core/async_executor/src/aws/aws_async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
 #include "core/common/uuid/src/uuid.h"
 #include "core/interface/async_context.h"
 #include "cpio/client_providers/instance_client_provider/src/aws/aws_instance_client_utils.h"
@@ -44,6 +47,7 @@ using Aws::SQS::Model::ChangeMessageVisibilityOutcome;
 using Aws::SQS::Model::ChangeMessageVisibilityRequest;
 using Aws::SQS::Model::DeleteMessageOutcome;
 using Aws::SQS::Model::GetQueueUrlRequest;
+using Aws::SQS::Model::Message;
 using Aws::SQS::Model::QueueAttributeName;
 using Aws::SQS::Model::ReceiveMessageOutcome;
 using Aws::SQS::Model::ReceiveMessageRequest;
@@ -55,6 +59,8 @@ using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -66,7 +72,10 @@ using google::scp::core::ExecutionResultOr;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::async_executor::aws::AwsAsyncExecutor;
+using google::scp::core::common::TimeProvider;
 using google::scp::core::common::kZeroUuid;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES;
 using google::scp::core::errors::SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE;
 using google::scp::core::errors::
     SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_RECEIPT_INFO;
@@ -81,20 +90,39 @@ using google::scp::core::errors::
 using google::scp::cpio::client_providers::AwsInstanceClientUtils;
 using google::scp::cpio::common::CreateClientConfiguration;
 using std::bind;
+using std::lock_guard;
 using std::make_shared;
+using std::max;
+using std::min;
 using std::move;
+using std::mutex;
 using std::shared_ptr;
 using std::string;
 using std::to_string;
+using std::vector;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
 using std::placeholders::_1;
 using std::placeholders::_2;
 using std::placeholders::_3;
 using std::placeholders::_4;
 
 static constexpr char kAwsQueueClientProvider[] = "AwsQueueClientProvider";
-static const uint8_t kMaxNumberOfMessagesReceived = 1;
-static const uint8_t kMaxWaitTimeSeconds = 0;
+static const uint8_t kMaxNumberOfMessagesPerReceive = 10;
+static const uint8_t kMaxWaitTimeSeconds = 20;
 static const uint16_t kMaxVisibilityTimeoutSeconds = 600;
+// Long polling calls must not time out before SQS returns.
+static const uint16_t kLongPollingRequestTimeoutMarginMs = 5000;
+
+namespace {
+GetTopMessageResponse ConvertMessage(const Message& message) {
+  GetTopMessageResponse response;
+  response.set_message_id(message.GetMessageId().c_str());
+  response.set_message_body(message.GetBody().c_str());
+  response.set_receipt_info(message.GetReceiptHandle().c_str());
+  return response;
+}
+}  // namespace
 
 namespace google::scp::cpio::client_providers {
 ExecutionResult AwsQueueClientProvider::Init() noexcept {
@@ -119,6 +147,15 @@ ExecutionResult AwsQueueClientProvider::Run() noexcept {
     return execution_result;
   }
 
+  max_messages_per_receive_ =
+      std::clamp<size_t>(queue_client_options_->max_messages_per_receive, 1,
+                         kMaxNumberOfMessagesPerReceive);
+  receive_wait_time_seconds_ = min<size_t>(
+      queue_client_options_->receive_wait_time_seconds, kMaxWaitTimeSeconds);
+  prefetched_message_visibility_timeout_seconds_ = std::clamp<size_t>(
+      queue_client_options_->prefetched_message_visibility_timeout_seconds, 1,
+      kMaxVisibilityTimeoutSeconds);
+
   auto client_config_or = CreateClientConfiguration();
   if (!client_config_or.Successful()) {
     execution_result = client_config_or.result();
@@ -154,6 +191,12 @@ AwsQueueClientProvider::CreateClientConfiguration() noexcept {
   auto client_config = common::CreateClientConfiguration(
       make_shared<string>(move(*region_code_or)));
   client_config->executor = make_shared<AwsAsyncExecutor>(io_async_executor_);
+  if (receive_wait_time_seconds_ > 0) {
+    client_config->requestTimeoutMs =
+        max<long>(client_config->requestTimeoutMs,
+                  receive_wait_time_seconds_ * 1000 +
+                      kLongPollingRequestTimeoutMarginMs);
+  }
 
   return client_config;
 }
@@ -178,6 +221,9 @@ ExecutionResultOr<string> AwsQueueClientProvider::GetQueueUrl() noexcept {
 }
 
 ExecutionResult AwsQueueClientProvider::Stop() noexcept {
+  // The dropped messages become visible again once their timeout elapses.
+  lock_guard<mutex> lock(prefetch_buffer_mutex_);
+  prefetch_buffer_.clear();
   return SuccessExecutionResult();
 }
 
@@ -235,15 +281,101 @@ void AwsQueueClientProvider::OnSendMessageCallback(
   FinishContext(execution_result, enqueue_message_context, cpu_async_executor_);
 }
 
+ReceiveMessageRequest AwsQueueClientProvider::CreateReceiveMessageRequest(
+    size_t requested_count) noexcept {
+  auto receive_count = max(requested_count, max_messages_per_receive_);
+  ReceiveMessageRequest receive_message_request;
+  receive_message_request.SetQueueUrl(queue_url_.c_str());
+  receive_message_request.SetMaxNumberOfMessages(receive_count);
+  receive_message_request.SetWaitTimeSeconds(receive_wait_time_seconds_);
+  // The requested messages keep the visibility timeout of the queue, the
+  // prefetched ones get theirs once received.
+  return receive_message_request;
+}
+
+vector<GetTopMessageResponse> AwsQueueClientProvider::TakePrefetchedMessages(
+    size_t max_count) noexcept {
+  vector<GetTopMessageResponse> messages;
+  auto now = TimeProvider::GetSteadyTimestampInNanoseconds();
+  lock_guard<mutex> lock(prefetch_buffer_mutex_);
+  while (!prefetch_buffer_.empty() && messages.size() < max_count) {
+    auto& prefetched_message = prefetch_buffer_.front();
+    if (prefetched_message.expiry_time > now) {
+      messages.push_back(move(prefetched_message.message));
+    }
+    prefetch_buffer_.pop_front();
+  }
+  return messages;
+}
+
+void AwsQueueClientProvider::BufferPrefetchedMessages(
+    const Aws::Vector<Message>& messages, size_t first_index) noexcept {
+  if (first_index >= messages.size()) {
+    return;
+  }
+
+  // Only half of the visibility timeout is used, which leaves the receiver
+  // time to process the message before others may receive it again. It
+  // starts before the timeout is changed, so the message expires early
+  // rather than late.
+  auto expiry_time =
+      TimeProvider::GetSteadyTimestampInNanoseconds() +
+      nanoseconds(seconds(prefetched_message_visibility_timeout_seconds_)) / 2;
+  for (auto i = first_index; i < messages.size(); ++i) {
+    ChangeMessageVisibilityRequest change_message_visibility_request;
+    change_message_visibility_request.SetQueueUrl(queue_url_.c_str());
+    change_message_visibility_request.SetVisibilityTimeout(
+        prefetched_message_visibility_timeout_seconds_);
+    change_message_visibility_request.SetReceiptHandle(
+        messages[i].GetReceiptHandle());
+
+    sqs_client_->ChangeMessageVisibilityAsync(
+        change_message_visibility_request,
+        bind(&AwsQueueClientProvider::OnChangePrefetchedVisibilityCallback,
+             this, ConvertMessage(messages[i]), expiry_time, _1, _2, _3, _4),
+        nullptr);
+  }
+}
+
+void AwsQueueClientProvider::OnChangePrefetchedVisibilityCallback(
+    GetTopMessageResponse& message, nanoseconds expiry_time,
+    const SQSClient* sqs_client,
+    const ChangeMessageVisibilityRequest& change_message_visibility_request,
+    ChangeMessageVisibilityOutcome change_message_visibility_outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  // A message whose timeout could not be changed is not buffered, it becomes
+  // visible to the receivers again after the timeout of the queue.
+  if (!change_message_visibility_outcome.IsSuccess()) {
+    auto error_type =
+        change_message_visibility_outcome.GetError().GetErrorType();
+    auto error_message =
+        change_message_visibility_outcome.GetError().GetMessage().c_str();
+    auto execution_result = SqsErrorConverter::ConvertSqsError(error_type);
+    SCP_ERROR(kAwsQueueClientProvider, kZeroUuid, execution_result,
+              "Failed to change visibility of the prefetched message due to "
+              "AWS SQS service error. Error code: %d, error message: %s",
+              error_type, error_message);
+    return;
+  }
+
+  lock_guard<mutex> lock(prefetch_buffer_mutex_);
+  prefetch_buffer_.push_back(PrefetchedMessage{move(message), expiry_time});
+}
+
 ExecutionResult AwsQueueClientProvider::GetTopMessage(
     AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
         get_top_message_context) noexcept {
-  ReceiveMessageRequest receive_message_request;
-  receive_message_request.SetQueueUrl(queue_url_.c_str());
-  receive_message_request.SetMaxNumberOfMessages(kMaxNumberOfMessagesReceived);
-  receive_message_request.SetWaitTimeSeconds(kMaxWaitTimeSeconds);
+  auto prefetched_messages = TakePrefetchedMessages(1);
+  if (!prefetched_messages.empty()) {
+    get_top_message_context.response =
+        make_shared<GetTopMessageResponse>(move(prefetched_messages[0]));
+    FinishContext(SuccessExecutionResult(), get_top_message_context,
+                  cpu_async_executor_);
+    return SuccessExecutionResult();
+  }
+
   sqs_client_->ReceiveMessageAsync(
-      receive_message_request,
+      CreateReceiveMessageRequest(1),
       bind(&AwsQueueClientProvider::OnReceiveMessageCallback, this,
            get_top_message_context, _1, _2, _3, _4),
       nullptr);
@@ -286,7 +418,7 @@ void AwsQueueClientProvider::OnReceiveMessageCallback(
   }
 
   // This should never happen.
-  if (messages.size() > kMaxNumberOfMessagesReceived) {
+  if (messages.size() > max_messages_per_receive_) {
     execution_result = FailureExecutionResult(
         SC_AWS_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_EXCEEDED);
     SCP_ERROR_CONTEXT(
@@ -299,14 +431,101 @@ void AwsQueueClientProvider::OnReceiveMessageCallback(
     return;
   }
 
-  const auto& message = messages[0];
-  response->set_message_id(message.GetMessageId().c_str());
-  response->set_message_body(message.GetBody().c_str());
-  response->set_receipt_info(message.GetReceiptHandle().c_str());
+  *response = ConvertMessage(messages[0]);
+  BufferPrefetchedMessages(messages, 1);
   get_top_message_context.response = move(response);
   FinishContext(execution_result, get_top_message_context, cpu_async_executor_);
 }
 
+ExecutionResult AwsQueueClientProvider::GetTopMessages(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  auto max_number_of_messages =
+      get_top_messages_context.request->max_number_of_messages();
+  if (max_number_of_messages <= 0 ||
+      max_number_of_messages > kMaxNumberOfMessagesPerReceive) {
+    auto execution_result = FailureExecutionResult(
+        SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES);
+    SCP_ERROR_CONTEXT(kAwsQueueClientProvider, get_top_messages_context,
+                      execution_result,
+                      "Failed to receive messages due to invalid maximum "
+                      "number of messages: %d",
+                      max_number_of_messages);
+    get_top_messages_context.result = execution_result;
+    get_top_messages_context.Finish();
+    return execution_result;
+  }
+
+  // Buffered messages are handed out right away, even if fewer than
+  // requested, rather than waiting for another round trip.
+  auto prefetched_messages = TakePrefetchedMessages(max_number_of_messages);
+  if (!prefetched_messages.empty()) {
+    get_top_messages_context.response = make_shared<GetTopMessagesResponse>();
+    for (auto& message : prefetched_messages) {
+      *get_top_messages_context.response->add_messages() = move(message);
+    }
+    FinishContext(SuccessExecutionResult(), get_top_messages_context,
+                  cpu_async_executor_);
+    return SuccessExecutionResult();
+  }
+
+  sqs_client_->ReceiveMessageAsync(
+      CreateReceiveMessageRequest(max_number_of_messages),
+      bind(&AwsQueueClientProvider::OnReceiveMessagesCallback, this,
+           get_top_messages_context, max_number_of_messages, _1, _2, _3, _4),
+      nullptr);
+
+  return SuccessExecutionResult();
+}
+
+void AwsQueueClientProvider::OnReceiveMessagesCallback(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context,
+    size_t requested_count, const SQSClient* sqs_client,
+    const ReceiveMessageRequest& receive_message_request,
+    ReceiveMessageOutcome receive_message_outcome,
+    const shared_ptr<const AsyncCallerContext> async_context) noexcept {
+  if (!receive_message_outcome.IsSuccess()) {
+    auto error_type = receive_message_outcome.GetError().GetErrorType();
+    auto error_message =
+        receive_message_outcome.GetError().GetMessage().c_str();
+    auto execution_result = SqsErrorConverter::ConvertSqsError(error_type);
+    SCP_ERROR_CONTEXT(
+        kAwsQueueClientProvider, get_top_messages_context, execution_result,
+        "Failed to receive messages due to AWS SQS service error. Error "
+        "code: %d, error message: %s",
+        error_type, error_message);
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  const auto& messages = receive_message_outcome.GetResult().GetMessages();
+  // This should never happen.
+  if (messages.size() > max(requested_count, max_messages_per_receive_)) {
+    auto execution_result = FailureExecutionResult(
+        SC_AWS_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_EXCEEDED);
+    SCP_ERROR_CONTEXT(
+        kAwsQueueClientProvider, get_top_messages_context, execution_result,
+        "The number of messages recevies from the queue is higher "
+        "than the maximum number. Messages count: %d",
+        messages.size());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  auto response = make_shared<GetTopMessagesResponse>();
+  auto returned_count = min(requested_count, messages.size());
+  for (size_t i = 0; i < returned_count; ++i) {
+    *response->add_messages() = ConvertMessage(messages[i]);
+  }
+  BufferPrefetchedMessages(messages, returned_count);
+  get_top_messages_context.response = move(response);
+  FinishContext(SuccessExecutionResult(), get_top_messages_context,
+                cpu_async_executor_);
+}
+
 ExecutionResult AwsQueueClientProvider::UpdateMessageVisibilityTimeout(
     AsyncContext<UpdateMessageVisibilityTimeoutRequest,
                  UpdateMessageVisibilityTimeoutResponse>&
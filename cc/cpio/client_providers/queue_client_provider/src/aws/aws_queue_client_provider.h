@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "aws/sqs/SQSClient.h"
 #include "core/interface/async_context.h"
@@ -68,6 +72,11 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept override;
 
+  core::ExecutionResult GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept override;
+
   core::ExecutionResult UpdateMessageVisibilityTimeout(
       core::AsyncContext<
           cmrt::sdk::queue_service::v1::UpdateMessageVisibilityTimeoutRequest,
@@ -117,6 +126,63 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Creates a ReceiveMessage request for the requested number of
+   * messages, which receives more to prefetch if configured so.
+   *
+   * @param requested_count The number of messages requested by the caller.
+   * @return Aws::SQS::Model::ReceiveMessageRequest the request.
+   */
+  Aws::SQS::Model::ReceiveMessageRequest CreateReceiveMessageRequest(
+      size_t requested_count) noexcept;
+
+  /**
+   * @brief Takes up to the given number of messages from the prefetch buffer,
+   * dropping the expired ones.
+   *
+   * @param max_count The maximum number of messages to take.
+   * @return std::vector<cmrt::sdk::queue_service::v1::GetTopMessageResponse>
+   * the messages, empty if none is buffered.
+   */
+  std::vector<cmrt::sdk::queue_service::v1::GetTopMessageResponse>
+  TakePrefetchedMessages(size_t max_count) noexcept;
+
+  /**
+   * @brief Sets the prefetched visibility timeout on the received messages from
+   * the given index on, and keeps them in the prefetch buffer once it is set.
+   *
+   * @param messages The received messages.
+   * @param first_index The index of the first message to keep.
+   */
+  void BufferPrefetchedMessages(
+      const Aws::Vector<Aws::SQS::Model::Message>& messages,
+      size_t first_index) noexcept;
+
+  /**
+   * @brief Is called when the visibility timeout of a prefetched message is
+   * changed, to keep the message in the prefetch buffer.
+   *
+   * @param message The prefetched message.
+   * @param expiry_time The steady time after which the message is not handed
+   * out anymore.
+   * @param sqs_client An instance of the SQS client.
+   * @param change_message_visibility_request The change message visibility
+   * request.
+   * @param change_message_visibility_outcome The change message visibility
+   * outcome of the async operation.
+   * @param async_context The Aws async context. This arg is not used.
+   */
+  void OnChangePrefetchedVisibilityCallback(
+      cmrt::sdk::queue_service::v1::GetTopMessageResponse& message,
+      std::chrono::nanoseconds expiry_time,
+      const Aws::SQS::SQSClient* sqs_client,
+      const Aws::SQS::Model::ChangeMessageVisibilityRequest&
+          change_message_visibility_request,
+      Aws::SQS::Model::ChangeMessageVisibilityOutcome
+          change_message_visibility_outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
   /**
    * @brief Is called when the object is returned from the SQS ReceiveMessage
    * callback.
@@ -138,6 +204,28 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
       const std::shared_ptr<const Aws::Client::AsyncCallerContext>
           async_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the SQS ReceiveMessage
+   * callback of GetTopMessages.
+   *
+   * @param get_top_messages_context The get top messages context object.
+   * @param requested_count The number of messages requested by the caller.
+   * @param sqs_client An instance of the SQS client.
+   * @param receive_message_request The receive message request.
+   * @param receive_message_outcome The receive message outcome of the async
+   * operation.
+   * @param async_context The Aws async context. This arg is not used.
+   */
+  void OnReceiveMessagesCallback(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context,
+      size_t requested_count, const Aws::SQS::SQSClient* sqs_client,
+      const Aws::SQS::Model::ReceiveMessageRequest& receive_message_request,
+      Aws::SQS::Model::ReceiveMessageOutcome receive_message_outcome,
+      const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+          async_context) noexcept;
+
   /**
    * @brief Is called when the object is returned from the SQS Change Message
    * Visibility callback.
@@ -203,6 +291,28 @@ class AwsQueueClientProvider : public QueueClientProviderInterface {
 
   /// An Instance of the AWS SQS client.
   std::shared_ptr<Aws::SQS::SQSClient> sqs_client_;
+
+  /// The number of messages received per ReceiveMessage call.
+  size_t max_messages_per_receive_ = 1;
+
+  /// The long polling wait time of ReceiveMessage calls.
+  size_t receive_wait_time_seconds_ = 0;
+
+  /// The visibility timeout of the messages received while prefetching.
+  size_t prefetched_message_visibility_timeout_seconds_ = 0;
+
+  /// A received message which was not requested yet.
+  struct PrefetchedMessage {
+    cmrt::sdk::queue_service::v1::GetTopMessageResponse message;
+    /// The steady time after which the message is not handed out anymore.
+    std::chrono::nanoseconds expiry_time;
+  };
+
+  /// Mutex for the prefetch buffer.
+  std::mutex prefetch_buffer_mutex_;
+
+  /// The prefetched messages, in the order they were received.
+  std::deque<PrefetchedMessage> prefetch_buffer_;
 };
 
 /// Provides AwsSqsClient.
@@ -53,6 +53,11 @@ DEFINE_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_MESSAGE_NOT_IN_FLIGHT,
                   "Cannot execute SQS operation due to the message assoicated "
                   "with the receipt info is not in flight",
                   HttpStatusCode::BAD_REQUEST)
+DEFINE_ERROR_CODE(
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES,
+    SC_AWS_QUEUE_CLIENT_PROVIDER, 0x0008,
+    "Cannot execute SQS operation due to invalid maximum number of messages",
+    HttpStatusCode::BAD_REQUEST)
 MAP_TO_PUBLIC_ERROR_CODE(
     SC_AWS_QUEUE_CLIENT_PROVIDER_QUEUE_CLIENT_OPTIONS_REQUIRED,
     SC_CPIO_INTERNAL_ERROR)
@@ -69,4 +74,7 @@ MAP_TO_PUBLIC_ERROR_CODE(
     SC_CPIO_INVALID_REQUEST)
 MAP_TO_PUBLIC_ERROR_CODE(SC_AWS_QUEUE_CLIENT_PROVIDER_MESSAGE_NOT_IN_FLIGHT,
                          SC_CPIO_INVALID_REQUEST)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES,
+    SC_CPIO_INVALID_REQUEST)
 }  // namespace google::scp::core::errors
@@ -62,6 +62,11 @@ DEFINE_ERROR_CODE(
     SC_GCP_QUEUE_CLIENT_PROVIDER, 0x0009,
     "The number of messages receiving from SQS exceed maximum number",
     HttpStatusCode::INTERNAL_SERVER_ERROR)
+DEFINE_ERROR_CODE(
+    SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES,
+    SC_GCP_QUEUE_CLIENT_PROVIDER, 0x000A,
+    "Cannot execute PubSub operation due to invalid maximum number of messages",
+    HttpStatusCode::BAD_REQUEST)
 MAP_TO_PUBLIC_ERROR_CODE(
     SC_GCP_QUEUE_CLIENT_PROVIDER_QUEUE_CLIENT_OPTIONS_REQUIRED,
     SC_CPIO_INTERNAL_ERROR)
@@ -83,4 +88,7 @@ MAP_TO_PUBLIC_ERROR_CODE(SC_GCP_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_MISMATCH,
                          SC_CPIO_INTERNAL_ERROR)
 MAP_TO_PUBLIC_ERROR_CODE(SC_GCP_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_EXCEEDED,
                          SC_CPIO_INTERNAL_ERROR)
+MAP_TO_PUBLIC_ERROR_CODE(
+    SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES,
+    SC_CPIO_CLOUD_INVALID_ARGUMENT)
 }  // namespace google::scp::core::errors
@@ -37,6 +37,8 @@ using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -60,6 +62,8 @@ using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::errors::
     SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_CONFIG_VISIBILITY_TIMEOUT;
+using google::scp::core::errors::
+    SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES;
 using google::scp::core::errors::SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MESSAGE;
 using google::scp::core::errors::
     SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_VISIBILITY_TIMEOUT;
@@ -99,6 +103,7 @@ static constexpr char kGcpTopicFormatString[] = "projects/%s/topics/%s";
 static constexpr char kGcpSubscriptionFormatString[] =
     "projects/%s/subscriptions/%s";
 static constexpr uint8_t kMaxNumberOfMessagesReceived = 1;
+static constexpr uint16_t kMaxNumberOfMessagesPerPull = 1000;
 static constexpr uint16_t kMaxAckDeadlineSeconds = 600;
 
 namespace google::scp::cpio::client_providers {
@@ -321,6 +326,96 @@ void GcpQueueClientProvider::GetTopMessageAsync(
                 cpu_async_executor_);
 }
 
+ExecutionResult GcpQueueClientProvider::GetTopMessages(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  auto max_number_of_messages =
+      get_top_messages_context.request->max_number_of_messages();
+  if (max_number_of_messages <= 0 ||
+      max_number_of_messages > kMaxNumberOfMessagesPerPull) {
+    auto execution_result = FailureExecutionResult(
+        SC_GCP_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES);
+    SCP_ERROR_CONTEXT(kGcpQueueClientProvider, get_top_messages_context,
+                      execution_result,
+                      "Failed to get top messages due to invalid maximum "
+                      "number of messages: %d",
+                      max_number_of_messages);
+    get_top_messages_context.result = execution_result;
+    get_top_messages_context.Finish();
+    return execution_result;
+  }
+
+  auto execution_result = io_async_executor_->Schedule(
+      bind(&GcpQueueClientProvider::GetTopMessagesAsync, this,
+           get_top_messages_context),
+      AsyncPriority::Normal);
+  if (!execution_result.Successful()) {
+    get_top_messages_context.result = execution_result;
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, get_top_messages_context,
+        get_top_messages_context.result,
+        "Get Top Messages request failed to be scheduled. Topic: %s",
+        topic_name_.c_str());
+    get_top_messages_context.Finish();
+    return execution_result;
+  }
+  return SuccessExecutionResult();
+}
+
+void GcpQueueClientProvider::GetTopMessagesAsync(
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+        get_top_messages_context) noexcept {
+  auto max_number_of_messages =
+      get_top_messages_context.request->max_number_of_messages();
+  PullRequest pull_request;
+  pull_request.set_subscription(subscription_name_);
+  pull_request.set_max_messages(max_number_of_messages);
+  ClientContext client_context;
+  PullResponse pull_response;
+  auto status =
+      subscriber_stub_->Pull(&client_context, pull_request, &pull_response);
+
+  if (!status.ok()) {
+    auto execution_result = GcpUtils::GcpErrorConverter(status);
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, get_top_messages_context, execution_result,
+        "Failed to get top messages due to GCP Pub/Sub service error. "
+        "Subscription: %s",
+        subscription_name_.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  const auto& received_messages = pull_response.received_messages();
+
+  // This should never happen.
+  if (received_messages.size() > max_number_of_messages) {
+    auto execution_result = FailureExecutionResult(
+        SC_GCP_QUEUE_CLIENT_PROVIDER_MESSAGES_NUMBER_EXCEEDED);
+    SCP_ERROR_CONTEXT(
+        kGcpQueueClientProvider, get_top_messages_context, execution_result,
+        "The number of messages recevied from the response is larger "
+        "than the maximum number. Subscription: %s",
+        subscription_name_.c_str());
+    FinishContext(execution_result, get_top_messages_context,
+                  cpu_async_executor_);
+    return;
+  }
+
+  auto response = make_shared<GetTopMessagesResponse>();
+  for (const auto& received_message : received_messages) {
+    auto* message = response->add_messages();
+    message->set_message_body(received_message.message().data());
+    message->set_message_id(received_message.message().message_id());
+    message->set_receipt_info(received_message.ack_id());
+  }
+  get_top_messages_context.response = move(response);
+
+  FinishContext(SuccessExecutionResult(), get_top_messages_context,
+                cpu_async_executor_);
+}
+
 ExecutionResult GcpQueueClientProvider::UpdateMessageVisibilityTimeout(
     AsyncContext<UpdateMessageVisibilityTimeoutRequest,
                  UpdateMessageVisibilityTimeoutResponse>&
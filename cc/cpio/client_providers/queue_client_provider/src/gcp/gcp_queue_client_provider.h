@@ -70,6 +70,11 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept override;
 
+  core::ExecutionResult GetTopMessages(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept override;
+
   core::ExecutionResult UpdateMessageVisibilityTimeout(
       core::AsyncContext<
           cmrt::sdk::queue_service::v1::UpdateMessageVisibilityTimeoutRequest,
@@ -102,6 +107,17 @@ class GcpQueueClientProvider : public QueueClientProviderInterface {
                          cmrt::sdk::queue_service::v1::GetTopMessageResponse>&
           get_top_message_context) noexcept;
 
+  /**
+   * @brief Is called when the object is returned from the GCP Pull callback
+   * of GetTopMessages.
+   *
+   * @param get_top_messages_context the get top messages context.
+   */
+  void GetTopMessagesAsync(
+      core::AsyncContext<cmrt::sdk::queue_service::v1::GetTopMessagesRequest,
+                         cmrt::sdk::queue_service::v1::GetTopMessagesResponse>&
+          get_top_messages_context) noexcept;
+
   /**
    * @brief Is called when the object is returned from the GCP Update Ack
    * Deadline callback.
@@ -62,6 +62,8 @@ using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -73,6 +75,8 @@ using google::scp::core::FailureExecutionResult;
 using google::scp::core::async_executor::mock::MockAsyncExecutor;
 using google::scp::core::errors::SC_AWS_INVALID_CREDENTIALS;
 using google::scp::core::errors::SC_AWS_INVALID_REQUEST;
+using google::scp::core::errors::
+    SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES;
 using google::scp::core::errors::
     SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_RECEIPT_INFO;
 using google::scp::core::errors::
@@ -98,6 +102,7 @@ using std::make_shared;
 using std::make_unique;
 using std::move;
 using std::shared_ptr;
+using std::string;
 using std::unique_ptr;
 using testing::_;
 using testing::Eq;
@@ -117,6 +122,15 @@ const uint8_t kDefaultMaxNumberOfMessagesReceived = 1;
 const uint8_t kDefaultMaxWaitTimeSeconds = 0;
 const uint16_t kVisibilityTimeoutSeconds = 10;
 const uint16_t kInvalidVisibilityTimeoutSeconds = 50000;
+
+Message CreateMessage(const string& message_id, const string& message_body,
+                      const string& receipt_handle) {
+  Message message;
+  message.SetMessageId(message_id);
+  message.SetBody(message_body);
+  message.SetReceiptHandle(receipt_handle);
+  return message;
+}
 }  // namespace
 
 namespace google::scp::cpio::client_providers::test {
@@ -502,6 +516,199 @@ MATCHER_P3(HasChangeVisibilityRequestParams, queue_url, visibility_timeout,
                             result_listener);
 }
 
+TEST_F(AwsQueueClientProviderTest, GetTopMessageServesPrefetchedMessages) {
+  queue_client_options_->max_messages_per_receive = 3;
+  queue_client_options_->receive_wait_time_seconds = 10;
+  queue_client_options_->prefetched_message_visibility_timeout_seconds =
+      kVisibilityTimeoutSeconds;
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  // Only the first call receives from SQS, the second one is served from the
+  // prefetch buffer. The requested message keeps the visibility timeout of the
+  // queue, the prefetched one gets its own.
+  EXPECT_CALL(*mock_sqs_client_,
+              ReceiveMessageAsync(
+                  HasReceiveMessageRequestParams(kQueueUrl, 3, 10), _, _))
+      .WillOnce([](const ReceiveMessageRequest& request, auto callback, auto) {
+        EXPECT_FALSE(request.VisibilityTimeoutHasBeenSet());
+        ReceiveMessageRequest receive_message_request;
+        Vector<Message> messages;
+        messages.push_back(
+            CreateMessage(kMessageId, kMessageBody, kReceiptInfo));
+        messages.push_back(CreateMessage("123", "456", "789"));
+        ReceiveMessageResult receive_message_result;
+        receive_message_result.SetMessages(messages);
+        ReceiveMessageOutcome receive_message_outcome(
+            move(receive_message_result));
+        callback(nullptr, receive_message_request,
+                 move(receive_message_outcome), nullptr);
+      });
+  EXPECT_CALL(*mock_sqs_client_,
+              ChangeMessageVisibilityAsync(
+                  HasChangeVisibilityRequestParams(
+                      kQueueUrl, kVisibilityTimeoutSeconds, "789"),
+                  _, _))
+      .WillOnce([](auto, auto callback, auto) {
+        ChangeMessageVisibilityRequest change_message_visibility_request;
+        NoResult result;
+        ChangeMessageVisibilityOutcome change_message_visibility_outcome(
+            result);
+        callback(nullptr, change_message_visibility_request,
+                 move(change_message_visibility_outcome), nullptr);
+      });
+
+  get_top_message_context_.callback =
+      [this](AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
+                 get_top_message_context) {
+        EXPECT_SUCCESS(get_top_message_context.result);
+        EXPECT_EQ(get_top_message_context.response->message_id(), kMessageId);
+        EXPECT_EQ(get_top_message_context.response->receipt_info(),
+                  kReceiptInfo);
+        finish_called_ = true;
+      };
+  EXPECT_SUCCESS(
+      queue_client_provider_->GetTopMessage(get_top_message_context_));
+  WaitUntil([this]() { return finish_called_.load(); });
+
+  finish_called_ = false;
+  get_top_message_context_.callback =
+      [this](AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
+                 get_top_message_context) {
+        EXPECT_SUCCESS(get_top_message_context.result);
+        EXPECT_EQ(get_top_message_context.response->message_id(), "123");
+        EXPECT_EQ(get_top_message_context.response->message_body(), "456");
+        EXPECT_EQ(get_top_message_context.response->receipt_info(), "789");
+        finish_called_ = true;
+      };
+  EXPECT_SUCCESS(
+      queue_client_provider_->GetTopMessage(get_top_message_context_));
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest,
+       PrefetchedMessageIsNotBufferedIfItsVisibilityIsNotChanged) {
+  queue_client_options_->max_messages_per_receive = 2;
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  // The second call receives from SQS again since nothing was buffered.
+  EXPECT_CALL(*mock_sqs_client_, ReceiveMessageAsync)
+      .Times(2)
+      .WillRepeatedly([](auto, auto callback, auto) {
+        ReceiveMessageRequest receive_message_request;
+        Vector<Message> messages;
+        messages.push_back(
+            CreateMessage(kMessageId, kMessageBody, kReceiptInfo));
+        messages.push_back(CreateMessage("123", "456", "789"));
+        ReceiveMessageResult receive_message_result;
+        receive_message_result.SetMessages(messages);
+        ReceiveMessageOutcome receive_message_outcome(
+            move(receive_message_result));
+        callback(nullptr, receive_message_request,
+                 move(receive_message_outcome), nullptr);
+      });
+  EXPECT_CALL(*mock_sqs_client_, ChangeMessageVisibilityAsync)
+      .Times(2)
+      .WillRepeatedly([](auto, auto callback, auto) {
+        ChangeMessageVisibilityRequest change_message_visibility_request;
+        AWSError<SQSErrors> sqs_error(SQSErrors::MESSAGE_NOT_INFLIGHT, false);
+        ChangeMessageVisibilityOutcome change_message_visibility_outcome(
+            sqs_error);
+        callback(nullptr, change_message_visibility_request,
+                 move(change_message_visibility_outcome), nullptr);
+      });
+
+  get_top_message_context_.callback =
+      [this](AsyncContext<GetTopMessageRequest, GetTopMessageResponse>&
+                 get_top_message_context) {
+        EXPECT_SUCCESS(get_top_message_context.result);
+        EXPECT_EQ(get_top_message_context.response->message_id(), kMessageId);
+        finish_called_ = true;
+      };
+  for (int i = 0; i < 2; ++i) {
+    finish_called_ = false;
+    EXPECT_SUCCESS(
+        queue_client_provider_->GetTopMessage(get_top_message_context_));
+    WaitUntil([this]() { return finish_called_.load(); });
+  }
+}
+
+TEST_F(AwsQueueClientProviderTest, GetTopMessagesSuccess) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_sqs_client_,
+              ReceiveMessageAsync(
+                  HasReceiveMessageRequestParams(
+                      kQueueUrl, 2, kDefaultMaxWaitTimeSeconds),
+                  _, _))
+      .WillOnce([](auto, auto callback, auto) {
+        ReceiveMessageRequest receive_message_request;
+        Vector<Message> messages;
+        messages.push_back(
+            CreateMessage(kMessageId, kMessageBody, kReceiptInfo));
+        messages.push_back(CreateMessage("123", "456", "789"));
+        ReceiveMessageResult receive_message_result;
+        receive_message_result.SetMessages(messages);
+        ReceiveMessageOutcome receive_message_outcome(
+            move(receive_message_result));
+        callback(nullptr, receive_message_request,
+                 move(receive_message_outcome), nullptr);
+      });
+
+  AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+      get_top_messages_context(
+          make_shared<GetTopMessagesRequest>(),
+          [this](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                     get_top_messages_context) {
+            EXPECT_SUCCESS(get_top_messages_context.result);
+            const auto& messages =
+                get_top_messages_context.response->messages();
+            ASSERT_EQ(messages.size(), 2);
+            EXPECT_EQ(messages[0].message_id(), kMessageId);
+            EXPECT_EQ(messages[0].receipt_info(), kReceiptInfo);
+            EXPECT_EQ(messages[1].message_id(), "123");
+            EXPECT_EQ(messages[1].receipt_info(), "789");
+            finish_called_ = true;
+          });
+  get_top_messages_context.request->set_max_number_of_messages(2);
+
+  EXPECT_SUCCESS(
+      queue_client_provider_->GetTopMessages(get_top_messages_context));
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
+TEST_F(AwsQueueClientProviderTest, GetTopMessagesWithInvalidMaxNumber) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_sqs_client_, ReceiveMessageAsync(_, _, _)).Times(0);
+
+  auto expected_result = FailureExecutionResult(
+      SC_AWS_QUEUE_CLIENT_PROVIDER_INVALID_MAX_NUMBER_OF_MESSAGES);
+  for (auto max_number_of_messages : {0, 11}) {
+    finish_called_ = false;
+    AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+        get_top_messages_context(
+            make_shared<GetTopMessagesRequest>(),
+            [this, &expected_result](
+                AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                    get_top_messages_context) {
+              EXPECT_THAT(get_top_messages_context.result,
+                          ResultIs(expected_result));
+              finish_called_ = true;
+            });
+    get_top_messages_context.request->set_max_number_of_messages(
+        max_number_of_messages);
+
+    EXPECT_THAT(
+        queue_client_provider_->GetTopMessages(get_top_messages_context),
+        ResultIs(expected_result));
+    WaitUntil([this]() { return finish_called_.load(); });
+  }
+}
+
 TEST_F(AwsQueueClientProviderTest, UpdateMessageVisibilityTimeoutSuccess) {
   EXPECT_SUCCESS(queue_client_provider_->Init());
   EXPECT_SUCCESS(queue_client_provider_->Run());
@@ -39,6 +39,8 @@ using google::cmrt::sdk::queue_service::v1::EnqueueMessageRequest;
 using google::cmrt::sdk::queue_service::v1::EnqueueMessageResponse;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageRequest;
 using google::cmrt::sdk::queue_service::v1::GetTopMessageResponse;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesRequest;
+using google::cmrt::sdk::queue_service::v1::GetTopMessagesResponse;
 using google::cmrt::sdk::queue_service::v1::
     UpdateMessageVisibilityTimeoutRequest;
 using google::cmrt::sdk::queue_service::v1::
@@ -359,6 +361,49 @@ TEST_F(GcpQueueClientProviderTest, GetTopMessageSuccess) {
   WaitUntil([this]() { return finish_called_.load(); });
 }
 
+TEST_F(GcpQueueClientProviderTest, GetTopMessagesSuccess) {
+  EXPECT_SUCCESS(queue_client_provider_->Init());
+  EXPECT_SUCCESS(queue_client_provider_->Run());
+
+  EXPECT_CALL(*mock_subscriber_stub_,
+              Pull(_, HasPullParams(kExpectedSubscriptionName, 5), _))
+      .WillOnce([](auto, auto, auto* pull_response) {
+        auto* received_message = pull_response->add_received_messages();
+        received_message->mutable_message()->set_data(kMessageBody);
+        received_message->mutable_message()->set_message_id(kMessageId);
+        received_message->set_ack_id(kReceiptInfo);
+        received_message = pull_response->add_received_messages();
+        received_message->mutable_message()->set_data("body 2");
+        received_message->mutable_message()->set_message_id("id 2");
+        received_message->set_ack_id("ack 2");
+        return Status(StatusCode::OK, "");
+      });
+
+  AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>
+      get_top_messages_context(
+          make_shared<GetTopMessagesRequest>(),
+          [this](AsyncContext<GetTopMessagesRequest, GetTopMessagesResponse>&
+                     get_top_messages_context) {
+            EXPECT_SUCCESS(get_top_messages_context.result);
+            const auto& messages =
+                get_top_messages_context.response->messages();
+            ASSERT_EQ(messages.size(), 2);
+            EXPECT_EQ(messages[0].message_id(), kMessageId);
+            EXPECT_EQ(messages[0].message_body(), kMessageBody);
+            EXPECT_EQ(messages[0].receipt_info(), kReceiptInfo);
+            EXPECT_EQ(messages[1].message_id(), "id 2");
+            EXPECT_EQ(messages[1].message_body(), "body 2");
+            EXPECT_EQ(messages[1].receipt_info(), "ack 2");
+            finish_called_ = true;
+          });
+  get_top_messages_context.request->set_max_number_of_messages(5);
+
+  EXPECT_SUCCESS(
+      queue_client_provider_->GetTopMessages(get_top_messages_context));
+
+  WaitUntil([this]() { return finish_called_.load(); });
+}
+
 TEST_F(GcpQueueClientProviderTest, GetTopMessageWithNoMessagesReturns) {
   EXPECT_SUCCESS(queue_client_provider_->Init());
   EXPECT_SUCCESS(queue_client_provider_->Run());
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -40,6 +41,11 @@ class MockRoleCredentialsProvider : public RoleCredentialsProviderInterface {
   core::ExecutionResult GetRoleCredentials(
       core::AsyncContext<GetRoleCredentialsRequest, GetRoleCredentialsResponse>&
           get_credentials_context) noexcept override {
+    get_role_credentials_count++;
+    correlation_id = get_credentials_context.correlation_id;
+    if (fail_credentials_synchronously) {
+      return core::FailureExecutionResult(SC_UNKNOWN);
+    }
     if (fail_credentials) {
       get_credentials_context.result = core::FailureExecutionResult(SC_UNKNOWN);
       get_credentials_context.Finish();
@@ -54,11 +60,18 @@ class MockRoleCredentialsProvider : public RoleCredentialsProviderInterface {
         std::make_shared<std::string>("access_key_secret");
     get_credentials_context.response->security_token =
         std::make_shared<std::string>("security_token");
+    get_credentials_context.response->expiration_timestamp =
+        expiration_timestamp;
     get_credentials_context.result = core::SuccessExecutionResult();
     get_credentials_context.Finish();
     return core::SuccessExecutionResult();
   }
 
   bool fail_credentials = false;
+  // Fails without finishing the context, as when the fetch cannot start.
+  bool fail_credentials_synchronously = false;
+  core::Timestamp expiration_timestamp = 0;
+  std::atomic<size_t> get_role_credentials_count = 0;
+  core::common::Uuid correlation_id = core::common::kZeroUuid;
 };
 }  // namespace google::scp::cpio::client_providers::mock
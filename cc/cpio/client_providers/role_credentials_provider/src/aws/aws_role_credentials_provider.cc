@@ -16,6 +16,7 @@
 
 #include "aws_role_credentials_provider.h"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
@@ -54,6 +55,9 @@ using std::make_shared;
 using std::shared_ptr;
 using std::string;
 using std::to_string;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
 using std::placeholders::_1;
 using std::placeholders::_2;
 using std::placeholders::_3;
@@ -174,6 +178,13 @@ void AwsRoleCredentialsProvider::OnGetRoleCredentialsCallback(
                               .GetCredentials()
                               .GetSessionToken()
                               .c_str());
+  get_credentials_context.response->expiration_timestamp =
+      duration_cast<nanoseconds>(
+          milliseconds(get_credentials_outcome.GetResult()
+                           .GetCredentials()
+                           .GetExpiration()
+                           .Millis()))
+          .count();
 
   get_credentials_context.Finish();
 }
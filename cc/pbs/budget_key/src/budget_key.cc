@@ -22,11 +22,14 @@
 #include <utility>
 #include <vector>
 
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/common/serialization/src/serialization.h"
 #include "core/common/uuid/src/uuid.h"
+#include "core/config_provider/src/config_provider_utils.h"
 #include "pbs/budget_key/src/proto/budget_key.pb.h"
 #include "pbs/budget_key_timeframe_manager/src/budget_key_timeframe_manager.h"
 #include "pbs/budget_key_transaction_protocols/src/consume_budget_transaction_protocol.h"
+#include "pbs/interface/configuration_keys.h"
 
 #include "error_codes.h"
 
@@ -36,6 +39,7 @@ using google::scp::core::Byte;
 using google::scp::core::BytesBuffer;
 using google::scp::core::CheckpointLog;
 using google::scp::core::ConfigProviderInterface;
+using google::scp::core::ConfigProviderUtils;
 using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::JournalLogRequest;
@@ -46,6 +50,7 @@ using google::scp::core::NoSQLDatabaseProviderInterface;
 using google::scp::core::RetryExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::Version;
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::common::Serialization;
 using google::scp::core::common::Uuid;
 using google::scp::cpio::MetricClientInterface;
@@ -64,6 +69,14 @@ static constexpr Version kCurrentVersion = {.major = 1, .minor = 0};
 static constexpr char kBudgetKey[] = "BudgetKey";
 
 namespace google::scp::pbs {
+/// Returns true if the consume budget transactions reserve tokens in the
+/// escrow mode instead of locking the timeframes.
+static bool IsEscrowReservationsEnabled(
+    const shared_ptr<ConfigProviderInterface>& config_provider) noexcept {
+  return ConfigProviderUtils::GetBoolOrDefault(
+      config_provider, kPBSBudgetKeyEscrowReservationsEnabled, false);
+}
+
 BudgetKey::BudgetKey(
     const shared_ptr<BudgetKeyName>& name, const Uuid& id,
     const shared_ptr<AsyncExecutorInterface>& async_executor,
@@ -178,7 +191,8 @@ ExecutionResult BudgetKey::OnJournalServiceRecoverCallback(
       config_provider_, budget_key_count_metric_);
   consume_budget_transaction_protocol_ =
       make_shared<ConsumeBudgetTransactionProtocol>(
-          budget_key_timeframe_manager_);
+          budget_key_timeframe_manager_,
+          IsEscrowReservationsEnabled(config_provider_));
 
   return budget_key_timeframe_manager_->Init();
 }
@@ -200,8 +214,8 @@ ExecutionResult BudgetKey::SerializeBudgetKey(
 
   // Serializing the log v1.0 object.
   size_t bytes_serialized = 0;
-  BytesBuffer budget_key_log_1_0_bytes_buffer(
-      budget_key_log_1_0.ByteSizeLong());
+  BytesBuffer budget_key_log_1_0_bytes_buffer =
+      BytesBufferPool::Allocate(budget_key_log_1_0.ByteSizeLong());
   auto execution_result =
       Serialization::SerializeProtoMessage<BudgetKeyLog_1_0>(
           budget_key_log_1_0_bytes_buffer, 0, budget_key_log_1_0,
@@ -218,7 +232,7 @@ ExecutionResult BudgetKey::SerializeBudgetKey(
   // Serializing the log object.
   bytes_serialized = 0;
   budget_key_log_bytes_buffer.bytes =
-      make_shared<vector<Byte>>(budget_key_log.ByteSizeLong());
+      BytesBufferPool::AllocateBytes(budget_key_log.ByteSizeLong());
   budget_key_log_bytes_buffer.capacity = budget_key_log.ByteSizeLong();
   execution_result = Serialization::SerializeProtoMessage<BudgetKeyLog>(
       budget_key_log_bytes_buffer, 0, budget_key_log, bytes_serialized);
@@ -305,7 +319,8 @@ void BudgetKey::OnLogLoadBudgetKeyCallback(
       config_provider_, budget_key_count_metric_);
   consume_budget_transaction_protocol_ =
       make_shared<ConsumeBudgetTransactionProtocol>(
-          budget_key_timeframe_manager_);
+          budget_key_timeframe_manager_,
+          IsEscrowReservationsEnabled(config_provider_));
 
   load_budget_key_context.result = SuccessExecutionResult();
   load_budget_key_context.Finish();
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "core/common/auto_expiry_concurrent_map/src/error_codes.h"
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/common/concurrent_map/src/error_codes.h"
 #include "core/common/serialization/src/serialization.h"
 #include "core/common/time_provider/src/time_provider.h"
@@ -51,6 +52,7 @@ using google::scp::core::JournalLogStatus;
 using google::scp::core::RetryExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::Version;
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::common::Serialization;
 using google::scp::core::common::TimeProvider;
@@ -212,8 +214,8 @@ ExecutionResult BudgetKeyProvider::SerializeBudgetKeyProviderPair(
   // Serialize the budget_key_provider_log_1_0 object.
   size_t offset = 0;
   size_t bytes_serialized = 0;
-  BytesBuffer budget_key_provider_log_1_0_bytes_buffer(
-      budget_key_provider_log_1_0.ByteSizeLong());
+  BytesBuffer budget_key_provider_log_1_0_bytes_buffer =
+      BytesBufferPool::Allocate(budget_key_provider_log_1_0.ByteSizeLong());
   auto execution_result =
       Serialization::SerializeProtoMessage<BudgetKeyProviderLog_1_0>(
           budget_key_provider_log_1_0_bytes_buffer, offset,
@@ -230,7 +232,7 @@ ExecutionResult BudgetKeyProvider::SerializeBudgetKeyProviderPair(
 
   bytes_serialized = 0;
   budget_key_provider_log_bytes_buffer.bytes =
-      make_shared<vector<Byte>>(budget_key_provider_log.ByteSizeLong());
+      BytesBufferPool::AllocateBytes(budget_key_provider_log.ByteSizeLong());
   budget_key_provider_log_bytes_buffer.capacity =
       budget_key_provider_log.ByteSizeLong();
   execution_result = Serialization::SerializeProtoMessage<BudgetKeyProviderLog>(
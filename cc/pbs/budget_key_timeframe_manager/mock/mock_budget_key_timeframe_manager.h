@@ -68,6 +68,13 @@ class MockBudgetKeyTimeframeManager
     return update_function(update_budget_key_timeframe_context);
   }
 
+  core::ExecutionResult UpdateReservation(
+      core::AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                         UpdateBudgetKeyTimeframeReservationResponse>&
+          update_reservation_context) noexcept override {
+    return update_reservation_function(update_reservation_context);
+  }
+
   const core::common::Uuid GetId() noexcept { return id; }
 
   core::ExecutionResult Checkpoint(
@@ -89,6 +96,11 @@ class MockBudgetKeyTimeframeManager
                          UpdateBudgetKeyTimeframeResponse>&)>
       update_function;
 
+  std::function<core::ExecutionResult(
+      core::AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                         UpdateBudgetKeyTimeframeReservationResponse>&)>
+      update_reservation_function;
+
   std::function<core::ExecutionResult(
       std::shared_ptr<std::list<core::CheckpointLog>>&)>
       checkpoint_mock;
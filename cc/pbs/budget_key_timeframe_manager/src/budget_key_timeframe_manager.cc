@@ -30,6 +30,7 @@
 #include "core/common/concurrent_map/src/error_codes.h"
 #include "core/common/time_provider/src/time_provider.h"
 #include "core/common/uuid/src/uuid.h"
+#include "core/config_provider/src/config_provider_utils.h"
 #include "core/interface/nosql_database_provider_interface.h"
 #include "core/nosql_database_provider/src/common/error_codes.h"
 #include "pbs/budget_key_timeframe_manager/src/proto/budget_key_timeframe_manager.pb.h"
@@ -76,6 +77,8 @@ using google::scp::pbs::budget_key_timeframe_manager::proto::
     BudgetKeyTimeframeManagerLog;
 using google::scp::pbs::budget_key_timeframe_manager::proto::
     BudgetKeyTimeframeManagerLog_1_0;
+using google::scp::pbs::budget_key_timeframe_manager::proto::
+    BudgetKeyTimeframeReservationLog_1_0;
 using google::scp::pbs::budget_key_timeframe_manager::proto::OperationType;
 using std::function;
 using std::get;
@@ -96,6 +99,14 @@ static constexpr char kBudgetKeyTimeframeManager[] =
     "BudgetKeyTimeframeManager";
 
 namespace google::scp::pbs {
+/// Returns true if the checkpoints store all the time groups as a single
+/// columnar snapshot log.
+static bool IsColumnarCheckpointsEnabled(
+    const shared_ptr<core::ConfigProviderInterface>& config_provider) noexcept {
+  return core::ConfigProviderUtils::GetBoolOrDefault(
+      config_provider, kPBSBudgetKeyColumnarCheckpointsEnabled, false);
+}
+
 ExecutionResult BudgetKeyTimeframeManager::Init() noexcept {
   auto execution_result = budget_key_timeframe_groups_->Init();
   if (!execution_result.Successful()) {
@@ -147,7 +158,8 @@ void BudgetKeyTimeframeManager::OnBeforeGarbageCollection(
       should_delete_entry(false);
       return;
     }
-    if (budget_key_timeframe->active_transaction_id.load() != kZeroUuid) {
+    if (budget_key_timeframe->active_transaction_id.load() != kZeroUuid ||
+        budget_key_timeframe->reserved_token_count.load() != 0) {
       should_delete_entry(false);
       return;
     }
@@ -226,6 +238,8 @@ void BudgetKeyTimeframeManager::OnBeforeGarbageCollection(
       make_shared<NoSQLDatabaseValidAttributeValueTypes>(serialized_tokens);
   upsert_database_item_context.request->new_attributes->push_back(
       key_value_pair);
+  // The tokens are the only attribute of the timeframe group.
+  upsert_database_item_context.request->replace_existing_attributes = true;
   budget_key_count_metric_->Increment(kMetricEventUnloadFromDBScheduled);
 
   // Request-level retry is not necessary here. If the request is unsuccessful,
@@ -834,6 +848,163 @@ void BudgetKeyTimeframeManager::OnLogUpdateCallback(
   update_budget_key_timeframe_context.Finish();
 }
 
+ExecutionResult BudgetKeyTimeframeManager::UpdateReservation(
+    AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                 UpdateBudgetKeyTimeframeReservationResponse>&
+        update_reservation_context) noexcept {
+  const auto& request = *update_reservation_context.request;
+  auto time_group = Utils::GetTimeGroup(request.reporting_time);
+  auto time_bucket = Utils::GetTimeBucket(request.reporting_time);
+
+  shared_ptr<BudgetKeyTimeframeGroup> budget_key_timeframe_group;
+  auto execution_result = budget_key_timeframe_groups_->Find(
+      time_group, budget_key_timeframe_group);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  shared_ptr<BudgetKeyTimeframe> budget_key_timeframe;
+  execution_result = budget_key_timeframe_group->budget_key_timeframes.Find(
+      time_bucket, budget_key_timeframe);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  // Only a reservation added by the caller but not journaled yet can be
+  // reserved, and only a journaled one can be consumed or released.
+  shared_ptr<BudgetKeyTimeframeReservation> reservation;
+  bool should_be_logged =
+      request.operation != BudgetKeyTimeframeReservationOperation::Reserve;
+  if (!budget_key_timeframe->reservations
+           .Find(request.transaction_id, reservation)
+           .Successful() ||
+      reservation->is_logged.load() != should_be_logged) {
+    return FailureExecutionResult(
+        core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_RESERVATION_NOT_FOUND);
+  }
+
+  OperationType operation_type = OperationType::RESERVE_TIMEFRAME_TOKENS;
+  if (request.operation == BudgetKeyTimeframeReservationOperation::Consume) {
+    operation_type = OperationType::CONSUME_TIMEFRAME_RESERVATION;
+  } else if (request.operation ==
+             BudgetKeyTimeframeReservationOperation::Release) {
+    operation_type = OperationType::RELEASE_TIMEFRAME_RESERVATION;
+  }
+
+  BytesBuffer reservation_log_bytes_buffer;
+  execution_result = Serialization::SerializeBudgetKeyTimeframeReservationLog(
+      time_group, time_bucket, operation_type, request.transaction_id,
+      reservation->token_count, reservation_log_bytes_buffer);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  execution_result = budget_key_timeframe_groups_->DisableEviction(time_group);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  AsyncContext<JournalLogRequest, JournalLogResponse> journal_log_context;
+  journal_log_context.parent_activity_id =
+      update_reservation_context.activity_id;
+  journal_log_context.correlation_id =
+      update_reservation_context.correlation_id;
+  journal_log_context.request = make_shared<JournalLogRequest>();
+  journal_log_context.request->component_id = id_;
+  journal_log_context.request->log_id = Uuid::GenerateUuid();
+  journal_log_context.request->log_status = JournalLogStatus::Log;
+  journal_log_context.request->data =
+      make_shared<BytesBuffer>(move(reservation_log_bytes_buffer));
+  journal_log_context.callback =
+      bind(&BudgetKeyTimeframeManager::OnLogUpdateReservationCallback, this,
+           update_reservation_context, budget_key_timeframe, reservation, _1);
+
+  operation_dispatcher_
+      .Dispatch<AsyncContext<JournalLogRequest, JournalLogResponse>>(
+          journal_log_context,
+          [journal_service = journal_service_](
+              AsyncContext<JournalLogRequest, JournalLogResponse>&
+                  journal_log_context) {
+            return journal_service->Log(journal_log_context);
+          });
+
+  return SuccessExecutionResult();
+}
+
+void BudgetKeyTimeframeManager::OnLogUpdateReservationCallback(
+    AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                 UpdateBudgetKeyTimeframeReservationResponse>&
+        update_reservation_context,
+    shared_ptr<BudgetKeyTimeframe>& budget_key_timeframe,
+    shared_ptr<BudgetKeyTimeframeReservation>& reservation,
+    AsyncContext<JournalLogRequest, JournalLogResponse>&
+        journal_log_context) noexcept {
+  const auto& request = *update_reservation_context.request;
+  auto time_group = Utils::GetTimeGroup(request.reporting_time);
+  auto execution_result =
+      budget_key_timeframe_groups_->EnableEviction(time_group);
+  if (!execution_result.Successful()) {
+    SCP_ERROR_CONTEXT(kBudgetKeyTimeframeManager, update_reservation_context,
+                      execution_result,
+                      "Cache eviction failed for %s time group %d",
+                      budget_key_name_->c_str(), time_group);
+  }
+
+  if (!journal_log_context.result.Successful()) {
+    update_reservation_context.result = journal_log_context.result;
+    update_reservation_context.Finish();
+    return;
+  }
+
+  // The reserved tokens are already accounted for by the caller, the
+  // reservation only needs to become durable.
+  if (request.operation == BudgetKeyTimeframeReservationOperation::Reserve) {
+    reservation->is_logged = true;
+  } else {
+    ApplyReservationOperation(*budget_key_timeframe, request.operation,
+                              request.transaction_id, reservation->token_count);
+  }
+
+  update_reservation_context.result = SuccessExecutionResult();
+  update_reservation_context.Finish();
+}
+
+ExecutionResult BudgetKeyTimeframeManager::ApplyReservationOperation(
+    BudgetKeyTimeframe& budget_key_timeframe,
+    BudgetKeyTimeframeReservationOperation operation,
+    const Uuid& transaction_id, TokenCount token_count) noexcept {
+  if (operation == BudgetKeyTimeframeReservationOperation::Reserve) {
+    auto reservation = make_shared<BudgetKeyTimeframeReservation>(token_count);
+    reservation->is_logged = true;
+    auto reservation_pair = make_pair(transaction_id, reservation);
+    auto execution_result = budget_key_timeframe.reservations.Insert(
+        reservation_pair, reservation);
+    if (!execution_result.Successful()) {
+      return execution_result.status_code ==
+                     core::errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS
+                 ? SuccessExecutionResult()
+                 : execution_result;
+    }
+    budget_key_timeframe.reserved_token_count += token_count;
+    return SuccessExecutionResult();
+  }
+
+  shared_ptr<BudgetKeyTimeframeReservation> reservation;
+  if (!budget_key_timeframe.reservations.Find(transaction_id, reservation)
+           .Successful() ||
+      !budget_key_timeframe.reservations.Erase(transaction_id).Successful()) {
+    return SuccessExecutionResult();
+  }
+
+  // The tokens are deducted before being unreserved, so that the available
+  // budget is never overestimated by concurrent reservations.
+  if (operation == BudgetKeyTimeframeReservationOperation::Consume) {
+    budget_key_timeframe.token_count -= reservation->token_count;
+  }
+  budget_key_timeframe.reserved_token_count -= reservation->token_count;
+  return SuccessExecutionResult();
+}
+
 ExecutionResult BudgetKeyTimeframeManager::OnJournalServiceRecoverCallback(
     const shared_ptr<BytesBuffer>& bytes_buffer,
     const Uuid& activity_id) noexcept {
@@ -861,14 +1032,6 @@ ExecutionResult BudgetKeyTimeframeManager::OnJournalServiceRecoverCallback(
   if (budget_key_time_frame_manager_log_1_0.operation_type() ==
       OperationType::INSERT_TIMEGROUP_INTO_CACHE) {
     TimeGroup time_group = budget_key_time_frame_manager_log_1_0.time_group();
-    execution_result = budget_key_timeframe_groups_->Erase(time_group);
-    if (!execution_result.Successful()) {
-      if (execution_result.status_code !=
-          core::errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST) {
-        return execution_result;
-      }
-    }
-
     auto budget_key_timeframe_group =
         make_shared<BudgetKeyTimeframeGroup>(time_group);
 
@@ -879,16 +1042,27 @@ ExecutionResult BudgetKeyTimeframeManager::OnJournalServiceRecoverCallback(
       return execution_result;
     }
 
-    auto budget_key_timeframe_group_pair =
-        make_pair(time_group, budget_key_timeframe_group);
-    execution_result = budget_key_timeframe_groups_->Insert(
-        budget_key_timeframe_group_pair, budget_key_timeframe_group);
+    return InsertRecoveredTimeframeGroup(budget_key_timeframe_group);
+  }
+
+  if (budget_key_time_frame_manager_log_1_0.operation_type() ==
+      OperationType::INSERT_TIMEGROUPS_SNAPSHOT_INTO_CACHE) {
+    vector<shared_ptr<BudgetKeyTimeframeGroup>> budget_key_timeframe_groups;
+    execution_result =
+        Serialization::DeserializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+            budget_key_time_frame_manager_log_1_0.log_body(),
+            budget_key_timeframe_groups);
     if (!execution_result.Successful()) {
       return execution_result;
     }
 
-    budget_key_timeframe_group->needs_loader = false;
-    budget_key_timeframe_group->is_loaded = true;
+    for (const auto& budget_key_timeframe_group : budget_key_timeframe_groups) {
+      execution_result =
+          InsertRecoveredTimeframeGroup(budget_key_timeframe_group);
+      if (!execution_result.Successful()) {
+        return execution_result;
+      }
+    }
     return SuccessExecutionResult();
   }
 
@@ -986,10 +1160,83 @@ ExecutionResult BudgetKeyTimeframeManager::OnJournalServiceRecoverCallback(
     return SuccessExecutionResult();
   }
 
+  if (budget_key_time_frame_manager_log_1_0.operation_type() ==
+          OperationType::RESERVE_TIMEFRAME_TOKENS ||
+      budget_key_time_frame_manager_log_1_0.operation_type() ==
+          OperationType::CONSUME_TIMEFRAME_RESERVATION ||
+      budget_key_time_frame_manager_log_1_0.operation_type() ==
+          OperationType::RELEASE_TIMEFRAME_RESERVATION) {
+    shared_ptr<BudgetKeyTimeframeGroup> budget_key_timeframe_group;
+    execution_result = budget_key_timeframe_groups_->Find(
+        budget_key_time_frame_manager_log_1_0.time_group(),
+        budget_key_timeframe_group);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+
+    BudgetKeyTimeframeReservationLog_1_0 reservation_log_1_0;
+    execution_result =
+        Serialization::DeserializeBudgetKeyTimeframeReservationLog_1_0(
+            budget_key_time_frame_manager_log_1_0.log_body(),
+            reservation_log_1_0);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+
+    shared_ptr<BudgetKeyTimeframe> budget_key_timeframe;
+    execution_result = budget_key_timeframe_group->budget_key_timeframes.Find(
+        reservation_log_1_0.time_bucket(), budget_key_timeframe);
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+
+    auto operation = BudgetKeyTimeframeReservationOperation::Reserve;
+    if (budget_key_time_frame_manager_log_1_0.operation_type() ==
+        OperationType::CONSUME_TIMEFRAME_RESERVATION) {
+      operation = BudgetKeyTimeframeReservationOperation::Consume;
+    } else if (budget_key_time_frame_manager_log_1_0.operation_type() ==
+               OperationType::RELEASE_TIMEFRAME_RESERVATION) {
+      operation = BudgetKeyTimeframeReservationOperation::Release;
+    }
+
+    Uuid transaction_id;
+    transaction_id.high = reservation_log_1_0.transaction_id().high();
+    transaction_id.low = reservation_log_1_0.transaction_id().low();
+    return ApplyReservationOperation(*budget_key_timeframe, operation,
+                                     transaction_id,
+                                     reservation_log_1_0.token_count());
+  }
+
   return FailureExecutionResult(
       core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_INVALID_LOG);
 }
 
+ExecutionResult BudgetKeyTimeframeManager::InsertRecoveredTimeframeGroup(
+    const shared_ptr<BudgetKeyTimeframeGroup>&
+        budget_key_timeframe_group) noexcept {
+  auto time_group = budget_key_timeframe_group->time_group;
+  auto execution_result = budget_key_timeframe_groups_->Erase(time_group);
+  if (!execution_result.Successful()) {
+    if (execution_result.status_code !=
+        core::errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST) {
+      return execution_result;
+    }
+  }
+
+  auto budget_key_timeframe_group_pair =
+      make_pair(time_group, budget_key_timeframe_group);
+  shared_ptr<BudgetKeyTimeframeGroup> inserted_budget_key_timeframe_group;
+  execution_result = budget_key_timeframe_groups_->Insert(
+      budget_key_timeframe_group_pair, inserted_budget_key_timeframe_group);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  budget_key_timeframe_group->needs_loader = false;
+  budget_key_timeframe_group->is_loaded = true;
+  return SuccessExecutionResult();
+}
+
 ExecutionResult BudgetKeyTimeframeManager::Checkpoint(
     shared_ptr<list<CheckpointLog>>& checkpoint_logs) noexcept {
   vector<TimeGroup> time_groups;
@@ -998,6 +1245,9 @@ ExecutionResult BudgetKeyTimeframeManager::Checkpoint(
     return execution_result;
   }
 
+  auto columnar_checkpoints_enabled =
+      IsColumnarCheckpointsEnabled(config_provider_);
+  vector<shared_ptr<BudgetKeyTimeframeGroup>> budget_key_timeframe_groups;
   for (auto time_group : time_groups) {
     shared_ptr<BudgetKeyTimeframeGroup> budget_key_timeframe_group;
     execution_result = budget_key_timeframe_groups_->Find(
@@ -1006,6 +1256,11 @@ ExecutionResult BudgetKeyTimeframeManager::Checkpoint(
       return execution_result;
     }
 
+    if (columnar_checkpoints_enabled) {
+      budget_key_timeframe_groups.push_back(budget_key_timeframe_group);
+      continue;
+    }
+
     CheckpointLog budget_key_timeframe_metadata_checkpoint_log;
     execution_result = Serialization::SerializeBudgetKeyTimeframeGroupLog(
         budget_key_timeframe_group,
@@ -1021,6 +1276,24 @@ ExecutionResult BudgetKeyTimeframeManager::Checkpoint(
     checkpoint_logs->push_back(
         move(budget_key_timeframe_metadata_checkpoint_log));
   }
+
+  if (budget_key_timeframe_groups.empty()) {
+    return SuccessExecutionResult();
+  }
+
+  CheckpointLog budget_key_timeframe_groups_checkpoint_log;
+  execution_result =
+      Serialization::SerializeBudgetKeyTimeframeGroupsSnapshotLog(
+          budget_key_timeframe_groups,
+          budget_key_timeframe_groups_checkpoint_log.bytes_buffer);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  budget_key_timeframe_groups_checkpoint_log.component_id = id_;
+  budget_key_timeframe_groups_checkpoint_log.log_id = Uuid::GenerateUuid();
+  budget_key_timeframe_groups_checkpoint_log.log_status = JournalLogStatus::Log;
+  checkpoint_logs->push_back(move(budget_key_timeframe_groups_checkpoint_log));
   return SuccessExecutionResult();
 }
 }  // namespace google::scp::pbs
@@ -125,6 +125,11 @@ class BudgetKeyTimeframeManager : public BudgetKeyTimeframeManagerInterface {
                          UpdateBudgetKeyTimeframeResponse>&
           update_budget_key_timeframe_context) noexcept override;
 
+  core::ExecutionResult UpdateReservation(
+      core::AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                         UpdateBudgetKeyTimeframeReservationResponse>&
+          update_reservation_context) noexcept override;
+
   const core::common::Uuid GetId() noexcept override { return id_; }
 
   core::ExecutionResult Checkpoint(
@@ -187,6 +192,17 @@ class BudgetKeyTimeframeManager : public BudgetKeyTimeframeManagerInterface {
       const std::shared_ptr<core::BytesBuffer>& bytes_buffer,
       const core::common::Uuid& activity_id) noexcept;
 
+  /**
+   * @brief Replaces the cached time group by the recovered one, which is
+   * loaded.
+   *
+   * @param budget_key_timeframe_group The recovered budget key timeframe group.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  core::ExecutionResult InsertRecoveredTimeframeGroup(
+      const std::shared_ptr<BudgetKeyTimeframeGroup>&
+          budget_key_timeframe_group) noexcept;
+
   /**
    * @brief Is called when logging on the update operation is completed.
    *
@@ -204,6 +220,42 @@ class BudgetKeyTimeframeManager : public BudgetKeyTimeframeManagerInterface {
       core::AsyncContext<core::JournalLogRequest, core::JournalLogResponse>&
           journal_log_context) noexcept;
 
+  /**
+   * @brief Is called when logging on the update reservation operation is
+   * completed.
+   *
+   * @param update_reservation_context The update reservation operation
+   * context.
+   * @param budget_key_timeframe The budget key timeframe of the reservation.
+   * @param reservation The reservation being updated.
+   * @param journal_log_context The journal log operation context.
+   */
+  virtual void OnLogUpdateReservationCallback(
+      core::AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                         UpdateBudgetKeyTimeframeReservationResponse>&
+          update_reservation_context,
+      std::shared_ptr<BudgetKeyTimeframe>& budget_key_timeframe,
+      std::shared_ptr<BudgetKeyTimeframeReservation>& reservation,
+      core::AsyncContext<core::JournalLogRequest, core::JournalLogResponse>&
+          journal_log_context) noexcept;
+
+  /**
+   * @brief Applies a journaled reservation operation to the timeframe. Is
+   * idempotent, so that replaying a log on a timeframe which already reflects
+   * it is a no-op.
+   *
+   * @param budget_key_timeframe The budget key timeframe of the reservation.
+   * @param operation The reservation operation.
+   * @param transaction_id The transaction owning the reservation.
+   * @param token_count The number of tokens reserved, only used to reserve.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  static core::ExecutionResult ApplyReservationOperation(
+      BudgetKeyTimeframe& budget_key_timeframe,
+      BudgetKeyTimeframeReservationOperation operation,
+      const core::common::Uuid& transaction_id,
+      TokenCount token_count) noexcept;
+
   /**
    * @brief Is called when logging on the load operation is completed.
    *
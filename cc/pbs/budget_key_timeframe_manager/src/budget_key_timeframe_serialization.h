@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -23,6 +24,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/common/serialization/src/serialization.h"
 #include "pbs/budget_key_timeframe_manager/src/proto/budget_key_timeframe_manager.pb.h"
 #include "pbs/interface/budget_key_timeframe_manager_interface.h"
@@ -207,6 +209,61 @@ class Serialization {
         budget_key_timeframe_group_log_bytes_buffer);
   }
 
+  /**
+   * @brief Serializes a snapshot of all the provided budget key timeframe
+   * groups into a single log.
+   *
+   * @param budget_key_timeframe_groups The budget key timeframe groups to
+   * serialize to log.
+   * @param budget_key_timeframe_groups_snapshot_log_bytes_buffer The byte
+   * buffer to write the data to.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  static core::ExecutionResult SerializeBudgetKeyTimeframeGroupsSnapshotLog(
+      const std::vector<std::shared_ptr<BudgetKeyTimeframeGroup>>&
+          budget_key_timeframe_groups,
+      core::BytesBuffer&
+          budget_key_timeframe_groups_snapshot_log_bytes_buffer) {
+    core::BytesBuffer budget_key_timeframe_groups_snapshot_log_1_0_buffer;
+    auto execution_result = SerializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+        budget_key_timeframe_groups,
+        budget_key_timeframe_groups_snapshot_log_1_0_buffer);
+    if (execution_result != core::SuccessExecutionResult()) {
+      return execution_result;
+    }
+
+    proto::BudgetKeyTimeframeManagerLog_1_0
+        budget_key_timeframe_manager_log_1_0;
+    budget_key_timeframe_manager_log_1_0.set_operation_type(
+        proto::OperationType::INSERT_TIMEGROUPS_SNAPSHOT_INTO_CACHE);
+
+    budget_key_timeframe_manager_log_1_0.set_log_body(
+        budget_key_timeframe_groups_snapshot_log_1_0_buffer.bytes->data(),
+        budget_key_timeframe_groups_snapshot_log_1_0_buffer.length);
+
+    core::BytesBuffer budget_key_timeframe_manager_log_1_0_bytes_buffer;
+    execution_result = SerializeBudgetKeyTimeframeManagerLog_1_0(
+        budget_key_timeframe_manager_log_1_0,
+        budget_key_timeframe_manager_log_1_0_bytes_buffer);
+    if (execution_result != core::SuccessExecutionResult()) {
+      return execution_result;
+    }
+
+    proto::BudgetKeyTimeframeManagerLog budget_key_timeframe_manager_log;
+    budget_key_timeframe_manager_log.mutable_version()->set_major(
+        kCurrentVersion.major);
+    budget_key_timeframe_manager_log.mutable_version()->set_minor(
+        kCurrentVersion.minor);
+
+    budget_key_timeframe_manager_log.set_log_body(
+        budget_key_timeframe_manager_log_1_0_bytes_buffer.bytes->data(),
+        budget_key_timeframe_manager_log_1_0_bytes_buffer.length);
+
+    return SerializeBudgetKeyTimeframeManagerLog(
+        budget_key_timeframe_manager_log,
+        budget_key_timeframe_groups_snapshot_log_bytes_buffer);
+  }
+
   /**
    * @brief Serializes budget key time frame group removal log.
    *
@@ -251,6 +308,90 @@ class Serialization {
         budget_key_timeframe_manager_group_removal_log_bytes_buffer);
   }
 
+  /**
+   * @brief Serializes the log of an operation on the token reservation of a
+   * transaction.
+   *
+   * @param time_group The time group associated with the timeframe.
+   * @param time_bucket The time bucket of the timeframe.
+   * @param operation_type The reservation operation, one of
+   * RESERVE_TIMEFRAME_TOKENS, CONSUME_TIMEFRAME_RESERVATION or
+   * RELEASE_TIMEFRAME_RESERVATION.
+   * @param transaction_id The transaction owning the reservation.
+   * @param token_count The number of tokens reserved.
+   * @param budget_key_timeframe_reservation_log_bytes_buffer The byte buffer to
+   * write the data to.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  static core::ExecutionResult SerializeBudgetKeyTimeframeReservationLog(
+      const TimeGroup& time_group, const TimeBucket& time_bucket,
+      proto::OperationType operation_type,
+      const core::common::Uuid& transaction_id, TokenCount token_count,
+      core::BytesBuffer& budget_key_timeframe_reservation_log_bytes_buffer) {
+    proto::BudgetKeyTimeframeReservationLog_1_0
+        budget_key_timeframe_reservation_log_1_0;
+    budget_key_timeframe_reservation_log_1_0.set_time_bucket(time_bucket);
+    budget_key_timeframe_reservation_log_1_0.mutable_transaction_id()->set_high(
+        transaction_id.high);
+    budget_key_timeframe_reservation_log_1_0.mutable_transaction_id()->set_low(
+        transaction_id.low);
+    budget_key_timeframe_reservation_log_1_0.set_token_count(token_count);
+
+    proto::BudgetKeyTimeframeManagerLog_1_0
+        budget_key_timeframe_manager_log_1_0;
+    budget_key_timeframe_manager_log_1_0.set_operation_type(operation_type);
+    budget_key_timeframe_manager_log_1_0.set_time_group(time_group);
+    budget_key_timeframe_manager_log_1_0.set_log_body(
+        budget_key_timeframe_reservation_log_1_0.SerializeAsString());
+
+    core::BytesBuffer budget_key_timeframe_manager_log_1_0_bytes_buffer;
+    auto execution_result = SerializeBudgetKeyTimeframeManagerLog_1_0(
+        budget_key_timeframe_manager_log_1_0,
+        budget_key_timeframe_manager_log_1_0_bytes_buffer);
+    if (execution_result != core::SuccessExecutionResult()) {
+      return execution_result;
+    }
+
+    proto::BudgetKeyTimeframeManagerLog budget_key_timeframe_manager_log;
+    budget_key_timeframe_manager_log.mutable_version()->set_major(
+        kCurrentVersion.major);
+    budget_key_timeframe_manager_log.mutable_version()->set_minor(
+        kCurrentVersion.minor);
+
+    budget_key_timeframe_manager_log.set_log_body(
+        budget_key_timeframe_manager_log_1_0_bytes_buffer.bytes->data(),
+        budget_key_timeframe_manager_log_1_0_bytes_buffer.length);
+
+    return SerializeBudgetKeyTimeframeManagerLog(
+        budget_key_timeframe_manager_log,
+        budget_key_timeframe_reservation_log_bytes_buffer);
+  }
+
+  /**
+   * @brief Deserializes budget key time frame reservation 1_0 object from log.
+   *
+   * @param budget_key_timeframe_reservation_log_1_0_str The buffer to read the
+   * serialized object from.
+   * @param budget_key_timeframe_reservation_log_1_0 The log object to be
+   * created from the serialized buffer.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  static core::ExecutionResult DeserializeBudgetKeyTimeframeReservationLog_1_0(
+      const std::string& budget_key_timeframe_reservation_log_1_0_str,
+      proto::BudgetKeyTimeframeReservationLog_1_0&
+          budget_key_timeframe_reservation_log_1_0) noexcept {
+    if (budget_key_timeframe_reservation_log_1_0_str.empty()) {
+      return core::FailureExecutionResult(
+          core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_INVALID_LOG);
+    }
+
+    size_t bytes_deserialized = 0;
+    return core::common::Serialization::DeserializeProtoMessage<
+        proto::BudgetKeyTimeframeReservationLog_1_0>(
+        budget_key_timeframe_reservation_log_1_0_str,
+        budget_key_timeframe_reservation_log_1_0, bytes_deserialized);
+  }
+
   /**
    * @brief Serializes budget key time frame manager removal log.
    *
@@ -268,7 +409,8 @@ class Serialization {
     size_t offset = 0;
     size_t bytes_serialized = 0;
     budget_key_timeframe_log_bytes_buffer =
-        core::BytesBuffer(budget_key_timeframe_manager_log.ByteSizeLong());
+        core::common::BytesBufferPool::Allocate(
+            budget_key_timeframe_manager_log.ByteSizeLong());
     auto execution_result = core::common::Serialization::SerializeProtoMessage<
         proto::BudgetKeyTimeframeManagerLog>(
         budget_key_timeframe_log_bytes_buffer, offset,
@@ -325,7 +467,8 @@ class Serialization {
     size_t offset = 0;
     size_t bytes_serialized = 0;
     budget_key_timeframe_manager_log_1_0_bytes_buffer =
-        core::BytesBuffer(budget_key_timeframe_manager_log_1_0.ByteSizeLong());
+        core::common::BytesBufferPool::Allocate(
+            budget_key_timeframe_manager_log_1_0.ByteSizeLong());
     auto execution_result = core::common::Serialization::SerializeProtoMessage<
         proto::BudgetKeyTimeframeManagerLog_1_0>(
         budget_key_timeframe_manager_log_1_0_bytes_buffer, offset,
@@ -385,7 +528,8 @@ class Serialization {
     size_t offset = 0;
     size_t bytes_serialized = 0;
     budget_key_timeframe_log_1_0_bytes_buffer =
-        core::BytesBuffer(budget_key_timeframe_log_1_0.ByteSizeLong());
+        core::common::BytesBufferPool::Allocate(
+            budget_key_timeframe_log_1_0.ByteSizeLong());
     auto execution_result = core::common::Serialization::SerializeProtoMessage<
         proto::BudgetKeyTimeframeLog_1_0>(
         budget_key_timeframe_log_1_0_bytes_buffer, offset,
@@ -437,7 +581,8 @@ class Serialization {
     size_t offset = 0;
     size_t bytes_serialized = 0;
     batch_budget_key_timeframe_log_1_0_bytes_buffer =
-        core::BytesBuffer(batch_budget_key_timeframe_log_1_0.ByteSizeLong());
+        core::common::BytesBufferPool::Allocate(
+            batch_budget_key_timeframe_log_1_0.ByteSizeLong());
     auto execution_result = core::common::Serialization::SerializeProtoMessage<
         proto::BatchBudgetKeyTimeframeLog_1_0>(
         batch_budget_key_timeframe_log_1_0_bytes_buffer, offset,
@@ -584,12 +729,37 @@ class Serialization {
           budget_key_timeframe->active_transaction_id.load().high);
       loaded_frame->mutable_active_transaction_id()->set_low(
           budget_key_timeframe->active_transaction_id.load().low);
+
+      // Reservations which are not journaled yet may still be rolled back.
+      std::vector<core::common::Uuid> transaction_ids;
+      execution_result =
+          budget_key_timeframe->reservations.Keys(transaction_ids);
+      if (execution_result != core::SuccessExecutionResult()) {
+        return execution_result;
+      }
+      for (const auto& transaction_id : transaction_ids) {
+        std::shared_ptr<BudgetKeyTimeframeReservation> reservation;
+        if (!budget_key_timeframe->reservations.Find(transaction_id,
+                                                     reservation)
+                 .Successful() ||
+            !reservation->is_logged.load()) {
+          continue;
+        }
+        auto reservation_log = loaded_frame->add_reservations();
+        reservation_log->set_time_bucket(
+            budget_key_timeframe->time_bucket_index);
+        reservation_log->mutable_transaction_id()->set_high(
+            transaction_id.high);
+        reservation_log->mutable_transaction_id()->set_low(transaction_id.low);
+        reservation_log->set_token_count(reservation->token_count);
+      }
     }
 
     size_t offset = 0;
     size_t bytes_serialized = 0;
     budget_key_timeframe_group_log_bytes_buffer =
-        core::BytesBuffer(budget_key_timeframe_group_log_1_0.ByteSizeLong());
+        core::common::BytesBufferPool::Allocate(
+            budget_key_timeframe_group_log_1_0.ByteSizeLong());
     execution_result = core::common::Serialization::SerializeProtoMessage<
         proto::BudgetKeyTimeframeGroupLog_1_0>(
         budget_key_timeframe_group_log_bytes_buffer, offset,
@@ -663,11 +833,433 @@ class Serialization {
 
       budget_key_timeframe->active_transaction_id = active_transaction_id;
       budget_key_timeframe->active_token_count = item.active_token_count();
+
+      for (const auto& reservation_log : item.reservations()) {
+        core::common::Uuid transaction_id;
+        transaction_id.high = reservation_log.transaction_id().high();
+        transaction_id.low = reservation_log.transaction_id().low();
+        auto reservation = std::make_shared<BudgetKeyTimeframeReservation>(
+            reservation_log.token_count());
+        reservation->is_logged = true;
+        auto reservation_pair = std::make_pair(transaction_id, reservation);
+        execution_result = budget_key_timeframe->reservations.Insert(
+            reservation_pair, reservation);
+        if (execution_result != core::SuccessExecutionResult()) {
+          return core::FailureExecutionResult(
+              core::errors::
+                  SC_BUDGET_KEY_TIMEFRAME_MANAGER_CORRUPTED_KEY_METADATA);
+        }
+        budget_key_timeframe->reserved_token_count +=
+            reservation->token_count;
+      }
     }
 
     return core::SuccessExecutionResult();
   }
 
+  /**
+   * @brief Serializes the snapshot of the budget key timeframe groups 1_0 into
+   * the provided buffer. The timeframes are stored in columns, and the time
+   * groups, the time buckets and the token counts are delta encoded and bit
+   * packed, so that a day of unchanged tokens takes a few bytes.
+   *
+   * @param budget_key_timeframe_groups The budget key timeframe groups to
+   * serialize.
+   * @param budget_key_timeframe_groups_snapshot_log_1_0_bytes_buffer The
+   * buffer to write the serialized data to.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  static core::ExecutionResult SerializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+      const std::vector<std::shared_ptr<BudgetKeyTimeframeGroup>>&
+          budget_key_timeframe_groups,
+      core::BytesBuffer&
+          budget_key_timeframe_groups_snapshot_log_1_0_bytes_buffer) noexcept {
+    if (budget_key_timeframe_groups.empty()) {
+      return core::FailureExecutionResult(
+          core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_INVALID_LOG);
+    }
+
+    auto sorted_budget_key_timeframe_groups = budget_key_timeframe_groups;
+    std::sort(sorted_budget_key_timeframe_groups.begin(),
+              sorted_budget_key_timeframe_groups.end(),
+              [](const auto& group, const auto& other_group) {
+                return group->time_group < other_group->time_group;
+              });
+
+    proto::BudgetKeyTimeframeGroupsSnapshotLog_1_0 snapshot_log_1_0;
+    std::vector<uint64_t> time_groups;
+    std::vector<uint64_t> time_buckets;
+    std::vector<uint64_t> token_counts;
+    std::string time_buckets_column;
+    std::string token_counts_column;
+    uint32_t timeframe_index = 0;
+    for (const auto& budget_key_timeframe_group :
+         sorted_budget_key_timeframe_groups) {
+      time_groups.push_back(budget_key_timeframe_group->time_group);
+
+      std::vector<TimeBucket> group_time_buckets;
+      auto execution_result =
+          budget_key_timeframe_group->budget_key_timeframes.Keys(
+              group_time_buckets);
+      if (execution_result != core::SuccessExecutionResult()) {
+        return execution_result;
+      }
+      std::sort(group_time_buckets.begin(), group_time_buckets.end());
+
+      time_buckets.clear();
+      token_counts.clear();
+      for (auto time_bucket : group_time_buckets) {
+        std::shared_ptr<BudgetKeyTimeframe> budget_key_timeframe;
+        execution_result =
+            budget_key_timeframe_group->budget_key_timeframes.Find(
+                time_bucket, budget_key_timeframe);
+        if (execution_result != core::SuccessExecutionResult()) {
+          return execution_result;
+        }
+        time_buckets.push_back(budget_key_timeframe->time_bucket_index);
+        token_counts.push_back(budget_key_timeframe->token_count.load());
+
+        auto active_transaction_id =
+            budget_key_timeframe->active_transaction_id.load();
+        auto active_token_count =
+            budget_key_timeframe->active_token_count.load();
+        if (active_transaction_id != core::common::kZeroUuid ||
+            active_token_count != 0) {
+          snapshot_log_1_0.add_active_timeframe_indices(timeframe_index);
+          snapshot_log_1_0.add_active_token_counts(active_token_count);
+          snapshot_log_1_0.add_active_transaction_id_highs(
+              active_transaction_id.high);
+          snapshot_log_1_0.add_active_transaction_id_lows(
+              active_transaction_id.low);
+        }
+
+        // Only the journaled reservations are part of the snapshot. A
+        // reservation still being journaled is erased if its log fails, so it
+        // must not survive a restart through the checkpoint. Once journaled,
+        // its reserve log is replayed from the journals instead.
+        std::vector<core::common::Uuid> transaction_ids;
+        execution_result =
+            budget_key_timeframe->reservations.Keys(transaction_ids);
+        if (execution_result != core::SuccessExecutionResult()) {
+          return execution_result;
+        }
+        for (const auto& transaction_id : transaction_ids) {
+          std::shared_ptr<BudgetKeyTimeframeReservation> reservation;
+          if (!budget_key_timeframe->reservations.Find(transaction_id,
+                                                       reservation)
+                   .Successful() ||
+              !reservation->is_logged.load()) {
+            continue;
+          }
+          snapshot_log_1_0.add_reservation_timeframe_indices(timeframe_index);
+          snapshot_log_1_0.add_reservation_token_counts(
+              reservation->token_count);
+          snapshot_log_1_0.add_reservation_transaction_id_highs(
+              transaction_id.high);
+          snapshot_log_1_0.add_reservation_transaction_id_lows(
+              transaction_id.low);
+        }
+        timeframe_index++;
+      }
+
+      snapshot_log_1_0.add_timeframe_counts(group_time_buckets.size());
+      PackDeltas(time_buckets, time_buckets_column);
+      PackDeltas(token_counts, token_counts_column);
+    }
+    PackDeltas(time_groups, *snapshot_log_1_0.mutable_time_groups());
+    snapshot_log_1_0.set_time_buckets(std::move(time_buckets_column));
+    snapshot_log_1_0.set_token_counts(std::move(token_counts_column));
+
+    size_t offset = 0;
+    size_t bytes_serialized = 0;
+    budget_key_timeframe_groups_snapshot_log_1_0_bytes_buffer =
+        core::common::BytesBufferPool::Allocate(
+            snapshot_log_1_0.ByteSizeLong());
+    auto execution_result = core::common::Serialization::SerializeProtoMessage<
+        proto::BudgetKeyTimeframeGroupsSnapshotLog_1_0>(
+        budget_key_timeframe_groups_snapshot_log_1_0_bytes_buffer, offset,
+        snapshot_log_1_0, bytes_serialized);
+    if (execution_result != core::SuccessExecutionResult()) {
+      return execution_result;
+    }
+    budget_key_timeframe_groups_snapshot_log_1_0_bytes_buffer.length =
+        bytes_serialized;
+    return core::SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Deserializes the budget key timeframe groups from the provided
+   * snapshot. All the columns are decoded before the groups are built in a
+   * single pass over the timeframes.
+   *
+   * @param budget_key_timeframe_groups_snapshot_log_str The buffer containing
+   * the serialized object.
+   * @param budget_key_timeframe_groups The time groups to be created from the
+   * serialized data, in ascending order.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  static core::ExecutionResult
+  DeserializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+      const std::string& budget_key_timeframe_groups_snapshot_log_str,
+      std::vector<std::shared_ptr<BudgetKeyTimeframeGroup>>&
+          budget_key_timeframe_groups) noexcept {
+    if (budget_key_timeframe_groups_snapshot_log_str.empty()) {
+      return core::FailureExecutionResult(
+          core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_CORRUPTED_KEY_METADATA);
+    }
+
+    proto::BudgetKeyTimeframeGroupsSnapshotLog_1_0 snapshot_log_1_0;
+    size_t bytes_deserialized = 0;
+    auto execution_result =
+        core::common::Serialization::DeserializeProtoMessage<
+            proto::BudgetKeyTimeframeGroupsSnapshotLog_1_0>(
+            budget_key_timeframe_groups_snapshot_log_str, snapshot_log_1_0,
+            bytes_deserialized);
+    if (execution_result != core::SuccessExecutionResult()) {
+      return execution_result;
+    }
+
+    auto corrupted_result = core::FailureExecutionResult(
+        core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_CORRUPTED_KEY_METADATA);
+    size_t time_group_count = snapshot_log_1_0.timeframe_counts_size();
+    std::vector<uint64_t> time_groups;
+    time_groups.reserve(time_group_count);
+    size_t time_groups_offset = 0;
+    if (time_group_count == 0 ||
+        !UnpackDeltas(snapshot_log_1_0.time_groups(), time_groups_offset,
+                      time_group_count, time_groups)
+             .Successful() ||
+        time_groups_offset != snapshot_log_1_0.time_groups().size()) {
+      return corrupted_result;
+    }
+
+    size_t timeframe_count = 0;
+    for (auto group_timeframe_count : snapshot_log_1_0.timeframe_counts()) {
+      timeframe_count += group_timeframe_count;
+    }
+    std::vector<uint64_t> time_buckets;
+    std::vector<uint64_t> token_counts;
+    time_buckets.reserve(timeframe_count);
+    token_counts.reserve(timeframe_count);
+    size_t time_buckets_offset = 0;
+    size_t token_counts_offset = 0;
+    for (auto group_timeframe_count : snapshot_log_1_0.timeframe_counts()) {
+      if (!UnpackDeltas(snapshot_log_1_0.time_buckets(), time_buckets_offset,
+                        group_timeframe_count, time_buckets)
+               .Successful() ||
+          !UnpackDeltas(snapshot_log_1_0.token_counts(), token_counts_offset,
+                        group_timeframe_count, token_counts)
+               .Successful()) {
+        return corrupted_result;
+      }
+    }
+    if (time_buckets_offset != snapshot_log_1_0.time_buckets().size() ||
+        token_counts_offset != snapshot_log_1_0.token_counts().size()) {
+      return corrupted_result;
+    }
+
+    std::vector<std::shared_ptr<BudgetKeyTimeframe>> budget_key_timeframes;
+    budget_key_timeframes.reserve(timeframe_count);
+    for (size_t i = 0; i < timeframe_count; ++i) {
+      auto budget_key_timeframe =
+          std::make_shared<BudgetKeyTimeframe>(time_buckets[i]);
+      budget_key_timeframe->token_count = token_counts[i];
+      budget_key_timeframes.push_back(budget_key_timeframe);
+    }
+
+    auto active_count = snapshot_log_1_0.active_timeframe_indices_size();
+    if (snapshot_log_1_0.active_token_counts_size() != active_count ||
+        snapshot_log_1_0.active_transaction_id_highs_size() != active_count ||
+        snapshot_log_1_0.active_transaction_id_lows_size() != active_count) {
+      return corrupted_result;
+    }
+    for (int i = 0; i < active_count; ++i) {
+      auto timeframe_index = snapshot_log_1_0.active_timeframe_indices(i);
+      if (timeframe_index >= timeframe_count) {
+        return corrupted_result;
+      }
+      auto& budget_key_timeframe = budget_key_timeframes[timeframe_index];
+      budget_key_timeframe->active_token_count =
+          snapshot_log_1_0.active_token_counts(i);
+      core::common::Uuid active_transaction_id;
+      active_transaction_id.high =
+          snapshot_log_1_0.active_transaction_id_highs(i);
+      active_transaction_id.low =
+          snapshot_log_1_0.active_transaction_id_lows(i);
+      budget_key_timeframe->active_transaction_id = active_transaction_id;
+    }
+
+    auto reservation_count =
+        snapshot_log_1_0.reservation_timeframe_indices_size();
+    if (snapshot_log_1_0.reservation_token_counts_size() != reservation_count ||
+        snapshot_log_1_0.reservation_transaction_id_highs_size() !=
+            reservation_count ||
+        snapshot_log_1_0.reservation_transaction_id_lows_size() !=
+            reservation_count) {
+      return corrupted_result;
+    }
+    for (int i = 0; i < reservation_count; ++i) {
+      auto timeframe_index = snapshot_log_1_0.reservation_timeframe_indices(i);
+      if (timeframe_index >= timeframe_count) {
+        return corrupted_result;
+      }
+      auto& budget_key_timeframe = budget_key_timeframes[timeframe_index];
+      core::common::Uuid transaction_id;
+      transaction_id.high =
+          snapshot_log_1_0.reservation_transaction_id_highs(i);
+      transaction_id.low =
+          snapshot_log_1_0.reservation_transaction_id_lows(i);
+      auto reservation = std::make_shared<BudgetKeyTimeframeReservation>(
+          snapshot_log_1_0.reservation_token_counts(i));
+      reservation->is_logged = true;
+      auto reservation_pair = std::make_pair(transaction_id, reservation);
+      execution_result = budget_key_timeframe->reservations.Insert(
+          reservation_pair, reservation);
+      if (execution_result != core::SuccessExecutionResult()) {
+        return corrupted_result;
+      }
+      budget_key_timeframe->reserved_token_count += reservation->token_count;
+    }
+
+    budget_key_timeframe_groups.reserve(time_group_count);
+    size_t timeframe_index = 0;
+    for (size_t i = 0; i < time_group_count; ++i) {
+      auto budget_key_timeframe_group =
+          std::make_shared<BudgetKeyTimeframeGroup>(time_groups[i]);
+      auto group_timeframe_count = snapshot_log_1_0.timeframe_counts(i);
+      for (uint32_t j = 0; j < group_timeframe_count; ++j) {
+        auto& budget_key_timeframe = budget_key_timeframes[timeframe_index++];
+        auto budget_key_timeframe_pair = std::make_pair(
+            budget_key_timeframe->time_bucket_index, budget_key_timeframe);
+        execution_result =
+            budget_key_timeframe_group->budget_key_timeframes.Insert(
+                budget_key_timeframe_pair, budget_key_timeframe);
+        if (execution_result != core::SuccessExecutionResult()) {
+          return corrupted_result;
+        }
+      }
+      budget_key_timeframe_groups.push_back(budget_key_timeframe_group);
+    }
+    return core::SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Appends the values to the packed buffer as the varint of the first
+   * value, followed by the bit width of the deltas and the bit-packed zigzag
+   * deltas of the other values from their previous ones:
+   * [First-Varint][Width-1B][Delta-Width-Bits]...
+   * Nothing is appended for no values.
+   *
+   * @param values The values to pack.
+   * @param packed The buffer to append the packed values to.
+   */
+  static void PackDeltas(const std::vector<uint64_t>& values,
+                         std::string& packed) noexcept {
+    if (values.empty()) {
+      return;
+    }
+
+    auto value = values[0];
+    while (value >= 0x80) {
+      packed.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    packed.push_back(static_cast<char>(value));
+
+    std::vector<uint64_t> deltas;
+    deltas.reserve(values.size() - 1);
+    uint64_t max_delta = 0;
+    for (size_t i = 1; i < values.size(); ++i) {
+      auto delta = static_cast<int64_t>(values[i] - values[i - 1]);
+      auto zigzag_delta = (static_cast<uint64_t>(delta) << 1) ^
+                          static_cast<uint64_t>(delta >> 63);
+      deltas.push_back(zigzag_delta);
+      max_delta |= zigzag_delta;
+    }
+    uint8_t width = 0;
+    while (width < 64 && (max_delta >> width) != 0) {
+      width++;
+    }
+    packed.push_back(static_cast<char>(width));
+
+    auto packed_offset = packed.size();
+    packed.resize(packed_offset + (deltas.size() * width + 7) / 8, 0);
+    size_t bit_offset = 0;
+    for (auto delta : deltas) {
+      for (uint8_t bits_written = 0; bits_written < width;) {
+        uint8_t shift = bit_offset % 8;
+        uint8_t bit_count = std::min<uint8_t>(8 - shift, width - bits_written);
+        auto bits = (delta >> bits_written) & ((1u << bit_count) - 1);
+        packed[packed_offset + bit_offset / 8] |=
+            static_cast<char>(bits << shift);
+        bits_written += bit_count;
+        bit_offset += bit_count;
+      }
+    }
+  }
+
+  /**
+   * @brief Unpacks the given count of values packed by PackDeltas at the
+   * offset, and appends them to the values.
+   *
+   * @param packed The buffer of the packed values.
+   * @param offset The offset to unpack from, which is moved past the values.
+   * @param count The count of values to unpack.
+   * @param values The vector to append the unpacked values to.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  static core::ExecutionResult UnpackDeltas(
+      const std::string& packed, size_t& offset, size_t count,
+      std::vector<uint64_t>& values) noexcept {
+    if (count == 0) {
+      return core::SuccessExecutionResult();
+    }
+
+    auto corrupted_result = core::FailureExecutionResult(
+        core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_CORRUPTED_KEY_METADATA);
+    uint64_t value = 0;
+    for (size_t shift = 0;; shift += 7) {
+      if (offset >= packed.size() || shift >= 64) {
+        return corrupted_result;
+      }
+      auto byte = static_cast<uint8_t>(packed[offset++]);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        break;
+      }
+    }
+    values.push_back(value);
+
+    if (offset >= packed.size()) {
+      return corrupted_result;
+    }
+    auto width = static_cast<uint8_t>(packed[offset++]);
+    auto packed_byte_count = ((count - 1) * width + 7) / 8;
+    if (width > 64 || packed_byte_count > packed.size() - offset) {
+      return corrupted_result;
+    }
+
+    size_t bit_offset = 0;
+    for (size_t i = 1; i < count; ++i) {
+      uint64_t zigzag_delta = 0;
+      for (uint8_t bits_read = 0; bits_read < width;) {
+        uint8_t shift = bit_offset % 8;
+        uint8_t bit_count = std::min<uint8_t>(8 - shift, width - bits_read);
+        uint64_t bits =
+            (static_cast<uint8_t>(packed[offset + bit_offset / 8]) >> shift) &
+            ((1u << bit_count) - 1);
+        zigzag_delta |= bits << bits_read;
+        bits_read += bit_count;
+        bit_offset += bit_count;
+      }
+      auto delta = (zigzag_delta >> 1) ^ (~(zigzag_delta & 1) + 1);
+      value += delta;
+      values.push_back(value);
+    }
+    offset += packed_byte_count;
+    return core::SuccessExecutionResult();
+  }
+
   /**
    * @brief Serializes 24 hours token per hour vector into string.
    *
@@ -62,4 +62,10 @@ DEFINE_ERROR_CODE(
     "The budget key timeframe manager request does not have unique time "
     "buckets",
     HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_BUDGET_KEY_TIMEFRAME_MANAGER_RESERVATION_NOT_FOUND,
+                  SC_BUDGET_KEY_TIMEFRAME_MANAGER, 0x0009,
+                  "The transaction has no token reservation in the state "
+                  "required by the operation.",
+                  HttpStatusCode::BAD_REQUEST)
 }  // namespace google::scp::core::errors
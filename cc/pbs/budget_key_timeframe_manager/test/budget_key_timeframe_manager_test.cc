@@ -3414,6 +3414,96 @@ TEST(BudgetKeyTimeframeManagerTest, Checkpoint) {
   }
 }
 
+TEST(BudgetKeyTimeframeManagerTest, CheckpointColumnarSnapshot) {
+  auto mock_journal_service = make_shared<MockJournalService>();
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  mock_config_provider->SetBool(kPBSBudgetKeyColumnarCheckpointsEnabled, true);
+  auto journal_service =
+      static_pointer_cast<JournalServiceInterface>(mock_journal_service);
+  auto mock_async_executor = make_shared<MockAsyncExecutor>();
+  auto async_executor =
+      static_pointer_cast<AsyncExecutorInterface>(mock_async_executor);
+  auto budget_key_name = make_shared<string>("budget_key_name");
+  Uuid id = Uuid::GenerateUuid();
+  auto mock_nosql_database_provider =
+      make_shared<MockNoSQLDatabaseProviderNoOverrides>();
+  shared_ptr<NoSQLDatabaseProviderInterface> nosql_database_provider =
+      static_pointer_cast<NoSQLDatabaseProviderInterface>(
+          mock_nosql_database_provider);
+
+  MockBudgetKeyTimeframeManager budget_key_timeframe_manager(
+      budget_key_name, id, async_executor, journal_service,
+      nosql_database_provider, mock_metric_client, mock_config_provider);
+
+  auto logs = make_shared<list<CheckpointLog>>();
+  EXPECT_SUCCESS(budget_key_timeframe_manager.Checkpoint(logs));
+  EXPECT_EQ(logs->size(), 0);
+
+  vector<Timestamp> reporting_times = {1660498765350482296,
+                                       1680498365350482296};
+  for (auto reporting_time : reporting_times) {
+    auto time_group = Utils::GetTimeGroup(reporting_time);
+    auto budget_key_timeframe_group =
+        make_shared<BudgetKeyTimeframeGroup>(time_group);
+    auto timeframe_group_pair =
+        make_pair(time_group, budget_key_timeframe_group);
+    budget_key_timeframe_manager.GetBudgetTimeframeGroups()->Insert(
+        timeframe_group_pair, budget_key_timeframe_group);
+
+    auto time_bucket = Utils::GetTimeBucket(reporting_time);
+    auto timeframe = make_shared<BudgetKeyTimeframe>(time_bucket);
+    timeframe->active_token_count = 1;
+    timeframe->token_count = 23;
+    timeframe->active_transaction_id = Uuid::GenerateUuid();
+    auto pair = make_pair(time_bucket, timeframe);
+    budget_key_timeframe_group->budget_key_timeframes.Insert(pair, timeframe);
+  }
+
+  // All the time groups are in a single log.
+  EXPECT_SUCCESS(budget_key_timeframe_manager.Checkpoint(logs));
+  ASSERT_EQ(logs->size(), 1);
+  EXPECT_EQ(logs->front().component_id, budget_key_timeframe_manager.GetId());
+  EXPECT_EQ(logs->front().log_status, JournalLogStatus::Log);
+
+  MockBudgetKeyTimeframeManager recovery_budget_key_timeframe_manager(
+      budget_key_name, id, async_executor, journal_service,
+      nosql_database_provider, mock_metric_client, mock_config_provider);
+  EXPECT_SUCCESS(
+      recovery_budget_key_timeframe_manager.OnJournalServiceRecoverCallback(
+          make_shared<BytesBuffer>(logs->front().bytes_buffer), kDefaultUuid));
+
+  for (auto reporting_time : reporting_times) {
+    shared_ptr<BudgetKeyTimeframeGroup> original_budget_key_timeframe_group;
+    shared_ptr<BudgetKeyTimeframeGroup> recovered_budget_key_timeframe_group;
+    EXPECT_SUCCESS(
+        budget_key_timeframe_manager.GetBudgetTimeframeGroups()->Find(
+            Utils::GetTimeGroup(reporting_time),
+            original_budget_key_timeframe_group));
+    EXPECT_SUCCESS(
+        recovery_budget_key_timeframe_manager.GetBudgetTimeframeGroups()->Find(
+            Utils::GetTimeGroup(reporting_time),
+            recovered_budget_key_timeframe_group));
+    EXPECT_TRUE(recovered_budget_key_timeframe_group->is_loaded.load());
+    EXPECT_FALSE(recovered_budget_key_timeframe_group->needs_loader.load());
+
+    shared_ptr<BudgetKeyTimeframe> original_budget_key_timeframe;
+    shared_ptr<BudgetKeyTimeframe> recovered_budget_key_timeframe;
+    EXPECT_SUCCESS(original_budget_key_timeframe_group->budget_key_timeframes
+                       .Find(Utils::GetTimeBucket(reporting_time),
+                             original_budget_key_timeframe));
+    EXPECT_SUCCESS(recovered_budget_key_timeframe_group->budget_key_timeframes
+                       .Find(Utils::GetTimeBucket(reporting_time),
+                             recovered_budget_key_timeframe));
+    EXPECT_EQ(recovered_budget_key_timeframe->token_count.load(),
+              original_budget_key_timeframe->token_count.load());
+    EXPECT_EQ(recovered_budget_key_timeframe->active_token_count.load(),
+              original_budget_key_timeframe->active_token_count.load());
+    EXPECT_EQ(recovered_budget_key_timeframe->active_transaction_id.load(),
+              original_budget_key_timeframe->active_transaction_id.load());
+  }
+}
+
 TEST(BudgetKeyTimeframeManagerTest, CanUnload) {
   auto mock_journal_service = make_shared<MockJournalService>();
   auto mock_metric_client = make_shared<MockMetricClient>();
@@ -3569,4 +3659,184 @@ TEST(BudgetKeyTimeframeManagerTest, PopulateLoadBudgetKeyTimeframeResponse) {
     EXPECT_EQ(response->budget_key_frames[1], budget_key_timeframe1);
   }
 }
+
+TEST(BudgetKeyTimeframeManagerTest, UpdateReservationJournalsAndApplies) {
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  auto mock_journal_service = make_shared<MockJournalService>();
+  auto journal_service =
+      static_pointer_cast<JournalServiceInterface>(mock_journal_service);
+  auto mock_async_executor = make_shared<MockAsyncExecutor>();
+  auto async_executor =
+      static_pointer_cast<AsyncExecutorInterface>(mock_async_executor);
+  auto budget_key_name = make_shared<string>("budget_key_name");
+  Uuid id = Uuid::GenerateUuid();
+  shared_ptr<NoSQLDatabaseProviderInterface> nosql_database_provider =
+      make_shared<MockNoSQLDatabaseProvider>();
+  MockBudgetKeyTimeframeManager budget_key_timeframe_manager(
+      budget_key_name, id, async_executor, journal_service,
+      nosql_database_provider, mock_metric_client, mock_config_provider);
+
+  vector<OperationType> logged_operation_types;
+  mock_journal_service->log_mock =
+      [&](AsyncContext<JournalLogRequest, JournalLogResponse>&
+              journal_log_context) {
+        BudgetKeyTimeframeManagerLog budget_key_time_frame_manager_log;
+        EXPECT_SUCCESS(budget_key_timeframe_manager::Serialization::
+                           DeserializeBudgetKeyTimeframeManagerLog(
+                               *journal_log_context.request->data,
+                               budget_key_time_frame_manager_log));
+        BudgetKeyTimeframeManagerLog_1_0 budget_key_time_frame_manager_log_1_0;
+        EXPECT_SUCCESS(budget_key_timeframe_manager::Serialization::
+                           DeserializeBudgetKeyTimeframeManagerLog_1_0(
+                               budget_key_time_frame_manager_log.log_body(),
+                               budget_key_time_frame_manager_log_1_0));
+        logged_operation_types.push_back(
+            budget_key_time_frame_manager_log_1_0.operation_type());
+        journal_log_context.result = SuccessExecutionResult();
+        journal_log_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  Timestamp reporting_time = 1000;
+  auto time_group = Utils::GetTimeGroup(reporting_time);
+  auto time_bucket = Utils::GetTimeBucket(reporting_time);
+  auto budget_key_timeframe_group_pair =
+      make_pair(time_group, make_shared<BudgetKeyTimeframeGroup>(time_group));
+  shared_ptr<BudgetKeyTimeframeGroup> budget_key_timeframe_group;
+  budget_key_timeframe_manager.GetBudgetTimeframeGroups()->Insert(
+      budget_key_timeframe_group_pair, budget_key_timeframe_group);
+  auto budget_key_timeframe = make_shared<BudgetKeyTimeframe>(time_bucket);
+  budget_key_timeframe->token_count = 10;
+  auto budget_key_timeframe_pair = make_pair(time_bucket, budget_key_timeframe);
+  budget_key_timeframe_group->budget_key_timeframes.Insert(
+      budget_key_timeframe_pair, budget_key_timeframe);
+
+  ExecutionResult update_result;
+  AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+               UpdateBudgetKeyTimeframeReservationResponse>
+      update_reservation_context(
+          make_shared<UpdateBudgetKeyTimeframeReservationRequest>(),
+          [&](auto& update_reservation_context) {
+            update_result = update_reservation_context.result;
+          });
+  update_reservation_context.request->reporting_time = reporting_time;
+  update_reservation_context.request->transaction_id = {1, 2};
+
+  // The caller must add the reservation before it is reserved.
+  EXPECT_THAT(
+      budget_key_timeframe_manager.UpdateReservation(
+          update_reservation_context),
+      ResultIs(FailureExecutionResult(
+          core::errors::
+              SC_BUDGET_KEY_TIMEFRAME_MANAGER_RESERVATION_NOT_FOUND)));
+
+  auto reservation = make_shared<BudgetKeyTimeframeReservation>(3);
+  auto reservation_pair = make_pair(Uuid{1, 2}, reservation);
+  budget_key_timeframe->reservations.Insert(reservation_pair, reservation);
+  budget_key_timeframe->reserved_token_count = 3;
+
+  EXPECT_SUCCESS(budget_key_timeframe_manager.UpdateReservation(
+      update_reservation_context));
+  EXPECT_SUCCESS(update_result);
+  EXPECT_TRUE(reservation->is_logged.load());
+  EXPECT_EQ(budget_key_timeframe->token_count.load(), 10);
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 3);
+
+  update_reservation_context.request->operation =
+      BudgetKeyTimeframeReservationOperation::Consume;
+  EXPECT_SUCCESS(budget_key_timeframe_manager.UpdateReservation(
+      update_reservation_context));
+  EXPECT_SUCCESS(update_result);
+  EXPECT_EQ(budget_key_timeframe->token_count.load(), 7);
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 0);
+  EXPECT_THAT(budget_key_timeframe->reservations.Find({1, 2}, reservation),
+              ResultIs(FailureExecutionResult(
+                  core::errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+
+  // Once consumed, the reservation can no longer be released.
+  update_reservation_context.request->operation =
+      BudgetKeyTimeframeReservationOperation::Release;
+  EXPECT_THAT(
+      budget_key_timeframe_manager.UpdateReservation(
+          update_reservation_context),
+      ResultIs(FailureExecutionResult(
+          core::errors::
+              SC_BUDGET_KEY_TIMEFRAME_MANAGER_RESERVATION_NOT_FOUND)));
+
+  EXPECT_EQ(logged_operation_types,
+            vector<OperationType>(
+                {OperationType::RESERVE_TIMEFRAME_TOKENS,
+                 OperationType::CONSUME_TIMEFRAME_RESERVATION}));
+}
+
+TEST(BudgetKeyTimeframeManagerTest,
+     OnJournalServiceRecoverCallbackReservationLogs) {
+  auto mock_journal_service = make_shared<MockJournalService>();
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  auto journal_service =
+      static_pointer_cast<JournalServiceInterface>(mock_journal_service);
+  auto mock_async_executor = make_shared<MockAsyncExecutor>();
+  auto async_executor =
+      static_pointer_cast<AsyncExecutorInterface>(mock_async_executor);
+  auto budget_key_name = make_shared<string>("budget_key_name");
+  Uuid id = Uuid::GenerateUuid();
+  shared_ptr<NoSQLDatabaseProviderInterface> nosql_database_provider =
+      make_shared<MockNoSQLDatabaseProvider>();
+  MockBudgetKeyTimeframeManager budget_key_timeframe_manager(
+      budget_key_name, id, async_executor, journal_service,
+      nosql_database_provider, mock_metric_client, mock_config_provider);
+
+  TimeGroup time_group = 1234;
+  TimeBucket time_bucket = 5;
+  auto budget_key_timeframe_group_pair =
+      make_pair(time_group, make_shared<BudgetKeyTimeframeGroup>(time_group));
+  shared_ptr<BudgetKeyTimeframeGroup> budget_key_timeframe_group;
+  budget_key_timeframe_manager.GetBudgetTimeframeGroups()->Insert(
+      budget_key_timeframe_group_pair, budget_key_timeframe_group);
+  auto budget_key_timeframe = make_shared<BudgetKeyTimeframe>(time_bucket);
+  budget_key_timeframe->token_count = 10;
+  auto budget_key_timeframe_pair = make_pair(time_bucket, budget_key_timeframe);
+  budget_key_timeframe_group->budget_key_timeframes.Insert(
+      budget_key_timeframe_pair, budget_key_timeframe);
+
+  auto serialize_log = [&](OperationType operation_type,
+                           const Uuid& transaction_id, TokenCount token_count) {
+    auto bytes_buffer = make_shared<BytesBuffer>();
+    EXPECT_SUCCESS(budget_key_timeframe_manager::Serialization::
+                       SerializeBudgetKeyTimeframeReservationLog(
+                           time_group, time_bucket, operation_type,
+                           transaction_id, token_count, *bytes_buffer));
+    return bytes_buffer;
+  };
+
+  // Replaying a log twice applies it once.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_SUCCESS(budget_key_timeframe_manager.OnJournalServiceRecoverCallback(
+        serialize_log(OperationType::RESERVE_TIMEFRAME_TOKENS, {1, 1}, 2),
+        kDefaultUuid));
+    EXPECT_SUCCESS(budget_key_timeframe_manager.OnJournalServiceRecoverCallback(
+        serialize_log(OperationType::RESERVE_TIMEFRAME_TOKENS, {1, 2}, 3),
+        kDefaultUuid));
+  }
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 5);
+  shared_ptr<BudgetKeyTimeframeReservation> reservation;
+  EXPECT_SUCCESS(budget_key_timeframe->reservations.Find({1, 1}, reservation));
+  EXPECT_TRUE(reservation->is_logged.load());
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_SUCCESS(budget_key_timeframe_manager.OnJournalServiceRecoverCallback(
+        serialize_log(OperationType::CONSUME_TIMEFRAME_RESERVATION, {1, 1}, 2),
+        kDefaultUuid));
+    EXPECT_SUCCESS(budget_key_timeframe_manager.OnJournalServiceRecoverCallback(
+        serialize_log(OperationType::RELEASE_TIMEFRAME_RESERVATION, {1, 2}, 3),
+        kDefaultUuid));
+  }
+  EXPECT_EQ(budget_key_timeframe->token_count.load(), 8);
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 0);
+  vector<Uuid> transaction_ids;
+  budget_key_timeframe->reservations.Keys(transaction_ids);
+  EXPECT_TRUE(transaction_ids.empty());
+}
 }  // namespace google::scp::pbs::test
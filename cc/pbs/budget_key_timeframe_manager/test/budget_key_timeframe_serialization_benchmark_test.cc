@@ -0,0 +1,130 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/uuid/src/uuid.h"
+#include "pbs/budget_key_timeframe_manager/src/budget_key_timeframe_serialization.h"
+#include "pbs/budget_key_timeframe_manager/src/proto/budget_key_timeframe_manager.pb.h"
+
+namespace google::scp::pbs::test {
+
+using ::google::scp::core::BytesBuffer;
+using ::google::scp::core::common::Uuid;
+using ::google::scp::pbs::budget_key_timeframe_manager::kHoursPerDay;
+using ::google::scp::pbs::budget_key_timeframe_manager::Serialization;
+using ::google::scp::pbs::budget_key_timeframe_manager::proto::
+    BudgetKeyTimeframeManagerLog;
+using ::google::scp::pbs::budget_key_timeframe_manager::proto::
+    BudgetKeyTimeframeManagerLog_1_0;
+
+static constexpr TimeGroup kTimeGroup = 1234;
+
+static std::vector<std::shared_ptr<BudgetKeyTimeframe>> CreateTimeframes(
+    size_t count) {
+  std::vector<std::shared_ptr<BudgetKeyTimeframe>> budget_key_timeframes;
+  for (size_t i = 0; i < count; i++) {
+    auto budget_key_timeframe = std::make_shared<BudgetKeyTimeframe>(i);
+    budget_key_timeframe->token_count = 13;
+    budget_key_timeframe->active_token_count = 1;
+    budget_key_timeframe->active_transaction_id = Uuid::GenerateUuid();
+    budget_key_timeframes.push_back(budget_key_timeframe);
+  }
+  return budget_key_timeframes;
+}
+
+/// Serializes the log of a batch update. The argument is the number of
+/// timeframes in the batch.
+static void BM_SerializeBatchTimeframeLog(benchmark::State& state) {
+  auto budget_key_timeframes = CreateTimeframes(state.range(0));
+  for (auto _ : state) {
+    BytesBuffer bytes_buffer;
+    if (!Serialization::SerializeBatchBudgetKeyTimeframeLog(
+             kTimeGroup, budget_key_timeframes, bytes_buffer)
+             .Successful()) {
+      state.SkipWithError("Cannot serialize the batch log.");
+      break;
+    }
+    benchmark::DoNotOptimize(bytes_buffer.bytes->data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SerializeBatchTimeframeLog)->RangeMultiplier(4)->Range(1, 256);
+
+/// Deserializes the log of a batch update down to the timeframes, the way
+/// recovery does. The argument is the number of timeframes in the batch.
+static void BM_DeserializeBatchTimeframeLog(benchmark::State& state) {
+  BytesBuffer bytes_buffer;
+  Serialization::SerializeBatchBudgetKeyTimeframeLog(
+      kTimeGroup, CreateTimeframes(state.range(0)), bytes_buffer);
+
+  for (auto _ : state) {
+    BudgetKeyTimeframeManagerLog log;
+    BudgetKeyTimeframeManagerLog_1_0 log_1_0;
+    std::vector<std::shared_ptr<BudgetKeyTimeframe>> budget_key_timeframes;
+    if (!Serialization::DeserializeBudgetKeyTimeframeManagerLog(bytes_buffer,
+                                                                log)
+             .Successful() ||
+        !Serialization::DeserializeBudgetKeyTimeframeManagerLog_1_0(
+             log.log_body(), log_1_0)
+             .Successful() ||
+        !Serialization::DeserializeBatchBudgetKeyTimeframeLog_1_0(
+             log_1_0.log_body(), budget_key_timeframes)
+             .Successful()) {
+      state.SkipWithError("Cannot deserialize the batch log.");
+      break;
+    }
+    benchmark::DoNotOptimize(budget_key_timeframes);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_DeserializeBatchTimeframeLog)->RangeMultiplier(4)->Range(1, 256);
+
+/// Serializes the log of a full day of timeframes, as written when a budget
+/// key timeframe group is checkpointed.
+static void BM_SerializeTimeframeGroupLog(benchmark::State& state) {
+  auto budget_key_timeframe_group =
+      std::make_shared<BudgetKeyTimeframeGroup>(kTimeGroup);
+  for (auto& budget_key_timeframe : CreateTimeframes(kHoursPerDay)) {
+    budget_key_timeframe_group->budget_key_timeframes.Insert(
+        std::make_pair(budget_key_timeframe->time_bucket_index,
+                       budget_key_timeframe),
+        budget_key_timeframe);
+  }
+
+  for (auto _ : state) {
+    BytesBuffer bytes_buffer;
+    if (!Serialization::SerializeBudgetKeyTimeframeGroupLog(
+             budget_key_timeframe_group, bytes_buffer)
+             .Successful()) {
+      state.SkipWithError("Cannot serialize the group log.");
+      break;
+    }
+    benchmark::DoNotOptimize(bytes_buffer.bytes->data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SerializeTimeframeGroupLog);
+
+}  // namespace google::scp::pbs::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
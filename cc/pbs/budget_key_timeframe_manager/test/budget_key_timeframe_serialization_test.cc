@@ -33,6 +33,7 @@
 #include "pbs/budget_key_timeframe_manager/src/budget_key_timeframe_utils.h"
 #include "pbs/budget_key_timeframe_manager/src/error_codes.h"
 #include "pbs/budget_key_timeframe_manager/src/proto/budget_key_timeframe_manager.pb.h"
+#include "public/core/test/interface/execution_result_matchers.h"
 
 using google::scp::core::BytesBuffer;
 using google::scp::core::ExecutionResult;
@@ -41,11 +42,15 @@ using google::scp::core::RetryExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::Timestamp;
 using google::scp::core::common::Uuid;
+using google::scp::core::test::ResultIs;
 using google::scp::pbs::BudgetKeyTimeframeManager;
+using google::scp::pbs::budget_key_timeframe_manager::kHoursPerDay;
 using google::scp::pbs::budget_key_timeframe_manager::Serialization;
 using google::scp::pbs::budget_key_timeframe_manager::Utils;
 using google::scp::pbs::budget_key_timeframe_manager::proto::
     BudgetKeyTimeframeGroupLog_1_0;
+using google::scp::pbs::budget_key_timeframe_manager::proto::
+    BudgetKeyTimeframeGroupsSnapshotLog_1_0;
 using google::scp::pbs::budget_key_timeframe_manager::proto::
     BudgetKeyTimeframeLog_1_0;
 using google::scp::pbs::budget_key_timeframe_manager::proto::
@@ -525,4 +530,173 @@ TEST(BudgetKeyTimeframeManagerTest, DeserializeHourTokensInTimeGroup) {
                     SC_BUDGET_KEY_TIMEFRAME_MANAGER_CORRUPTED_KEY_METADATA));
 }
 
+TEST(BudgetKeyTimeframeManagerTest, PackDeltas) {
+  vector<vector<uint64_t>> values_list = {
+      {},
+      {0},
+      {UINT64_MAX},
+      {19000, 19000, 19000},
+      {100, 100, 99, 100, 0, 100},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+      {0, UINT64_MAX, 0, 1ULL << 63, 12345678901234}};
+  string packed;
+  for (const auto& values : values_list) {
+    Serialization::PackDeltas(values, packed);
+  }
+
+  // A day of unchanged tokens only takes the first value and the width.
+  string unchanged_packed;
+  Serialization::PackDeltas(vector<uint64_t>(24, 100), unchanged_packed);
+  EXPECT_EQ(unchanged_packed.size(), 2);
+
+  size_t offset = 0;
+  for (const auto& values : values_list) {
+    vector<uint64_t> unpacked_values;
+    EXPECT_SUCCESS(Serialization::UnpackDeltas(packed, offset, values.size(),
+                                               unpacked_values));
+    EXPECT_EQ(unpacked_values, values);
+  }
+  EXPECT_EQ(offset, packed.size());
+
+  // The values cannot be unpacked past the end of the buffer.
+  string last_packed;
+  Serialization::PackDeltas(values_list.back(), last_packed);
+  for (size_t length = 0; length < last_packed.size(); ++length) {
+    offset = 0;
+    vector<uint64_t> unpacked_values;
+    EXPECT_THAT(
+        Serialization::UnpackDeltas(last_packed.substr(0, length), offset,
+                                    values_list.back().size(),
+                                    unpacked_values),
+        ResultIs(FailureExecutionResult(
+            core::errors::
+                SC_BUDGET_KEY_TIMEFRAME_MANAGER_CORRUPTED_KEY_METADATA)));
+  }
+}
+
+TEST(BudgetKeyTimeframeManagerTest,
+     SerializeBudgetKeyTimeframeGroupsSnapshotLog_1_0) {
+  vector<shared_ptr<BudgetKeyTimeframeGroup>> budget_key_timeframe_groups;
+  for (TimeGroup time_group : {19003, 19001, 19002}) {
+    auto budget_key_timeframe_group =
+        make_shared<BudgetKeyTimeframeGroup>(time_group);
+    for (TimeBucket time_bucket = 0; time_bucket < kHoursPerDay;
+         ++time_bucket) {
+      auto budget_key_timeframe = make_shared<BudgetKeyTimeframe>(time_bucket);
+      budget_key_timeframe->token_count = time_bucket % 5;
+      auto pair = make_pair(time_bucket, budget_key_timeframe);
+      budget_key_timeframe_group->budget_key_timeframes.Insert(
+          pair, budget_key_timeframe);
+    }
+    budget_key_timeframe_groups.push_back(budget_key_timeframe_group);
+  }
+  // A time group being loaded has no timeframes.
+  budget_key_timeframe_groups.push_back(
+      make_shared<BudgetKeyTimeframeGroup>(18000));
+
+  shared_ptr<BudgetKeyTimeframe> active_budget_key_timeframe;
+  budget_key_timeframe_groups[0]->budget_key_timeframes.Find(
+      3, active_budget_key_timeframe);
+  active_budget_key_timeframe->active_token_count = 2;
+  active_budget_key_timeframe->active_transaction_id = Uuid::GenerateUuid();
+
+  shared_ptr<BudgetKeyTimeframe> reserved_budget_key_timeframe;
+  budget_key_timeframe_groups[1]->budget_key_timeframes.Find(
+      7, reserved_budget_key_timeframe);
+  auto transaction_id = Uuid::GenerateUuid();
+  auto reservation = make_shared<BudgetKeyTimeframeReservation>(1);
+  reservation->is_logged = true;
+  auto reservation_pair = make_pair(transaction_id, reservation);
+  reserved_budget_key_timeframe->reservations.Insert(reservation_pair,
+                                                     reservation);
+  // Reservations not logged yet are not in the snapshot.
+  auto unlogged_reservation = make_shared<BudgetKeyTimeframeReservation>(1);
+  auto unlogged_reservation_pair =
+      make_pair(Uuid::GenerateUuid(), unlogged_reservation);
+  reserved_budget_key_timeframe->reservations.Insert(unlogged_reservation_pair,
+                                                     unlogged_reservation);
+
+  BytesBuffer output_log;
+  EXPECT_SUCCESS(
+      Serialization::SerializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+          budget_key_timeframe_groups, output_log));
+  string output_log_str(output_log.bytes->begin(),
+                        output_log.bytes->begin() + output_log.length);
+
+  // The snapshot is smaller than the logs of the time groups.
+  size_t group_logs_length = 0;
+  for (const auto& budget_key_timeframe_group : budget_key_timeframe_groups) {
+    BytesBuffer group_log;
+    EXPECT_SUCCESS(Serialization::SerializeBudgetKeyTimeframeGroupLog_1_0(
+        budget_key_timeframe_group, group_log));
+    group_logs_length += group_log.length;
+  }
+  EXPECT_LT(output_log.length * 4, group_logs_length);
+
+  vector<shared_ptr<BudgetKeyTimeframeGroup>> new_timeframe_groups;
+  EXPECT_SUCCESS(
+      Serialization::DeserializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+          output_log_str, new_timeframe_groups));
+  ASSERT_EQ(new_timeframe_groups.size(), 4);
+  EXPECT_EQ(new_timeframe_groups[0]->time_group, 18000);
+  EXPECT_EQ(new_timeframe_groups[0]->budget_key_timeframes.Size(), 0);
+  for (size_t i = 1; i < new_timeframe_groups.size(); ++i) {
+    auto& new_timeframe_group = new_timeframe_groups[i];
+    shared_ptr<BudgetKeyTimeframeGroup> budget_key_timeframe_group;
+    for (const auto& group : budget_key_timeframe_groups) {
+      if (group->time_group == new_timeframe_group->time_group) {
+        budget_key_timeframe_group = group;
+      }
+    }
+    ASSERT_NE(budget_key_timeframe_group, nullptr);
+    EXPECT_EQ(new_timeframe_group->budget_key_timeframes.Size(), kHoursPerDay);
+
+    for (TimeBucket time_bucket = 0; time_bucket < kHoursPerDay;
+         ++time_bucket) {
+      shared_ptr<BudgetKeyTimeframe> budget_key_timeframe;
+      shared_ptr<BudgetKeyTimeframe> new_budget_key_timeframe;
+      EXPECT_SUCCESS(budget_key_timeframe_group->budget_key_timeframes.Find(
+          time_bucket, budget_key_timeframe));
+      EXPECT_SUCCESS(new_timeframe_group->budget_key_timeframes.Find(
+          time_bucket, new_budget_key_timeframe));
+      EXPECT_EQ(new_budget_key_timeframe->time_bucket_index, time_bucket);
+      EXPECT_EQ(new_budget_key_timeframe->token_count.load(),
+                budget_key_timeframe->token_count.load());
+      EXPECT_EQ(new_budget_key_timeframe->active_token_count.load(),
+                budget_key_timeframe->active_token_count.load());
+      EXPECT_EQ(new_budget_key_timeframe->active_transaction_id.load(),
+                budget_key_timeframe->active_transaction_id.load());
+    }
+  }
+
+  // The time groups are sorted, so 19001 follows 18000.
+  shared_ptr<BudgetKeyTimeframe> new_reserved_budget_key_timeframe;
+  EXPECT_SUCCESS(new_timeframe_groups[1]->budget_key_timeframes.Find(
+      7, new_reserved_budget_key_timeframe));
+  EXPECT_EQ(new_reserved_budget_key_timeframe->reservations.Size(), 1);
+  EXPECT_EQ(new_reserved_budget_key_timeframe->reserved_token_count.load(), 1);
+  shared_ptr<BudgetKeyTimeframeReservation> new_reservation;
+  EXPECT_SUCCESS(new_reserved_budget_key_timeframe->reservations.Find(
+      transaction_id, new_reservation));
+  EXPECT_TRUE(new_reservation->is_logged.load());
+
+  // A truncated column is corrupted.
+  BudgetKeyTimeframeGroupsSnapshotLog_1_0 snapshot_log_1_0;
+  snapshot_log_1_0.ParseFromString(output_log_str);
+  snapshot_log_1_0.mutable_token_counts()->pop_back();
+  EXPECT_THAT(
+      Serialization::DeserializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+          snapshot_log_1_0.SerializeAsString(), new_timeframe_groups),
+      ResultIs(FailureExecutionResult(
+          core::errors::
+              SC_BUDGET_KEY_TIMEFRAME_MANAGER_CORRUPTED_KEY_METADATA)));
+
+  BytesBuffer empty_output_log;
+  EXPECT_THAT(
+      Serialization::SerializeBudgetKeyTimeframeGroupsSnapshotLog_1_0(
+          {}, empty_output_log),
+      ResultIs(FailureExecutionResult(
+          core::errors::SC_BUDGET_KEY_TIMEFRAME_MANAGER_INVALID_LOG)));
+}
+
 }  // namespace google::scp::pbs::test
@@ -159,7 +159,8 @@ void BatchConsumeBudgetTransactionProtocol::OnPrepareBudgetKeyLoaded(
       return;
     }
 
-    if (budget_key_frame->token_count < budget_to_consume.token_count) {
+    if (budget_key_frame->token_count - budget_key_frame->reserved_token_count <
+        budget_to_consume.token_count) {
       prepare_batch_consume_budget_context.result = FailureExecutionResult(
           core::errors::SC_PBS_BUDGET_KEY_CONSUME_BUDGET_INSUFFICIENT_BUDGET);
       if (auto result = PopulateInsufficientBudgetConsumptionIndicesInResponse(
@@ -290,6 +291,18 @@ void BatchConsumeBudgetTransactionProtocol::OnCommitBudgetKeyLoaded(
       return;
     }
 
+    // The timeframe cannot be locked while escrow transactions hold
+    // reservations on it.
+    if (budget_key_timeframes[i]->reserved_token_count.load() != 0) {
+      TransactionProtocolHelpers::ReleaseAcquiredLocksOnTimeframes(
+          commit_batch_consume_budget_context.request->transaction_id,
+          budget_key_timeframes);
+      commit_batch_consume_budget_context.result = RetryExecutionResult(
+          core::errors::SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS);
+      commit_batch_consume_budget_context.Finish();
+      return;
+    }
+
     // Budget check needs to happen. There is a chance that a write operation
     // has happened between this request's prepare and commit phases.
     if (budget_key_timeframes[i]->token_count <
@@ -29,13 +29,76 @@ using google::scp::core::RetryExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
 using std::bind;
+using std::make_pair;
 using std::make_shared;
 using std::move;
 using std::shared_ptr;
 using std::string;
 using std::placeholders::_1;
 
+namespace {
+/**
+ * @brief Rolls back the reservation of the transaction if it has not been
+ * journaled.
+ */
+void RollbackReservation(
+    google::scp::pbs::BudgetKeyTimeframe& budget_key_frame,
+    const google::scp::core::common::Uuid& transaction_id) noexcept {
+  shared_ptr<google::scp::pbs::BudgetKeyTimeframeReservation> reservation;
+  if (!budget_key_frame.reservations.Find(transaction_id, reservation)
+           .Successful() ||
+      reservation->is_logged.load() ||
+      !budget_key_frame.reservations.Erase(transaction_id).Successful()) {
+    return;
+  }
+  budget_key_frame.reserved_token_count -= reservation->token_count;
+}
+}  // namespace
+
 namespace google::scp::pbs {
+template <typename Request, typename Response>
+void ConsumeBudgetTransactionProtocol::UpdateReservation(
+    AsyncContext<Request, Response>& context,
+    shared_ptr<BudgetKeyTimeframe>& budget_key_frame,
+    BudgetKeyTimeframeReservationOperation operation) noexcept {
+  AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+               UpdateBudgetKeyTimeframeReservationResponse>
+      update_reservation_context;
+  update_reservation_context.request =
+      make_shared<UpdateBudgetKeyTimeframeReservationRequest>();
+  update_reservation_context.request->reporting_time =
+      context.request->time_bucket;
+  update_reservation_context.request->transaction_id =
+      context.request->transaction_id;
+  update_reservation_context.request->operation = operation;
+  update_reservation_context.parent_activity_id = context.activity_id;
+  update_reservation_context.correlation_id = context.correlation_id;
+  update_reservation_context.callback =
+      [context, budget_key_frame, operation](
+          AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                       UpdateBudgetKeyTimeframeReservationResponse>&
+              update_reservation_context) mutable {
+        if (!update_reservation_context.result.Successful() &&
+            operation == BudgetKeyTimeframeReservationOperation::Reserve) {
+          RollbackReservation(*budget_key_frame,
+                              context.request->transaction_id);
+        }
+        context.result = update_reservation_context.result;
+        context.Finish();
+      };
+
+  auto execution_result =
+      budget_key_timeframe_manager_->UpdateReservation(
+          update_reservation_context);
+  if (!execution_result.Successful()) {
+    if (operation == BudgetKeyTimeframeReservationOperation::Reserve) {
+      RollbackReservation(*budget_key_frame, context.request->transaction_id);
+    }
+    context.result = execution_result;
+    context.Finish();
+  }
+}
+
 ExecutionResult ConsumeBudgetTransactionProtocol::Prepare(
     AsyncContext<PrepareConsumeBudgetRequest, PrepareConsumeBudgetResponse>&
         prepare_consume_budget_context) noexcept {
@@ -83,7 +146,9 @@ void ConsumeBudgetTransactionProtocol::OnPrepareBudgetKeyLoaded(
     return;
   }
 
-  if (budget_key_frame->token_count <
+  // Tokens reserved by other transactions are not available, and the total
+  // reserved never exceeds the token count.
+  if (budget_key_frame->token_count - budget_key_frame->reserved_token_count <
       prepare_consume_budget_context.request->token_count) {
     prepare_consume_budget_context.result = FailureExecutionResult(
         core::errors::SC_PBS_BUDGET_KEY_CONSUME_BUDGET_INSUFFICIENT_BUDGET);
@@ -132,6 +197,11 @@ void ConsumeBudgetTransactionProtocol::OnCommitBudgetKeyLoaded(
   auto budget_key_frame =
       load_budget_key_timeframe_context.response->budget_key_frames.front();
 
+  if (escrow_reservations_enabled_) {
+    ReserveTokens(commit_consume_budget_context, budget_key_frame);
+    return;
+  }
+
   // In the commit phase, it is required to take the ownership of the cached
   // object. So the current transaction will try to change the transaction id on
   // the entry in the cache from zero to the request transaction id.
@@ -157,6 +227,17 @@ void ConsumeBudgetTransactionProtocol::OnCommitBudgetKeyLoaded(
     return;
   }
 
+  // The timeframe cannot be locked while escrow transactions hold
+  // reservations on it. Reservations check the lock after being added, so
+  // either this transaction or the escrow ones back off.
+  if (budget_key_frame->reserved_token_count.load() != 0) {
+    budget_key_frame->active_transaction_id = kZeroUuid;
+    commit_consume_budget_context.result = RetryExecutionResult(
+        core::errors::SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS);
+    commit_consume_budget_context.Finish();
+    return;
+  }
+
   // Budget check needs to happen. There is a chance that a write operation
   // has happened between this request's prepare and commit phases.
   if (budget_key_frame->token_count <
@@ -206,6 +287,57 @@ void ConsumeBudgetTransactionProtocol::OnCommitBudgetKeyLoaded(
   }
 }
 
+void ConsumeBudgetTransactionProtocol::ReserveTokens(
+    AsyncContext<CommitConsumeBudgetRequest, CommitConsumeBudgetResponse>&
+        commit_consume_budget_context,
+    shared_ptr<BudgetKeyTimeframe>& budget_key_frame) noexcept {
+  const auto& transaction_id =
+      commit_consume_budget_context.request->transaction_id;
+  TokenCount token_count = commit_consume_budget_context.request->token_count;
+
+  auto reservation = make_shared<BudgetKeyTimeframeReservation>(token_count);
+  auto reservation_pair = make_pair(transaction_id, reservation);
+  if (!budget_key_frame->reservations.Insert(reservation_pair, reservation)
+           .Successful()) {
+    // This is a retry. It succeeds once the first attempt is journaled.
+    if (reservation->is_logged.load()) {
+      commit_consume_budget_context.result = SuccessExecutionResult();
+    } else {
+      commit_consume_budget_context.result = RetryExecutionResult(
+          core::errors::SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS);
+    }
+    commit_consume_budget_context.Finish();
+    return;
+  }
+
+  // Admits the reservation only if all the reservations still fit in the
+  // token count. Budget may have been consumed since the prepare phase.
+  auto reserved_token_count = budget_key_frame->reserved_token_count.load();
+  do {
+    if (reserved_token_count + token_count > budget_key_frame->token_count) {
+      budget_key_frame->reservations.Erase(transaction_id);
+      commit_consume_budget_context.result = FailureExecutionResult(
+          core::errors::SC_PBS_BUDGET_KEY_CONSUME_BUDGET_INSUFFICIENT_BUDGET);
+      commit_consume_budget_context.Finish();
+      return;
+    }
+  } while (!budget_key_frame->reserved_token_count.compare_exchange_weak(
+      reserved_token_count, reserved_token_count + token_count));
+
+  // A non-escrow transaction may have locked the timeframe concurrently. It
+  // checks the reservations after locking, so either of them backs off.
+  if (budget_key_frame->active_transaction_id.load() != kZeroUuid) {
+    RollbackReservation(*budget_key_frame, transaction_id);
+    commit_consume_budget_context.result = RetryExecutionResult(
+        core::errors::SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS);
+    commit_consume_budget_context.Finish();
+    return;
+  }
+
+  UpdateReservation(commit_consume_budget_context, budget_key_frame,
+                    BudgetKeyTimeframeReservationOperation::Reserve);
+}
+
 void ConsumeBudgetTransactionProtocol::OnCommitLogged(
     shared_ptr<BudgetKeyTimeframe>& budget_key_time_frame,
     AsyncContext<CommitConsumeBudgetRequest, CommitConsumeBudgetResponse>&
@@ -275,6 +407,23 @@ void ConsumeBudgetTransactionProtocol::OnNotifyBudgetKeyLoaded(
   // and this is a retry operation.
   if (budget_key_time_frame->active_transaction_id.load() !=
       notify_consume_budget_context.request->transaction_id) {
+    // The transaction may have reserved its tokens in the escrow mode.
+    shared_ptr<BudgetKeyTimeframeReservation> reservation;
+    if (budget_key_time_frame->reservations
+            .Find(notify_consume_budget_context.request->transaction_id,
+                  reservation)
+            .Successful()) {
+      // The commit of the transaction is still being journaled.
+      if (!reservation->is_logged.load()) {
+        notify_consume_budget_context.result = RetryExecutionResult(
+            core::errors::SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS);
+        notify_consume_budget_context.Finish();
+        return;
+      }
+      UpdateReservation(notify_consume_budget_context, budget_key_time_frame,
+                        BudgetKeyTimeframeReservationOperation::Consume);
+      return;
+    }
     notify_consume_budget_context.result = SuccessExecutionResult();
     notify_consume_budget_context.Finish();
     return;
@@ -374,6 +523,23 @@ void ConsumeBudgetTransactionProtocol::OnAbortBudgetKeyLoaded(
   // Ensure that the request has arrived with the right transaction id.
   if (budget_key_frame->active_transaction_id.load() !=
       abort_consume_budget_context.request->transaction_id) {
+    // The transaction may have reserved its tokens in the escrow mode.
+    shared_ptr<BudgetKeyTimeframeReservation> reservation;
+    if (budget_key_frame->reservations
+            .Find(abort_consume_budget_context.request->transaction_id,
+                  reservation)
+            .Successful()) {
+      // The commit of the transaction is still being journaled.
+      if (!reservation->is_logged.load()) {
+        abort_consume_budget_context.result = RetryExecutionResult(
+            core::errors::SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS);
+        abort_consume_budget_context.Finish();
+        return;
+      }
+      UpdateReservation(abort_consume_budget_context, budget_key_frame,
+                        BudgetKeyTimeframeReservationOperation::Release);
+      return;
+    }
     abort_consume_budget_context.result = SuccessExecutionResult();
     abort_consume_budget_context.Finish();
     return;
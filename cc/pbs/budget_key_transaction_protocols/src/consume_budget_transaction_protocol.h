@@ -30,10 +30,22 @@ namespace google::scp::pbs {
 class ConsumeBudgetTransactionProtocol
     : public ConsumeBudgetTransactionProtocolInterface {
  public:
+  /**
+   * @brief Constructs a new consume budget transaction protocol.
+   *
+   * @param budget_key_timeframe_manager The timeframe manager of the budget
+   * key.
+   * @param escrow_reservations_enabled If true, the commit phase reserves the
+   * tokens on the timeframe instead of locking it, so that concurrent
+   * transactions can commit on the same timeframe as long as the sum of their
+   * reservations fits in its token count.
+   */
   ConsumeBudgetTransactionProtocol(
       const std::shared_ptr<BudgetKeyTimeframeManagerInterface>
-          budget_key_timeframe_manager)
-      : budget_key_timeframe_manager_(budget_key_timeframe_manager) {}
+          budget_key_timeframe_manager,
+      bool escrow_reservations_enabled = false)
+      : budget_key_timeframe_manager_(budget_key_timeframe_manager),
+        escrow_reservations_enabled_(escrow_reservations_enabled) {}
 
   core::ExecutionResult Prepare(
       core::AsyncContext<PrepareConsumeBudgetRequest,
@@ -176,8 +188,40 @@ class ConsumeBudgetTransactionProtocol
                          UpdateBudgetKeyTimeframeResponse>&
           update_budget_key_timeframe_context) noexcept;
 
+  /**
+   * @brief Reserves the tokens of the commit request on the timeframe and
+   * journals the reservation. Finishes the context with a retry result if the
+   * timeframe is locked by a non-escrow transaction.
+   *
+   * @param commit_consume_budget_context The commit consume budget operation
+   * context.
+   * @param budget_key_frame The budget key timeframe to reserve on.
+   */
+  void ReserveTokens(core::AsyncContext<CommitConsumeBudgetRequest,
+                                        CommitConsumeBudgetResponse>&
+                         commit_consume_budget_context,
+                     std::shared_ptr<BudgetKeyTimeframe>&
+                         budget_key_frame) noexcept;
+
+  /**
+   * @brief Journals an operation on the reservation of the transaction of the
+   * context and finishes the context with its result. A reservation which
+   * fails to be journaled is rolled back.
+   *
+   * @param context The commit, notify or abort operation context.
+   * @param budget_key_frame The budget key timeframe of the reservation.
+   * @param operation The reservation operation.
+   */
+  template <typename Request, typename Response>
+  void UpdateReservation(
+      core::AsyncContext<Request, Response>& context,
+      std::shared_ptr<BudgetKeyTimeframe>& budget_key_frame,
+      BudgetKeyTimeframeReservationOperation operation) noexcept;
+
  private:
   const std::shared_ptr<BudgetKeyTimeframeManagerInterface>
       budget_key_timeframe_manager_;
+  /// Whether the commit phase reserves tokens instead of locking timeframes.
+  const bool escrow_reservations_enabled_;
 };
 }  // namespace google::scp::pbs
@@ -20,6 +20,7 @@
 #include <utility>
 #include <vector>
 
+#include "core/common/concurrent_map/src/error_codes.h"
 #include "core/interface/async_context.h"
 #include "core/test/utils/conditional_wait.h"
 #include "pbs/budget_key_timeframe_manager/mock/mock_budget_key_timeframe_manager.h"
@@ -38,11 +39,14 @@ using google::scp::core::common::Uuid;
 using google::scp::core::test::ResultIs;
 using google::scp::core::test::WaitUntil;
 using google::scp::pbs::BudgetKeyTimeframe;
+using google::scp::pbs::BudgetKeyTimeframeReservation;
+using google::scp::pbs::BudgetKeyTimeframeReservationOperation;
 using google::scp::pbs::budget_key::mock::
     MockConsumeBudgetTransactionProtocolWithOverrides;
 using google::scp::pbs::buget_key_timeframe_manager::mock::
     MockBudgetKeyTimeframeManager;
 using std::atomic;
+using std::make_pair;
 using std::make_shared;
 using std::move;
 using std::shared_ptr;
@@ -1131,4 +1135,242 @@ TEST(ConsumeBudgetTransactionProtocolTest, OnAbortLogged) {
   }
 }
 
+
+TEST(ConsumeBudgetTransactionProtocolTest, ConsumeBudgetCommitEscrowReserves) {
+  auto budget_key_manager = make_shared<MockBudgetKeyTimeframeManager>();
+  auto transaction_protocol = make_shared<ConsumeBudgetTransactionProtocol>(
+      budget_key_manager, /*escrow_reservations_enabled=*/true);
+  auto budget_key_timeframe = make_shared<BudgetKeyTimeframe>(0);
+  budget_key_timeframe->token_count = 2;
+
+  budget_key_manager->load_function =
+      [&](auto& load_budget_key_timeframe_context) {
+        load_budget_key_timeframe_context.response =
+            make_shared<LoadBudgetKeyTimeframeResponse>();
+        load_budget_key_timeframe_context.response->budget_key_frames = {
+            budget_key_timeframe};
+
+        load_budget_key_timeframe_context.result = SuccessExecutionResult();
+        load_budget_key_timeframe_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  budget_key_manager->update_reservation_function =
+      [&](auto& update_reservation_context) {
+        EXPECT_EQ(update_reservation_context.request->operation,
+                  BudgetKeyTimeframeReservationOperation::Reserve);
+        shared_ptr<BudgetKeyTimeframeReservation> reservation;
+        EXPECT_SUCCESS(budget_key_timeframe->reservations.Find(
+            update_reservation_context.request->transaction_id, reservation));
+        reservation->is_logged = true;
+        update_reservation_context.result = SuccessExecutionResult();
+        update_reservation_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  // Transactions do not lock the timeframe, so all of them commit as long as
+  // their tokens fit in the timeframe.
+  vector<ExecutionResult> results;
+  for (uint64_t i = 1; i <= 3; ++i) {
+    AsyncContext<CommitConsumeBudgetRequest, CommitConsumeBudgetResponse>
+        commit_consume_budget_context(
+            make_shared<CommitConsumeBudgetRequest>(CommitConsumeBudgetRequest{
+                .transaction_id{0, i}, .time_bucket = 0, .token_count = 1}),
+            [&](auto& commit_consume_budget_context) {
+              results.push_back(commit_consume_budget_context.result);
+            });
+    EXPECT_SUCCESS(transaction_protocol->Commit(commit_consume_budget_context));
+  }
+
+  EXPECT_EQ(results.size(), 3);
+  EXPECT_SUCCESS(results[0]);
+  EXPECT_SUCCESS(results[1]);
+  EXPECT_THAT(results[2],
+              ResultIs(FailureExecutionResult(
+                  core::errors::
+                      SC_PBS_BUDGET_KEY_CONSUME_BUDGET_INSUFFICIENT_BUDGET)));
+  EXPECT_EQ(budget_key_timeframe->token_count.load(), 2);
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 2);
+  EXPECT_EQ(budget_key_timeframe->active_transaction_id.load(),
+            core::common::kZeroUuid);
+  shared_ptr<BudgetKeyTimeframeReservation> reservation;
+  EXPECT_THAT(budget_key_timeframe->reservations.Find({0, 3}, reservation),
+              ResultIs(FailureExecutionResult(
+                  core::errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+
+  // A retry of a journaled reservation succeeds without reserving again.
+  AsyncContext<CommitConsumeBudgetRequest, CommitConsumeBudgetResponse>
+      commit_consume_budget_context(
+          make_shared<CommitConsumeBudgetRequest>(CommitConsumeBudgetRequest{
+              .transaction_id{0, 1}, .time_bucket = 0, .token_count = 1}),
+          [&](auto& commit_consume_budget_context) {
+            results.push_back(commit_consume_budget_context.result);
+          });
+  EXPECT_SUCCESS(transaction_protocol->Commit(commit_consume_budget_context));
+  EXPECT_SUCCESS(results.back());
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 2);
+}
+
+TEST(ConsumeBudgetTransactionProtocolTest,
+     ConsumeBudgetCommitEscrowRollsBackOnFailure) {
+  auto budget_key_manager = make_shared<MockBudgetKeyTimeframeManager>();
+  auto transaction_protocol = make_shared<ConsumeBudgetTransactionProtocol>(
+      budget_key_manager, /*escrow_reservations_enabled=*/true);
+  auto budget_key_timeframe = make_shared<BudgetKeyTimeframe>(0);
+  budget_key_timeframe->token_count = 5;
+
+  budget_key_manager->load_function =
+      [&](auto& load_budget_key_timeframe_context) {
+        load_budget_key_timeframe_context.response =
+            make_shared<LoadBudgetKeyTimeframeResponse>();
+        load_budget_key_timeframe_context.response->budget_key_frames = {
+            budget_key_timeframe};
+
+        load_budget_key_timeframe_context.result = SuccessExecutionResult();
+        load_budget_key_timeframe_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  budget_key_manager->update_reservation_function =
+      [&](auto& update_reservation_context) {
+        update_reservation_context.result = FailureExecutionResult(1234);
+        update_reservation_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  ExecutionResult result;
+  AsyncContext<CommitConsumeBudgetRequest, CommitConsumeBudgetResponse>
+      commit_consume_budget_context(
+          make_shared<CommitConsumeBudgetRequest>(CommitConsumeBudgetRequest{
+              .transaction_id{0, 1}, .time_bucket = 0, .token_count = 3}),
+          [&](auto& commit_consume_budget_context) {
+            result = commit_consume_budget_context.result;
+          });
+  EXPECT_SUCCESS(transaction_protocol->Commit(commit_consume_budget_context));
+  EXPECT_THAT(result, ResultIs(FailureExecutionResult(1234)));
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 0);
+  shared_ptr<BudgetKeyTimeframeReservation> reservation;
+  EXPECT_THAT(budget_key_timeframe->reservations.Find({0, 1}, reservation),
+              ResultIs(FailureExecutionResult(
+                  core::errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+
+  // A timeframe locked by a non-escrow transaction cannot be reserved.
+  budget_key_timeframe->active_transaction_id = {1, 1};
+  EXPECT_SUCCESS(transaction_protocol->Commit(commit_consume_budget_context));
+  EXPECT_THAT(result,
+              ResultIs(RetryExecutionResult(
+                  core::errors::
+                      SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS)));
+  EXPECT_EQ(budget_key_timeframe->reserved_token_count.load(), 0);
+}
+
+TEST(ConsumeBudgetTransactionProtocolTest,
+     ConsumeBudgetCommitRetriesWhenReserved) {
+  auto budget_key_manager = make_shared<MockBudgetKeyTimeframeManager>();
+  auto transaction_protocol =
+      make_shared<ConsumeBudgetTransactionProtocol>(budget_key_manager);
+  auto budget_key_timeframe = make_shared<BudgetKeyTimeframe>(0);
+  budget_key_timeframe->token_count = 5;
+  budget_key_timeframe->reserved_token_count = 1;
+
+  budget_key_manager->load_function =
+      [&](auto& load_budget_key_timeframe_context) {
+        load_budget_key_timeframe_context.response =
+            make_shared<LoadBudgetKeyTimeframeResponse>();
+        load_budget_key_timeframe_context.response->budget_key_frames = {
+            budget_key_timeframe};
+
+        load_budget_key_timeframe_context.result = SuccessExecutionResult();
+        load_budget_key_timeframe_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  ExecutionResult result;
+  AsyncContext<CommitConsumeBudgetRequest, CommitConsumeBudgetResponse>
+      commit_consume_budget_context(
+          make_shared<CommitConsumeBudgetRequest>(CommitConsumeBudgetRequest{
+              .transaction_id{0, 1}, .time_bucket = 0, .token_count = 1}),
+          [&](auto& commit_consume_budget_context) {
+            result = commit_consume_budget_context.result;
+          });
+  EXPECT_SUCCESS(transaction_protocol->Commit(commit_consume_budget_context));
+  EXPECT_THAT(result,
+              ResultIs(RetryExecutionResult(
+                  core::errors::
+                      SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS)));
+  EXPECT_EQ(budget_key_timeframe->active_transaction_id.load(),
+            core::common::kZeroUuid);
+}
+
+TEST(ConsumeBudgetTransactionProtocolTest,
+     ConsumeBudgetNotifyAndAbortEscrowReservations) {
+  auto budget_key_manager = make_shared<MockBudgetKeyTimeframeManager>();
+  auto transaction_protocol = make_shared<ConsumeBudgetTransactionProtocol>(
+      budget_key_manager, /*escrow_reservations_enabled=*/true);
+  auto budget_key_timeframe = make_shared<BudgetKeyTimeframe>(0);
+  budget_key_timeframe->token_count = 5;
+
+  budget_key_manager->load_function =
+      [&](auto& load_budget_key_timeframe_context) {
+        load_budget_key_timeframe_context.response =
+            make_shared<LoadBudgetKeyTimeframeResponse>();
+        load_budget_key_timeframe_context.response->budget_key_frames = {
+            budget_key_timeframe};
+
+        load_budget_key_timeframe_context.result = SuccessExecutionResult();
+        load_budget_key_timeframe_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  vector<BudgetKeyTimeframeReservationOperation> operations;
+  budget_key_manager->update_reservation_function =
+      [&](auto& update_reservation_context) {
+        operations.push_back(update_reservation_context.request->operation);
+        update_reservation_context.result = SuccessExecutionResult();
+        update_reservation_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  auto reservation = make_shared<BudgetKeyTimeframeReservation>(2);
+  auto reservation_pair = make_pair(Uuid{0, 1}, reservation);
+  budget_key_timeframe->reservations.Insert(reservation_pair, reservation);
+  budget_key_timeframe->reserved_token_count = 2;
+
+  ExecutionResult result;
+  AsyncContext<NotifyConsumeBudgetRequest, NotifyConsumeBudgetResponse>
+      notify_consume_budget_context(
+          make_shared<NotifyConsumeBudgetRequest>(
+              NotifyConsumeBudgetRequest{.transaction_id{0, 1},
+                                         .time_bucket = 0}),
+          [&](auto& notify_consume_budget_context) {
+            result = notify_consume_budget_context.result;
+          });
+
+  // The reservation is still being journaled.
+  EXPECT_SUCCESS(transaction_protocol->Notify(notify_consume_budget_context));
+  EXPECT_THAT(result,
+              ResultIs(RetryExecutionResult(
+                  core::errors::
+                      SC_PBS_BUDGET_KEY_ACTIVE_TRANSACTION_IN_PROGRESS)));
+  EXPECT_TRUE(operations.empty());
+
+  reservation->is_logged = true;
+  EXPECT_SUCCESS(transaction_protocol->Notify(notify_consume_budget_context));
+  EXPECT_SUCCESS(result);
+
+  AsyncContext<AbortConsumeBudgetRequest, AbortConsumeBudgetResponse>
+      abort_consume_budget_context(
+          make_shared<AbortConsumeBudgetRequest>(
+              AbortConsumeBudgetRequest{.transaction_id{0, 1},
+                                        .time_bucket = 0}),
+          [&](auto& abort_consume_budget_context) {
+            result = abort_consume_budget_context.result;
+          });
+  EXPECT_SUCCESS(transaction_protocol->Abort(abort_consume_budget_context));
+  EXPECT_SUCCESS(result);
+
+  EXPECT_EQ(operations, vector<BudgetKeyTimeframeReservationOperation>(
+                            {BudgetKeyTimeframeReservationOperation::Consume,
+                             BudgetKeyTimeframeReservationOperation::Release}));
+}
 }  // namespace google::scp::pbs::test
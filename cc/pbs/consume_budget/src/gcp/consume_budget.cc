@@ -14,6 +14,8 @@
 #include "cc/pbs/consume_budget/src/gcp/consume_budget.h"
 
 #include <memory>
+#include <list>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -22,7 +24,9 @@
 #include <nlohmann/json.hpp>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_format.h"
+#include "cc/core/async_executor/src/async_executor.h"
 #include "cc/core/interface/config_provider_interface.h"
 #include "cc/core/interface/configuration_keys.h"
 #include "cc/pbs/budget_key_timeframe_manager/src/budget_key_timeframe_serialization.h"
@@ -40,8 +44,12 @@ namespace google::scp::pbs {
 namespace {
 
 using ::google::scp::core::AsyncContext;
+using ::google::scp::core::AsyncExecutor;
 using ::google::scp::core::AsyncExecutorInterface;
 using ::google::scp::core::ConfigProviderInterface;
+using ConsumeBudgetsContext =
+    ::google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                      ConsumeBudgetsResponse>;
 using ::google::scp::core::ExecutionResult;
 using ::google::scp::core::ExecutionResultOr;
 using ::google::scp::core::FailureExecutionResult;
@@ -50,7 +58,11 @@ using ::google::scp::core::kGcpProjectId;
 using ::google::scp::core::kSpannerDatabase;
 using ::google::scp::core::kSpannerEndpointOverride;
 using ::google::scp::core::kSpannerInstance;
+using ::google::scp::core::kSpannerCallExecutorQueueCap;
+using ::google::scp::core::kSpannerCallExecutorThreadCount;
 using ::google::scp::core::SuccessExecutionResult;
+using ::google::scp::pbs::kBudgetConsumptionCoalescingEnabled;
+using ::google::scp::pbs::kBudgetConsumptionCoalescingMaxBatchSize;
 using ::google::scp::pbs::budget_key_timeframe_manager::Serialization;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_FAIL_TO_COMMIT;
@@ -65,6 +77,8 @@ constexpr absl::string_view kValueSpannerColumnName = "Value";
 constexpr absl::string_view kTokenCountJsonField = "TokenCount";
 constexpr size_t kDefaultTokenCountSize = 24;
 constexpr TokenCount kDefaultPrivacyBudgetCount = 1;
+constexpr size_t kDefaultCoalescingMaxBatchSize = 32;
+constexpr size_t kDefaultSpannerCallExecutorQueueCap = 100000;
 
 class PbsPrimaryKey {
  public:
@@ -341,6 +355,35 @@ std::tuple<cloud::Status, ExecutionResult> CreateSpannerMutations(
   }
   return std::make_tuple(cloud::Status(), SuccessExecutionResult());
 }
+
+// Returns a string identifying the Spanner row the budget is stored in.
+std::string GetRowKey(const ConsumeBudgetMetadata& metadata) {
+  // The time group is numeric, so the first ':' always ends it.
+  return absl::StrCat(
+      budget_key_timeframe_manager::Utils::GetTimeGroup(metadata.time_bucket),
+      ":", *metadata.budget_key_name);
+}
+
+absl::flat_hash_set<std::string> GetRowKeys(
+    const ConsumeBudgetsContext& consume_budgets_context) {
+  absl::flat_hash_set<std::string> row_keys;
+  for (const ConsumeBudgetMetadata& metadata :
+       consume_budgets_context.request->budgets) {
+    row_keys.insert(GetRowKey(metadata));
+  }
+  return row_keys;
+}
+
+void FinishContext(AsyncExecutorInterface* async_executor,
+                   ConsumeBudgetsContext consume_budgets_context) {
+  if (!async_executor->Schedule(
+          [consume_budgets_context]() mutable {
+            consume_budgets_context.Finish();
+          },
+          google::scp::core::AsyncPriority::Normal)) {
+    consume_budgets_context.Finish();
+  }
+}
 }  // namespace
 
 BudgetConsumptionHelper::BudgetConsumptionHelper(
@@ -351,7 +394,8 @@ BudgetConsumptionHelper::BudgetConsumptionHelper(
     : config_provider_(config_provider),
       async_executor_(async_executor),
       io_async_executor_(io_async_executor),
-      spanner_connection_(spanner_connection) {}
+      spanner_connection_(spanner_connection),
+      coalescing_max_batch_size_(kDefaultCoalescingMaxBatchSize) {}
 
 ExecutionResultOr<std::shared_ptr<cloud::spanner::Connection>>
 BudgetConsumptionHelper::MakeSpannerConnectionForProd(
@@ -396,14 +440,48 @@ ExecutionResult BudgetConsumptionHelper::Init() noexcept {
       execution_result != SuccessExecutionResult()) {
     return execution_result;
   }
+  if (!config_provider_
+           ->Get(kBudgetConsumptionCoalescingEnabled, coalescing_enabled_)
+           .Successful()) {
+    coalescing_enabled_ = false;
+  }
+  if (!config_provider_
+           ->Get(kBudgetConsumptionCoalescingMaxBatchSize,
+                 coalescing_max_batch_size_)
+           .Successful() ||
+      coalescing_max_batch_size_ == 0) {
+    coalescing_max_batch_size_ = kDefaultCoalescingMaxBatchSize;
+  }
+  // The Spanner client only has blocking calls, so every transaction holds
+  // a thread until it commits. Isolating them on a dedicated executor keeps
+  // the IO executor threads free for other work.
+  size_t thread_count = 0;
+  if (config_provider_->Get(kSpannerCallExecutorThreadCount, thread_count)
+          .Successful() &&
+      thread_count > 0) {
+    size_t queue_cap = kDefaultSpannerCallExecutorQueueCap;
+    config_provider_->Get(kSpannerCallExecutorQueueCap, queue_cap);
+    spanner_call_executor_ =
+        std::make_unique<AsyncExecutor>(thread_count, queue_cap);
+    if (auto execution_result = spanner_call_executor_->Init();
+        !execution_result.Successful()) {
+      return execution_result;
+    }
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult BudgetConsumptionHelper::Run() noexcept {
+  if (spanner_call_executor_) {
+    return spanner_call_executor_->Run();
+  }
   return SuccessExecutionResult();
 }
 
 ExecutionResult BudgetConsumptionHelper::Stop() noexcept {
+  if (spanner_call_executor_) {
+    return spanner_call_executor_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
@@ -412,7 +490,10 @@ ExecutionResult BudgetConsumptionHelper::ConsumeBudgets(
         consume_budgets_context) {
   // TODO: Check that request is not empty.
   // Return invalid argument
-  if (auto schedule_result = io_async_executor_->Schedule(
+  if (coalescing_enabled_) {
+    return ConsumeBudgetsCoalesced(consume_budgets_context);
+  }
+  if (auto schedule_result = GetSpannerCallExecutor().Schedule(
           std::bind(
               &BudgetConsumptionHelper::ConsumeBudgetsSyncAndFinishContext,
               this, consume_budgets_context),
@@ -429,13 +510,7 @@ void BudgetConsumptionHelper::ConsumeBudgetsSyncAndFinishContext(
     AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
         consume_budgets_context) {
   consume_budgets_context.result = ConsumeBudgetsSync(consume_budgets_context);
-  if (!async_executor_->Schedule(
-          [consume_budgets_context]() mutable {
-            consume_budgets_context.Finish();
-          },
-          google::scp::core::AsyncPriority::Normal)) {
-    consume_budgets_context.Finish();
-  }
+  FinishContext(async_executor_, consume_budgets_context);
 }
 
 ExecutionResult BudgetConsumptionHelper::ConsumeBudgetsSync(
@@ -525,4 +600,277 @@ ExecutionResult BudgetConsumptionHelper::ConsumeBudgetsSync(
   }
   return SuccessExecutionResult();
 }
+
+ExecutionResult BudgetConsumptionHelper::ConsumeBudgetsCoalesced(
+    ConsumeBudgetsContext consume_budgets_context) {
+  std::vector<std::vector<ConsumeBudgetsContext>> batches;
+  {
+    std::lock_guard<std::mutex> lock(coalescing_mutex_);
+    pending_contexts_.push_back(consume_budgets_context);
+    batches = TakeSchedulableBatchesLocked();
+  }
+  ScheduleBatches(std::move(batches));
+  return SuccessExecutionResult();
+}
+
+std::vector<std::vector<ConsumeBudgetsContext>>
+BudgetConsumptionHelper::TakeSchedulableBatchesLocked() {
+  std::vector<std::vector<ConsumeBudgetsContext>> batches;
+  std::vector<absl::flat_hash_set<std::string>> batch_rows;
+  // Rows of the requests left in the queue. Later requests touching them stay
+  // queued as well so that every row is consumed in arrival order.
+  absl::flat_hash_set<std::string> blocked_rows;
+
+  auto intersects = [](const absl::flat_hash_set<std::string>& rows,
+                       const absl::flat_hash_set<std::string>& other_rows) {
+    for (const auto& row : rows) {
+      if (other_rows.contains(row)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (auto it = pending_contexts_.begin(); it != pending_contexts_.end();) {
+    auto rows = GetRowKeys(*it);
+    bool is_blocked = intersects(rows, in_flight_rows_) ||
+                      intersects(rows, blocked_rows);
+
+    std::vector<size_t> overlapping_batches;
+    size_t merged_batch_size = 1;
+    if (!is_blocked) {
+      for (size_t i = 0; i < batches.size(); i++) {
+        if (!batches[i].empty() && intersects(rows, batch_rows[i])) {
+          overlapping_batches.push_back(i);
+          merged_batch_size += batches[i].size();
+        }
+      }
+      is_blocked = merged_batch_size > coalescing_max_batch_size_;
+    }
+
+    if (is_blocked) {
+      blocked_rows.insert(rows.begin(), rows.end());
+      ++it;
+      continue;
+    }
+
+    if (overlapping_batches.empty()) {
+      batches.emplace_back();
+      batch_rows.emplace_back();
+      overlapping_batches.push_back(batches.size() - 1);
+    }
+
+    // The request joins the earliest overlapping batch, which absorbs any
+    // other batch the request connects it to.
+    auto target = overlapping_batches[0];
+    for (size_t i = 1; i < overlapping_batches.size(); i++) {
+      auto source = overlapping_batches[i];
+      batches[target].insert(batches[target].end(), batches[source].begin(),
+                             batches[source].end());
+      batch_rows[target].insert(batch_rows[source].begin(),
+                                batch_rows[source].end());
+      batches[source].clear();
+      batch_rows[source].clear();
+    }
+    batches[target].push_back(*it);
+    batch_rows[target].insert(rows.begin(), rows.end());
+    it = pending_contexts_.erase(it);
+  }
+
+  std::vector<std::vector<ConsumeBudgetsContext>> schedulable_batches;
+  for (size_t i = 0; i < batches.size(); i++) {
+    if (batches[i].empty()) {
+      continue;
+    }
+    in_flight_rows_.insert(batch_rows[i].begin(), batch_rows[i].end());
+    schedulable_batches.push_back(std::move(batches[i]));
+  }
+  return schedulable_batches;
+}
+
+void BudgetConsumptionHelper::ScheduleBatches(
+    std::vector<std::vector<ConsumeBudgetsContext>> batches) {
+  for (auto& batch : batches) {
+    if (auto schedule_result = GetSpannerCallExecutor().Schedule(
+            [this, batch]() mutable {
+              ConsumeBatchSyncAndFinishContexts(std::move(batch));
+            },
+            google::scp::core::AsyncPriority::Normal);
+        !schedule_result.Successful()) {
+      // The requests have already been accepted, so they are finished with
+      // the scheduling failure.
+      for (auto& consume_budgets_context : batch) {
+        consume_budgets_context.result = schedule_result;
+      }
+      ReleaseRowsAndSchedulePendingBatches(batch);
+      for (auto& consume_budgets_context : batch) {
+        FinishContext(async_executor_, consume_budgets_context);
+      }
+    }
+  }
+}
+
+void BudgetConsumptionHelper::ConsumeBatchSyncAndFinishContexts(
+    std::vector<ConsumeBudgetsContext> batch) {
+  ConsumeBatchSync(batch);
+  ReleaseRowsAndSchedulePendingBatches(batch);
+  for (auto& consume_budgets_context : batch) {
+    FinishContext(async_executor_, consume_budgets_context);
+  }
+}
+
+void BudgetConsumptionHelper::ReleaseRowsAndSchedulePendingBatches(
+    const std::vector<ConsumeBudgetsContext>& batch) {
+  std::vector<std::vector<ConsumeBudgetsContext>> batches;
+  {
+    std::lock_guard<std::mutex> lock(coalescing_mutex_);
+    for (const auto& consume_budgets_context : batch) {
+      for (const ConsumeBudgetMetadata& metadata :
+           consume_budgets_context.request->budgets) {
+        in_flight_rows_.erase(GetRowKey(metadata));
+      }
+    }
+    batches = TakeSchedulableBatchesLocked();
+  }
+  ScheduleBatches(std::move(batches));
+}
+
+void BudgetConsumptionHelper::ConsumeBatchSync(
+    std::vector<ConsumeBudgetsContext>& batch) {
+  spanner::Client client(spanner_connection_);
+  ExecutionResult captured_execution_result = SuccessExecutionResult();
+  std::vector<ExecutionResult> request_results(batch.size());
+  std::vector<std::vector<size_t>> request_budget_exhausted_indices(
+      batch.size());
+  bool has_consumed_budgets = false;
+  // Whether the transaction was rolled back only because no request of the
+  // batch had enough budget, in which case each request keeps its own result.
+  bool no_request_has_budget = false;
+
+  auto commit_result = client.Commit(
+      [&](spanner::Transaction txn) -> cloud::StatusOr<spanner::Mutations> {
+        // The lambda is re-run when the transaction is aborted, so start over.
+        captured_execution_result = SuccessExecutionResult();
+        has_consumed_budgets = false;
+        no_request_has_budget = false;
+        for (size_t i = 0; i < batch.size(); ++i) {
+          request_results[i] = SuccessExecutionResult();
+          request_budget_exhausted_indices[i].clear();
+        }
+
+        std::vector<ConsumeBudgetMetadata> batch_budgets;
+        for (const auto& consume_budgets_context : batch) {
+          batch_budgets.insert(batch_budgets.end(),
+                               consume_budgets_context.request->budgets.begin(),
+                               consume_budgets_context.request->budgets.end());
+        }
+        cloud::StatusOr<absl::flat_hash_map<PbsPrimaryKey, spanner::Json>>
+            results =
+                ReadPrivacyBudgetsForKeys(client, txn, table_name_,
+                                          CreateSpannerKeySet(batch_budgets));
+        if (!results.ok()) {
+          return results.status();
+        }
+
+        absl::flat_hash_map<PbsPrimaryKey, PbsBudgetKeyMutation> pbs_mutations;
+        if (auto [status, execution_result] =
+                CreatePbsMutations(*results, pbs_mutations);
+            !status.ok()) {
+          captured_execution_result = execution_result;
+          return status;
+        }
+
+        // Rows changed by at least one request of the batch.
+        absl::flat_hash_map<PbsPrimaryKey, PbsBudgetKeyMutation>
+            updated_pbs_mutations;
+        for (size_t i = 0; i < batch.size(); ++i) {
+          const auto& budgets = batch[i].request->budgets;
+          if (auto [status, execution_result, budget_exhausted_indices] =
+                  ValidatePbsMutations(budgets, pbs_mutations);
+              !status.ok()) {
+            request_results[i] = execution_result;
+            request_budget_exhausted_indices[i] = budget_exhausted_indices;
+            continue;
+          }
+
+          // Applies the request on a copy of its rows so that it is either
+          // applied entirely or not at all.
+          absl::flat_hash_map<PbsPrimaryKey, PbsBudgetKeyMutation>
+              request_pbs_mutations;
+          for (const ConsumeBudgetMetadata& metadata : budgets) {
+            PbsPrimaryKey primary_key{
+                *metadata.budget_key_name,
+                absl::StrCat(budget_key_timeframe_manager::Utils::GetTimeGroup(
+                    metadata.time_bucket))};
+            if (auto pbs_mutation = pbs_mutations.find(primary_key);
+                pbs_mutation != pbs_mutations.end()) {
+              request_pbs_mutations.insert(*pbs_mutation);
+            }
+          }
+          if (auto [status, execution_result] =
+                  UpdatePbsMutationsToConsumeBudgets(budgets,
+                                                     request_pbs_mutations);
+              !status.ok()) {
+            request_results[i] = execution_result;
+            continue;
+          }
+          for (const auto& [primary_key, pbs_mutation] :
+               request_pbs_mutations) {
+            pbs_mutations.insert_or_assign(primary_key, pbs_mutation);
+            updated_pbs_mutations.insert_or_assign(primary_key, pbs_mutation);
+          }
+          has_consumed_budgets = true;
+        }
+
+        if (!has_consumed_budgets) {
+          no_request_has_budget = true;
+          return cloud::Status(cloud::StatusCode::kInvalidArgument,
+                               "Not enough budget for any request.");
+        }
+
+        spanner::Mutations mutations;
+        if (auto [status, execution_result] = CreateSpannerMutations(
+                updated_pbs_mutations, table_name_, mutations);
+            !status.ok()) {
+          captured_execution_result = execution_result;
+          return status;
+        }
+        return mutations;
+      });
+
+  // If the whole batch failed for a reason other than the budgets of its
+  // requests, e.g. the read or the commit failed, every request fails with the
+  // same result since no budget was consumed.
+  if (!commit_result && !no_request_has_budget) {
+    auto final_execution_result =
+        !captured_execution_result.Successful()
+            ? captured_execution_result
+            : FailureExecutionResult(SC_CONSUME_BUDGET_FAIL_TO_COMMIT);
+    for (auto& consume_budgets_context : batch) {
+      consume_budgets_context.result = final_execution_result;
+      SCP_ERROR_CONTEXT(
+          kComponentName, consume_budgets_context, final_execution_result,
+          absl::StrFormat("ConsumeBudgets failed in a batch of %d requests. "
+                          "Error code %d, message: %s",
+                          batch.size(), commit_result.status().code(),
+                          commit_result.status().message()));
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i].result = request_results[i];
+    if (request_results[i].status_code == SC_CONSUME_BUDGET_EXHAUSTED) {
+      batch[i].response->budget_exhausted_indices =
+          request_budget_exhausted_indices[i];
+      SCP_WARNING_CONTEXT(
+          kComponentName, batch[i],
+          absl::StrFormat("ConsumeBudgets failed in a batch of %d requests. "
+                          "final_execution_result: %s",
+                          batch.size(),
+                          google::scp::core::errors::GetErrorMessage(
+                              request_results[i].status_code)));
+    }
+  }
+}
 }  // namespace google::scp::pbs
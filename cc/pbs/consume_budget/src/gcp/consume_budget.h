@@ -14,9 +14,13 @@
 #ifndef CC_PBS_CONSUME_BUDGET_SRC_GCP_CONSUME_BUDGET_H_
 #define CC_PBS_CONSUME_BUDGET_SRC_GCP_CONSUME_BUDGET_H_
 
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/config_provider_interface.h"
 #include "cc/pbs/interface/consume_budget_interface.h"
@@ -64,11 +68,72 @@ class BudgetConsumptionHelper : public BudgetConsumptionHelperInterface {
                                             ConsumeBudgetsResponse>&
           consume_budgets_context);
 
+  // Queues the request and schedules it, possibly along with other queued
+  // requests touching the same rows, once none of its rows are used by an
+  // in-flight transaction.
+  google::scp::core::ExecutionResult ConsumeBudgetsCoalesced(
+      google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                      ConsumeBudgetsResponse>
+          consume_budgets_context);
+
+  // Moves the queued requests whose rows are not in use into new batches.
+  // Requests sharing rows are merged into the same batch. Must be called with
+  // coalescing_mutex_ held.
+  std::vector<std::vector<google::scp::core::AsyncContext<
+      ConsumeBudgetsRequest, ConsumeBudgetsResponse>>>
+  TakeSchedulableBatchesLocked();
+
+  void ScheduleBatches(
+      std::vector<std::vector<google::scp::core::AsyncContext<
+          ConsumeBudgetsRequest, ConsumeBudgetsResponse>>>
+          batches);
+
+  void ConsumeBatchSyncAndFinishContexts(
+      std::vector<google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                                  ConsumeBudgetsResponse>>
+          batch);
+
+  // Consumes the budgets of all requests in the batch in one transaction.
+  // Every request is validated and applied independently in order, and its
+  // result is set on its context.
+  void ConsumeBatchSync(
+      std::vector<google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                                  ConsumeBudgetsResponse>>&
+          batch);
+
+  // Releases the rows of a finished batch and schedules the queued requests
+  // that were waiting on them.
+  void ReleaseRowsAndSchedulePendingBatches(
+      const std::vector<google::scp::core::AsyncContext<
+          ConsumeBudgetsRequest, ConsumeBudgetsResponse>>& batch);
+
+  // Returns the executor running the blocking Spanner transactions.
+  google::scp::core::AsyncExecutorInterface& GetSpannerCallExecutor() {
+    return spanner_call_executor_ ? *spanner_call_executor_
+                                  : *io_async_executor_;
+  }
+
   google::scp::core::ConfigProviderInterface* config_provider_;
   google::scp::core::AsyncExecutorInterface* async_executor_;
   google::scp::core::AsyncExecutorInterface* io_async_executor_;
+  // Runs the blocking Spanner transactions instead of io_async_executor_ if
+  // kSpannerCallExecutorThreadCount is set.
+  std::unique_ptr<google::scp::core::AsyncExecutorInterface>
+      spanner_call_executor_;
   std::shared_ptr<cloud::spanner::Connection> spanner_connection_;
   std::string table_name_;
+
+  // Whether concurrent requests touching the same rows are coalesced into one
+  // Spanner transaction.
+  bool coalescing_enabled_ = false;
+  size_t coalescing_max_batch_size_;
+  std::mutex coalescing_mutex_;
+  // Requests waiting for their rows to be released, in arrival order.
+  std::list<google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                            ConsumeBudgetsResponse>>
+      pending_contexts_;
+  // Rows used by the in-flight coalesced transactions.
+  absl::flat_hash_set<std::string> in_flight_rows_;
 };
 
 }  // namespace google::scp::pbs
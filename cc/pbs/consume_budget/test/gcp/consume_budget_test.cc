@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
 #include "cc/core/async_executor/src/async_executor.h"
 #include "cc/core/config_provider/mock/mock_config_provider.h"
 #include "cc/core/interface/configuration_keys.h"
@@ -46,8 +47,10 @@ using ::google::scp::core::SuccessExecutionResult;
 using ::google::scp::core::config_provider::mock::MockConfigProvider;
 using ::google::scp::core::errors::SC_ASYNC_EXECUTOR_NOT_RUNNING;
 using ::google::scp::core::test::ResultIs;
+using ::google::scp::pbs::kBudgetConsumptionCoalescingEnabled;
 using ::google::scp::pbs::kBudgetKeyTableName;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_FAIL_TO_COMMIT;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_INITIALIZATION_ERROR;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_PARSING_ERROR;
 using ::testing::_;
@@ -57,6 +60,7 @@ using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Field;
 using ::testing::FieldsAre;
+using ::testing::Invoke;
 using ::testing::IsEmpty;
 using ::testing::Return;
 using ::testing::UnorderedElementsAre;
@@ -475,5 +479,178 @@ TEST_F(BudgetConsumptionHelperWithLifecycleTest,
       ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_PARSING_ERROR)));
   EXPECT_THAT(result_context.response->budget_exhausted_indices, IsEmpty());
 }
+
+class BudgetConsumptionHelperWithCoalescingTest
+    : public BudgetConsumptionHelperTest {
+ protected:
+  void SetUp() override {
+    BudgetConsumptionHelperTest::SetUp();
+    mock_config_provider_->Set(kBudgetKeyTableName, std::string(kTableName));
+    mock_config_provider_->SetBool(kBudgetConsumptionCoalescingEnabled, true);
+    ASSERT_SUCCESS(InitAndRunComponents());
+  }
+
+  void TearDown() override {
+    BudgetConsumptionHelperTest::TearDown();
+    ASSERT_SUCCESS(StopComponents());
+  }
+};
+
+TEST_F(BudgetConsumptionHelperWithCoalescingTest,
+       ConcurrentRequestsOnSameRowAreCoalesced) {
+  // The first request reads an empty row. The two requests arriving while it
+  // is in flight are validated independently in one transaction.
+  absl::Notification release_first_read;
+  std::unique_ptr<spanner_mocks::MockResultSetSource> first_source =
+      CreatePbsMockResultSetSource();
+  EXPECT_CALL(*first_source, NextRow()).WillRepeatedly(Return(spanner::Row()));
+  std::unique_ptr<spanner_mocks::MockResultSetSource> second_source =
+      CreatePbsMockResultSetSource();
+  EXPECT_CALL(*second_source, NextRow())
+      .WillOnce(Return(spanner_mocks::MakeRow(
+          {{std::string(kBudgetKeySpannerColumnName),
+            spanner::Value("fake-key-name")},
+           {std::string(kTimeframeSpannerColumnName), spanner::Value("0")},
+           {std::string(kValueSpannerColumnName),
+            spanner::Value(
+                spanner::Json("{\"TokenCount\":\"1 0 1 1 1 1 1 1 1 1 1 1 1 "
+                              "1 1 1 1 1 1 1 1 1 1 1\"}"))}})))
+      .WillRepeatedly(Return(spanner::Row()));
+
+  EXPECT_CALL(*mock_connection_, Read)
+      .WillOnce(Invoke([&](const spanner::Connection::ReadParams&) {
+        release_first_read.WaitForNotification();
+        return spanner::RowStream(std::move(first_source));
+      }))
+      .WillOnce(Invoke([&](const spanner::Connection::ReadParams&) {
+        return spanner::RowStream(std::move(second_source));
+      }));
+
+  spanner::Mutation first_mutation =
+      cloud::spanner::InsertMutationBuilder(
+          std::string(kTableName), {std::string(kBudgetKeySpannerColumnName),
+                                    std::string(kTimeframeSpannerColumnName),
+                                    std::string(kValueSpannerColumnName)})
+          .EmplaceRow(
+              "fake-key-name", "0",
+              spanner::Json("{\"TokenCount\":\"1 0 1 1 1 1 1 1 1 1 1 1 1 "
+                            "1 1 1 1 1 1 1 1 1 1 1\"}"))
+          .Build();
+  spanner::Mutation second_mutation =
+      cloud::spanner::UpdateMutationBuilder(
+          std::string(kTableName), {std::string(kBudgetKeySpannerColumnName),
+                                    std::string(kTimeframeSpannerColumnName),
+                                    std::string(kValueSpannerColumnName)})
+          .EmplaceRow(
+              "fake-key-name", "0",
+              spanner::Json("{\"TokenCount\":\"1 0 0 1 1 1 1 1 1 1 1 1 1 "
+                            "1 1 1 1 1 1 1 1 1 1 1\"}"))
+          .Build();
+  EXPECT_CALL(*mock_connection_,
+              Commit(FieldsAre(_, UnorderedElementsAre(first_mutation), _)))
+      .WillOnce(Return(spanner::CommitResult{}));
+  EXPECT_CALL(*mock_connection_,
+              Commit(FieldsAre(_, UnorderedElementsAre(second_mutation), _)))
+      .WillOnce(Return(spanner::CommitResult{}));
+
+  absl::BlockingCounter blocking(3);
+  std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>
+      contexts(3);
+  std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>
+      result_contexts(3);
+  // Hour 1, hour 1 again and hour 2 of the same day.
+  std::vector<TimeBucket> time_buckets = {3601000000000, 3601000000000,
+                                        7201000000000};
+  for (size_t i = 0; i < contexts.size(); ++i) {
+    contexts[i].request = std::make_shared<ConsumeBudgetsRequest>();
+    contexts[i].request->budgets.push_back(ConsumeBudgetMetadata{
+        std::make_shared<std::string>("fake-key-name"), 1, time_buckets[i]});
+    contexts[i].response = std::make_shared<ConsumeBudgetsResponse>();
+    contexts[i].callback =
+        [&, i](AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+                   context) {
+          result_contexts[i] = context;
+          blocking.DecrementCount();
+        };
+  }
+
+  for (auto& context : contexts) {
+    EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(context));
+  }
+  release_first_read.Notify();
+  blocking.Wait();
+
+  EXPECT_SUCCESS(result_contexts[0].result);
+  EXPECT_THAT(result_contexts[0].response->budget_exhausted_indices,
+              IsEmpty());
+  EXPECT_THAT(result_contexts[1].result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_contexts[1].response->budget_exhausted_indices,
+              ElementsAre(0));
+  EXPECT_SUCCESS(result_contexts[2].result);
+  EXPECT_THAT(result_contexts[2].response->budget_exhausted_indices,
+              IsEmpty());
+}
+
+TEST_F(BudgetConsumptionHelperWithCoalescingTest,
+       CoalescedRequestsFailIfTheReadFails) {
+  // The first request holds the row, so the next two are coalesced into one
+  // transaction whose read fails. None of them consumed any budget.
+  absl::Notification release_first_read;
+  std::unique_ptr<spanner_mocks::MockResultSetSource> first_source =
+      CreatePbsMockResultSetSource();
+  EXPECT_CALL(*first_source, NextRow()).WillRepeatedly(Return(spanner::Row()));
+  std::unique_ptr<spanner_mocks::MockResultSetSource> second_source =
+      CreatePbsMockResultSetSource();
+  EXPECT_CALL(*second_source, NextRow())
+      .WillRepeatedly(Return(cloud::Status(cloud::StatusCode::kPermissionDenied,
+                                           "Read failed.")));
+
+  EXPECT_CALL(*mock_connection_, Read)
+      .WillOnce(Invoke([&](const spanner::Connection::ReadParams&) {
+        release_first_read.WaitForNotification();
+        return spanner::RowStream(std::move(first_source));
+      }))
+      .WillOnce(Invoke([&](const spanner::Connection::ReadParams&) {
+        return spanner::RowStream(std::move(second_source));
+      }));
+  EXPECT_CALL(*mock_connection_, Commit)
+      .WillOnce(Return(spanner::CommitResult{}));
+
+  absl::BlockingCounter blocking(3);
+  std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>
+      contexts(3);
+  std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>
+      result_contexts(3);
+  // Hour 1 for the first request, hours 2 and 3 of the same day for the
+  // coalesced ones.
+  std::vector<TimeBucket> time_buckets = {3601000000000, 7201000000000,
+                                        10801000000000};
+  for (size_t i = 0; i < contexts.size(); ++i) {
+    contexts[i].request = std::make_shared<ConsumeBudgetsRequest>();
+    contexts[i].request->budgets.push_back(ConsumeBudgetMetadata{
+        std::make_shared<std::string>("fake-key-name"), 1, time_buckets[i]});
+    contexts[i].response = std::make_shared<ConsumeBudgetsResponse>();
+    contexts[i].callback =
+        [&, i](AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+                   context) {
+          result_contexts[i] = context;
+          blocking.DecrementCount();
+        };
+  }
+
+  for (auto& context : contexts) {
+    EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(context));
+  }
+  release_first_read.Notify();
+  blocking.Wait();
+
+  EXPECT_SUCCESS(result_contexts[0].result);
+  for (size_t i = 1; i < result_contexts.size(); ++i) {
+    EXPECT_THAT(
+        result_contexts[i].result,
+        ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_FAIL_TO_COMMIT)));
+  }
+}
 }  // namespace
 }  // namespace google::scp::pbs
@@ -144,6 +144,21 @@ class MockFrontEndServiceWithOverrides : public FrontEndService {
     return FrontEndService::BeginTransaction(http_context);
   }
 
+  core::ExecutionResult ConsumeBudgetTransaction(
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>&
+          http_context) noexcept {
+    return FrontEndService::ConsumeBudgetTransaction(http_context);
+  }
+
+  void OnConsumeBudgetTransactionCallback(
+      const std::shared_ptr<cpio::AggregateMetricInterface>& metric_instance,
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>& http_context,
+      core::AsyncContext<core::TransactionRequest, core::TransactionResponse>&
+          transaction_context) noexcept {
+    FrontEndService::OnConsumeBudgetTransactionCallback(
+        metric_instance, http_context, transaction_context);
+  }
+
   core::ExecutionResult PrepareTransaction(
       core::AsyncContext<core::HttpRequest, core::HttpResponse>&
           http_context) noexcept {
@@ -198,6 +213,12 @@ class MockFrontEndServiceWithOverrides : public FrontEndService {
         metric_label);
   }
 
+  core::ExecutionResult BatchGetTransactionStatus(
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>&
+          http_context) noexcept {
+    return FrontEndService::BatchGetTransactionStatus(http_context);
+  }
+
   std::vector<std::shared_ptr<core::TransactionCommand>>
   GenerateConsumeBudgetCommands(
       std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list,
@@ -16,6 +16,7 @@
 
 #include "front_end_service.h"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <list>
@@ -90,6 +91,7 @@ using ::google::scp::cpio::MetricUnit;
 using ::google::scp::pbs::FrontEndUtils;
 using ::opentelemetry::metrics::Counter;
 using ::std::any_of;
+using ::std::atomic;
 using ::std::bind;
 using ::std::dynamic_pointer_cast;
 using ::std::list;
@@ -127,6 +129,7 @@ FrontEndService::FrontEndService(
       config_provider_(config_provider),
       aggregated_metric_interval_ms_(core::kDefaultAggregatedMetricIntervalMs),
       generate_batch_budget_consume_commands_per_day_(false),
+      phase_collapsed_transactions_enabled_(false),
       adtech_site_authorized_domain_enabled_(false) {
   meter_ = opentelemetry::metrics::Provider::GetMeterProvider()->GetMeter(
       "Frontend Service v1", "1.0");
@@ -159,6 +162,7 @@ FrontEndService::FrontEndService(
       config_provider_(config_provider),
       aggregated_metric_interval_ms_(core::kDefaultAggregatedMetricIntervalMs),
       generate_batch_budget_consume_commands_per_day_(false),
+      phase_collapsed_transactions_enabled_(false),
       total_request_counter_(std::move(total_request_counter)),
       client_error_counter_(std::move(client_error_counter)),
       server_error_counter_(std::move(server_error_counter)) {}
@@ -183,11 +187,15 @@ FrontEndService::RegisterAggregateMetric(const string& name,
 }
 
 ExecutionResult FrontEndService::InitMetricInstances() noexcept {
-  list<string> method_names = {
-      kMetricLabelBeginTransaction,    kMetricLabelPrepareTransaction,
-      kMetricLabelCommitTransaction,   kMetricLabelAbortTransaction,
-      kMetricLabelNotifyTransaction,   kMetricLabelEndTransaction,
-      kMetricLabelGetStatusTransaction};
+  list<string> method_names = {kMetricLabelBeginTransaction,
+                               kMetricLabelPrepareTransaction,
+                               kMetricLabelCommitTransaction,
+                               kMetricLabelAbortTransaction,
+                               kMetricLabelNotifyTransaction,
+                               kMetricLabelEndTransaction,
+                               kMetricLabelGetStatusTransaction,
+                               kMetricLabelBatchGetStatusTransaction,
+                               kMetricLabelConsumeBudgetTransaction};
 
   list<string> metric_names = {kMetricNameRequests, kMetricNameClientErrors,
                                kMetricNameServerErrors};
@@ -232,6 +240,13 @@ ExecutionResult FrontEndService::Init() noexcept {
                             remote_coordinator_claimed_identity_);
   RETURN_IF_FAILURE(execution_result);
 
+  if (!config_provider_
+           ->Get(kPhaseCollapsedTransactionsEnabled,
+                 phase_collapsed_transactions_enabled_)
+           .Successful()) {
+    phase_collapsed_transactions_enabled_ = false;
+  }
+
   // TODO: It is required to build a better type of versioned resource
   // handling.
   string begin_transaction_path(kBeginTransactionPath);
@@ -277,6 +292,24 @@ ExecutionResult FrontEndService::Init() noexcept {
                                         get_transaction_status_path,
                                         get_transaction_transaction_handler);
 
+  string batch_get_transaction_status_path(kBatchStatusTransactionPath);
+  HttpHandler batch_get_transaction_status_handler =
+      bind(&FrontEndService::BatchGetTransactionStatus, this, _1);
+  http_server_->RegisterResourceHandler(HttpMethod::POST,
+                                        batch_get_transaction_status_path,
+                                        batch_get_transaction_status_handler);
+
+  if (phase_collapsed_transactions_enabled_) {
+    SCP_INFO(kFrontEndService, kZeroUuid,
+             "Phase collapsed consume budget transactions are enabled");
+    string consume_budget_transaction_path(kConsumeBudgetTransactionPath);
+    HttpHandler consume_budget_transaction_handler =
+        bind(&FrontEndService::ConsumeBudgetTransaction, this, _1);
+    http_server_->RegisterResourceHandler(HttpMethod::POST,
+                                          consume_budget_transaction_path,
+                                          consume_budget_transaction_handler);
+  }
+
   string service_status_path(kServiceStatusPath);
   HttpHandler service_status_handler =
       bind(&FrontEndService::GetServiceStatus, this, _1);
@@ -423,6 +456,18 @@ FrontEndService::GenerateConsumeBudgetCommandsWithBatchesPerDay(
   return generated_commands;
 }
 
+vector<shared_ptr<TransactionCommand>>
+FrontEndService::GenerateConsumeBudgetCommandsForTransaction(
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list,
+    const std::string& transaction_origin, const Uuid& transaction_id) {
+  if (generate_batch_budget_consume_commands_per_day_) {
+    return GenerateConsumeBudgetCommandsWithBatchesPerDay(
+        consume_budget_metadata_list, transaction_origin, transaction_id);
+  }
+  return GenerateConsumeBudgetCommands(consume_budget_metadata_list,
+                                       transaction_origin, transaction_id);
+}
+
 ExecutionResult FrontEndService::BeginTransaction(
     AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
   bool disallow_begin_transaction_request = false;
@@ -529,28 +574,15 @@ ExecutionResult FrontEndService::BeginTransaction(
 
   if (adtech_site_authorized_domain_enabled_) {
     auto transaction_origin = ObtainTransactionOrigin(http_context);
-    if (generate_batch_budget_consume_commands_per_day_) {
-      transaction_context.request->commands =
-          GenerateConsumeBudgetCommandsWithBatchesPerDay(
-              consume_budget_metadata_list, *transaction_origin,
-              transaction_id);
-    } else {
-      transaction_context.request->commands = GenerateConsumeBudgetCommands(
-          consume_budget_metadata_list, *transaction_origin, transaction_id);
-    }
+    transaction_context.request->commands =
+        GenerateConsumeBudgetCommandsForTransaction(
+            consume_budget_metadata_list, *transaction_origin, transaction_id);
   } else {
-    if (generate_batch_budget_consume_commands_per_day_) {
-      transaction_context.request->commands =
-          GenerateConsumeBudgetCommandsWithBatchesPerDay(
-              consume_budget_metadata_list,
-              *http_context.request->auth_context.authorized_domain,
-              transaction_id);
-    } else {
-      transaction_context.request->commands = GenerateConsumeBudgetCommands(
-          consume_budget_metadata_list,
-          *http_context.request->auth_context.authorized_domain,
-          transaction_id);
-    }
+    transaction_context.request->commands =
+        GenerateConsumeBudgetCommandsForTransaction(
+            consume_budget_metadata_list,
+            *http_context.request->auth_context.authorized_domain,
+            transaction_id);
   }
 
   transaction_context.request->is_coordinated_remotely = true;
@@ -583,6 +615,129 @@ ExecutionResult FrontEndService::BeginTransaction(
   return execution_result;
 }
 
+ExecutionResult FrontEndService::ConsumeBudgetTransaction(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  bool disallow_new_transaction_request = false;
+  auto execution_result = config_provider_->Get(
+      kDisallowNewTransactionRequests, disallow_new_transaction_request);
+  if (!execution_result.Successful()) {
+    disallow_new_transaction_request = false;
+  }
+
+  if (disallow_new_transaction_request) {
+    return FailureExecutionResult(
+        core::errors::SC_PBS_FRONT_END_SERVICE_BEGIN_TRANSACTION_DISALLOWED);
+  }
+
+  const auto& total_request_metrics_instance =
+      metrics_instances_map_.at(kMetricLabelConsumeBudgetTransaction)
+          .at(kMetricNameRequests);
+  const auto& client_error_metrics_instance =
+      metrics_instances_map_.at(kMetricLabelConsumeBudgetTransaction)
+          .at(kMetricNameClientErrors);
+  const string reporting_origin_metric_label =
+      FrontEndUtils::FrontEndUtils::GetReportingOriginMetricLabel(
+          http_context.request, remote_coordinator_claimed_identity_);
+  total_request_metrics_instance->Increment(reporting_origin_metric_label);
+
+  const absl::flat_hash_map<std::string, std::string>
+      consume_budget_transaction_label_kv = {
+          {kMetricLabelTransactionPhase, kMetricLabelConsumeBudgetTransaction},
+          {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label}};
+
+  total_request_counter_->Add(1, consume_budget_transaction_label_kv);
+
+  Uuid transaction_id;
+  execution_result = FrontEndUtils::ExtractTransactionId(
+      http_context.request->headers, transaction_id);
+  if (!execution_result.Successful()) {
+    client_error_metrics_instance->Increment(reporting_origin_metric_label);
+    client_error_counter_->Add(1, consume_budget_transaction_label_kv);
+    return execution_result;
+  }
+
+  string transaction_secret;
+  execution_result = FrontEndUtils::ExtractTransactionSecret(
+      http_context.request->headers, transaction_secret);
+  if (!execution_result.Successful()) {
+    client_error_metrics_instance->Increment(reporting_origin_metric_label);
+    client_error_counter_->Add(1, consume_budget_transaction_label_kv);
+    return execution_result;
+  }
+
+  // Transaction origin must be the one authorized with the system.
+  auto transaction_origin =
+      adtech_site_authorized_domain_enabled_
+          ? ObtainTransactionOrigin(http_context)
+          : http_context.request->auth_context.authorized_domain;
+
+  std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
+  if (adtech_site_authorized_domain_enabled_) {
+    execution_result = ParseBeginTransactionRequestBody(
+        *http_context.request->auth_context.authorized_domain,
+        *transaction_origin, http_context.request->body,
+        consume_budget_metadata_list);
+  } else {
+    execution_result = ParseBeginTransactionRequestBody(
+        *http_context.request->auth_context.authorized_domain,
+        http_context.request->body, consume_budget_metadata_list);
+  }
+
+  if (!execution_result.Successful()) {
+    client_error_metrics_instance->Increment(reporting_origin_metric_label);
+    client_error_counter_->Add(1, consume_budget_transaction_label_kv);
+    return execution_result;
+  }
+
+  if (consume_budget_metadata_list.size() == 0) {
+    client_error_metrics_instance->Increment(reporting_origin_metric_label);
+    client_error_counter_->Add(1, consume_budget_transaction_label_kv);
+    return FailureExecutionResult(
+        core::errors::SC_PBS_FRONT_END_SERVICE_NO_KEYS_AVAILABLE);
+  }
+
+  auto transaction_id_string = ToString(transaction_id);
+  SCP_DEBUG_CONTEXT(kFrontEndService, http_context,
+                    "Starting phase collapsed Transaction: %s Total Keys: %lld",
+                    transaction_id_string.c_str(),
+                    consume_budget_metadata_list.size());
+
+  auto const& server_error_metrics_instance =
+      metrics_instances_map_.at(kMetricLabelConsumeBudgetTransaction)
+          .at(kMetricNameServerErrors);
+  AsyncContext<TransactionRequest, TransactionResponse> transaction_context(
+      make_shared<TransactionRequest>(),
+      bind(&FrontEndService::OnConsumeBudgetTransactionCallback, this,
+           server_error_metrics_instance, http_context, _1),
+      http_context);
+
+  transaction_context.request->commands =
+      GenerateConsumeBudgetCommandsForTransaction(
+          consume_budget_metadata_list, *transaction_origin, transaction_id);
+  // All the phases are executed by the Transaction Manager of this service
+  // without any round trips with the client.
+  transaction_context.request->is_coordinated_remotely = false;
+  transaction_context.request->is_phase_collapsed = true;
+  transaction_context.request->transaction_secret =
+      make_shared<string>(transaction_secret);
+  transaction_context.request->transaction_origin = transaction_origin;
+  transaction_context.request->timeout_time =
+      (TimeProvider::GetSteadyTimestampInNanoseconds() +
+       milliseconds(kTransactionTimeoutMs))
+          .count();
+  transaction_context.request->transaction_id = transaction_id;
+
+  execution_result = transaction_request_router_->Execute(transaction_context);
+  if (!execution_result.Successful()) {
+    SCP_ERROR_CONTEXT(kFrontEndService, http_context, execution_result,
+                      "Failed to execute transaction %s",
+                      transaction_id_string.c_str());
+    client_error_metrics_instance->Increment(reporting_origin_metric_label);
+    client_error_counter_->Add(1, consume_budget_transaction_label_kv);
+  }
+  return execution_result;
+}
+
 ExecutionResult FrontEndService::PrepareTransaction(
     AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
   auto const& total_request_metrics_instance =
@@ -1027,6 +1182,82 @@ ExecutionResult FrontEndService::GetTransactionStatus(
   return execution_result;
 }
 
+ExecutionResult FrontEndService::BatchGetTransactionStatus(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  auto const& total_request_metrics_instance =
+      metrics_instances_map_.at(kMetricLabelBatchGetStatusTransaction)
+          .at(kMetricNameRequests);
+  auto const& client_error_metrics_instance =
+      metrics_instances_map_.at(kMetricLabelBatchGetStatusTransaction)
+          .at(kMetricNameClientErrors);
+  const string reporting_origin_metric_label =
+      FrontEndUtils::FrontEndUtils::GetReportingOriginMetricLabel(
+          http_context.request, remote_coordinator_claimed_identity_);
+  total_request_metrics_instance->Increment(reporting_origin_metric_label);
+
+  const absl::flat_hash_map<std::string, std::string>
+      transaction_status_label_kv = {
+          {kMetricLabelTransactionStatus,
+           kMetricLabelBatchGetStatusTransaction},
+          {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label}};
+
+  total_request_counter_->Add(1, transaction_status_label_kv);
+
+  vector<shared_ptr<GetTransactionStatusRequest>> items;
+  auto execution_result =
+      FrontEndUtils::DeserializeBatchGetTransactionStatusRequest(
+          http_context.request->body, items);
+  if (execution_result.Successful() &&
+      (items.empty() || items.size() > kMaxBatchStatusTransactionItems)) {
+    execution_result = FailureExecutionResult(
+        core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+  }
+  if (!execution_result.Successful()) {
+    client_error_metrics_instance->Increment(reporting_origin_metric_label);
+    client_error_counter_->Add(1, transaction_status_label_kv);
+    return execution_result;
+  }
+
+  SCP_DEBUG_CONTEXT(kFrontEndService, http_context,
+                    "Executing GetTransactionStatus for %llu transactions",
+                    items.size());
+
+  auto batch_response = make_shared<BatchGetTransactionStatusResponse>();
+  batch_response->item_results.resize(
+      items.size(),
+      FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST));
+  batch_response->items.resize(items.size());
+  auto pending_items_count = make_shared<atomic<size_t>>(items.size());
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    // As for a single transaction, the transaction origin in the request is
+    // used if a peer coordinator is resolving a transaction on behalf of a
+    // client.
+    auto& transaction_origin = items[i]->transaction_origin;
+    if (!transaction_origin || transaction_origin->empty()) {
+      transaction_origin = http_context.request->auth_context.authorized_domain;
+    }
+
+    AsyncContext<GetTransactionStatusRequest, GetTransactionStatusResponse>
+        get_transaction_status_context(
+            items[i],
+            bind(&FrontEndService::OnBatchGetTransactionStatusItemCallback,
+                 this, http_context, batch_response, pending_items_count, i,
+                 _1),
+            http_context);
+    execution_result =
+        transaction_request_router_->Execute(get_transaction_status_context);
+    if (!execution_result.Successful()) {
+      get_transaction_status_context.result = execution_result;
+      OnBatchGetTransactionStatusItemCallback(
+          http_context, batch_response, pending_items_count, i,
+          get_transaction_status_context);
+    }
+  }
+  return SuccessExecutionResult();
+}
+
 /**
  * @brief Returns true any of the provided commands list is a batch
  * command
@@ -1386,6 +1617,44 @@ void FrontEndService::OnGetTransactionStatusCallback(
   http_context.Finish();
 }
 
+void FrontEndService::OnBatchGetTransactionStatusItemCallback(
+    AsyncContext<HttpRequest, HttpResponse>& http_context,
+    const shared_ptr<BatchGetTransactionStatusResponse>& batch_response,
+    const shared_ptr<atomic<size_t>>& pending_items_count,
+    size_t item_index,
+    AsyncContext<GetTransactionStatusRequest, GetTransactionStatusResponse>&
+        get_transaction_status_context) noexcept {
+  // Every index is written by a single callback, and the release of the
+  // decrement below publishes it to the callback finishing the batch.
+  batch_response->item_results[item_index] =
+      get_transaction_status_context.result;
+  if (get_transaction_status_context.result.Successful()) {
+    batch_response->items[item_index] =
+        get_transaction_status_context.response;
+  }
+  if (pending_items_count->fetch_sub(1) != 1) {
+    return;
+  }
+
+  http_context.result =
+      FrontEndUtils::SerializeBatchGetTransactionStatusResponse(
+          *batch_response, http_context.response->body);
+  if (!http_context.result.Successful()) {
+    const string reporting_origin_metric_label =
+        FrontEndUtils::FrontEndUtils::GetReportingOriginMetricLabel(
+            http_context.request, remote_coordinator_claimed_identity_);
+    const absl::flat_hash_map<std::string, std::string> transaction_label_kv =
+        {{kMetricLabelTransactionStatus,
+          kMetricLabelBatchGetStatusTransaction},
+         {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label}};
+    metrics_instances_map_.at(kMetricLabelBatchGetStatusTransaction)
+        .at(kMetricNameServerErrors)
+        ->Increment(reporting_origin_metric_label);
+    server_error_counter_->Add(1, transaction_label_kv);
+  }
+  http_context.Finish();
+}
+
 ExecutionResult FrontEndService::ExecuteConsumeBudgetTransaction(
     AsyncContext<ConsumeBudgetTransactionRequest,
                  ConsumeBudgetTransactionResponse>&
@@ -1433,4 +1702,63 @@ void FrontEndService::OnExecuteConsumeBudgetTransactionCallback(
   consume_budget_transaction_context.Finish();
 }
 
+void FrontEndService::OnConsumeBudgetTransactionCallback(
+    const shared_ptr<AggregateMetricInterface>& metrics_instance,
+    AsyncContext<HttpRequest, HttpResponse>& http_context,
+    AsyncContext<TransactionRequest, TransactionResponse>&
+        transaction_context) noexcept {
+  const string reporting_origin_metric_label =
+      FrontEndUtils::FrontEndUtils::GetReportingOriginMetricLabel(
+          http_context.request, remote_coordinator_claimed_identity_);
+  auto transaction_id_string =
+      ToString(transaction_context.request->transaction_id);
+
+  if (!transaction_context.result.Successful()) {
+    SCP_ERROR_CONTEXT(kFrontEndService, http_context,
+                      transaction_context.result,
+                      "Phase collapsed transaction failed: %s",
+                      transaction_id_string.c_str());
+
+    if (transaction_context.result.status == core::ExecutionStatus::Failure &&
+        transaction_context.response) {
+      auto local_execution_result =
+          SerializeTransactionFailedCommandIndicesResponse(
+              transaction_context.response->failed_commands_indices,
+              transaction_context.response->failed_commands,
+              http_context.response->body);
+      if (!local_execution_result.Successful()) {
+        // Not returned to the client, see OnTransactionCallback.
+        SCP_ERROR_CONTEXT(kFrontEndService, http_context,
+                          local_execution_result,
+                          "Serialization of the transaction response failed");
+      }
+    }
+
+    const absl::flat_hash_map<std::string, std::string> transaction_label_kv =
+        {{kMetricLabelTransactionPhase, kMetricLabelConsumeBudgetTransaction},
+         {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label}};
+    metrics_instance->Increment(reporting_origin_metric_label);
+    server_error_counter_->Add(1, transaction_label_kv);
+    http_context.result = transaction_context.result;
+    http_context.Finish();
+    return;
+  }
+
+  static string transaction_id_header(kTransactionIdHeader);
+  static string transaction_last_execution_timestamp(
+      kTransactionLastExecutionTimestampHeader);
+  http_context.response->headers->insert(
+      {transaction_id_header, transaction_id_string});
+  http_context.response->headers->insert(
+      {transaction_last_execution_timestamp,
+       to_string(transaction_context.response->last_execution_timestamp)});
+
+  SCP_DEBUG_CONTEXT(kFrontEndService, http_context,
+                    "Phase collapsed transaction completed: %s",
+                    transaction_id_string.c_str());
+
+  http_context.result = SuccessExecutionResult();
+  http_context.Finish();
+}
+
 }  // namespace google::scp::pbs
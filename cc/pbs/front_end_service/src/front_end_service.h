@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -32,6 +33,7 @@
 #include "opentelemetry/metrics/meter.h"
 #include "opentelemetry/metrics/provider.h"
 #include "pbs/interface/front_end_service_interface.h"
+#include "pbs/interface/pbs_client_interface.h"
 #include "pbs/transactions/src/consume_budget_command_factory_interface.h"
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/interface/metric_client/metric_client_interface.h"
@@ -174,6 +176,21 @@ class FrontEndService : public FrontEndServiceInterface {
       core::AsyncContext<core::TransactionRequest, core::TransactionResponse>&
           transaction_context) noexcept;
 
+  /**
+   * @brief Is called when the phase collapsed consume budget transaction is
+   * completed.
+   *
+   * @param metric_instance The metric instance used to track the execution
+   * status.
+   * @param http_context The http context of the operation.
+   * @param transaction_context The transaction context of the operation.
+   */
+  virtual void OnConsumeBudgetTransactionCallback(
+      const std::shared_ptr<cpio::AggregateMetricInterface>& metric_instance,
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>& http_context,
+      core::AsyncContext<core::TransactionRequest, core::TransactionResponse>&
+          transaction_context) noexcept;
+
   /**
    * @brief Executes the begin transaction phase.
    *
@@ -234,6 +251,18 @@ class FrontEndService : public FrontEndServiceInterface {
       core::AsyncContext<core::HttpRequest, core::HttpResponse>&
           http_context) noexcept;
 
+  /**
+   * @brief Executes all the phases of a consume budget transaction in one
+   * request, for deployments where this service is the only coordinator. Only
+   * the transaction, its commit decision and its end are journaled.
+   *
+   * @param http_context The http context of the operation.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  core::ExecutionResult ConsumeBudgetTransaction(
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>&
+          http_context) noexcept;
+
   /**
    * @brief Gets the current transactions status.
    *
@@ -276,6 +305,38 @@ class FrontEndService : public FrontEndServiceInterface {
           get_transaction_status_context,
       const std::string& metric_label) noexcept;
 
+  /**
+   * @brief Executes the get transaction status of multiple transactions in one
+   * request, e.g. for a peer coordinator resolving stale transactions. The
+   * response body has the result of every transaction in the request order.
+   *
+   * @param http_context The http context of the operation.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  core::ExecutionResult BatchGetTransactionStatus(
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>&
+          http_context) noexcept;
+
+  /**
+   * @brief Is called when the get transaction status of an item of a batch is
+   * completed. The http context is finished once all the items are completed.
+   *
+   * @param http_context The http context of the operation.
+   * @param batch_response The response of the batch, shared by the items.
+   * @param pending_items_count The number of items not yet completed.
+   * @param item_index The index of the item in the batch.
+   * @param get_transaction_status_context The context of the get transaction
+   * status operation of the item.
+   */
+  void OnBatchGetTransactionStatusItemCallback(
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>& http_context,
+      const std::shared_ptr<BatchGetTransactionStatusResponse>& batch_response,
+      const std::shared_ptr<std::atomic<size_t>>& pending_items_count,
+      size_t item_index,
+      core::AsyncContext<core::GetTransactionStatusRequest,
+                         core::GetTransactionStatusResponse>&
+          get_transaction_status_context) noexcept;
+
   /**
    * @brief Generate one command per budget to consume
    *
@@ -304,6 +365,21 @@ class FrontEndService : public FrontEndServiceInterface {
       const std::string& authorized_domain,
       const core::common::Uuid& transaction_id);
 
+  /**
+   * @brief Generate the commands to consume the budgets of a transaction, with
+   * or without batches per day depending on the configuration.
+   *
+   * @param consume_budget_metadata_list
+   * @param transaction_origin
+   * @param transaction_id
+   * @return std::vector<std::shared_ptr<core::TransactionCommand>>
+   */
+  std::vector<std::shared_ptr<core::TransactionCommand>>
+  GenerateConsumeBudgetCommandsForTransaction(
+      std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list,
+      const std::string& transaction_origin,
+      const core::common::Uuid& transaction_id);
+
   /**
    * @brief Helper to obtain transaction origin from HTTP Request
    *
@@ -349,6 +425,9 @@ class FrontEndService : public FrontEndServiceInterface {
   /// Enable generating batch budget consume commands per day
   bool generate_batch_budget_consume_commands_per_day_;
 
+  /// Enable the phase collapsed consume budget transaction endpoint.
+  bool phase_collapsed_transactions_enabled_;
+
   /// The claimed-identity string of the remote coordinator. This value is
   /// present in the requests coming from the remote coordinator and can be
   /// used to identify such requests.
@@ -40,6 +40,7 @@
 #include "opentelemetry/metrics/sync_instruments.h"
 #include "pbs/budget_key_timeframe_manager/src/budget_key_timeframe_utils.h"
 #include "pbs/interface/front_end_service_interface.h"
+#include "pbs/interface/pbs_client_interface.h"
 #include "pbs/interface/type_def.h"
 #include "public/core/interface/execution_result.h"
 
@@ -230,7 +231,19 @@ class FrontEndUtils {
     try {
       auto get_transaction_status = nlohmann::json::parse(
           response_body.bytes->begin(), response_body.bytes->end());
+      return DeserializeGetTransactionStatus(get_transaction_status,
+                                             get_transaction_status_response);
+    } catch (...) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_RESPONSE_BODY);
+    }
+  }
 
+  static core::ExecutionResult DeserializeGetTransactionStatus(
+      const nlohmann::json& get_transaction_status,
+      std::shared_ptr<core::GetTransactionStatusResponse>&
+          get_transaction_status_response) noexcept {
+    try {
       if (get_transaction_status.find("is_expired") ==
               get_transaction_status.end() ||
           get_transaction_status.find("has_failures") ==
@@ -272,6 +285,23 @@ class FrontEndUtils {
       const std::shared_ptr<core::GetTransactionStatusResponse>& response,
       core::BytesBuffer& request_body) noexcept {
     nlohmann::json json_response;
+    auto execution_result =
+        SerializeGetTransactionStatus(response, json_response);
+    if (execution_result != core::SuccessExecutionResult()) {
+      return execution_result;
+    }
+
+    auto body = json_response.dump();
+    request_body.capacity = body.length();
+    request_body.length = body.length();
+    request_body.bytes =
+        std::make_shared<std::vector<core::Byte>>(body.begin(), body.end());
+    return core::SuccessExecutionResult();
+  }
+
+  static core::ExecutionResult SerializeGetTransactionStatus(
+      const std::shared_ptr<core::GetTransactionStatusResponse>& response,
+      nlohmann::json& json_response) noexcept {
     json_response["is_expired"] = response->is_expired;
     json_response["has_failures"] = response->has_failure;
     json_response["last_execution_timestamp"] =
@@ -285,7 +315,37 @@ class FrontEndUtils {
     }
 
     json_response["transaction_execution_phase"] = transaction_execution_phase;
-    auto body = json_response.dump();
+    return core::SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Serializes the transactions of a batch get transaction status
+   * request into the request body, e.g.
+   * {"v": "1.0", "t": [{"transaction_id": "...", "transaction_secret": "...",
+   * "transaction_origin": "..."}]}. The transaction origin is optional.
+   */
+  static core::ExecutionResult SerializeBatchGetTransactionStatusRequest(
+      const BatchGetTransactionStatusRequest& request,
+      core::BytesBuffer& request_body) noexcept {
+    nlohmann::json json_request;
+    json_request["v"] = "1.0";
+    json_request["t"] = nlohmann::json::array();
+    for (const auto& item : request.items) {
+      if (!item || !item->transaction_secret) {
+        return core::FailureExecutionResult(
+            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+      }
+      nlohmann::json json_item;
+      json_item["transaction_id"] =
+          core::common::ToString(item->transaction_id);
+      json_item["transaction_secret"] = *item->transaction_secret;
+      if (item->transaction_origin) {
+        json_item["transaction_origin"] = *item->transaction_origin;
+      }
+      json_request["t"].push_back(json_item);
+    }
+
+    auto body = json_request.dump();
     request_body.capacity = body.length();
     request_body.length = body.length();
     request_body.bytes =
@@ -293,6 +353,146 @@ class FrontEndUtils {
     return core::SuccessExecutionResult();
   }
 
+  static core::ExecutionResult DeserializeBatchGetTransactionStatusRequest(
+      const core::BytesBuffer& request_body,
+      std::vector<std::shared_ptr<core::GetTransactionStatusRequest>>&
+          items) noexcept {
+    if (!request_body.bytes || request_body.length == 0) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+    }
+
+    try {
+      auto json_request = nlohmann::json::parse(
+          request_body.bytes->begin(),
+          request_body.bytes->begin() + request_body.length);
+      if (json_request.find("v") == json_request.end() ||
+          json_request["v"].get<std::string>() != "1.0" ||
+          json_request.find("t") == json_request.end() ||
+          !json_request["t"].is_array()) {
+        return core::FailureExecutionResult(
+            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+      }
+
+      for (const auto& json_item : json_request["t"]) {
+        if (json_item.find("transaction_id") == json_item.end() ||
+            json_item.find("transaction_secret") == json_item.end()) {
+          return core::FailureExecutionResult(
+              core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+        }
+
+        auto item = std::make_shared<core::GetTransactionStatusRequest>();
+        auto execution_result = core::common::FromString(
+            json_item["transaction_id"].get<std::string>(),
+            item->transaction_id);
+        if (!execution_result.Successful()) {
+          return core::FailureExecutionResult(
+              core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+        }
+        item->transaction_secret = std::make_shared<std::string>(
+            json_item["transaction_secret"].get<std::string>());
+        if (json_item.find("transaction_origin") != json_item.end()) {
+          item->transaction_origin = std::make_shared<std::string>(
+              json_item["transaction_origin"].get<std::string>());
+        }
+        items.push_back(std::move(item));
+      }
+    } catch (...) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+    }
+
+    return core::SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Serializes the results of a batch get transaction status into the
+   * response body, e.g. {"v": "1.0", "t": [{"status": 0, "status_code": 0,
+   * "is_expired": false, ...}]}. The status of the transaction is only set on
+   * the items which succeeded.
+   */
+  static core::ExecutionResult SerializeBatchGetTransactionStatusResponse(
+      const BatchGetTransactionStatusResponse& response,
+      core::BytesBuffer& response_body) noexcept {
+    if (response.item_results.size() != response.items.size()) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_RESPONSE_BODY);
+    }
+
+    nlohmann::json json_response;
+    json_response["v"] = "1.0";
+    json_response["t"] = nlohmann::json::array();
+    for (size_t i = 0; i < response.items.size(); ++i) {
+      nlohmann::json json_item;
+      if (response.item_results[i].Successful() && response.items[i]) {
+        auto execution_result =
+            SerializeGetTransactionStatus(response.items[i], json_item);
+        if (!execution_result.Successful()) {
+          return execution_result;
+        }
+      }
+      json_item["status"] =
+          static_cast<int>(response.item_results[i].status);
+      json_item["status_code"] = response.item_results[i].status_code;
+      json_response["t"].push_back(json_item);
+    }
+
+    auto body = json_response.dump();
+    response_body.capacity = body.length();
+    response_body.length = body.length();
+    response_body.bytes =
+        std::make_shared<std::vector<core::Byte>>(body.begin(), body.end());
+    return core::SuccessExecutionResult();
+  }
+
+  static core::ExecutionResult DeserializeBatchGetTransactionStatusResponse(
+      const core::BytesBuffer& response_body,
+      BatchGetTransactionStatusResponse& response) noexcept {
+    if (!response_body.bytes) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_RESPONSE_BODY);
+    }
+
+    try {
+      auto json_response = nlohmann::json::parse(
+          response_body.bytes->begin(),
+          response_body.bytes->begin() + response_body.length);
+      if (json_response.find("t") == json_response.end() ||
+          !json_response["t"].is_array()) {
+        return core::FailureExecutionResult(
+            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_RESPONSE_BODY);
+      }
+
+      for (const auto& json_item : json_response["t"]) {
+        if (json_item.find("status") == json_item.end() ||
+            json_item.find("status_code") == json_item.end()) {
+          return core::FailureExecutionResult(
+              core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_RESPONSE_BODY);
+        }
+
+        core::ExecutionResult item_result(
+            static_cast<core::ExecutionStatus>(json_item["status"].get<int>()),
+            json_item["status_code"].get<core::StatusCode>());
+        std::shared_ptr<core::GetTransactionStatusResponse> item;
+        if (item_result.Successful()) {
+          item = std::make_shared<core::GetTransactionStatusResponse>();
+          auto execution_result =
+              DeserializeGetTransactionStatus(json_item, item);
+          if (!execution_result.Successful()) {
+            return execution_result;
+          }
+        }
+        response.item_results.push_back(item_result);
+        response.items.push_back(std::move(item));
+      }
+    } catch (...) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_RESPONSE_BODY);
+    }
+
+    return core::SuccessExecutionResult();
+  }
+
   static core::ExecutionResult ToString(
       core::TransactionExecutionPhase transaction_execution_phase,
       std::string& output) noexcept {
@@ -40,6 +40,7 @@
 #include "cc/core/test/utils/conditional_wait.h"
 #include "cc/pbs/front_end_service/mock/mock_front_end_service_with_overrides.h"
 #include "cc/pbs/front_end_service/src/error_codes.h"
+#include "cc/pbs/front_end_service/src/front_end_utils.h"
 #include "cc/pbs/interface/configuration_keys.h"
 #include "cc/pbs/partition_request_router/mock/mock_transaction_request_router.h"
 #include "cc/pbs/transactions/mock/mock_consume_budget_command_factory.h"
@@ -84,6 +85,7 @@ using ::google::scp::core::TransactionPhaseResponse;
 using ::google::scp::core::TransactionRequest;
 using ::google::scp::core::TransactionResponse;
 using ::google::scp::core::async_executor::mock::MockAsyncExecutor;
+using ::google::scp::core::common::ToString;
 using ::google::scp::core::common::Uuid;
 using ::google::scp::core::config_provider::mock::MockConfigProvider;
 using ::google::scp::core::http2_server::mock::MockHttp2Server;
@@ -991,6 +993,141 @@ TEST_F(FrontEndServiceTest, OnTransactionCallback) {
   }
 }
 
+TEST_F(FrontEndServiceTest, ConsumeBudgetTransactionValidBody) {
+  auto mock_metric_client = std::make_shared<MockMetricClient>();
+  auto mock_config_provider = std::make_shared<MockConfigProvider>();
+  mock_config_provider->SetBool(
+      "google_scp_pbs_adtech_site_as_authorized_domain_enabled", false);
+  mock_config_provider->SetBool(pbs::kPhaseCollapsedTransactionsEnabled, true);
+
+  auto mock_transaction_request_router = GetMockTransactionRequestRouter();
+  std::shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      make_shared<MockAsyncExecutor>();
+
+  atomic<bool> condition = false;
+  EXPECT_CALL(
+      *mock_transaction_request_router,
+      Execute(An<AsyncContext<TransactionRequest, TransactionResponse>&>()))
+      .WillOnce([&](AsyncContext<TransactionRequest, TransactionResponse>&
+                        transaction_context) {
+        EXPECT_EQ(transaction_context.request->commands.size(), 2);
+        EXPECT_FALSE(transaction_context.request->is_coordinated_remotely);
+        EXPECT_TRUE(transaction_context.request->is_phase_collapsed);
+        EXPECT_NE(transaction_context.request->timeout_time, 0);
+        EXPECT_EQ(ToString(transaction_context.request->transaction_id),
+                  "3E2A3D09-48ED-A355-D346-AD7DC6CB0909");
+        EXPECT_EQ(*transaction_context.request->transaction_secret,
+                  "transaction_secret");
+        EXPECT_EQ(*transaction_context.request->transaction_origin,
+                  "https://origin.foo.com");
+        condition = true;
+        return SuccessExecutionResult();
+      });
+
+  std::unique_ptr<ConsumeBudgetCommandFactoryInterface>
+      consume_budget_command_factory = GetMockConsumeBudgetCommandFactory();
+  std::shared_ptr<HttpServerInterface> http2_server =
+      std::make_shared<MockHttp2Server>();
+  MockFrontEndServiceWithOverrides front_end_service(
+      http2_server, mock_async_executor,
+      std::move(mock_transaction_request_router),
+      std::move(consume_budget_command_factory), mock_metric_client,
+      mock_config_provider);
+
+  front_end_service.Init();
+  front_end_service.InitMetricInstances();
+
+  AsyncContext<HttpRequest, HttpResponse> http_context;
+  http_context.request = std::make_shared<HttpRequest>();
+  http_context.request->headers = std::make_shared<HttpHeaders>();
+  http_context.request->auth_context.authorized_domain =
+      std::make_shared<string>("https://origin.foo.com");
+  http_context.request->headers->insert(
+      {std::string(kTransactionIdHeader),
+       "3E2A3D09-48ED-A355-D346-AD7DC6CB0909"});
+  http_context.request->headers->insert({std::string(kTransactionSecretHeader),
+                                         std::string("transaction_secret")});
+  EXPECT_EQ(
+      front_end_service.ConsumeBudgetTransaction(http_context),
+      FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
+
+  string body_string = GetBeginTransactionHttpRequestBody_Sample();
+  http_context.request->body.bytes =
+      std::make_shared<vector<Byte>>(body_string.begin(), body_string.end());
+  http_context.request->body.capacity = body_string.length();
+  http_context.request->body.length = body_string.length();
+  EXPECT_EQ(front_end_service.ConsumeBudgetTransaction(http_context),
+            SuccessExecutionResult());
+  WaitUntil([&]() { return condition.load(); });
+
+  auto total_request_metric_instance = front_end_service.GetMetricsInstance(
+      kMetricLabelConsumeBudgetTransaction, kMetricNameRequests);
+  auto client_errors_metric_instance = front_end_service.GetMetricsInstance(
+      kMetricLabelConsumeBudgetTransaction, kMetricNameClientErrors);
+  EXPECT_EQ(
+      total_request_metric_instance->GetCounter(kMetricLabelValueOperator), 2);
+  EXPECT_EQ(
+      client_errors_metric_instance->GetCounter(kMetricLabelValueOperator), 1);
+}
+
+TEST_F(FrontEndServiceTest, OnConsumeBudgetTransactionCallback) {
+  AsyncContext<TransactionRequest, TransactionResponse> transaction_context;
+  transaction_context.request = make_shared<TransactionRequest>();
+  transaction_context.request->transaction_id = Uuid::GenerateUuid();
+  transaction_context.response = make_shared<TransactionResponse>();
+  transaction_context.response->transaction_id =
+      transaction_context.request->transaction_id;
+  transaction_context.response->failed_commands_indices = {1, 3};
+  transaction_context.response->last_execution_timestamp = 1234567;
+
+  vector<ExecutionResult> results = {SuccessExecutionResult(),
+                                     FailureExecutionResult(123),
+                                     RetryExecutionResult(123)};
+  vector<size_t> expected_server_error_metrics = {0, 1, 1};
+
+  for (int i = 0; i < results.size(); i++) {
+    auto result = results[i];
+    atomic<bool> condition = false;
+    AsyncContext<HttpRequest, HttpResponse> http_context;
+    http_context.response = make_shared<HttpResponse>();
+    http_context.request = make_shared<HttpRequest>();
+    http_context.request->headers = make_shared<HttpHeaders>();
+    http_context.request->auth_context.authorized_domain =
+        make_shared<string>("origin");
+    http_context.response->headers = make_shared<core::HttpHeaders>();
+    http_context.callback =
+        [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+          EXPECT_THAT(http_context.result, ResultIs(result));
+          if (result.Successful()) {
+            EXPECT_EQ(http_context.response->headers
+                          ->find(kTransactionIdHeader)
+                          ->second,
+                      ToString(transaction_context.request->transaction_id));
+            EXPECT_EQ(http_context.response->headers
+                          ->find(kTransactionLastExecutionTimestampHeader)
+                          ->second,
+                      "1234567");
+          } else if (result.status == core::ExecutionStatus::Failure) {
+            string body(http_context.response->body.bytes->begin(),
+                        http_context.response->body.bytes->end());
+            EXPECT_EQ(body, R"({"f":[1,3],"v":"1.0"})");
+          } else {
+            EXPECT_EQ(http_context.response->body.length, 0);
+          }
+          condition = true;
+        };
+
+    transaction_context.result = result;
+    auto mock_metric_transaction = make_shared<MockAggregateMetric>();
+    front_end_service_->OnConsumeBudgetTransactionCallback(
+        mock_metric_transaction, http_context, transaction_context);
+    WaitUntil([&]() { return condition.load(); });
+    EXPECT_EQ(mock_metric_transaction->GetCounter(kMetricLabelValueOperator),
+              expected_server_error_metrics[i]);
+  }
+}
+
 TEST_F(FrontEndServiceTest, OnTransactionCallbackWithBatchCommands) {
   // Create Batch
   auto batch_budgets1 = GetBatchBudgetConsumptions_Sample1();
@@ -1883,6 +2020,127 @@ TEST_F(FrontEndServiceTest, OnGetTransactionStatusCallback) {
   WaitUntil([&]() { return called.load(); });
 }
 
+TEST_F(FrontEndServiceTest, BatchGetTransactionStatus) {
+  auto mock_metric_client = make_shared<MockMetricClient>();
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  auto mock_transaction_request_router = GetMockTransactionRequestRouter();
+  auto mock_transaction_request_router_copy =
+      mock_transaction_request_router.get();
+  shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      make_shared<MockAsyncExecutor>();
+  std::unique_ptr<ConsumeBudgetCommandFactoryInterface>
+      consume_budget_command_factory = GetMockConsumeBudgetCommandFactory();
+  shared_ptr<HttpServerInterface> http2_server = make_shared<MockHttp2Server>();
+
+  auto total_request_counter = std::make_unique<MockCounter<uint64_t>>();
+  auto client_error_counter = std::make_unique<MockCounter<uint64_t>>();
+  auto server_error_counter = std::make_unique<MockCounter<uint64_t>>();
+  EXPECT_CALL(
+      *total_request_counter,
+      Add(1, testing::A<const opentelemetry::common::KeyValueIterable&>()))
+      .Times(2);
+  EXPECT_CALL(
+      *client_error_counter,
+      Add(1, testing::A<const opentelemetry::common::KeyValueIterable&>()))
+      .Times(1);
+
+  MockFrontEndServiceWithOverrides front_end_service(
+      http2_server, mock_async_executor,
+      std::move(mock_transaction_request_router),
+      std::move(consume_budget_command_factory), mock_metric_client,
+      mock_config_provider, std::move(total_request_counter),
+      std::move(client_error_counter), std::move(server_error_counter));
+  front_end_service.InitMetricInstances();
+
+  AsyncContext<HttpRequest, HttpResponse> http_context;
+  http_context.request = make_shared<HttpRequest>();
+  http_context.request->headers = make_shared<HttpHeaders>();
+  http_context.request->auth_context.authorized_domain =
+      make_shared<string>("authorized-domain.com");
+  http_context.response = make_shared<HttpResponse>();
+
+  // A batch without any transactions is rejected.
+  string body = "{\"v\": \"1.0\", \"t\": []}";
+  http_context.request->body.bytes =
+      make_shared<vector<Byte>>(body.begin(), body.end());
+  http_context.request->body.length = body.length();
+  http_context.request->body.capacity = body.length();
+  EXPECT_THAT(
+      front_end_service.BatchGetTransactionStatus(http_context),
+      ResultIs(FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY)));
+
+  BatchGetTransactionStatusRequest batch_request;
+  for (int i = 0; i < 2; ++i) {
+    auto item = make_shared<GetTransactionStatusRequest>();
+    item->transaction_id = Uuid::GenerateUuid();
+    item->transaction_secret = make_shared<string>("secret");
+    batch_request.items.push_back(item);
+  }
+  batch_request.items[1]->transaction_origin =
+      make_shared<string>("remote-origin.com");
+  EXPECT_SUCCESS(FrontEndUtils::SerializeBatchGetTransactionStatusRequest(
+      batch_request, http_context.request->body));
+
+  // The first transaction fails synchronously and the second one succeeds.
+  size_t execute_count = 0;
+  EXPECT_CALL(*mock_transaction_request_router_copy,
+              Execute(An<AsyncContext<GetTransactionStatusRequest,
+                                      GetTransactionStatusResponse>&>()))
+      .Times(2)
+      .WillRepeatedly(
+          [&](AsyncContext<GetTransactionStatusRequest,
+                           GetTransactionStatusResponse>& transaction_context)
+              -> ExecutionResult {
+            EXPECT_EQ(transaction_context.request->transaction_id,
+                      batch_request.items[execute_count]->transaction_id);
+            if (execute_count++ == 0) {
+              EXPECT_EQ(*transaction_context.request->transaction_origin,
+                        "authorized-domain.com");
+              return FailureExecutionResult(1234);
+            }
+            EXPECT_EQ(*transaction_context.request->transaction_origin,
+                      "remote-origin.com");
+            transaction_context.response =
+                make_shared<GetTransactionStatusResponse>();
+            transaction_context.response->last_execution_timestamp = 12345;
+            transaction_context.response->transaction_execution_phase =
+                TransactionExecutionPhase::Commit;
+            transaction_context.result = SuccessExecutionResult();
+            transaction_context.Finish();
+            return SuccessExecutionResult();
+          });
+
+  atomic<bool> called = false;
+  http_context.callback =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        EXPECT_SUCCESS(http_context.result);
+        BatchGetTransactionStatusResponse batch_response;
+        EXPECT_SUCCESS(
+            FrontEndUtils::DeserializeBatchGetTransactionStatusResponse(
+                http_context.response->body, batch_response));
+        EXPECT_EQ(batch_response.items.size(), 2);
+        EXPECT_THAT(batch_response.item_results[0],
+                    ResultIs(FailureExecutionResult(1234)));
+        EXPECT_SUCCESS(batch_response.item_results[1]);
+        EXPECT_EQ(batch_response.items[1]->last_execution_timestamp, 12345);
+        EXPECT_EQ(batch_response.items[1]->transaction_execution_phase,
+                  TransactionExecutionPhase::Commit);
+        called = true;
+      };
+  EXPECT_SUCCESS(front_end_service.BatchGetTransactionStatus(http_context));
+  WaitUntil([&]() { return called.load(); });
+
+  auto total_request_metric_instance = front_end_service.GetMetricsInstance(
+      kMetricLabelBatchGetStatusTransaction, kMetricNameRequests);
+  auto client_errors_metric_instance = front_end_service.GetMetricsInstance(
+      kMetricLabelBatchGetStatusTransaction, kMetricNameClientErrors);
+  EXPECT_EQ(
+      total_request_metric_instance->GetCounter(kMetricLabelValueOperator), 2);
+  EXPECT_EQ(
+      client_errors_metric_instance->GetCounter(kMetricLabelValueOperator), 1);
+}
+
 TEST_F(FrontEndServiceTest, GenerateConsumeBudgetCommands) {
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   consume_budget_metadata_list.emplace_back();
@@ -24,6 +24,7 @@
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/common/time_provider/src/time_provider.h"
 #include "opentelemetry/metrics/provider.h"
 #include "opentelemetry/sdk/metrics/meter_provider.h"
@@ -48,6 +49,7 @@ using google::scp::core::HttpMethod;
 using google::scp::core::HttpRequest;
 using google::scp::core::HttpResponse;
 using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::common::TimeProvider;
 using google::scp::core::errors::GetErrorMessage;
@@ -123,6 +125,46 @@ void HealthService::ObserveFileSystemStorageUsageCallback(
       *(self_ptr->GetFileSystemStorageUsagePercentage(kVarLogDirectory)));
 }
 
+// static
+void HealthService::ObserveBytesBufferPoolPooledBytesCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    HealthService* self_ptr) {
+  auto observer = std::get<opentelemetry::nostd::shared_ptr<
+      opentelemetry::metrics::ObserverResultT<int64_t>>>(observer_result);
+  observer->Observe(
+      static_cast<int64_t>(BytesBufferPool::GetMetrics().pooled_bytes));
+}
+
+// static
+void HealthService::ObserveBytesBufferPoolOutstandingBytesCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    HealthService* self_ptr) {
+  auto observer = std::get<opentelemetry::nostd::shared_ptr<
+      opentelemetry::metrics::ObserverResultT<int64_t>>>(observer_result);
+  observer->Observe(
+      static_cast<int64_t>(BytesBufferPool::GetMetrics().outstanding_bytes));
+}
+
+// static
+void HealthService::ObserveBytesBufferPoolHitsCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    HealthService* self_ptr) {
+  auto observer = std::get<opentelemetry::nostd::shared_ptr<
+      opentelemetry::metrics::ObserverResultT<int64_t>>>(observer_result);
+  observer->Observe(
+      static_cast<int64_t>(BytesBufferPool::GetMetrics().hit_count));
+}
+
+// static
+void HealthService::ObserveBytesBufferPoolMissesCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    HealthService* self_ptr) {
+  auto observer = std::get<opentelemetry::nostd::shared_ptr<
+      opentelemetry::metrics::ObserverResultT<int64_t>>>(observer_result);
+  observer->Observe(
+      static_cast<int64_t>(BytesBufferPool::GetMetrics().miss_count));
+}
+
 ExecutionResult HealthService::Init() noexcept {
   HttpHandler check_health_handler =
       bind(&HealthService::CheckHealth, this, _1);
@@ -156,6 +198,38 @@ ExecutionResult HealthService::Init() noexcept {
           &HealthService::ObserveFileSystemStorageUsageCallback),
       this);
 
+  bytes_buffer_pool_pooled_bytes_instrument_ =
+      meter_->CreateInt64ObservableGauge(
+          google::scp::pbs::kMetricNameBytesBufferPoolPooledBytes,
+          "Bytes cached by the bytes buffer pool", "By");
+  bytes_buffer_pool_outstanding_bytes_instrument_ =
+      meter_->CreateInt64ObservableGauge(
+          google::scp::pbs::kMetricNameBytesBufferPoolOutstandingBytes,
+          "Bytes of the bytes buffer pool in use", "By");
+  bytes_buffer_pool_hits_instrument_ = meter_->CreateInt64ObservableCounter(
+      google::scp::pbs::kMetricNameBytesBufferPoolHits,
+      "Allocations served by the bytes buffer pool");
+  bytes_buffer_pool_misses_instrument_ = meter_->CreateInt64ObservableCounter(
+      google::scp::pbs::kMetricNameBytesBufferPoolMisses,
+      "Allocations not served by the bytes buffer pool");
+
+  bytes_buffer_pool_pooled_bytes_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &HealthService::ObserveBytesBufferPoolPooledBytesCallback),
+      this);
+  bytes_buffer_pool_outstanding_bytes_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &HealthService::ObserveBytesBufferPoolOutstandingBytesCallback),
+      this);
+  bytes_buffer_pool_hits_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &HealthService::ObserveBytesBufferPoolHitsCallback),
+      this);
+  bytes_buffer_pool_misses_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &HealthService::ObserveBytesBufferPoolMissesCallback),
+      this);
+
   RETURN_IF_FAILURE(InitMetricClientInterface());
   return SuccessExecutionResult();
 }
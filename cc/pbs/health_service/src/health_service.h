@@ -72,6 +72,21 @@ class HealthService : public core::ServiceInterface {
       opentelemetry::metrics::ObserverResult observer_result,
       HealthService* self_ptr);
 
+  /// Callbacks to be used with the OTel ObservableInstruments of the bytes
+  /// buffer pool, which is shared by the whole process.
+  static void ObserveBytesBufferPoolPooledBytesCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      HealthService* self_ptr);
+  static void ObserveBytesBufferPoolOutstandingBytesCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      HealthService* self_ptr);
+  static void ObserveBytesBufferPoolHitsCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      HealthService* self_ptr);
+  static void ObserveBytesBufferPoolMissesCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      HealthService* self_ptr);
+
   HealthService() {}
 
   /**
@@ -156,6 +171,16 @@ class HealthService : public core::ServiceInterface {
   /// The OpenTelemetry Instrument for instance file system storage usage.
   std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
       filesystem_storage_usage_instrument_;
+  /// The OpenTelemetry Instruments for the bytes buffer pool occupancy.
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      bytes_buffer_pool_pooled_bytes_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      bytes_buffer_pool_outstanding_bytes_instrument_;
+  /// The OpenTelemetry Instruments for the bytes buffer pool allocations.
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      bytes_buffer_pool_hits_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      bytes_buffer_pool_misses_instrument_;
 
  private:
   /// Initialize MetricClient.
@@ -27,6 +27,7 @@
 
 #include "cc/core/telemetry/src/common/metric_utils.h"
 #include "cc/pbs/health_service/src/error_codes.h"
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/async_executor/src/async_executor.h"
 #include "core/http2_server/mock/mock_http2_server.h"
 #include "core/interface/config_provider_interface.h"
@@ -49,6 +50,7 @@ using google::scp::core::HttpRequest;
 using google::scp::core::HttpResponse;
 using google::scp::core::HttpServerInterface;
 using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::errors::
     SC_PBS_HEALTH_SERVICE_COULD_NOT_FIND_MEMORY_INFO;
 using google::scp::core::errors::
@@ -498,4 +500,39 @@ TEST_F(HealthServiceTest,
          "(int64_t)";
 }
 
+TEST_F(HealthServiceTest, OTelReturnsBytesBufferPoolMetrics) {
+  const std::map<std::string, std::string> empty_label_kv = {};
+  const opentelemetry::sdk::common::OrderedAttributeMap dimensions(
+      (opentelemetry::common::KeyValueIterableView<
+          std::map<std::string, std::string>>(empty_label_kv)));
+
+  auto bytes = BytesBufferPool::AllocateBytes(1000);
+  auto metrics = BytesBufferPool::GetMetrics();
+
+  std::vector<opentelemetry::sdk::metrics::ResourceMetrics> data =
+      metric_router_->GetExportedData();
+
+  std::optional<opentelemetry::sdk::metrics::PointType>
+      outstanding_bytes_metric_point_data = core::GetMetricPointData(
+          google::scp::pbs::kMetricNameBytesBufferPoolOutstandingBytes,
+          dimensions, data);
+  ASSERT_TRUE(outstanding_bytes_metric_point_data.has_value());
+  auto outstanding_bytes_last_value_point_data =
+      std::move(std::get<opentelemetry::sdk::metrics::LastValuePointData>(
+          outstanding_bytes_metric_point_data.value()));
+  EXPECT_EQ(std::get<int64_t>(outstanding_bytes_last_value_point_data.value_),
+            static_cast<int64_t>(metrics.outstanding_bytes));
+
+  std::optional<opentelemetry::sdk::metrics::PointType>
+      misses_metric_point_data = core::GetMetricPointData(
+          google::scp::pbs::kMetricNameBytesBufferPoolMisses, dimensions,
+          data);
+  ASSERT_TRUE(misses_metric_point_data.has_value());
+  auto misses_sum_point_data =
+      std::move(std::get<opentelemetry::sdk::metrics::SumPointData>(
+          misses_metric_point_data.value()));
+  EXPECT_EQ(std::get<int64_t>(misses_sum_point_data.value_),
+            static_cast<int64_t>(metrics.miss_count));
+}
+
 }  // namespace google::scp::pbs::test
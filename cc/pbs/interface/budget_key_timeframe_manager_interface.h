@@ -29,6 +29,23 @@
 #include "public/core/interface/execution_result.h"
 
 namespace google::scp::pbs {
+/**
+ * @brief Tokens reserved on a budget key timeframe by a transaction in the
+ * escrow mode. The tokens are deducted from the timeframe once the transaction
+ * is notified, or given back if it is aborted.
+ */
+struct BudgetKeyTimeframeReservation {
+  explicit BudgetKeyTimeframeReservation(TokenCount token_count)
+      : token_count(token_count), is_logged(false) {}
+
+  /// The number of tokens reserved by the transaction.
+  const TokenCount token_count;
+
+  /// Whether the reservation has been journaled. A reservation which is not
+  /// journaled yet can still be rolled back.
+  std::atomic<bool> is_logged;
+};
+
 /**
  * @brief Responsible to keep the time_bucket info and number of tokens
  * associated with the time bucket.
@@ -38,7 +55,8 @@ struct BudgetKeyTimeframe {
       : time_bucket_index(time_bucket_index),
         token_count(0),
         active_transaction_id(core::common::kZeroUuid),
-        active_token_count(0) {}
+        active_token_count(0),
+        reserved_token_count(0) {}
 
   /// This is hour index of time bucket within time group
   const TimeBucket time_bucket_index;
@@ -54,6 +72,19 @@ struct BudgetKeyTimeframe {
    * the value that is proposed by the transaction.
    */
   std::atomic<TokenCount> active_token_count;
+
+  /**
+   * @brief The sum of the tokens reserved by the escrow transactions, which
+   * never exceeds token_count. A timeframe has either an active transaction id
+   * or reservations, never both.
+   */
+  std::atomic<TokenCount> reserved_token_count;
+
+  /// The reservations of the escrow transactions by transaction id.
+  core::common::ConcurrentMap<core::common::Uuid,
+                              std::shared_ptr<BudgetKeyTimeframeReservation>,
+                              core::common::UuidCompare>
+      reservations;
 };
 
 /**
@@ -110,6 +141,31 @@ struct UpdateBudgetKeyTimeframeRequest {
 /// The response object after a budget key timeframe has been updated.
 struct UpdateBudgetKeyTimeframeResponse {};
 
+/// The operations on the token reservation of a transaction.
+enum class BudgetKeyTimeframeReservationOperation {
+  /// Reserves the tokens for the transaction.
+  Reserve = 0,
+  /// Deducts the reserved tokens from the timeframe.
+  Consume = 1,
+  /// Gives the reserved tokens back to the timeframe.
+  Release = 2,
+};
+
+/// The request object to update the token reservation of a transaction on a
+/// budget key timeframe.
+struct UpdateBudgetKeyTimeframeReservationRequest {
+  /// Timebucket of the reporting timestamp to be updated.
+  core::Timestamp reporting_time = 0;
+  /// The transaction owning the reservation.
+  core::common::Uuid transaction_id;
+  /// The operation on the reservation.
+  BudgetKeyTimeframeReservationOperation operation =
+      BudgetKeyTimeframeReservationOperation::Reserve;
+};
+
+/// The response object after a token reservation has been updated.
+struct UpdateBudgetKeyTimeframeReservationResponse {};
+
 /**
  * @brief Is responsible to load key time frame related into from the undelying
  * storage for any specific keys.
@@ -153,6 +209,21 @@ class BudgetKeyTimeframeManagerInterface : public core::ServiceInterface {
                          UpdateBudgetKeyTimeframeResponse>&
           update_budget_key_timeframe_context) noexcept = 0;
 
+  /**
+   * @brief Journals an operation on the token reservation of a transaction and
+   * applies it to the cached timeframe. To reserve, the caller must have
+   * already added the reservation to the timeframe, which is marked as logged
+   * once journaled. To consume or release, the reservation must be logged.
+   *
+   * @param update_reservation_context The context of the update reservation
+   * operation.
+   * @return core::ExecutionResult the execution result of the operation.
+   */
+  virtual core::ExecutionResult UpdateReservation(
+      core::AsyncContext<UpdateBudgetKeyTimeframeReservationRequest,
+                         UpdateBudgetKeyTimeframeReservationResponse>&
+          update_reservation_context) noexcept = 0;
+
   /**
    * @brief Returns the id of the current budget key timeframe manager.
    *
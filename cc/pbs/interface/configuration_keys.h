@@ -30,6 +30,13 @@ static constexpr char kServiceMetricsBatchTimeDurationMs[] =
     "google_scp_pbs_metrics_batch_time_duration_ms";
 static constexpr char kBudgetKeyTableName[] =
     "google_scp_pbs_budget_key_table_name";
+// Whether concurrent budget consumption requests touching the same budget key
+// rows are coalesced into a single database transaction.
+static constexpr char kBudgetConsumptionCoalescingEnabled[] =
+    "google_scp_pbs_budget_consumption_coalescing_enabled";
+// Maximum number of budget consumption requests in one coalesced transaction.
+static constexpr char kBudgetConsumptionCoalescingMaxBatchSize[] =
+    "google_scp_pbs_budget_consumption_coalescing_max_batch_size";
 static constexpr char kAsyncExecutorQueueSize[] =
     "google_scp_pbs_async_executor_queue_size";
 static constexpr char kAsyncExecutorThreadsCount[] =
@@ -44,6 +51,10 @@ static constexpr char kJournalServiceBucketName[] =
     "google_scp_pbs_journal_service_bucket_name";
 static constexpr char kJournalServicePartitionName[] =
     "google_scp_pbs_journal_service_partition_name";
+// The local directory to write the journals to before shipping them to the
+// journal bucket. The journals are written to the bucket directly if not set.
+static constexpr char kJournalServiceLocalTierPath[] =
+    "google_scp_pbs_journal_service_local_tier_path";
 static constexpr char kPrivacyBudgetServiceHostAddress[] =
     "google_scp_pbs_host_address";
 static constexpr char kPrivacyBudgetServiceHostPort[] =
@@ -57,6 +68,11 @@ static constexpr char kEnableBatchBudgetCommandsPerDayConfigName[] =
     "google_scp_pbs_enable_batch_budget_commands_per_day";
 static constexpr char kDisallowNewTransactionRequests[] =
     "google_scp_pbs_disallow_new_transaction_requests";
+// Serves the consume budget transaction endpoint, which executes all the
+// phases of a transaction in one request. Only for deployments with a single
+// coordinator.
+static constexpr char kPhaseCollapsedTransactionsEnabled[] =
+    "google_scp_pbs_phase_collapsed_transactions_enabled";
 
 // PBS multi-instance mode configurations
 static constexpr char kPBSPartitionLockTableNameConfigName[] =
@@ -100,6 +116,12 @@ static constexpr char kPBSPartitionIdList[] =
     "google_scp_pbs_partition_id_list";
 static constexpr char kPBSVirtualNodeIdList[] =
     "google_scp_pbs_virtual_node_id_list";
+// Scheme used to map budget keys to partitions, either "modulo" (default) or
+// "consistent_hash".
+static constexpr char kPBSPartitionMappingScheme[] =
+    "google_scp_pbs_partition_mapping_scheme";
+static constexpr char kPBSPartitionMappingVirtualNodesPerPartition[] =
+    "google_scp_pbs_partition_mapping_virtual_nodes_per_partition";
 
 // Remote configurations
 static constexpr char kRemotePrivacyBudgetServiceHostAddress[] =
@@ -134,6 +156,14 @@ static constexpr char
         "google_scp_pbs_journal_checkpointing_max_entries_to_process_in_each_"
         "run";
 
+// Standby partitions
+static constexpr char kPBSPartitionManagerStandbyPartitionsEnabled[] =
+    "google_scp_pbs_partition_manager_standby_partitions_enabled";
+static constexpr char
+    kPBSPartitionManagerStandbyCatchUpIntervalInMilliseconds[] =
+        "google_scp_pbs_partition_manager_standby_catch_up_interval_in_"
+        "milliseconds";
+
 // Health service
 static constexpr char kPBSHealthServiceEnableMemoryAndStorageCheck[] =
     "google_scp_pbs_health_service_enable_mem_and_storage_check";
@@ -141,11 +171,61 @@ static constexpr char kPBSHealthServiceEnableMemoryAndStorageCheck[] =
 // workload generator
 static constexpr char kPBSWorkloadGeneratorMaxHttpRetryCount[] =
     "pbs_workload_generator_max_http_retry_count";
+// A non-zero target RPS runs the workload generator in open-loop mode.
+static constexpr char kPBSWorkloadGeneratorTargetRps[] =
+    "pbs_workload_generator_target_rps";
+static constexpr char kPBSWorkloadGeneratorClientThreadCount[] =
+    "pbs_workload_generator_client_thread_count";
+static constexpr char kPBSWorkloadGeneratorKeySpaceSize[] =
+    "pbs_workload_generator_key_space_size";
+static constexpr char kPBSWorkloadGeneratorKeyZipfExponent[] =
+    "pbs_workload_generator_key_zipf_exponent";
+static constexpr char kPBSWorkloadGeneratorBatchSizeZipfExponent[] =
+    "pbs_workload_generator_batch_size_zipf_exponent";
+// Results are written as JSON if the path ends with .json, CSV otherwise.
+static constexpr char kPBSWorkloadGeneratorResultsPath[] =
+    "pbs_workload_generator_results_path";
 
 // PBS with relaxed consistency
 static constexpr char kPBSRelaxedConsistencyEnabled[] =
     "google_scp_pbs_relaxed_consistency_enabled";
 
+// Consume budget transactions reserve tokens on the budget key timeframes
+// instead of locking them, so that concurrent transactions can consume budget
+// from the same timeframe.
+static constexpr char kPBSBudgetKeyEscrowReservationsEnabled[] =
+    "google_scp_pbs_budget_key_escrow_reservations_enabled";
+
+// The number of transaction status inquiries to a remote coordinator sent in a
+// single request. Inquiries are sent one by one if this is 1, which is also
+// needed when the remote coordinator does not support batches.
+static constexpr char kRemoteTransactionStatusBatchSize[] =
+    "google_scp_pbs_remote_transaction_status_batch_size";
+
+// Whether the leases of all the partitions (and virtual nodes) of a node are
+// refreshed together by a single thread with batched database requests,
+// instead of by a thread and database requests per lease.
+static constexpr char kPBSBatchedLeaseRefreshEnabled[] =
+    "google_scp_pbs_batched_lease_refresh_enabled";
+
+// The number of budget key timeframe write-backs, done when the timeframes are
+// evicted from the cache, sent to the database in a single batch. Write-backs
+// are sent one by one if this is 1.
+static constexpr char kPBSBudgetKeyWriteBackBatchSize[] =
+    "google_scp_pbs_budget_key_write_back_batch_size";
+
+// Whether the HTTP/1 requests, e.g. the ones to the authorization service,
+// share connections on a single curl multi event loop, instead of each
+// blocking an IO thread on its own connection.
+static constexpr char kPBSHttp1CurlMultiEngineEnabled[] =
+    "google_scp_pbs_http1_curl_multi_engine_enabled";
+
+// Whether the checkpoints store all the time groups of a budget key as a
+// single columnar snapshot log instead of a log per time group. Only enable
+// once all the PBS instances and checkpoint services can read the snapshots.
+static constexpr char kPBSBudgetKeyColumnarCheckpointsEnabled[] =
+    "google_scp_pbs_budget_key_columnar_checkpoints_enabled";
+
 // Opentelemetry
 static constexpr char kOtelEnabled[] = "google_scp_otel_enabled";
 static constexpr char kOtelPrintDataToConsoleEnabled[] =
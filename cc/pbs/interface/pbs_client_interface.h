@@ -14,12 +14,29 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "core/interface/async_context.h"
 #include "core/interface/service_interface.h"
 #include "core/interface/transaction_manager_interface.h"
 #include "pbs/interface/front_end_service_interface.h"
 
 namespace google::scp::pbs {
+/// Represents the request to inquire the status of multiple transactions.
+struct BatchGetTransactionStatusRequest {
+  /// The transactions to inquire, each with its own secret and origin.
+  std::vector<std::shared_ptr<core::GetTransactionStatusRequest>> items;
+};
+
+/// Represents the response of a batch transaction status inquiry.
+struct BatchGetTransactionStatusResponse {
+  /// The result of each item, in the order of the request items.
+  std::vector<core::ExecutionResult> item_results;
+  /// The status of each item, set only if the item succeeded.
+  std::vector<std::shared_ptr<core::GetTransactionStatusResponse>> items;
+};
+
 /**
  * @brief Provides privacy budget service API layer for a single privacy budget
  * instance.
@@ -39,6 +56,19 @@ class PrivacyBudgetServiceClientInterface : public core::ServiceInterface {
                          core::GetTransactionStatusResponse>&
           get_transaction_status_context) noexcept = 0;
 
+  /**
+   * @brief Inquires the status of multiple transactions from the remote
+   * transaction engine in a single request.
+   *
+   * @param batch_get_transaction_status_context The batch get transaction
+   * status context.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  virtual core::ExecutionResult BatchGetTransactionStatus(
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&
+          batch_get_transaction_status_context) noexcept = 0;
+
   /**
    * @brief Initiates a new consume budget transaction on a privacy budget
    * service.
@@ -52,6 +82,19 @@ class PrivacyBudgetServiceClientInterface : public core::ServiceInterface {
                          ConsumeBudgetTransactionResponse>&
           consume_budget_transaction_context) noexcept = 0;
 
+  /**
+   * @brief Executes all the phases of a consume budget transaction in a single
+   * request on a privacy budget service which is the only coordinator.
+   *
+   * @param consume_budget_transaction_context The consume budget transaction
+   * context of the operation.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  virtual core::ExecutionResult ExecuteConsumeBudgetTransaction(
+      core::AsyncContext<ConsumeBudgetTransactionRequest,
+                         ConsumeBudgetTransactionResponse>&
+          consume_budget_transaction_context) noexcept = 0;
+
   /**
    * @brief Executes a transaction phase on a privacy budget service.
    *
@@ -81,6 +81,18 @@ class PBSPartitionInterface : public core::PartitionInterface {
   virtual core::ExecutionResult GetTransactionManagerStatus(
       const core::GetTransactionManagerStatusRequest& request,
       core::GetTransactionManagerStatusResponse& response) noexcept = 0;
+
+  /**
+   * @brief Keeps an initialized but not yet loaded partition warm by
+   * replaying the checkpoint and journals written by the current owner of the
+   * partition. The first call performs a full recovery, subsequent calls only
+   * replay the journals written since the previous call. The partition does
+   * not accept requests while in standby, and a subsequent Load() only needs
+   * to replay the journals written after the last catch up.
+   *
+   * @return core::ExecutionResult
+   */
+  virtual core::ExecutionResult CatchUpAsStandby() noexcept = 0;
 };
 
 }  // namespace google::scp::pbs
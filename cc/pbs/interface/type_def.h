@@ -40,6 +40,12 @@ static constexpr char kNotifyTransactionPath[] = "/v1/transactions:notify";
 static constexpr char kAbortTransactionPath[] = "/v1/transactions:abort";
 static constexpr char kEndTransactionPath[] = "/v1/transactions:end";
 static constexpr char kStatusTransactionPath[] = "/v1/transactions:status";
+static constexpr char kBatchStatusTransactionPath[] =
+    "/v1/transactions:batch-status";
+/// The maximum number of transactions in a batch transaction status request.
+static constexpr size_t kMaxBatchStatusTransactionItems = 1000;
+static constexpr char kConsumeBudgetTransactionPath[] =
+    "/v1/transactions:consume-budget";
 static constexpr char kServiceStatusPath[] = "/v1/service:status";
 
 // Metric labels
@@ -52,6 +58,10 @@ static constexpr char kMetricLabelNotifyTransaction[] = "notify_transaction";
 static constexpr char kMetricLabelEndTransaction[] = "end_transaction";
 static constexpr char kMetricLabelGetStatusTransaction[] =
     "get_status_transaction";
+static constexpr char kMetricLabelBatchGetStatusTransaction[] =
+    "batch_get_status_transaction";
+static constexpr char kMetricLabelConsumeBudgetTransaction[] =
+    "consume_budget_transaction";
 static constexpr char kMetricLabelValueOperator[] = "operator";
 static constexpr char kMetricLabelValueCoordinator[] = "coordinator";
 static constexpr char kMetricLabelKeyReportingOrigin[] = "reporting_origin";
@@ -69,6 +79,14 @@ static constexpr char kMetricNameMemoryUsage[] =
     "google.scp.pbs.health.memory_usage";
 static constexpr char kMetricNameFileSystemStorageUsage[] =
     "google.scp.pbs.health.filesystem_storage_usage";
+static constexpr char kMetricNameBytesBufferPoolPooledBytes[] =
+    "google.scp.pbs.health.bytes_buffer_pool.pooled_bytes";
+static constexpr char kMetricNameBytesBufferPoolOutstandingBytes[] =
+    "google.scp.pbs.health.bytes_buffer_pool.outstanding_bytes";
+static constexpr char kMetricNameBytesBufferPoolHits[] =
+    "google.scp.pbs.health.bytes_buffer_pool.hits";
+static constexpr char kMetricNameBytesBufferPoolMisses[] =
+    "google.scp.pbs.health.bytes_buffer_pool.misses";
 
 // TODO: This must be configurable.
 static constexpr int kMaxToken = 1;
@@ -31,4 +31,9 @@ DEFINE_ERROR_CODE(SC_LEASABLE_LOCK_ACQUISITION_DISALLOWED, SC_LEASABLE_LOCK,
                   0x0002, "Lease acquisition disabled at this time",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_LEASABLE_LOCK_INVALID_BATCH_RESPONSE, SC_LEASABLE_LOCK,
+                  0x0003,
+                  "The database response of a batch lease refresh is invalid.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 }  // namespace google::scp::core::errors
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pbs/leasable_lock/src/leasable_lock_batch_refresher_on_nosql_database.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "core/common/global_logger/src/global_logger.h"
+#include "core/common/uuid/src/uuid.h"
+#include "pbs/leasable_lock/src/error_codes.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::BatchGetDatabaseItemsRequest;
+using google::scp::core::BatchGetDatabaseItemsResponse;
+using google::scp::core::BatchUpsertDatabaseItemsRequest;
+using google::scp::core::BatchUpsertDatabaseItemsResponse;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::LeasableLockInterface;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::kZeroUuid;
+using std::atomic;
+using std::dynamic_pointer_cast;
+using std::make_shared;
+using std::mutex;
+using std::optional;
+using std::shared_ptr;
+using std::unique_lock;
+using std::vector;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+static constexpr char kLeasableLockBatchRefresher[] =
+    "LeasableLockBatchRefresher";
+
+namespace google::scp::pbs {
+/**
+ * @brief Executes the batch operation and waits for its completion.
+ *
+ * @return ExecutionResult the result of the batch, not of its items.
+ */
+template <typename Request, typename Response, typename Operation>
+static ExecutionResult ExecuteBatchSynchronously(
+    const shared_ptr<Request>& request, shared_ptr<Response>& response,
+    Operation operation) {
+  atomic<bool> request_executed = false;
+  AsyncContext<Request, Response> response_context;
+  AsyncContext<Request, Response> request_context(
+      request, [&](auto& context) {
+        response_context = context;
+        request_executed = true;
+      });
+
+  auto result = operation(request_context);
+  if (!result.Successful()) {
+    return result;
+  }
+
+  // Wait for the query to be executed.
+  while (!request_executed) {
+    sleep_for(milliseconds(5));
+  }
+
+  if (!response_context.result.Successful()) {
+    return response_context.result;
+  }
+  if (!response_context.response ||
+      response_context.response->item_results.size() !=
+          request->items.size() ||
+      response_context.response->items.size() != request->items.size()) {
+    return FailureExecutionResult(
+        core::errors::SC_LEASABLE_LOCK_INVALID_BATCH_RESPONSE);
+  }
+  response = response_context.response;
+  return SuccessExecutionResult();
+}
+
+vector<ExecutionResult>
+LeasableLockBatchRefresherOnNoSQLDatabase::RefreshLeases(
+    const vector<shared_ptr<LeasableLockInterface>>& leasable_locks,
+    const vector<bool>& is_read_only_lease_refresh) noexcept {
+  vector<ExecutionResult> results(leasable_locks.size(),
+                                  SuccessExecutionResult());
+
+  // Only the locks on this database can be batched.
+  vector<LeasableLockOnNoSQLDatabase*> locks;
+  vector<size_t> lock_indices;
+  for (size_t i = 0; i < leasable_locks.size(); ++i) {
+    auto lock = dynamic_pointer_cast<LeasableLockOnNoSQLDatabase>(
+        leasable_locks[i]);
+    if (lock && lock->database_ == database_) {
+      locks.push_back(lock.get());
+      lock_indices.push_back(i);
+    } else {
+      results[i] =
+          leasable_locks[i]->RefreshLease(is_read_only_lease_refresh[i]);
+    }
+  }
+  if (locks.empty()) {
+    return results;
+  }
+
+  // Every lock is held for the whole refresh as in RefreshLease(). Locks are
+  // only held together here, always in the given order.
+  vector<unique_lock<mutex>> lock_guards;
+  lock_guards.reserve(locks.size());
+  for (auto* lock : locks) {
+    lock_guards.emplace_back(lock->mutex_);
+  }
+
+  //
+  // 1) Read all the leases at once.
+  //
+  vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal> leases_read;
+  vector<ExecutionResult> read_results;
+  ReadLeasesSynchronouslyFromDatabase(locks, leases_read, read_results);
+
+  //
+  // 2) Decide on the leases to write.
+  //
+  vector<LeasableLockOnNoSQLDatabase*> locks_to_write;
+  vector<size_t> lock_to_write_indices;
+  vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal> leases_to_overwrite;
+  vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal> new_leases;
+  for (size_t i = 0; i < locks.size(); ++i) {
+    auto& result = results[lock_indices[i]];
+    if (!read_results[i].Successful()) {
+      SCP_ERROR(kLeasableLockBatchRefresher, locks[i]->activity_id_,
+                read_results[i], "LockId: '%s', Failed to read the lease.",
+                locks[i]->lock_row_key_.c_str());
+      result = read_results[i];
+      continue;
+    }
+
+    optional<LeasableLockOnNoSQLDatabase::LeaseInfoInternal> new_lease;
+    result = locks[i]->OnLeaseRead(
+        leases_read[i], is_read_only_lease_refresh[lock_indices[i]],
+        new_lease);
+    if (result.Successful() && new_lease.has_value()) {
+      locks_to_write.push_back(locks[i]);
+      lock_to_write_indices.push_back(lock_indices[i]);
+      leases_to_overwrite.push_back(leases_read[i]);
+      new_leases.push_back(*new_lease);
+    }
+  }
+  if (locks_to_write.empty()) {
+    return results;
+  }
+
+  //
+  // 3) Write all the new leases at once.
+  //
+  vector<ExecutionResult> write_results;
+  WriteLeasesSynchronouslyToDatabase(locks_to_write, leases_to_overwrite,
+                                     new_leases, write_results);
+  for (size_t i = 0; i < locks_to_write.size(); ++i) {
+    results[lock_to_write_indices[i]] = locks_to_write[i]->OnLeaseWritten(
+        leases_to_overwrite[i], new_leases[i], write_results[i]);
+  }
+
+  SCP_DEBUG(kLeasableLockBatchRefresher, kZeroUuid,
+            "Refreshed '%llu' leases, of which '%llu' were written.",
+            locks.size(), locks_to_write.size());
+  return results;
+}
+
+void LeasableLockBatchRefresherOnNoSQLDatabase::
+    ReadLeasesSynchronouslyFromDatabase(
+        const vector<LeasableLockOnNoSQLDatabase*>& locks,
+        vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal>& leases_read,
+        vector<ExecutionResult>& results) noexcept {
+  auto request = make_shared<BatchGetDatabaseItemsRequest>();
+  for (auto* lock : locks) {
+    request->items.push_back(lock->ConstructReadLeaseRequest());
+  }
+
+  leases_read.resize(locks.size());
+  shared_ptr<BatchGetDatabaseItemsResponse> response;
+  auto batch_result = ExecuteBatchSynchronously(
+      request, response, [this](auto& context) {
+        return database_->BatchGetDatabaseItems(context);
+      });
+  if (!batch_result.Successful()) {
+    results.assign(locks.size(), batch_result);
+    return;
+  }
+
+  results = response->item_results;
+  for (size_t i = 0; i < locks.size(); ++i) {
+    if (!results[i].Successful()) {
+      continue;
+    }
+    if (!response->items[i]) {
+      results[i] = FailureExecutionResult(
+          core::errors::SC_LEASABLE_LOCK_INVALID_BATCH_RESPONSE);
+      continue;
+    }
+    results[i] = locks[i]->ObtainLeaseInfoFromAttributes(
+        response->items[i]->attributes, leases_read[i]);
+  }
+}
+
+void LeasableLockBatchRefresherOnNoSQLDatabase::
+    WriteLeasesSynchronouslyToDatabase(
+        const vector<LeasableLockOnNoSQLDatabase*>& locks,
+        const vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal>&
+            leases_read,
+        const vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal>&
+            new_leases,
+        vector<ExecutionResult>& results) noexcept {
+  results.assign(locks.size(), SuccessExecutionResult());
+
+  // Locks whose request cannot be constructed are left out of the batch.
+  auto request = make_shared<BatchUpsertDatabaseItemsRequest>();
+  vector<size_t> item_indices;
+  for (size_t i = 0; i < locks.size(); ++i) {
+    shared_ptr<core::UpsertDatabaseItemRequest> item;
+    results[i] = locks[i]->ConstructWriteLeaseRequest(leases_read[i],
+                                                      new_leases[i], item);
+    if (results[i].Successful()) {
+      request->items.push_back(item);
+      item_indices.push_back(i);
+    }
+  }
+  if (request->items.empty()) {
+    return;
+  }
+
+  shared_ptr<BatchUpsertDatabaseItemsResponse> response;
+  auto batch_result = ExecuteBatchSynchronously(
+      request, response, [this](auto& context) {
+        return database_->BatchUpsertDatabaseItems(context);
+      });
+  for (size_t i = 0; i < item_indices.size(); ++i) {
+    results[item_indices[i]] =
+        batch_result.Successful() ? response->item_results[i] : batch_result;
+  }
+}
+}  // namespace google::scp::pbs
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/interface/lease_manager_interface.h"
+#include "core/interface/nosql_database_provider_interface.h"
+#include "pbs/leasable_lock/src/leasable_lock_on_nosql_database.h"
+
+namespace google::scp::pbs {
+/**
+ * @copydoc core::LeasableLockBatchRefresherInterface
+ *
+ * Refreshes the leases of LeasableLockOnNoSQLDatabase locks on the same
+ * database with one batched read of all the lock rows, followed by one batched
+ * conditional write of the leases to acquire or renew. Any other lock is
+ * refreshed on its own.
+ */
+class LeasableLockBatchRefresherOnNoSQLDatabase
+    : public core::LeasableLockBatchRefresherInterface {
+ public:
+  /**
+   * @brief Construct a new Leasable Lock Batch Refresher object
+   *
+   * @param database nosql database acessor object of the locks to batch.
+   */
+  explicit LeasableLockBatchRefresherOnNoSQLDatabase(
+      const std::shared_ptr<core::NoSQLDatabaseProviderInterface>&
+          database) noexcept
+      : database_(database) {}
+
+  std::vector<core::ExecutionResult> RefreshLeases(
+      const std::vector<std::shared_ptr<core::LeasableLockInterface>>&
+          leasable_locks,
+      const std::vector<bool>& is_read_only_lease_refresh) noexcept override;
+
+ protected:
+  /**
+   * @brief Reads the leases of the locks from the database.
+   *
+   * @param locks the locks to read the leases of.
+   * @param leases_read set to the lease read for each lock.
+   * @param results set to the result of the read for each lock.
+   */
+  void ReadLeasesSynchronouslyFromDatabase(
+      const std::vector<LeasableLockOnNoSQLDatabase*>& locks,
+      std::vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal>& leases_read,
+      std::vector<core::ExecutionResult>& results) noexcept;
+
+  /**
+   * @brief Writes the new leases of the locks to the database, on the
+   * condition that the lease rows still hold the read leases.
+   *
+   * @param locks the locks to write the leases of.
+   * @param leases_read the lease read for each lock.
+   * @param new_leases the lease to write for each lock.
+   * @param results set to the result of the write for each lock.
+   */
+  void WriteLeasesSynchronouslyToDatabase(
+      const std::vector<LeasableLockOnNoSQLDatabase*>& locks,
+      const std::vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal>&
+          leases_read,
+      const std::vector<LeasableLockOnNoSQLDatabase::LeaseInfoInternal>&
+          new_leases,
+      std::vector<core::ExecutionResult>& results) noexcept;
+
+  /// @brief NoSQL database accessor of the locks to batch.
+  std::shared_ptr<core::NoSQLDatabaseProviderInterface> database_;
+};
+}  // namespace google::scp::pbs
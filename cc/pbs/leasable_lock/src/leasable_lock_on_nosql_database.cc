@@ -87,6 +87,19 @@ ExecutionResult LeasableLockOnNoSQLDatabase::RefreshLease(
     return result;
   }
 
+  optional<LeaseInfoInternal> new_lease;
+  result = OnLeaseRead(lease_read, is_read_only_lease_refresh, new_lease);
+  if (!result.Successful() || !new_lease.has_value()) {
+    return result;
+  }
+
+  result = WriteLeaseSynchronouslyToDatabase(lease_read, *new_lease);
+  return OnLeaseWritten(lease_read, *new_lease, result);
+}
+
+ExecutionResult LeasableLockOnNoSQLDatabase::OnLeaseRead(
+    const LeaseInfoInternal& lease_read, bool is_read_only_lease_refresh,
+    optional<LeaseInfoInternal>& new_lease) noexcept {
   SCP_INFO(kLeasableLock, activity_id_,
            "LockId: '%s', Read the current lease from lock.",
            lock_row_key_.c_str());
@@ -103,14 +116,14 @@ ExecutionResult LeasableLockOnNoSQLDatabase::RefreshLease(
   if (!lease_read.IsLeaseOwner(lease_acquirer_info_.lease_acquirer_id) &&
       !lease_read.IsExpired()) {
     current_lease_ = lease_read;
-    return result;
+    return SuccessExecutionResult();
   }
 
   // If lease should not be acquired, i.e. lease is read only, then return with
   // the read lease.
   if (is_read_only_lease_refresh) {
     current_lease_ = lease_read;
-    return result;
+    return SuccessExecutionResult();
   }
 
   SCP_INFO(kLeasableLock, activity_id_,
@@ -118,14 +131,19 @@ ExecutionResult LeasableLockOnNoSQLDatabase::RefreshLease(
            lock_row_key_.c_str());
 
   // Renew(if owner) or Acquire(if not owner) the lease
-  LeaseInfoInternal new_lease = lease_read;
+  new_lease = lease_read;
   if (!lease_read.IsLeaseOwner(lease_acquirer_info_.lease_acquirer_id)) {
     new_lease = LeaseInfoInternal(lease_acquirer_info_);
   }
-  new_lease.SetExpirationTimestampFromNow(lease_duration_in_milliseconds_);
-  result = WriteLeaseSynchronouslyToDatabase(lease_read, new_lease);
-  if (!result.Successful()) {
-    SCP_ERROR(kLeasableLock, activity_id_, result,
+  new_lease->SetExpirationTimestampFromNow(lease_duration_in_milliseconds_);
+  return SuccessExecutionResult();
+}
+
+ExecutionResult LeasableLockOnNoSQLDatabase::OnLeaseWritten(
+    const LeaseInfoInternal& lease_read, const LeaseInfoInternal& new_lease,
+    const ExecutionResult& write_result) noexcept {
+  if (!write_result.Successful()) {
+    SCP_ERROR(kLeasableLock, activity_id_, write_result,
               "LockId: '%s', Failed to update lease on the database. "
               "Expiration Timestamp (ms): '%llu', Remaining time on Lease "
               "(ms): '%lld'",
@@ -134,7 +152,7 @@ ExecutionResult LeasableLockOnNoSQLDatabase::RefreshLease(
               lease_read.lease_expiraton_timestamp_in_milliseconds -
                   duration_cast<milliseconds>(
                       TimeProvider::GetWallTimestampInNanoseconds()));
-    return result;
+    return write_result;
   }
 
   SCP_INFO(
@@ -156,7 +174,7 @@ ExecutionResult LeasableLockOnNoSQLDatabase::RefreshLease(
               TimeProvider::GetWallTimestampInNanoseconds()));
 
   current_lease_ = new_lease;
-  return result;
+  return SuccessExecutionResult();
 }
 
 bool LeasableLockOnNoSQLDatabase::ShouldRefreshLease() const noexcept {
@@ -98,6 +98,8 @@ class LeasableLockOnNoSQLDatabase : public core::LeasableLockInterface {
       const noexcept override;
 
  protected:
+  friend class LeasableLockBatchRefresherOnNoSQLDatabase;
+
   struct LeaseInfoInternal {
     LeaseInfoInternal(
         const core::LeaseInfo& lease_owner_info,
@@ -149,7 +151,39 @@ class LeasableLockOnNoSQLDatabase : public core::LeasableLockInterface {
     bool lease_acquisition_disallowed;
   };
 
+  /**
+   * @brief Decides on the lease to write after reading the lease from the
+   * database, and caches the read lease if none needs to be written. Must be
+   * called with mutex_ held.
+   *
+   * @param lease_read the lease read from the database.
+   * @param is_read_only_lease_refresh whether the lease must not be acquired.
+   * @param new_lease set to the lease to write, if any.
+   * @return core::ExecutionResult
+   */
+  core::ExecutionResult OnLeaseRead(
+      const LeaseInfoInternal& lease_read, bool is_read_only_lease_refresh,
+      std::optional<LeaseInfoInternal>& new_lease) noexcept;
+
+  /**
+   * @brief Caches the new lease once it is written to the database. Must be
+   * called with mutex_ held.
+   *
+   * @param lease_read the lease read from the database.
+   * @param new_lease the lease written over the read lease.
+   * @param write_result the result of the write.
+   * @return core::ExecutionResult the result of the lease refresh.
+   */
+  core::ExecutionResult OnLeaseWritten(
+      const LeaseInfoInternal& lease_read, const LeaseInfoInternal& new_lease,
+      const core::ExecutionResult& write_result) noexcept;
+
   // Database helper functions
+  std::shared_ptr<core::GetDatabaseItemRequest> ConstructReadLeaseRequest();
+  core::ExecutionResult ConstructWriteLeaseRequest(
+      const LeaseInfoInternal& previous_lease,
+      const LeaseInfoInternal& new_lease,
+      std::shared_ptr<core::UpsertDatabaseItemRequest>& request);
   core::ExecutionResult WriteLeaseSynchronouslyToDatabase(
       const LeaseInfoInternal& previous_lease,
       const LeaseInfoInternal& new_lease);
@@ -135,42 +135,57 @@ ExecutionResult LeasableLockOnNoSQLDatabase::ObtainLeaseInfoFromAttributes(
   return SuccessExecutionResult();
 }
 
-ExecutionResult LeasableLockOnNoSQLDatabase::WriteLeaseSynchronouslyToDatabase(
-    const LeaseInfoInternal& previous_lease,
-    const LeaseInfoInternal& new_lease) {
-  atomic<bool> request_executed = false;
+shared_ptr<GetDatabaseItemRequest>
+LeasableLockOnNoSQLDatabase::ConstructReadLeaseRequest() {
+  auto request = make_shared<GetDatabaseItemRequest>();
+  request->table_name = make_shared<string>(table_name_);
+  request->partition_key = make_shared<NoSqlDatabaseKeyValuePair>();
+  request->partition_key->attribute_name =
+      make_shared<string>(kPBSPartitionLockTableLockIdKeyName);
+  request->partition_key->attribute_value =
+      make_shared<NoSQLDatabaseValidAttributeValueTypes>(lock_row_key_);
+  return request;
+}
 
-  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
-      response_context;
-  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
-      request_context(make_shared<UpsertDatabaseItemRequest>(),
-                      [&](auto& context) {
-                        response_context = context;
-                        request_executed = true;
-                      });
-
-  request_context.request->table_name = make_shared<string>(table_name_);
-  request_context.request->partition_key =
-      make_shared<NoSqlDatabaseKeyValuePair>();
-  request_context.request->partition_key->attribute_name =
+ExecutionResult LeasableLockOnNoSQLDatabase::ConstructWriteLeaseRequest(
+    const LeaseInfoInternal& previous_lease, const LeaseInfoInternal& new_lease,
+    shared_ptr<UpsertDatabaseItemRequest>& request) {
+  request = make_shared<UpsertDatabaseItemRequest>();
+  request->table_name = make_shared<string>(table_name_);
+  request->partition_key = make_shared<NoSqlDatabaseKeyValuePair>();
+  request->partition_key->attribute_name =
       make_shared<string>(kPBSPartitionLockTableLockIdKeyName);
-  request_context.request->partition_key->attribute_value =
+  request->partition_key->attribute_value =
       make_shared<NoSQLDatabaseValidAttributeValueTypes>(lock_row_key_);
 
   // Old attributes (conditional statement)
-  request_context.request->attributes =
-      make_shared<vector<NoSqlDatabaseKeyValuePair>>();
-  auto result = ConstructAttributesFromLeaseInfo(
-      previous_lease, request_context.request->attributes);
+  request->attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  auto result =
+      ConstructAttributesFromLeaseInfo(previous_lease, request->attributes);
   if (!result.Successful()) {
     return result;
   }
 
   // New attributes
-  request_context.request->new_attributes =
-      make_shared<vector<NoSqlDatabaseKeyValuePair>>();
-  result = ConstructAttributesFromLeaseInfo(
-      new_lease, request_context.request->new_attributes);
+  request->new_attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  return ConstructAttributesFromLeaseInfo(new_lease, request->new_attributes);
+}
+
+ExecutionResult LeasableLockOnNoSQLDatabase::WriteLeaseSynchronouslyToDatabase(
+    const LeaseInfoInternal& previous_lease,
+    const LeaseInfoInternal& new_lease) {
+  atomic<bool> request_executed = false;
+
+  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
+      response_context;
+  AsyncContext<UpsertDatabaseItemRequest, UpsertDatabaseItemResponse>
+      request_context(nullptr, [&](auto& context) {
+        response_context = context;
+        request_executed = true;
+      });
+
+  auto result = ConstructWriteLeaseRequest(previous_lease, new_lease,
+                                           request_context.request);
   if (!result.Successful()) {
     return result;
   }
@@ -198,19 +213,11 @@ ExecutionResult LeasableLockOnNoSQLDatabase::ReadLeaseSynchronouslyFromDatabase(
   AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse>
       response_context;
   AsyncContext<GetDatabaseItemRequest, GetDatabaseItemResponse> request_context(
-      make_shared<GetDatabaseItemRequest>(), [&](auto& updated_context) {
+      ConstructReadLeaseRequest(), [&](auto& updated_context) {
         response_context = updated_context;
         request_executed = true;
       });
 
-  request_context.request->table_name = make_shared<string>(table_name_);
-  request_context.request->partition_key =
-      make_shared<NoSqlDatabaseKeyValuePair>();
-  request_context.request->partition_key->attribute_name =
-      make_shared<string>(kPBSPartitionLockTableLockIdKeyName);
-  request_context.request->partition_key->attribute_value =
-      make_shared<NoSQLDatabaseValidAttributeValueTypes>(lock_row_key_);
-
   auto result = database_->GetDatabaseItem(request_context);
   if (!result.Successful()) {
     return result;
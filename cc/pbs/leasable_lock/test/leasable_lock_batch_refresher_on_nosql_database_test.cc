@@ -0,0 +1,257 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pbs/leasable_lock/src/leasable_lock_batch_refresher_on_nosql_database.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/interface/nosql_database_provider_interface.h"
+#include "core/lease_manager/mock/mock_leasable_lock_gmock.h"
+#include "core/nosql_database_provider/mock/mock_nosql_database_provider_no_overrides.h"
+#include "pbs/leasable_lock/src/error_codes.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::BatchGetDatabaseItemsRequest;
+using google::scp::core::BatchGetDatabaseItemsResponse;
+using google::scp::core::BatchUpsertDatabaseItemsRequest;
+using google::scp::core::BatchUpsertDatabaseItemsResponse;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::GetDatabaseItemResponse;
+using google::scp::core::LeasableLockInterface;
+using google::scp::core::LeaseInfo;
+using google::scp::core::NoSQLDatabaseAttributeName;
+using google::scp::core::NoSqlDatabaseKeyValuePair;
+using google::scp::core::NoSQLDatabaseProviderInterface;
+using google::scp::core::NoSQLDatabaseValidAttributeValueTypes;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::UpsertDatabaseItemResponse;
+using google::scp::core::common::TimeProvider;
+using google::scp::core::lease_manager::mock::MockLeasableLock;
+using google::scp::core::nosql_database_provider::mock::
+    MockNoSQLDatabaseProviderNoOverrides;
+using google::scp::core::test::ResultIs;
+using std::get;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using ::testing::_;
+using ::testing::Return;
+
+static constexpr char kPBSPartitionLockTableDefaultName[] =
+    "pbs_partition_lock_table";
+
+namespace google::scp::pbs::test {
+/// Returns the attributes of a lock row holding the lease.
+static shared_ptr<vector<NoSqlDatabaseKeyValuePair>> CreateLockRowAttributes(
+    const LeaseInfo& lease_owner_info, milliseconds expiration_timestamp) {
+  auto attributes = make_shared<vector<NoSqlDatabaseKeyValuePair>>();
+  attributes->push_back(
+      {make_shared<NoSQLDatabaseAttributeName>(
+           kPBSPartitionLockTableLeaseOwnerIdAttributeName),
+       make_shared<NoSQLDatabaseValidAttributeValueTypes>(
+           lease_owner_info.lease_acquirer_id)});
+  attributes->push_back(
+      {make_shared<NoSQLDatabaseAttributeName>(
+           kPBSLockTableLeaseOwnerServiceEndpointAddressAttributeName),
+       make_shared<NoSQLDatabaseValidAttributeValueTypes>(
+           lease_owner_info.service_endpoint_address)});
+  attributes->push_back(
+      {make_shared<NoSQLDatabaseAttributeName>(
+           kPBSPartitionLockTableLeaseExpirationTimestampAttributeName),
+       make_shared<NoSQLDatabaseValidAttributeValueTypes>(
+           to_string(expiration_timestamp.count()))});
+  return attributes;
+}
+
+/// Returns the lock row key of the database item.
+template <typename Item>
+static string GetLockRowKey(const Item& item) {
+  return get<string>(*item->partition_key->attribute_value);
+}
+
+class LeasableLockBatchRefresherOnNoSQLDatabaseTest : public ::testing::Test {
+ protected:
+  LeasableLockBatchRefresherOnNoSQLDatabaseTest()
+      : mock_nosql_database_provider_(
+            make_shared<MockNoSQLDatabaseProviderNoOverrides>()),
+        batch_refresher_(mock_nosql_database_provider_) {
+    for (size_t i = 0; i < 3; ++i) {
+      locks_.push_back(make_shared<LeasableLockOnNoSQLDatabase>(
+          mock_nosql_database_provider_, lease_acquirer_1_,
+          kPBSPartitionLockTableDefaultName, to_string(i)));
+    }
+    // Every lock is refreshed by a batch, never on its own.
+    EXPECT_CALL(*mock_nosql_database_provider_, GetDatabaseItem).Times(0);
+    EXPECT_CALL(*mock_nosql_database_provider_, UpsertDatabaseItem).Times(0);
+  }
+
+  /// Makes the batch reads return the rows for the lock row keys in order.
+  void SetLockRows(
+      const vector<shared_ptr<vector<NoSqlDatabaseKeyValuePair>>>& rows,
+      const vector<ExecutionResult>& item_results) {
+    EXPECT_CALL(*mock_nosql_database_provider_, BatchGetDatabaseItems)
+        .WillOnce([=](AsyncContext<BatchGetDatabaseItemsRequest,
+                                   BatchGetDatabaseItemsResponse>& context) {
+          EXPECT_EQ(context.request->items.size(), rows.size());
+          context.response = make_shared<BatchGetDatabaseItemsResponse>();
+          for (size_t i = 0; i < context.request->items.size(); ++i) {
+            EXPECT_EQ(GetLockRowKey(context.request->items[i]), to_string(i));
+            EXPECT_EQ(*context.request->items[i]->table_name,
+                      kPBSPartitionLockTableDefaultName);
+            auto item = make_shared<GetDatabaseItemResponse>();
+            item->attributes = rows[i];
+            context.response->items.push_back(item);
+            context.response->item_results.push_back(item_results[i]);
+          }
+          context.result = SuccessExecutionResult();
+          context.Finish();
+          return SuccessExecutionResult();
+        });
+  }
+
+  vector<shared_ptr<LeasableLockInterface>> GetLocks() {
+    return vector<shared_ptr<LeasableLockInterface>>(locks_.begin(),
+                                                     locks_.end());
+  }
+
+  milliseconds GetTimestampFromNow(milliseconds duration) {
+    return duration_cast<milliseconds>(
+               TimeProvider::GetWallTimestampInNanoseconds()) +
+           duration;
+  }
+
+  LeaseInfo lease_acquirer_1_ = {"123", "10.1.1.1"};
+  LeaseInfo lease_acquirer_2_ = {"456", "10.1.1.2"};
+  shared_ptr<MockNoSQLDatabaseProviderNoOverrides>
+      mock_nosql_database_provider_;
+  LeasableLockBatchRefresherOnNoSQLDatabase batch_refresher_;
+  vector<shared_ptr<LeasableLockOnNoSQLDatabase>> locks_;
+};
+
+TEST_F(LeasableLockBatchRefresherOnNoSQLDatabaseTest,
+       RefreshesLeasesWithOneBatchedReadAndOneBatchedWrite) {
+  // The lease of lock 0 is held by another acquirer, the leases of locks 1
+  // and 2 are expired but only lock 1 may be acquired.
+  SetLockRows({CreateLockRowAttributes(lease_acquirer_2_,
+                                       GetTimestampFromNow(seconds(10))),
+               CreateLockRowAttributes(lease_acquirer_2_, milliseconds(0)),
+               CreateLockRowAttributes(lease_acquirer_2_, milliseconds(0))},
+              {SuccessExecutionResult(), SuccessExecutionResult(),
+               SuccessExecutionResult()});
+  EXPECT_CALL(*mock_nosql_database_provider_, BatchUpsertDatabaseItems)
+      .WillOnce([&](AsyncContext<BatchUpsertDatabaseItemsRequest,
+                                 BatchUpsertDatabaseItemsResponse>& context) {
+        EXPECT_EQ(context.request->items.size(), 1);
+        const auto& item = context.request->items[0];
+        EXPECT_EQ(GetLockRowKey(item), "1");
+        // The write is conditioned on the read lease.
+        EXPECT_EQ(get<string>(*item->attributes->at(0).attribute_value),
+                  lease_acquirer_2_.lease_acquirer_id);
+        EXPECT_EQ(get<string>(*item->new_attributes->at(0).attribute_value),
+                  lease_acquirer_1_.lease_acquirer_id);
+        context.response = make_shared<BatchUpsertDatabaseItemsResponse>();
+        context.response->items.push_back(
+            make_shared<UpsertDatabaseItemResponse>());
+        context.response->item_results.push_back(SuccessExecutionResult());
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+
+  auto results = batch_refresher_.RefreshLeases(GetLocks(),
+                                                {false, false, true});
+  ASSERT_EQ(results.size(), 3);
+  for (const auto& result : results) {
+    EXPECT_SUCCESS(result);
+  }
+
+  EXPECT_FALSE(locks_[0]->IsCurrentLeaseOwner());
+  EXPECT_EQ(locks_[0]->GetCurrentLeaseOwnerInfo(), lease_acquirer_2_);
+  EXPECT_TRUE(locks_[1]->IsCurrentLeaseOwner());
+  EXPECT_FALSE(locks_[2]->IsCurrentLeaseOwner());
+  EXPECT_FALSE(locks_[2]->GetCurrentLeaseOwnerInfo().has_value());
+}
+
+TEST_F(LeasableLockBatchRefresherOnNoSQLDatabaseTest, FailsLocksOneByOne) {
+  // The read of lock 0 fails and the write of lock 1 fails.
+  SetLockRows({nullptr,
+               CreateLockRowAttributes(lease_acquirer_2_, milliseconds(0)),
+               CreateLockRowAttributes(lease_acquirer_2_, milliseconds(0))},
+              {FailureExecutionResult(1234), SuccessExecutionResult(),
+               SuccessExecutionResult()});
+  EXPECT_CALL(*mock_nosql_database_provider_, BatchUpsertDatabaseItems)
+      .WillOnce([&](AsyncContext<BatchUpsertDatabaseItemsRequest,
+                                 BatchUpsertDatabaseItemsResponse>& context) {
+        EXPECT_EQ(context.request->items.size(), 2);
+        context.response = make_shared<BatchUpsertDatabaseItemsResponse>();
+        context.response->items = {nullptr,
+                                   make_shared<UpsertDatabaseItemResponse>()};
+        context.response->item_results = {FailureExecutionResult(5678),
+                                          SuccessExecutionResult()};
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      });
+
+  auto results = batch_refresher_.RefreshLeases(GetLocks(),
+                                                {false, false, false});
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_THAT(results[0], ResultIs(FailureExecutionResult(1234)));
+  EXPECT_THAT(results[1], ResultIs(FailureExecutionResult(5678)));
+  EXPECT_SUCCESS(results[2]);
+  EXPECT_FALSE(locks_[0]->IsCurrentLeaseOwner());
+  EXPECT_FALSE(locks_[1]->IsCurrentLeaseOwner());
+  EXPECT_TRUE(locks_[2]->IsCurrentLeaseOwner());
+}
+
+TEST_F(LeasableLockBatchRefresherOnNoSQLDatabaseTest,
+       FailedBatchFailsAllLocks) {
+  EXPECT_CALL(*mock_nosql_database_provider_, BatchGetDatabaseItems)
+      .WillOnce(Return(FailureExecutionResult(1234)));
+  EXPECT_CALL(*mock_nosql_database_provider_, BatchUpsertDatabaseItems)
+      .Times(0);
+
+  auto results = batch_refresher_.RefreshLeases(GetLocks(),
+                                                {false, false, false});
+  ASSERT_EQ(results.size(), 3);
+  for (const auto& result : results) {
+    EXPECT_THAT(result, ResultIs(FailureExecutionResult(1234)));
+  }
+}
+
+TEST_F(LeasableLockBatchRefresherOnNoSQLDatabaseTest,
+       RefreshesOtherLocksOnTheirOwn) {
+  auto other_lock = make_shared<MockLeasableLock>();
+  EXPECT_CALL(*other_lock, RefreshLease(true))
+      .WillOnce(Return(FailureExecutionResult(1234)));
+  EXPECT_CALL(*mock_nosql_database_provider_, BatchGetDatabaseItems).Times(0);
+
+  auto results = batch_refresher_.RefreshLeases({other_lock}, {true});
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_THAT(results[0], ResultIs(FailureExecutionResult(1234)));
+}
+}  // namespace google::scp::pbs::test
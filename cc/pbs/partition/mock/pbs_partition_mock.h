@@ -59,6 +59,9 @@ class MockPBSPartition : public testing::NiceMock<PBSPartitionInterface> {
                core::GetTransactionManagerStatusResponse& response),
               (override, noexcept));
 
+  MOCK_METHOD(core::ExecutionResult, CatchUpAsStandby, (),
+              (override, noexcept));
+
   std::atomic<core::PartitionLoadUnloadState> partition_state_ =
       core::PartitionLoadUnloadState::Created;
 };
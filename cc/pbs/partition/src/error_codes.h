@@ -54,4 +54,9 @@ DEFINE_ERROR_CODE(SC_PBS_PARTITION_IS_REMOTE_CANNOT_HANDLE_REQUEST,
                   "This is a remote partition and request cannot be handled.",
                   HttpStatusCode::SERVICE_UNAVAILABLE)
 
+DEFINE_ERROR_CODE(SC_PBS_PARTITION_CANNOT_CATCH_UP_AS_STANDBY,
+                  SC_PBS_PARTITION, 0x0009,
+                  "PBS partition cannot catch up as a standby at this time.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 }  // namespace google::scp::core::errors
@@ -38,6 +38,7 @@ using google::scp::core::GetTransactionManagerStatusRequest;
 using google::scp::core::GetTransactionManagerStatusResponse;
 using google::scp::core::GetTransactionStatusRequest;
 using google::scp::core::GetTransactionStatusResponse;
+using google::scp::core::JournalId;
 using google::scp::core::JournalRecoverRequest;
 using google::scp::core::JournalRecoverResponse;
 using google::scp::core::JournalService;
@@ -100,14 +101,17 @@ PBSPartition::PBSPartition(
     const core::PartitionId& partition_id,
     const Dependencies& partition_dependencies,
     std::shared_ptr<std::string> partition_journal_bucket_name,
-    size_t partition_transaction_manager_capacity)
+    size_t partition_transaction_manager_capacity, bool is_standby)
     : partition_id_(partition_id),
       partition_state_(PartitionLoadUnloadState::Created),
       partition_journal_bucket_name_(partition_journal_bucket_name),
       partition_transaction_manager_capacity_(
           partition_transaction_manager_capacity),
       partition_dependencies_(partition_dependencies),
-      requests_seen_count_(0) {}
+      requests_seen_count_(0),
+      is_standby_(is_standby),
+      is_standby_recovered_(false),
+      standby_last_processed_journal_id_(core::kInvalidJournalId) {}
 
 ExecutionResult PBSPartition::Init() noexcept {
   auto current_state = partition_state_.load();
@@ -122,12 +126,22 @@ ExecutionResult PBSPartition::Init() noexcept {
   std::shared_ptr<std::string> partition_id_str =
       std::make_shared<std::string>(ToString(partition_id_));
 
+  // The journal local tier is disabled unless configured. A standby does not
+  // write journals while the partition is owned by another node, and the
+  // local tier directory of the partition belongs to its owner on this node,
+  // so the local tier of a standby is only attached when it is loaded.
+  auto journal_local_tier_path = std::make_shared<std::string>();
+  if (!is_standby_) {
+    partition_dependencies_.config_provider->Get(kJournalServiceLocalTierPath,
+                                                 *journal_local_tier_path);
+  }
+
   journal_service_ = std::make_shared<JournalService>(
       partition_journal_bucket_name_, partition_id_str,
       partition_dependencies_.async_executor,
       partition_dependencies_.blob_store_provider,
       partition_dependencies_.metric_client,
-      partition_dependencies_.config_provider);
+      partition_dependencies_.config_provider, journal_local_tier_path);
 
   checkpoint_service_ = std::make_shared<CheckpointService>(
       partition_journal_bucket_name_, partition_id_str,
@@ -172,13 +186,17 @@ ExecutionResult PBSPartition::Init() noexcept {
   return SuccessExecutionResult();
 }
 
-ExecutionResult PBSPartition::RecoverPartition() {
-  SCP_INFO(kPBSPartition, partition_id_, "Starting log recovery");
+ExecutionResult PBSPartition::RecoverPartition(
+    JournalId start_after_journal_id, JournalId& last_processed_journal_id) {
+  SCP_INFO(kPBSPartition, partition_id_,
+           "Starting log recovery after journal ID: '%llu'",
+           start_after_journal_id);
 
   std::atomic<bool> recovery_completed = false;
   std::atomic<bool> recovery_failed = false;
   AsyncContext<JournalRecoverRequest, JournalRecoverResponse> recovery_context;
   recovery_context.request = std::make_shared<JournalRecoverRequest>();
+  recovery_context.request->start_after_journal_id = start_after_journal_id;
   auto activity_id = Uuid::GenerateUuid();
   recovery_context.parent_activity_id = activity_id;
   recovery_context.correlation_id = activity_id;
@@ -189,6 +207,9 @@ ExecutionResult PBSPartition::RecoverPartition() {
           SCP_CRITICAL(kPBSPartition, partition_id_, recovery_context.result,
                        "Log recovery failed.");
           recovery_failed = true;
+        } else {
+          last_processed_journal_id =
+              recovery_context.response->last_processed_journal_id;
         }
         recovery_completed = true;
       };
@@ -199,7 +220,11 @@ ExecutionResult PBSPartition::RecoverPartition() {
   // Recovery metrics needs to be separately Run because the journal_service_ is
   // not yet Run().
   RETURN_IF_FAILURE(journal_service_->RunRecoveryMetrics());
-  RETURN_IF_FAILURE(journal_service_->Recover(recovery_context));
+  if (auto execution_result = journal_service_->Recover(recovery_context);
+      !execution_result.Successful()) {
+    journal_service_->StopRecoveryMetrics();
+    return execution_result;
+  }
 
   while (!recovery_completed) {
     auto time_elapsed = duration_cast<milliseconds>(
@@ -218,7 +243,39 @@ ExecutionResult PBSPartition::RecoverPartition() {
         core::errors::SC_PBS_PARTITION_RECOVERY_FAILED);
   }
 
-  SCP_INFO(kPBSPartition, partition_id_, "Done with log recovery");
+  SCP_INFO(kPBSPartition, partition_id_,
+           "Done with log recovery. Last processed journal ID: '%llu'",
+           last_processed_journal_id);
+
+  return SuccessExecutionResult();
+}
+
+ExecutionResult PBSPartition::CatchUpAsStandby() noexcept {
+  std::unique_lock lock(standby_recovery_mutex_);
+  auto current_state = partition_state_.load();
+  if (current_state != PartitionLoadUnloadState::Initialized) {
+    SCP_INFO(kPBSPartition, partition_id_,
+             "Cannot catch up as standby at this state. Current State is %llu",
+             static_cast<uint64_t>(current_state));
+    return FailureExecutionResult(
+        core::errors::SC_PBS_PARTITION_CANNOT_CATCH_UP_AS_STANDBY);
+  }
+
+  // The first catch up does a full recovery, the later ones only replay the
+  // journals that the owner of the partition has written in the meantime.
+  auto start_after_journal_id = is_standby_recovered_
+                                    ? standby_last_processed_journal_id_
+                                    : core::kInvalidJournalId;
+  JournalId last_processed_journal_id = core::kInvalidJournalId;
+  RETURN_IF_FAILURE(
+      RecoverPartition(start_after_journal_id, last_processed_journal_id));
+
+  // If no journals were found after the start journal, the last processed
+  // journal stays the same.
+  if (last_processed_journal_id != core::kInvalidJournalId) {
+    standby_last_processed_journal_id_ = last_processed_journal_id;
+  }
+  is_standby_recovered_ = true;
 
   return SuccessExecutionResult();
 }
@@ -236,7 +293,26 @@ ExecutionResult PBSPartition::Load() noexcept {
   SCP_INFO(kPBSPartition, partition_id_, "Loading Partition with ID: %s",
            ToString(partition_id_).c_str());
 
-  RETURN_IF_FAILURE(RecoverPartition());
+  {
+    // If the partition was kept warm as a standby, only the tail of the
+    // journals written since the last catch up needs to be replayed.
+    std::unique_lock lock(standby_recovery_mutex_);
+    if (is_standby_) {
+      // The partition is now owned by this node, so its journals go through
+      // the local tier like those of a partition loaded without a standby.
+      auto journal_local_tier_path = std::make_shared<std::string>();
+      partition_dependencies_.config_provider->Get(kJournalServiceLocalTierPath,
+                                                   *journal_local_tier_path);
+      RETURN_IF_FAILURE(
+          journal_service_->AttachLocalTier(journal_local_tier_path));
+    }
+    auto start_after_journal_id = is_standby_recovered_
+                                      ? standby_last_processed_journal_id_
+                                      : core::kInvalidJournalId;
+    JournalId last_processed_journal_id = core::kInvalidJournalId;
+    RETURN_IF_FAILURE(
+        RecoverPartition(start_after_journal_id, last_processed_journal_id));
+  }
 
   RUN_PBS_PARTITION_COMPONENT(journal_service_);
   RUN_PBS_PARTITION_COMPONENT(budget_key_provider_);
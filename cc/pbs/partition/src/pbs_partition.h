@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "core/interface/blob_storage_provider_interface.h"
@@ -65,10 +66,23 @@ class PBSPartition : public PBSPartitionInterface {
         remote_transaction_manager;
   };
 
+  /**
+   * @brief Construct a new PBSPartition object.
+   *
+   * @param partition_id
+   * @param partition_dependencies
+   * @param partition_journal_bucket_name
+   * @param partition_transaction_manager_capacity
+   * @param is_standby Whether the partition is constructed as a standby of a
+   * partition owned by another node. A standby reads the journals from the
+   * blob storage directly rather than through the journal local tier, which
+   * is attached when the standby is loaded.
+   */
   PBSPartition(const core::PartitionId& partition_id,
                const Dependencies& partition_dependencies,
                std::shared_ptr<std::string> partition_journal_bucket_name,
-               size_t partition_transaction_manager_capacity);
+               size_t partition_transaction_manager_capacity,
+               bool is_standby = false);
 
   core::ExecutionResult Init() noexcept override;
 
@@ -97,13 +111,21 @@ class PBSPartition : public PBSPartitionInterface {
       const core::GetTransactionManagerStatusRequest& request,
       core::GetTransactionManagerStatusResponse& response) noexcept override;
 
+  core::ExecutionResult CatchUpAsStandby() noexcept override;
+
  protected:
   /**
    * @brief Perform Log Recovery on the partition synchronously.
    *
+   * @param start_after_journal_id If valid, only the journals after this
+   * journal id are replayed, otherwise a full recovery is performed.
+   * @param last_processed_journal_id The last journal id replayed by the
+   * recovery.
    * @return core::ExecutionResult
    */
-  core::ExecutionResult RecoverPartition();
+  core::ExecutionResult RecoverPartition(
+      core::JournalId start_after_journal_id,
+      core::JournalId& last_processed_journal_id);
 
   void IncrementRequestCount();
 
@@ -139,6 +161,20 @@ class PBSPartition : public PBSPartitionInterface {
   /// counter which becomes eventually consistent and should be used only for
   /// approximate calculations.
   std::atomic<size_t> requests_seen_count_;
+
+  /// @brief Whether the partition is constructed as a standby.
+  const bool is_standby_;
+
+  /// @brief Serializes standby catch ups with the final catch up of Load().
+  std::mutex standby_recovery_mutex_;
+
+  /// @brief Indicates if the partition has been recovered as a standby, in
+  /// which case Load() only replays the journals after
+  /// standby_last_processed_journal_id_.
+  bool is_standby_recovered_;
+
+  /// @brief The last journal id replayed while in standby.
+  core::JournalId standby_last_processed_journal_id_;
 };
 
 };  // namespace google::scp::pbs
@@ -86,6 +86,11 @@ class RemotePBSPartition : public PBSPartitionInterface {
         core::errors::SC_PBS_PARTITION_IS_REMOTE_CANNOT_HANDLE_REQUEST);
   }
 
+  core::ExecutionResult CatchUpAsStandby() noexcept override {
+    return core::FailureExecutionResult(
+        core::errors::SC_PBS_PARTITION_IS_REMOTE_CANNOT_HANDLE_REQUEST);
+  }
+
  protected:
   std::atomic<core::PartitionLoadUnloadState> partition_state_;
 };
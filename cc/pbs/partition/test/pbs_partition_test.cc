@@ -30,6 +30,7 @@
 #include "core/test/utils/conditional_wait.h"
 #include "core/test/utils/logging_utils.h"
 #include "core/transaction_manager/src/error_codes.h"
+#include "pbs/interface/configuration_keys.h"
 #include "pbs/partition/src/error_codes.h"
 #include "pbs/transactions/src/consume_budget_command.h"
 #include "public/core/test/interface/execution_result_matchers.h"
@@ -65,6 +66,7 @@ using google::scp::cpio::MockMetricClient;
 using google::scp::pbs::ConsumeBudgetCommandRequestInfo;
 
 static constexpr char kPartitionsBucketName[] = "partitions";
+static constexpr char kJournalLocalTierPath[] = "partitions_local_tier";
 
 namespace google::scp::pbs::test {
 class PBSPartitionTest : public testing::Test {
@@ -254,6 +256,118 @@ TEST_F(PBSPartitionTest, PartitionCannotUnloadUntilLoaded) {
   EXPECT_SUCCESS(partition_->Unload());
 }
 
+TEST_F(PBSPartitionTest, PartitionCannotCatchUpAsStandbyUnlessInitialized) {
+  auto expected_result = ResultIs(FailureExecutionResult(
+      core::errors::SC_PBS_PARTITION_CANNOT_CATCH_UP_AS_STANDBY));
+  EXPECT_THAT(partition_->CatchUpAsStandby(), expected_result);
+
+  EXPECT_SUCCESS(partition_->Init());
+  EXPECT_SUCCESS(partition_->Load());
+  EXPECT_THAT(partition_->CatchUpAsStandby(), expected_result);
+
+  EXPECT_SUCCESS(partition_->Unload());
+  EXPECT_THAT(partition_->CatchUpAsStandby(), expected_result);
+}
+
+TEST_F(PBSPartitionTest, StandbyPartitionDoesNotAcceptRequestsUntilLoaded) {
+  EXPECT_SUCCESS(partition_->Init());
+  EXPECT_SUCCESS(partition_->CatchUpAsStandby());
+  EXPECT_SUCCESS(partition_->CatchUpAsStandby());
+
+  EXPECT_EQ(partition_->GetPartitionState(),
+            core::PartitionLoadUnloadState::Initialized);
+  ExecuteAllRequestTypes(
+      RetryExecutionResult(core::errors::SC_PBS_PARTITION_NOT_LOADED));
+
+  EXPECT_SUCCESS(partition_->Load());
+  EXPECT_SUCCESS(partition_->ExecuteRequest(dummy_transaction_request_));
+  EXPECT_SUCCESS(partition_->Unload());
+}
+
+TEST_F(PBSPartitionTest, StandbyPartitionCatchesUpWithPartitionOwner) {
+  // The owner of the partition processes a transaction while another
+  // instance of the partition tails its journals as a standby.
+  auto standby_partition = std::make_shared<PBSPartition>(
+      partition_id_, dependencies_, journal_bucket_name_,
+      transaction_manager_capacity_);
+  EXPECT_SUCCESS(standby_partition->Init());
+  EXPECT_SUCCESS(standby_partition->CatchUpAsStandby());
+
+  EXPECT_SUCCESS(partition_->Init());
+  EXPECT_SUCCESS(partition_->Load());
+  std::atomic<bool> transaction_executed = false;
+  dummy_transaction_request_.callback = [&](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    transaction_executed = true;
+  };
+  EXPECT_SUCCESS(partition_->ExecuteRequest(dummy_transaction_request_));
+  WaitUntil([&]() { return transaction_executed.load(); });
+  EXPECT_SUCCESS(partition_->Unload());
+
+  // The standby replays the journals of the owner and takes over.
+  EXPECT_SUCCESS(standby_partition->CatchUpAsStandby());
+  EXPECT_SUCCESS(standby_partition->Load());
+
+  GetTransactionManagerStatusRequest request;
+  GetTransactionManagerStatusResponse response;
+  EXPECT_SUCCESS(
+      standby_partition->GetTransactionManagerStatus(request, response));
+  EXPECT_SUCCESS(standby_partition->Unload());
+}
+
+TEST_F(PBSPartitionTest, StandbyPartitionCatchesUpWithLocalTierConfigured) {
+  // The owner of the partition writes its journals through the local tier,
+  // while the standby reads them from the blob storage without opening the
+  // local tier directory of the owner.
+  config_provider_->Set(kJournalServiceLocalTierPath, kJournalLocalTierPath);
+  auto owner_local_tier_path = std::filesystem::path(kJournalLocalTierPath) /
+                               core::common::ToString(partition_id_);
+  std::filesystem::remove_all(kJournalLocalTierPath);
+
+  auto standby_partition = std::make_shared<PBSPartition>(
+      partition_id_, dependencies_, journal_bucket_name_,
+      transaction_manager_capacity_, true /* is_standby */);
+  EXPECT_SUCCESS(standby_partition->Init());
+  EXPECT_SUCCESS(standby_partition->CatchUpAsStandby());
+  EXPECT_FALSE(std::filesystem::exists(owner_local_tier_path));
+
+  EXPECT_SUCCESS(partition_->Init());
+  EXPECT_TRUE(std::filesystem::exists(owner_local_tier_path));
+  EXPECT_SUCCESS(partition_->Load());
+  std::atomic<bool> transaction_executed = false;
+  dummy_transaction_request_.callback = [&](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    transaction_executed = true;
+  };
+  EXPECT_SUCCESS(partition_->ExecuteRequest(dummy_transaction_request_));
+  WaitUntil([&]() { return transaction_executed.load(); });
+  EXPECT_SUCCESS(standby_partition->CatchUpAsStandby());
+
+  // The owner ships its journals on unload, and the standby takes over with
+  // its own local tier.
+  EXPECT_SUCCESS(partition_->Unload());
+  std::filesystem::remove_all(kJournalLocalTierPath);
+  EXPECT_SUCCESS(standby_partition->CatchUpAsStandby());
+  EXPECT_SUCCESS(standby_partition->Load());
+  EXPECT_TRUE(std::filesystem::exists(owner_local_tier_path));
+
+  auto transaction_request = GetSampleTransactionRequestContext();
+  transaction_executed = false;
+  transaction_request.callback = [&](auto& context) {
+    EXPECT_SUCCESS(context.result);
+    transaction_executed = true;
+  };
+  EXPECT_SUCCESS(standby_partition->ExecuteRequest(transaction_request));
+  WaitUntil([&]() { return transaction_executed.load(); });
+
+  GetTransactionManagerStatusRequest request;
+  GetTransactionManagerStatusResponse response;
+  EXPECT_SUCCESS(
+      standby_partition->GetTransactionManagerStatus(request, response));
+  EXPECT_SUCCESS(standby_partition->Unload());
+  std::filesystem::remove_all(kJournalLocalTierPath);
+}
+
 TEST_F(PBSPartitionTest, PartitionAcceptsTransactionPhaseRequestAfterLoad) {
   EXPECT_SUCCESS(partition_->Init());
   EXPECT_SUCCESS(partition_->Load());
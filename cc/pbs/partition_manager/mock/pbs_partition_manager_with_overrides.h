@@ -37,6 +37,15 @@ class PBSPartitionManagerWithOverrides : public PBSPartitionManager {
                                                       partition_type);
   }
 
+  std::shared_ptr<PBSPartitionInterface> ConstructStandbyPBSPartition(
+      const core::PartitionId& partition_id) noexcept override {
+    if (construct_partition_override_) {
+      return construct_partition_override_(partition_id,
+                                           core::PartitionType::Local);
+    }
+    return PBSPartitionManager::ConstructStandbyPBSPartition(partition_id);
+  }
+
   void SetConfigProvider(
       const std::shared_ptr<core::ConfigProviderInterface>& config_provider) {
     partition_dependencies_.config_provider = config_provider;
@@ -16,6 +16,8 @@
 
 #include "pbs/partition_manager/src/pbs_partition_manager.h"
 
+#include <chrono>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -40,12 +42,21 @@ using google::scp::core::common::ToString;
 using google::scp::pbs::RemotePBSPartition;
 using std::make_pair;
 using std::make_shared;
+using std::make_unique;
 using std::move;
+using std::mutex;
 using std::shared_ptr;
 using std::string;
+using std::thread;
+using std::unique_lock;
 using std::vector;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
 
 static constexpr char kPBSPartitionManager[] = "PBSPartitionManager";
+static constexpr size_t kDefaultStandbyCatchUpIntervalInMilliseconds = 5000;
+static constexpr size_t kStandbyCatchUpSleepStepInMilliseconds = 100;
+static constexpr size_t kStandbyCatchUpRoundsBeforeDiscarding = 2;
 
 namespace google::scp::pbs {
 
@@ -55,7 +66,10 @@ PBSPartitionManager::PBSPartitionManager(
     : partition_dependencies_(move(partition_dependencies)),
       partition_transaction_manager_capacity_(
           partition_transaction_manager_capacity),
-      is_running_(false) {}
+      is_running_(false),
+      standby_partitions_enabled_(false),
+      standby_catch_up_interval_in_milliseconds_(
+          kDefaultStandbyCatchUpIntervalInMilliseconds) {}
 
 ExecutionResult PBSPartitionManager::Init() noexcept {
   if (is_running_) {
@@ -76,6 +90,26 @@ ExecutionResult PBSPartitionManager::Init() noexcept {
   SCP_INFO(kPBSPartitionManager, kZeroUuid, "Journal Bucket Name: '%s'",
            partition_journal_bucket_name_->c_str());
 
+  if (!partition_dependencies_.config_provider
+           ->Get(kPBSPartitionManagerStandbyPartitionsEnabled,
+                 standby_partitions_enabled_)
+           .Successful()) {
+    standby_partitions_enabled_ = false;
+  }
+
+  if (!partition_dependencies_.config_provider
+           ->Get(kPBSPartitionManagerStandbyCatchUpIntervalInMilliseconds,
+                 standby_catch_up_interval_in_milliseconds_)
+           .Successful()) {
+    standby_catch_up_interval_in_milliseconds_ =
+        kDefaultStandbyCatchUpIntervalInMilliseconds;
+  }
+
+  SCP_INFO(kPBSPartitionManager, kZeroUuid,
+           "Standby partitions enabled: '%d', catch up interval (ms): '%zu'",
+           standby_partitions_enabled_,
+           standby_catch_up_interval_in_milliseconds_);
+
   return SuccessExecutionResult();
 }
 
@@ -85,6 +119,12 @@ ExecutionResult PBSPartitionManager::Run() noexcept {
         core::errors::SC_PBS_PARTITION_MANAGER_ALREADY_RUNNING);
   }
   is_running_ = true;
+
+  if (standby_partitions_enabled_) {
+    standby_catch_up_thread_ =
+        make_unique<thread>([this]() { CatchUpStandbyPartitions(); });
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -96,6 +136,16 @@ ExecutionResult PBSPartitionManager::Stop() noexcept {
 
   is_running_ = false;
 
+  // Standby partitions are only initialized and do not need to be unloaded.
+  if (standby_catch_up_thread_ && standby_catch_up_thread_->joinable()) {
+    standby_catch_up_thread_->join();
+  }
+  vector<core::common::Uuid> standby_partition_ids;
+  RETURN_IF_FAILURE(standby_partitions_map_.Keys(standby_partition_ids));
+  for (const auto& standby_partition_id : standby_partition_ids) {
+    standby_partitions_map_.Erase(standby_partition_id);
+  }
+
   // Unload all of partitions
   vector<core::common::Uuid> loaded_partition_ids;
   RETURN_IF_FAILURE(loaded_partitions_map_.Keys(loaded_partition_ids));
@@ -146,6 +196,123 @@ shared_ptr<PBSPartitionInterface> PBSPartitionManager::ConstructPBSPartition(
                                    partition_transaction_manager_capacity_);
 }
 
+shared_ptr<PBSPartitionInterface>
+PBSPartitionManager::ConstructStandbyPBSPartition(
+    const PartitionId& partition_id) noexcept {
+  return make_shared<PBSPartition>(
+      partition_id, partition_dependencies_, partition_journal_bucket_name_,
+      partition_transaction_manager_capacity_, true /* is_standby */);
+}
+
+ExecutionResult PBSPartitionManager::CreateStandbyPartition(
+    const PartitionId& partition_id) noexcept {
+  auto standby_partition = ConstructStandbyPBSPartition(partition_id);
+  auto execution_result = standby_partition->Init();
+  if (!execution_result.Successful()) {
+    SCP_ERROR(kPBSPartitionManager, partition_id, execution_result,
+              "Cannot initialize standby partition");
+    return execution_result;
+  }
+
+  auto standby_entry =
+      make_shared<PBSPartitionManagerStandbyEntry>(standby_partition);
+  auto standby_entry_pair = make_pair(partition_id, standby_entry);
+  return standby_partitions_map_.Insert(standby_entry_pair, standby_entry);
+}
+
+void PBSPartitionManager::EraseStandbyEntry(
+    const PartitionId& partition_id,
+    const shared_ptr<PBSPartitionManagerStandbyEntry>& standby_entry) noexcept {
+  shared_ptr<PBSPartitionManagerStandbyEntry> current_standby_entry;
+  if (standby_partitions_map_.Find(partition_id, current_standby_entry)
+          .Successful() &&
+      current_standby_entry == standby_entry) {
+    standby_partitions_map_.Erase(partition_id);
+  }
+}
+
+bool PBSPartitionManager::IsLoadedAsRemote(
+    const PartitionId& partition_id) noexcept {
+  shared_ptr<PBSPartitionManagerMapEntry> loaded_partition_entry;
+  return loaded_partitions_map_.Find(partition_id, loaded_partition_entry)
+             .Successful() &&
+         loaded_partition_entry->partition_type == PartitionType::Remote;
+}
+
+void PBSPartitionManager::CatchUpStandbyPartition(
+    const PartitionId& partition_id,
+    const shared_ptr<PBSPartitionManagerStandbyEntry>& standby_entry) noexcept {
+  // A partition acquired by this node is unloaded as remote right before it
+  // is loaded as local, so the standby is only discarded once its partition
+  // has not been loaded as remote for a whole catch up interval, e.g. because
+  // the partition is no longer known to this node.
+  if (IsLoadedAsRemote(partition_id)) {
+    standby_entry->rounds_not_loaded_as_remote = 0;
+  } else {
+    standby_entry->rounds_not_loaded_as_remote++;
+  }
+
+  // The standby is not promoted while it is being caught up, and is neither
+  // caught up nor recreated once it has been promoted.
+  unique_lock<mutex> standby_lock(standby_entry->mutex);
+  if (standby_entry->is_retired) {
+    return;
+  }
+
+  if (standby_entry->rounds_not_loaded_as_remote >=
+      kStandbyCatchUpRoundsBeforeDiscarding) {
+    standby_entry->is_retired = true;
+    standby_lock.unlock();
+    SCP_INFO(kPBSPartitionManager, partition_id,
+             "Discarding the standby of a partition no longer loaded as "
+             "remote");
+    EraseStandbyEntry(partition_id, standby_entry);
+    return;
+  }
+
+  auto execution_result = standby_entry->partition_handle->CatchUpAsStandby();
+  if (execution_result.Successful()) {
+    return;
+  }
+
+  // A failed catch up may have partially replayed the journals, so the
+  // standby is discarded and a fresh one does a full recovery next time.
+  standby_entry->is_retired = true;
+  standby_lock.unlock();
+  SCP_ERROR(kPBSPartitionManager, partition_id, execution_result,
+            "Cannot catch up standby partition. Recreating the standby.");
+  EraseStandbyEntry(partition_id, standby_entry);
+  if (IsLoadedAsRemote(partition_id)) {
+    CreateStandbyPartition(partition_id);
+  }
+}
+
+void PBSPartitionManager::CatchUpStandbyPartitions() noexcept {
+  while (is_running_) {
+    vector<PartitionId> standby_partition_ids;
+    standby_partitions_map_.Keys(standby_partition_ids);
+    for (const auto& standby_partition_id : standby_partition_ids) {
+      if (!is_running_) {
+        return;
+      }
+
+      shared_ptr<PBSPartitionManagerStandbyEntry> standby_entry;
+      if (!standby_partitions_map_.Find(standby_partition_id, standby_entry)
+               .Successful()) {
+        continue;
+      }
+      CatchUpStandbyPartition(standby_partition_id, standby_entry);
+    }
+
+    for (size_t slept_in_milliseconds = 0;
+         is_running_ &&
+         slept_in_milliseconds < standby_catch_up_interval_in_milliseconds_;
+         slept_in_milliseconds += kStandbyCatchUpSleepStepInMilliseconds) {
+      sleep_for(milliseconds(kStandbyCatchUpSleepStepInMilliseconds));
+    }
+  }
+}
+
 ExecutionResult PBSPartitionManager::LoadPartition(
     const PartitionMetadata& partition_metadata) noexcept {
   if (!is_running_) {
@@ -153,8 +320,28 @@ ExecutionResult PBSPartitionManager::LoadPartition(
         core::errors::SC_PBS_PARTITION_MANAGER_NOT_RUNNING);
   }
 
-  shared_ptr<PBSPartitionInterface> partition = ConstructPBSPartition(
-      partition_metadata.partition_id, partition_metadata.partition_type);
+  // A standby of the partition, if present, is already initialized and has
+  // replayed most of the journals, so it is loaded in place of a new one. Its
+  // lock is held until the standby is promoted, so that it is not caught up
+  // or recreated concurrently.
+  shared_ptr<PBSPartitionInterface> partition;
+  shared_ptr<PBSPartitionManagerStandbyEntry> standby_entry;
+  unique_lock<mutex> standby_lock;
+  if (standby_partitions_enabled_ &&
+      partition_metadata.partition_type == PartitionType::Local &&
+      standby_partitions_map_
+          .Find(partition_metadata.partition_id, standby_entry)
+          .Successful()) {
+    standby_lock = unique_lock<mutex>(standby_entry->mutex);
+    if (!standby_entry->is_retired) {
+      partition = standby_entry->partition_handle;
+    }
+  }
+  bool is_standby_partition = partition != nullptr;
+  if (!is_standby_partition) {
+    partition = ConstructPBSPartition(partition_metadata.partition_id,
+                                      partition_metadata.partition_type);
+  }
   auto partition_map_entry =
       make_shared<PBSPartitionManagerMapEntry>(partition_metadata, partition);
   auto partition_map_pair =
@@ -162,6 +349,15 @@ ExecutionResult PBSPartitionManager::LoadPartition(
   RETURN_IF_FAILURE(
       loaded_partitions_map_.Insert(partition_map_pair, partition_map_entry));
 
+  // The standby is only removed once it is owned by loaded_partitions_map_.
+  if (is_standby_partition) {
+    standby_entry->is_retired = true;
+    standby_lock.unlock();
+    EraseStandbyEntry(partition_metadata.partition_id, standby_entry);
+    SCP_INFO(kPBSPartitionManager, partition_metadata.partition_id,
+             "Loading partition from its standby");
+  }
+
   // If the partition manager is unloading while this thread is inserting, we
   // must ensure that the partition is discarded since the unloading thread
   // might miss erasing this due to the race.
@@ -170,12 +366,16 @@ ExecutionResult PBSPartitionManager::LoadPartition(
     return SuccessExecutionResult();
   }
 
-  auto execution_result = partition->Init();
-  if (!execution_result.Successful()) {
-    loaded_partitions_map_.Erase(partition_metadata.partition_id);
-    SCP_ERROR(kPBSPartitionManager, partition_metadata.partition_id,
-              execution_result, "Cannot Load partition");
-    return FailureExecutionResult(core::errors::SC_PBS_PARTITION_LOAD_FAILURE);
+  ExecutionResult execution_result = SuccessExecutionResult();
+  if (!is_standby_partition) {
+    execution_result = partition->Init();
+    if (!execution_result.Successful()) {
+      loaded_partitions_map_.Erase(partition_metadata.partition_id);
+      SCP_ERROR(kPBSPartitionManager, partition_metadata.partition_id,
+                execution_result, "Cannot Load partition");
+      return FailureExecutionResult(
+          core::errors::SC_PBS_PARTITION_LOAD_FAILURE);
+    }
   }
 
   execution_result = partition->Load();
@@ -186,6 +386,17 @@ ExecutionResult PBSPartitionManager::LoadPartition(
     return FailureExecutionResult(core::errors::SC_PBS_PARTITION_LOAD_FAILURE);
   }
 
+  // Keep a warm standby of the remote partition in case this node acquires
+  // it later. Failing to create the standby only means a cold load later.
+  if (standby_partitions_enabled_ &&
+      partition_metadata.partition_type == PartitionType::Remote) {
+    execution_result = CreateStandbyPartition(partition_metadata.partition_id);
+    if (!execution_result.Successful()) {
+      SCP_ERROR(kPBSPartitionManager, partition_metadata.partition_id,
+                execution_result, "Cannot create standby partition");
+    }
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "core/common/concurrent_map/src/concurrent_map.h"
 #include "pbs/interface/pbs_partition_manager_interface.h"
@@ -71,6 +72,64 @@ class PBSPartitionManager : public PBSPartitionManagerInterface {
       const core::PartitionId& partition_id,
       const core::PartitionType& partition_type) noexcept;
 
+  /**
+   * @brief Internal factory method for the standby of a remote partition.
+   *
+   * @param partition_id
+   * @return std::shared_ptr<PBSPartitionInterface>
+   */
+  virtual std::shared_ptr<PBSPartitionInterface> ConstructStandbyPBSPartition(
+      const core::PartitionId& partition_id) noexcept;
+
+  /**
+   * @brief Constructs and initializes a standby for the given remote
+   * partition, which is kept warm by the standby catch up thread until this
+   * node acquires the partition.
+   *
+   * @param partition_id
+   * @return core::ExecutionResult
+   */
+  core::ExecutionResult CreateStandbyPartition(
+      const core::PartitionId& partition_id) noexcept;
+
+  /**
+   * @brief Periodically catches up all the standby partitions with the
+   * journals written by their current owners. Runs on
+   * standby_catch_up_thread_ until the manager is stopped.
+   */
+  void CatchUpStandbyPartitions() noexcept;
+
+  /**
+   * @brief Catches up a single standby partition, or discards it if its
+   * partition is no longer loaded as remote or the catch up fails.
+   *
+   * @param partition_id
+   * @param standby_entry
+   */
+  void CatchUpStandbyPartition(
+      const core::PartitionId& partition_id,
+      const std::shared_ptr<PBSPartitionManagerStandbyEntry>&
+          standby_entry) noexcept;
+
+  /**
+   * @brief Indicates whether the partition is loaded as a remote partition.
+   *
+   * @param partition_id
+   * @return bool
+   */
+  bool IsLoadedAsRemote(const core::PartitionId& partition_id) noexcept;
+
+  /**
+   * @brief Erases the standby entry of the partition, unless it has already
+   * been replaced by another entry.
+   *
+   * @param partition_id
+   * @param standby_entry
+   */
+  void EraseStandbyEntry(const core::PartitionId& partition_id,
+                         const std::shared_ptr<PBSPartitionManagerStandbyEntry>&
+                             standby_entry) noexcept;
+
   /// @brief Dependencies to boot up a partition.
   PBSPartition::Dependencies partition_dependencies_;
 
@@ -88,5 +147,22 @@ class PBSPartitionManager : public PBSPartitionManagerInterface {
                               std::shared_ptr<PBSPartitionManagerMapEntry>,
                               core::common::UuidCompare>
       loaded_partitions_map_;
+
+  /// @brief Indicates if standby partitions are kept for remote partitions.
+  bool standby_partitions_enabled_;
+
+  /// @brief Interval between two catch ups of the standby partitions.
+  size_t standby_catch_up_interval_in_milliseconds_;
+
+  /// @brief Map of standby partitions, i.e. initialized local partitions
+  /// tailing the journals of partitions owned by other nodes. A standby is
+  /// moved to loaded_partitions_map_ once this node loads the partition.
+  core::common::ConcurrentMap<core::PartitionId,
+                              std::shared_ptr<PBSPartitionManagerStandbyEntry>,
+                              core::common::UuidCompare>
+      standby_partitions_map_;
+
+  /// @brief Thread catching up the standby partitions.
+  std::unique_ptr<std::thread> standby_catch_up_thread_;
 };
 }  // namespace google::scp::pbs
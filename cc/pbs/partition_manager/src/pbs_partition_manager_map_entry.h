@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 
@@ -55,4 +56,25 @@ struct PBSPartitionManagerMapEntry {
   std::shared_ptr<core::PartitionAddressUri> partition_address_uri_;
   std::shared_mutex address_mutex_;
 };
+
+/// A standby partition kept warm for a partition owned by another node.
+struct PBSPartitionManagerStandbyEntry {
+  explicit PBSPartitionManagerStandbyEntry(
+      const std::shared_ptr<PBSPartitionInterface>& partition)
+      : partition_handle(partition) {}
+
+  const std::shared_ptr<PBSPartitionInterface> partition_handle;
+
+  /// Serializes the catch ups of the standby with its promotion to a loaded
+  /// partition.
+  std::mutex mutex;
+
+  /// Set once the standby is promoted or discarded, after which it must be
+  /// neither caught up nor promoted. Protected by mutex.
+  bool is_retired = false;
+
+  /// The number of consecutive catch up rounds that found the partition not
+  /// loaded as remote. Only accessed by the standby catch up thread.
+  size_t rounds_not_loaded_as_remote = 0;
+};
 }  // namespace google::scp::pbs
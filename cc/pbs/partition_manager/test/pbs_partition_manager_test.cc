@@ -19,6 +19,7 @@
 
 #include "core/common/concurrent_map/src/error_codes.h"
 #include "core/config_provider/mock/mock_config_provider.h"
+#include "core/test/utils/conditional_wait.h"
 #include "pbs/interface/configuration_keys.h"
 #include "pbs/partition/mock/pbs_partition_mock.h"
 #include "pbs/partition/src/pbs_partition.h"
@@ -34,6 +35,7 @@ using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::Uuid;
 using google::scp::core::config_provider::mock::MockConfigProvider;
 using google::scp::core::test::ResultIs;
+using google::scp::core::test::WaitUntil;
 using google::scp::pbs::PBSPartition;
 using google::scp::pbs::partition::mock::MockPBSPartition;
 using google::scp::pbs::partition_manager::mock::
@@ -152,6 +154,294 @@ TEST_F(PBSPartitionManagerTest, LoadRemotePartitionSuccess) {
   EXPECT_SUCCESS(partition_manager_.LoadPartition(partition_metadata));
 }
 
+TEST_F(PBSPartitionManagerTest,
+       StandbyPartitionIsCaughtUpAndLoadedWhenPartitionBecomesLocal) {
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  mock_config_provider->Set(kJournalServiceBucketName, "budget");
+  mock_config_provider->SetBool(kPBSPartitionManagerStandbyPartitionsEnabled,
+                                true);
+  mock_config_provider->SetInt(
+      kPBSPartitionManagerStandbyCatchUpIntervalInMilliseconds, 10);
+  partition_manager_.SetConfigProvider(mock_config_provider);
+
+  auto remote_partition = make_shared<MockPBSPartition>();
+  auto standby_partition = make_shared<MockPBSPartition>();
+  partition_manager_.construct_partition_override_ =
+      [&](const PartitionId& partition_id,
+          const PartitionType& partition_type) {
+        if (partition_type == PartitionType::Remote) {
+          return remote_partition;
+        }
+        return standby_partition;
+      };
+
+  EXPECT_CALL(*remote_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Load)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Unload)
+      .WillOnce(Return(SuccessExecutionResult()));
+
+  // The standby is initialized once, caught up in the background and then
+  // loaded without being initialized again.
+  std::atomic<size_t> catch_up_count = 0;
+  EXPECT_CALL(*standby_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*standby_partition, CatchUpAsStandby)
+      .WillRepeatedly([&catch_up_count]() {
+        catch_up_count++;
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*standby_partition, GetPartitionState)
+      .WillRepeatedly([&mock_partition = *standby_partition]() {
+        return mock_partition.partition_state_.load();
+      });
+  EXPECT_CALL(*standby_partition, Load)
+      .WillOnce([&mock_partition = *standby_partition]() {
+        mock_partition.partition_state_ =
+            core::PartitionLoadUnloadState::Loaded;
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*standby_partition, Unload)
+      .WillOnce([&mock_partition = *standby_partition]() {
+        mock_partition.partition_state_ =
+            core::PartitionLoadUnloadState::Unloaded;
+        return SuccessExecutionResult();
+      });
+
+  EXPECT_SUCCESS(partition_manager_.Init());
+  EXPECT_SUCCESS(partition_manager_.Run());
+
+  EXPECT_SUCCESS(partition_manager_.LoadPartition(
+      {mock_partition_1_id, PartitionType::Remote, "https://1.1.1.1:9090"}));
+  WaitUntil([&catch_up_count]() { return catch_up_count.load() >= 2; });
+
+  EXPECT_SUCCESS(partition_manager_.UnloadPartition(
+      {mock_partition_1_id, PartitionType::Remote, ""}));
+  EXPECT_SUCCESS(partition_manager_.LoadPartition(
+      {mock_partition_1_id, PartitionType::Local, "https://localhost"}));
+  EXPECT_EQ(*partition_manager_.GetPBSPartition(mock_partition_1_id),
+            standby_partition);
+
+  EXPECT_SUCCESS(partition_manager_.Stop());
+}
+
+TEST_F(PBSPartitionManagerTest, StandbyIsKeptIfThePartitionCannotBeInserted) {
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  mock_config_provider->Set(kJournalServiceBucketName, "budget");
+  mock_config_provider->SetBool(kPBSPartitionManagerStandbyPartitionsEnabled,
+                                true);
+  mock_config_provider->SetInt(
+      kPBSPartitionManagerStandbyCatchUpIntervalInMilliseconds, 10);
+  partition_manager_.SetConfigProvider(mock_config_provider);
+
+  auto remote_partition = make_shared<MockPBSPartition>();
+  auto standby_partition = make_shared<MockPBSPartition>();
+  partition_manager_.construct_partition_override_ =
+      [&](const PartitionId& partition_id,
+          const PartitionType& partition_type) {
+        if (partition_type == PartitionType::Remote) {
+          return remote_partition;
+        }
+        return standby_partition;
+      };
+
+  EXPECT_CALL(*remote_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Load)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Unload)
+      .WillOnce(Return(SuccessExecutionResult()));
+
+  std::atomic<size_t> catch_up_count = 0;
+  EXPECT_CALL(*standby_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*standby_partition, CatchUpAsStandby)
+      .WillRepeatedly([&catch_up_count]() {
+        catch_up_count++;
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*standby_partition, GetPartitionState)
+      .WillRepeatedly([&mock_partition = *standby_partition]() {
+        return mock_partition.partition_state_.load();
+      });
+  EXPECT_CALL(*standby_partition, Load)
+      .WillOnce([&mock_partition = *standby_partition]() {
+        mock_partition.partition_state_ =
+            core::PartitionLoadUnloadState::Loaded;
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*standby_partition, Unload)
+      .WillOnce([&mock_partition = *standby_partition]() {
+        mock_partition.partition_state_ =
+            core::PartitionLoadUnloadState::Unloaded;
+        return SuccessExecutionResult();
+      });
+
+  EXPECT_SUCCESS(partition_manager_.Init());
+  EXPECT_SUCCESS(partition_manager_.Run());
+
+  EXPECT_SUCCESS(partition_manager_.LoadPartition(
+      {mock_partition_1_id, PartitionType::Remote, "https://1.1.1.1:9090"}));
+  WaitUntil([&catch_up_count]() { return catch_up_count.load() >= 1; });
+
+  // The remote partition is still loaded, so the standby cannot be promoted
+  // and is kept for the next load.
+  EXPECT_THAT(partition_manager_.LoadPartition(
+                  {mock_partition_1_id, PartitionType::Local, "https://b"}),
+              ResultIs(FailureExecutionResult(
+                  core::errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS)));
+  EXPECT_EQ(*partition_manager_.GetPBSPartition(mock_partition_1_id),
+            remote_partition);
+
+  EXPECT_SUCCESS(partition_manager_.UnloadPartition(
+      {mock_partition_1_id, PartitionType::Remote, ""}));
+  EXPECT_SUCCESS(partition_manager_.LoadPartition(
+      {mock_partition_1_id, PartitionType::Local, "https://localhost"}));
+  EXPECT_EQ(*partition_manager_.GetPBSPartition(mock_partition_1_id),
+            standby_partition);
+
+  EXPECT_SUCCESS(partition_manager_.Stop());
+}
+
+TEST_F(PBSPartitionManagerTest,
+       StandbyIsDiscardedWhenPartitionIsNoLongerLoadedAsRemote) {
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  mock_config_provider->Set(kJournalServiceBucketName, "budget");
+  mock_config_provider->SetBool(kPBSPartitionManagerStandbyPartitionsEnabled,
+                                true);
+  mock_config_provider->SetInt(
+      kPBSPartitionManagerStandbyCatchUpIntervalInMilliseconds, 10);
+  partition_manager_.SetConfigProvider(mock_config_provider);
+
+  auto remote_partition = make_shared<MockPBSPartition>();
+  auto standby_partition = make_shared<MockPBSPartition>();
+  partition_manager_.construct_partition_override_ =
+      [&](const PartitionId& partition_id,
+          const PartitionType& partition_type) {
+        if (partition_type == PartitionType::Remote) {
+          return remote_partition;
+        }
+        return standby_partition;
+      };
+
+  EXPECT_CALL(*remote_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Load)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Unload)
+      .WillOnce(Return(SuccessExecutionResult()));
+
+  std::atomic<size_t> catch_up_count = 0;
+  EXPECT_CALL(*standby_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*standby_partition, CatchUpAsStandby)
+      .WillRepeatedly([&catch_up_count]() {
+        catch_up_count++;
+        return SuccessExecutionResult();
+      });
+
+  EXPECT_SUCCESS(partition_manager_.Init());
+  EXPECT_SUCCESS(partition_manager_.Run());
+
+  EXPECT_SUCCESS(partition_manager_.LoadPartition(
+      {mock_partition_1_id, PartitionType::Remote, "https://1.1.1.1:9090"}));
+  WaitUntil([&catch_up_count]() { return catch_up_count.load() >= 1; });
+
+  // The partition is no longer known to this node, so the manager drops its
+  // reference to the standby.
+  EXPECT_SUCCESS(partition_manager_.UnloadPartition(
+      {mock_partition_1_id, PartitionType::Remote, ""}));
+  WaitUntil([&]() { return standby_partition.use_count() == 1; });
+
+  EXPECT_SUCCESS(partition_manager_.Stop());
+}
+
+TEST_F(PBSPartitionManagerTest,
+       StandbyFailingToCatchUpIsNotRecreatedOncePartitionIsNotRemote) {
+  auto mock_config_provider = make_shared<MockConfigProvider>();
+  mock_config_provider->Set(kJournalServiceBucketName, "budget");
+  mock_config_provider->SetBool(kPBSPartitionManagerStandbyPartitionsEnabled,
+                                true);
+  mock_config_provider->SetInt(
+      kPBSPartitionManagerStandbyCatchUpIntervalInMilliseconds, 10);
+  partition_manager_.SetConfigProvider(mock_config_provider);
+
+  auto remote_partition = make_shared<MockPBSPartition>();
+  auto standby_partition = make_shared<MockPBSPartition>();
+  auto local_partition = make_shared<MockPBSPartition>();
+  std::atomic<size_t> local_construct_count = 0;
+  partition_manager_.construct_partition_override_ =
+      [&](const PartitionId& partition_id,
+          const PartitionType& partition_type) {
+        if (partition_type == PartitionType::Remote) {
+          return remote_partition;
+        }
+        return local_construct_count++ == 0 ? standby_partition
+                                            : local_partition;
+      };
+
+  EXPECT_CALL(*remote_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Load)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*remote_partition, Unload)
+      .WillOnce(Return(SuccessExecutionResult()));
+
+  // The catch up fails after the remote partition is unloaded, while this
+  // node is about to load the partition.
+  std::atomic<bool> is_catching_up = false;
+  std::atomic<bool> is_remote_unloaded = false;
+  EXPECT_CALL(*standby_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*standby_partition, CatchUpAsStandby)
+      .WillOnce([&]() {
+        is_catching_up = true;
+        WaitUntil([&]() { return is_remote_unloaded.load(); });
+        return FailureExecutionResult(SC_UNKNOWN);
+      });
+  EXPECT_CALL(*standby_partition, Load).Times(0);
+
+  EXPECT_CALL(*local_partition, Init)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_CALL(*local_partition, Load)
+      .WillOnce([&mock_partition = *local_partition]() {
+        mock_partition.partition_state_ =
+            core::PartitionLoadUnloadState::Loaded;
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*local_partition, Unload)
+      .WillOnce([&mock_partition = *local_partition]() {
+        mock_partition.partition_state_ =
+            core::PartitionLoadUnloadState::Unloaded;
+        return SuccessExecutionResult();
+      });
+  EXPECT_CALL(*local_partition, GetPartitionState)
+      .WillRepeatedly([&mock_partition = *local_partition]() {
+        return mock_partition.partition_state_.load();
+      });
+
+  EXPECT_SUCCESS(partition_manager_.Init());
+  EXPECT_SUCCESS(partition_manager_.Run());
+
+  EXPECT_SUCCESS(partition_manager_.LoadPartition(
+      {mock_partition_1_id, PartitionType::Remote, "https://1.1.1.1:9090"}));
+  WaitUntil([&is_catching_up]() { return is_catching_up.load(); });
+  EXPECT_SUCCESS(partition_manager_.UnloadPartition(
+      {mock_partition_1_id, PartitionType::Remote, ""}));
+  is_remote_unloaded = true;
+
+  // The failed standby is discarded rather than promoted or recreated.
+  EXPECT_SUCCESS(partition_manager_.LoadPartition(
+      {mock_partition_1_id, PartitionType::Local, "https://localhost"}));
+  EXPECT_EQ(*partition_manager_.GetPBSPartition(mock_partition_1_id),
+            local_partition);
+  WaitUntil([&]() { return standby_partition.use_count() == 1; });
+  EXPECT_EQ(local_construct_count.load(), 2);
+
+  EXPECT_SUCCESS(partition_manager_.Stop());
+}
+
 static void SetupMocksForAllPartitionMethods(
     shared_ptr<MockPBSPartition> mock_partition) {
   // Partition 1
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "core/interface/errors.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::core::errors {
+
+/// Registers component code as 0x0158 for the PBS partition namespace.
+REGISTER_COMPONENT_CODE(SC_PBS_PARTITION_NAMESPACE, 0x0158)
+
+DEFINE_ERROR_CODE(
+    SC_PBS_PARTITION_NAMESPACE_MIGRATION_PLAN_NOT_SUPPORTED,
+    SC_PBS_PARTITION_NAMESPACE, 0x0001,
+    "Migration plan is only supported with the consistent hash mapping scheme",
+    HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_PBS_PARTITION_NAMESPACE_INVALID_PARTITIONS,
+                  SC_PBS_PARTITION_NAMESPACE, 0x0002,
+                  "The partition list is empty or contains duplicates",
+                  HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_PBS_PARTITION_NAMESPACE_INVALID_MAPPING_SCHEME,
+                  SC_PBS_PARTITION_NAMESPACE, 0x0003,
+                  "The partition mapping scheme is invalid",
+                  HttpStatusCode::BAD_REQUEST)
+
+}  // namespace google::scp::core::errors
@@ -16,14 +16,192 @@
 
 #include "pbs/partition_namespace/src/pbs_partition_namespace.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+#include <vector>
+
+#include "pbs/partition_namespace/src/error_codes.h"
+
+using google::scp::core::ExecutionResultOr;
+using google::scp::core::FailureExecutionResult;
 using google::scp::core::PartitionId;
 using google::scp::core::ResourceId;
+using std::numeric_limits;
+using std::set;
+using std::sort;
+using std::vector;
+
+static constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+static constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+namespace {
+/// Finalizer of MurmurHash3, spreads the bits of the input over the output.
+uint64_t Mix64(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+}  // namespace
 
 namespace google::scp::pbs {
 
+bool PBSPartitionNamespace::RingPoint::operator<(
+    const RingPoint& other) const {
+  if (hash != other.hash) {
+    return hash < other.hash;
+  }
+  // Ties are broken by partition ID so that the ring does not depend on the
+  // order of the partition list.
+  if (partition_id.high != other.partition_id.high) {
+    return partition_id.high < other.partition_id.high;
+  }
+  return partition_id.low < other.partition_id.low;
+}
+
+PBSPartitionNamespace::PBSPartitionNamespace(
+    const vector<PartitionId>& partitions,
+    PartitionMappingScheme mapping_scheme, size_t virtual_nodes_per_partition)
+    : partitions_(partitions),
+      mapping_scheme_(mapping_scheme),
+      virtual_nodes_per_partition_(virtual_nodes_per_partition) {
+  assert(partitions_.size() > 0);
+  if (mapping_scheme_ == PartitionMappingScheme::ConsistentHash) {
+    assert(virtual_nodes_per_partition_ > 0);
+    ring_ = BuildRing(partitions_, virtual_nodes_per_partition_);
+  }
+}
+
+uint64_t PBSPartitionNamespace::GetResourceHash(
+    const ResourceId& resource_id) noexcept {
+  // FNV-1a is used rather than std::hash since the ring must be identical on
+  // every instance irrespective of the standard library in use.
+  uint64_t hash = kFnvOffsetBasis;
+  for (unsigned char c : resource_id) {
+    hash ^= c;
+    hash *= kFnvPrime;
+  }
+  return Mix64(hash);
+}
+
+vector<PBSPartitionNamespace::RingPoint> PBSPartitionNamespace::BuildRing(
+    const vector<PartitionId>& partitions,
+    size_t virtual_nodes_per_partition) noexcept {
+  vector<RingPoint> ring;
+  ring.reserve(partitions.size() * virtual_nodes_per_partition);
+  for (const auto& partition_id : partitions) {
+    for (uint64_t i = 0; i < virtual_nodes_per_partition; i++) {
+      auto hash =
+          Mix64(partition_id.high ^ Mix64(partition_id.low ^ Mix64(i + 1)));
+      ring.push_back({hash, partition_id});
+    }
+  }
+  sort(ring.begin(), ring.end());
+  return ring;
+}
+
+const PartitionId& PBSPartitionNamespace::FindRingOwner(
+    const vector<RingPoint>& ring, uint64_t hash) noexcept {
+  auto it = std::lower_bound(
+      ring.begin(), ring.end(), hash,
+      [](const RingPoint& point, uint64_t value) { return point.hash < value; });
+  if (it == ring.end()) {
+    // Wrap around to the first point of the ring.
+    it = ring.begin();
+  }
+  return it->partition_id;
+}
+
 PartitionId PBSPartitionNamespace::MapResourceToPartition(
     const ResourceId& resource_id) noexcept {
+  if (mapping_scheme_ == PartitionMappingScheme::ConsistentHash) {
+    return FindRingOwner(ring_, GetResourceHash(resource_id));
+  }
   size_t hash_value = resource_hasher_(resource_id);
   return partitions_[(hash_value % partitions_.size())];
 }
+
+ExecutionResultOr<vector<PartitionKeyRangeMigration>>
+PBSPartitionNamespace::GetMigrationPlan(
+    const vector<PartitionId>& target_partitions) const noexcept {
+  if (mapping_scheme_ != PartitionMappingScheme::ConsistentHash) {
+    return FailureExecutionResult(
+        core::errors::SC_PBS_PARTITION_NAMESPACE_MIGRATION_PLAN_NOT_SUPPORTED);
+  }
+
+  // Uuid::operator< only compares the high bits, so compare both halves.
+  auto partition_id_less = [](const PartitionId& left,
+                              const PartitionId& right) {
+    return left.high != right.high ? left.high < right.high
+                                   : left.low < right.low;
+  };
+  set<PartitionId, decltype(partition_id_less)> unique_target_partitions(
+      target_partitions.begin(), target_partitions.end(), partition_id_less);
+  if (target_partitions.empty() ||
+      unique_target_partitions.size() != target_partitions.size()) {
+    return FailureExecutionResult(
+        core::errors::SC_PBS_PARTITION_NAMESPACE_INVALID_PARTITIONS);
+  }
+
+  auto target_ring =
+      BuildRing(target_partitions, virtual_nodes_per_partition_);
+
+  // Every hash between two consecutive points of the union of both rings has
+  // the same owner on each ring as the point that ends the arc.
+  vector<uint64_t> boundaries;
+  boundaries.reserve(ring_.size() + target_ring.size());
+  for (const auto& point : ring_) {
+    boundaries.push_back(point.hash);
+  }
+  for (const auto& point : target_ring) {
+    boundaries.push_back(point.hash);
+  }
+  sort(boundaries.begin(), boundaries.end());
+  boundaries.erase(std::unique(boundaries.begin(), boundaries.end()),
+                   boundaries.end());
+
+  vector<PartitionKeyRangeMigration> plan;
+  auto add_range = [&](uint64_t start_hash, uint64_t end_hash,
+                       const PartitionId& source,
+                       const PartitionId& destination) {
+    if (!plan.empty() && plan.back().end_hash + 1 == start_hash &&
+        plan.back().source_partition_id == source &&
+        plan.back().destination_partition_id == destination) {
+      plan.back().end_hash = end_hash;
+      return;
+    }
+    plan.push_back({start_hash, end_hash, source, destination});
+  };
+
+  for (size_t i = 0; i < boundaries.size(); i++) {
+    auto end_hash = boundaries[i];
+    const auto& source = FindRingOwner(ring_, end_hash);
+    const auto& destination = FindRingOwner(target_ring, end_hash);
+    if (source == destination) {
+      continue;
+    }
+    if (i == 0) {
+      // The first arc wraps around from the last boundary.
+      add_range(0, end_hash, source, destination);
+    } else {
+      add_range(boundaries[i - 1] + 1, end_hash, source, destination);
+    }
+  }
+
+  // The tail of the hash space after the last boundary is owned by the first
+  // point of each ring.
+  if (boundaries.back() != numeric_limits<uint64_t>::max()) {
+    const auto& source = ring_.front().partition_id;
+    const auto& destination = target_ring.front().partition_id;
+    if (source != destination) {
+      add_range(boundaries.back() + 1, numeric_limits<uint64_t>::max(), source,
+                destination);
+    }
+  }
+  return plan;
+}
 }  // namespace google::scp::pbs
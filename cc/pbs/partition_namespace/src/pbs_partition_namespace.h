@@ -16,14 +16,42 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "core/interface/partition_namespace_interface.h"
+#include "public/core/interface/execution_result.h"
 
 namespace google::scp::pbs {
+/**
+ * @brief The scheme used to map resources onto partitions.
+ */
+enum class PartitionMappingScheme {
+  /// hash(resource) % partition_count. Changing the partition count remaps
+  /// almost every resource.
+  Modulo = 0,
+  /// Consistent hash ring with virtual nodes. Changing the partition count
+  /// remaps only the resources owned by the added or removed partitions.
+  ConsistentHash = 1,
+};
+
+/// Default number of points each partition owns on the consistent hash ring.
+static constexpr size_t kDefaultVirtualNodesPerPartition = 128;
+
+/**
+ * @brief A contiguous range of the resource hash space that is owned by a
+ * different partition after a partition set change. Both ends are inclusive.
+ */
+struct PartitionKeyRangeMigration {
+  uint64_t start_hash = 0;
+  uint64_t end_hash = 0;
+  core::PartitionId source_partition_id;
+  core::PartitionId destination_partition_id;
+};
+
 /**
  * @copydoc PartitionNamespaceInterface
  *
@@ -37,12 +65,14 @@ class PBSPartitionNamespace : public core::PartitionNamespaceInterface {
    * deployment configuration file.
    *
    * @param partitions
+   * @param mapping_scheme the scheme used to map resources to partitions.
+   * @param virtual_nodes_per_partition number of ring points per partition
+   * when using the consistent hash scheme.
    */
   explicit PBSPartitionNamespace(
-      const std::vector<core::PartitionId>& partitions)
-      : partitions_(partitions) {
-    assert(partitions_.size() > 0);
-  }
+      const std::vector<core::PartitionId>& partitions,
+      PartitionMappingScheme mapping_scheme = PartitionMappingScheme::Modulo,
+      size_t virtual_nodes_per_partition = kDefaultVirtualNodesPerPartition);
 
   core::PartitionId MapResourceToPartition(
       const core::ResourceId&) noexcept override;
@@ -52,8 +82,55 @@ class PBSPartitionNamespace : public core::PartitionNamespaceInterface {
     return partitions_;
   }
 
+  /**
+   * @brief Computes the ranges of the resource hash space (see
+   * GetResourceHash) that change owners if this namespace's partitions were
+   * replaced by the target partitions. Adjacent ranges with the same source
+   * and destination are merged. Only supported with the consistent hash
+   * scheme.
+   *
+   * @param target_partitions the partition set after the change.
+   * @return ExecutionResultOr<std::vector<PartitionKeyRangeMigration>> the
+   * ranges sorted by start hash.
+   */
+  core::ExecutionResultOr<std::vector<PartitionKeyRangeMigration>>
+  GetMigrationPlan(
+      const std::vector<core::PartitionId>& target_partitions) const noexcept;
+
+  /**
+   * @brief Returns the position of the resource in the consistent hash space.
+   * The hash is stable across processes and platforms.
+   */
+  static uint64_t GetResourceHash(const core::ResourceId& resource_id) noexcept;
+
  protected:
+  /// A virtual node of a partition on the consistent hash ring. It owns the
+  /// hashes in (previous point, point].
+  struct RingPoint {
+    uint64_t hash;
+    core::PartitionId partition_id;
+
+    bool operator<(const RingPoint& other) const;
+  };
+
+  /**
+   * @brief Builds the consistent hash ring sorted by point hash.
+   */
+  static std::vector<RingPoint> BuildRing(
+      const std::vector<core::PartitionId>& partitions,
+      size_t virtual_nodes_per_partition) noexcept;
+
+  /**
+   * @brief Finds the partition owning the hash on the ring.
+   */
+  static const core::PartitionId& FindRingOwner(
+      const std::vector<RingPoint>& ring, uint64_t hash) noexcept;
+
   const std::vector<core::PartitionId> partitions_;
+  const PartitionMappingScheme mapping_scheme_;
+  const size_t virtual_nodes_per_partition_;
+  /// Consistent hash ring, only populated for the consistent hash scheme.
+  std::vector<RingPoint> ring_;
   std::hash<core::ResourceId> resource_hasher_;
 };
 }  // namespace google::scp::pbs
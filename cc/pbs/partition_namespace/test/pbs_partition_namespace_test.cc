@@ -19,11 +19,17 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "core/common/uuid/src/uuid.h"
 #include "core/interface/partition_types.h"
+#include "pbs/partition_namespace/src/error_codes.h"
+#include "public/core/test/interface/execution_result_matchers.h"
 
+using google::scp::core::FailureExecutionResult;
 using google::scp::core::PartitionId;
 using google::scp::core::ResourceId;
+using google::scp::core::test::ResultIs;
 
 namespace google::scp::pbs::test {
 
@@ -110,4 +116,149 @@ TEST(PartitionNamespace, MapResourceIdsMapsMultiplePartitionMultipleResources) {
   EXPECT_EQ(total_resources_mapped, resource_count);
 }
 
+TEST(PartitionNamespace, ConsistentHashMapsResourcesToAllPartitions) {
+  std::vector<PartitionId> partitions = {PartitionId{1, 1}, PartitionId{1, 2},
+                                         PartitionId{1, 3}, PartitionId{1, 4},
+                                         PartitionId{1, 5}};
+  PBSPartitionNamespace partition_namespace(
+      partitions, PartitionMappingScheme::ConsistentHash);
+
+  std::vector<size_t> partition_mapped_counts(partitions.size(), 0);
+  size_t resource_count = 10000;
+  for (int i = 0; i < resource_count; i++) {
+    auto mapped_partition = partition_namespace.MapResourceToPartition(
+        "google" + std::to_string(i) + ".com");
+    for (int j = 0; j < partitions.size(); j++) {
+      if (mapped_partition == partitions[j]) {
+        partition_mapped_counts[j]++;
+      }
+    }
+  }
+
+  // Each partition should get a reasonable share of the resources.
+  for (auto count : partition_mapped_counts) {
+    EXPECT_GT(count, resource_count / partitions.size() / 2);
+    EXPECT_LT(count, resource_count / partitions.size() * 2);
+  }
+}
+
+TEST(PartitionNamespace, ConsistentHashMappingDoesNotDependOnPartitionOrder) {
+  std::vector<PartitionId> partitions = {PartitionId{1, 1}, PartitionId{1, 2},
+                                         PartitionId{1, 3}};
+  std::vector<PartitionId> reversed_partitions(partitions.rbegin(),
+                                               partitions.rend());
+  PBSPartitionNamespace partition_namespace(
+      partitions, PartitionMappingScheme::ConsistentHash);
+  PBSPartitionNamespace reversed_partition_namespace(
+      reversed_partitions, PartitionMappingScheme::ConsistentHash);
+
+  for (int i = 0; i < 1000; i++) {
+    ResourceId resource = std::to_string(i);
+    EXPECT_EQ(partition_namespace.MapResourceToPartition(resource),
+              reversed_partition_namespace.MapResourceToPartition(resource));
+  }
+}
+
+TEST(PartitionNamespace, ConsistentHashAddingPartitionMovesFewResources) {
+  std::vector<PartitionId> partitions = {PartitionId{1, 1}, PartitionId{1, 2},
+                                         PartitionId{1, 3}, PartitionId{1, 4}};
+  auto grown_partitions = partitions;
+  grown_partitions.push_back(PartitionId{1, 5});
+
+  PBSPartitionNamespace partition_namespace(
+      partitions, PartitionMappingScheme::ConsistentHash);
+  PBSPartitionNamespace grown_partition_namespace(
+      grown_partitions, PartitionMappingScheme::ConsistentHash);
+
+  size_t resource_count = 10000;
+  size_t moved_count = 0;
+  for (int i = 0; i < resource_count; i++) {
+    ResourceId resource = std::to_string(i);
+    auto before = partition_namespace.MapResourceToPartition(resource);
+    auto after = grown_partition_namespace.MapResourceToPartition(resource);
+    if (before != after) {
+      // Resources only move to the new partition.
+      EXPECT_EQ(after, grown_partitions.back());
+      moved_count++;
+    }
+  }
+
+  // Roughly 1/5th of the resources should move, unlike with modulo where
+  // almost all of them would.
+  EXPECT_GT(moved_count, 0);
+  EXPECT_LT(moved_count, resource_count * 3 / 10);
+}
+
+TEST(PartitionNamespace, MigrationPlanCoversExactlyTheMovedResources) {
+  std::vector<PartitionId> partitions = {PartitionId{1, 1}, PartitionId{1, 2},
+                                         PartitionId{1, 3}};
+  std::vector<PartitionId> target_partitions = {
+      PartitionId{1, 2}, PartitionId{1, 3}, PartitionId{1, 4},
+      PartitionId{1, 5}};
+
+  PBSPartitionNamespace partition_namespace(
+      partitions, PartitionMappingScheme::ConsistentHash, 16);
+  PBSPartitionNamespace target_partition_namespace(
+      target_partitions, PartitionMappingScheme::ConsistentHash, 16);
+
+  auto plan_or = partition_namespace.GetMigrationPlan(target_partitions);
+  ASSERT_SUCCESS(plan_or.result());
+  auto& plan = *plan_or;
+  ASSERT_FALSE(plan.empty());
+
+  for (int i = 1; i < plan.size(); i++) {
+    EXPECT_LT(plan[i - 1].end_hash, plan[i].start_hash);
+  }
+
+  for (int i = 0; i < 10000; i++) {
+    ResourceId resource = std::to_string(i);
+    auto hash = PBSPartitionNamespace::GetResourceHash(resource);
+    auto before = partition_namespace.MapResourceToPartition(resource);
+    auto after = target_partition_namespace.MapResourceToPartition(resource);
+
+    auto range = std::find_if(plan.begin(), plan.end(), [&](auto& range) {
+      return range.start_hash <= hash && hash <= range.end_hash;
+    });
+    if (before == after) {
+      EXPECT_EQ(range, plan.end());
+    } else {
+      ASSERT_NE(range, plan.end());
+      EXPECT_EQ(range->source_partition_id, before);
+      EXPECT_EQ(range->destination_partition_id, after);
+    }
+  }
+}
+
+TEST(PartitionNamespace, MigrationPlanIsEmptyForSamePartitions) {
+  std::vector<PartitionId> partitions = {PartitionId{1, 1}, PartitionId{1, 2}};
+  PBSPartitionNamespace partition_namespace(
+      partitions, PartitionMappingScheme::ConsistentHash);
+  auto plan_or = partition_namespace.GetMigrationPlan(
+      {PartitionId{1, 2}, PartitionId{1, 1}});
+  ASSERT_SUCCESS(plan_or.result());
+  EXPECT_TRUE(plan_or->empty());
+}
+
+TEST(PartitionNamespace, MigrationPlanFailsOnInvalidInput) {
+  std::vector<PartitionId> partitions = {PartitionId{1, 1}, PartitionId{1, 2}};
+  PBSPartitionNamespace modulo_partition_namespace(partitions);
+  EXPECT_THAT(
+      modulo_partition_namespace.GetMigrationPlan(partitions).result(),
+      ResultIs(FailureExecutionResult(
+          core::errors::
+              SC_PBS_PARTITION_NAMESPACE_MIGRATION_PLAN_NOT_SUPPORTED)));
+
+  PBSPartitionNamespace partition_namespace(
+      partitions, PartitionMappingScheme::ConsistentHash);
+  EXPECT_THAT(partition_namespace.GetMigrationPlan({}).result(),
+              ResultIs(FailureExecutionResult(
+                  core::errors::SC_PBS_PARTITION_NAMESPACE_INVALID_PARTITIONS)));
+  EXPECT_THAT(
+      partition_namespace
+          .GetMigrationPlan({PartitionId{1, 3}, PartitionId{1, 3}})
+          .result(),
+      ResultIs(FailureExecutionResult(
+          core::errors::SC_PBS_PARTITION_NAMESPACE_INVALID_PARTITIONS)));
+}
+
 }  // namespace google::scp::pbs::test
@@ -46,6 +46,17 @@ class MockPrivacyBudgetServiceClient
     return core::SuccessExecutionResult();
   }
 
+  core::ExecutionResult ExecuteConsumeBudgetTransaction(
+      core::AsyncContext<ConsumeBudgetTransactionRequest,
+                         ConsumeBudgetTransactionResponse>&
+          consume_budget_transaction_context) noexcept override {
+    if (execute_consume_budget_transaction_mock) {
+      return execute_consume_budget_transaction_mock(
+          consume_budget_transaction_context);
+    }
+    return core::SuccessExecutionResult();
+  }
+
   core::ExecutionResult ExecuteTransactionPhase(
       core::AsyncContext<core::TransactionPhaseRequest,
                          core::TransactionPhaseResponse>&
@@ -67,11 +78,28 @@ class MockPrivacyBudgetServiceClient
     return core::SuccessExecutionResult();
   }
 
+  core::ExecutionResult BatchGetTransactionStatus(
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&
+          batch_get_transaction_status_context) noexcept override {
+    if (batch_get_transaction_status_mock) {
+      return batch_get_transaction_status_mock(
+          batch_get_transaction_status_context);
+    }
+
+    return core::SuccessExecutionResult();
+  }
+
   std::function<core::ExecutionResult(
       core::AsyncContext<ConsumeBudgetTransactionRequest,
                          ConsumeBudgetTransactionResponse>&)>
       initiate_consume_budget_transaction_mock;
 
+  std::function<core::ExecutionResult(
+      core::AsyncContext<ConsumeBudgetTransactionRequest,
+                         ConsumeBudgetTransactionResponse>&)>
+      execute_consume_budget_transaction_mock;
+
   std::function<core::ExecutionResult(
       core::AsyncContext<core::TransactionPhaseRequest,
                          core::TransactionPhaseResponse>&)>
@@ -81,5 +109,10 @@ class MockPrivacyBudgetServiceClient
       core::AsyncContext<core::GetTransactionStatusRequest,
                          core::GetTransactionStatusResponse>&)>
       get_transaction_status_mock;
+
+  std::function<core::ExecutionResult(
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&)>
+      batch_get_transaction_status_mock;
 };
 }  // namespace google::scp::pbs::client::mock
@@ -63,8 +63,22 @@ class MockPrivacyBudgetServiceClientWithOverrides
         get_transaction_status_context, http_context);
   }
 
+  virtual void OnBatchGetTransactionStatusCallback(
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&
+          batch_get_transaction_status_context,
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>&
+          http_context) noexcept {
+    PrivacyBudgetServiceClient::OnBatchGetTransactionStatusCallback(
+        batch_get_transaction_status_context, http_context);
+  }
+
   std::string GetTransactionStatusUrl() { return *get_transaction_status_url_; }
 
+  std::string GetBatchTransactionStatusUrl() {
+    return *batch_get_transaction_status_url_;
+  }
+
   std::string GetExecuteTransactionBeginPhaseUrl() {
     return *begin_consume_budget_transaction_url_;
   }
@@ -88,5 +102,9 @@ class MockPrivacyBudgetServiceClientWithOverrides
   std::string GetExecuteTransactionEndPhaseUrl() {
     return *end_consume_budget_transaction_url_;
   }
+
+  std::string GetConsumeBudgetTransactionUrl() {
+    return *consume_budget_transaction_url_;
+  }
 };
 }  // namespace google::scp::pbs::client::mock
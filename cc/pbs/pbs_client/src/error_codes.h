@@ -41,4 +41,12 @@ DEFINE_ERROR_CODE(SC_PBS_CLIENT_NO_BUDGET_KEY_PROVIDED, SC_PBS_CLIENT, 0x0004,
 DEFINE_ERROR_CODE(SC_PBS_CLIENT_INVALID_TRANSACTION_METADATA, SC_PBS_CLIENT,
                   0x0005, "Invalid transaction metadata.",
                   HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_PBS_CLIENT_INVALID_BATCH_SIZE, SC_PBS_CLIENT, 0x0006,
+                  "The number of items in the batch is invalid.",
+                  HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_PBS_CLIENT_INVALID_BATCH_RESPONSE, SC_PBS_CLIENT, 0x0007,
+                  "The batch response does not match the batch request.",
+                  HttpStatusCode::BAD_REQUEST)
 }  // namespace google::scp::core::errors
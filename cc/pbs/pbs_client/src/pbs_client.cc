@@ -78,6 +78,8 @@ PrivacyBudgetServiceClient::PrivacyBudgetServiceClient(
       authorization_token_provider_cache_(authorization_token_provider_cache) {
   get_transaction_status_url_ =
       make_shared<string>(pbs_endpoint_ + string(kStatusTransactionPath));
+  batch_get_transaction_status_url_ =
+      make_shared<string>(pbs_endpoint_ + string(kBatchStatusTransactionPath));
   begin_consume_budget_transaction_url_ =
       make_shared<string>(pbs_endpoint_ + string(kBeginTransactionPath));
   prepare_consume_budget_transaction_url_ =
@@ -90,6 +92,8 @@ PrivacyBudgetServiceClient::PrivacyBudgetServiceClient(
       make_shared<string>(pbs_endpoint_ + string(kAbortTransactionPath));
   end_consume_budget_transaction_url_ =
       make_shared<string>(pbs_endpoint_ + string(kEndTransactionPath));
+  consume_budget_transaction_url_ = make_shared<string>(
+      pbs_endpoint_ + string(kConsumeBudgetTransactionPath));
 }
 
 ExecutionResult PrivacyBudgetServiceClient::Init() noexcept {
@@ -201,10 +205,100 @@ void PrivacyBudgetServiceClient::OnGetTransactionStatusCallback(
   get_transaction_status_context.Finish();
 }
 
+ExecutionResult PrivacyBudgetServiceClient::BatchGetTransactionStatus(
+    AsyncContext<BatchGetTransactionStatusRequest,
+                 BatchGetTransactionStatusResponse>&
+        batch_get_transaction_status_context) noexcept {
+  if (!batch_get_transaction_status_context.request ||
+      batch_get_transaction_status_context.request->items.empty() ||
+      batch_get_transaction_status_context.request->items.size() >
+          kMaxBatchStatusTransactionItems) {
+    return FailureExecutionResult(
+        core::errors::SC_PBS_CLIENT_INVALID_BATCH_SIZE);
+  }
+
+  AsyncContext<HttpRequest, HttpResponse> http_context(
+      make_shared<HttpRequest>(),
+      bind(&PrivacyBudgetServiceClient::OnBatchGetTransactionStatusCallback,
+           this, batch_get_transaction_status_context, _1),
+      batch_get_transaction_status_context);
+
+  auto execution_result =
+      FrontEndUtils::SerializeBatchGetTransactionStatusRequest(
+          *batch_get_transaction_status_context.request,
+          http_context.request->body);
+  if (!execution_result.Successful()) {
+    return execution_result;
+  }
+
+  auto auth_token_or = authorization_token_provider_cache_->GetToken();
+  if (!auth_token_or.Successful()) {
+    return auth_token_or.result();
+  }
+
+  // The transaction ids, secrets and origins of the items are in the body.
+  http_context.request->path = batch_get_transaction_status_url_;
+  http_context.request->method = HttpMethod::POST;
+  http_context.request->headers = make_shared<HttpHeaders>();
+  http_context.request->headers->insert(
+      {string(core::kAuthHeader), *auth_token_or.value()});
+  http_context.request->headers->insert(
+      {string(core::kClaimedIdentityHeader), reporting_origin_});
+
+  return http_client_->PerformRequest(http_context);
+}
+
+void PrivacyBudgetServiceClient::OnBatchGetTransactionStatusCallback(
+    AsyncContext<BatchGetTransactionStatusRequest,
+                 BatchGetTransactionStatusResponse>&
+        batch_get_transaction_status_context,
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  if (!http_context.result.Successful()) {
+    batch_get_transaction_status_context.result = http_context.result;
+    batch_get_transaction_status_context.Finish();
+    return;
+  }
+
+  auto response = make_shared<BatchGetTransactionStatusResponse>();
+  auto execution_result =
+      FrontEndUtils::DeserializeBatchGetTransactionStatusResponse(
+          http_context.response->body, *response);
+  if (execution_result.Successful() &&
+      response->items.size() !=
+          batch_get_transaction_status_context.request->items.size()) {
+    execution_result = FailureExecutionResult(
+        core::errors::SC_PBS_CLIENT_INVALID_BATCH_RESPONSE);
+  }
+
+  if (execution_result.Successful()) {
+    batch_get_transaction_status_context.response = response;
+  }
+  batch_get_transaction_status_context.result = execution_result;
+  batch_get_transaction_status_context.Finish();
+}
+
 ExecutionResult PrivacyBudgetServiceClient::InitiateConsumeBudgetTransaction(
     AsyncContext<ConsumeBudgetTransactionRequest,
                  ConsumeBudgetTransactionResponse>&
         consume_budget_transaction_context) noexcept {
+  return SendConsumeBudgetTransactionRequest(
+      consume_budget_transaction_context,
+      begin_consume_budget_transaction_url_);
+}
+
+ExecutionResult PrivacyBudgetServiceClient::ExecuteConsumeBudgetTransaction(
+    AsyncContext<ConsumeBudgetTransactionRequest,
+                 ConsumeBudgetTransactionResponse>&
+        consume_budget_transaction_context) noexcept {
+  return SendConsumeBudgetTransactionRequest(consume_budget_transaction_context,
+                                             consume_budget_transaction_url_);
+}
+
+ExecutionResult PrivacyBudgetServiceClient::SendConsumeBudgetTransactionRequest(
+    AsyncContext<ConsumeBudgetTransactionRequest,
+                 ConsumeBudgetTransactionResponse>&
+        consume_budget_transaction_context,
+    const shared_ptr<string>& url) noexcept {
   string serialized_body;
   auto execution_result = SerializeConsumeBudgetTransactionRequest(
       consume_budget_transaction_context.request, serialized_body);
@@ -219,7 +313,7 @@ ExecutionResult PrivacyBudgetServiceClient::InitiateConsumeBudgetTransaction(
            this, consume_budget_transaction_context, _1),
       consume_budget_transaction_context);
 
-  http_context.request->path = begin_consume_budget_transaction_url_;
+  http_context.request->path = url;
   http_context.request->body = BytesBuffer(serialized_body.length());
   http_context.request->body.bytes =
       make_shared<vector<Byte>>(serialized_body.begin(), serialized_body.end());
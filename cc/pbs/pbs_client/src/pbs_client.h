@@ -61,11 +61,21 @@ class PrivacyBudgetServiceClient : public PrivacyBudgetServiceClientInterface {
                          core::GetTransactionStatusResponse>&
           get_transaction_status_context) noexcept override;
 
+  core::ExecutionResult BatchGetTransactionStatus(
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&
+          batch_get_transaction_status_context) noexcept override;
+
   core::ExecutionResult InitiateConsumeBudgetTransaction(
       core::AsyncContext<ConsumeBudgetTransactionRequest,
                          ConsumeBudgetTransactionResponse>&
           consume_budget_transaction_context) noexcept override;
 
+  core::ExecutionResult ExecuteConsumeBudgetTransaction(
+      core::AsyncContext<ConsumeBudgetTransactionRequest,
+                         ConsumeBudgetTransactionResponse>&
+          consume_budget_transaction_context) noexcept override;
+
   core::ExecutionResult ExecuteTransactionPhase(
       core::AsyncContext<core::TransactionPhaseRequest,
                          core::TransactionPhaseResponse>&
@@ -86,6 +96,21 @@ class PrivacyBudgetServiceClient : public PrivacyBudgetServiceClientInterface {
       core::AsyncContext<core::HttpRequest, core::HttpResponse>&
           http_context) noexcept;
 
+  /**
+   * @brief Is called when the batch get transaction status operation
+   * completes.
+   *
+   * @param batch_get_transaction_status_context The batch get transaction
+   * status context of the operation.
+   * @param http_context The http context of the http operation.
+   */
+  virtual void OnBatchGetTransactionStatusCallback(
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&
+          batch_get_transaction_status_context,
+      core::AsyncContext<core::HttpRequest, core::HttpResponse>&
+          http_context) noexcept;
+
   /**
    * @brief Serializes consume budget transaction request to used for the http
    * request.
@@ -100,6 +125,21 @@ class PrivacyBudgetServiceClient : public PrivacyBudgetServiceClientInterface {
           consume_budget_transaction_request,
       std::string& serialized) noexcept;
 
+  /**
+   * @brief Sends the budgets of the consume budget transaction to the url, for
+   * both initiating a transaction and executing all of its phases at once.
+   *
+   * @param consume_budget_transaction_context The consume budget transaction
+   * context of the operation.
+   * @param url The url of the operation.
+   * @return core::ExecutionResult The execution result of the operation.
+   */
+  core::ExecutionResult SendConsumeBudgetTransactionRequest(
+      core::AsyncContext<ConsumeBudgetTransactionRequest,
+                         ConsumeBudgetTransactionResponse>&
+          consume_budget_transaction_context,
+      const std::shared_ptr<std::string>& url) noexcept;
+
   /**
    * @brief Is called when the consume budget transaction operation completes.
    *
@@ -135,6 +175,8 @@ class PrivacyBudgetServiceClient : public PrivacyBudgetServiceClientInterface {
  protected:
   /// The pre-constructed get transaction status  url.
   std::shared_ptr<std::string> get_transaction_status_url_;
+  /// The pre-constructed batch get transaction status url.
+  std::shared_ptr<std::string> batch_get_transaction_status_url_;
   /// The pre-constructed begin consume budget transaction url.
   std::shared_ptr<std::string> begin_consume_budget_transaction_url_;
   /// The pre-constructed prepare consume budget transaction  url.
@@ -147,6 +189,8 @@ class PrivacyBudgetServiceClient : public PrivacyBudgetServiceClientInterface {
   std::shared_ptr<std::string> abort_consume_budget_transaction_url_;
   /// The pre-constructed end consume budget transaction  url.
   std::shared_ptr<std::string> end_consume_budget_transaction_url_;
+  /// The pre-constructed phase collapsed consume budget transaction url.
+  std::shared_ptr<std::string> consume_budget_transaction_url_;
 
  private:
   /// The reporting origin
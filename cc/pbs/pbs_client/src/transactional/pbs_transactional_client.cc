@@ -70,12 +70,14 @@ PrivacyBudgetServiceTransactionalClient::
         const shared_ptr<HttpClientInterface>& http_client,
         const shared_ptr<AsyncExecutorInterface>& async_executor,
         const shared_ptr<TokenProviderCacheInterface>&
-            authorization_token_provider_cache)
+            authorization_token_provider_cache,
+        bool phase_collapsed_transactions_enabled)
     : PrivacyBudgetServiceTransactionalClient(async_executor, http_client) {
   pbs1_client_ = make_shared<PrivacyBudgetServiceClient>(
       reporting_origin, pbs_endpoint, http_client_,
       authorization_token_provider_cache);
   is_single_coordinator_mode = true;
+  phase_collapsed_transactions_enabled_ = phase_collapsed_transactions_enabled;
 }
 
 PrivacyBudgetServiceTransactionalClient::
@@ -99,6 +101,7 @@ PrivacyBudgetServiceTransactionalClient::
         const shared_ptr<AsyncExecutorInterface>& async_executor,
         const shared_ptr<HttpClientInterface>& http_client)
     : is_single_coordinator_mode(false),
+      phase_collapsed_transactions_enabled_(false),
       async_executor_(async_executor),
       http_client_(http_client),
       max_concurrent_transactions_(100000),
@@ -177,6 +180,13 @@ ExecutionResult PrivacyBudgetServiceTransactionalClient::ConsumeBudget(
     AsyncContext<ConsumeBudgetTransactionRequest,
                  ConsumeBudgetTransactionResponse>&
         consume_budget_transaction_context) noexcept {
+  // The only coordinator executes all the phases of the transaction, so there
+  // is nothing to coordinate on the client.
+  if (is_single_coordinator_mode && phase_collapsed_transactions_enabled_) {
+    return pbs1_client_->ExecuteConsumeBudgetTransaction(
+        consume_budget_transaction_context);
+  }
+
   AsyncContext<TransactionRequest, TransactionResponse> transaction_context(
       make_shared<TransactionRequest>(),
       bind(&PrivacyBudgetServiceTransactionalClient::OnConsumeBudgetCallback,
@@ -46,13 +46,17 @@ class PrivacyBudgetServiceTransactionalClient
    * @param http_client
    * @param async_executor
    * @param pbs_auth_token_cache
+   * @param phase_collapsed_transactions_enabled whether to execute all the
+   * phases of a transaction in a single request, which the endpoint must have
+   * enabled as well.
    */
   PrivacyBudgetServiceTransactionalClient(
       const std::string& reporting_origin, const std::string& pbs_endpoint,
       const std::shared_ptr<core::HttpClientInterface>& http_client,
       const std::shared_ptr<core::AsyncExecutorInterface>& async_executor,
       const std::shared_ptr<core::TokenProviderCacheInterface>&
-          authorization_token_provider_cache);
+          authorization_token_provider_cache,
+      bool phase_collapsed_transactions_enabled = false);
 
   /**
    * @brief Construct a new Privacy Budget Service Transactional Client object
@@ -110,6 +114,9 @@ class PrivacyBudgetServiceTransactionalClient
 
   /// Indicates whether this is a single coordinator client.
   bool is_single_coordinator_mode;
+  /// Indicates whether the transactions of a single coordinator client are
+  /// executed in a single request.
+  bool phase_collapsed_transactions_enabled_;
   /// An instance of the async executor.
   std::shared_ptr<core::AsyncExecutorInterface> async_executor_;
   /// The http client to call the endpoints.
@@ -29,6 +29,7 @@
 #include "core/interface/authorization_service_interface.h"
 #include "core/token_provider_cache/mock/token_provider_cache_mock.h"
 #include "pbs/front_end_service/src/error_codes.h"
+#include "pbs/front_end_service/src/front_end_utils.h"
 #include "pbs/pbs_client/mock/mock_pbs_client_with_overrides.h"
 #include "pbs/pbs_client/src/error_codes.h"
 #include "public/core/test/interface/execution_result_matchers.h"
@@ -60,6 +61,7 @@ using google::scp::core::common::Uuid;
 using google::scp::core::http2_client::mock::MockHttpClient;
 using google::scp::core::test::ResultIs;
 using google::scp::core::token_provider_cache::mock::MockTokenProviderCache;
+using google::scp::pbs::FrontEndUtils;
 using google::scp::pbs::PrivacyBudgetServiceClient;
 using google::scp::pbs::client::mock::
     MockPrivacyBudgetServiceClientWithOverrides;
@@ -151,6 +153,10 @@ TEST_F(PBSClientTest, ValidateEndpointUrls) {
             "http://www.pbs_endpoint.com/v1/transactions:end");
   EXPECT_EQ(privacy_budget_service_client.GetTransactionStatusUrl(),
             "http://www.pbs_endpoint.com/v1/transactions:status");
+  EXPECT_EQ(privacy_budget_service_client.GetBatchTransactionStatusUrl(),
+            "http://www.pbs_endpoint.com/v1/transactions:batch-status");
+  EXPECT_EQ(privacy_budget_service_client.GetConsumeBudgetTransactionUrl(),
+            "http://www.pbs_endpoint.com/v1/transactions:consume-budget");
 }
 
 TEST_F(PBSClientTest, InitiateConsumeBudgetTransactionHttpClientFailures) {
@@ -283,6 +289,70 @@ TEST_F(PBSClientTest, InitiateConsumeBudgetTransaction) {
   EXPECT_EQ(is_called, true);
 }
 
+TEST_F(PBSClientTest, ExecuteConsumeBudgetTransaction) {
+  PrivacyBudgetServiceClient privacy_budget_service_client(
+      reporting_origin_, pbs_endpoint_, http_client_,
+      auth_token_provider_cache_);
+
+  AsyncContext<ConsumeBudgetTransactionRequest,
+               ConsumeBudgetTransactionResponse>
+      consume_budget_transaction_context;
+  consume_budget_transaction_context.request =
+      make_shared<ConsumeBudgetTransactionRequest>();
+  consume_budget_transaction_context.request->transaction_id =
+      Uuid::GenerateUuid();
+  consume_budget_transaction_context.request->transaction_secret =
+      make_shared<string>("This is secret");
+
+  auto budget_keys = make_shared<vector<ConsumeBudgetMetadata>>();
+  ConsumeBudgetMetadata metadata;
+  metadata.budget_key_name = make_shared<string>("test_budget_key");
+  metadata.time_bucket = 1576135250000000000;
+  metadata.token_count = 1;
+  budget_keys->push_back(metadata);
+  consume_budget_transaction_context.request->budget_keys = budget_keys;
+
+  bool finished = false;
+  consume_budget_transaction_context.callback =
+      [&](AsyncContext<ConsumeBudgetTransactionRequest,
+                       ConsumeBudgetTransactionResponse>& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(context.response->last_execution_timestamp, 1234);
+        finished = true;
+      };
+
+  mock_http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        EXPECT_EQ(
+            *http_context.request->path,
+            "http://www.pbs_endpoint.com/v1/transactions:consume-budget");
+        EXPECT_EQ(http_context.request->method, HttpMethod::POST);
+        EXPECT_EQ(
+            http_context.request->headers->find(string(kTransactionIdHeader))
+                ->second,
+            ToString(
+                consume_budget_transaction_context.request->transaction_id));
+
+        string body(http_context.request->body.bytes->begin(),
+                    http_context.request->body.bytes->end());
+        EXPECT_EQ(body,
+                  "{\"t\":[{\"key\":\"test_budget_key\",\"reporting_time\":"
+                  "\"2019-12-12T07:20:50Z\",\"token\":1}],\"v\":\"1.0\"}");
+
+        http_context.response = make_shared<HttpResponse>();
+        http_context.response->headers = make_shared<HttpHeaders>();
+        http_context.response->headers->insert(
+            {string(kTransactionLastExecutionTimestampHeader), "1234"});
+        http_context.result = SuccessExecutionResult();
+        http_context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  EXPECT_SUCCESS(privacy_budget_service_client.ExecuteConsumeBudgetTransaction(
+      consume_budget_transaction_context));
+  EXPECT_TRUE(finished);
+}
+
 TEST_F(PBSClientTest, OnInitiateConsumeBudgetTransactionCallbackHttpFailure) {
   MockPrivacyBudgetServiceClientWithOverrides privacy_budget_service_client(
       reporting_origin_, pbs_endpoint_, http_client_,
@@ -833,4 +903,129 @@ TEST_F(PBSClientTest, OnGetTransactionStatusCallback) {
   EXPECT_TRUE(is_called);
 }
 
+TEST_F(PBSClientTest, BatchGetTransactionStatus) {
+  PrivacyBudgetServiceClient privacy_budget_service_client(
+      reporting_origin_, pbs_endpoint_, http_client_,
+      auth_token_provider_cache_);
+
+  AsyncContext<BatchGetTransactionStatusRequest,
+               BatchGetTransactionStatusResponse>
+      batch_context;
+  batch_context.request = make_shared<BatchGetTransactionStatusRequest>();
+  EXPECT_THAT(
+      privacy_budget_service_client.BatchGetTransactionStatus(batch_context),
+      ResultIs(FailureExecutionResult(
+          core::errors::SC_PBS_CLIENT_INVALID_BATCH_SIZE)));
+
+  batch_context.request->items.push_back(
+      GetSampleGetTransactionStatusRequest());
+  batch_context.request->items.push_back(
+      GetSampleGetTransactionStatusRequest());
+  batch_context.request->items[1]->transaction_origin = nullptr;
+
+  bool is_called = false;
+  mock_http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        EXPECT_EQ(http_context.request->method, HttpMethod::POST);
+        EXPECT_EQ(*http_context.request->path,
+                  "http://www.pbs_endpoint.com/v1/transactions:batch-status");
+        EXPECT_EQ(http_context.request->headers
+                      ->find(string(core::kClaimedIdentityHeader))
+                      ->second,
+                  reporting_origin_);
+        EXPECT_EQ(
+            http_context.request->headers->find(kTransactionIdHeader),
+            http_context.request->headers->end());
+
+        vector<shared_ptr<GetTransactionStatusRequest>> items;
+        EXPECT_SUCCESS(
+            FrontEndUtils::DeserializeBatchGetTransactionStatusRequest(
+                http_context.request->body, items));
+        EXPECT_EQ(items.size(), 2);
+        EXPECT_EQ(items[0]->transaction_id,
+                  batch_context.request->items[0]->transaction_id);
+        EXPECT_EQ(*items[0]->transaction_secret, "This is secret");
+        EXPECT_EQ(*items[0]->transaction_origin,
+                  "This is transaction origin");
+        EXPECT_EQ(items[1]->transaction_id,
+                  batch_context.request->items[1]->transaction_id);
+        EXPECT_EQ(items[1]->transaction_origin, nullptr);
+        is_called = true;
+        return SuccessExecutionResult();
+      };
+  EXPECT_SUCCESS(
+      privacy_budget_service_client.BatchGetTransactionStatus(batch_context));
+  EXPECT_TRUE(is_called);
+}
+
+TEST_F(PBSClientTest, OnBatchGetTransactionStatusCallback) {
+  MockPrivacyBudgetServiceClientWithOverrides privacy_budget_service_client(
+      reporting_origin_, pbs_endpoint_, http_client_,
+      auth_token_provider_cache_);
+
+  AsyncContext<BatchGetTransactionStatusRequest,
+               BatchGetTransactionStatusResponse>
+      batch_context;
+  batch_context.request = make_shared<BatchGetTransactionStatusRequest>();
+  batch_context.request->items.push_back(
+      GetSampleGetTransactionStatusRequest());
+  batch_context.request->items.push_back(
+      GetSampleGetTransactionStatusRequest());
+
+  AsyncContext<HttpRequest, HttpResponse> http_context;
+  auto set_response_body = [&](const string& body) {
+    http_context.result = SuccessExecutionResult();
+    http_context.response = make_shared<HttpResponse>();
+    http_context.response->body.capacity = body.length();
+    http_context.response->body.length = body.length();
+    http_context.response->body.bytes =
+        make_shared<vector<Byte>>(body.begin(), body.end());
+  };
+
+  ExecutionResult batch_result;
+  batch_context.callback =
+      [&](AsyncContext<BatchGetTransactionStatusRequest,
+                       BatchGetTransactionStatusResponse>& batch_context) {
+        batch_result = batch_context.result;
+      };
+  http_context.result = RetryExecutionResult(1234);
+  privacy_budget_service_client.OnBatchGetTransactionStatusCallback(
+      batch_context, http_context);
+  EXPECT_THAT(batch_result, ResultIs(RetryExecutionResult(1234)));
+
+  // The response must have as many items as the request.
+  set_response_body(
+      "{\"v\":\"1.0\",\"t\":[{\"status\":1,\"status_code\":0}]}");
+  privacy_budget_service_client.OnBatchGetTransactionStatusCallback(
+      batch_context, http_context);
+  EXPECT_THAT(batch_result,
+              ResultIs(FailureExecutionResult(
+                  core::errors::SC_PBS_CLIENT_INVALID_BATCH_RESPONSE)));
+
+  set_response_body(
+      "{\"v\":\"1.0\",\"t\":[{\"status\":1,\"status_code\":1234},"
+      "{\"status\":0,\"status_code\":0,\"has_failures\":true,"
+      "\"is_expired\":false,\"last_execution_timestamp\":1234512313,"
+      "\"transaction_execution_phase\":\"NOTIFY\"}]}");
+  shared_ptr<BatchGetTransactionStatusResponse> response;
+  batch_context.callback =
+      [&](AsyncContext<BatchGetTransactionStatusRequest,
+                       BatchGetTransactionStatusResponse>& batch_context) {
+        batch_result = batch_context.result;
+        response = batch_context.response;
+      };
+  privacy_budget_service_client.OnBatchGetTransactionStatusCallback(
+      batch_context, http_context);
+  EXPECT_SUCCESS(batch_result);
+  ASSERT_NE(response, nullptr);
+  ASSERT_EQ(response->items.size(), 2);
+  EXPECT_THAT(response->item_results[0],
+              ResultIs(FailureExecutionResult(1234)));
+  EXPECT_EQ(response->items[0], nullptr);
+  EXPECT_SUCCESS(response->item_results[1]);
+  EXPECT_EQ(response->items[1]->has_failure, true);
+  EXPECT_EQ(response->items[1]->last_execution_timestamp, 1234512313);
+  EXPECT_EQ(response->items[1]->transaction_execution_phase,
+            TransactionExecutionPhase::Notify);
+}
 }  // namespace google::scp::pbs::test
@@ -164,6 +164,14 @@ class DummyPBSClient : public PrivacyBudgetServiceClientInterface {
     return core::FailureExecutionResult(SC_UNKNOWN);
   }
 
+  core::ExecutionResult BatchGetTransactionStatus(
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&
+          batch_get_transaction_status_context) noexcept override {
+    // Not required for single coordinator testing
+    return core::FailureExecutionResult(SC_UNKNOWN);
+  }
+
   core::ExecutionResult InitiateConsumeBudgetTransaction(
       core::AsyncContext<ConsumeBudgetTransactionRequest,
                          ConsumeBudgetTransactionResponse>&
@@ -172,6 +180,14 @@ class DummyPBSClient : public PrivacyBudgetServiceClientInterface {
     return core::FailureExecutionResult(SC_UNKNOWN);
   }
 
+  core::ExecutionResult ExecuteConsumeBudgetTransaction(
+      core::AsyncContext<ConsumeBudgetTransactionRequest,
+                         ConsumeBudgetTransactionResponse>&
+          consume_budget_transaction_context) noexcept override {
+    // Not required for single coordinator testing
+    return core::FailureExecutionResult(SC_UNKNOWN);
+  }
+
   core::ExecutionResult ExecuteTransactionPhase(
       core::AsyncContext<core::TransactionPhaseRequest,
                          core::TransactionPhaseResponse>&
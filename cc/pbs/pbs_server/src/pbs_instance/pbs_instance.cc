@@ -94,6 +94,7 @@ using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::GrpcAuthConfig;
 using google::scp::core::Http1CurlClient;
+using google::scp::core::Http1CurlMultiEngine;
 using google::scp::core::Http2Server;
 using google::scp::core::HttpClient;
 using google::scp::core::HttpClientInterface;
@@ -170,8 +171,14 @@ ExecutionResult PBSInstance::CreateComponents() noexcept {
   io_async_executor_ = make_shared<AsyncExecutor>(
       pbs_instance_config_.io_async_executor_thread_pool_size,
       pbs_instance_config_.io_async_executor_queue_size);
-  http1_client_ =
-      make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  if (pbs_instance_config_.http1_curl_multi_engine_enabled) {
+    http1_client_ = make_shared<Http1CurlClient>(
+        async_executor_, io_async_executor_,
+        make_shared<Http1CurlMultiEngine>());
+  } else {
+    http1_client_ =
+        make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  }
   http2_client_ = make_shared<HttpClient>(async_executor_);
 
   async_executor_for_leasable_lock_nosql_database_ = make_shared<AsyncExecutor>(
@@ -266,13 +273,14 @@ ExecutionResult PBSInstance::CreateComponents() noexcept {
       platform_dependency_factory->ConstructBlobStorageClient(
           async_executor_, io_async_executor_);
 
-  remote_transaction_manager_ =
-      make_shared<RemoteTransactionManager>(remote_coordinator_pbs_client_);
+  remote_transaction_manager_ = make_shared<RemoteTransactionManager>(
+      remote_coordinator_pbs_client_,
+      pbs_instance_config_.remote_transaction_status_batch_size);
   journal_service_ = make_shared<JournalService>(
       pbs_instance_config_.journal_bucket_name,
       pbs_instance_config_.journal_partition_name, async_executor_,
       blob_storage_provider_for_journal_service_, metric_client_,
-      config_provider_);
+      config_provider_, pbs_instance_config_.journal_local_tier_path);
   // TODO: b/297262889 Make a distinction between the live-traffic and
   // background NoSQL operations.
   budget_key_provider_ = make_shared<BudgetKeyProvider>(
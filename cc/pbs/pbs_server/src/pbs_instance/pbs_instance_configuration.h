@@ -54,9 +54,14 @@ struct PBSInstanceConfig {
   size_t http2server_thread_pool_size = 256;
   size_t async_executor_thread_pool_size_for_lease_db_requests = 2;
   size_t async_executor_queue_size_for_lease_db_requests = 10000;
+  size_t remote_transaction_status_batch_size = 1;
+  bool batched_lease_refresh_enabled = false;
+  size_t budget_key_write_back_batch_size = 1;
+  bool http1_curl_multi_engine_enabled = false;
 
   std::shared_ptr<std::string> journal_bucket_name;
   std::shared_ptr<std::string> journal_partition_name;
+  std::shared_ptr<std::string> journal_local_tier_path;
 
   std::shared_ptr<std::string> host_address;
   std::shared_ptr<std::string> host_port;
@@ -227,6 +232,28 @@ GetPBSInstanceConfigFromConfigProvider(
     }
   }
 
+  // Status inquiries are not batched unless configured, since the remote
+  // coordinator might not support batches yet.
+  config_provider->Get(
+      kRemoteTransactionStatusBatchSize,
+      pbs_instance_config.remote_transaction_status_batch_size);
+
+  config_provider->Get(kPBSBatchedLeaseRefreshEnabled,
+                       pbs_instance_config.batched_lease_refresh_enabled);
+
+  // Budget key write-backs are not batched unless configured.
+  config_provider->Get(kPBSBudgetKeyWriteBackBatchSize,
+                       pbs_instance_config.budget_key_write_back_batch_size);
+
+  // HTTP/1 requests block an IO thread each unless configured otherwise.
+  config_provider->Get(kPBSHttp1CurlMultiEngineEnabled,
+                       pbs_instance_config.http1_curl_multi_engine_enabled);
+
+  // The journal local tier is disabled unless configured.
+  pbs_instance_config.journal_local_tier_path = std::make_shared<std::string>();
+  config_provider->Get(kJournalServiceLocalTierPath,
+                       *pbs_instance_config.journal_local_tier_path);
+
   // Lease related configurations
   // Partition Lease
   std::string partition_lease_table_name;
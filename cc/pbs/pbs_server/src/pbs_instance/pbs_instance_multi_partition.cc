@@ -47,6 +47,8 @@
 #include "core/lease_manager/src/v2/component_lifecycle_lease_event_sink.h"
 #include "core/lease_manager/src/v2/lease_manager_v2.h"
 #include "core/lease_manager/src/v2/lease_refresher_factory.h"
+#include "core/lease_manager/src/v2/multi_lease_refresher_factory.h"
+#include "core/nosql_database_provider/src/common/batching_nosql_database_provider.h"
 #include "core/tcp_traffic_forwarder/src/tcp_traffic_forwarder_socat.h"
 #include "core/transaction_manager/src/transaction_manager.h"
 #include "pbs/budget_key_provider/src/budget_key_provider.h"
@@ -55,8 +57,10 @@
 #include "pbs/front_end_service/src/transaction_request_router.h"
 #include "pbs/health_service/src/health_service.h"
 #include "pbs/interface/configuration_keys.h"
+#include "pbs/leasable_lock/src/leasable_lock_batch_refresher_on_nosql_database.h"
 #include "pbs/leasable_lock/src/leasable_lock_on_nosql_database.h"
 #include "pbs/partition_lease_event_sink/src/partition_lease_event_sink.h"
+#include "pbs/partition_namespace/src/error_codes.h"
 #include "pbs/partition_request_router/src/http_request_route_resolver_for_partition.h"
 #include "pbs/partition_request_router/src/transaction_request_router_for_partition.h"
 #include "pbs/pbs_server/src/pbs_instance/pbs_instance_logging.h"
@@ -85,6 +89,7 @@ using google::scp::core::ExecutionResult;
 using google::scp::core::ExecutionResultOr;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::Http1CurlClient;
+using google::scp::core::Http1CurlMultiEngine;
 using google::scp::core::Http2Forwarder;
 using google::scp::core::Http2Server;
 using google::scp::core::HttpClient;
@@ -105,6 +110,8 @@ using google::scp::core::LeaseInfo;
 using google::scp::core::LeaseManagerInterface;
 using google::scp::core::LeaseManagerV2;
 using google::scp::core::LeaseRefresherFactory;
+using google::scp::core::LeaseRefresherFactoryInterface;
+using google::scp::core::MultiLeaseRefresherFactory;
 using google::scp::core::LeaseReleaseNotificationInterface;
 using google::scp::core::LeaseStatisticsInterface;
 using google::scp::core::LeaseTransitionType;
@@ -129,12 +136,14 @@ using google::scp::core::common::RetryStrategyType;
 using google::scp::core::common::TimeProvider;
 using google::scp::core::common::ToString;
 using google::scp::core::common::Uuid;
+using google::scp::core::nosql_database_provider::BatchingNoSQLDatabaseProvider;
 using google::scp::pbs::BudgetKeyProvider;
 using google::scp::pbs::BudgetKeyProviderInterface;
 using google::scp::pbs::CheckpointService;
 using google::scp::pbs::FrontEndService;
 using google::scp::pbs::FrontEndServiceInterface;
 using google::scp::pbs::HealthService;
+using google::scp::pbs::LeasableLockBatchRefresherOnNoSQLDatabase;
 using google::scp::pbs::LeasableLockOnNoSQLDatabase;
 using google::scp::pbs::RemoteTransactionManager;
 using google::scp::pbs::TransactionCommandSerializer;
@@ -192,6 +201,21 @@ static ExecutionResultOr<vector<PartitionId>> GetPartitionIds(
   return partition_ids;
 }
 
+static ExecutionResultOr<PartitionMappingScheme> GetPartitionMappingScheme(
+    const shared_ptr<ConfigProviderInterface>& config_provider) {
+  string mapping_scheme;
+  if (!config_provider->Get(kPBSPartitionMappingScheme, mapping_scheme)
+           .Successful() ||
+      mapping_scheme.empty() || mapping_scheme == "modulo") {
+    return PartitionMappingScheme::Modulo;
+  }
+  if (mapping_scheme == "consistent_hash") {
+    return PartitionMappingScheme::ConsistentHash;
+  }
+  return FailureExecutionResult(
+      core::errors::SC_PBS_PARTITION_NAMESPACE_INVALID_MAPPING_SCHEME);
+}
+
 pair<string, string> PBSInstanceMultiPartition::GetInstanceIDAndIPv4Address() {
   pair<string, string> instance_id_and_ipv4_pair;
   string resource_name;
@@ -262,8 +286,14 @@ ExecutionResult PBSInstanceMultiPartition::ConstructDependencies() noexcept {
   io_async_executor_ = make_shared<AsyncExecutor>(
       pbs_instance_config_.io_async_executor_thread_pool_size,
       pbs_instance_config_.io_async_executor_queue_size);
-  http1_client_ =
-      make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  if (pbs_instance_config_.http1_curl_multi_engine_enabled) {
+    http1_client_ = make_shared<Http1CurlClient>(
+        async_executor_, io_async_executor_,
+        make_shared<Http1CurlMultiEngine>());
+  } else {
+    http1_client_ =
+        make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  }
   http2_client_ = make_shared<HttpClient>(async_executor_);
 
   http2_client_for_forwarder_ = make_shared<HttpClient>(
@@ -324,22 +354,45 @@ ExecutionResult PBSInstanceMultiPartition::ConstructDependencies() noexcept {
       platform_dependency_factory_->ConstructNoSQLDatabaseClient(
           async_executor_, io_async_executor_,
           kDefaultAsyncPriorityForCallbackExecution, AsyncPriority::Normal);
+  // The background operations are the budget key write-backs on eviction,
+  // which can be batched.
+  if (pbs_instance_config_.budget_key_write_back_batch_size > 1) {
+    nosql_database_provider_for_background_operations_ =
+        make_shared<BatchingNoSQLDatabaseProvider>(
+            nosql_database_provider_for_background_operations_,
+            pbs_instance_config_.budget_key_write_back_batch_size);
+  }
   nosql_database_provider_for_live_traffic_ =
       platform_dependency_factory_->ConstructNoSQLDatabaseClient(
           async_executor_, io_async_executor_,
           kDefaultAsyncPriorityForCallbackExecution, AsyncPriority::High);
-  remote_transaction_manager_ =
-      make_shared<RemoteTransactionManager>(remote_coordinator_pbs_client_);
+  remote_transaction_manager_ = make_shared<RemoteTransactionManager>(
+      remote_coordinator_pbs_client_,
+      pbs_instance_config_.remote_transaction_status_batch_size);
 
   // Two Lease Managers
   // 1. Partition Lease Manager
   // 2. Virtual Node Lease Manager
-  auto lease_refresher_factory = make_shared<LeaseRefresherFactory>();
+  // With batched lease refresh, the leases of each lease manager are refreshed
+  // together in one round.
+  shared_ptr<LeaseRefresherFactoryInterface> partition_lease_refresher_factory =
+      make_shared<LeaseRefresherFactory>();
+  shared_ptr<LeaseRefresherFactoryInterface> vnode_lease_refresher_factory =
+      partition_lease_refresher_factory;
+  if (pbs_instance_config_.batched_lease_refresh_enabled) {
+    auto leasable_lock_batch_refresher =
+        make_shared<LeasableLockBatchRefresherOnNoSQLDatabase>(
+            nosql_database_provider_for_leasable_lock_);
+    partition_lease_refresher_factory =
+        make_shared<MultiLeaseRefresherFactory>(leasable_lock_batch_refresher);
+    vnode_lease_refresher_factory =
+        make_shared<MultiLeaseRefresherFactory>(leasable_lock_batch_refresher);
+  }
   auto partition_lease_manager_service =
-      make_shared<LeaseManagerV2>(lease_refresher_factory);
+      make_shared<LeaseManagerV2>(partition_lease_refresher_factory);
   partition_lease_manager_service_ = partition_lease_manager_service;
   auto vnode_lease_manager_service = make_shared<LeaseManagerV2>(
-      lease_refresher_factory,
+      vnode_lease_refresher_factory,
       LeaseAcquisitionPreference{1 /* single vnode */,
                                  {} /* no specific preference */});
   vnode_lease_manager_service_ = vnode_lease_manager_service;
@@ -369,7 +422,16 @@ ExecutionResult PBSInstanceMultiPartition::ConstructDependencies() noexcept {
           partition_lease_manager_service),
       metric_client_, config_provider_,
       pbs_instance_config_.partition_lease_duration_in_seconds);
-  partition_namespace_ = make_shared<PBSPartitionNamespace>(partition_ids_);
+  size_t virtual_nodes_per_partition = kDefaultVirtualNodesPerPartition;
+  if (!config_provider_
+           ->Get(kPBSPartitionMappingVirtualNodesPerPartition,
+                 virtual_nodes_per_partition)
+           .Successful() ||
+      virtual_nodes_per_partition == 0) {
+    virtual_nodes_per_partition = kDefaultVirtualNodesPerPartition;
+  }
+  partition_namespace_ = make_shared<PBSPartitionNamespace>(
+      partition_ids_, partition_mapping_scheme_, virtual_nodes_per_partition);
 
   // Partition Lease Preference Applier
   partition_lease_preference_applier_ =
@@ -451,6 +513,8 @@ ExecutionResult PBSInstanceMultiPartition::Init() noexcept {
   // Read configurations of Partition Ids and PBS Virtual Node Ids
   ASSIGN_OR_RETURN(partition_ids_, GetPartitionIds(config_provider_));
   ASSIGN_OR_RETURN(pbs_vnode_ids_, GetVirtualNodeIds(config_provider_));
+  ASSIGN_OR_RETURN(partition_mapping_scheme_,
+                   GetPartitionMappingScheme(config_provider_));
 
   SCP_INFO(kPBSInstance, kZeroUuid,
            "Init PBS with '%llu' partitions, and '%llu' PBS virtual nodes",
@@ -137,6 +137,8 @@ class PBSInstanceMultiPartition : public core::ServiceInterface {
       request_route_resolver_;
   PBSPartition::Dependencies partition_dependencies_;
   std::vector<core::PartitionId> partition_ids_;
+  PartitionMappingScheme partition_mapping_scheme_ =
+      PartitionMappingScheme::Modulo;
 
   // PBS Virtual Node Ids
   std::vector<core::PartitionId> pbs_vnode_ids_;
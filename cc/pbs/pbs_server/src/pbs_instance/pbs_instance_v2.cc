@@ -90,6 +90,7 @@ using google::scp::core::ConfigProviderInterface;
 using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::Http1CurlClient;
+using google::scp::core::Http1CurlMultiEngine;
 using google::scp::core::Http2Forwarder;
 using google::scp::core::Http2Server;
 using google::scp::core::HttpClient;
@@ -329,8 +330,14 @@ ExecutionResult PBSInstanceV2::ConstructDependencies() noexcept {
   io_async_executor_ = make_shared<AsyncExecutor>(
       pbs_instance_config_.io_async_executor_thread_pool_size,
       pbs_instance_config_.io_async_executor_queue_size);
-  http1_client_ =
-      make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  if (pbs_instance_config_.http1_curl_multi_engine_enabled) {
+    http1_client_ = make_shared<Http1CurlClient>(
+        async_executor_, io_async_executor_,
+        make_shared<Http1CurlMultiEngine>());
+  } else {
+    http1_client_ =
+        make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  }
   http2_client_ = make_shared<HttpClient>(async_executor_);
 
   async_executor_for_leasable_lock_nosql_database_ = make_shared<AsyncExecutor>(
@@ -373,8 +380,9 @@ ExecutionResult PBSInstanceV2::ConstructDependencies() noexcept {
   nosql_database_provider_ =
       platform_dependency_factory_->ConstructNoSQLDatabaseClient(
           async_executor_, io_async_executor_);
-  remote_transaction_manager_ =
-      make_shared<RemoteTransactionManager>(remote_coordinator_pbs_client_);
+  remote_transaction_manager_ = make_shared<RemoteTransactionManager>(
+      remote_coordinator_pbs_client_,
+      pbs_instance_config_.remote_transaction_status_batch_size);
 
   // Partition Dependencies
   partition_dependencies_.async_executor = async_executor_;
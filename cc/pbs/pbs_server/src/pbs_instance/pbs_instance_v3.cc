@@ -43,6 +43,7 @@ using ::google::scp::core::ConfigProviderInterface;
 using ::google::scp::core::ExecutionResult;
 using ::google::scp::core::FailureExecutionResult;
 using ::google::scp::core::Http1CurlClient;
+using ::google::scp::core::Http1CurlMultiEngine;
 using ::google::scp::core::Http2Server;
 using ::google::scp::core::HttpClient;
 using ::google::scp::core::PassThruAuthorizationProxy;
@@ -68,8 +69,14 @@ ExecutionResult PBSInstanceV3::CreateComponents() noexcept {
   io_async_executor_ = std::make_shared<AsyncExecutor>(
       pbs_instance_config_.io_async_executor_thread_pool_size,
       pbs_instance_config_.io_async_executor_queue_size);
-  http1_client_ =
-      std::make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  if (pbs_instance_config_.http1_curl_multi_engine_enabled) {
+    http1_client_ = std::make_shared<Http1CurlClient>(
+        async_executor_, io_async_executor_,
+        std::make_shared<Http1CurlMultiEngine>());
+  } else {
+    http1_client_ =
+        std::make_shared<Http1CurlClient>(async_executor_, io_async_executor_);
+  }
   http2_client_ = std::make_shared<HttpClient>(async_executor_);
 
   // Factory should be initialized before the other components are constructed.
@@ -16,12 +16,17 @@
 
 #include "remote_transaction_manager.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "core/common/global_logger/src/global_logger.h"
 #include "core/common/uuid/src/uuid.h"
+#include "core/http2_client/src/error_codes.h"
 #include "core/http2_client/src/http2_client.h"
 #include "pbs/front_end_service/src/front_end_utils.h"
 #include "pbs/interface/type_def.h"
@@ -41,17 +46,31 @@ using google::scp::core::TransactionExecutionPhase;
 using google::scp::core::TransactionPhaseRequest;
 using google::scp::core::TransactionPhaseResponse;
 using google::scp::core::common::ToString;
+using google::scp::core::errors::SC_HTTP2_CLIENT_HTTP_STATUS_METHOD_NOT_ALLOWED;
+using google::scp::core::errors::SC_HTTP2_CLIENT_HTTP_STATUS_NOT_FOUND;
+using google::scp::core::errors::SC_HTTP2_CLIENT_HTTP_STATUS_NOT_IMPLEMENTED;
 using google::scp::core::common::Uuid;
 using google::scp::pbs::PrivacyBudgetServiceClient;
 using std::bind;
+using std::lock_guard;
 using std::make_shared;
+using std::min;
 using std::shared_ptr;
 using std::string;
+using std::vector;
+using std::placeholders::_1;
+
+static constexpr char kRemoteTransactionManager[] = "RemoteTransactionManager";
 
 namespace google::scp::pbs {
 RemoteTransactionManager::RemoteTransactionManager(
-    const std::shared_ptr<PrivacyBudgetServiceClientInterface>& pbs_client)
-    : pbs_client_(pbs_client) {}
+    const std::shared_ptr<PrivacyBudgetServiceClientInterface>& pbs_client,
+    size_t status_batch_size)
+    : pbs_client_(pbs_client),
+      status_batch_size_(
+          min(status_batch_size, kMaxBatchStatusTransactionItems)),
+      is_status_batch_in_flight_(false),
+      is_status_batch_unsupported_(false) {}
 
 ExecutionResult RemoteTransactionManager::Init() noexcept {
   return SuccessExecutionResult();
@@ -68,7 +87,118 @@ ExecutionResult RemoteTransactionManager::Stop() noexcept {
 ExecutionResult RemoteTransactionManager::GetTransactionStatus(
     AsyncContext<GetTransactionStatusRequest, GetTransactionStatusResponse>&
         get_transaction_status_context) noexcept {
-  return pbs_client_->GetTransactionStatus(get_transaction_status_context);
+  if (status_batch_size_ <= 1 || is_status_batch_unsupported_) {
+    return pbs_client_->GetTransactionStatus(get_transaction_status_context);
+  }
+
+  {
+    lock_guard lock(pending_status_contexts_mutex_);
+    pending_status_contexts_.push_back(get_transaction_status_context);
+    if (is_status_batch_in_flight_) {
+      return SuccessExecutionResult();
+    }
+    is_status_batch_in_flight_ = true;
+  }
+
+  SendPendingStatusBatches();
+  return SuccessExecutionResult();
+}
+
+void RemoteTransactionManager::SendPendingStatusBatches() noexcept {
+  while (true) {
+    vector<GetTransactionStatusContext> status_contexts;
+    {
+      lock_guard lock(pending_status_contexts_mutex_);
+      if (pending_status_contexts_.empty()) {
+        is_status_batch_in_flight_ = false;
+        return;
+      }
+
+      auto batch_size =
+          min(pending_status_contexts_.size(), status_batch_size_);
+      status_contexts.assign(pending_status_contexts_.begin(),
+                             pending_status_contexts_.begin() + batch_size);
+      pending_status_contexts_.erase(
+          pending_status_contexts_.begin(),
+          pending_status_contexts_.begin() + batch_size);
+    }
+
+    if (is_status_batch_unsupported_) {
+      SendStatusInquiriesOneByOne(status_contexts);
+      continue;
+    }
+
+    AsyncContext<BatchGetTransactionStatusRequest,
+                 BatchGetTransactionStatusResponse>
+        batch_context(
+            make_shared<BatchGetTransactionStatusRequest>(),
+            bind(&RemoteTransactionManager::
+                     OnBatchGetTransactionStatusCallback,
+                 this, status_contexts, _1),
+            status_contexts.front());
+    for (const auto& status_context : status_contexts) {
+      batch_context.request->items.push_back(status_context.request);
+    }
+
+    auto execution_result =
+        pbs_client_->BatchGetTransactionStatus(batch_context);
+    if (execution_result.Successful()) {
+      // The callback of the batch sends the next one.
+      return;
+    }
+    SendStatusInquiriesOneByOne(status_contexts);
+  }
+}
+
+void RemoteTransactionManager::OnBatchGetTransactionStatusCallback(
+    const vector<GetTransactionStatusContext>& status_contexts,
+    AsyncContext<BatchGetTransactionStatusRequest,
+                 BatchGetTransactionStatusResponse>& batch_context) noexcept {
+  auto contexts = status_contexts;
+  if (!batch_context.result.Successful() || !batch_context.response ||
+      batch_context.response->item_results.size() != contexts.size() ||
+      batch_context.response->items.size() != contexts.size()) {
+    if (IsStatusBatchUnsupported(batch_context.result) &&
+        !is_status_batch_unsupported_.exchange(true)) {
+      SCP_WARNING_CONTEXT(kRemoteTransactionManager, batch_context,
+                          "The remote coordinator does not support batches "
+                          "of transaction status inquiries. Sending them one "
+                          "by one from now on.");
+    }
+    SendStatusInquiriesOneByOne(contexts);
+  } else {
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      contexts[i].result = batch_context.response->item_results[i];
+      if (contexts[i].result.Successful()) {
+        contexts[i].response = batch_context.response->items[i];
+      }
+      contexts[i].Finish();
+    }
+  }
+
+  SendPendingStatusBatches();
+}
+
+bool RemoteTransactionManager::IsStatusBatchUnsupported(
+    const ExecutionResult& execution_result) noexcept {
+  return execution_result ==
+             FailureExecutionResult(SC_HTTP2_CLIENT_HTTP_STATUS_NOT_FOUND) ||
+         execution_result ==
+             FailureExecutionResult(
+                 SC_HTTP2_CLIENT_HTTP_STATUS_METHOD_NOT_ALLOWED) ||
+         execution_result == FailureExecutionResult(
+                                 SC_HTTP2_CLIENT_HTTP_STATUS_NOT_IMPLEMENTED);
+}
+
+void RemoteTransactionManager::SendStatusInquiriesOneByOne(
+    vector<GetTransactionStatusContext>& status_contexts) noexcept {
+  for (auto& status_context : status_contexts) {
+    auto execution_result = pbs_client_->GetTransactionStatus(status_context);
+    if (!execution_result.Successful()) {
+      status_context.result = execution_result;
+      status_context.Finish();
+    }
+  }
 }
 
 ExecutionResult RemoteTransactionManager::ExecutePhase(
@@ -16,8 +16,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "core/common/operation_dispatcher/src/operation_dispatcher.h"
 #include "core/interface/async_executor_interface.h"
@@ -29,12 +33,23 @@
 
 namespace google::scp::pbs {
 /*! @copydoc RemoteTransactionManagerInterface
+ *
+ * Each instance talks to a single remote coordinator through its PBS client.
  */
 class RemoteTransactionManager
     : public core::RemoteTransactionManagerInterface {
  public:
+  /**
+   * @brief Constructs a new Remote Transaction Manager object.
+   *
+   * @param pbs_client The client of the remote coordinator.
+   * @param status_batch_size The maximum number of transaction status
+   * inquiries sent in a single request. Inquiries are sent one by one if this
+   * is 1.
+   */
   RemoteTransactionManager(
-      const std::shared_ptr<PrivacyBudgetServiceClientInterface>& pbs_client);
+      const std::shared_ptr<PrivacyBudgetServiceClientInterface>& pbs_client,
+      size_t status_batch_size = 1);
 
   core::ExecutionResult Init() noexcept override;
 
@@ -53,7 +68,61 @@ class RemoteTransactionManager
           transaction_phase_context) noexcept override;
 
  protected:
+  using GetTransactionStatusContext =
+      core::AsyncContext<core::GetTransactionStatusRequest,
+                         core::GetTransactionStatusResponse>;
+
+  /**
+   * @brief Sends the pending status inquiries in batches of up to
+   * status_batch_size_, one batch at a time. The inquiries which arrive while
+   * a batch is in flight are sent together in the next batch, so the batches
+   * grow with the load without delaying the inquiries when the load is low.
+   */
+  virtual void SendPendingStatusBatches() noexcept;
+
+  /**
+   * @brief Is called when a batch of status inquiries completes.
+   *
+   * @param status_contexts The status inquiries of the batch.
+   * @param batch_context The context of the batch operation.
+   */
+  virtual void OnBatchGetTransactionStatusCallback(
+      const std::vector<GetTransactionStatusContext>& status_contexts,
+      core::AsyncContext<BatchGetTransactionStatusRequest,
+                         BatchGetTransactionStatusResponse>&
+          batch_context) noexcept;
+
+  /**
+   * @brief Returns whether the failure of a batch means that the remote
+   * coordinator does not support batches, e.g. it predates the batch
+   * endpoint.
+   *
+   * @param execution_result The result of the batch.
+   */
+  static bool IsStatusBatchUnsupported(
+      const core::ExecutionResult& execution_result) noexcept;
+
+  /**
+   * @brief Sends the status inquiries of a failed batch one by one, e.g. when
+   * the remote coordinator does not support batches.
+   *
+   * @param status_contexts The status inquiries of the batch.
+   */
+  virtual void SendStatusInquiriesOneByOne(
+      std::vector<GetTransactionStatusContext>& status_contexts) noexcept;
+
   /// An instance of the PBS client.
   std::shared_ptr<PrivacyBudgetServiceClientInterface> pbs_client_;
+  /// The maximum number of status inquiries in a batch.
+  const size_t status_batch_size_;
+  /// Mutex to protect the pending status inquiries.
+  std::mutex pending_status_contexts_mutex_;
+  /// The status inquiries waiting for the batch in flight to complete.
+  std::deque<GetTransactionStatusContext> pending_status_contexts_;
+  /// Whether a batch of status inquiries is in flight.
+  bool is_status_batch_in_flight_;
+  /// Whether the remote coordinator does not support batches, in which case
+  /// the status inquiries are sent one by one from then on.
+  std::atomic<bool> is_status_batch_unsupported_;
 };
 }  // namespace google::scp::pbs
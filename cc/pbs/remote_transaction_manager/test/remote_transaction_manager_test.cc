@@ -0,0 +1,257 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pbs/remote_transaction_manager/src/remote_transaction_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/common/uuid/src/uuid.h"
+#include "core/http2_client/src/error_codes.h"
+#include "pbs/pbs_client/mock/mock_pbs_client.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FailureExecutionResult;
+using google::scp::core::GetTransactionStatusRequest;
+using google::scp::core::GetTransactionStatusResponse;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::common::Uuid;
+using google::scp::core::errors::SC_HTTP2_CLIENT_HTTP_STATUS_NOT_FOUND;
+using google::scp::core::test::ResultIs;
+using google::scp::pbs::client::mock::MockPrivacyBudgetServiceClient;
+using std::make_shared;
+using std::shared_ptr;
+using std::vector;
+
+namespace google::scp::pbs::test {
+class RemoteTransactionManagerTest : public testing::Test {
+ protected:
+  RemoteTransactionManagerTest()
+      : mock_pbs_client_(make_shared<MockPrivacyBudgetServiceClient>()) {}
+
+  /// Returns a status inquiry which records its result once finished.
+  AsyncContext<GetTransactionStatusRequest, GetTransactionStatusResponse>
+  CreateStatusContext(vector<ExecutionResult>& results) {
+    AsyncContext<GetTransactionStatusRequest, GetTransactionStatusResponse>
+        context(make_shared<GetTransactionStatusRequest>(),
+                [&results](AsyncContext<GetTransactionStatusRequest,
+                                        GetTransactionStatusResponse>&
+                               context) { results.push_back(context.result); });
+    context.request->transaction_id = Uuid::GenerateUuid();
+    return context;
+  }
+
+  shared_ptr<MockPrivacyBudgetServiceClient> mock_pbs_client_;
+};
+
+TEST_F(RemoteTransactionManagerTest, StatusInquiriesAreNotBatchedByDefault) {
+  RemoteTransactionManager remote_transaction_manager(mock_pbs_client_);
+
+  size_t status_count = 0;
+  mock_pbs_client_->get_transaction_status_mock =
+      [&](AsyncContext<GetTransactionStatusRequest,
+                       GetTransactionStatusResponse>&) {
+        status_count++;
+        return SuccessExecutionResult();
+      };
+  mock_pbs_client_->batch_get_transaction_status_mock =
+      [&](AsyncContext<BatchGetTransactionStatusRequest,
+                       BatchGetTransactionStatusResponse>&) {
+        ADD_FAILURE();
+        return SuccessExecutionResult();
+      };
+
+  vector<ExecutionResult> results;
+  for (int i = 0; i < 3; ++i) {
+    auto context = CreateStatusContext(results);
+    EXPECT_SUCCESS(remote_transaction_manager.GetTransactionStatus(context));
+  }
+  EXPECT_EQ(status_count, 3);
+}
+
+TEST_F(RemoteTransactionManagerTest, BatchesInquiriesWhileBatchInFlight) {
+  RemoteTransactionManager remote_transaction_manager(mock_pbs_client_,
+                                                      /*status_batch_size=*/3);
+
+  vector<AsyncContext<BatchGetTransactionStatusRequest,
+                      BatchGetTransactionStatusResponse>>
+      batch_contexts;
+  // Finishing a batch sends the next one, which must not move the former.
+  batch_contexts.reserve(10);
+  mock_pbs_client_->batch_get_transaction_status_mock =
+      [&](AsyncContext<BatchGetTransactionStatusRequest,
+                       BatchGetTransactionStatusResponse>& batch_context) {
+        batch_contexts.push_back(batch_context);
+        return SuccessExecutionResult();
+      };
+  auto finish_batch = [](AsyncContext<BatchGetTransactionStatusRequest,
+                                      BatchGetTransactionStatusResponse>&
+                             batch_context) {
+    batch_context.result = SuccessExecutionResult();
+    batch_context.response = make_shared<BatchGetTransactionStatusResponse>();
+    for (size_t i = 0; i < batch_context.request->items.size(); ++i) {
+      batch_context.response->item_results.push_back(
+          i == 0 ? FailureExecutionResult(1234) : SuccessExecutionResult());
+      batch_context.response->items.push_back(
+          make_shared<GetTransactionStatusResponse>());
+    }
+    batch_context.Finish();
+  };
+
+  // The first inquiry is sent right away and the next ones wait for it.
+  vector<ExecutionResult> results;
+  vector<Uuid> transaction_ids;
+  for (int i = 0; i < 5; ++i) {
+    auto context = CreateStatusContext(results);
+    transaction_ids.push_back(context.request->transaction_id);
+    EXPECT_SUCCESS(remote_transaction_manager.GetTransactionStatus(context));
+    EXPECT_EQ(batch_contexts.size(), 1);
+  }
+  EXPECT_EQ(batch_contexts[0].request->items.size(), 1);
+
+  finish_batch(batch_contexts[0]);
+  EXPECT_EQ(results.size(), 1);
+  EXPECT_THAT(results[0], ResultIs(FailureExecutionResult(1234)));
+  ASSERT_EQ(batch_contexts.size(), 2);
+  ASSERT_EQ(batch_contexts[1].request->items.size(), 3);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(batch_contexts[1].request->items[i]->transaction_id,
+              transaction_ids[i + 1]);
+  }
+
+  finish_batch(batch_contexts[1]);
+  EXPECT_EQ(results.size(), 4);
+  EXPECT_SUCCESS(results[2]);
+  ASSERT_EQ(batch_contexts.size(), 3);
+  EXPECT_EQ(batch_contexts[2].request->items.size(), 1);
+
+  finish_batch(batch_contexts[2]);
+  EXPECT_EQ(results.size(), 5);
+
+  // Nothing is in flight anymore, so the next inquiry is sent right away.
+  auto context = CreateStatusContext(results);
+  EXPECT_SUCCESS(remote_transaction_manager.GetTransactionStatus(context));
+  EXPECT_EQ(batch_contexts.size(), 4);
+}
+
+TEST_F(RemoteTransactionManagerTest, FailedBatchIsSentOneByOne) {
+  RemoteTransactionManager remote_transaction_manager(mock_pbs_client_,
+                                                      /*status_batch_size=*/10);
+
+  vector<AsyncContext<BatchGetTransactionStatusRequest,
+                      BatchGetTransactionStatusResponse>>
+      batch_contexts;
+  batch_contexts.reserve(10);
+  mock_pbs_client_->batch_get_transaction_status_mock =
+      [&](AsyncContext<BatchGetTransactionStatusRequest,
+                       BatchGetTransactionStatusResponse>& batch_context) {
+        batch_contexts.push_back(batch_context);
+        return SuccessExecutionResult();
+      };
+  size_t status_count = 0;
+  mock_pbs_client_->get_transaction_status_mock =
+      [&](AsyncContext<GetTransactionStatusRequest,
+                       GetTransactionStatusResponse>& context) {
+        status_count++;
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  vector<ExecutionResult> results;
+  for (int i = 0; i < 3; ++i) {
+    auto context = CreateStatusContext(results);
+    EXPECT_SUCCESS(remote_transaction_manager.GetTransactionStatus(context));
+  }
+  ASSERT_EQ(batch_contexts.size(), 1);
+
+  // E.g. the remote coordinator does not support batches.
+  batch_contexts[0].result = FailureExecutionResult(1234);
+  batch_contexts[0].Finish();
+  ASSERT_EQ(batch_contexts.size(), 2);
+  EXPECT_EQ(batch_contexts[1].request->items.size(), 2);
+  EXPECT_EQ(status_count, 1);
+
+  // A batch failing synchronously is sent one by one as well.
+  mock_pbs_client_->batch_get_transaction_status_mock =
+      [&](AsyncContext<BatchGetTransactionStatusRequest,
+                       BatchGetTransactionStatusResponse>&) {
+        return FailureExecutionResult(1234);
+      };
+  auto context = CreateStatusContext(results);
+  EXPECT_SUCCESS(remote_transaction_manager.GetTransactionStatus(context));
+  EXPECT_EQ(status_count, 1);
+
+  batch_contexts[1].result = FailureExecutionResult(1234);
+  batch_contexts[1].Finish();
+  EXPECT_EQ(status_count, 4);
+  EXPECT_EQ(results.size(), 4);
+  for (const auto& result : results) {
+    EXPECT_SUCCESS(result);
+  }
+}
+
+TEST_F(RemoteTransactionManagerTest,
+       InquiriesAreSentOneByOneOnceBatchesAreUnsupported) {
+  RemoteTransactionManager remote_transaction_manager(mock_pbs_client_,
+                                                      /*status_batch_size=*/10);
+
+  vector<AsyncContext<BatchGetTransactionStatusRequest,
+                      BatchGetTransactionStatusResponse>>
+      batch_contexts;
+  batch_contexts.reserve(10);
+  mock_pbs_client_->batch_get_transaction_status_mock =
+      [&](AsyncContext<BatchGetTransactionStatusRequest,
+                       BatchGetTransactionStatusResponse>& batch_context) {
+        batch_contexts.push_back(batch_context);
+        return SuccessExecutionResult();
+      };
+  size_t status_count = 0;
+  mock_pbs_client_->get_transaction_status_mock =
+      [&](AsyncContext<GetTransactionStatusRequest,
+                       GetTransactionStatusResponse>& context) {
+        status_count++;
+        context.result = SuccessExecutionResult();
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  vector<ExecutionResult> results;
+  for (int i = 0; i < 3; ++i) {
+    auto context = CreateStatusContext(results);
+    EXPECT_SUCCESS(remote_transaction_manager.GetTransactionStatus(context));
+  }
+  ASSERT_EQ(batch_contexts.size(), 1);
+
+  // The remote coordinator predates the batch endpoint, so the pending
+  // inquiries and the later ones are not batched anymore.
+  batch_contexts[0].result =
+      FailureExecutionResult(SC_HTTP2_CLIENT_HTTP_STATUS_NOT_FOUND);
+  batch_contexts[0].Finish();
+  EXPECT_EQ(batch_contexts.size(), 1);
+  EXPECT_EQ(status_count, 3);
+
+  auto context = CreateStatusContext(results);
+  EXPECT_SUCCESS(remote_transaction_manager.GetTransactionStatus(context));
+  EXPECT_EQ(batch_contexts.size(), 1);
+  EXPECT_EQ(status_count, 4);
+  EXPECT_EQ(results.size(), 4);
+}
+}  // namespace google::scp::pbs::test
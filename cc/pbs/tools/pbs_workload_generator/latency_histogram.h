@@ -0,0 +1,121 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace google::scp::pbs {
+/**
+ * @brief A lock free log-linear latency histogram. Every power of two range is
+ * split into 16 equal buckets, so a recorded value is off by at most ~6%.
+ * Values below 32 are recorded exactly.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() {
+    for (auto& bucket : buckets_) {
+      bucket = 0;
+    }
+  }
+
+  /// Records a value, usually a latency in microseconds.
+  void Record(uint64_t value) noexcept {
+    buckets_[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    auto min = min_.load(std::memory_order_relaxed);
+    while (value < min && !min_.compare_exchange_weak(min, value)) {}
+    auto max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value)) {}
+  }
+
+  uint64_t Count() const noexcept { return count_.load(); }
+
+  uint64_t Min() const noexcept { return Count() == 0 ? 0 : min_.load(); }
+
+  uint64_t Max() const noexcept { return max_.load(); }
+
+  double Mean() const noexcept {
+    auto count = Count();
+    return count == 0 ? 0 : static_cast<double>(sum_.load()) / count;
+  }
+
+  /**
+   * @brief Returns the value at the given percentile, i.e. the upper bound of
+   * the bucket holding the value of that rank.
+   *
+   * @param percentile in the range of [0, 100].
+   */
+  uint64_t Percentile(double percentile) const noexcept {
+    auto count = Count();
+    if (count == 0) {
+      return 0;
+    }
+    auto rank = static_cast<uint64_t>(
+        std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * count));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t cumulative_count = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+      cumulative_count += buckets_[i].load(std::memory_order_relaxed);
+      if (cumulative_count >= rank) {
+        return std::min(GetBucketUpperBound(i), Max());
+      }
+    }
+    return Max();
+  }
+
+ protected:
+  /// Values below this are recorded in their own bucket.
+  static constexpr uint64_t kLinearBucketCount = 32;
+  /// Buckets per power of two range above the linear buckets.
+  static constexpr uint64_t kSubBucketCount = 16;
+  static constexpr size_t kBucketCount = 64 * kSubBucketCount;
+
+  static size_t GetBucketIndex(uint64_t value) noexcept {
+    if (value < kLinearBucketCount) {
+      return value;
+    }
+    size_t most_significant_bit = 63 - __builtin_clzll(value);
+    // Keeps the 5 most significant bits, i.e. a value in [16, 32).
+    size_t shift = most_significant_bit - 4;
+    return shift * kSubBucketCount + (value >> shift);
+  }
+
+  static uint64_t GetBucketUpperBound(size_t index) noexcept {
+    if (index < kLinearBucketCount) {
+      return index;
+    }
+    size_t shift = index / kSubBucketCount - 1;
+    uint64_t mantissa = index - shift * kSubBucketCount;
+    if (shift + 5 >= 64) {
+      return std::numeric_limits<uint64_t>::max();
+    }
+    return ((mantissa + 1) << shift) - 1;
+  }
+
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+  std::atomic<uint64_t> count_ = 0;
+  std::atomic<uint64_t> sum_ = 0;
+  std::atomic<uint64_t> min_ = std::numeric_limits<uint64_t>::max();
+  std::atomic<uint64_t> max_ = 0;
+};
+}  // namespace google::scp::pbs
@@ -0,0 +1,387 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pbs/tools/pbs_workload_generator/open_loop_workload.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/uuid/src/uuid.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::TransactionExecutionPhase;
+using google::scp::core::TransactionPhaseRequest;
+using google::scp::core::TransactionPhaseResponse;
+using google::scp::core::common::TimeProvider;
+using google::scp::core::common::ToString;
+using google::scp::core::common::Uuid;
+using std::make_shared;
+using std::mt19937_64;
+using std::ostream;
+using std::random_device;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+using std::this_thread::sleep_for;
+using std::this_thread::sleep_until;
+
+static constexpr uint64_t kNanosecondsInHour = 3600ULL * 1000 * 1000 * 1000;
+// Number of attempts at drawing a key not already in the transaction.
+static constexpr size_t kMaxKeySamplingAttempts = 16;
+
+static constexpr const char* kPhaseNames[] = {"begin", "prepare", "commit",
+                                              "notify", "end"};
+static constexpr TransactionExecutionPhase kPhases[] = {
+    TransactionExecutionPhase::Begin, TransactionExecutionPhase::Prepare,
+    TransactionExecutionPhase::Commit, TransactionExecutionPhase::Notify,
+    TransactionExecutionPhase::End};
+// From the notify phase on, the transaction is committed and cannot be aborted.
+static constexpr size_t kNotifyPhaseIndex = 3;
+
+namespace google::scp::pbs {
+
+OpenLoopWorkload::OpenLoopWorkload(
+    const OpenLoopConfiguration& configuration,
+    const vector<shared_ptr<PrivacyBudgetServiceClientInterface>>& pbs_clients)
+    : configuration_(configuration),
+      pbs_clients_(pbs_clients),
+      key_distribution_(configuration.key_space_size,
+                        configuration.key_zipf_exponent),
+      batch_size_distribution_(
+          std::max<size_t>(configuration.max_keys_per_transaction, 1),
+          configuration.batch_size_zipf_exponent),
+      key_use_counts_(std::max<uint64_t>(configuration.key_space_size, 1)),
+      issued_count_(0),
+      succeeded_count_(0),
+      failed_count_(0),
+      dropped_count_(0),
+      in_flight_count_(0),
+      elapsed_seconds_(0) {
+  for (auto& failed_count : phase_failed_counts_) {
+    failed_count = 0;
+  }
+}
+
+void OpenLoopWorkload::Run(seconds drain_timeout) {
+  auto interval = duration_cast<nanoseconds>(
+      duration<double>(1.0 / std::max<size_t>(configuration_.target_rps, 1)));
+  auto thread_count = std::max<size_t>(configuration_.client_thread_count, 1);
+  auto start_time = steady_clock::now();
+  auto end_time = start_time + seconds(configuration_.duration_in_seconds);
+
+  // Thread i issues the transactions scheduled at i, i + thread_count, ...
+  // Each transaction is issued at its scheduled time whether or not the
+  // previous ones have completed.
+  vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; i++) {
+    threads.emplace_back([this, i, thread_count, interval, start_time,
+                          end_time]() {
+      random_device random_device_local;
+      mt19937_64 generator(random_device_local());
+      for (uint64_t index = i;; index += thread_count) {
+        auto intended_start_time = start_time + interval * index;
+        if (intended_start_time >= end_time) {
+          break;
+        }
+        sleep_until(intended_start_time);
+        IssueTransaction(intended_start_time, generator);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // The achieved rate is measured over the time the transactions were
+  // issued, so waiting for the last ones to complete does not lower it.
+  elapsed_seconds_ =
+      duration<double>(steady_clock::now() - start_time).count();
+
+  auto drain_deadline = steady_clock::now() + drain_timeout;
+  while (in_flight_count_.load() > 0 && steady_clock::now() < drain_deadline) {
+    sleep_for(milliseconds(100));
+  }
+}
+
+void OpenLoopWorkload::IssueTransaction(
+    steady_clock::time_point intended_start_time,
+    mt19937_64& generator) noexcept {
+  issued_count_++;
+  if (in_flight_count_.load() >= configuration_.max_in_flight_transactions) {
+    dropped_count_++;
+    return;
+  }
+
+  auto state = make_shared<TransactionState>();
+  state->intended_start_time = intended_start_time;
+  state->transaction_id = Uuid::GenerateUuid();
+  state->transaction_secret =
+      make_shared<string>(ToString(state->transaction_id));
+  state->budget_keys = make_shared<vector<ConsumeBudgetMetadata>>();
+  state->last_execution_timestamps.resize(pbs_clients_.size());
+
+  auto key_count = batch_size_distribution_(generator);
+  auto now = TimeProvider::GetWallTimestampInNanosecondsAsClockTicks();
+  vector<uint64_t> key_ranks;
+  for (size_t i = 0; i < key_count; i++) {
+    for (size_t attempt = 0; attempt < kMaxKeySamplingAttempts; attempt++) {
+      auto rank = key_distribution_(generator);
+      if (std::find(key_ranks.begin(), key_ranks.end(), rank) ==
+          key_ranks.end()) {
+        key_ranks.push_back(rank);
+        break;
+      }
+    }
+  }
+  for (auto rank : key_ranks) {
+    auto use_count = key_use_counts_[rank - 1].fetch_add(1);
+    ConsumeBudgetMetadata metadata;
+    metadata.budget_key_name = make_shared<string>(
+        configuration_.key_prefix + "_" + to_string(rank));
+    metadata.time_bucket = now - use_count * kNanosecondsInHour;
+    metadata.token_count = 1;
+    state->budget_keys->push_back(metadata);
+  }
+
+  in_flight_count_++;
+  state->phase_start_time = steady_clock::now();
+  ExecuteStep(state);
+}
+
+void OpenLoopWorkload::ExecuteStep(
+    const shared_ptr<TransactionState>& state) noexcept {
+  if (state->is_aborting) {
+    ExecutePhase(state, TransactionExecutionPhase::Abort);
+  } else if (state->phase_index == 0) {
+    ExecuteBegin(state);
+  } else {
+    ExecutePhase(state, kPhases[state->phase_index]);
+  }
+}
+
+void OpenLoopWorkload::ExecuteBegin(
+    const shared_ptr<TransactionState>& state) noexcept {
+  AsyncContext<ConsumeBudgetTransactionRequest,
+               ConsumeBudgetTransactionResponse>
+      consume_budget_transaction_context;
+  consume_budget_transaction_context.request =
+      make_shared<ConsumeBudgetTransactionRequest>();
+  consume_budget_transaction_context.request->transaction_id =
+      state->transaction_id;
+  consume_budget_transaction_context.request->transaction_secret =
+      state->transaction_secret;
+  consume_budget_transaction_context.request->budget_keys = state->budget_keys;
+  consume_budget_transaction_context.callback =
+      [this, state](AsyncContext<ConsumeBudgetTransactionRequest,
+                                 ConsumeBudgetTransactionResponse>&
+                        consume_budget_transaction_context) {
+        if (!consume_budget_transaction_context.result.Successful()) {
+          OnStepFailed(state);
+          return;
+        }
+        state->last_execution_timestamps[state->client_index] =
+            consume_budget_transaction_context.response
+                ->last_execution_timestamp;
+        OnStepSucceeded(state);
+      };
+
+  if (!pbs_clients_[state->client_index]
+           ->InitiateConsumeBudgetTransaction(
+               consume_budget_transaction_context)
+           .Successful()) {
+    OnStepFailed(state);
+  }
+}
+
+void OpenLoopWorkload::ExecutePhase(const shared_ptr<TransactionState>& state,
+                                    TransactionExecutionPhase phase) noexcept {
+  AsyncContext<TransactionPhaseRequest, TransactionPhaseResponse>
+      transaction_phase_context;
+  transaction_phase_context.request = make_shared<TransactionPhaseRequest>();
+  transaction_phase_context.request->transaction_id = state->transaction_id;
+  transaction_phase_context.request->transaction_secret =
+      state->transaction_secret;
+  transaction_phase_context.request->transaction_execution_phase = phase;
+  transaction_phase_context.request->last_execution_timestamp =
+      state->last_execution_timestamps[state->client_index];
+  transaction_phase_context.callback =
+      [this, state](AsyncContext<TransactionPhaseRequest,
+                                 TransactionPhaseResponse>&
+                        transaction_phase_context) {
+        if (state->is_aborting) {
+          // Aborts are best effort and not measured.
+          OnStepSucceeded(state);
+          return;
+        }
+        if (!transaction_phase_context.result.Successful()) {
+          OnStepFailed(state);
+          return;
+        }
+        state->last_execution_timestamps[state->client_index] =
+            transaction_phase_context.response->last_execution_timestamp;
+        OnStepSucceeded(state);
+      };
+
+  if (!pbs_clients_[state->client_index]
+           ->ExecuteTransactionPhase(transaction_phase_context)
+           .Successful()) {
+    if (state->is_aborting) {
+      OnStepSucceeded(state);
+    } else {
+      OnStepFailed(state);
+    }
+  }
+}
+
+void OpenLoopWorkload::OnStepSucceeded(
+    const shared_ptr<TransactionState>& state) noexcept {
+  state->client_index++;
+  auto client_count = state->is_aborting ? state->abort_client_count
+                                         : pbs_clients_.size();
+  if (state->client_index < client_count) {
+    ExecuteStep(state);
+    return;
+  }
+
+  if (state->is_aborting) {
+    CompleteTransaction(state, /*succeeded=*/false);
+    return;
+  }
+
+  phase_histograms_[state->phase_index].Record(
+      duration_cast<microseconds>(steady_clock::now() -
+                                  state->phase_start_time)
+          .count());
+  state->phase_index++;
+  state->client_index = 0;
+  if (state->phase_index == kPhaseCount) {
+    CompleteTransaction(state, /*succeeded=*/true);
+    return;
+  }
+  state->phase_start_time = steady_clock::now();
+  ExecuteStep(state);
+}
+
+void OpenLoopWorkload::OnStepFailed(
+    const shared_ptr<TransactionState>& state) noexcept {
+  phase_failed_counts_[state->phase_index]++;
+
+  // Aborts the transaction on the PBS instances it has begun on, unless it has
+  // been committed.
+  auto begun_client_count = state->phase_index == 0 ? state->client_index
+                                                    : pbs_clients_.size();
+  if (state->phase_index >= kNotifyPhaseIndex || begun_client_count == 0) {
+    CompleteTransaction(state, /*succeeded=*/false);
+    return;
+  }
+  state->is_aborting = true;
+  state->abort_client_count = begun_client_count;
+  state->client_index = 0;
+  ExecuteStep(state);
+}
+
+void OpenLoopWorkload::CompleteTransaction(
+    const shared_ptr<TransactionState>& state, bool succeeded) noexcept {
+  if (succeeded) {
+    succeeded_count_++;
+    end_to_end_histogram_.Record(
+        duration_cast<microseconds>(steady_clock::now() -
+                                    state->intended_start_time)
+            .count());
+  } else {
+    failed_count_++;
+  }
+  in_flight_count_--;
+}
+
+void OpenLoopWorkload::WriteCsv(ostream& output) const {
+  output << "phase,count,failed,min_us,mean_us,p50_us,p90_us,p99_us,p999_us,"
+            "max_us"
+         << std::endl;
+  auto write_row = [&](const string& name, const LatencyHistogram& histogram,
+                       uint64_t failed_count) {
+    output << name << "," << histogram.Count() << "," << failed_count << ","
+           << histogram.Min() << "," << histogram.Mean() << ","
+           << histogram.Percentile(50) << "," << histogram.Percentile(90)
+           << "," << histogram.Percentile(99) << ","
+           << histogram.Percentile(99.9) << "," << histogram.Max()
+           << std::endl;
+  };
+  for (size_t i = 0; i < kPhaseCount; i++) {
+    write_row(kPhaseNames[i], phase_histograms_[i], phase_failed_counts_[i]);
+  }
+  write_row("end_to_end", end_to_end_histogram_, failed_count_);
+}
+
+void OpenLoopWorkload::WritePhaseJson(ostream& output, const string& name,
+                                      const LatencyHistogram& histogram,
+                                      uint64_t failed_count) const {
+  output << "\"" << name << "\": {\"count\": " << histogram.Count()
+         << ", \"failed\": " << failed_count
+         << ", \"min_us\": " << histogram.Min()
+         << ", \"mean_us\": " << histogram.Mean()
+         << ", \"p50_us\": " << histogram.Percentile(50)
+         << ", \"p90_us\": " << histogram.Percentile(90)
+         << ", \"p99_us\": " << histogram.Percentile(99)
+         << ", \"p999_us\": " << histogram.Percentile(99.9)
+         << ", \"max_us\": " << histogram.Max() << "}";
+}
+
+void OpenLoopWorkload::WriteJson(ostream& output) const {
+  output << "{\"target_rps\": " << configuration_.target_rps
+         << ", \"client_threads\": " << configuration_.client_thread_count
+         << ", \"duration_seconds\": " << configuration_.duration_in_seconds
+         << ", \"elapsed_seconds\": " << elapsed_seconds_
+         << ", \"achieved_rps\": "
+         << (elapsed_seconds_ > 0 ? succeeded_count_ / elapsed_seconds_ : 0)
+         << ", \"issued\": " << issued_count_
+         << ", \"succeeded\": " << succeeded_count_
+         << ", \"failed\": " << failed_count_
+         << ", \"dropped\": " << dropped_count_
+         << ", \"incomplete\": " << in_flight_count_ << ", \"phases\": {";
+  for (size_t i = 0; i < kPhaseCount; i++) {
+    WritePhaseJson(output, kPhaseNames[i], phase_histograms_[i],
+                   phase_failed_counts_[i]);
+    output << ", ";
+  }
+  WritePhaseJson(output, "end_to_end", end_to_end_histogram_, failed_count_);
+  output << "}}" << std::endl;
+}
+
+void OpenLoopWorkload::PrintSummary(ostream& output) const {
+  output << "Target RPS: " << configuration_.target_rps << std::endl;
+  output << "Time Elapsed (Seconds): " << elapsed_seconds_ << std::endl;
+  output << "Issued: " << issued_count_ << " Succeeded: " << succeeded_count_
+         << " Failed: " << failed_count_ << " Dropped: " << dropped_count_
+         << " Incomplete: " << in_flight_count_ << std::endl;
+  if (elapsed_seconds_ > 0) {
+    output << "Achieved RPS: " << succeeded_count_ / elapsed_seconds_
+           << std::endl;
+  }
+  WriteCsv(output);
+}
+}  // namespace google::scp::pbs
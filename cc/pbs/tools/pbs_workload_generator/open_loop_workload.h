@@ -0,0 +1,161 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/interface/transaction_manager_interface.h"
+#include "pbs/interface/pbs_client_interface.h"
+#include "pbs/tools/pbs_workload_generator/latency_histogram.h"
+#include "pbs/tools/pbs_workload_generator/zipf_distribution.h"
+
+namespace google::scp::pbs {
+
+/// Configuration of the open-loop workload.
+struct OpenLoopConfiguration {
+  /// Transactions started per second, regardless of how many are in flight.
+  size_t target_rps = 0;
+  /// Number of threads issuing transactions.
+  size_t client_thread_count = 1;
+  /// For how long transactions are issued.
+  int64_t duration_in_seconds = 0;
+  /// Number of distinct budget keys.
+  uint64_t key_space_size = 1000000;
+  /// Zipf exponent of the budget key popularity. 0 is uniform.
+  double key_zipf_exponent = 0;
+  /// Maximum number of budget keys in a transaction.
+  size_t max_keys_per_transaction = 1;
+  /// Zipf exponent of the number of keys in a transaction. 0 is uniform.
+  double batch_size_zipf_exponent = 0;
+  /// Transactions are dropped, and counted as such, beyond this many in
+  /// flight so that an overloaded PBS does not exhaust the generator.
+  size_t max_in_flight_transactions = 100000;
+  /// Prefix of the generated budget key names.
+  std::string key_prefix;
+};
+
+/**
+ * @brief Issues consume budget transactions at a fixed rate (open loop) and
+ * drives the begin, prepare, commit, notify and end phases against one or
+ * more PBS instances, recording the latency of each phase.
+ *
+ * The end to end latency is measured from the time the transaction was
+ * scheduled to start rather than the time it was actually sent, so that
+ * delays of the generator itself are not hidden (coordinated omission).
+ */
+class OpenLoopWorkload {
+ public:
+  OpenLoopWorkload(
+      const OpenLoopConfiguration& configuration,
+      const std::vector<std::shared_ptr<PrivacyBudgetServiceClientInterface>>&
+          pbs_clients);
+
+  /**
+   * @brief Issues transactions for the configured duration and then waits up
+   * to drain_timeout for the in flight transactions to complete.
+   */
+  void Run(std::chrono::seconds drain_timeout);
+
+  /// Writes one row of latency statistics per phase.
+  void WriteCsv(std::ostream& output) const;
+
+  /// Writes the run summary and the latency statistics of every phase.
+  void WriteJson(std::ostream& output) const;
+
+  /// Prints a human readable summary.
+  void PrintSummary(std::ostream& output) const;
+
+ protected:
+  /// Begin, prepare, commit, notify and end.
+  static constexpr size_t kPhaseCount = 5;
+
+  struct TransactionState {
+    std::chrono::steady_clock::time_point intended_start_time;
+    std::chrono::steady_clock::time_point phase_start_time;
+    /// Index of the current phase, see kPhaseCount.
+    size_t phase_index = 0;
+    /// Index of the PBS client the current phase is executing on.
+    size_t client_index = 0;
+    /// Whether the transaction failed and is being aborted.
+    bool is_aborting = false;
+    /// Number of PBS instances the transaction is aborted on.
+    size_t abort_client_count = 0;
+    core::common::Uuid transaction_id;
+    std::shared_ptr<std::string> transaction_secret;
+    std::shared_ptr<std::vector<ConsumeBudgetMetadata>> budget_keys;
+    /// The last execution timestamp on each PBS.
+    std::vector<core::Timestamp> last_execution_timestamps;
+  };
+
+  /// Creates a transaction with Zipf distributed keys and starts it, unless
+  /// too many transactions are in flight.
+  void IssueTransaction(
+      std::chrono::steady_clock::time_point intended_start_time,
+      std::mt19937_64& generator) noexcept;
+
+  /// Executes the current phase of the transaction on the current client.
+  void ExecuteStep(const std::shared_ptr<TransactionState>& state) noexcept;
+
+  void ExecuteBegin(const std::shared_ptr<TransactionState>& state) noexcept;
+
+  void ExecutePhase(const std::shared_ptr<TransactionState>& state,
+                    core::TransactionExecutionPhase phase) noexcept;
+
+  /// Moves the transaction to the next client, or the next phase once the
+  /// current phase has been executed on all the clients.
+  void OnStepSucceeded(const std::shared_ptr<TransactionState>& state) noexcept;
+
+  /// Records the failure and aborts the transaction if it was not committed.
+  void OnStepFailed(const std::shared_ptr<TransactionState>& state) noexcept;
+
+  void CompleteTransaction(const std::shared_ptr<TransactionState>& state,
+                           bool succeeded) noexcept;
+
+  void WritePhaseJson(std::ostream& output, const std::string& name,
+                      const LatencyHistogram& histogram,
+                      uint64_t failed_count) const;
+
+  const OpenLoopConfiguration configuration_;
+  const std::vector<std::shared_ptr<PrivacyBudgetServiceClientInterface>>
+      pbs_clients_;
+
+  ZipfDistribution key_distribution_;
+  ZipfDistribution batch_size_distribution_;
+  /// Number of times each key was used. Every use of a key consumes a
+  /// different hour so that hot keys do not run out of budget.
+  std::vector<std::atomic<uint32_t>> key_use_counts_;
+
+  /// Latencies in microseconds of each phase across all the PBS instances.
+  std::array<LatencyHistogram, kPhaseCount> phase_histograms_;
+  std::array<std::atomic<uint64_t>, kPhaseCount> phase_failed_counts_;
+  /// End to end latencies in microseconds from the intended start time.
+  LatencyHistogram end_to_end_histogram_;
+
+  std::atomic<uint64_t> issued_count_;
+  std::atomic<uint64_t> succeeded_count_;
+  std::atomic<uint64_t> failed_count_;
+  std::atomic<uint64_t> dropped_count_;
+  std::atomic<uint64_t> in_flight_count_;
+  /// Seconds spent issuing the transactions, excluding the drain.
+  double elapsed_seconds_;
+};
+}  // namespace google::scp::pbs
@@ -14,6 +14,8 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <cmath>
 #include <condition_variable>
 #include <cstdlib>
 #include <filesystem>
@@ -47,8 +49,10 @@
 #include "pbs/authorization_token_fetcher/src/aws/aws_authorization_token_fetcher.h"
 #include "pbs/authorization_token_fetcher/src/gcp/gcp_authorization_token_fetcher.h"
 #include "pbs/interface/configuration_keys.h"
+#include "pbs/pbs_client/src/pbs_client.h"
 #include "pbs/pbs_client/src/transactional/pbs_transactional_client.h"
 #include "pbs/pbs_server/src/pbs_instance/pbs_instance.h"
+#include "pbs/tools/pbs_workload_generator/open_loop_workload.h"
 
 using Aws::InitAPI;
 using Aws::SDKOptions;
@@ -94,7 +98,11 @@ using google::scp::pbs::ConsumeBudgetMetadata;
 using google::scp::pbs::ConsumeBudgetTransactionRequest;
 using google::scp::pbs::ConsumeBudgetTransactionResponse;
 using google::scp::pbs::GcpAuthorizationTokenFetcher;
+using google::scp::pbs::OpenLoopConfiguration;
+using google::scp::pbs::OpenLoopWorkload;
 using google::scp::pbs::PBSInstance;
+using google::scp::pbs::PrivacyBudgetServiceClient;
+using google::scp::pbs::PrivacyBudgetServiceClientInterface;
 using google::scp::pbs::PrivacyBudgetServiceTransactionalClient;
 using std::atomic;
 using std::condition_variable;
@@ -106,6 +114,7 @@ using std::make_shared;
 using std::make_unique;
 using std::mt19937;
 using std::mutex;
+using std::ofstream;
 using std::random_device;
 using std::runtime_error;
 using std::shared_ptr;
@@ -130,6 +139,9 @@ static constexpr size_t kHttp2RequestRetryStrategyMaxRetries = 3;
 // Give up quickly if the destination node is not reachable.
 static constexpr size_t kHttp2ConnectionReadTimeoutInSeconds = 5;
 
+// How long to wait for the in flight transactions of an open-loop run.
+static constexpr size_t kOpenLoopDrainTimeoutInSeconds = 60;
+
 static constexpr char kPBSWorkloadGenerator[] = "PBSWorkloadGenerator";
 
 namespace google::scp::pbs {
@@ -142,6 +154,14 @@ struct AppConfiguration {
   path config_path;
   int64_t duration_in_seconds;
   CloudPlatformType cloud_platform_type;
+  /// Transactions per second of the open-loop mode. 0 runs the closed-loop
+  /// mode.
+  size_t target_rps = 0;
+  size_t client_thread_count = 1;
+  uint64_t key_space_size = 1000000;
+  double key_zipf_exponent = 0;
+  double batch_size_zipf_exponent = 0;
+  string results_path;
 };
 
 struct SingleCoordinatorConfig {
@@ -493,6 +513,59 @@ void RunWorkload(
   }
 }
 
+void RunOpenLoopWorkload(
+    const AppConfiguration& app_configuration,
+    const vector<shared_ptr<PrivacyBudgetServiceClientInterface>>& clients) {
+  for (const auto& client : clients) {
+    if (!client->Init().Successful()) {
+      throw runtime_error("Cannot initialize the client");
+    }
+    if (!client->Run().Successful()) {
+      throw runtime_error("Cannot run the client");
+    }
+  }
+
+  OpenLoopConfiguration configuration;
+  configuration.target_rps = app_configuration.target_rps;
+  configuration.client_thread_count = app_configuration.client_thread_count;
+  configuration.duration_in_seconds = app_configuration.duration_in_seconds;
+  configuration.key_space_size = app_configuration.key_space_size;
+  configuration.key_zipf_exponent = app_configuration.key_zipf_exponent;
+  configuration.max_keys_per_transaction =
+      app_configuration.keys_per_transaction;
+  configuration.batch_size_zipf_exponent =
+      app_configuration.batch_size_zipf_exponent;
+  configuration.max_in_flight_transactions =
+      app_configuration.total_transactions;
+  configuration.key_prefix = generate_random_string();
+
+  cout << "Running the open-loop workload at " << app_configuration.target_rps
+       << " transactions per second" << endl;
+  OpenLoopWorkload workload(configuration, clients);
+  workload.Run(seconds(kOpenLoopDrainTimeoutInSeconds));
+  workload.PrintSummary(cout);
+
+  if (!app_configuration.results_path.empty()) {
+    ofstream results_file(app_configuration.results_path);
+    if (!results_file.is_open()) {
+      throw runtime_error("Cannot open the results file");
+    }
+    if (path(app_configuration.results_path).extension() == ".json") {
+      workload.WriteJson(results_file);
+    } else {
+      workload.WriteCsv(results_file);
+    }
+    cout << "Results are written to " << app_configuration.results_path
+         << endl;
+  }
+
+  for (const auto& client : clients) {
+    if (!client->Stop().Successful()) {
+      throw runtime_error("Cannot stop the client");
+    }
+  }
+}
+
 void RunWithSingleClient(AppConfiguration& app_configuration,
                          shared_ptr<HttpClientInterface> http1_client,
                          shared_ptr<HttpClientInterface> http2_client,
@@ -517,12 +590,22 @@ void RunWithSingleClient(AppConfiguration& app_configuration,
   assert(auth_token_provider_cache->Init().Successful());
   assert(auth_token_provider_cache->Run().Successful());
 
-  auto client = make_shared<PrivacyBudgetServiceTransactionalClient>(
-      config.reporting_origin, config.pbs_endpoint, http2_client,
-      async_executor, auth_token_provider_cache);
+  if (app_configuration.target_rps > 0) {
+    vector<shared_ptr<PrivacyBudgetServiceClientInterface>> clients = {
+        make_shared<PrivacyBudgetServiceClient>(
+            config.reporting_origin, config.pbs_endpoint, http2_client,
+            auth_token_provider_cache)};
 
-  cout << "Running the workload against a single PBS" << endl;
-  RunWorkload(config.reporting_origin, app_configuration, client);
+    cout << "Running the workload against a single PBS" << endl;
+    RunOpenLoopWorkload(app_configuration, clients);
+  } else {
+    auto client = make_shared<PrivacyBudgetServiceTransactionalClient>(
+        config.reporting_origin, config.pbs_endpoint, http2_client,
+        async_executor, auth_token_provider_cache);
+
+    cout << "Running the workload against a single PBS" << endl;
+    RunWorkload(config.reporting_origin, app_configuration, client);
+  }
 
   assert(auth_token_provider_cache->Stop().Successful());
 }
@@ -561,13 +644,26 @@ void RunWithPBSTransactionalClient(
   assert(auth_token_provider_cache_1->Run().Successful());
   assert(auth_token_provider_cache_2->Run().Successful());
 
-  auto client = make_shared<PrivacyBudgetServiceTransactionalClient>(
-      config.reporting_origin, config.pbs1_endpoint, config.pbs2_endpoint,
-      http2_client, async_executor, auth_token_provider_cache_1,
-      auth_token_provider_cache_2);
+  if (app_configuration.target_rps > 0) {
+    vector<shared_ptr<PrivacyBudgetServiceClientInterface>> clients = {
+        make_shared<PrivacyBudgetServiceClient>(
+            config.reporting_origin, config.pbs1_endpoint, http2_client,
+            auth_token_provider_cache_1),
+        make_shared<PrivacyBudgetServiceClient>(
+            config.reporting_origin, config.pbs2_endpoint, http2_client,
+            auth_token_provider_cache_2)};
+
+    cout << "Running the workload against a multi PBS" << endl;
+    RunOpenLoopWorkload(app_configuration, clients);
+  } else {
+    auto client = make_shared<PrivacyBudgetServiceTransactionalClient>(
+        config.reporting_origin, config.pbs1_endpoint, config.pbs2_endpoint,
+        http2_client, async_executor, auth_token_provider_cache_1,
+        auth_token_provider_cache_2);
 
-  cout << "Running the workload against a multi PBS" << endl;
-  RunWorkload(config.reporting_origin, app_configuration, client);
+    cout << "Running the workload against a multi PBS" << endl;
+    RunWorkload(config.reporting_origin, app_configuration, client);
+  }
 
   assert(auth_token_provider_cache_1->Stop().Successful());
   assert(auth_token_provider_cache_2->Stop().Successful());
@@ -584,6 +680,26 @@ void PrintHelp() {
           "for_how_long_in_seconds "
           "cloud_platform_type i.e. aws/gcp/local"
        << std::endl;
+  cout << "Setting the pbs_workload_generator_target_rps environment variable "
+          "runs an open-loop workload at that rate instead. In that mode "
+          "number_of_transactions is the maximum number of transactions in "
+          "flight and number_of_unique_keys is the maximum number of keys per "
+          "transaction. Optional variables: "
+          "pbs_workload_generator_client_thread_count, "
+          "pbs_workload_generator_key_space_size, "
+          "pbs_workload_generator_key_zipf_exponent, "
+          "pbs_workload_generator_batch_size_zipf_exponent and "
+          "pbs_workload_generator_results_path (.json or .csv)."
+       << std::endl;
+}
+
+/// Parses a Zipf exponent, which must be a finite non-negative number.
+bool ParseZipfExponent(const string& value, double& exponent) {
+  char* end = nullptr;
+  errno = 0;
+  exponent = strtod(value.c_str(), &end);
+  return !value.empty() && end == value.c_str() + value.size() &&
+         errno == 0 && std::isfinite(exponent) && exponent >= 0;
 }
 
 void StartLogger() {
@@ -642,11 +758,66 @@ int main(int argc, char** argv) {
     http_request_max_retries_count = kHttp2RequestRetryStrategyMaxRetries;
   }
 
+  size_t target_rps;
+  if (config_provider
+          .Get(google::scp::pbs::kPBSWorkloadGeneratorTargetRps, target_rps)
+          .Successful()) {
+    app_configuration.target_rps = target_rps;
+  }
+  size_t client_thread_count;
+  if (config_provider
+          .Get(google::scp::pbs::kPBSWorkloadGeneratorClientThreadCount,
+               client_thread_count)
+          .Successful()) {
+    app_configuration.client_thread_count = client_thread_count;
+  }
+  size_t key_space_size;
+  if (config_provider
+          .Get(google::scp::pbs::kPBSWorkloadGeneratorKeySpaceSize,
+               key_space_size)
+          .Successful()) {
+    app_configuration.key_space_size = key_space_size;
+  }
+  string zipf_exponent;
+  if (config_provider
+          .Get(google::scp::pbs::kPBSWorkloadGeneratorKeyZipfExponent,
+               zipf_exponent)
+          .Successful() &&
+      !ParseZipfExponent(zipf_exponent, app_configuration.key_zipf_exponent)) {
+    std::cerr << "Invalid "
+              << google::scp::pbs::kPBSWorkloadGeneratorKeyZipfExponent << ": '"
+              << zipf_exponent << "' is not a non-negative number." << endl;
+    return EXIT_FAILURE;
+  }
+  if (config_provider
+          .Get(google::scp::pbs::kPBSWorkloadGeneratorBatchSizeZipfExponent,
+               zipf_exponent)
+          .Successful() &&
+      !ParseZipfExponent(zipf_exponent,
+                         app_configuration.batch_size_zipf_exponent)) {
+    std::cerr << "Invalid "
+              << google::scp::pbs::kPBSWorkloadGeneratorBatchSizeZipfExponent
+              << ": '" << zipf_exponent << "' is not a non-negative number."
+              << endl;
+    return EXIT_FAILURE;
+  }
+  config_provider.Get(google::scp::pbs::kPBSWorkloadGeneratorResultsPath,
+                      app_configuration.results_path);
+
   cout << "Config path: " << app_configuration.config_path << endl;
   cout << "Total Txns: " << app_configuration.total_transactions << endl;
   cout << "Keys Per Txn: " << app_configuration.keys_per_transaction << endl;
   cout << "Duration in Seconds: " << app_configuration.duration_in_seconds
        << endl;
+  if (app_configuration.target_rps > 0) {
+    cout << "Target RPS: " << app_configuration.target_rps << endl;
+    cout << "Client Threads: " << app_configuration.client_thread_count << endl;
+    cout << "Key Space Size: " << app_configuration.key_space_size << endl;
+    cout << "Key Zipf Exponent: " << app_configuration.key_zipf_exponent
+         << endl;
+    cout << "Batch Size Zipf Exponent: "
+         << app_configuration.batch_size_zipf_exponent << endl;
+  }
 
   size_t async_executor_thread_count = std::thread::hardware_concurrency() * 2;
   size_t async_executor_queue_cap = 100000;
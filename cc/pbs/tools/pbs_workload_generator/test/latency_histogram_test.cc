@@ -0,0 +1,99 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pbs/tools/pbs_workload_generator/latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace google::scp::pbs::test {
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Count(), 0);
+  EXPECT_EQ(histogram.Min(), 0);
+  EXPECT_EQ(histogram.Max(), 0);
+  EXPECT_EQ(histogram.Mean(), 0);
+  EXPECT_EQ(histogram.Percentile(50), 0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreRecordedExactly) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 10; value++) {
+    histogram.Record(value);
+  }
+  EXPECT_EQ(histogram.Count(), 10);
+  EXPECT_EQ(histogram.Min(), 1);
+  EXPECT_EQ(histogram.Max(), 10);
+  EXPECT_DOUBLE_EQ(histogram.Mean(), 5.5);
+  EXPECT_EQ(histogram.Percentile(0), 1);
+  EXPECT_EQ(histogram.Percentile(50), 5);
+  EXPECT_EQ(histogram.Percentile(90), 9);
+  EXPECT_EQ(histogram.Percentile(100), 10);
+}
+
+TEST(LatencyHistogramTest, LargeValuesAreWithinTheBucketError) {
+  for (uint64_t value = 32; value < 1000000; value = value * 3 / 2) {
+    LatencyHistogram single_value_histogram;
+    single_value_histogram.Record(value);
+    single_value_histogram.Record(value * 4);
+    auto percentile = single_value_histogram.Percentile(50);
+    EXPECT_GE(percentile, value);
+    EXPECT_LE(percentile, value + value / 16);
+  }
+}
+
+TEST(LatencyHistogramTest, PercentilesAreOrdered) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 100000; value++) {
+    histogram.Record(value);
+  }
+  EXPECT_LE(histogram.Percentile(50), histogram.Percentile(90));
+  EXPECT_LE(histogram.Percentile(90), histogram.Percentile(99));
+  EXPECT_LE(histogram.Percentile(99), histogram.Percentile(100));
+  EXPECT_GE(histogram.Percentile(50), 50000);
+  EXPECT_LE(histogram.Percentile(50), 50000 + 50000 / 16);
+  EXPECT_EQ(histogram.Percentile(100), 100000);
+}
+
+TEST(LatencyHistogramTest, MaxValueIsRecorded) {
+  LatencyHistogram histogram;
+  histogram.Record(std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(histogram.Count(), 1);
+  EXPECT_EQ(histogram.Min(), std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(histogram.Percentile(100), std::numeric_limits<uint64_t>::max());
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecords) {
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (uint64_t thread_index = 0; thread_index < 4; thread_index++) {
+    threads.emplace_back([&histogram, thread_index]() {
+      for (uint64_t value = 1; value <= 10000; value++) {
+        histogram.Record(value + thread_index);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(histogram.Count(), 40000);
+  EXPECT_EQ(histogram.Min(), 1);
+  EXPECT_EQ(histogram.Max(), 10003);
+}
+}  // namespace google::scp::pbs::test
@@ -0,0 +1,86 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pbs/tools/pbs_workload_generator/zipf_distribution.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace google::scp::pbs::test {
+
+TEST(ZipfDistributionTest, SamplesAreWithinRange) {
+  ZipfDistribution distribution(10, 1.2);
+  std::mt19937_64 generator(1);
+  for (int i = 0; i < 10000; i++) {
+    auto rank = distribution(generator);
+    EXPECT_GE(rank, 1);
+    EXPECT_LE(rank, 10);
+  }
+}
+
+TEST(ZipfDistributionTest, EmptyRangeSamplesTheFirstRank) {
+  ZipfDistribution distribution(0, 1);
+  std::mt19937_64 generator(1);
+  EXPECT_EQ(distribution(generator), 1);
+}
+
+TEST(ZipfDistributionTest, ZeroExponentIsUniform) {
+  ZipfDistribution distribution(4, 0);
+  std::mt19937_64 generator(1);
+  std::vector<uint64_t> counts(4, 0);
+  for (int i = 0; i < 40000; i++) {
+    counts[distribution(generator) - 1]++;
+  }
+  for (auto count : counts) {
+    EXPECT_NEAR(count, 10000, 500);
+  }
+}
+
+TEST(ZipfDistributionTest, RankFrequencyFollowsTheExponent) {
+  ZipfDistribution distribution(10, 1);
+  std::mt19937_64 generator(1);
+  std::vector<uint64_t> counts(10, 0);
+  for (int i = 0; i < 100000; i++) {
+    counts[distribution(generator) - 1]++;
+  }
+  // With an exponent of 1, rank k is sampled k times less than rank 1.
+  EXPECT_NEAR(static_cast<double>(counts[0]) / counts[1], 2, 0.1);
+  EXPECT_NEAR(static_cast<double>(counts[0]) / counts[4], 5, 0.5);
+}
+
+TEST(ZipfDistributionTest, SharedDistributionWithPerThreadGenerators) {
+  ZipfDistribution distribution(100, 1);
+  std::vector<std::thread> threads;
+  std::vector<uint64_t> sums(4, 0);
+  for (size_t thread_index = 0; thread_index < sums.size(); thread_index++) {
+    threads.emplace_back([&distribution, &sums, thread_index]() {
+      std::mt19937_64 generator(thread_index);
+      for (int i = 0; i < 10000; i++) {
+        sums[thread_index] += distribution(generator);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto sum : sums) {
+    EXPECT_GE(sum, 10000);
+    EXPECT_LE(sum, 1000000);
+  }
+}
+}  // namespace google::scp::pbs::test
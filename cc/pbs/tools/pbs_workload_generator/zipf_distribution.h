@@ -0,0 +1,59 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace google::scp::pbs {
+/**
+ * @brief Samples ranks in [1, n] where the probability of rank k is
+ * proportional to 1 / k^exponent. An exponent of 0 is the uniform
+ * distribution. The cumulative distribution is precomputed, so sampling is a
+ * binary search.
+ */
+class ZipfDistribution {
+ public:
+  ZipfDistribution(uint64_t n, double exponent)
+      : cumulative_(std::max<uint64_t>(n, 1)) {
+    double sum = 0;
+    for (uint64_t k = 1; k <= cumulative_.size(); k++) {
+      sum += 1.0 / std::pow(static_cast<double>(k), exponent);
+      cumulative_[k - 1] = sum;
+    }
+    for (auto& value : cumulative_) {
+      value /= sum;
+    }
+  }
+
+  /// Thread safe as long as each thread uses its own generator.
+  template <typename Generator>
+  uint64_t operator()(Generator& generator) const {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto value = uniform(generator);
+    auto it = std::lower_bound(cumulative_.begin(), cumulative_.end(), value);
+    if (it == cumulative_.end()) {
+      return cumulative_.size();
+    }
+    return (it - cumulative_.begin()) + 1;
+  }
+
+ protected:
+  std::vector<double> cumulative_;
+};
+}  // namespace google::scp::pbs
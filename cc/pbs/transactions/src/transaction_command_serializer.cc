@@ -19,6 +19,7 @@
 #include <memory>
 #include <vector>
 
+#include "core/common/bytes_buffer_pool/src/bytes_buffer_pool.h"
 #include "core/common/uuid/src/uuid.h"
 #include "pbs/transactions/src/batch_consume_budget_command.h"
 #include "pbs/transactions/src/batch_consume_budget_command_serialization.h"
@@ -36,6 +37,7 @@ using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::TransactionCommand;
 using google::scp::core::Version;
+using google::scp::core::common::BytesBufferPool;
 using google::scp::core::common::Uuid;
 using google::scp::pbs::ConsumeBudgetCommand;
 using google::scp::pbs::transactions::proto::CommandType;
@@ -169,7 +171,7 @@ ExecutionResult TransactionCommandSerializer::Serialize(
   BytesBuffer log_bytes_buffer;
   log_bytes_buffer.capacity = size;
   log_bytes_buffer.length = size;
-  log_bytes_buffer.bytes = make_shared<vector<Byte>>(size);
+  log_bytes_buffer.bytes = BytesBufferPool::AllocateBytes(size);
 
   if (!transaction_command_log_1_0.SerializeToArray(
           log_bytes_buffer.bytes->data(), size)) {
@@ -184,7 +186,7 @@ ExecutionResult TransactionCommandSerializer::Serialize(
   size = transaction_command_log.ByteSizeLong();
   bytes_buffer.capacity = size;
   bytes_buffer.length = size;
-  bytes_buffer.bytes = make_shared<vector<Byte>>(size);
+  bytes_buffer.bytes = BytesBufferPool::AllocateBytes(size);
 
   if (!transaction_command_log.SerializeToArray(bytes_buffer.bytes->data(),
                                                 size)) {
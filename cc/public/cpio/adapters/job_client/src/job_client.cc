@@ -32,6 +32,8 @@ using google::cmrt::sdk::job_service::v1::GetJobByIdRequest;
 using google::cmrt::sdk::job_service::v1::GetJobByIdResponse;
 using google::cmrt::sdk::job_service::v1::GetNextJobRequest;
 using google::cmrt::sdk::job_service::v1::GetNextJobResponse;
+using google::cmrt::sdk::job_service::v1::GetNextJobsRequest;
+using google::cmrt::sdk::job_service::v1::GetNextJobsResponse;
 using google::cmrt::sdk::job_service::v1::PutJobRequest;
 using google::cmrt::sdk::job_service::v1::PutJobResponse;
 using google::cmrt::sdk::job_service::v1::UpdateJobBodyRequest;
@@ -129,6 +131,12 @@ ExecutionResult JobClient::GetNextJob(
   return job_client_provider_->GetNextJob(get_next_job_context);
 }
 
+ExecutionResult JobClient::GetNextJobs(
+    AsyncContext<GetNextJobsRequest, GetNextJobsResponse>&
+        get_next_jobs_context) noexcept {
+  return job_client_provider_->GetNextJobs(get_next_jobs_context);
+}
+
 ExecutionResult JobClient::GetJobById(
     AsyncContext<GetJobByIdRequest, GetJobByIdResponse>&
         get_job_by_id_context) noexcept {
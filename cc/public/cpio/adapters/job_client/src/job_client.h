@@ -48,6 +48,11 @@ class JobClient : public JobClientInterface {
                          cmrt::sdk::job_service::v1::GetNextJobResponse>&
           get_next_job_context) noexcept override;
 
+  core::ExecutionResult GetNextJobs(
+      core::AsyncContext<cmrt::sdk::job_service::v1::GetNextJobsRequest,
+                         cmrt::sdk::job_service::v1::GetNextJobsResponse>&
+          get_next_jobs_context) noexcept override;
+
   core::ExecutionResult GetJobById(
       core::AsyncContext<cmrt::sdk::job_service::v1::GetJobByIdRequest,
                          cmrt::sdk::job_service::v1::GetJobByIdResponse>&
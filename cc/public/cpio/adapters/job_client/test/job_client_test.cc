@@ -29,6 +29,8 @@ using google::cmrt::sdk::job_service::v1::GetJobByIdRequest;
 using google::cmrt::sdk::job_service::v1::GetJobByIdResponse;
 using google::cmrt::sdk::job_service::v1::GetNextJobRequest;
 using google::cmrt::sdk::job_service::v1::GetNextJobResponse;
+using google::cmrt::sdk::job_service::v1::GetNextJobsRequest;
+using google::cmrt::sdk::job_service::v1::GetNextJobsResponse;
 using google::cmrt::sdk::job_service::v1::PutJobRequest;
 using google::cmrt::sdk::job_service::v1::PutJobResponse;
 using google::cmrt::sdk::job_service::v1::UpdateJobBodyRequest;
@@ -66,6 +68,13 @@ TEST_F(JobClientTest, GetNextJobSuccess) {
   EXPECT_THAT(client_.GetNextJob(context), IsSuccessful());
 }
 
+TEST_F(JobClientTest, GetNextJobsSuccess) {
+  AsyncContext<GetNextJobsRequest, GetNextJobsResponse> context;
+  EXPECT_CALL(client_.GetJobClientProvider(), GetNextJobs)
+      .WillOnce(Return(SuccessExecutionResult()));
+  EXPECT_THAT(client_.GetNextJobs(context), IsSuccessful());
+}
+
 TEST_F(JobClientTest, GetJobByIdSuccess) {
   AsyncContext<GetJobByIdRequest, GetJobByIdResponse> context;
   EXPECT_CALL(client_.GetJobClientProvider(), GetJobById)
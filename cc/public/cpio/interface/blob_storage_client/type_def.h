@@ -30,6 +30,12 @@ struct BlobStorageClientOptions {
   std::chrono::seconds transfer_stall_timeout = std::chrono::seconds(60 * 2);
   // GCP - How many retries should be used for blob storage operations.
   size_t retry_limit = 3;
+  // AWS - How many ranges of a GetBlobStream are downloaded concurrently. The
+  // ranges are still returned in order. 1 downloads one range at a time.
+  size_t get_blob_stream_readahead_count = 1;
+  // AWS - How many parts of a PutBlobStream are uploaded concurrently. 1
+  // uploads one part at a time.
+  size_t put_blob_stream_max_concurrent_parts = 1;
 
   virtual ~BlobStorageClientOptions() = default;
 };
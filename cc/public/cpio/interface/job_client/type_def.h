@@ -33,5 +33,14 @@ struct JobClientOptions {
 
   // The Spanner Database to use for GCP. Unused for AWS.
   std::string gcp_spanner_database_name;
+
+  // The number of job messages received per queue call for AWS, up to 10.
+  // The ones beyond the requested jobs are prefetched for the next calls.
+  // Unused for GCP.
+  size_t aws_queue_max_messages_per_receive = 1;
+
+  // The long polling wait time of queue calls in seconds for AWS, up to 20.
+  // Unused for GCP.
+  size_t aws_queue_receive_wait_time_seconds = 0;
 };
 }  // namespace google::scp::cpio
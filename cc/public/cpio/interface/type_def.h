@@ -68,6 +68,10 @@ struct CpioOptions {
 
   /// Optional IO thread pool. If not set, an internal thread pool will be used.
   std::shared_ptr<core::AsyncExecutorInterface> io_async_executor;
+
+  /// Whether the HTTP/1 requests share connections on a single curl multi
+  /// event loop instead of each blocking an IO thread. Default is false.
+  bool http1_curl_multi_engine_enabled = false;
 };
 
 template <typename TResponse>
@@ -15,7 +15,9 @@
  */
 #pragma once
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "core/interface/async_context.h"
 #include "public/core/interface/execution_result.h"
@@ -54,6 +56,33 @@ class ConfigurationFetcherInterface {
   virtual core::ExecutionResult GetParameterByNameAsync(
       core::AsyncContext<std::string, std::string> context) noexcept = 0;
 
+  /**
+   * @brief Prefetch the parameters read by the getters of this class plus the
+   * given ones into an in-memory snapshot. The later gets of these parameters
+   * are served from the snapshot without any remote call. Parameters which
+   * cannot be fetched are left out of the snapshot and keep being fetched
+   * remotely.
+   *
+   * @param parameter_names the additional parameters to prefetch, e.g. the
+   * ones read with GetParameterByName.
+   * @return core::ExecutionResultOr<std::map<std::string, std::string>> the
+   * prefetched parameter values and result.
+   */
+  virtual core::ExecutionResultOr<std::map<std::string, std::string>>
+  PrefetchParameters(std::vector<std::string> parameter_names) noexcept = 0;
+
+  /**
+   * @brief Prefetch the parameters read by the getters of this class plus the
+   * given ones into an in-memory snapshot.
+   *
+   * @param context the async context for the operation.
+   * @return core::ExecutionResult scheduling result returned synchronously.
+   */
+  virtual core::ExecutionResult PrefetchParametersAsync(
+      core::AsyncContext<std::vector<std::string>,
+                         std::map<std::string, std::string>>
+          context) noexcept = 0;
+
   /**** Shared configurations start */
   /**
    * @brief Get SharedLogOption.
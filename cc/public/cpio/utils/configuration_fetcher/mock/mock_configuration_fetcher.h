@@ -18,7 +18,9 @@
 
 #include <gmock/gmock.h>
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/interface/type_def.h"
@@ -37,6 +39,15 @@ class MockConfigurationFetcher : public ConfigurationFetcherInterface {
               ((core::AsyncContext<std::string, std::string>)),
               (noexcept, override));
 
+  MOCK_METHOD((core::ExecutionResultOr<std::map<std::string, std::string>>),
+              PrefetchParameters, ((std::vector<std::string>)),
+              (noexcept, override));
+
+  MOCK_METHOD(core::ExecutionResult, PrefetchParametersAsync,
+              ((core::AsyncContext<std::vector<std::string>,
+                                   std::map<std::string, std::string>>)),
+              (noexcept, override));
+
   MOCK_METHOD(core::ExecutionResultOr<LogOption>, GetSharedLogOption,
               ((GetConfigurationRequest)), (noexcept, override));
 
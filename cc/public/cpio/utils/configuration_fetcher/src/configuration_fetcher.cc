@@ -17,9 +17,13 @@
 #include "configuration_fetcher.h"
 
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "cc/core/common/uuid/src/uuid.h"
@@ -64,10 +68,16 @@ using google::scp::core::errors::SC_CONFIGURATION_FETCHER_CONVERSION_FAILED;
 using google::scp::core::errors::
     SC_CONFIGURATION_FETCHER_ENVIRONMENT_NAME_NOT_FOUND;
 using std::bind;
+using std::lock_guard;
 using std::make_shared;
+using std::map;
+using std::mutex;
 using std::move;
 using std::shared_ptr;
 using std::string;
+using std::unordered_set;
+using std::vector;
+using std::chrono::steady_clock;
 using std::placeholders::_1;
 using std::placeholders::_2;
 
@@ -77,6 +87,27 @@ constexpr char kEnvNameTag[] = "environment-name";
 }  // namespace
 
 namespace google::scp::cpio {
+namespace {
+/// Returns the parameters read by the getters of ConfigurationFetcher.
+vector<string> GetKnownParameterNames() {
+  return {kSdkClientLogOption,
+          kSharedCpuThreadCount,
+          kSharedCpuThreadPoolQueueCap,
+          kSharedIoThreadCount,
+          kSharedIoThreadPoolQueueCap,
+          kJobClientJobQueueName,
+          kJobClientJobTableName,
+          kGcpJobClientSpannerInstanceName,
+          kGcpJobClientSpannerDatabaseName,
+          kGcpNoSQLDatabaseClientSpannerInstanceName,
+          kGcpNoSQLDatabaseClientSpannerDatabaseName,
+          kQueueClientQueueName,
+          kCryptoClientHpkeKem,
+          kCryptoClientHpkeKdf,
+          kCryptoClientHpkeAead};
+}
+}  // namespace
+
 ExecutionResultOr<string> ConfigurationFetcher::GetParameterByName(
     string parameter_name) noexcept {
   string parameter;
@@ -94,6 +125,115 @@ ExecutionResult ConfigurationFetcher::GetParameterByNameAsync(
   return GetConfiguration(context);
 }
 
+ExecutionResultOr<map<string, string>> ConfigurationFetcher::PrefetchParameters(
+    vector<string> parameter_names) noexcept {
+  map<string, string> parameter_values;
+  auto execution_result =
+      SyncUtils::AsyncToSync<vector<string>, map<string, string>>(
+          bind(&ConfigurationFetcher::PrefetchParametersAsync, this, _1),
+          move(parameter_names), parameter_values);
+  RETURN_AND_LOG_IF_FAILURE(execution_result, kConfigurationFetcher, kZeroUuid,
+                            "Failed to PrefetchParameters.");
+  return parameter_values;
+}
+
+ExecutionResult ConfigurationFetcher::PrefetchParametersAsync(
+    AsyncContext<vector<string>, map<string, string>> context) noexcept {
+  auto parameter_names = make_shared<vector<string>>(GetKnownParameterNames());
+  unordered_set<string> seen_parameter_names(parameter_names->begin(),
+                                             parameter_names->end());
+  if (context.request) {
+    for (const auto& parameter_name : *context.request) {
+      if (seen_parameter_names.insert(parameter_name).second) {
+        parameter_names->push_back(parameter_name);
+      }
+    }
+  }
+
+  AsyncContext<GetConfigurationRequest, string> get_environment_name_context(
+      make_shared<GetConfigurationRequest>(),
+      bind(&ConfigurationFetcher::PrefetchParametersEnvironmentNameCallback,
+           this, _1, parameter_names, context),
+      context);
+  return GetEnvironmentName(get_environment_name_context);
+}
+
+void ConfigurationFetcher::PrefetchParametersEnvironmentNameCallback(
+    AsyncContext<GetConfigurationRequest, string>& get_environment_name_context,
+    const shared_ptr<vector<string>>& parameter_names,
+    AsyncContext<vector<string>, map<string, string>>&
+        prefetch_context) noexcept {
+  if (!get_environment_name_context.result.Successful()) {
+    prefetch_context.result = get_environment_name_context.result;
+    prefetch_context.Finish();
+    return;
+  }
+
+  // All the parameters are fetched concurrently with the environment name
+  // resolved once.
+  auto tracker =
+      make_shared<PrefetchParametersTracker>(parameter_names->size());
+  for (size_t i = 0; i < parameter_names->size(); ++i) {
+    GetParameterRequest request;
+    request.set_parameter_name(
+        absl::StrCat("scp-", *get_environment_name_context.response, "-",
+                     (*parameter_names)[i]));
+    // Clients may or may not call back when failing synchronously. Only the
+    // first completion of a parameter counts, so both are fine.
+    if (auto result = parameter_client_->GetParameter(
+            move(request),
+            bind(&ConfigurationFetcher::PrefetchParameterCallback, this, _1, _2,
+                 i, parameter_names, tracker, prefetch_context));
+        !result.Successful()) {
+      PrefetchParameterCallback(result, GetParameterResponse(), i,
+                                parameter_names, tracker, prefetch_context);
+    }
+  }
+}
+
+void ConfigurationFetcher::PrefetchParameterCallback(
+    const ExecutionResult& result, GetParameterResponse response, size_t index,
+    const shared_ptr<vector<string>>& parameter_names,
+    const shared_ptr<PrefetchParametersTracker>& tracker,
+    AsyncContext<vector<string>, map<string, string>>&
+        prefetch_context) noexcept {
+  if (tracker->is_parameter_complete[index].exchange(true)) {
+    return;
+  }
+
+  const auto& parameter_name = (*parameter_names)[index];
+  if (result.Successful()) {
+    lock_guard<mutex> lock(tracker->parameter_values_mutex);
+    tracker->parameter_values[parameter_name] =
+        move(*response.mutable_parameter_value());
+  } else {
+    // E.g. the parameter is not defined for this platform. The later gets of
+    // the parameter fetch it remotely and fail as they would without the
+    // prefetch.
+    SCP_DEBUG_CONTEXT(kConfigurationFetcher, prefetch_context,
+                      "Failed to prefetch parameter %s",
+                      parameter_name.c_str());
+  }
+
+  if (tracker->pending_parameter_count.fetch_sub(1) != 1) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock(snapshot_mutex_);
+    // A refresh keeps the former value of a parameter it fails to fetch.
+    for (const auto& [name, value] : tracker->parameter_values) {
+      parameter_snapshot_[name] = value;
+    }
+    snapshot_parameter_names_ = *parameter_names;
+    snapshot_time_ = steady_clock::now();
+  }
+  prefetch_context.response =
+      make_shared<map<string, string>>(move(tracker->parameter_values));
+  prefetch_context.result = SuccessExecutionResult();
+  prefetch_context.Finish();
+}
+
 ExecutionResultOr<LogOption> ConfigurationFetcher::GetSharedLogOption(
     GetConfigurationRequest request) noexcept {
   LogOption parameter;
@@ -444,21 +584,102 @@ AsyncContext<string, string> ConfigurationFetcher::ContextConvertCallback(
 
 core::ExecutionResult ConfigurationFetcher::GetConfiguration(
     AsyncContext<string, string>& get_configuration_context) noexcept {
+  if (GetConfigurationFromSnapshot(get_configuration_context)) {
+    return SuccessExecutionResult();
+  }
+
+  AsyncContext<GetConfigurationRequest, string> get_environment_name_context(
+      make_shared<GetConfigurationRequest>(),
+      [this, get_configuration_context](
+          AsyncContext<GetConfigurationRequest, string>&
+              get_environment_name_context) mutable {
+        if (!get_environment_name_context.result.Successful()) {
+          get_configuration_context.result =
+              get_environment_name_context.result;
+          get_configuration_context.Finish();
+          return;
+        }
+        GetParameter(*get_environment_name_context.response,
+                     get_configuration_context);
+      },
+      get_configuration_context);
+  return GetEnvironmentName(get_environment_name_context);
+}
+
+bool ConfigurationFetcher::GetConfigurationFromSnapshot(
+    AsyncContext<string, string>& get_configuration_context) noexcept {
+  vector<string> parameter_names_to_refresh;
+  {
+    lock_guard<mutex> lock(snapshot_mutex_);
+    auto it = parameter_snapshot_.find(*get_configuration_context.request);
+    if (it == parameter_snapshot_.end()) {
+      return false;
+    }
+    get_configuration_context.response = make_shared<string>(it->second);
+
+    if (snapshot_refresh_interval_.count() > 0 &&
+        steady_clock::now() - snapshot_time_ >= snapshot_refresh_interval_ &&
+        !is_refreshing_snapshot_.exchange(true)) {
+      parameter_names_to_refresh = snapshot_parameter_names_;
+    }
+  }
+
+  // The stale value is served while the snapshot is refreshed.
+  if (!parameter_names_to_refresh.empty()) {
+    AsyncContext<vector<string>, map<string, string>> refresh_context(
+        make_shared<vector<string>>(move(parameter_names_to_refresh)),
+        [this](AsyncContext<vector<string>, map<string, string>>&
+                   refresh_context) {
+          if (!refresh_context.result.Successful()) {
+            SCP_ERROR_CONTEXT(kConfigurationFetcher, refresh_context,
+                              refresh_context.result,
+                              "Failed to refresh the parameter snapshot");
+          }
+          is_refreshing_snapshot_ = false;
+        },
+        get_configuration_context);
+    if (!PrefetchParametersAsync(refresh_context).Successful()) {
+      is_refreshing_snapshot_ = false;
+    }
+  }
+
+  get_configuration_context.result = SuccessExecutionResult();
+  get_configuration_context.Finish();
+  return true;
+}
+
+ExecutionResult ConfigurationFetcher::GetEnvironmentName(
+    AsyncContext<GetConfigurationRequest, string>&
+        get_environment_name_context) noexcept {
+  {
+    lock_guard<mutex> lock(snapshot_mutex_);
+    if (environment_name_) {
+      get_environment_name_context.response =
+          make_shared<string>(*environment_name_);
+    }
+  }
+  if (get_environment_name_context.response) {
+    get_environment_name_context.result = SuccessExecutionResult();
+    get_environment_name_context.Finish();
+    return SuccessExecutionResult();
+  }
+
   return instance_client_->GetCurrentInstanceResourceName(
       GetCurrentInstanceResourceNameRequest(),
       bind(&ConfigurationFetcher::GetCurrentInstanceResourceNameCallback, this,
-           _1, _2, get_configuration_context));
+           _1, _2, get_environment_name_context));
 }
 
 void ConfigurationFetcher::GetCurrentInstanceResourceNameCallback(
     const ExecutionResult& result,
     GetCurrentInstanceResourceNameResponse response,
-    AsyncContext<string, string>& get_configuration_context) noexcept {
+    AsyncContext<GetConfigurationRequest, string>&
+        get_environment_name_context) noexcept {
   if (!result.Successful()) {
-    get_configuration_context.result = result;
-    SCP_ERROR_CONTEXT(kConfigurationFetcher, get_configuration_context, result,
-                      "Failed to GetCurrentInstanceResourceName");
-    get_configuration_context.Finish();
+    get_environment_name_context.result = result;
+    SCP_ERROR_CONTEXT(kConfigurationFetcher, get_environment_name_context,
+                      result, "Failed to GetCurrentInstanceResourceName");
+    get_environment_name_context.Finish();
     return;
   }
 
@@ -467,14 +688,14 @@ void ConfigurationFetcher::GetCurrentInstanceResourceNameCallback(
   if (auto result = instance_client_->GetInstanceDetailsByResourceName(
           move(request),
           bind(&ConfigurationFetcher::GetInstanceDetailsByResourceNameCallback,
-               this, _1, _2, response, get_configuration_context));
+               this, _1, _2, response, get_environment_name_context));
       !result.Successful()) {
-    get_configuration_context.result = result;
+    get_environment_name_context.result = result;
     SCP_ERROR_CONTEXT(
-        kConfigurationFetcher, get_configuration_context, result,
+        kConfigurationFetcher, get_environment_name_context, result,
         "Failed to GetInstanceDetailsByResourceName for instance %s",
         response.instance_resource_name().c_str());
-    get_configuration_context.Finish();
+    get_environment_name_context.Finish();
   }
 }
 
@@ -482,33 +703,46 @@ void ConfigurationFetcher::GetInstanceDetailsByResourceNameCallback(
     const ExecutionResult& result,
     GetInstanceDetailsByResourceNameResponse get_instance_details_response,
     const GetCurrentInstanceResourceNameResponse& get_current_instance_response,
-    AsyncContext<string, string>& get_configuration_context) noexcept {
+    AsyncContext<GetConfigurationRequest, string>&
+        get_environment_name_context) noexcept {
   if (!result.Successful()) {
-    get_configuration_context.result = result;
+    get_environment_name_context.result = result;
     SCP_ERROR_CONTEXT(
-        kConfigurationFetcher, get_configuration_context, result,
+        kConfigurationFetcher, get_environment_name_context, result,
         "Failed to GetInstanceDetailsByResourceName for instance %s",
         get_current_instance_response.instance_resource_name().c_str());
-    get_configuration_context.Finish();
+    get_environment_name_context.Finish();
     return;
   }
 
   auto it = get_instance_details_response.instance_details().labels().find(
       string(kEnvNameTag));
   if (it == get_instance_details_response.instance_details().labels().end()) {
-    get_configuration_context.result = FailureExecutionResult(
+    get_environment_name_context.result = FailureExecutionResult(
         SC_CONFIGURATION_FETCHER_ENVIRONMENT_NAME_NOT_FOUND);
     SCP_ERROR_CONTEXT(
-        kConfigurationFetcher, get_configuration_context,
-        get_configuration_context.result,
+        kConfigurationFetcher, get_environment_name_context,
+        get_environment_name_context.result,
         "Failed to find environment name for instance %s",
         get_current_instance_response.instance_resource_name().c_str());
-    get_configuration_context.Finish();
+    get_environment_name_context.Finish();
     return;
   }
 
+  {
+    lock_guard<mutex> lock(snapshot_mutex_);
+    environment_name_ = it->second;
+  }
+  get_environment_name_context.response = make_shared<string>(it->second);
+  get_environment_name_context.result = SuccessExecutionResult();
+  get_environment_name_context.Finish();
+}
+
+void ConfigurationFetcher::GetParameter(
+    const string& environment_name,
+    AsyncContext<string, string>& get_configuration_context) noexcept {
   GetParameterRequest request;
-  request.set_parameter_name(absl::StrCat("scp-", it->second, "-",
+  request.set_parameter_name(absl::StrCat("scp-", environment_name, "-",
                                           *get_configuration_context.request));
   if (auto result = parameter_client_->GetParameter(
           move(request), bind(&ConfigurationFetcher::GetParameterCallback, this,
@@ -17,9 +17,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "core/interface/async_context.h"
@@ -36,10 +40,25 @@ namespace google::scp::cpio {
  */
 class ConfigurationFetcher : public ConfigurationFetcherInterface {
  public:
-  explicit ConfigurationFetcher(InstanceClientInterface* instance_client,
-                                ParameterClientInterface* parameter_client)
+  /**
+   * @brief Construct a new Configuration Fetcher.
+   *
+   * @param instance_client the instance client to find the environment name.
+   * @param parameter_client the parameter client to get the parameters.
+   * @param snapshot_refresh_interval how old the prefetched snapshot gets
+   * before a get served from it refreshes it in the background. Zero never
+   * refreshes the snapshot. The fetcher must outlive the refreshes, as it
+   * outlives any other async get.
+   */
+  explicit ConfigurationFetcher(
+      InstanceClientInterface* instance_client,
+      ParameterClientInterface* parameter_client,
+      std::chrono::milliseconds snapshot_refresh_interval =
+          std::chrono::milliseconds(0))
       : instance_client_(instance_client),
-        parameter_client_(parameter_client) {}
+        parameter_client_(parameter_client),
+        snapshot_refresh_interval_(snapshot_refresh_interval),
+        is_refreshing_snapshot_(false) {}
 
   core::ExecutionResultOr<std::string> GetParameterByName(
       std::string parameter_name) noexcept override;
@@ -47,6 +66,15 @@ class ConfigurationFetcher : public ConfigurationFetcherInterface {
   core::ExecutionResult GetParameterByNameAsync(
       core::AsyncContext<std::string, std::string> context) noexcept override;
 
+  core::ExecutionResultOr<std::map<std::string, std::string>>
+  PrefetchParameters(std::vector<std::string> parameter_names) noexcept
+      override;
+
+  core::ExecutionResult PrefetchParametersAsync(
+      core::AsyncContext<std::vector<std::string>,
+                         std::map<std::string, std::string>>
+          context) noexcept override;
+
   core::ExecutionResultOr<LogOption> GetSharedLogOption(
       GetConfigurationRequest request) noexcept override;
 
@@ -162,16 +190,52 @@ class ConfigurationFetcher : public ConfigurationFetcherInterface {
       core::AsyncContext<GetConfigurationRequest, std::string>&
           context_without_parameter_name) noexcept;
 
+  /// Tracks the parameters of a prefetch, which complete in any order.
+  struct PrefetchParametersTracker {
+    explicit PrefetchParametersTracker(size_t parameter_count)
+        : pending_parameter_count(parameter_count),
+          is_parameter_complete(
+              std::make_unique<std::atomic<bool>[]>(parameter_count)) {
+      for (size_t i = 0; i < parameter_count; ++i) {
+        is_parameter_complete[i] = false;
+      }
+    }
+
+    std::atomic<size_t> pending_parameter_count;
+    std::unique_ptr<std::atomic<bool>[]> is_parameter_complete;
+    std::mutex parameter_values_mutex;
+    std::map<std::string, std::string> parameter_values;
+  };
+
   core::ExecutionResult GetConfiguration(
       core::AsyncContext<std::string, std::string>&
           get_configuration_context) noexcept;
 
+  /**
+   * @brief Serves the parameter from the prefetched snapshot, and refreshes
+   * the snapshot in the background if it is too old.
+   *
+   * @return true if the parameter is in the snapshot and the context is
+   * finished.
+   */
+  bool GetConfigurationFromSnapshot(
+      core::AsyncContext<std::string, std::string>&
+          get_configuration_context) noexcept;
+
+  /**
+   * @brief Gets the environment name from the labels of the current instance.
+   * The environment name is resolved once and reused by the later gets.
+   */
+  core::ExecutionResult GetEnvironmentName(
+      core::AsyncContext<GetConfigurationRequest, std::string>&
+          get_environment_name_context) noexcept;
+
   void GetCurrentInstanceResourceNameCallback(
       const core::ExecutionResult& result,
       cmrt::sdk::instance_service::v1::GetCurrentInstanceResourceNameResponse
           response,
-      core::AsyncContext<std::string, std::string>&
-          get_configuration_context) noexcept;
+      core::AsyncContext<GetConfigurationRequest, std::string>&
+          get_environment_name_context) noexcept;
 
   void GetInstanceDetailsByResourceNameCallback(
       const core::ExecutionResult& result,
@@ -179,8 +243,12 @@ class ConfigurationFetcher : public ConfigurationFetcherInterface {
           get_instance_details_response,
       const cmrt::sdk::instance_service::v1::
           GetCurrentInstanceResourceNameResponse& get_current_instance_response,
-      core::AsyncContext<std::string, std::string>&
-          get_configuration_context) noexcept;
+      core::AsyncContext<GetConfigurationRequest, std::string>&
+          get_environment_name_context) noexcept;
+
+  void GetParameter(const std::string& environment_name,
+                    core::AsyncContext<std::string, std::string>&
+                        get_configuration_context) noexcept;
 
   void GetParameterCallback(
       const core::ExecutionResult& result,
@@ -188,7 +256,36 @@ class ConfigurationFetcher : public ConfigurationFetcherInterface {
       core::AsyncContext<std::string, std::string>&
           get_configuration_context) noexcept;
 
+  void PrefetchParametersEnvironmentNameCallback(
+      core::AsyncContext<GetConfigurationRequest, std::string>&
+          get_environment_name_context,
+      const std::shared_ptr<std::vector<std::string>>& parameter_names,
+      core::AsyncContext<std::vector<std::string>,
+                         std::map<std::string, std::string>>&
+          prefetch_context) noexcept;
+
+  void PrefetchParameterCallback(
+      const core::ExecutionResult& result,
+      cmrt::sdk::parameter_service::v1::GetParameterResponse response,
+      size_t index,
+      const std::shared_ptr<std::vector<std::string>>& parameter_names,
+      const std::shared_ptr<PrefetchParametersTracker>& tracker,
+      core::AsyncContext<std::vector<std::string>,
+                         std::map<std::string, std::string>>&
+          prefetch_context) noexcept;
+
   InstanceClientInterface* instance_client_;
   ParameterClientInterface* parameter_client_;
+  const std::chrono::milliseconds snapshot_refresh_interval_;
+
+  /// Guards the environment name and the prefetched snapshot.
+  std::mutex snapshot_mutex_;
+  std::optional<std::string> environment_name_;
+  std::unordered_map<std::string, std::string> parameter_snapshot_;
+  /// The parameters a refresh of the snapshot fetches again.
+  std::vector<std::string> snapshot_parameter_names_;
+  std::chrono::steady_clock::time_point snapshot_time_;
+  /// Whether a refresh of the snapshot is in flight.
+  std::atomic<bool> is_refreshing_snapshot_;
 };
 }  // namespace google::scp::cpio
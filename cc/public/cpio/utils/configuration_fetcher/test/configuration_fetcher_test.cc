@@ -17,9 +17,12 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include "absl/strings/str_cat.h"
@@ -72,6 +75,10 @@ using std::move;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::vector;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+using testing::_;
 
 namespace {
 constexpr char kInstanceResourceName[] =
@@ -88,6 +95,8 @@ constexpr char kTestHpkeKem[] = "DHKEM_X25519_HKDF_SHA256";
 constexpr char kTestHpkeKdf[] = "HKDF_SHA256";
 constexpr char kTestHpkeAead[] = "CHACHA20_POLY1305";
 constexpr char kTestLogOption[] = "ConsoleLog";
+constexpr char kTestCustomParameter[] = "test-custom-parameter";
+constexpr char kTestCustomValue[] = "test-custom-value";
 }  // namespace
 
 namespace google::scp::cpio {
@@ -151,6 +160,28 @@ class ConfigurationFetcherTest : public ::testing::Test {
         });
   }
 
+  /// Serves the parameters in values and fails the other ones asynchronously.
+  void ExpectGetParameters(const std::map<string, string>& values,
+                           size_t& get_parameter_count) {
+    EXPECT_CALL(*mock_parameter_client_, GetParameter)
+        .WillRepeatedly([&values, &get_parameter_count](
+                            GetParameterRequest request,
+                            Callback<GetParameterResponse> callback) {
+          get_parameter_count++;
+          for (const auto& [name, value] : values) {
+            if (request.parameter_name() ==
+                absl::StrCat("scp-", kEnvName, "-", name)) {
+              GetParameterResponse response;
+              response.set_parameter_value(value);
+              callback(SuccessExecutionResult(), move(response));
+              return SuccessExecutionResult();
+            }
+          }
+          callback(FailureExecutionResult(SC_UNKNOWN), GetParameterResponse());
+          return SuccessExecutionResult();
+        });
+  }
+
   unique_ptr<MockInstanceClient> mock_instance_client_;
   unique_ptr<MockParameterClient> mock_parameter_client_;
   unique_ptr<ConfigurationFetcher> fetcher_;
@@ -715,4 +746,63 @@ TEST_F(ConfigurationFetcherTest, EnvNameNotFound) {
       fetcher_->GetJobClientJobTableNameAsync(get_job_table_context));
   WaitUntil([&]() { return finished.load(); });
 }
+
+TEST_F(ConfigurationFetcherTest, PrefetchParametersServesLaterGets) {
+  ExpectGetCurrentInstanceResourceName(SuccessExecutionResult());
+  ExpectGetInstanceDetails(SuccessExecutionResult(), env_name_tag_);
+  std::map<string, string> values = {
+      {kJobClientJobTableName, kTestTable},
+      {kTestCustomParameter, kTestCustomValue}};
+  size_t get_parameter_count = 0;
+  ExpectGetParameters(values, get_parameter_count);
+
+  auto prefetched = fetcher_->PrefetchParameters({kTestCustomParameter});
+  EXPECT_THAT(prefetched, IsSuccessfulAndHolds(values));
+  // The known parameters and the custom one, all with one instance lookup.
+  EXPECT_EQ(get_parameter_count, 16);
+
+  EXPECT_THAT(fetcher_->GetJobClientJobTableName(GetConfigurationRequest()),
+              IsSuccessfulAndHolds(kTestTable));
+  EXPECT_THAT(fetcher_->GetParameterByName(kTestCustomParameter),
+              IsSuccessfulAndHolds(kTestCustomValue));
+  EXPECT_EQ(get_parameter_count, 16);
+
+  // A parameter which failed to prefetch is fetched remotely again, reusing
+  // the environment name.
+  EXPECT_THAT(
+      fetcher_->GetJobClientJobQueueName(GetConfigurationRequest()).result(),
+      ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+  EXPECT_EQ(get_parameter_count, 17);
+}
+
+TEST_F(ConfigurationFetcherTest, PrefetchParametersEnvNameNotFound) {
+  ExpectGetCurrentInstanceResourceName(SuccessExecutionResult());
+  ExpectGetInstanceDetails(SuccessExecutionResult(), "invalid_tag");
+  EXPECT_CALL(*mock_parameter_client_, GetParameter).Times(0);
+  EXPECT_THAT(fetcher_->PrefetchParameters({}).result(),
+              ResultIs(FailureExecutionResult(
+                  SC_CONFIGURATION_FETCHER_ENVIRONMENT_NAME_NOT_FOUND)));
+}
+
+TEST_F(ConfigurationFetcherTest, StaleSnapshotIsRefreshedInBackground) {
+  fetcher_ = make_unique<ConfigurationFetcher>(mock_instance_client_.get(),
+                                               mock_parameter_client_.get(),
+                                               milliseconds(1));
+  ExpectGetCurrentInstanceResourceName(SuccessExecutionResult());
+  ExpectGetInstanceDetails(SuccessExecutionResult(), env_name_tag_);
+  std::map<string, string> values = {{kJobClientJobTableName, kTestTable}};
+  size_t get_parameter_count = 0;
+  ExpectGetParameters(values, get_parameter_count);
+  EXPECT_SUCCESS(fetcher_->PrefetchParameters({}).result());
+  EXPECT_EQ(get_parameter_count, 15);
+
+  // The stale value is served while the snapshot is refreshed.
+  sleep_for(milliseconds(5));
+  values[kJobClientJobTableName] = "new-table";
+  EXPECT_THAT(fetcher_->GetJobClientJobTableName(GetConfigurationRequest()),
+              IsSuccessfulAndHolds(kTestTable));
+  EXPECT_EQ(get_parameter_count, 30);
+  EXPECT_THAT(fetcher_->GetJobClientJobTableName(GetConfigurationRequest()),
+              IsSuccessfulAndHolds(string("new-table")));
+}
 }  // namespace google::scp::cpio
@@ -0,0 +1,126 @@
+#!/bin/bash
+# Copyright 2023 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs the microbenchmarks and writes their results as JSON, one file per
+# benchmark target. If a baseline directory with the results of a previous
+# run is given, the median real time of every benchmark is compared against
+# it, e.g.:
+#
+#   run_benchmarks.sh --output_directory=/tmp/before
+#   <apply the change>
+#   run_benchmarks.sh --output_directory=/tmp/after \
+#     --baseline_directory=/tmp/before
+
+set -euo pipefail
+
+benchmark_targets=(
+  "//cc/core/async_executor/test:async_executor_schedule_benchmark_test"
+  "//cc/core/common/auto_expiry_concurrent_map/test:auto_expiry_concurrent_map_benchmark_test"
+  "//cc/core/common/concurrent_map/test:concurrent_map_benchmark_test"
+  "//cc/core/common/concurrent_queue/test:concurrent_queue_benchmark_test"
+  "//cc/core/common/lru_cache/test:lru_cache_benchmark_test"
+  "//cc/core/journal_service/test:journal_serialization_benchmark_test"
+  "//cc/pbs/budget_key_timeframe_manager/test:budget_key_timeframe_serialization_benchmark_test"
+)
+
+output_directory=""
+baseline_directory=""
+benchmark_filter="."
+repetitions=5
+
+while [ $# -gt 0 ]; do
+  case "$1" in
+    --output_directory=*)
+      output_directory="${1#*=}"
+      ;;
+    --baseline_directory=*)
+      baseline_directory="${1#*=}"
+      ;;
+    --benchmark_filter=*)
+      benchmark_filter="${1#*=}"
+      ;;
+    --repetitions=*)
+      repetitions="${1#*=}"
+      ;;
+    *)
+      printf "***************************\n"
+      printf "* Error: Invalid argument.*\n"
+      printf "***************************\n"
+      exit 1
+  esac
+  shift
+done
+
+if [ -z "$output_directory" ]; then
+  info_msg=$(cat <<-END
+    Must provide the output directory. Switches are:\n
+      --output_directory=<value>\n
+      --baseline_directory=<value> (optional)\n
+      --benchmark_filter=<regex> (optional)\n
+      --repetitions=<value> (optional, default 5)\n
+END
+)
+  echo -e $info_msg
+  exit 1
+fi
+
+mkdir -p "$output_directory"
+output_directory=$(realpath "$output_directory")
+
+for target in "${benchmark_targets[@]}"; do
+  name="${target##*:}"
+  bazel run --compilation_mode=opt "$target" -- \
+    --benchmark_filter="$benchmark_filter" \
+    --benchmark_repetitions="$repetitions" \
+    --benchmark_report_aggregates_only=true \
+    --benchmark_out="$output_directory/$name.json" \
+    --benchmark_out_format=json
+done
+
+[ -z "$baseline_directory" ] && exit 0
+
+python3 - "$(realpath "$baseline_directory")" "$output_directory" <<'END'
+import json
+import os
+import sys
+
+
+def read_medians(directory):
+    medians = {}
+    for file_name in sorted(os.listdir(directory)):
+        if not file_name.endswith(".json"):
+            continue
+        with open(os.path.join(directory, file_name)) as results:
+            for benchmark in json.load(results)["benchmarks"]:
+                if benchmark.get("aggregate_name", "median") != "median":
+                    continue
+                medians[benchmark["run_name"]] = (benchmark["real_time"],
+                                                  benchmark["time_unit"])
+    return medians
+
+
+baseline = read_medians(sys.argv[1])
+current = read_medians(sys.argv[2])
+print("%-90s %14s %14s %8s" % ("Benchmark", "Baseline", "Current", "Change"))
+for name, (current_time, time_unit) in current.items():
+    if name not in baseline:
+        print("%-90s %14s %11.1f %s %8s" %
+              (name, "-", current_time, time_unit, "new"))
+        continue
+    baseline_time, _ = baseline[name]
+    change = (current_time - baseline_time) / baseline_time * 100
+    print("%-90s %11.1f %s %11.1f %s %+7.1f%%" %
+          (name, baseline_time, time_unit, current_time, time_unit, change))
+END